@@ -110,3 +110,29 @@ int ivf_read_frame(FILE *infile, uint8_t **buffer, size_t *bytes_read,
 
   return 1;
 }
+
+int ivf_map_frame(struct VpxFileMap *map, uint8_t **buffer,
+                  size_t *bytes_read) {
+  size_t left = map->size - map->position;
+  size_t frame_size;
+
+  if (left < IVF_FRAME_HDR_SZ) return 1;
+  frame_size = mem_get_le32(map->data + map->position);
+  map->position += IVF_FRAME_HDR_SZ;
+  left -= IVF_FRAME_HDR_SZ;
+
+  if (frame_size > 256 * 1024 * 1024) {
+    warn("Read invalid frame size (%u)", (unsigned int)frame_size);
+    frame_size = 0;
+  }
+  if (frame_size > left) {
+    warn("Failed to read full frame");
+    map->position = map->size;
+    return 1;
+  }
+
+  *buffer = map->data + map->position;
+  *bytes_read = frame_size;
+  map->position += frame_size;
+  return 0;
+}
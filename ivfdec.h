@@ -21,6 +21,10 @@ int file_is_ivf(struct VpxInputContext *input);
 int ivf_read_frame(FILE *infile, uint8_t **buffer, size_t *bytes_read,
                    size_t *buffer_size);
 
+// Like ivf_read_frame(), but points *buffer at the frame in the mapped file.
+int ivf_map_frame(struct VpxFileMap *map, uint8_t **buffer,
+                  size_t *bytes_read);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
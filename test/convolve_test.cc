@@ -2043,6 +2043,19 @@ INSTANTIATE_TEST_SUITE_P(AVX2, ConvolveTest12Tap,
 #endif
 #endif  // HAVE_AVX2
 
+#if HAVE_AVX512 && !CONFIG_VP9_HIGHBITDEPTH
+const ConvolveFunctions convolve8_avx512(
+    vpx_convolve_copy_c, vpx_convolve_avg_c, vpx_convolve8_horiz_avx512,
+    vpx_convolve8_avg_horiz_avx512, vpx_convolve8_vert_avx512,
+    vpx_convolve8_avg_vert_avx512, vpx_convolve8_avx512,
+    vpx_convolve8_avg_avx512, vpx_scaled_horiz_c, vpx_scaled_avg_horiz_c,
+    vpx_scaled_vert_c, vpx_scaled_avg_vert_c, vpx_scaled_2d_c,
+    vpx_scaled_avg_2d_c, 0);
+const ConvolveParam kArrayConvolve8_avx512[] = { ALL_SIZES(convolve8_avx512) };
+INSTANTIATE_TEST_SUITE_P(AVX512, ConvolveTest,
+                         ::testing::ValuesIn(kArrayConvolve8_avx512));
+#endif  // HAVE_AVX512 && !CONFIG_VP9_HIGHBITDEPTH
+
 #if HAVE_NEON
 #if CONFIG_VP9_HIGHBITDEPTH
 const ConvolveFunctions convolve8_neon(
@@ -123,6 +123,8 @@ INSTANTIATE_TEST_SUITE_P(
                       make_tuple(&vpx_highbd_fdct8x8_1_c, 8, VPX_BITS_12),
                       make_tuple(&vpx_highbd_fdct8x8_1_c, 8, VPX_BITS_10),
                       make_tuple(&vpx_fdct8x8_1_c, 8, VPX_BITS_8),
+                      make_tuple(&vpx_highbd_fdct4x4_1_c, 4, VPX_BITS_12),
+                      make_tuple(&vpx_highbd_fdct4x4_1_c, 4, VPX_BITS_10),
                       make_tuple(&vpx_fdct4x4_1_c, 4, VPX_BITS_8)));
 #else
 INSTANTIATE_TEST_SUITE_P(
@@ -134,12 +136,30 @@ INSTANTIATE_TEST_SUITE_P(
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
 #if HAVE_SSE2
+#if CONFIG_VP9_HIGHBITDEPTH
+INSTANTIATE_TEST_SUITE_P(
+    SSE2, PartialFdctTest,
+    ::testing::Values(
+        make_tuple(&vpx_highbd_fdct32x32_1_sse2, 32, VPX_BITS_12),
+        make_tuple(&vpx_highbd_fdct32x32_1_sse2, 32, VPX_BITS_10),
+        make_tuple(&vpx_fdct32x32_1_sse2, 32, VPX_BITS_8),
+        make_tuple(&vpx_highbd_fdct16x16_1_sse2, 16, VPX_BITS_12),
+        make_tuple(&vpx_highbd_fdct16x16_1_sse2, 16, VPX_BITS_10),
+        make_tuple(&vpx_fdct16x16_1_sse2, 16, VPX_BITS_8),
+        make_tuple(&vpx_highbd_fdct8x8_1_sse2, 8, VPX_BITS_12),
+        make_tuple(&vpx_highbd_fdct8x8_1_sse2, 8, VPX_BITS_10),
+        make_tuple(&vpx_fdct8x8_1_sse2, 8, VPX_BITS_8),
+        make_tuple(&vpx_highbd_fdct4x4_1_sse2, 4, VPX_BITS_12),
+        make_tuple(&vpx_highbd_fdct4x4_1_sse2, 4, VPX_BITS_10),
+        make_tuple(&vpx_fdct4x4_1_sse2, 4, VPX_BITS_8)));
+#else
 INSTANTIATE_TEST_SUITE_P(
     SSE2, PartialFdctTest,
     ::testing::Values(make_tuple(&vpx_fdct32x32_1_sse2, 32, VPX_BITS_8),
                       make_tuple(&vpx_fdct16x16_1_sse2, 16, VPX_BITS_8),
                       make_tuple(&vpx_fdct8x8_1_sse2, 8, VPX_BITS_8),
                       make_tuple(&vpx_fdct4x4_1_sse2, 4, VPX_BITS_8)));
+#endif  // CONFIG_VP9_HIGHBITDEPTH
 #endif  // HAVE_SSE2
 
 #if HAVE_NEON
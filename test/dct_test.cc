@@ -703,19 +703,47 @@ INSTANTIATE_TEST_SUITE_P(
                        ::testing::Range(0, 4), ::testing::Values(VPX_BITS_8)));
 #endif  // HAVE_SSE2
 
+#if HAVE_AVX2
+static const FuncInfo ht_avx2_func_info[] = {
+#if CONFIG_VP9_HIGHBITDEPTH
+  { &vp9_highbd_fht8x8_avx2, &highbd_iht_wrapper<vp9_highbd_iht8x8_64_add_c>,
+    8, 2 },
+  { &vp9_highbd_fht16x16_avx2,
+    &highbd_iht_wrapper<vp9_highbd_iht16x16_256_add_c>, 16, 2 },
+#endif
+  { &vp9_fht4x4_c, &iht_wrapper<vp9_iht4x4_16_add_avx2>, 4, 1 },
+  { &vp9_fht8x8_c, &iht_wrapper<vp9_iht8x8_64_add_avx2>, 8, 1 },
+  { &vp9_fht16x16_c, &iht_wrapper<vp9_iht16x16_256_add_avx2>, 16, 1 }
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, TransHT,
+    ::testing::Combine(
+        ::testing::Range(0, static_cast<int>(sizeof(ht_avx2_func_info) /
+                                             sizeof(ht_avx2_func_info[0]))),
+        ::testing::Values(ht_avx2_func_info), ::testing::Range(0, 4),
+        ::testing::Values(VPX_BITS_8, VPX_BITS_10, VPX_BITS_12)));
+#endif  // HAVE_AVX2
+
 #if HAVE_SSE4_1 && CONFIG_VP9_HIGHBITDEPTH
-static const FuncInfo ht_sse4_1_func_info[3] = {
+static const FuncInfo ht_sse4_1_func_info[6] = {
   { &vp9_highbd_fht4x4_c, &highbd_iht_wrapper<vp9_highbd_iht4x4_16_add_sse4_1>,
     4, 2 },
+  { &vp9_highbd_fht4x4_sse4_1,
+    &highbd_iht_wrapper<vp9_highbd_iht4x4_16_add_sse4_1>, 4, 2 },
   { vp9_highbd_fht8x8_c, &highbd_iht_wrapper<vp9_highbd_iht8x8_64_add_sse4_1>,
     8, 2 },
+  { &vp9_highbd_fht8x8_sse4_1,
+    &highbd_iht_wrapper<vp9_highbd_iht8x8_64_add_sse4_1>, 8, 2 },
   { &vp9_highbd_fht16x16_c,
+    &highbd_iht_wrapper<vp9_highbd_iht16x16_256_add_sse4_1>, 16, 2 },
+  { &vp9_highbd_fht16x16_sse4_1,
     &highbd_iht_wrapper<vp9_highbd_iht16x16_256_add_sse4_1>, 16, 2 }
 };
 
 INSTANTIATE_TEST_SUITE_P(
     SSE4_1, TransHT,
-    ::testing::Combine(::testing::Range(0, 3),
+    ::testing::Combine(::testing::Range(0, 6),
                        ::testing::Values(ht_sse4_1_func_info),
                        ::testing::Range(0, 4),
                        ::testing::Values(VPX_BITS_8, VPX_BITS_10,
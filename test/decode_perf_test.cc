@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <ctime>
 #include <string>
 #include <tuple>
 
@@ -110,6 +111,64 @@ TEST_P(DecodePerfTest, PerfTest) {
 INSTANTIATE_TEST_SUITE_P(VP9, DecodePerfTest,
                          ::testing::ValuesIn(kVP9DecodePerfVectors));
 
+#if CONFIG_VP8_DECODER
+/*
+ VP8RowMtDecodePerfTest takes a number of threads + VP8D_SET_ROW_MT value. The
+ process CPU time is reported alongside the wall time, it includes the time
+ threads spend waiting on the row above.
+ */
+typedef std::tuple<unsigned, int> VP8RowMtDecodePerfParam;
+
+const char kVP8DecodePerfVideo[] = "tos_vp8.webm";
+
+class VP8RowMtDecodePerfTest
+    : public ::testing::TestWithParam<VP8RowMtDecodePerfParam> {};
+
+TEST_P(VP8RowMtDecodePerfTest, PerfTest) {
+  const unsigned threads = std::get<0>(GetParam());
+  const int row_mt = std::get<1>(GetParam());
+
+  libvpx_test::WebMVideoSource video(kVP8DecodePerfVideo);
+  video.Init();
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  libvpx_test::VP8Decoder decoder(cfg, 0);
+  decoder.Control(VP8D_SET_ROW_MT, row_mt);
+
+  vpx_usec_timer t;
+  vpx_usec_timer_start(&t);
+  const std::clock_t cpu_start = std::clock();
+
+  for (video.Begin(); video.cxdata() != nullptr; video.Next()) {
+    decoder.DecodeFrame(video.cxdata(), video.frame_size());
+  }
+
+  const std::clock_t cpu_end = std::clock();
+  vpx_usec_timer_mark(&t);
+  const double elapsed_secs = double(vpx_usec_timer_elapsed(&t)) / kUsecsInSec;
+  const double cpu_secs = double(cpu_end - cpu_start) / CLOCKS_PER_SEC;
+  const unsigned frames = video.frame_number();
+  const double fps = double(frames) / elapsed_secs;
+
+  printf("{\n");
+  printf("\t\"type\" : \"decode_perf_test\",\n");
+  printf("\t\"version\" : \"%s\",\n", vpx_codec_version_str());
+  printf("\t\"videoName\" : \"%s\",\n", kVP8DecodePerfVideo);
+  printf("\t\"threadCount\" : %u,\n", threads);
+  printf("\t\"rowMt\" : %d,\n", row_mt);
+  printf("\t\"decodeTimeSecs\" : %f,\n", elapsed_secs);
+  printf("\t\"cpuTimeSecs\" : %f,\n", cpu_secs);
+  printf("\t\"totalFrames\" : %u,\n", frames);
+  printf("\t\"framesPerSecond\" : %f\n", fps);
+  printf("}\n");
+}
+
+INSTANTIATE_TEST_SUITE_P(VP8, VP8RowMtDecodePerfTest,
+                         ::testing::Combine(::testing::Values(1, 2, 4, 8),
+                                            ::testing::Values(0, 1)));
+#endif  // CONFIG_VP8_DECODER
+
 class VP9NewEncodeDecodePerfTest
     : public ::libvpx_test::EncoderTest,
       public ::libvpx_test::CodecTestWithParam<libvpx_test::TestMode> {
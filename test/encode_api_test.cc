@@ -8,17 +8,21 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <climits>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <initializer_list>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "test/acm_random.h"
+#include "test/md5_helper.h"
 #include "test/video_source.h"
 #include "test/y4m_video_source.h"
 
@@ -171,6 +175,31 @@ TEST(EncodeAPI, HighBitDepthCapability) {
 #endif
 }
 
+// Encodes |img|, or flushes |enc| if it is null, and passes every packet that
+// comes out to |handle_pkt|. Returns the number of frame packets.
+int EncodeAndCollect(
+    vpx_codec_ctx_t *enc, const vpx_image_t *img, vpx_codec_pts_t pts,
+    vpx_enc_deadline_t deadline,
+    const std::function<void(const vpx_codec_cx_pkt_t &)> &handle_pkt) {
+  EXPECT_EQ(vpx_codec_encode(enc, img, pts, 1, 0, deadline), VPX_CODEC_OK);
+  vpx_codec_iter_t iter = nullptr;
+  const vpx_codec_cx_pkt_t *pkt;
+  int num_frame_pkts = 0;
+  while ((pkt = vpx_codec_get_cx_data(enc, &iter)) != nullptr) {
+    if (pkt->kind == VPX_CODEC_CX_FRAME_PKT) ++num_frame_pkts;
+    handle_pkt(*pkt);
+  }
+  return num_frame_pkts;
+}
+
+// Appends the data of a frame packet to |stream|.
+void AppendFramePkt(const vpx_codec_cx_pkt_t &pkt,
+                    std::vector<uint8_t> *stream) {
+  if (pkt.kind != VPX_CODEC_CX_FRAME_PKT) return;
+  const uint8_t *const buf = static_cast<const uint8_t *>(pkt.data.frame.buf);
+  stream->insert(stream->end(), buf, buf + pkt.data.frame.sz);
+}
+
 #if CONFIG_VP8_ENCODER
 TEST(EncodeAPI, ImageSizeSetting) {
   const int width = 711;
@@ -651,6 +680,55 @@ TEST(EncodeAPI, OssFuzz69906) {
     EncodeOssFuzz69906(cpu_used, VPX_DL_REALTIME);
   }
 }
+
+// Encodes noise in realtime mode with |threads| threads and eight token
+// partitions, and returns the MD5 of the compressed frames.
+std::string EncodeVp8RealtimeMd5(unsigned int threads) {
+  vpx_codec_iface_t *const iface = vpx_codec_vp8_cx();
+  vpx_codec_enc_cfg_t cfg;
+  EXPECT_EQ(vpx_codec_enc_config_default(iface, &cfg, 0), VPX_CODEC_OK);
+  cfg.g_w = 352;
+  cfg.g_h = 288;
+  cfg.g_lag_in_frames = 0;
+  cfg.rc_end_usage = VPX_CBR;
+  cfg.rc_target_bitrate = 1000;
+  // Keeps the noise frames well within the size of the token partitions.
+  cfg.rc_min_quantizer = 32;
+  cfg.g_threads = threads;
+
+  vpx_codec_ctx_t enc;
+  EXPECT_EQ(vpx_codec_enc_init(&enc, iface, &cfg, 0), VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP8E_SET_CPUUSED, -6), VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP8E_SET_TOKEN_PARTITIONS,
+                              VP8_EIGHT_TOKENPARTITION),
+            VPX_CODEC_OK);
+
+  std::vector<uint8_t> stream;
+  libvpx_test::RandomVideoSource video;
+  video.SetSize(cfg.g_w, cfg.g_h);
+  video.set_limit(10);
+  for (video.Begin(); video.img() != nullptr; video.Next()) {
+    EncodeAndCollect(&enc, video.img(), video.pts(), VPX_DL_REALTIME,
+                     [&stream](const vpx_codec_cx_pkt_t &pkt) {
+                       AppendFramePkt(pkt, &stream);
+                     });
+  }
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+
+  libvpx_test::MD5 md5;
+  md5.Add(stream.data(), stream.size());
+  return md5.Get();
+}
+
+// Rows are encoded in any order by any thread. With on-the-fly bitpacking
+// they are also packed straight into the token partitions, which have to
+// come out the same as with a single thread.
+TEST(EncodeAPI, Vp8MultiThreadMatchesSingleThread) {
+  const std::string md5 = EncodeVp8RealtimeMd5(1);
+  for (const unsigned int threads : { 2, 4, 8 }) {
+    EXPECT_EQ(md5, EncodeVp8RealtimeMd5(threads)) << "threads: " << threads;
+  }
+}
 #endif  // CONFIG_VP8_ENCODER
 
 // Set up 2 spatial streams with 2 temporal layers per stream, and generate
@@ -1036,6 +1114,102 @@ TEST(EncodeAPI, PtsOrDurationTooBig) {
   }
 }
 
+constexpr unsigned int kCxDataPadBefore = 7;
+constexpr unsigned int kCxDataPadAfter = 5;
+constexpr uint8_t kCxDataFill = 0xa5;
+
+// Fills |packets| with the frame packets of 40 frames encoded with
+// |lag_in_frames| and alt refs on. When |buf| is set, it's given to
+// vpx_codec_set_cx_data_buf() before each call to vpx_codec_encode(), which
+// must write the packets there itself, padded and in order, rather than leave
+// vpx_codec_get_cx_data() to copy them.
+void EncodeWithCxDataBuf(vpx_codec_iface_t *iface, unsigned int lag_in_frames,
+                         std::vector<uint8_t> *buf,
+                         std::vector<std::vector<uint8_t>> *packets) {
+  vpx_codec_enc_cfg_t cfg;
+  ASSERT_EQ(vpx_codec_enc_config_default(iface, &cfg, 0), VPX_CODEC_OK);
+  cfg.g_w = 64;
+  cfg.g_h = 64;
+  cfg.g_lag_in_frames = lag_in_frames;
+  vpx_codec_ctx_t enc;
+  ASSERT_EQ(vpx_codec_enc_init(&enc, iface, &cfg, 0), VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_control(&enc, VP8E_SET_CPUUSED, 4), VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_control(&enc, VP8E_SET_ENABLEAUTOALTREF, 1),
+            VPX_CODEC_OK);
+
+  libvpx_test::RandomVideoSource video;
+  video.SetSize(cfg.g_w, cfg.g_h);
+  video.set_limit(40);
+  video.Begin();
+  // One pass VP9 only codes alt refs, held back for the next superframe, in
+  // realtime mode.
+  const vpx_enc_deadline_t deadline =
+      IsVP9(iface) ? VPX_DL_REALTIME : VPX_DL_GOOD_QUALITY;
+  bool flushing = false;
+  for (;;) {
+    if (buf != nullptr) {
+      std::fill(buf->begin(), buf->end(), kCxDataFill);
+      const vpx_fixed_buf_t fixed_buf = { buf->data(), buf->size() };
+      ASSERT_EQ(vpx_codec_set_cx_data_buf(&enc, &fixed_buf, kCxDataPadBefore,
+                                          kCxDataPadAfter),
+                VPX_CODEC_OK);
+    }
+    ASSERT_EQ(vpx_codec_encode(&enc, flushing ? nullptr : video.img(),
+                               video.pts(), video.duration(), 0, deadline),
+              VPX_CODEC_OK)
+        << vpx_codec_error_detail(&enc);
+    // What vpx_codec_encode() left in the buffer.
+    const std::vector<uint8_t> encoded =
+        buf != nullptr ? *buf : std::vector<uint8_t>();
+
+    vpx_codec_iter_t iter = nullptr;
+    const vpx_codec_cx_pkt_t *pkt;
+    size_t offset = 0;
+    bool got_data = false;
+    while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != nullptr) {
+      if (pkt->kind != VPX_CODEC_CX_FRAME_PKT) continue;
+      const uint8_t *data = static_cast<const uint8_t *>(pkt->data.frame.buf);
+      size_t size = pkt->data.frame.sz;
+      if (buf != nullptr) {
+        const auto is_fill = [](uint8_t b) { return b == kCxDataFill; };
+        ASSERT_EQ(data, buf->data() + offset);
+        ASSERT_GT(size, kCxDataPadBefore + kCxDataPadAfter);
+        const uint8_t *const written = encoded.data() + offset;
+        offset += size;
+        data += kCxDataPadBefore;
+        size -= kCxDataPadBefore + kCxDataPadAfter;
+        EXPECT_TRUE(std::all_of(written, written + kCxDataPadBefore, is_fill));
+        EXPECT_EQ(memcmp(written + kCxDataPadBefore, data, size), 0);
+        EXPECT_TRUE(std::all_of(written + kCxDataPadBefore + size,
+                                written + kCxDataPadBefore + size +
+                                    kCxDataPadAfter,
+                                is_fill));
+      }
+      packets->emplace_back(data, data + size);
+      got_data = true;
+    }
+    if (flushing && !got_data) break;
+    video.Next();
+    flushing = video.img() == nullptr;
+  }
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+}
+
+TEST(EncodeAPI, SetCxDataBufWritesInPlace) {
+  std::vector<uint8_t> buf(1 << 20);
+  for (const auto *iface : kCodecIfaces) {
+    for (const unsigned int lag_in_frames : { 0u, 25u }) {
+      SCOPED_TRACE(vpx_codec_iface_name(iface));
+      SCOPED_TRACE(lag_in_frames);
+      std::vector<std::vector<uint8_t>> expected, packets;
+      EncodeWithCxDataBuf(iface, lag_in_frames, nullptr, &expected);
+      ASSERT_FALSE(expected.empty());
+      EncodeWithCxDataBuf(iface, lag_in_frames, &buf, &packets);
+      EXPECT_EQ(expected, packets);
+    }
+  }
+}
+
 #if CONFIG_VP9_ENCODER
 // Frame size needed to trigger the overflow exceeds the max buffer allowed on
 // 32-bit systems defined by VPX_MAX_ALLOCABLE_MEMORY
@@ -1922,6 +2096,354 @@ TEST(EncodeAPI, Chromium352414650) {
   ASSERT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
 }
 
+// Source frame laid out as required by VP9E_SET_EXTERNAL_SOURCE_BUFFERS, with
+// VP9E_SOURCE_BORDER_IN_PIXELS of border around each plane.
+struct BorderedFrame {
+  std::vector<uint8_t> data;
+  vpx_image_t img;
+  int released;
+};
+
+void InitBorderedFrame(int width, int height, libvpx_test::ACMRandom *rnd,
+                       BorderedFrame *frame) {
+  const int border = VP9E_SOURCE_BORDER_IN_PIXELS;
+  const int y_stride = (((width + 7) & ~7) + 2 * border + 31) & ~31;
+  const int uv_stride = y_stride / 2;
+  const int uv_w = (width + 1) / 2;
+  const int uv_h = (height + 1) / 2;
+  const size_t y_size = static_cast<size_t>(y_stride) * (height + 2 * border);
+  const size_t uv_size = static_cast<size_t>(uv_stride) * (uv_h + border);
+  frame->data.assign(y_size + 2 * uv_size, 0);
+  frame->released = 0;
+
+  uint8_t *const base = frame->data.data();
+  vpx_img_wrap(&frame->img, VPX_IMG_FMT_I420, width, height, 1, base);
+  frame->img.planes[VPX_PLANE_Y] = base + border * y_stride + border;
+  frame->img.planes[VPX_PLANE_U] =
+      base + y_size + (border / 2) * uv_stride + border / 2;
+  frame->img.planes[VPX_PLANE_V] = frame->img.planes[VPX_PLANE_U] + uv_size;
+  frame->img.stride[VPX_PLANE_Y] = y_stride;
+  frame->img.stride[VPX_PLANE_U] = uv_stride;
+  frame->img.stride[VPX_PLANE_V] = uv_stride;
+  frame->img.user_priv = frame;
+
+  for (int r = 0; r < height; ++r) {
+    for (int c = 0; c < width; ++c) {
+      frame->img.planes[VPX_PLANE_Y][r * y_stride + c] = rnd->Rand8();
+    }
+  }
+  for (int plane = VPX_PLANE_U; plane <= VPX_PLANE_V; ++plane) {
+    for (int r = 0; r < uv_h; ++r) {
+      for (int c = 0; c < uv_w; ++c) {
+        frame->img.planes[plane][r * uv_stride + c] = rnd->Rand8();
+      }
+    }
+  }
+}
+
+void ReleaseBorderedFrame(void *cb_priv, const vpx_image_t *img) {
+  BorderedFrame *const frame = static_cast<BorderedFrame *>(img->user_priv);
+  ++frame->released;
+  ++*static_cast<int *>(cb_priv);
+}
+
+// Encodes |frames| and returns the compressed stream. With |zero_copy| set
+// the frames are handed to the encoder by reference.
+std::vector<uint8_t> EncodeBorderedFrames(std::vector<BorderedFrame> *frames,
+                                          bool zero_copy, int *num_released,
+                                          int *released_before_flush) {
+  vpx_codec_iface_t *const iface = vpx_codec_vp9_cx();
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+  std::vector<uint8_t> stream;
+  EXPECT_EQ(vpx_codec_enc_config_default(iface, &cfg, 0), VPX_CODEC_OK);
+  cfg.g_w = (*frames)[0].img.d_w;
+  cfg.g_h = (*frames)[0].img.d_h;
+  cfg.g_lag_in_frames = 5;
+  EXPECT_EQ(vpx_codec_enc_init(&enc, iface, &cfg, 0), VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP8E_SET_CPUUSED, 4), VPX_CODEC_OK);
+  if (zero_copy) {
+    vpx_source_release_cb_t release = { ReleaseBorderedFrame, num_released };
+    EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_EXTERNAL_SOURCE_BUFFERS,
+                                &release),
+              VPX_CODEC_OK);
+  }
+
+  const auto append = [&stream](const vpx_codec_cx_pkt_t &pkt) {
+    AppendFramePkt(pkt, &stream);
+  };
+  const int num_frames = static_cast<int>(frames->size());
+  for (int i = 0; i < num_frames; ++i) {
+    EncodeAndCollect(&enc, &(*frames)[i].img, i, VPX_DL_GOOD_QUALITY, append);
+  }
+  *released_before_flush = *num_released;
+  while (EncodeAndCollect(&enc, nullptr, num_frames, VPX_DL_GOOD_QUALITY,
+                          append) > 0) {
+  }
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+  return stream;
+}
+
+TEST(EncodeAPI, VP9ExternalSourceBuffers) {
+  constexpr int kWidth = 100;
+  constexpr int kHeight = 74;
+  constexpr int kNumFrames = 12;
+  libvpx_test::ACMRandom rnd(libvpx_test::ACMRandom::DeterministicSeed());
+  std::vector<BorderedFrame> frames(kNumFrames);
+  for (auto &frame : frames) InitBorderedFrame(kWidth, kHeight, &rnd, &frame);
+
+  int num_released = 0;
+  int released_before_flush = 0;
+  const std::vector<uint8_t> copied = EncodeBorderedFrames(
+      &frames, false, &num_released, &released_before_flush);
+  EXPECT_EQ(num_released, 0);
+
+  const std::vector<uint8_t> referenced = EncodeBorderedFrames(
+      &frames, true, &num_released, &released_before_flush);
+  EXPECT_EQ(copied, referenced);
+  // Every frame comes back exactly once, and frames are not all held until
+  // the end of the stream.
+  EXPECT_EQ(num_released, kNumFrames);
+  for (const auto &frame : frames) EXPECT_EQ(frame.released, 1);
+  EXPECT_GT(released_before_flush, 0);
+}
+
+TEST(EncodeAPI, VP9ExternalSourceBuffersWithoutBorder) {
+  vpx_codec_iface_t *const iface = vpx_codec_vp9_cx();
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+  ASSERT_EQ(vpx_codec_enc_config_default(iface, &cfg, 0), VPX_CODEC_OK);
+  cfg.g_w = 64;
+  cfg.g_h = 64;
+  ASSERT_EQ(vpx_codec_enc_init(&enc, iface, &cfg, 0), VPX_CODEC_OK);
+  int num_released = 0;
+  vpx_source_release_cb_t release = { ReleaseBorderedFrame, &num_released };
+  ASSERT_EQ(
+      vpx_codec_control(&enc, VP9E_SET_EXTERNAL_SOURCE_BUFFERS, &release),
+      VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_EXTERNAL_SOURCE_BUFFERS,
+                              static_cast<vpx_source_release_cb_t *>(nullptr)),
+            VPX_CODEC_INVALID_PARAM);
+
+  // A frame without the required border is copied and handed back before
+  // vpx_codec_encode() returns.
+  BorderedFrame frame;
+  frame.released = 0;
+  vpx_image_t *const image =
+      CreateImage(VPX_BITS_8, VPX_IMG_FMT_I420, cfg.g_w, cfg.g_h);
+  ASSERT_NE(image, nullptr);
+  image->user_priv = &frame;
+  ASSERT_EQ(vpx_codec_encode(&enc, image, 0, 1, 0, VPX_DL_GOOD_QUALITY),
+            VPX_CODEC_OK);
+  EXPECT_EQ(num_released, 1);
+  EXPECT_EQ(frame.released, 1);
+
+  vpx_img_free(image);
+  ASSERT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+  EXPECT_EQ(num_released, 1);
+}
+
+TEST(EncodeAPI, VP9ExternalSourceBuffersOnError) {
+  vpx_codec_iface_t *const iface = vpx_codec_vp9_cx();
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+  ASSERT_EQ(vpx_codec_enc_config_default(iface, &cfg, 0), VPX_CODEC_OK);
+  cfg.g_w = 64;
+  cfg.g_h = 64;
+  ASSERT_EQ(vpx_codec_enc_init(&enc, iface, &cfg, 0), VPX_CODEC_OK);
+  int num_released = 0;
+  vpx_source_release_cb_t release = { ReleaseBorderedFrame, &num_released };
+  ASSERT_EQ(
+      vpx_codec_control(&enc, VP9E_SET_EXTERNAL_SOURCE_BUFFERS, &release),
+      VPX_CODEC_OK);
+  libvpx_test::ACMRandom rnd(libvpx_test::ACMRandom::DeterministicSeed());
+  BorderedFrame frames[3];
+  InitBorderedFrame(cfg.g_w, cfg.g_h, &rnd, &frames[0]);
+  InitBorderedFrame(cfg.g_w + 2, cfg.g_h, &rnd, &frames[1]);
+  InitBorderedFrame(cfg.g_w, cfg.g_h, &rnd, &frames[2]);
+
+  // A frame rejected by vpx_codec_encode(), before or after the encoder
+  // would have taken it, is handed back before the call returns.
+  ASSERT_EQ(vpx_codec_encode(&enc, &frames[0].img, 1, 1, 0,
+                             VPX_DL_GOOD_QUALITY),
+            VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_encode(&enc, &frames[1].img, 2, 1, 0,
+                             VPX_DL_GOOD_QUALITY),
+            VPX_CODEC_INVALID_PARAM);
+  EXPECT_EQ(frames[1].released, 1);
+  // pts smaller than the initial pts.
+  EXPECT_EQ(vpx_codec_encode(&enc, &frames[2].img, 0, 1, 0,
+                             VPX_DL_GOOD_QUALITY),
+            VPX_CODEC_INVALID_PARAM);
+  EXPECT_EQ(frames[2].released, 1);
+
+  ASSERT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+  EXPECT_EQ(num_released, 3);
+  EXPECT_EQ(frames[0].released, 1);
+}
+
+using PsnrPkt = decltype(vpx_codec_cx_pkt_t::data.psnr);
+
+// Encodes the frames of |video| with VPX_CODEC_USE_PSNR and returns the PSNR
+// packets in output order. |first_pkt_is_frame| is set if a frame packet came
+// first.
+std::vector<PsnrPkt> EncodeWithPsnr(libvpx_test::DummyVideoSource *video,
+                                    int threads, bool async_psnr,
+                                    bool *first_pkt_is_frame) {
+  vpx_codec_iface_t *const iface = vpx_codec_vp9_cx();
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+  std::vector<PsnrPkt> psnr;
+  int num_frame_pkts = 0;
+  video->Begin();
+  EXPECT_EQ(vpx_codec_enc_config_default(iface, &cfg, 0), VPX_CODEC_OK);
+  cfg.g_w = video->img()->d_w;
+  cfg.g_h = video->img()->d_h;
+  cfg.g_lag_in_frames = 3;
+  cfg.g_threads = threads;
+  EXPECT_EQ(vpx_codec_enc_init(&enc, iface, &cfg, VPX_CODEC_USE_PSNR),
+            VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP8E_SET_CPUUSED, 4), VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_ROW_MT, 1), VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_ASYNC_PSNR, async_psnr ? 1 : 0),
+            VPX_CODEC_OK);
+
+  *first_pkt_is_frame = false;
+  const auto collect = [&](const vpx_codec_cx_pkt_t &pkt) {
+    if (pkt.kind == VPX_CODEC_CX_FRAME_PKT) {
+      if (num_frame_pkts++ == 0 && psnr.empty()) *first_pkt_is_frame = true;
+    } else if (pkt.kind == VPX_CODEC_PSNR_PKT) {
+      psnr.push_back(pkt.data.psnr);
+    }
+  };
+  for (; video->img() != nullptr; video->Next()) {
+    EncodeAndCollect(&enc, video->img(), video->pts(), VPX_DL_GOOD_QUALITY,
+                     collect);
+  }
+  while (EncodeAndCollect(&enc, nullptr, video->pts(), VPX_DL_GOOD_QUALITY,
+                          collect) > 0) {
+  }
+  EXPECT_EQ(static_cast<int>(psnr.size()), num_frame_pkts);
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+  return psnr;
+}
+
+void ExpectSamePsnr(const std::vector<PsnrPkt> &a,
+                    const std::vector<PsnrPkt> &b) {
+  ASSERT_EQ(a.size(), b.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    for (int j = 0; j < 4; ++j) {
+      EXPECT_EQ(a[i].samples[j], b[i].samples[j]) << "frame " << i;
+      EXPECT_EQ(a[i].sse[j], b[i].sse[j]) << "frame " << i;
+      EXPECT_EQ(a[i].psnr[j], b[i].psnr[j]) << "frame " << i;
+    }
+  }
+}
+
+TEST(EncodeAPI, VP9ThreadedAndAsyncPsnr) {
+  // Three 64-row bands, the last one partial.
+  constexpr int kWidth = 96;
+  constexpr int kHeight = 150;
+  constexpr int kNumFrames = 8;
+  libvpx_test::RandomVideoSource video;
+  video.SetSize(kWidth, kHeight);
+  video.set_limit(kNumFrames);
+
+  bool first_pkt_is_frame;
+  const std::vector<PsnrPkt> sync_psnr =
+      EncodeWithPsnr(&video, 1, false, &first_pkt_is_frame);
+  EXPECT_FALSE(first_pkt_is_frame);
+  EXPECT_EQ(static_cast<int>(sync_psnr.size()), kNumFrames);
+
+  ExpectSamePsnr(sync_psnr,
+                 EncodeWithPsnr(&video, 4, false, &first_pkt_is_frame));
+  EXPECT_FALSE(first_pkt_is_frame);
+
+  // The async packets trail their frames but carry the same values.
+  for (int threads : { 1, 4 }) {
+    SCOPED_TRACE(threads);
+    ExpectSamePsnr(sync_psnr,
+                   EncodeWithPsnr(&video, threads, true, &first_pkt_is_frame));
+    EXPECT_TRUE(first_pkt_is_frame);
+  }
+}
+
+// Encodes the frames of |video| as 3 spatial layers scaled by
+// |scaling_num| / 12 and returns the superframes.
+std::vector<uint8_t> EncodeSvcLayers(libvpx_test::DummyVideoSource *video,
+                                     const int scaling_num[3],
+                                     bool async_scale) {
+  vpx_codec_iface_t *const iface = vpx_codec_vp9_cx();
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+  std::vector<uint8_t> stream;
+  video->Begin();
+  EXPECT_EQ(vpx_codec_enc_config_default(iface, &cfg, 0), VPX_CODEC_OK);
+  cfg.g_w = video->img()->d_w;
+  cfg.g_h = video->img()->d_h;
+  cfg.g_lag_in_frames = 0;
+  cfg.g_threads = 4;
+  cfg.rc_end_usage = VPX_CBR;
+  cfg.rc_target_bitrate = 600;
+  cfg.rc_dropframe_thresh = 0;
+  cfg.ss_number_layers = 3;
+  cfg.ts_number_layers = 1;
+  cfg.ts_rate_decimator[0] = 1;
+  cfg.layer_target_bitrate[0] = 100;
+  cfg.layer_target_bitrate[1] = 200;
+  cfg.layer_target_bitrate[2] = 300;
+  cfg.temporal_layering_mode = VP9E_TEMPORAL_LAYERING_MODE_NOLAYERING;
+  EXPECT_EQ(vpx_codec_enc_init(&enc, iface, &cfg, 0), VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP8E_SET_CPUUSED, 7), VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_ROW_MT, 1), VPX_CODEC_OK);
+
+  vpx_svc_extra_cfg_t svc_cfg = {};
+  for (int sl = 0; sl < 3; ++sl) {
+    svc_cfg.max_quantizers[sl] = 56;
+    svc_cfg.min_quantizers[sl] = 2;
+    svc_cfg.scaling_factor_num[sl] = scaling_num[sl];
+    svc_cfg.scaling_factor_den[sl] = 12;
+  }
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_SVC_PARAMETERS, &svc_cfg),
+            VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_SVC, 1), VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_SVC_ASYNC_SCALE,
+                              async_scale ? 1 : 0),
+            VPX_CODEC_OK);
+
+  for (; video->img() != nullptr; video->Next()) {
+    EncodeAndCollect(&enc, video->img(), video->pts(), VPX_DL_REALTIME,
+                     [&stream](const vpx_codec_cx_pkt_t &pkt) {
+                       AppendFramePkt(pkt, &stream);
+                     });
+  }
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+  return stream;
+}
+
+TEST(EncodeAPI, VP9SvcAsyncScale) {
+  // Layers for the general scaler, the non-normative one below 1/2, the 4:3
+  // scaler and the dyadic layers that reuse the two-stage scaling.
+  static const int kScalingNum[][3] = {
+    { 4, 8, 12 }, { 2, 8, 12 }, { 6, 9, 12 }, { 3, 6, 12 }
+  };
+  constexpr int kWidth = 192;
+  constexpr int kHeight = 108;
+  constexpr int kNumFrames = 6;
+  libvpx_test::RandomVideoSource video;
+  video.SetSize(kWidth, kHeight);
+  video.set_limit(kNumFrames);
+
+  for (const auto &scaling_num : kScalingNum) {
+    SCOPED_TRACE(scaling_num[0]);
+    SCOPED_TRACE(scaling_num[1]);
+    const std::vector<uint8_t> sync_stream =
+        EncodeSvcLayers(&video, scaling_num, false);
+    EXPECT_FALSE(sync_stream.empty());
+    EXPECT_EQ(sync_stream, EncodeSvcLayers(&video, scaling_num, true));
+  }
+}
+
 #endif  // CONFIG_VP9_ENCODER
 
 }  // namespace
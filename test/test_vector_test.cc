@@ -58,9 +58,17 @@ class TestVectorTest : public ::libvpx_test::DecoderTest,
         << "Md5 file open failed. Filename: " << md5_file_name_;
   }
 
-#if CONFIG_VP9_DECODER
   void PreDecodeFrameHook(const libvpx_test::CompressedVideoSource &video,
                           libvpx_test::Decoder *decoder) override {
+#if CONFIG_VP8_DECODER
+    if (decoder->IsVP8()) {
+      if (video.frame_number() == 0 && mt_mode_ >= 0) {
+        decoder->Control(VP8D_SET_ROW_MT, mt_mode_);
+      }
+      return;
+    }
+#endif
+#if CONFIG_VP9_DECODER
     if (video.frame_number() == 0 && mt_mode_ >= 0) {
       if (mt_mode_ == 1) {
         decoder->Control(VP9D_SET_LOOP_FILTER_OPT, 1);
@@ -68,13 +76,18 @@ class TestVectorTest : public ::libvpx_test::DecoderTest,
       } else if (mt_mode_ == 2) {
         decoder->Control(VP9D_SET_LOOP_FILTER_OPT, 0);
         decoder->Control(VP9D_SET_ROW_MT, 1);
+      } else if (mt_mode_ == 3) {
+        decoder->Control(VP9D_SET_LAZY_BORDER, 1);
       } else {
         decoder->Control(VP9D_SET_LOOP_FILTER_OPT, 0);
         decoder->Control(VP9D_SET_ROW_MT, 0);
       }
     }
-  }
+#else
+    (void)video;
+    (void)decoder;
 #endif
+  }
 
   void DecompressedFrameHook(const vpx_image_t &img,
                              const unsigned int frame_number) override {
@@ -169,7 +182,7 @@ INSTANTIATE_TEST_SUITE_P(
             static_cast<const libvpx_test::CodecFactory *>(&libvpx_test::kVP8)),
         ::testing::Combine(
             ::testing::Range(2, 9),  // With 2 ~ 8 threads.
-            ::testing::Values(-1),   // LPF opt and Row MT is not applicable
+            ::testing::Range(0, 2),  // 0: static rows, 1: row MT
             ::testing::ValuesIn(libvpx_test::kVP8TestVectors,
                                 libvpx_test::kVP8TestVectors +
                                     libvpx_test::kNumVP8TestVectors))));
@@ -200,5 +213,18 @@ INSTANTIATE_TEST_SUITE_P(
             ::testing::ValuesIn(libvpx_test::kVP9TestVectors,
                                 libvpx_test::kVP9TestVectors +
                                     libvpx_test::kNumVP9TestVectors))));
+
+// Test VP9 decode with the frames allocated without a border.
+INSTANTIATE_TEST_SUITE_P(
+    VP9LazyBorder, TestVectorTest,
+    ::testing::Combine(
+        ::testing::Values(
+            static_cast<const libvpx_test::CodecFactory *>(&libvpx_test::kVP9)),
+        ::testing::Combine(
+            ::testing::Values(1, 4),  // With 1 and 4 threads.
+            ::testing::Values(3),     // 3: Lazy border
+            ::testing::ValuesIn(libvpx_test::kVP9TestVectors,
+                                libvpx_test::kVP9TestVectors +
+                                    libvpx_test::kNumVP9TestVectors))));
 #endif
 }  // namespace
@@ -1555,6 +1555,39 @@ INSTANTIATE_TEST_SUITE_P(
                                 0)));
 #endif  // HAVE_AVX2
 
+#if HAVE_AVX512
+INSTANTIATE_TEST_SUITE_P(
+    AVX512, VpxVarianceTest,
+    ::testing::Values(VarianceParams(6, 6, &vpx_variance64x64_avx512),
+                      VarianceParams(6, 5, &vpx_variance64x32_avx512),
+                      VarianceParams(5, 6, &vpx_variance32x64_avx512),
+                      VarianceParams(5, 5, &vpx_variance32x32_avx512),
+                      VarianceParams(5, 4, &vpx_variance32x16_avx512)));
+
+INSTANTIATE_TEST_SUITE_P(
+    AVX512, VpxSubpelVarianceTest,
+    ::testing::Values(
+        SubpelVarianceParams(6, 6, &vpx_sub_pixel_variance64x64_avx512, 0),
+        SubpelVarianceParams(6, 5, &vpx_sub_pixel_variance64x32_avx512, 0),
+        SubpelVarianceParams(5, 6, &vpx_sub_pixel_variance32x64_avx512, 0),
+        SubpelVarianceParams(5, 5, &vpx_sub_pixel_variance32x32_avx512, 0),
+        SubpelVarianceParams(5, 4, &vpx_sub_pixel_variance32x16_avx512, 0)));
+
+INSTANTIATE_TEST_SUITE_P(
+    AVX512, VpxSubpelAvgVarianceTest,
+    ::testing::Values(
+        SubpelAvgVarianceParams(6, 6, &vpx_sub_pixel_avg_variance64x64_avx512,
+                                0),
+        SubpelAvgVarianceParams(6, 5, &vpx_sub_pixel_avg_variance64x32_avx512,
+                                0),
+        SubpelAvgVarianceParams(5, 6, &vpx_sub_pixel_avg_variance32x64_avx512,
+                                0),
+        SubpelAvgVarianceParams(5, 5, &vpx_sub_pixel_avg_variance32x32_avx512,
+                                0),
+        SubpelAvgVarianceParams(5, 4, &vpx_sub_pixel_avg_variance32x16_avx512,
+                                0)));
+#endif  // HAVE_AVX512
+
 #if HAVE_NEON
 INSTANTIATE_TEST_SUITE_P(NEON, VpxSseTest,
                          ::testing::Values(SseParams(2, 2,
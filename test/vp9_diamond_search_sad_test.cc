@@ -0,0 +1,249 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "gtest/gtest.h"
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "./vpx_dsp_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "vp9/common/vp9_entropymv.h"
+#include "vp9/encoder/vp9_block.h"
+#include "vp9/encoder/vp9_mcomp.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_mem/vpx_mem.h"
+#include "vpx_ports/vpx_timer.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+
+typedef int (*DiamondSearchSadFunc)(const MACROBLOCK *x,
+                                    const search_site_config *cfg, MV *ref_mv,
+                                    uint32_t start_mv_sad, MV *best_mv,
+                                    int search_param, int sad_per_bit,
+                                    int *num00,
+                                    const vp9_sad_fn_ptr_t *sad_fn_ptr,
+                                    const MV *center_mv);
+
+// The search is done for a 16x16 block in the middle of a frame with a border
+// wide enough for the motion vector limits.
+const int kBlockSize = 16;
+const int kMvRange = 48;
+const int kBorder = kMvRange + 16;
+const int kStride = 2 * kBorder + kBlockSize;
+const int kNumIterations = 10000;
+
+class DiamondSearchSadTest
+    : public ::testing::TestWithParam<DiamondSearchSadFunc> {
+ public:
+  ~DiamondSearchSadTest() override = default;
+
+  void SetUp() override {
+    search_func_ = GetParam();
+    rnd_.Reset(ACMRandom::DeterministicSeed());
+
+    src_ = reinterpret_cast<uint8_t *>(
+        vpx_memalign(16, kBlockSize * kBlockSize * sizeof(*src_)));
+    ref_ = reinterpret_cast<uint8_t *>(
+        vpx_memalign(16, kStride * kStride * sizeof(*ref_)));
+    mvsadcost_ = reinterpret_cast<int *>(
+        vpx_calloc(2 * MV_VALS, sizeof(*mvsadcost_)));
+    x_ = reinterpret_cast<MACROBLOCK *>(vpx_calloc(1, sizeof(*x_)));
+    ASSERT_NE(src_, nullptr);
+    ASSERT_NE(ref_, nullptr);
+    ASSERT_NE(mvsadcost_, nullptr);
+    ASSERT_NE(x_, nullptr);
+
+    // Same cost tables as cal_nmvjointsadcost() and cal_nmvsadcosts() in
+    // vp9_encoder.c, the SIMD versions rely on their properties.
+    x_->nmvjointsadcost[0] = 600;
+    x_->nmvjointsadcost[1] = 300;
+    x_->nmvjointsadcost[2] = 300;
+    x_->nmvjointsadcost[3] = 300;
+    x_->nmvsadcost[0] = mvsadcost_ + MV_MAX;
+    x_->nmvsadcost[1] = mvsadcost_ + MV_VALS + MV_MAX;
+    for (int i = 1; i <= MV_MAX; ++i) {
+      const int z = static_cast<int>(256 * (2 * (log2f(8 * i) + .6)));
+      x_->nmvsadcost[0][i] = x_->nmvsadcost[0][-i] = z;
+      x_->nmvsadcost[1][i] = x_->nmvsadcost[1][-i] = z;
+    }
+
+    x_->plane[0].src.buf = src_;
+    x_->plane[0].src.stride = kBlockSize;
+    x_->e_mbd.plane[0].pre[0].buf = ref_ + kBorder * kStride + kBorder;
+    x_->e_mbd.plane[0].pre[0].stride = kStride;
+
+    sad_fn_.sdf = vpx_sad16x16;
+    sad_fn_.sdx4df = vpx_sad16x16x4d;
+  }
+
+  void TearDown() override {
+    vpx_free(src_);
+    vpx_free(ref_);
+    vpx_free(mvsadcost_);
+    vpx_free(x_);
+    libvpx_test::ClearSystemState();
+  }
+
+ protected:
+  // Fills the reference frame with a smooth pattern and copies the source
+  // block from a random position of it, so that the search has a well defined
+  // minimum to walk to. Some noise is added to break the ties.
+  void FillFrames() {
+    const int fx = rnd_.Rand8() % 16 + 1;
+    const int fy = rnd_.Rand8() % 16 + 1;
+    for (int r = 0; r < kStride; ++r) {
+      for (int c = 0; c < kStride; ++c) {
+        ref_[r * kStride + c] = static_cast<uint8_t>(
+            (r * fy + c * fx + (rnd_.Rand8() & 7)) & 0xff);
+      }
+    }
+    const int off_r = kBorder + rnd_.PseudoUniform(2 * kMvRange) - kMvRange;
+    const int off_c = kBorder + rnd_.PseudoUniform(2 * kMvRange) - kMvRange;
+    for (int r = 0; r < kBlockSize; ++r) {
+      for (int c = 0; c < kBlockSize; ++c) {
+        src_[r * kBlockSize + c] = static_cast<uint8_t>(
+            ref_[(off_r + r) * kStride + off_c + c] + (rnd_.Rand8() & 3));
+      }
+    }
+  }
+
+  void RandomizeLimits() {
+    x_->mv_limits.row_min = -static_cast<int>(rnd_.PseudoUniform(kMvRange));
+    x_->mv_limits.row_max = rnd_.PseudoUniform(kMvRange);
+    x_->mv_limits.col_min = -static_cast<int>(rnd_.PseudoUniform(kMvRange));
+    x_->mv_limits.col_max = rnd_.PseudoUniform(kMvRange);
+  }
+
+  MV RandomMv(int min_row, int max_row, int min_col, int max_col) {
+    MV mv;
+    mv.row = static_cast<int16_t>(min_row +
+                                  rnd_.PseudoUniform(max_row - min_row + 1));
+    mv.col = static_cast<int16_t>(min_col +
+                                  rnd_.PseudoUniform(max_col - min_col + 1));
+    return mv;
+  }
+
+  void RunCheckOutput(const search_site_config *cfg) {
+    for (int iter = 0; iter < kNumIterations; ++iter) {
+      FillFrames();
+      RandomizeLimits();
+      const MvLimits *const lim = &x_->mv_limits;
+      MV ref_mv =
+          RandomMv(lim->row_min, lim->row_max, lim->col_min, lim->col_max);
+      MV ref_mv_copy = ref_mv;
+      const MV center_mv = RandomMv(-8 * kMvRange, 8 * kMvRange,
+                                    -8 * kMvRange, 8 * kMvRange);
+      const int search_param = rnd_.PseudoUniform(MAX_MVSEARCH_STEPS - 1);
+      const int sad_per_bit = rnd_.PseudoUniform(256);
+      const uint32_t start_mv_sad =
+          sad_fn_.sdf(src_, kBlockSize,
+                      get_buf_from_mv(&x_->e_mbd.plane[0].pre[0], &ref_mv),
+                      kStride) +
+          rnd_.PseudoUniform(1024);
+
+      MV ref_best_mv, best_mv;
+      int ref_num00, num00;
+      const int ref_sad = vp9_diamond_search_sad_c(
+          x_, cfg, &ref_mv_copy, start_mv_sad, &ref_best_mv, search_param,
+          sad_per_bit, &ref_num00, &sad_fn_, &center_mv);
+      int sad;
+      ASM_REGISTER_STATE_CHECK(
+          sad = search_func_(x_, cfg, &ref_mv, start_mv_sad, &best_mv,
+                             search_param, sad_per_bit, &num00, &sad_fn_,
+                             &center_mv));
+
+      ASSERT_EQ(ref_sad, sad) << "iteration " << iter;
+      ASSERT_EQ(ref_best_mv.row, best_mv.row) << "iteration " << iter;
+      ASSERT_EQ(ref_best_mv.col, best_mv.col) << "iteration " << iter;
+      ASSERT_EQ(ref_num00, num00) << "iteration " << iter;
+    }
+  }
+
+  void RunSpeedTest(const search_site_config *cfg, const char *name) {
+    const int kSpeedIterations = 200000;
+    FillFrames();
+    x_->mv_limits.row_min = x_->mv_limits.col_min = -kMvRange;
+    x_->mv_limits.row_max = x_->mv_limits.col_max = kMvRange;
+    const MV center_mv = { 0, 0 };
+
+    for (int k = 0; k < 2; ++k) {
+      const DiamondSearchSadFunc func =
+          k == 0 ? vp9_diamond_search_sad_c : search_func_;
+      vpx_usec_timer timer;
+      vpx_usec_timer_start(&timer);
+      for (int i = 0; i < kSpeedIterations; ++i) {
+        MV ref_mv = { 0, 0 };
+        MV best_mv;
+        int num00;
+        func(x_, cfg, &ref_mv, UINT32_MAX / 2, &best_mv, 0, 64, &num00,
+             &sad_fn_, &center_mv);
+      }
+      vpx_usec_timer_mark(&timer);
+      const int elapsed_time =
+          static_cast<int>(vpx_usec_timer_elapsed(&timer) / 1000);
+      printf("%s diamond search %s time: %5d ms\n", name, k == 0 ? "c" : "opt",
+             elapsed_time);
+    }
+  }
+
+  DiamondSearchSadFunc search_func_;
+  ACMRandom rnd_;
+  uint8_t *src_;
+  uint8_t *ref_;
+  int *mvsadcost_;
+  MACROBLOCK *x_;
+  vp9_sad_fn_ptr_t sad_fn_;
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(DiamondSearchSadTest);
+
+TEST_P(DiamondSearchSadTest, DiamondMatchesC) {
+  search_site_config cfg;
+  vp9_init_dsmotion_compensation(&cfg, kStride);
+  RunCheckOutput(&cfg);
+}
+
+TEST_P(DiamondSearchSadTest, EightPointMatchesC) {
+  search_site_config cfg;
+  vp9_init3smotion_compensation(&cfg, kStride);
+  RunCheckOutput(&cfg);
+}
+
+TEST_P(DiamondSearchSadTest, DISABLED_Speed) {
+  search_site_config cfg;
+  vp9_init_dsmotion_compensation(&cfg, kStride);
+  RunSpeedTest(&cfg, "dsmotion");
+  vp9_init3smotion_compensation(&cfg, kStride);
+  RunSpeedTest(&cfg, "3smotion");
+}
+
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_SUITE_P(SSE4_1, DiamondSearchSadTest,
+                         ::testing::Values(&vp9_diamond_search_sad_sse4_1));
+#endif  // HAVE_SSE4_1
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, DiamondSearchSadTest,
+                         ::testing::Values(&vp9_diamond_search_sad_avx2));
+#endif  // HAVE_AVX2
+
+#if HAVE_NEON
+INSTANTIATE_TEST_SUITE_P(NEON, DiamondSearchSadTest,
+                         ::testing::Values(&vp9_diamond_search_sad_neon));
+#endif  // HAVE_NEON
+}  // namespace
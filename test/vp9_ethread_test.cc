@@ -437,6 +437,17 @@ INSTANTIATE_TEST_SUITE_P(
         ::testing::Range(2, 5)));  // threads
 
 #if !CONFIG_REALTIME_ONLY
+// Two pass encodes build the TPL model, which is multi-threaded with row-mt.
+INSTANTIATE_TEST_SUITE_P(
+    VP9TwoPass, VPxEncoderThreadTest,
+    ::testing::Combine(
+        ::testing::Values(
+            static_cast<const libvpx_test::CodecFactory *>(&libvpx_test::kVP9)),
+        ::testing::Values(libvpx_test::kTwoPassGood),
+        ::testing::Values(2),    // cpu_used
+        ::testing::Range(0, 2),  // tile_columns
+        ::testing::Values(4)));  // threads
+
 INSTANTIATE_TEST_SUITE_P(
     VP9LargeBest, VPxEncoderThreadTest,
     ::testing::Combine(
@@ -0,0 +1,280 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8dx.h"
+
+namespace {
+
+// Generates a textured pattern moving across the frame, so that the decoder
+// runs sub-pixel motion compensation from the previous frames.
+class MovingPatternVideoSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (img_ == nullptr) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int shift = plane ? 1 : 0;
+      const int w = (img_->d_w + shift) >> shift;
+      const int h = (img_->d_h + shift) >> shift;
+      const int dx = 3 * frame_ >> shift;
+      const int dy = 2 * frame_ >> shift;
+      for (int y = 0; y < h; ++y) {
+        uint8_t *const row = img_->planes[plane] + y * img_->stride[plane];
+        for (int x = 0; x < w; ++x) {
+          const int u = x + dx;
+          const int v = y + dy;
+          row[x] = static_cast<uint8_t>(((u >> 3) ^ (v >> 3)) * 16 + u + 2 * v +
+                                        plane * 64);
+        }
+      }
+    }
+  }
+};
+
+// Generates smooth gradients moving down by 18 rows a frame. At a low
+// bitrate they are coded with 64x64 blocks and 32x32 transforms, so that the
+// 4:2:0 chroma planes use 32x32 transforms and the widest loop filter too.
+// The chroma prediction of the bottom of a block row then reads chroma rows
+// that the loop filter of the next block row changes in the reference frame.
+class SmoothGradientVideoSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (img_ == nullptr) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int shift = plane ? 1 : 0;
+      const int w = (img_->d_w + shift) >> shift;
+      const int h = (img_->d_h + shift) >> shift;
+      for (int y = 0; y < h; ++y) {
+        uint8_t *const row = img_->planes[plane] + y * img_->stride[plane];
+        // Luma coordinates of the pel in the first frame.
+        const int v = (y << shift) - 18 * static_cast<int>(frame_) + 1024;
+        for (int x = 0; x < w; ++x) {
+          const int u = (x << shift) + 1024;
+          // A step every 64 rows leaves edges for the loop filter.
+          row[x] = static_cast<uint8_t>(u / 3 + v / 2 + (v & 64) + plane * 40);
+        }
+      }
+    }
+  }
+};
+
+typedef std::vector<std::vector<uint8_t> > Packets;
+
+class FrameParallelTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWith3Params<libvpx_test::TestMode, int,
+                                                 int> {
+ protected:
+  FrameParallelTest()
+      : EncoderTest(GET_PARAM(0)), encoding_mode_(GET_PARAM(1)),
+        frame_parallel_decoding_mode_(GET_PARAM(2)), aq_mode_(GET_PARAM(3)),
+        corrupt_packet_(-1) {}
+
+  ~FrameParallelTest() override = default;
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(encoding_mode_);
+    cfg_.g_lag_in_frames = encoding_mode_ == ::libvpx_test::kRealTime ? 0 : 25;
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 300;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 4);
+      encoder->Control(VP9E_SET_FRAME_PARALLEL_DECODING,
+                       frame_parallel_decoding_mode_);
+      encoder->Control(VP9E_SET_AQ_MODE, aq_mode_);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 1);
+      if (encoding_mode_ != ::libvpx_test::kRealTime) {
+        encoder->Control(VP8E_SET_ENABLEAUTOALTREF, 1);
+        encoder->Control(VP8E_SET_ARNR_MAXFRAMES, 7);
+        encoder->Control(VP8E_SET_ARNR_STRENGTH, 5);
+      }
+    }
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const uint8_t *const buf = static_cast<const uint8_t *>(pkt->data.frame.buf);
+    packets_.push_back(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+  }
+
+  // Returns a superframe holding the first half of the packet at 'index' and
+  // the packet that follows it, so that the second frame is decoded on top
+  // of the failed one within the same decode call.
+  std::vector<uint8_t> CorruptSuperframe(size_t index) const {
+    const std::vector<uint8_t> &first = packets_[index];
+    const std::vector<uint8_t> &second = packets_[index + 1];
+    const uint32_t sizes[2] = { static_cast<uint32_t>(first.size() / 2),
+                                static_cast<uint32_t>(second.size()) };
+    // Two frames with 4-byte sizes.
+    const uint8_t marker = 0xc0 | (3 << 3) | 1;
+    std::vector<uint8_t> data(first.begin(), first.begin() + sizes[0]);
+    data.insert(data.end(), second.begin(), second.end());
+    data.push_back(marker);
+    for (uint32_t size : sizes) {
+      for (int b = 0; b < 4; ++b) data.push_back((size >> (8 * b)) & 0xff);
+    }
+    data.push_back(marker);
+    return data;
+  }
+
+  // Decodes all the packets and returns the MD5 of each output frame. The
+  // packets at corrupt_packet_ and after it are replaced with
+  // CorruptSuperframe().
+  std::vector<std::string> Decode(int frame_parallel, int threads) {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = threads;
+    ::libvpx_test::VP9Decoder decoder(cfg, 0);
+    if (frame_parallel > 0) {
+      decoder.Control(VP9D_SET_FRAME_PARALLEL, frame_parallel);
+    }
+
+    std::vector<std::string> md5s;
+    for (size_t i = 0; i < packets_.size(); ++i) {
+      if (static_cast<int>(i) == corrupt_packet_) {
+        const std::vector<uint8_t> data = CorruptSuperframe(i++);
+        decoder.DecodeFrame(data.data(), data.size());
+      } else {
+        const vpx_codec_err_t res =
+            decoder.DecodeFrame(packets_[i].data(), packets_[i].size());
+        if (corrupt_packet_ < 0) {
+          EXPECT_EQ(VPX_CODEC_OK, res) << decoder.DecodeError();
+        }
+      }
+      AddFrames(&decoder, &md5s);
+    }
+    // Flush the frames in flight.
+    EXPECT_EQ(VPX_CODEC_OK, decoder.DecodeFrame(nullptr, 0));
+    AddFrames(&decoder, &md5s);
+    return md5s;
+  }
+
+  static void AddFrames(::libvpx_test::Decoder *decoder,
+                        std::vector<std::string> *md5s) {
+    ::libvpx_test::DxDataIterator dec_iter = decoder->GetDxData();
+    const vpx_image_t *img;
+    while ((img = dec_iter.Next()) != nullptr) {
+      ::libvpx_test::MD5 md5;
+      md5.Add(img);
+      md5s->push_back(md5.Get());
+    }
+  }
+
+  ::libvpx_test::TestMode encoding_mode_;
+  int frame_parallel_decoding_mode_;
+  int aq_mode_;
+  int corrupt_packet_;
+  Packets packets_;
+};
+
+// Encodes a clip and checks that decoding it with several frames in flight
+// returns the same frames as the serial decoder.
+TEST_P(FrameParallelTest, MatchesSerialDecode) {
+  MovingPatternVideoSource video;
+  video.SetSize(176, 144);
+  video.set_limit(20);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+  const std::vector<std::string> serial_md5s = Decode(0, 1);
+  ASSERT_EQ(20u, serial_md5s.size());
+
+  const int kFrameParallel[] = { 2, 3, 8 };
+  for (int frame_parallel : kFrameParallel) {
+    for (int threads = 1; threads <= 4; threads += 3) {
+      SCOPED_TRACE(testing::Message() << "frame_parallel: " << frame_parallel
+                                      << " threads: " << threads);
+      const std::vector<std::string> md5s = Decode(frame_parallel, threads);
+      ASSERT_EQ(serial_md5s.size(), md5s.size());
+      for (size_t i = 0; i < md5s.size(); ++i) {
+        EXPECT_EQ(serial_md5s[i], md5s[i]) << "frame " << i;
+      }
+    }
+  }
+}
+
+// The loop filter of the next block row still changes 7 chroma rows above it,
+// i.e. 14 luma rows in 4:2:0, when the chroma planes use 32x32 transforms.
+// Frames predicting from those rows have to wait for them.
+TEST_P(FrameParallelTest, ChromaLoopFilterMatchesSerialDecode) {
+  SmoothGradientVideoSource video;
+  video.SetSize(352, 288);
+  video.set_limit(20);
+  cfg_.rc_target_bitrate = 60;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+  const std::vector<std::string> serial_md5s = Decode(0, 1);
+  ASSERT_EQ(20u, serial_md5s.size());
+
+  const int kFrameParallel[] = { 2, 8 };
+  for (int frame_parallel : kFrameParallel) {
+    for (int threads = 1; threads <= 4; threads += 3) {
+      SCOPED_TRACE(testing::Message() << "frame_parallel: " << frame_parallel
+                                      << " threads: " << threads);
+      const std::vector<std::string> md5s = Decode(frame_parallel, threads);
+      ASSERT_EQ(serial_md5s.size(), md5s.size());
+      for (size_t i = 0; i < md5s.size(); ++i) {
+        EXPECT_EQ(serial_md5s[i], md5s[i]) << "frame " << i;
+      }
+    }
+  }
+}
+
+// Truncates an inter frame in the middle of the clip and decodes the next
+// frame in the same call. The next frame starts before the truncated one has
+// failed and must fail with it, as it predicts from it. The serial decoder
+// outputs neither, nor anything else until the next key frame.
+TEST_P(FrameParallelTest, CorruptFrameMatchesSerialDecode) {
+  MovingPatternVideoSource video;
+  video.SetSize(176, 144);
+  video.set_limit(20);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+  // Pick two consecutive packets that are not superframes already.
+  for (size_t i = packets_.size() / 2; i + 1 < packets_.size(); ++i) {
+    if ((packets_[i].back() & 0xe0) != 0xc0 &&
+        (packets_[i + 1].back() & 0xe0) != 0xc0) {
+      corrupt_packet_ = static_cast<int>(i);
+      break;
+    }
+  }
+  ASSERT_GE(corrupt_packet_, 0);
+  const std::vector<std::string> serial_md5s = Decode(0, 1);
+  ASSERT_LT(serial_md5s.size(), 20u);
+
+  const int kFrameParallel[] = { 2, 3, 8 };
+  for (int frame_parallel : kFrameParallel) {
+    for (int threads = 1; threads <= 4; threads += 3) {
+      SCOPED_TRACE(testing::Message() << "frame_parallel: " << frame_parallel
+                                      << " threads: " << threads);
+      const std::vector<std::string> md5s = Decode(frame_parallel, threads);
+      ASSERT_EQ(serial_md5s.size(), md5s.size());
+      for (size_t i = 0; i < md5s.size(); ++i) {
+        EXPECT_EQ(serial_md5s[i], md5s[i]) << "frame " << i;
+      }
+    }
+  }
+}
+
+VP9_INSTANTIATE_TEST_SUITE(FrameParallelTest,
+                           ::testing::Values(::libvpx_test::kTwoPassGood,
+                                             ::libvpx_test::kRealTime),
+                           ::testing::Values(0, 1), ::testing::Values(0, 1));
+}  // namespace
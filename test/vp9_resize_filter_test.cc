@@ -0,0 +1,212 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "vp9/encoder/vp9_resize.h"
+#include "vpx_ports/mem.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+
+const int kNumTaps = 8;
+const int kMaxWidth = 80;
+const int kNumIterations = 2000;
+
+// Taps in [-128, 128], the range the resize filters are drawn from.
+void RandomFilter(ACMRandom *rnd, int16_t *filter) {
+  for (int k = 0; k < kNumTaps; ++k) {
+    filter[k] = static_cast<int16_t>((*rnd)(257) - 128);
+  }
+}
+
+typedef void (*ResizeFilterRowsFunc)(const uint8_t *const *src,
+                                     const int16_t *filter, uint8_t *dst,
+                                     int w);
+
+class ResizeFilterRowsTest
+    : public ::testing::TestWithParam<ResizeFilterRowsFunc> {
+ public:
+  ~ResizeFilterRowsTest() override = default;
+  void SetUp() override { func_ = GetParam(); }
+  void TearDown() override { libvpx_test::ClearSystemState(); }
+
+ protected:
+  void RunTest(bool extremes) {
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    DECLARE_ALIGNED(16, uint8_t, src[kNumTaps][kMaxWidth]);
+    DECLARE_ALIGNED(16, uint8_t, dst_ref[kMaxWidth + 1]);
+    DECLARE_ALIGNED(16, uint8_t, dst_tst[kMaxWidth + 1]);
+    const uint8_t *rows[kNumTaps];
+    int16_t filter[kNumTaps];
+
+    for (int iter = 0; iter < kNumIterations; ++iter) {
+      const int w = 1 + rnd(kMaxWidth);
+      RandomFilter(&rnd, filter);
+      for (int k = 0; k < kNumTaps; ++k) {
+        // Alternate between the largest and the smallest possible sums.
+        const bool high = (filter[k] >= 0) == !(iter & 1);
+        for (int x = 0; x < w; ++x) {
+          src[k][x] = extremes ? (high ? 255 : 0) : rnd.Rand8();
+        }
+        rows[k] = src[k];
+      }
+      memset(dst_ref, 0xa5, sizeof(dst_ref));
+      memset(dst_tst, 0xa5, sizeof(dst_tst));
+
+      vp9_resize_filter_rows_c(rows, filter, dst_ref, w);
+      ASM_REGISTER_STATE_CHECK(func_(rows, filter, dst_tst, w));
+      ASSERT_EQ(0, memcmp(dst_ref, dst_tst, sizeof(dst_ref)))
+          << "w: " << w << " iteration: " << iter;
+    }
+  }
+
+  ResizeFilterRowsFunc func_;
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(ResizeFilterRowsTest);
+
+TEST_P(ResizeFilterRowsTest, MatchesC) { RunTest(false); }
+
+TEST_P(ResizeFilterRowsTest, ExtremeValues) { RunTest(true); }
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_SUITE_P(SSE2, ResizeFilterRowsTest,
+                         ::testing::Values(vp9_resize_filter_rows_sse2));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, ResizeFilterRowsTest,
+                         ::testing::Values(vp9_resize_filter_rows_avx2));
+#endif  // HAVE_AVX2
+
+#if CONFIG_VP9_HIGHBITDEPTH
+typedef void (*HighbdResizeFilterRowsFunc)(const uint16_t *const *src,
+                                           const int16_t *filter,
+                                           uint16_t *dst, int w, int bd);
+typedef std::tuple<HighbdResizeFilterRowsFunc, int> HighbdResizeFilterParam;
+
+class HighbdResizeFilterRowsTest
+    : public ::testing::TestWithParam<HighbdResizeFilterParam> {
+ public:
+  ~HighbdResizeFilterRowsTest() override = default;
+  void SetUp() override {
+    func_ = std::get<0>(GetParam());
+    bd_ = std::get<1>(GetParam());
+  }
+  void TearDown() override { libvpx_test::ClearSystemState(); }
+
+ protected:
+  void RunTest(bool extremes) {
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    const int max = (1 << bd_) - 1;
+    DECLARE_ALIGNED(16, uint16_t, src[kNumTaps][kMaxWidth]);
+    DECLARE_ALIGNED(16, uint16_t, dst_ref[kMaxWidth + 1]);
+    DECLARE_ALIGNED(16, uint16_t, dst_tst[kMaxWidth + 1]);
+    const uint16_t *rows[kNumTaps];
+    int16_t filter[kNumTaps];
+
+    for (int iter = 0; iter < kNumIterations; ++iter) {
+      const int w = 1 + rnd(kMaxWidth);
+      RandomFilter(&rnd, filter);
+      for (int k = 0; k < kNumTaps; ++k) {
+        const bool high = (filter[k] >= 0) == !(iter & 1);
+        for (int x = 0; x < w; ++x) {
+          src[k][x] = extremes ? (high ? max : 0) : rnd.Rand16() & max;
+        }
+        rows[k] = src[k];
+      }
+      memset(dst_ref, 0xa5, sizeof(dst_ref));
+      memset(dst_tst, 0xa5, sizeof(dst_tst));
+
+      vp9_highbd_resize_filter_rows_c(rows, filter, dst_ref, w, bd_);
+      ASM_REGISTER_STATE_CHECK(func_(rows, filter, dst_tst, w, bd_));
+      ASSERT_EQ(0, memcmp(dst_ref, dst_tst, sizeof(dst_ref)))
+          << "w: " << w << " bd: " << bd_ << " iteration: " << iter;
+    }
+  }
+
+  HighbdResizeFilterRowsFunc func_;
+  int bd_;
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(HighbdResizeFilterRowsTest);
+
+TEST_P(HighbdResizeFilterRowsTest, MatchesC) { RunTest(false); }
+
+TEST_P(HighbdResizeFilterRowsTest, ExtremeValues) { RunTest(true); }
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_SUITE_P(
+    SSE2, HighbdResizeFilterRowsTest,
+    ::testing::Combine(::testing::Values(vp9_highbd_resize_filter_rows_sse2),
+                       ::testing::Values(8, 10, 12)));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, HighbdResizeFilterRowsTest,
+    ::testing::Combine(::testing::Values(vp9_highbd_resize_filter_rows_avx2),
+                       ::testing::Values(8, 10, 12)));
+#endif  // HAVE_AVX2
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+// Running the two passes of vp9_resize_plane() in bands, as the encoder
+// threads do, must give the same output as resizing the whole plane.
+TEST(VP9ResizePlaneTest, BandsMatchWholePlane) {
+  static const int kSizes[][4] = {
+    { 64, 48, 32, 24 },   { 67, 45, 20, 13 },  { 100, 75, 33, 25 },
+    { 160, 90, 120, 68 }, { 33, 21, 41, 27 },  { 35, 23, 35, 11 },
+    { 17, 130, 23, 17 },  { 120, 8, 13, 96 },
+  };
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  for (const auto &size : kSizes) {
+    const int width = size[0], height = size[1];
+    const int width2 = size[2], height2 = size[3];
+    const int in_stride = width + 3, out_stride = width2 + 5;
+    std::vector<uint8_t> input(in_stride * height);
+    std::vector<uint8_t> intbuf(width2 * height);
+    std::vector<uint8_t> ref(out_stride * height2, 0);
+    std::vector<uint8_t> out(out_stride * height2, 0);
+    for (auto &p : input) p = rnd.Rand8();
+
+    vp9_resize_plane(input.data(), height, width, in_stride, ref.data(),
+                     height2, width2, out_stride);
+
+    for (int num_bands = 2; num_bands <= 5; ++num_bands) {
+      std::fill(out.begin(), out.end(), 0);
+      for (int i = 0; i < num_bands; ++i) {
+        ASSERT_EQ(1, vp9_resize_plane_rows(
+                         input.data(), width, in_stride, intbuf.data(), width2,
+                         height * i / num_bands, height * (i + 1) / num_bands));
+      }
+      for (int i = 0; i < num_bands; ++i) {
+        ASSERT_EQ(1, vp9_resize_plane_cols(
+                         intbuf.data(), height, width2, out.data(), height2,
+                         out_stride, width2 * i / num_bands,
+                         width2 * (i + 1) / num_bands));
+      }
+      ASSERT_EQ(ref, out) << width << "x" << height << " -> " << width2 << "x"
+                          << height2 << " bands: " << num_bands;
+    }
+  }
+}
+
+}  // namespace
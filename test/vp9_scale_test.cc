@@ -16,10 +16,14 @@
 
 #include "./vp9_rtcd.h"
 #include "./vpx_config.h"
+#include "./vpx_dsp_rtcd.h"
 #include "./vpx_scale_rtcd.h"
+#include "test/acm_random.h"
 #include "test/clear_system_state.h"
 #include "test/register_state_check.h"
 #include "test/vpx_scale_test.h"
+#include "vp9/common/vp9_filter.h"
+#include "vp9/encoder/vp9_encoder.h"
 #include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/vpx_timer.h"
 #include "vpx_scale/yv12config.h"
@@ -198,6 +202,161 @@ TEST_P(ScaleTest, DISABLED_Speed) {
   }
 }
 
+// vp9_scale_frame_rows() must give the same frame as scaling every 16x16
+// block with vpx_scaled_2d_c(), however the block rows are split into bands.
+class ScaleFrameRowsTest : public VpxScaleBase, public ::testing::Test {
+ protected:
+  void ReferenceScaleFrame(INTERP_FILTER filter_type, int phase_scaler) {
+    const int src_w = img_.y_crop_width;
+    const int src_h = img_.y_crop_height;
+    const int dst_w = ref_img_.y_crop_width;
+    const int dst_h = ref_img_.y_crop_height;
+    const uint8_t *const srcs[3] = { img_.y_buffer, img_.u_buffer,
+                                     img_.v_buffer };
+    const int src_strides[3] = { img_.y_stride, img_.uv_stride,
+                                 img_.uv_stride };
+    uint8_t *const dsts[3] = { ref_img_.y_buffer, ref_img_.u_buffer,
+                               ref_img_.v_buffer };
+    const int dst_strides[3] = { ref_img_.y_stride, ref_img_.uv_stride,
+                                 ref_img_.uv_stride };
+    const InterpKernel *const kernel = vp9_filter_kernels[filter_type];
+    for (int i = 0; i < MAX_MB_PLANE; ++i) {
+      const int factor = (i == 0 ? 1 : 2);
+      for (int y = 0; y < dst_h; y += 16) {
+        const int y_q4 = y * (16 / factor) * src_h / dst_h + phase_scaler;
+        for (int x = 0; x < dst_w; x += 16) {
+          const int x_q4 = x * (16 / factor) * src_w / dst_w + phase_scaler;
+          const uint8_t *src_ptr =
+              srcs[i] + (y / factor) * src_h / dst_h * src_strides[i] +
+              (x / factor) * src_w / dst_w;
+          uint8_t *dst_ptr =
+              dsts[i] + (y / factor) * dst_strides[i] + (x / factor);
+          vpx_scaled_2d_c(src_ptr, src_strides[i], dst_ptr, dst_strides[i],
+                          kernel, x_q4 & 0xf, 16 * src_w / dst_w, y_q4 & 0xf,
+                          16 * src_h / dst_h, 16 / factor, 16 / factor);
+        }
+      }
+    }
+    vpx_extend_frame_borders_c(&ref_img_);
+  }
+
+  void ScaleFrameInBands(INTERP_FILTER filter_type, int phase_scaler,
+                         int num_bands) {
+    const int rows = (dst_img_.y_crop_height + 15) >> 4;
+    for (int i = 0; i < num_bands; ++i) {
+      vp9_scale_frame_rows(&img_, &dst_img_, filter_type, phase_scaler,
+                           rows * i / num_bands, rows * (i + 1) / num_bands);
+    }
+    vpx_extend_frame_borders_c(&dst_img_);
+  }
+};
+
+TEST_F(ScaleFrameRowsTest, MatchesPerBlockScaling) {
+  static const int kSrcSizes[] = { 2, 16, 34, 68, 134, 200 };
+  static const int kDstSizes[] = { 2, 8, 14, 22, 48, 66, 90, 130, 202, 256 };
+  static const int kPhases[] = { 0, 5, 8, 15 };
+  for (INTERP_FILTER filter_type = 0; filter_type < 4; ++filter_type) {
+    for (const int phase_scaler : kPhases) {
+      for (const int src_size : kSrcSizes) {
+        for (const int dst_size : kDstSizes) {
+          // vpx_convolve8_c() can't step more than 4 pels at a time.
+          if (src_size > 4 * dst_size) continue;
+          const int src_width = src_size;
+          const int src_height = (src_size * 3 / 4 + 1) & ~1;
+          const int dst_width = dst_size;
+          const int dst_height = (dst_size * 5 / 8 + 1) & ~1;
+          if (16 * src_height / dst_height > 64) continue;
+          ASSERT_NO_FATAL_FAILURE(ResetScaleImages(src_width, src_height,
+                                                   dst_width, dst_height));
+          ReferenceScaleFrame(filter_type, phase_scaler);
+          for (int num_bands = 1; num_bands <= 3; ++num_bands) {
+            memset(dst_img_.buffer_alloc, kBufFiller, dst_img_.frame_size);
+            ScaleFrameInBands(filter_type, phase_scaler, num_bands);
+            CompareImages(dst_img_);
+            ASSERT_FALSE(HasFailure())
+                << "filter_type = " << static_cast<int>(filter_type)
+                << ", phase_scaler = " << phase_scaler << ", " << src_width
+                << "x" << src_height << " -> " << dst_width << "x"
+                << dst_height << ", bands = " << num_bands;
+          }
+          DeallocScaleImages();
+        }
+      }
+    }
+  }
+}
+
+typedef void (*ScaleFilterHorizFunc)(const uint8_t *src, int src_stride,
+                                     const int *x_offsets,
+                                     const int16_t *const *x_filters,
+                                     uint8_t *dst, int dst_stride, int w,
+                                     int h);
+
+class ScaleFilterHorizTest
+    : public ::testing::TestWithParam<ScaleFilterHorizFunc> {
+ public:
+  ~ScaleFilterHorizTest() override = default;
+  void TearDown() override { libvpx_test::ClearSystemState(); }
+
+ protected:
+  // Pels advance by up to max_step pels, sometimes going back one pel as
+  // they can at a block boundary.
+  void RunTest(int max_step) {
+    static const int kMaxWidth = 150;
+    static const int kHeight = 3;
+    // The SIMD versions may read 8 pels past the last tap.
+    static const int kSrcStride = 4 * kMaxWidth + SUBPEL_TAPS + 8;
+    static const int kDstStride = kMaxWidth + 1;
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    uint8_t src[kSrcStride * kHeight];
+    int x_offsets[kMaxWidth];
+    const int16_t *x_filters[kMaxWidth];
+    uint8_t dst_ref[kDstStride * kHeight], dst_tst[kDstStride * kHeight];
+
+    for (int iter = 0; iter < 500; ++iter) {
+      const int w = 1 + rnd(kMaxWidth);
+      const InterpKernel *const kernel = vp9_filter_kernels[rnd(4)];
+      for (int i = 0; i < kSrcStride * kHeight; ++i) {
+        src[i] = (iter & 1) ? rnd.Rand8() : (rnd.Rand8() & 1) * 255;
+      }
+      int offset = 0;
+      for (int x = 0; x < w; ++x) {
+        x_offsets[x] = offset;
+        x_filters[x] = kernel[rnd(SUBPEL_SHIFTS)];
+        offset += rnd(max_step + 1);
+        if (offset > 0 && rnd(16) == 0) --offset;
+      }
+      memset(dst_ref, 0xa5, sizeof(dst_ref));
+      memset(dst_tst, 0xa5, sizeof(dst_tst));
+
+      vp9_scale_filter_horiz_c(src, kSrcStride, x_offsets, x_filters, dst_ref,
+                               kDstStride, w, kHeight);
+      ASM_REGISTER_STATE_CHECK(GetParam()(src, kSrcStride, x_offsets,
+                                          x_filters, dst_tst, kDstStride, w,
+                                          kHeight));
+      ASSERT_EQ(0, memcmp(dst_ref, dst_tst, sizeof(dst_ref)))
+          << "w: " << w << " iteration: " << iter;
+    }
+  }
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(ScaleFilterHorizTest);
+
+TEST_P(ScaleFilterHorizTest, Upscale) { RunTest(1); }
+
+TEST_P(ScaleFilterHorizTest, Downscale) { RunTest(2); }
+
+TEST_P(ScaleFilterHorizTest, SteepDownscale) { RunTest(4); }
+
+#if HAVE_SSSE3
+INSTANTIATE_TEST_SUITE_P(SSSE3, ScaleFilterHorizTest,
+                         ::testing::Values(vp9_scale_filter_horiz_ssse3));
+#endif  // HAVE_SSSE3
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, ScaleFilterHorizTest,
+                         ::testing::Values(vp9_scale_filter_horiz_avx2));
+#endif  // HAVE_AVX2
+
 INSTANTIATE_TEST_SUITE_P(C, ScaleTest,
                          ::testing::Values(vp9_scale_and_extend_frame_c));
 
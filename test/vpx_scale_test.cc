@@ -8,6 +8,10 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+#include <climits>
+#include <tuple>
+
 #include "gtest/gtest.h"
 
 #include "./vpx_config.h"
@@ -16,6 +20,7 @@
 #include "test/register_state_check.h"
 #include "test/vpx_scale_test.h"
 #include "vpx_mem/vpx_mem.h"
+#include "vpx_ports/mem.h"
 #include "vpx_ports/vpx_timer.h"
 #include "vpx_scale/yv12config.h"
 
@@ -29,6 +34,11 @@ const int kNumSizesToTest = 7;
 const int kNumSizesToTest = 8;
 #endif
 const int kSizesToTest[] = { 1, 15, 33, 145, 512, 1025, 3840, 16383 };
+#if CONFIG_VP9
+const int kSpeedTestWidth = 3840;
+const int kSpeedTestHeight = 2160;
+const int kCountSpeedTestFrames = 200;
+#endif  // CONFIG_VP9
 
 typedef void (*ExtendFrameBorderFunc)(YV12_BUFFER_CONFIG *ybf);
 typedef void (*CopyFrameFunc)(const YV12_BUFFER_CONFIG *src_ybf,
@@ -62,8 +72,69 @@ class ExtendBorderTest
 
 TEST_P(ExtendBorderTest, ExtendBorder) { ASSERT_NO_FATAL_FAILURE(RunTest()); }
 
+#if CONFIG_VP9
+// Uses the VP9 encoder border, the largest one used by the codecs.
+TEST_P(ExtendBorderTest, DISABLED_Speed) {
+  ASSERT_NO_FATAL_FAILURE(ResetScaleImages(kSpeedTestWidth, kSpeedTestHeight,
+                                           kSpeedTestWidth, kSpeedTestHeight));
+  ReferenceCopyFrame();
+
+  vpx_usec_timer timer;
+  vpx_usec_timer_start(&timer);
+  for (int i = 0; i < kCountSpeedTestFrames; ++i) extend_fn_(&img_);
+  libvpx_test::ClearSystemState();
+  vpx_usec_timer_mark(&timer);
+  const int elapsed_time =
+      static_cast<int>(vpx_usec_timer_elapsed(&timer) / 1000);
+  CompareImages(img_);
+  DeallocScaleImages();
+
+  printf("extend border %dx%d, border %d: %5d ms\n", kSpeedTestWidth,
+         kSpeedTestHeight, VP9_ENC_BORDER_IN_PIXELS, elapsed_time);
+}
+#endif  // CONFIG_VP9
+
+#if CONFIG_VP9
+INSTANTIATE_TEST_SUITE_P(C, ExtendBorderTest,
+                         ::testing::Values(vp8_yv12_extend_frame_borders_c,
+                                           vpx_extend_frame_borders_c));
+#else
 INSTANTIATE_TEST_SUITE_P(C, ExtendBorderTest,
                          ::testing::Values(vp8_yv12_extend_frame_borders_c));
+#endif  // CONFIG_VP9
+
+#if HAVE_SSE2
+#if CONFIG_VP9
+INSTANTIATE_TEST_SUITE_P(SSE2, ExtendBorderTest,
+                         ::testing::Values(vp8_yv12_extend_frame_borders_sse2,
+                                           vpx_extend_frame_borders_sse2));
+#else
+INSTANTIATE_TEST_SUITE_P(SSE2, ExtendBorderTest,
+                         ::testing::Values(vp8_yv12_extend_frame_borders_sse2));
+#endif  // CONFIG_VP9
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+#if CONFIG_VP9
+INSTANTIATE_TEST_SUITE_P(AVX2, ExtendBorderTest,
+                         ::testing::Values(vp8_yv12_extend_frame_borders_avx2,
+                                           vpx_extend_frame_borders_avx2));
+#else
+INSTANTIATE_TEST_SUITE_P(AVX2, ExtendBorderTest,
+                         ::testing::Values(vp8_yv12_extend_frame_borders_avx2));
+#endif  // CONFIG_VP9
+#endif  // HAVE_AVX2
+
+#if HAVE_NEON
+#if CONFIG_VP9
+INSTANTIATE_TEST_SUITE_P(NEON, ExtendBorderTest,
+                         ::testing::Values(vp8_yv12_extend_frame_borders_neon,
+                                           vpx_extend_frame_borders_neon));
+#else
+INSTANTIATE_TEST_SUITE_P(NEON, ExtendBorderTest,
+                         ::testing::Values(vp8_yv12_extend_frame_borders_neon));
+#endif  // CONFIG_VP9
+#endif  // HAVE_NEON
 
 class CopyFrameTest : public VpxScaleBase,
                       public ::testing::TestWithParam<CopyFrameFunc> {
@@ -94,8 +165,248 @@ class CopyFrameTest : public VpxScaleBase,
 
 TEST_P(CopyFrameTest, CopyFrame) { ASSERT_NO_FATAL_FAILURE(RunTest()); }
 
+#if CONFIG_VP9
+TEST_P(CopyFrameTest, DISABLED_Speed) {
+  ASSERT_NO_FATAL_FAILURE(ResetScaleImages(kSpeedTestWidth, kSpeedTestHeight,
+                                           kSpeedTestWidth, kSpeedTestHeight));
+  ReferenceCopyFrame();
+
+  vpx_usec_timer timer;
+  vpx_usec_timer_start(&timer);
+  for (int i = 0; i < kCountSpeedTestFrames; ++i) {
+    copy_frame_fn_(&img_, &dst_img_);
+  }
+  libvpx_test::ClearSystemState();
+  vpx_usec_timer_mark(&timer);
+  const int elapsed_time =
+      static_cast<int>(vpx_usec_timer_elapsed(&timer) / 1000);
+  CompareImages(dst_img_);
+  DeallocScaleImages();
+
+  printf("copy frame %dx%d, border %d: %5d ms\n", kSpeedTestWidth,
+         kSpeedTestHeight, VP9_ENC_BORDER_IN_PIXELS, elapsed_time);
+}
+#endif  // CONFIG_VP9
+
+#if CONFIG_VP9
+INSTANTIATE_TEST_SUITE_P(C, CopyFrameTest,
+                         ::testing::Values(vp8_yv12_copy_frame_c,
+                                           vpx_yv12_copy_frame_c));
+#else
 INSTANTIATE_TEST_SUITE_P(C, CopyFrameTest,
                          ::testing::Values(vp8_yv12_copy_frame_c));
+#endif  // CONFIG_VP9
+
+#if HAVE_SSE2
+#if CONFIG_VP9
+INSTANTIATE_TEST_SUITE_P(SSE2, CopyFrameTest,
+                         ::testing::Values(vp8_yv12_copy_frame_sse2,
+                                           vpx_yv12_copy_frame_sse2));
+#else
+INSTANTIATE_TEST_SUITE_P(SSE2, CopyFrameTest,
+                         ::testing::Values(vp8_yv12_copy_frame_sse2));
+#endif  // CONFIG_VP9
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+#if CONFIG_VP9
+INSTANTIATE_TEST_SUITE_P(AVX2, CopyFrameTest,
+                         ::testing::Values(vp8_yv12_copy_frame_avx2,
+                                           vpx_yv12_copy_frame_avx2));
+#else
+INSTANTIATE_TEST_SUITE_P(AVX2, CopyFrameTest,
+                         ::testing::Values(vp8_yv12_copy_frame_avx2));
+#endif  // CONFIG_VP9
+#endif  // HAVE_AVX2
+
+#if HAVE_NEON
+#if CONFIG_VP9
+INSTANTIATE_TEST_SUITE_P(NEON, CopyFrameTest,
+                         ::testing::Values(vp8_yv12_copy_frame_neon,
+                                           vpx_yv12_copy_frame_neon));
+#else
+INSTANTIATE_TEST_SUITE_P(NEON, CopyFrameTest,
+                         ::testing::Values(vp8_yv12_copy_frame_neon));
+#endif  // CONFIG_VP9
+#endif  // HAVE_NEON
+
+#if CONFIG_VP9
+// The VP9 functions also take borders other than VP8BORDERINPIXELS and, with
+// CONFIG_VP9_HIGHBITDEPTH, 16-bit frames.
+const int kVp9SizesToTest[] = { 1, 15, 33, 145 };
+const int kVp9BordersToTest[] = { VP9_DEC_BORDER_IN_PIXELS, 64,
+                                  VP9_ENC_BORDER_IN_PIXELS };
+
+class Vp9FrameBorderBase : public VpxScaleBase {
+ protected:
+  void ResetVp9Image(YV12_BUFFER_CONFIG *const img, int width, int height,
+                     int border, bool high) {
+    memset(img, 0, sizeof(*img));
+#if CONFIG_VP9_HIGHBITDEPTH
+    ASSERT_EQ(0, vpx_alloc_frame_buffer(img, width, height, 1, 1, high,
+                                        border, 0));
+#else
+    ASSERT_FALSE(high);
+    ASSERT_EQ(0,
+              vpx_alloc_frame_buffer(img, width, height, 1, 1, border, 0));
+#endif
+    memset(img->buffer_alloc, kBufFiller, img->frame_size);
+  }
+
+  // Allocates img_, ref_img_ and dst_img_ and fills the visible area of
+  // img_ with random samples.
+  void ResetVp9Images(int width, int height, int border, bool high) {
+    ResetVp9Image(&img_, width, height, border, high);
+    ResetVp9Image(&ref_img_, width, height, border, high);
+    ResetVp9Image(&dst_img_, width, height, border, high);
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    uint8_t *const planes[3] = { img_.y_buffer, img_.u_buffer, img_.v_buffer };
+    for (int i = 0; i < 3; ++i) {
+      const int w = i == 0 ? img_.y_crop_width : img_.uv_crop_width;
+      const int h = i == 0 ? img_.y_crop_height : img_.uv_crop_height;
+      const int stride = i == 0 ? img_.y_stride : img_.uv_stride;
+      for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+          if (high) {
+            CONVERT_TO_SHORTPTR(planes[i])[y * stride + x] =
+                rnd.Rand16() & 0xfff;
+          } else {
+            planes[i][y * stride + x] = rnd.Rand8();
+          }
+        }
+      }
+    }
+  }
+
+  // Extends the borders of ref_img_ by at most |max_extend| luma pixels.
+  template <typename Pixel>
+  void ReferenceExtend(Pixel *(*plane)(uint8_t *), int max_extend) {
+    const int extend = std::min(ref_img_.border, max_extend);
+    ExtendPlane(plane(ref_img_.y_buffer), ref_img_.y_crop_width,
+                ref_img_.y_crop_height, ref_img_.y_width, ref_img_.y_height,
+                ref_img_.y_stride, extend);
+    ExtendPlane(plane(ref_img_.u_buffer), ref_img_.uv_crop_width,
+                ref_img_.uv_crop_height, ref_img_.uv_width,
+                ref_img_.uv_height, ref_img_.uv_stride, extend / 2);
+    ExtendPlane(plane(ref_img_.v_buffer), ref_img_.uv_crop_width,
+                ref_img_.uv_crop_height, ref_img_.uv_width,
+                ref_img_.uv_height, ref_img_.uv_stride, extend / 2);
+  }
+
+  // Copies img_ to ref_img_ and extends the borders of the copy.
+  void ReferenceCopyAndExtend(bool high, int max_extend) {
+    memcpy(ref_img_.buffer_alloc, img_.buffer_alloc, img_.frame_size);
+    if (high) {
+      ReferenceExtend<uint16_t>(
+          [](uint8_t *p) { return CONVERT_TO_SHORTPTR(p); }, max_extend);
+    } else {
+      ReferenceExtend<uint8_t>([](uint8_t *p) { return p; }, max_extend);
+    }
+  }
+
+  void DeallocVp9Images() {
+    vpx_free_frame_buffer(&img_);
+    vpx_free_frame_buffer(&ref_img_);
+    vpx_free_frame_buffer(&dst_img_);
+  }
+
+  // Calls |test| for every size, border and sample size.
+  template <typename Test>
+  void ForEachFrame(Test test) {
+    for (int high = 0; high <= CONFIG_VP9_HIGHBITDEPTH; ++high) {
+      for (const int border : kVp9BordersToTest) {
+        for (const int h : kVp9SizesToTest) {
+          for (const int w : kVp9SizesToTest) {
+            SCOPED_TRACE(testing::Message() << w << "x" << h << " border "
+                                            << border << " high " << high);
+            ASSERT_NO_FATAL_FAILURE(ResetVp9Images(w, h, border, high != 0));
+            test(high != 0);
+            DeallocVp9Images();
+          }
+        }
+      }
+    }
+  }
+};
+
+// The extension function and whether it only extends the inner border.
+typedef std::tuple<ExtendFrameBorderFunc, bool> Vp9ExtendBorderParam;
+
+class Vp9ExtendBorderTest
+    : public Vp9FrameBorderBase,
+      public ::testing::TestWithParam<Vp9ExtendBorderParam> {};
+
+TEST_P(Vp9ExtendBorderTest, ExtendBorder) {
+  const ExtendFrameBorderFunc extend_fn = std::get<0>(GetParam());
+  const int max_extend =
+      std::get<1>(GetParam()) ? VP9INNERBORDERINPIXELS : INT_MAX;
+  ForEachFrame([&](bool high) {
+    ReferenceCopyAndExtend(high, max_extend);
+    ASM_REGISTER_STATE_CHECK(extend_fn(&img_));
+    CompareImages(img_);
+  });
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    C, Vp9ExtendBorderTest,
+    ::testing::Values(std::make_tuple(vpx_extend_frame_borders_c, false),
+                      std::make_tuple(vpx_extend_frame_inner_borders_c,
+                                      true)));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_SUITE_P(
+    SSE2, Vp9ExtendBorderTest,
+    ::testing::Values(std::make_tuple(vpx_extend_frame_borders_sse2, false),
+                      std::make_tuple(vpx_extend_frame_inner_borders_sse2,
+                                      true)));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, Vp9ExtendBorderTest,
+    ::testing::Values(std::make_tuple(vpx_extend_frame_borders_avx2, false),
+                      std::make_tuple(vpx_extend_frame_inner_borders_avx2,
+                                      true)));
+#endif  // HAVE_AVX2
+
+#if HAVE_NEON
+INSTANTIATE_TEST_SUITE_P(
+    NEON, Vp9ExtendBorderTest,
+    ::testing::Values(std::make_tuple(vpx_extend_frame_borders_neon, false),
+                      std::make_tuple(vpx_extend_frame_inner_borders_neon,
+                                      true)));
+#endif  // HAVE_NEON
+
+class Vp9CopyFrameTest : public Vp9FrameBorderBase,
+                         public ::testing::TestWithParam<CopyFrameFunc> {};
+
+TEST_P(Vp9CopyFrameTest, CopyFrame) {
+  const CopyFrameFunc copy_frame_fn = GetParam();
+  ForEachFrame([&](bool high) {
+    ReferenceCopyAndExtend(high, INT_MAX);
+    ASM_REGISTER_STATE_CHECK(copy_frame_fn(&img_, &dst_img_));
+    CompareImages(dst_img_);
+  });
+}
+
+INSTANTIATE_TEST_SUITE_P(C, Vp9CopyFrameTest,
+                         ::testing::Values(vpx_yv12_copy_frame_c));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_SUITE_P(SSE2, Vp9CopyFrameTest,
+                         ::testing::Values(vpx_yv12_copy_frame_sse2));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, Vp9CopyFrameTest,
+                         ::testing::Values(vpx_yv12_copy_frame_avx2));
+#endif  // HAVE_AVX2
+
+#if HAVE_NEON
+INSTANTIATE_TEST_SUITE_P(NEON, Vp9CopyFrameTest,
+                         ::testing::Values(vpx_yv12_copy_frame_neon));
+#endif  // HAVE_NEON
+#endif  // CONFIG_VP9
 
 }  // namespace
 }  // namespace libvpx_test
@@ -11,6 +11,8 @@
 #ifndef VPX_TEST_VPX_SCALE_TEST_H_
 #define VPX_TEST_VPX_SCALE_TEST_H_
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
 
 #include "./vpx_config.h"
@@ -112,40 +114,42 @@ class VpxScaleBase {
     }
   }
 
-  static void ExtendPlane(uint8_t *buf, int crop_width, int crop_height,
+  template <typename Pixel>
+  static void ExtendPlane(Pixel *buf, int crop_width, int crop_height,
                           int width, int height, int stride, int padding) {
     // Copy the outermost visible pixel to a distance of at least 'padding.'
     // The buffers are allocated such that there may be excess space outside the
     // padding. As long as the minimum amount of padding is achieved it is not
     // necessary to fill this space as well.
-    uint8_t *left = buf - padding;
-    uint8_t *right = buf + crop_width;
+    Pixel *left = buf - padding;
+    Pixel *right = buf + crop_width;
     const int right_extend = padding + (width - crop_width);
     const int bottom_extend = padding + (height - crop_height);
 
     // Fill the border pixels from the nearest image pixel.
     for (int y = 0; y < crop_height; ++y) {
-      memset(left, left[padding], padding);
-      memset(right, right[-1], right_extend);
+      std::fill_n(left, padding, left[padding]);
+      std::fill_n(right, right_extend, right[-1]);
       left += stride;
       right += stride;
     }
 
     left = buf - padding;
-    uint8_t *top = left - (stride * padding);
+    Pixel *top = left - (stride * padding);
     // The buffer does not always extend as far as the stride.
     // Equivalent to padding + width + padding.
     const int extend_width = padding + crop_width + right_extend;
 
     // The first row was already extended to the left and right. Copy it up.
     for (int y = 0; y < padding; ++y) {
-      memcpy(top, left, extend_width);
+      memcpy(top, left, extend_width * sizeof(*top));
       top += stride;
     }
 
-    uint8_t *bottom = left + (crop_height * stride);
+    Pixel *bottom = left + (crop_height * stride);
     for (int y = 0; y < bottom_extend; ++y) {
-      memcpy(bottom, left + (crop_height - 1) * stride, extend_width);
+      memcpy(bottom, left + (crop_height - 1) * stride,
+             extend_width * sizeof(*bottom));
       bottom += stride;
     }
   }
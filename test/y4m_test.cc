@@ -14,6 +14,7 @@
 
 #include "./vpx_config.h"
 #include "./y4menc.h"
+#include "test/acm_random.h"
 #include "test/md5_helper.h"
 #include "test/util.h"
 #include "test/y4m_video_source.h"
@@ -241,4 +242,191 @@ TEST(Y4MHeaderTest, LongHeader) {
   y4m_input_close(&y4m);
 }
 
+static const char kY4MFramesHeader[] = "YUV4MPEG2 W4 H4 F30:1 Ip A0:0 C%s\n";
+static const char *const kY4MFrames[] = { "FRAME\n", "FRAME Ip XTAG=1\n" };
+
+// Frames fetched from memory must match the ones read from the file, and be
+// used in place when they need no conversion.
+TEST(Y4MFetchFrameTest, MemMatchesFile) {
+  static const struct {
+    const char *chroma_type;
+    int frame_size;
+    int only_420;
+  } kFormats[] = { { "420jpeg", 24, 0 }, { "422", 32, 1 }, { "444", 48, 0 } };
+
+  for (const auto &format : kFormats) {
+    std::string frames;
+    for (int i = 0; i < 2; ++i) {
+      frames += kY4MFrames[i];
+      for (int j = 0; j < format.frame_size; ++j) {
+        frames += static_cast<char>('a' + (i * 7 + j) % 26);
+      }
+    }
+    libvpx_test::TempOutFile f;
+    ASSERT_NE(f.file(), nullptr);
+    fprintf(f.file(), kY4MFramesHeader, format.chroma_type);
+    fwrite(frames.data(), 1, frames.size(), f.file());
+    fflush(f.file());
+    ASSERT_EQ(fseek(f.file(), 0, 0), 0);
+
+    y4m_input y4m_file, y4m_mem;
+    ASSERT_EQ(y4m_input_open(&y4m_file, f.file(), nullptr, 0, format.only_420),
+              0);
+    ASSERT_EQ(fseek(f.file(), 0, 0), 0);
+    ASSERT_EQ(y4m_input_open(&y4m_mem, f.file(), nullptr, 0, format.only_420),
+              0);
+    ASSERT_EQ(fseek(f.file(), -static_cast<long>(frames.size()), SEEK_END), 0);
+
+    unsigned char *const buf = reinterpret_cast<unsigned char *>(&frames[0]);
+    size_t position = 0;
+    for (int i = 0; i < 2; ++i) {
+      vpx_image_t img_file, img_mem;
+      size_t consumed = 0;
+      ASSERT_EQ(y4m_input_fetch_frame(&y4m_file, f.file(), &img_file), 1);
+      ASSERT_EQ(y4m_input_fetch_frame_mem(&y4m_mem, buf + position,
+                                          frames.size() - position, &consumed,
+                                          &img_mem),
+                1);
+      position += consumed;
+      EXPECT_EQ(position, i == 0 ? strlen(kY4MFrames[0]) + format.frame_size
+                                 : frames.size());
+      libvpx_test::MD5 md5_file, md5_mem;
+      md5_file.Add(&img_file);
+      md5_mem.Add(&img_mem);
+      EXPECT_STREQ(md5_file.Get(), md5_mem.Get()) << format.chroma_type;
+      const bool in_place = img_mem.planes[VPX_PLANE_Y] >= buf &&
+                            img_mem.planes[VPX_PLANE_Y] < buf + frames.size();
+      EXPECT_EQ(in_place, !format.only_420) << format.chroma_type;
+    }
+    size_t consumed = 0;
+    vpx_image_t img;
+    EXPECT_EQ(y4m_input_fetch_frame_mem(&y4m_mem, buf + position, 0,
+                                        &consumed, &img),
+              0);
+    y4m_input_close(&y4m_file);
+    y4m_input_close(&y4m_mem);
+  }
+}
+
+struct Y4mConvertParam {
+  const char *chroma_type;
+  int only_420;
+};
+
+const Y4mConvertParam kY4mConversions[] = {
+  { "422jpeg", 0 },
+  { "422", 1 },
+  { "444", 1 },
+  { "420paldv", 0 },
+};
+
+const int kY4mConvertSizes[][2] = { { 1, 1 },   { 2, 3 },   { 5, 7 },
+                                    { 18, 9 },  { 37, 21 }, { 67, 10 },
+                                    { 130, 6 }, { 261, 5 }, { 100, 70 } };
+
+// Returns the MD5 of the converted frames of a random Y4M stream, converting
+// the chroma with |threads| threads. Every other frame only has samples of 0
+// and 255, which drive the filters into both clamps.
+std::string Y4mConvertMD5(const Y4mConvertParam &param, int width, int height,
+                          int threads) {
+  libvpx_test::ACMRandom rnd(libvpx_test::ACMRandom::DeterministicSeed());
+  libvpx_test::TempOutFile f;
+  EXPECT_NE(f.file(), nullptr);
+  if (f.file() == nullptr) return "";
+  fprintf(f.file(), "YUV4MPEG2 W%d H%d F30:1 Ip C%s\n", width, height,
+          param.chroma_type);
+  const int chroma_w = param.chroma_type[2] == '4' ? width : (width + 1) / 2;
+  const int chroma_h =
+      param.chroma_type[1] == '2' && param.chroma_type[2] == '0'
+          ? (height + 1) / 2
+          : height;
+  for (int i = 0; i < 4; ++i) {
+    fputs("FRAME\n", f.file());
+    for (int j = 0; j < width * height + 2 * chroma_w * chroma_h; ++j) {
+      const int sample = rnd.Rand8();
+      fputc((i & 1) ? (sample & 1) * 255 : sample, f.file());
+    }
+  }
+  fflush(f.file());
+  EXPECT_EQ(fseek(f.file(), 0, 0), 0);
+
+  y4m_input y4m;
+  EXPECT_EQ(y4m_input_open(&y4m, f.file(), nullptr, 0, param.only_420), 0);
+  if (threads > 1) {
+    EXPECT_EQ(y4m_input_set_threads(&y4m, threads), 0);
+  }
+  libvpx_test::MD5 md5;
+  vpx_image_t img;
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(y4m_input_fetch_frame(&y4m, f.file(), &img), 1);
+    md5.Add(&img);
+  }
+  y4m_input_close(&y4m);
+  return md5.Get();
+}
+
+TEST(Y4MConvertTest, MatchesReference) {
+  // Indexed by conversion, then size.
+  static const char *const kExpectedMD5[] = {
+    "6ac02a005f89a096c4516944995b80eb",  // 422jpeg 1x1
+    "9796c767a684f90610a72095430ad153",  // 422jpeg 2x3
+    "ca42278813188aee21e59638a0fefc49",  // 422jpeg 5x7
+    "fc69040c6d2f5c1a546fb7082d176f0c",  // 422jpeg 18x9
+    "d4f476a8851b54e5a91d19a9ac26eba7",  // 422jpeg 37x21
+    "7c24aa3b5b1fe80c417ea11fbfb94f5b",  // 422jpeg 67x10
+    "1db3a6d1735ef88343b81842df048bba",  // 422jpeg 130x6
+    "440fa390eeb75c71a4702dcd74d2121d",  // 422jpeg 261x5
+    "df354c5ee2d51113b89b80d939919a15",  // 422jpeg 100x70
+    "6ac02a005f89a096c4516944995b80eb",  // 422 1x1
+    "9796c767a684f90610a72095430ad153",  // 422 2x3
+    "2864277ebad2c2c3a1a766264e3e4993",  // 422 5x7
+    "f2b6bea071058636c9c94d5971906526",  // 422 18x9
+    "49bbea54244f226de0f802e80062ca3f",  // 422 37x21
+    "58cab3fddf3c00cb6f7e84606b0477e8",  // 422 67x10
+    "d50ee44efc10d3c90632e75efceda3b9",  // 422 130x6
+    "055138e8368e487b283310b3b51e07e3",  // 422 261x5
+    "4dcc10343234aa398e61f488ff5068df",  // 422 100x70
+    "6ac02a005f89a096c4516944995b80eb",  // 444 1x1
+    "952a9a4caab1a80bb0beb5c80bdae84f",  // 444 2x3
+    "fb1c706ca05eef4f08203c41133faa43",  // 444 5x7
+    "cacadb594f5fcefdf7c549db47b7f2e8",  // 444 18x9
+    "55ec073b452e55efca4783da33432e25",  // 444 37x21
+    "b01a57bffd731cf6cb659448968a01ab",  // 444 67x10
+    "214e79b9b9c25626a0567250d97ea243",  // 444 130x6
+    "520f53a43c19ba7cbbae6c55e04304cc",  // 444 261x5
+    "76fbeea4762fe3a5b9b129722384baaa",  // 444 100x70
+    "6ac02a005f89a096c4516944995b80eb",  // 420paldv 1x1
+    "0f613b07c0cb66319a648642deaed187",  // 420paldv 2x3
+    "92e6675f7fbe4ec08eecdd22cbaabbfe",  // 420paldv 5x7
+    "e5922054556e991aff08db69c57e5355",  // 420paldv 18x9
+    "2a3fc9b1fce9b5aee98f3c6fa5071a87",  // 420paldv 37x21
+    "a65ffd267a17504d424204a1124740ce",  // 420paldv 67x10
+    "5399994a28ebb1e6a645adbbc967043f",  // 420paldv 130x6
+    "92a4f94934ec3fdce3315fbebe9c05c8",  // 420paldv 261x5
+    "c478a5a94c004f3fff9e206d4d7c11ea",  // 420paldv 100x70
+  };
+  int i = 0;
+  for (const auto &param : kY4mConversions) {
+    for (const auto &size : kY4mConvertSizes) {
+      EXPECT_EQ(kExpectedMD5[i++], Y4mConvertMD5(param, size[0], size[1], 1))
+          << param.chroma_type << " " << size[0] << "x" << size[1];
+    }
+  }
+}
+
+#if CONFIG_MULTITHREAD
+TEST(Y4MConvertTest, ThreadsMatchSingleThread) {
+  for (const auto &param : kY4mConversions) {
+    for (const auto &size : kY4mConvertSizes) {
+      const std::string expected = Y4mConvertMD5(param, size[0], size[1], 1);
+      for (int threads = 2; threads <= 5; ++threads) {
+        EXPECT_EQ(expected, Y4mConvertMD5(param, size[0], size[1], threads))
+            << param.chroma_type << " " << size[0] << "x" << size[1]
+            << " threads: " << threads;
+      }
+    }
+  }
+}
+#endif  // CONFIG_MULTITHREAD
+
 }  // namespace
@@ -29,6 +29,9 @@
 #if defined(_WIN32)
 #include <io.h>
 #include <fcntl.h>
+#elif CONFIG_OS_SUPPORT
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
 #define LOG_ERROR(label)               \
@@ -134,6 +137,48 @@ int read_yuv_frame(struct VpxInputContext *input_ctx, vpx_image_t *yuv_frame) {
   return shortread;
 }
 
+int map_input_file(struct VpxInputContext *input) {
+#if CONFIG_OS_SUPPORT && !defined(_WIN32)
+  struct FileTypeDetectionBuffer *const detect = &input->detect;
+  const int fd = fileno(input->file);
+  struct stat st;
+  FileOffset position;
+  void *data;
+
+  if (fstat(fd, &st) || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+      (FileOffset)(size_t)st.st_size != st.st_size) {
+    return 0;
+  }
+  position = ftello(input->file);
+  if (position < 0 || position > st.st_size) return 0;
+  // Bytes of the detection buffer not consumed yet precede the file position.
+  if (detect->buf_read > detect->position) {
+    position -= (FileOffset)(detect->buf_read - detect->position);
+  }
+
+  data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) return 0;
+#if defined(MADV_SEQUENTIAL)
+  madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+  input->map.data = (uint8_t *)data;
+  input->map.size = (size_t)st.st_size;
+  input->map.position = (size_t)position;
+  if (detect->buf_read > detect->position) detect->position = detect->buf_read;
+  return 1;
+#else
+  (void)input;
+  return 0;
+#endif
+}
+
+void unmap_input_file(struct VpxInputContext *input) {
+#if CONFIG_OS_SUPPORT && !defined(_WIN32)
+  if (input->map.data) munmap(input->map.data, input->map.size);
+#endif
+  memset(&input->map, 0, sizeof(input->map));
+}
+
 #if CONFIG_ENCODERS
 
 static const VpxInterface vpx_encoders[] = {
@@ -282,13 +327,62 @@ double sse_to_psnr(double samples, double peak, double sse) {
 }
 
 #if CONFIG_ENCODERS
+// Points the planes of a planar image at the next frame of the mapped file.
+// 16-bit samples at an odd address are copied into the image instead. Every
+// plane of a 16-bit frame has an even size, so then no frame of the file is
+// mapped and the image still has its own planes.
+static int map_yuv_frame(struct VpxInputContext *input_ctx, vpx_image_t *img) {
+  struct VpxFileMap *const map = &input_ctx->map;
+  const int bytespp = (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+  const int copy =
+      bytespp == 2 && ((uintptr_t)(map->data + map->position) & 1);
+  int plane;
+
+  for (plane = 0; plane < 3; ++plane) {
+    // YV12 has the V plane first on disk.
+    const int p =
+        (plane > 0 && img->fmt == VPX_IMG_FMT_YV12) ? 3 - plane : plane;
+    const int stride = vpx_img_plane_width(img, plane) * bytespp;
+    const size_t size = (size_t)stride * vpx_img_plane_height(img, plane);
+
+    if (map->size - map->position < size) return 1;
+    if (copy) {
+      const int h = vpx_img_plane_height(img, plane);
+      int y;
+      for (y = 0; y < h; ++y) {
+        memcpy(img->planes[p] + y * img->stride[p],
+               map->data + map->position + y * stride, stride);
+      }
+    } else {
+      img->planes[p] = map->data + map->position;
+      img->stride[p] = stride;
+    }
+    map->position += size;
+  }
+
+  return 0;
+}
+
 int read_frame(struct VpxInputContext *input_ctx, vpx_image_t *img) {
   FILE *f = input_ctx->file;
   y4m_input *y4m = &input_ctx->y4m;
+  struct VpxFileMap *const map = &input_ctx->map;
   int shortread = 0;
 
   if (input_ctx->file_type == FILE_TYPE_Y4M) {
-    if (y4m_input_fetch_frame(y4m, f, img) < 1) return 0;
+    if (map->data) {
+      size_t frame_size;
+      if (y4m_input_fetch_frame_mem(y4m, map->data + map->position,
+                                    map->size - map->position, &frame_size,
+                                    img) < 1) {
+        return 0;
+      }
+      map->position += frame_size;
+    } else if (y4m_input_fetch_frame(y4m, f, img) < 1) {
+      return 0;
+    }
+  } else if (map->data) {
+    shortread = map_yuv_frame(input_ctx, img);
   } else {
     shortread = read_yuv_frame(input_ctx, img);
   }
@@ -347,6 +441,8 @@ void open_input_file(struct VpxInputContext *input) {
       input->framerate.denominator = input->y4m.fps_d;
       input->fmt = input->y4m.vpx_fmt;
       input->bit_depth = input->y4m.bit_depth;
+      /* The Y4M reader consumed the detection bytes. */
+      input->detect.position = input->detect.buf_read;
     } else {
       fatal("Unsupported Y4M stream.");
     }
@@ -358,6 +454,7 @@ void open_input_file(struct VpxInputContext *input) {
 }
 
 void close_input_file(struct VpxInputContext *input) {
+  unmap_input_file(input);
   fclose(input->file);
   if (input->file_type == FILE_TYPE_Y4M) y4m_input_close(&input->y4m);
 }
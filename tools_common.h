@@ -89,6 +89,15 @@ struct VpxRational {
   int denominator;
 };
 
+/* A memory mapping of an input file, consumed from position. The mapping
+ * is read-only, even though data is not const for the images wrapping it.
+ */
+struct VpxFileMap {
+  uint8_t *data;
+  size_t size;
+  size_t position;
+};
+
 struct VpxInputContext {
   const char *filename;
   FILE *file;
@@ -103,6 +112,7 @@ struct VpxInputContext {
   int only_i420;
   uint32_t fourcc;
   struct VpxRational framerate;
+  struct VpxFileMap map;
 #if CONFIG_ENCODERS
   y4m_input y4m;
 #endif
@@ -148,6 +158,14 @@ VPX_NO_RETURN void usage_exit(void);
 
 int read_yuv_frame(struct VpxInputContext *input_ctx, vpx_image_t *yuv_frame);
 
+/* Maps the input file so that frames can be used in place rather than read
+ * into buffers, starting with any bytes left in the detection buffer.
+ * Returns 0 and leaves the file to be read as a stream if it can't be
+ * mapped, e.g. for pipes.
+ */
+int map_input_file(struct VpxInputContext *input);
+void unmap_input_file(struct VpxInputContext *input);
+
 typedef struct VpxInterface {
   const char *name;
   uint32_t fourcc;
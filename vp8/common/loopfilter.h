@@ -72,6 +72,13 @@ void vp8_loop_filter_init(struct VP8Common *cm);
 void vp8_loop_filter_frame_init(struct VP8Common *cm, struct macroblockd *mbd,
                                 int default_filt_lvl);
 
+/* Computes the per segment, reference frame and mode filter levels for the
+ * frame level default_filt_lvl into lvl, as vp8_loop_filter_frame_init()
+ * does for cm->lf_info.lvl.
+ */
+void vp8_loop_filter_calc_lvl(struct macroblockd *mbd, int default_filt_lvl,
+                              unsigned char lvl[4][4][4]);
+
 void vp8_loop_filter_frame(struct VP8Common *cm, struct macroblockd *mbd,
                            int frame_type);
 
@@ -82,6 +89,14 @@ void vp8_loop_filter_partial_frame(struct VP8Common *cm,
 void vp8_loop_filter_frame_yonly(struct VP8Common *cm, struct macroblockd *mbd,
                                  int default_filt_lvl);
 
+/* Filters the Y plane of one macroblock using the levels in lvl. The
+ * macroblocks above and to the left must already be filtered.
+ */
+void vp8_loop_filter_mb_yonly(struct VP8Common *cm, unsigned char lvl[4][4][4],
+                              const struct modeinfo *mode_info_context,
+                              int mb_row, int mb_col, unsigned char *y_ptr,
+                              int y_stride);
+
 void vp8_loop_filter_update_sharpness(loop_filter_info_n *lfi,
                                       int sharpness_lvl);
 
@@ -91,6 +91,7 @@ static INLINE int vp8_sem_wait(vp8_sem_t *sem) {
 #endif
 
 #include "vpx_util/vpx_atomics.h"
+#include "vpx_util/vpx_pthread.h"
 
 static INLINE void vp8_atomic_spin_wait(
     int mb_col, const vpx_atomic_int *last_row_current_mb_col,
@@ -101,6 +102,57 @@ static INLINE void vp8_atomic_spin_wait(
   }
 }
 
+/* Number of pause iterations vp8_sync_wait() spins before it blocks. */
+#define VP8_SYNC_SPIN_COUNT 1024
+
+/* Same condition as vp8_atomic_spin_wait(), but only spins for a bounded
+ * number of iterations before sleeping on |cond|. The row being waited on
+ * must publish its progress with vp8_sync_write() using the same |waiters|,
+ * |mutex| and |cond|.
+ */
+static INLINE void vp8_sync_wait(int mb_col,
+                                 const vpx_atomic_int *last_row_current_mb_col,
+                                 const int nsync, vpx_atomic_int *waiters,
+                                 pthread_mutex_t *mutex, pthread_cond_t *cond) {
+  int spin;
+
+  for (spin = 0; spin < VP8_SYNC_SPIN_COUNT; ++spin) {
+    if (mb_col <= (vpx_atomic_load_acquire(last_row_current_mb_col) - nsync)) {
+      return;
+    }
+    x86_pause_hint();
+  }
+
+  /* |waiters| is only modified under |mutex|. The fence pairs with the one
+   * in vp8_sync_write(): either the writer sees the waiter, or the waiter
+   * sees the new column.
+   */
+  pthread_mutex_lock(mutex);
+  vpx_atomic_store_release(waiters, vpx_atomic_load_acquire(waiters) + 1);
+  vpx_atomic_thread_fence();
+  while (mb_col > (vpx_atomic_load_acquire(last_row_current_mb_col) - nsync)) {
+    pthread_cond_wait(cond, mutex);
+  }
+  vpx_atomic_store_release(waiters, vpx_atomic_load_acquire(waiters) - 1);
+  pthread_mutex_unlock(mutex);
+}
+
+/* Publishes the progress of a row. The mutex is only taken to wake up
+ * threads blocked in vp8_sync_wait().
+ */
+static INLINE void vp8_sync_write(vpx_atomic_int *current_mb_col, int mb_col,
+                                  const vpx_atomic_int *waiters,
+                                  pthread_mutex_t *mutex,
+                                  pthread_cond_t *cond) {
+  vpx_atomic_store_release(current_mb_col, mb_col);
+  vpx_atomic_thread_fence();
+  if (vpx_atomic_load_acquire(waiters)) {
+    pthread_mutex_lock(mutex);
+    pthread_cond_broadcast(cond);
+    pthread_mutex_unlock(mutex);
+  }
+}
+
 #endif /* CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD */
 
 #ifdef __cplusplus
@@ -91,20 +91,12 @@ void vp8_loop_filter_init(VP8_COMMON *cm) {
   }
 }
 
-void vp8_loop_filter_frame_init(VP8_COMMON *cm, MACROBLOCKD *mbd,
-                                int default_filt_lvl) {
+void vp8_loop_filter_calc_lvl(MACROBLOCKD *mbd, int default_filt_lvl,
+                              unsigned char lvl[4][4][4]) {
   int seg,  /* segment number */
       ref,  /* index in ref_lf_deltas */
       mode; /* index in mode_lf_deltas */
 
-  loop_filter_info_n *lfi = &cm->lf_info;
-
-  /* update limits if sharpness has changed */
-  if (cm->last_sharpness_level != cm->sharpness_level) {
-    vp8_loop_filter_update_sharpness(lfi, cm->sharpness_level);
-    cm->last_sharpness_level = cm->sharpness_level;
-  }
-
   for (seg = 0; seg < MAX_MB_SEGMENTS; ++seg) {
     int lvl_seg = default_filt_lvl;
     int lvl_ref, lvl_mode;
@@ -123,7 +115,7 @@ void vp8_loop_filter_frame_init(VP8_COMMON *cm, MACROBLOCKD *mbd,
       /* we could get rid of this if we assume that deltas are set to
        * zero when not in use; encoder always uses deltas
        */
-      memset(lfi->lvl[seg][0], lvl_seg, 4 * 4);
+      memset(lvl[seg][0], lvl_seg, 4 * 4);
       continue;
     }
 
@@ -140,12 +132,12 @@ void vp8_loop_filter_frame_init(VP8_COMMON *cm, MACROBLOCKD *mbd,
     /* clamp */
     lvl_mode = (lvl_mode > 0) ? (lvl_mode > 63 ? 63 : lvl_mode) : 0;
 
-    lfi->lvl[seg][ref][mode] = lvl_mode;
+    lvl[seg][ref][mode] = lvl_mode;
 
     mode = 1; /* all the rest of Intra modes */
     /* clamp */
     lvl_mode = (lvl_ref > 0) ? (lvl_ref > 63 ? 63 : lvl_ref) : 0;
-    lfi->lvl[seg][ref][mode] = lvl_mode;
+    lvl[seg][ref][mode] = lvl_mode;
 
     /* LAST, GOLDEN, ALT */
     for (ref = 1; ref < MAX_REF_FRAMES; ++ref) {
@@ -158,12 +150,25 @@ void vp8_loop_filter_frame_init(VP8_COMMON *cm, MACROBLOCKD *mbd,
         /* clamp */
         lvl_mode = (lvl_mode > 0) ? (lvl_mode > 63 ? 63 : lvl_mode) : 0;
 
-        lfi->lvl[seg][ref][mode] = lvl_mode;
+        lvl[seg][ref][mode] = lvl_mode;
       }
     }
   }
 }
 
+void vp8_loop_filter_frame_init(VP8_COMMON *cm, MACROBLOCKD *mbd,
+                                int default_filt_lvl) {
+  loop_filter_info_n *lfi = &cm->lf_info;
+
+  /* update limits if sharpness has changed */
+  if (cm->last_sharpness_level != cm->sharpness_level) {
+    vp8_loop_filter_update_sharpness(lfi, cm->sharpness_level);
+    cm->last_sharpness_level = cm->sharpness_level;
+  }
+
+  vp8_loop_filter_calc_lvl(mbd, default_filt_lvl, lfi->lvl);
+}
+
 void vp8_loop_filter_row_normal(VP8_COMMON *cm, MODE_INFO *mode_info_context,
                                 int mb_row, int post_ystride, int post_uvstride,
                                 unsigned char *y_ptr, unsigned char *u_ptr,
@@ -381,6 +386,58 @@ void vp8_loop_filter_frame(VP8_COMMON *cm, MACROBLOCKD *mbd, int frame_type) {
   }
 }
 
+void vp8_loop_filter_mb_yonly(VP8_COMMON *cm, unsigned char lvl[4][4][4],
+                              const MODE_INFO *mode_info_context, int mb_row,
+                              int mb_col, unsigned char *y_ptr, int y_stride) {
+  loop_filter_info_n *lfi_n = &cm->lf_info;
+  const int skip_lf = (mode_info_context->mbmi.mode != B_PRED &&
+                       mode_info_context->mbmi.mode != SPLITMV &&
+                       mode_info_context->mbmi.mb_skip_coeff);
+
+  const int mode_index = lfi_n->mode_lf_lut[mode_info_context->mbmi.mode];
+  const int seg = mode_info_context->mbmi.segment_id;
+  const int ref_frame = mode_info_context->mbmi.ref_frame;
+
+  const int filter_level = lvl[seg][ref_frame][mode_index];
+
+  if (filter_level) {
+    if (cm->filter_type == NORMAL_LOOPFILTER) {
+      loop_filter_info lfi;
+      const int hev_index = lfi_n->hev_thr_lut[cm->frame_type][filter_level];
+      lfi.mblim = lfi_n->mblim[filter_level];
+      lfi.blim = lfi_n->blim[filter_level];
+      lfi.lim = lfi_n->lim[filter_level];
+      lfi.hev_thr = lfi_n->hev_thr[hev_index];
+
+      if (mb_col > 0) vp8_loop_filter_mbv(y_ptr, 0, 0, y_stride, 0, &lfi);
+
+      if (!skip_lf) vp8_loop_filter_bv(y_ptr, 0, 0, y_stride, 0, &lfi);
+
+      /* don't apply across umv border */
+      if (mb_row > 0) vp8_loop_filter_mbh(y_ptr, 0, 0, y_stride, 0, &lfi);
+
+      if (!skip_lf) vp8_loop_filter_bh(y_ptr, 0, 0, y_stride, 0, &lfi);
+    } else {
+      if (mb_col > 0) {
+        vp8_loop_filter_simple_mbv(y_ptr, y_stride, lfi_n->mblim[filter_level]);
+      }
+
+      if (!skip_lf) {
+        vp8_loop_filter_simple_bv(y_ptr, y_stride, lfi_n->blim[filter_level]);
+      }
+
+      /* don't apply across umv border */
+      if (mb_row > 0) {
+        vp8_loop_filter_simple_mbh(y_ptr, y_stride, lfi_n->mblim[filter_level]);
+      }
+
+      if (!skip_lf) {
+        vp8_loop_filter_simple_bh(y_ptr, y_stride, lfi_n->blim[filter_level]);
+      }
+    }
+  }
+}
+
 void vp8_loop_filter_frame_yonly(VP8_COMMON *cm, MACROBLOCKD *mbd,
                                  int default_filt_lvl) {
   YV12_BUFFER_CONFIG *post = cm->frame_to_show;
@@ -389,20 +446,9 @@ void vp8_loop_filter_frame_yonly(VP8_COMMON *cm, MACROBLOCKD *mbd,
   int mb_row;
   int mb_col;
 
-  loop_filter_info_n *lfi_n = &cm->lf_info;
-  loop_filter_info lfi;
-
-  int filter_level;
-  FRAME_TYPE frame_type = cm->frame_type;
-
   /* Point at base of Mb MODE_INFO list */
   const MODE_INFO *mode_info_context = cm->mi;
 
-#if 0
-    if(default_filt_lvl == 0) /* no filter applied */
-        return;
-#endif
-
   /* Initialize the loop filter for this frame. */
   vp8_loop_filter_frame_init(cm, mbd, default_filt_lvl);
 
@@ -412,55 +458,8 @@ void vp8_loop_filter_frame_yonly(VP8_COMMON *cm, MACROBLOCKD *mbd,
   /* vp8_filter each macro block */
   for (mb_row = 0; mb_row < cm->mb_rows; ++mb_row) {
     for (mb_col = 0; mb_col < cm->mb_cols; ++mb_col) {
-      int skip_lf = (mode_info_context->mbmi.mode != B_PRED &&
-                     mode_info_context->mbmi.mode != SPLITMV &&
-                     mode_info_context->mbmi.mb_skip_coeff);
-
-      const int mode_index = lfi_n->mode_lf_lut[mode_info_context->mbmi.mode];
-      const int seg = mode_info_context->mbmi.segment_id;
-      const int ref_frame = mode_info_context->mbmi.ref_frame;
-
-      filter_level = lfi_n->lvl[seg][ref_frame][mode_index];
-
-      if (filter_level) {
-        if (cm->filter_type == NORMAL_LOOPFILTER) {
-          const int hev_index = lfi_n->hev_thr_lut[frame_type][filter_level];
-          lfi.mblim = lfi_n->mblim[filter_level];
-          lfi.blim = lfi_n->blim[filter_level];
-          lfi.lim = lfi_n->lim[filter_level];
-          lfi.hev_thr = lfi_n->hev_thr[hev_index];
-
-          if (mb_col > 0)
-            vp8_loop_filter_mbv(y_ptr, 0, 0, post->y_stride, 0, &lfi);
-
-          if (!skip_lf)
-            vp8_loop_filter_bv(y_ptr, 0, 0, post->y_stride, 0, &lfi);
-
-          /* don't apply across umv border */
-          if (mb_row > 0)
-            vp8_loop_filter_mbh(y_ptr, 0, 0, post->y_stride, 0, &lfi);
-
-          if (!skip_lf)
-            vp8_loop_filter_bh(y_ptr, 0, 0, post->y_stride, 0, &lfi);
-        } else {
-          if (mb_col > 0)
-            vp8_loop_filter_simple_mbv(y_ptr, post->y_stride,
-                                       lfi_n->mblim[filter_level]);
-
-          if (!skip_lf)
-            vp8_loop_filter_simple_bv(y_ptr, post->y_stride,
-                                      lfi_n->blim[filter_level]);
-
-          /* don't apply across umv border */
-          if (mb_row > 0)
-            vp8_loop_filter_simple_mbh(y_ptr, post->y_stride,
-                                       lfi_n->mblim[filter_level]);
-
-          if (!skip_lf)
-            vp8_loop_filter_simple_bh(y_ptr, post->y_stride,
-                                      lfi_n->blim[filter_level]);
-        }
-      }
+      vp8_loop_filter_mb_yonly(cm, cm->lf_info.lvl, mode_info_context, mb_row,
+                               mb_col, y_ptr, post->y_stride);
 
       y_ptr += 16;
       mode_info_context++; /* step to next MB */
@@ -83,6 +83,13 @@ typedef struct VP8D_COMP {
   int sync_range;
   /* Each row remembers its already decoded column. */
   vpx_atomic_int *mt_current_mb_col;
+  pthread_mutex_t *mt_current_mb_col_mutex;
+  pthread_cond_t *mt_current_mb_col_cond;
+  vpx_atomic_int *mt_current_mb_col_waiters;
+  /* Rows are taken from mt_next_mb_row when row_mt is set. */
+  int row_mt;
+  int mt_next_mb_row;
+  pthread_mutex_t mt_next_mb_row_mutex;
 
   unsigned char **mt_yabove_row; /* mb_rows x width */
   unsigned char **mt_uabove_row;
@@ -249,10 +249,34 @@ static void mt_decode_macroblock(VP8D_COMP *pbi, MACROBLOCKD *xd,
   }
 }
 
+static void sync_write(VP8D_COMP *pbi, int mb_row, int mb_col) {
+  if (pbi->row_mt) {
+    vp8_sync_write(&pbi->mt_current_mb_col[mb_row], mb_col,
+                   &pbi->mt_current_mb_col_waiters[mb_row],
+                   &pbi->mt_current_mb_col_mutex[mb_row],
+                   &pbi->mt_current_mb_col_cond[mb_row]);
+  } else {
+    vpx_atomic_store_release(&pbi->mt_current_mb_col[mb_row], mb_col);
+  }
+}
+
+/* Returns the row this thread decodes after |mb_row|, or pc->mb_rows when
+ * there is none left.
+ */
+static int get_next_mb_row(VP8D_COMP *pbi, int mb_row) {
+  if (pbi->row_mt) {
+    pthread_mutex_lock(&pbi->mt_next_mb_row_mutex);
+    mb_row = pbi->mt_next_mb_row;
+    if (mb_row < pbi->common.mb_rows) ++pbi->mt_next_mb_row;
+    pthread_mutex_unlock(&pbi->mt_next_mb_row_mutex);
+    return mb_row;
+  }
+  return mb_row + pbi->decoding_thread_count + 1;
+}
+
 static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
                               int start_mb_row) {
   const vpx_atomic_int *last_row_current_mb_col;
-  vpx_atomic_int *current_mb_col;
   int mb_row;
   VP8_COMMON *pc = &pbi->common;
   const int nsync = pbi->sync_range;
@@ -288,13 +312,12 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
   dst_buffer[1] = yv12_fb_new->u_buffer;
   dst_buffer[2] = yv12_fb_new->v_buffer;
 
-  xd->up_available = (start_mb_row != 0);
-
-  xd->mode_info_context = pc->mi + pc->mode_info_stride * start_mb_row;
   xd->mode_info_stride = pc->mode_info_stride;
 
+  if (pbi->row_mt) start_mb_row = get_next_mb_row(pbi, start_mb_row);
+
   for (mb_row = start_mb_row; mb_row < pc->mb_rows;
-       mb_row += (pbi->decoding_thread_count + 1)) {
+       mb_row = get_next_mb_row(pbi, mb_row)) {
     int recon_yoffset, recon_uvoffset;
     int mb_col;
     int filter_level;
@@ -302,6 +325,9 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
 
     /* save last row processed by this thread */
     last_mb_row = mb_row;
+
+    xd->up_available = (mb_row != 0);
+    xd->mode_info_context = pc->mi + pc->mode_info_stride * mb_row;
     /* select bool coder for current partition */
     xd->current_bc = &pbi->mbc[mb_row % num_part];
 
@@ -311,8 +337,6 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
       last_row_current_mb_col = &first_row_no_sync_above;
     }
 
-    current_mb_col = &pbi->mt_current_mb_col[mb_row];
-
     recon_yoffset = mb_row * recon_y_stride * 16;
     recon_uvoffset = mb_row * recon_uv_stride * 8;
 
@@ -361,11 +385,18 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
 
     for (mb_col = 0; mb_col < pc->mb_cols; ++mb_col) {
       if (((mb_col - 1) % nsync) == 0) {
-        vpx_atomic_store_release(current_mb_col, mb_col - 1);
+        sync_write(pbi, mb_row, mb_col - 1);
       }
 
       if (mb_row && !(mb_col & (nsync - 1))) {
-        vp8_atomic_spin_wait(mb_col, last_row_current_mb_col, nsync);
+        if (pbi->row_mt) {
+          vp8_sync_wait(mb_col, last_row_current_mb_col, nsync,
+                        &pbi->mt_current_mb_col_waiters[mb_row - 1],
+                        &pbi->mt_current_mb_col_mutex[mb_row - 1],
+                        &pbi->mt_current_mb_col_cond[mb_row - 1]);
+        } else {
+          vp8_atomic_spin_wait(mb_col, last_row_current_mb_col, nsync);
+        }
       }
 
       /* Distance of MB to the various image edges.
@@ -409,10 +440,18 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
       if (xd->corrupted) {
         // Move current decoding marcoblock to the end of row for all rows
         // assigned to this thread, such that other threads won't be waiting.
-        for (; mb_row < pc->mb_rows;
-             mb_row += (pbi->decoding_thread_count + 1)) {
-          current_mb_col = &pbi->mt_current_mb_col[mb_row];
-          vpx_atomic_store_release(current_mb_col, pc->mb_cols + nsync);
+        // With row_mt the remaining rows are claimed so that no other thread
+        // starts on them.
+        if (pbi->row_mt) {
+          pthread_mutex_lock(&pbi->mt_next_mb_row_mutex);
+          pbi->mt_next_mb_row = pc->mb_rows;
+          pthread_mutex_unlock(&pbi->mt_next_mb_row_mutex);
+          sync_write(pbi, mb_row, pc->mb_cols + nsync);
+        } else {
+          for (; mb_row < pc->mb_rows;
+               mb_row += (pbi->decoding_thread_count + 1)) {
+            sync_write(pbi, mb_row, pc->mb_cols + nsync);
+          }
         }
         vpx_internal_error(&xd->error_info, VPX_CODEC_CORRUPT_FRAME,
                            "Corrupted reference frame");
@@ -567,17 +606,12 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
     }
 
     /* last MB of row is ready just after extension is done */
-    vpx_atomic_store_release(current_mb_col, mb_col + nsync);
-
-    ++xd->mode_info_context; /* skip prediction column */
-    xd->up_available = 1;
-
-    /* since we have multithread */
-    xd->mode_info_context += xd->mode_info_stride * pbi->decoding_thread_count;
+    sync_write(pbi, mb_row, mb_col + nsync);
   }
 
   /* signal end of decoding of current thread for current frame */
-  if (last_mb_row + (int)pbi->decoding_thread_count + 1 >= pc->mb_rows)
+  if (pbi->row_mt ||
+      last_mb_row + (int)pbi->decoding_thread_count + 1 >= pc->mb_rows)
     vp8_sem_post(&pbi->h_event_end_decoding);
 }
 
@@ -641,6 +675,12 @@ void vp8_decoder_create_threads(VP8D_COMP *pbi) {
                          "Failed to initialize semaphore");
     }
 
+    if (pthread_mutex_init(&pbi->mt_next_mb_row_mutex, NULL)) {
+      vp8_sem_destroy(&pbi->h_event_end_decoding);
+      vpx_internal_error(&pbi->common.error, VPX_CODEC_MEM_ERROR,
+                         "Failed to initialize mutex");
+    }
+
     for (ithread = 0; ithread < pbi->decoding_thread_count; ++ithread) {
       if (vp8_sem_init(&pbi->h_event_start_decoding[ithread], 0, 0)) break;
 
@@ -664,6 +704,7 @@ void vp8_decoder_create_threads(VP8D_COMP *pbi) {
        * vp8_decoder_remove_threads(). */
       if (pbi->allocated_decoding_thread_count == 0) {
         vp8_sem_destroy(&pbi->h_event_end_decoding);
+        pthread_mutex_destroy(&pbi->mt_next_mb_row_mutex);
       }
       vpx_internal_error(&pbi->common.error, VPX_CODEC_MEM_ERROR,
                          "Failed to create threads");
@@ -676,6 +717,24 @@ void vp8mt_de_alloc_temp_buffers(VP8D_COMP *pbi, int mb_rows) {
 
   vpx_free(pbi->mt_current_mb_col);
   pbi->mt_current_mb_col = NULL;
+  vpx_free(pbi->mt_current_mb_col_waiters);
+  pbi->mt_current_mb_col_waiters = NULL;
+
+  if (pbi->mt_current_mb_col_mutex) {
+    for (i = 0; i < mb_rows; ++i) {
+      pthread_mutex_destroy(&pbi->mt_current_mb_col_mutex[i]);
+    }
+    vpx_free(pbi->mt_current_mb_col_mutex);
+    pbi->mt_current_mb_col_mutex = NULL;
+  }
+
+  if (pbi->mt_current_mb_col_cond) {
+    for (i = 0; i < mb_rows; ++i) {
+      pthread_cond_destroy(&pbi->mt_current_mb_col_cond[i]);
+    }
+    vpx_free(pbi->mt_current_mb_col_cond);
+    pbi->mt_current_mb_col_cond = NULL;
+  }
 
   /* Free above_row buffers. */
   if (pbi->mt_yabove_row) {
@@ -763,6 +822,25 @@ void vp8mt_alloc_temp_buffers(VP8D_COMP *pbi, int width, int prev_mb_rows) {
     for (i = 0; i < pc->mb_rows; ++i)
       vpx_atomic_init(&pbi->mt_current_mb_col[i], 0);
 
+    /* Allocate the wait state of each mb row. */
+    CHECK_MEM_ERROR(
+        &pc->error, pbi->mt_current_mb_col_waiters,
+        vpx_malloc(sizeof(*pbi->mt_current_mb_col_waiters) * pc->mb_rows));
+    for (i = 0; i < pc->mb_rows; ++i)
+      vpx_atomic_init(&pbi->mt_current_mb_col_waiters[i], 0);
+    CHECK_MEM_ERROR(
+        &pc->error, pbi->mt_current_mb_col_mutex,
+        vpx_malloc(sizeof(*pbi->mt_current_mb_col_mutex) * pc->mb_rows));
+    for (i = 0; i < pc->mb_rows; ++i) {
+      pthread_mutex_init(&pbi->mt_current_mb_col_mutex[i], NULL);
+    }
+    CHECK_MEM_ERROR(
+        &pc->error, pbi->mt_current_mb_col_cond,
+        vpx_malloc(sizeof(*pbi->mt_current_mb_col_cond) * pc->mb_rows));
+    for (i = 0; i < pc->mb_rows; ++i) {
+      pthread_cond_init(&pbi->mt_current_mb_col_cond[i], NULL);
+    }
+
     /* Allocate memory for above_row buffers. */
     CALLOC_ARRAY(pbi->mt_yabove_row, pc->mb_rows);
     for (i = 0; i < pc->mb_rows; ++i) {
@@ -824,6 +902,7 @@ void vp8_decoder_remove_threads(VP8D_COMP *pbi) {
 
     if (pbi->allocated_decoding_thread_count) {
       vp8_sem_destroy(&pbi->h_event_end_decoding);
+      pthread_mutex_destroy(&pbi->mt_next_mb_row_mutex);
     }
 
     vpx_free(pbi->h_decoding_thread);
@@ -883,6 +962,7 @@ int vp8mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd) {
 
   setup_decoding_thread_data(pbi, xd, pbi->mb_row_di,
                              pbi->decoding_thread_count);
+  pbi->mt_next_mb_row = 0;
 
   for (i = 0; i < pbi->decoding_thread_count; ++i) {
     vp8_sem_post(&pbi->h_event_start_decoding[i]);
@@ -326,7 +326,7 @@ static void encode_mb_row(VP8_COMP *cpi, VP8_COMMON *cm, int mb_row,
 
 #if (CONFIG_REALTIME_ONLY & CONFIG_ONTHEFLY_BITPACKING)
   const int num_part = (1 << cm->multi_token_partition);
-  TOKENEXTRA *tp_start = cpi->tok;
+  TOKENEXTRA *tp_start = *tp;
   vp8_writer *w;
 #endif
 
@@ -335,12 +335,18 @@ static void encode_mb_row(VP8_COMP *cpi, VP8_COMMON *cm, int mb_row,
   vpx_atomic_int rightmost_col = VPX_ATOMIC_INIT(cm->mb_cols + nsync);
   const vpx_atomic_int *last_row_current_mb_col;
   vpx_atomic_int *current_mb_col = NULL;
+  vpx_atomic_int *last_row_waiters = NULL;
+  pthread_mutex_t *last_row_mutex = NULL;
+  pthread_cond_t *last_row_cond = NULL;
 
   if (vpx_atomic_load_acquire(&cpi->b_multi_threaded) != 0) {
     current_mb_col = &cpi->mt_current_mb_col[mb_row];
   }
   if (vpx_atomic_load_acquire(&cpi->b_multi_threaded) != 0 && mb_row != 0) {
     last_row_current_mb_col = &cpi->mt_current_mb_col[mb_row - 1];
+    last_row_waiters = &cpi->mt_current_mb_col_waiters[mb_row - 1];
+    last_row_mutex = &cpi->mt_current_mb_col_mutex[mb_row - 1];
+    last_row_cond = &cpi->mt_current_mb_col_cond[mb_row - 1];
   } else {
     last_row_current_mb_col = &rightmost_col;
   }
@@ -351,11 +357,29 @@ static void encode_mb_row(VP8_COMP *cpi, VP8_COMMON *cm, int mb_row,
     w = &cpi->bc[1 + (mb_row % num_part)];
   else
     w = &cpi->bc[1];
+
+#if CONFIG_MULTITHREAD
+  /* Rows are claimed dynamically, so the previous row of this partition may
+   * still be packing its tokens. Wait for it to finish so that each partition
+   * is written by one row at a time and in row order.
+   */
+  if (vpx_atomic_load_acquire(&cpi->b_multi_threaded) != 0 &&
+      mb_row >= num_part) {
+    const int part_row = mb_row - num_part;
+    vp8_sync_wait(cm->mb_cols, &cpi->mt_current_mb_col[part_row], nsync,
+                  &cpi->mt_current_mb_col_waiters[part_row],
+                  &cpi->mt_current_mb_col_mutex[part_row],
+                  &cpi->mt_current_mb_col_cond[part_row]);
+  }
+#endif
 #endif
 
   /* reset above block coeffs */
   xd->above_context = cm->above_context;
 
+  /* The dot artifact check has a budget per row. */
+  x->mbs_zero_last_dot_suppress = 0;
+
   xd->up_available = (mb_row != 0);
   recon_yoffset = (mb_row * recon_y_stride * 16);
   recon_uvoffset = (mb_row * recon_uv_stride * 8);
@@ -381,7 +405,7 @@ static void encode_mb_row(VP8_COMP *cpi, VP8_COMMON *cm, int mb_row,
   /* for each macroblock col in image */
   for (mb_col = 0; mb_col < cm->mb_cols; ++mb_col) {
 #if (CONFIG_REALTIME_ONLY & CONFIG_ONTHEFLY_BITPACKING)
-    *tp = cpi->tok;
+    *tp = tp_start;
 #endif
     /* Distance of Mb to the left & right edges, specified in
      * 1/8th pel units as they are always compared to values
@@ -411,11 +435,15 @@ static void encode_mb_row(VP8_COMP *cpi, VP8_COMMON *cm, int mb_row,
 #if CONFIG_MULTITHREAD
     if (vpx_atomic_load_acquire(&cpi->b_multi_threaded) != 0) {
       if (((mb_col - 1) % nsync) == 0) {
-        vpx_atomic_store_release(current_mb_col, mb_col - 1);
+        vp8_sync_write(current_mb_col, mb_col - 1,
+                       &cpi->mt_current_mb_col_waiters[mb_row],
+                       &cpi->mt_current_mb_col_mutex[mb_row],
+                       &cpi->mt_current_mb_col_cond[mb_row]);
       }
 
       if (mb_row && !(mb_col & (nsync - 1))) {
-        vp8_atomic_spin_wait(mb_col, last_row_current_mb_col, nsync);
+        vp8_sync_wait(mb_col, last_row_current_mb_col, nsync, last_row_waiters,
+                      last_row_mutex, last_row_cond);
       }
     }
 #endif
@@ -562,18 +590,99 @@ static void encode_mb_row(VP8_COMP *cpi, VP8_COMMON *cm, int mb_row,
   vp8_extend_mb_row(&cm->yv12_fb[dst_fb_idx], xd->dst.y_buffer + 16,
                     xd->dst.u_buffer + 8, xd->dst.v_buffer + 8);
 
+  /* this is to account for the border */
+  xd->mode_info_context++;
+  x->partition_info++;
+
 #if CONFIG_MULTITHREAD
   if (vpx_atomic_load_acquire(&cpi->b_multi_threaded) != 0) {
-    vpx_atomic_store_release(current_mb_col,
-                             vpx_atomic_load_acquire(&rightmost_col));
+    vp8_sync_write(current_mb_col, vpx_atomic_load_acquire(&rightmost_col),
+                   &cpi->mt_current_mb_col_waiters[mb_row],
+                   &cpi->mt_current_mb_col_mutex[mb_row],
+                   &cpi->mt_current_mb_col_cond[mb_row]);
   }
 #endif
+}
 
-  /* this is to account for the border */
-  xd->mode_info_context++;
-  x->partition_info++;
+static void save_adapt_state(MB_ADAPT_STATE *state, const MACROBLOCK *x) {
+  memcpy(state->rd_thresh_mult, x->rd_thresh_mult, sizeof(x->rd_thresh_mult));
+  memcpy(state->rd_threshes, x->rd_threshes, sizeof(x->rd_threshes));
+  state->mbs_tested_so_far = x->mbs_tested_so_far;
+  memcpy(state->mode_test_hit_counts, x->mode_test_hit_counts,
+         sizeof(x->mode_test_hit_counts));
 }
 
+static void load_adapt_state(MACROBLOCK *x, const MB_ADAPT_STATE *state) {
+  memcpy(x->rd_thresh_mult, state->rd_thresh_mult, sizeof(x->rd_thresh_mult));
+  memcpy(x->rd_threshes, state->rd_threshes, sizeof(x->rd_threshes));
+  x->mbs_tested_so_far = state->mbs_tested_so_far;
+  memcpy(x->mode_test_hit_counts, state->mode_test_hit_counts,
+         sizeof(x->mode_test_hit_counts));
+}
+
+#if CONFIG_MULTITHREAD
+int vp8cx_get_next_mb_row(VP8_COMP *cpi) {
+  int mb_row;
+
+  pthread_mutex_lock(&cpi->mt_next_mb_row_mutex);
+  mb_row = cpi->mt_next_mb_row;
+  if (mb_row < cpi->common.mb_rows) ++cpi->mt_next_mb_row;
+  pthread_mutex_unlock(&cpi->mt_next_mb_row_mutex);
+
+  return mb_row;
+}
+
+void vp8cx_encode_mt_rows(VP8_COMP *cpi, int slot) {
+  VP8_COMMON *const cm = &cpi->common;
+  MACROBLOCK *x;
+  MACROBLOCKD *xd;
+  int *segment_counts;
+  int *totalrate;
+  int mb_row;
+
+  if (slot == 0) {
+    x = &cpi->mb;
+    segment_counts = cpi->mt_segment_counts;
+    totalrate = &cpi->mt_totalrate;
+  } else {
+    MB_ROW_COMP *const mbri = &cpi->mb_row_ei[slot - 1];
+    x = &mbri->mb;
+    segment_counts = mbri->segment_counts;
+    totalrate = &mbri->totalrate;
+  }
+  xd = &x->e_mbd;
+
+  while ((mb_row = vp8cx_get_next_mb_row(cpi)) < cm->mb_rows) {
+    TOKENEXTRA *tp;
+
+    /* Mode decisions adapt along the row. Starting each row from the frame
+     * state keeps the bitstream independent of which thread claims it.
+     */
+    load_adapt_state(x, &cpi->mt_adapt_start);
+
+    x->src.y_buffer = cpi->Source->y_buffer + 16 * x->src.y_stride * mb_row;
+    x->src.u_buffer = cpi->Source->u_buffer + 8 * x->src.uv_stride * mb_row;
+    x->src.v_buffer = cpi->Source->v_buffer + 8 * x->src.uv_stride * mb_row;
+    xd->mode_info_context = cm->mi + xd->mode_info_stride * mb_row;
+    x->partition_info = cpi->mb.pi + xd->mode_info_stride * mb_row;
+    x->gf_active_ptr =
+        (signed char *)cpi->gf_active_flags + cm->mb_cols * mb_row;
+    memset(xd->left_context, 0, sizeof(*xd->left_context));
+
+#if CONFIG_REALTIME_ONLY & CONFIG_ONTHEFLY_BITPACKING
+    tp = cpi->tok + slot * (16 * 24);
+#else
+    tp = cpi->tok + mb_row * (cm->mb_cols * 16 * 24);
+#endif
+
+    encode_mb_row(cpi, cm, mb_row, x, xd, &tp, segment_counts, totalrate);
+
+    /* The next frame carries on from the state after the last row. */
+    if (mb_row == cm->mb_rows - 1) save_adapt_state(&cpi->mt_adapt_end, x);
+  }
+}
+#endif  // CONFIG_MULTITHREAD
+
 static void init_encode_frame_mb_context(VP8_COMP *cpi) {
   MACROBLOCK *const x = &cpi->mb;
   VP8_COMMON *const cm = &cpi->common;
@@ -659,7 +768,7 @@ static void sum_coef_counts(MACROBLOCK *x, MACROBLOCK *x_thread) {
 
         do {
           x->coef_counts[i][j][k][t] += x_thread->coef_counts[i][j][k][t];
-        } while (++t < ENTROPY_NODES);
+        } while (++t < MAX_ENTROPY_TOKENS);
       } while (++k < PREV_COEF_CONTEXTS);
     } while (++j < COEF_BANDS);
   } while (++i < BLOCK_TYPES);
@@ -758,53 +867,33 @@ void vp8_encode_frame(VP8_COMP *cpi) {
                                 cpi->encoding_thread_count);
 
       if (cpi->mt_current_mb_col_size != cm->mb_rows) {
-        vpx_free(cpi->mt_current_mb_col);
-        cpi->mt_current_mb_col = NULL;
-        cpi->mt_current_mb_col_size = 0;
-        CHECK_MEM_ERROR(
-            &cpi->common.error, cpi->mt_current_mb_col,
-            vpx_malloc(sizeof(*cpi->mt_current_mb_col) * cm->mb_rows));
-        cpi->mt_current_mb_col_size = cm->mb_rows;
+        vp8cx_free_mt_row_sync(cpi);
+        vp8cx_alloc_mt_row_sync(cpi, cm->mb_rows);
       }
       for (i = 0; i < cm->mb_rows; ++i)
         vpx_atomic_store_release(&cpi->mt_current_mb_col[i], -1);
 
+      cpi->mt_next_mb_row = 0;
+      vp8_zero(cpi->mt_segment_counts);
+      cpi->mt_totalrate = 0;
+      save_adapt_state(&cpi->mt_adapt_start, x);
+
       for (i = 0; i < cpi->encoding_thread_count; ++i) {
         vp8_sem_post(&cpi->h_event_start_encoding[i]);
       }
 
-      for (mb_row = 0; mb_row < cm->mb_rows;
-           mb_row += (cpi->encoding_thread_count + 1)) {
-        vp8_zero(cm->left_context);
+      vp8cx_encode_mt_rows(cpi, 0);
 
-#if CONFIG_REALTIME_ONLY & CONFIG_ONTHEFLY_BITPACKING
-        tp = cpi->tok;
-#else
-        tp = cpi->tok + mb_row * (cm->mb_cols * 16 * 24);
-#endif
-
-        encode_mb_row(cpi, cm, mb_row, x, xd, &tp, segment_counts, &totalrate);
-
-        /* adjust to the next row of mbs */
-        x->src.y_buffer +=
-            16 * x->src.y_stride * (cpi->encoding_thread_count + 1) -
-            16 * cm->mb_cols;
-        x->src.u_buffer +=
-            8 * x->src.uv_stride * (cpi->encoding_thread_count + 1) -
-            8 * cm->mb_cols;
-        x->src.v_buffer +=
-            8 * x->src.uv_stride * (cpi->encoding_thread_count + 1) -
-            8 * cm->mb_cols;
-
-        xd->mode_info_context +=
-            xd->mode_info_stride * cpi->encoding_thread_count;
-        x->partition_info += xd->mode_info_stride * cpi->encoding_thread_count;
-        x->gf_active_ptr += cm->mb_cols * cpi->encoding_thread_count;
-      }
       /* Wait for all the threads to finish. */
       for (i = 0; i < cpi->encoding_thread_count; ++i) {
         vp8_sem_wait(&cpi->h_event_end_encoding[i]);
       }
+      load_adapt_state(x, &cpi->mt_adapt_end);
+
+      for (i = 0; i < MAX_MB_SEGMENTS; ++i) {
+        segment_counts[i] += cpi->mt_segment_counts[i];
+      }
+      totalrate += cpi->mt_totalrate;
 
       for (mb_row = 0; mb_row < cm->mb_rows; ++mb_row) {
         cpi->tok_count += (unsigned int)(cpi->tplist[mb_row].stop -
@@ -864,10 +953,16 @@ void vp8_encode_frame(VP8_COMP *cpi) {
     } else
 #endif  // CONFIG_MULTITHREAD
     {
+      MB_ADAPT_STATE adapt_start;
+      save_adapt_state(&adapt_start, x);
 
       /* for each macroblock row in image */
       for (mb_row = 0; mb_row < cm->mb_rows; ++mb_row) {
         vp8_zero(cm->left_context);
+        /* Rows start from the same state as with multiple threads, so the
+         * bitstream does not depend on the thread count.
+         */
+        load_adapt_state(x, &adapt_start);
 
 #if CONFIG_REALTIME_ONLY & CONFIG_ONTHEFLY_BITPACKING
         tp = cpi->tok;
@@ -27,6 +27,17 @@ void vp8_setup_block_ptrs(struct macroblock *x);
 
 void vp8_encode_frame(struct VP8_COMP *cpi);
 
+/* Encodes macroblock rows taken from the shared row counter until none are
+ * left. Called by the main thread with slot 0 and by encoding thread i with
+ * slot i + 1.
+ */
+void vp8cx_encode_mt_rows(struct VP8_COMP *cpi, int slot);
+
+/* Claims the next macroblock row from the shared row counter. Returns
+ * mb_rows once every row has been taken.
+ */
+int vp8cx_get_next_mb_row(struct VP8_COMP *cpi);
+
 int vp8cx_encode_inter_macroblock(struct VP8_COMP *cpi, struct macroblock *x,
                                   TOKENEXTRA **t, int recon_yoffset,
                                   int recon_uvoffset, int mb_row, int mb_col);
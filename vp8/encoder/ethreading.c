@@ -17,12 +17,11 @@
 #include "bitstream.h"
 #include "encodeframe.h"
 #include "ethreading.h"
+#include "picklpf.h"
+#include "temporal_filter.h"
 
 #if CONFIG_MULTITHREAD
 
-extern void vp8cx_mb_init_quantizer(VP8_COMP *cpi, MACROBLOCK *x,
-                                    int ok_to_skip);
-
 static THREADFN thread_loopfilter(void *p_data) {
   VP8_COMP *cpi = (VP8_COMP *)(((LPFTHREAD_DATA *)p_data)->ptr1);
   VP8_COMMON *cm = &cpi->common;
@@ -46,267 +45,25 @@ static THREADFN thread_loopfilter(void *p_data) {
 static THREADFN thread_encoding_proc(void *p_data) {
   int ithread = ((ENCODETHREAD_DATA *)p_data)->ithread;
   VP8_COMP *cpi = (VP8_COMP *)(((ENCODETHREAD_DATA *)p_data)->ptr1);
-  MB_ROW_COMP *mbri = (MB_ROW_COMP *)(((ENCODETHREAD_DATA *)p_data)->ptr2);
-  ENTROPY_CONTEXT_PLANES mb_row_left_context;
 
   while (1) {
     if (vpx_atomic_load_acquire(&cpi->b_multi_threaded) == 0) break;
 
     if (vp8_sem_wait(&cpi->h_event_start_encoding[ithread]) == 0) {
-      const int nsync = cpi->mt_sync_range;
-      VP8_COMMON *cm = &cpi->common;
-      int mb_row;
-      MACROBLOCK *x = &mbri->mb;
-      MACROBLOCKD *xd = &x->e_mbd;
-      TOKENEXTRA *tp;
-#if CONFIG_REALTIME_ONLY & CONFIG_ONTHEFLY_BITPACKING
-      TOKENEXTRA *tp_start = cpi->tok + (1 + ithread) * (16 * 24);
-      const int num_part = (1 << cm->multi_token_partition);
-#endif
-
-      int *segment_counts = mbri->segment_counts;
-      int *totalrate = &mbri->totalrate;
-
       /* we're shutting down */
       if (vpx_atomic_load_acquire(&cpi->b_multi_threaded) == 0) break;
 
-      xd->mode_info_context = cm->mi + cm->mode_info_stride * (ithread + 1);
-      xd->mode_info_stride = cm->mode_info_stride;
-
-      for (mb_row = ithread + 1; mb_row < cm->mb_rows;
-           mb_row += (cpi->encoding_thread_count + 1)) {
-        int recon_yoffset, recon_uvoffset;
-        int mb_col;
-        int ref_fb_idx = cm->lst_fb_idx;
-        int dst_fb_idx = cm->new_fb_idx;
-        int recon_y_stride = cm->yv12_fb[ref_fb_idx].y_stride;
-        int recon_uv_stride = cm->yv12_fb[ref_fb_idx].uv_stride;
-        int map_index = (mb_row * cm->mb_cols);
-        const vpx_atomic_int *last_row_current_mb_col;
-        vpx_atomic_int *current_mb_col = &cpi->mt_current_mb_col[mb_row];
-
-#if (CONFIG_REALTIME_ONLY & CONFIG_ONTHEFLY_BITPACKING)
-        vp8_writer *w = &cpi->bc[1 + (mb_row % num_part)];
-#else
-        tp = cpi->tok + (mb_row * (cm->mb_cols * 16 * 24));
-        cpi->tplist[mb_row].start = tp;
-#endif
-
-        last_row_current_mb_col = &cpi->mt_current_mb_col[mb_row - 1];
-
-        /* reset above block coeffs */
-        xd->above_context = cm->above_context;
-        xd->left_context = &mb_row_left_context;
-
-        vp8_zero(mb_row_left_context);
-
-        xd->up_available = (mb_row != 0);
-        recon_yoffset = (mb_row * recon_y_stride * 16);
-        recon_uvoffset = (mb_row * recon_uv_stride * 8);
-
-        /* Set the mb activity pointer to the start of the row. */
-        x->mb_activity_ptr = &cpi->mb_activity_map[map_index];
-
-        /* for each macroblock col in image */
-        for (mb_col = 0; mb_col < cm->mb_cols; ++mb_col) {
-          if (((mb_col - 1) % nsync) == 0) {
-            vpx_atomic_store_release(current_mb_col, mb_col - 1);
-          }
-
-          if (mb_row && !(mb_col & (nsync - 1))) {
-            vp8_atomic_spin_wait(mb_col, last_row_current_mb_col, nsync);
-          }
-
-#if CONFIG_REALTIME_ONLY & CONFIG_ONTHEFLY_BITPACKING
-          tp = tp_start;
-#endif
-
-          /* Distance of Mb to the various image edges.
-           * These specified to 8th pel as they are always compared
-           * to values that are in 1/8th pel units
-           */
-          xd->mb_to_left_edge = -((mb_col * 16) << 3);
-          xd->mb_to_right_edge = ((cm->mb_cols - 1 - mb_col) * 16) << 3;
-          xd->mb_to_top_edge = -((mb_row * 16) << 3);
-          xd->mb_to_bottom_edge = ((cm->mb_rows - 1 - mb_row) * 16) << 3;
-
-          /* Set up limit values for motion vectors used to prevent
-           * them extending outside the UMV borders
-           */
-          x->mv_col_min = -((mb_col * 16) + (VP8BORDERINPIXELS - 16));
-          x->mv_col_max =
-              ((cm->mb_cols - 1 - mb_col) * 16) + (VP8BORDERINPIXELS - 16);
-          x->mv_row_min = -((mb_row * 16) + (VP8BORDERINPIXELS - 16));
-          x->mv_row_max =
-              ((cm->mb_rows - 1 - mb_row) * 16) + (VP8BORDERINPIXELS - 16);
-
-          xd->dst.y_buffer = cm->yv12_fb[dst_fb_idx].y_buffer + recon_yoffset;
-          xd->dst.u_buffer = cm->yv12_fb[dst_fb_idx].u_buffer + recon_uvoffset;
-          xd->dst.v_buffer = cm->yv12_fb[dst_fb_idx].v_buffer + recon_uvoffset;
-          xd->left_available = (mb_col != 0);
-
-          x->rddiv = cpi->RDDIV;
-          x->rdmult = cpi->RDMULT;
-
-          /* Copy current mb to a buffer */
-          vp8_copy_mem16x16(x->src.y_buffer, x->src.y_stride, x->thismb, 16);
-
-          if (cpi->oxcf.tuning == VP8_TUNE_SSIM) vp8_activity_masking(cpi, x);
-
-          /* Is segmentation enabled */
-          /* MB level adjustment to quantizer */
-          if (xd->segmentation_enabled) {
-            /* Code to set segment id in xd->mbmi.segment_id for
-             * current MB (with range checking)
-             */
-            if (cpi->segmentation_map[map_index + mb_col] <= 3) {
-              xd->mode_info_context->mbmi.segment_id =
-                  cpi->segmentation_map[map_index + mb_col];
-            } else {
-              xd->mode_info_context->mbmi.segment_id = 0;
-            }
-
-            vp8cx_mb_init_quantizer(cpi, x, 1);
-          } else {
-            /* Set to Segment 0 by default */
-            xd->mode_info_context->mbmi.segment_id = 0;
-          }
-
-          x->active_ptr = cpi->active_map + map_index + mb_col;
-
-          if (cm->frame_type == KEY_FRAME) {
-            *totalrate += vp8cx_encode_intra_macroblock(cpi, x, &tp);
-#ifdef MODE_STATS
-            y_modes[xd->mbmi.mode]++;
-#endif
-          } else {
-            *totalrate += vp8cx_encode_inter_macroblock(
-                cpi, x, &tp, recon_yoffset, recon_uvoffset, mb_row, mb_col);
-
-#ifdef MODE_STATS
-            inter_y_modes[xd->mbmi.mode]++;
-
-            if (xd->mbmi.mode == SPLITMV) {
-              int b;
-
-              for (b = 0; b < xd->mbmi.partition_count; ++b) {
-                inter_b_modes[x->partition->bmi[b].mode]++;
-              }
-            }
-
-#endif
-            // Keep track of how many (consecutive) times a  block
-            // is coded as ZEROMV_LASTREF, for base layer frames.
-            // Reset to 0 if its coded as anything else.
-            if (cpi->current_layer == 0) {
-              if (xd->mode_info_context->mbmi.mode == ZEROMV &&
-                  xd->mode_info_context->mbmi.ref_frame == LAST_FRAME) {
-                // Increment, check for wrap-around.
-                if (cpi->consec_zero_last[map_index + mb_col] < 255) {
-                  cpi->consec_zero_last[map_index + mb_col] += 1;
-                }
-                if (cpi->consec_zero_last_mvbias[map_index + mb_col] < 255) {
-                  cpi->consec_zero_last_mvbias[map_index + mb_col] += 1;
-                }
-              } else {
-                cpi->consec_zero_last[map_index + mb_col] = 0;
-                cpi->consec_zero_last_mvbias[map_index + mb_col] = 0;
-              }
-              if (x->zero_last_dot_suppress) {
-                cpi->consec_zero_last_mvbias[map_index + mb_col] = 0;
-              }
-            }
-
-            /* Special case code for cyclic refresh
-             * If cyclic update enabled then copy
-             * xd->mbmi.segment_id; (which may have been updated
-             * based on mode during
-             * vp8cx_encode_inter_macroblock()) back into the
-             * global segmentation map
-             */
-            if ((cpi->current_layer == 0) &&
-                (cpi->cyclic_refresh_mode_enabled &&
-                 xd->segmentation_enabled)) {
-              const MB_MODE_INFO *mbmi = &xd->mode_info_context->mbmi;
-              cpi->segmentation_map[map_index + mb_col] = mbmi->segment_id;
-
-              /* If the block has been refreshed mark it as clean
-               * (the magnitude of the -ve influences how long it
-               * will be before we consider another refresh):
-               * Else if it was coded (last frame 0,0) and has
-               * not already been refreshed then mark it as a
-               * candidate for cleanup next time (marked 0) else
-               * mark it as dirty (1).
-               */
-              if (mbmi->segment_id) {
-                cpi->cyclic_refresh_map[map_index + mb_col] = -1;
-              } else if ((mbmi->mode == ZEROMV) &&
-                         (mbmi->ref_frame == LAST_FRAME)) {
-                if (cpi->cyclic_refresh_map[map_index + mb_col] == 1) {
-                  cpi->cyclic_refresh_map[map_index + mb_col] = 0;
-                }
-              } else {
-                cpi->cyclic_refresh_map[map_index + mb_col] = 1;
-              }
-            }
-          }
-
-#if CONFIG_REALTIME_ONLY & CONFIG_ONTHEFLY_BITPACKING
-          /* pack tokens for this MB */
-          {
-            int tok_count = tp - tp_start;
-            vp8_pack_tokens(w, tp_start, tok_count);
-          }
-#else
-          cpi->tplist[mb_row].stop = tp;
+      /* Take rows from the shared counter until none are left. */
+      switch (cpi->mt_row_job) {
+#if VP8_TEMPORAL_ALT_REF
+        case MT_TEMPORAL_FILTER_ROWS:
+          vp8_temporal_filter_mt_rows(cpi, &cpi->mb_row_ei[ithread].mb);
+          break;
 #endif
-          /* Increment pointer into gf usage flags structure. */
-          x->gf_active_ptr++;
-
-          /* Increment the activity mask pointers. */
-          x->mb_activity_ptr++;
-
-          /* adjust to the next column of macroblocks */
-          x->src.y_buffer += 16;
-          x->src.u_buffer += 8;
-          x->src.v_buffer += 8;
-
-          recon_yoffset += 16;
-          recon_uvoffset += 8;
-
-          /* Keep track of segment usage */
-          segment_counts[xd->mode_info_context->mbmi.segment_id]++;
-
-          /* skip to next mb */
-          xd->mode_info_context++;
-          x->partition_info++;
-          xd->above_context++;
-        }
-
-        vp8_extend_mb_row(&cm->yv12_fb[dst_fb_idx], xd->dst.y_buffer + 16,
-                          xd->dst.u_buffer + 8, xd->dst.v_buffer + 8);
-
-        vpx_atomic_store_release(current_mb_col, mb_col + nsync);
-
-        /* this is to account for the border */
-        xd->mode_info_context++;
-        x->partition_info++;
-
-        x->src.y_buffer +=
-            16 * x->src.y_stride * (cpi->encoding_thread_count + 1) -
-            16 * cm->mb_cols;
-        x->src.u_buffer +=
-            8 * x->src.uv_stride * (cpi->encoding_thread_count + 1) -
-            8 * cm->mb_cols;
-        x->src.v_buffer +=
-            8 * x->src.uv_stride * (cpi->encoding_thread_count + 1) -
-            8 * cm->mb_cols;
-
-        xd->mode_info_context +=
-            xd->mode_info_stride * cpi->encoding_thread_count;
-        x->partition_info += xd->mode_info_stride * cpi->encoding_thread_count;
-        x->gf_active_ptr += cm->mb_cols * cpi->encoding_thread_count;
+        case MT_PICK_LPF_ROWS: vp8cx_pick_lpf_mt_rows(cpi); break;
+        default: vp8cx_encode_mt_rows(cpi, ithread + 1); break;
       }
+
       /* Signal that this thread has completed processing its rows. */
       vp8_sem_post(&cpi->h_event_end_encoding[ithread]);
     }
@@ -367,12 +124,15 @@ static void setup_mbby_copy(MACROBLOCK *mbdst, MACROBLOCK *mbsrc) {
     z->block[i].zbin = x->block[i].zbin;
     z->block[i].zrun_zbin_boost = x->block[i].zrun_zbin_boost;
     z->block[i].round = x->block[i].round;
+    z->block[i].zbin_extra = x->block[i].zbin_extra;
     z->block[i].src_stride = x->block[i].src_stride;
   }
 
   z->q_index = x->q_index;
   z->act_zbin_adj = x->act_zbin_adj;
   z->last_act_zbin_adj = x->last_act_zbin_adj;
+  z->last_zbin_over_quant = x->last_zbin_over_quant;
+  z->last_zbin_mode_boost = x->last_zbin_mode_boost;
 
   {
     MACROBLOCKD *xd = &x->e_mbd;
@@ -467,8 +227,10 @@ void vp8cx_init_mbrthread_data(VP8_COMP *cpi, MACROBLOCK *x,
 
     vp8_build_block_offsets(mb);
 
-    mbd->left_context = &cm->left_context;
+    mbd->mode_info_stride = cm->mode_info_stride;
+    mbd->left_context = &mbr_ei[i].left_context;
     mb->mvc = cm->fc.mvc;
+    memcpy(mb->ref_frame_cost, x->ref_frame_cost, sizeof(x->ref_frame_cost));
 
     setup_mbby_copy(&mbr_ei[i].mb, x);
 
@@ -476,7 +238,8 @@ void vp8cx_init_mbrthread_data(VP8_COMP *cpi, MACROBLOCK *x,
     if (cm->full_pixel) mbd->fullpixel_mask = ~7;
 
     vp8_zero(mb->coef_counts);
-    vp8_zero(x->ymode_count);
+    vp8_zero(mb->ymode_count);
+    vp8_zero(mb->uv_mode_count);
     mb->skip_true_count = 0;
     vp8_zero(mb->MVcount);
     mb->prediction_error = 0;
@@ -487,6 +250,61 @@ void vp8cx_init_mbrthread_data(VP8_COMP *cpi, MACROBLOCK *x,
   }
 }
 
+void vp8cx_init_arnr_thread_data(VP8_COMP *cpi) {
+  int i;
+
+  /* The ARNR motion search only needs the search parameters and the
+   * predictors; the per-macroblock state is set up by the filter itself.
+   */
+  for (i = 0; i < cpi->encoding_thread_count; ++i) {
+    setup_mbby_copy(&cpi->mb_row_ei[i].mb, &cpi->mb);
+  }
+}
+
+void vp8cx_alloc_mt_row_sync(VP8_COMP *cpi, int mb_rows) {
+  int i;
+
+  CHECK_MEM_ERROR(&cpi->common.error, cpi->mt_current_mb_col,
+                  vpx_malloc(sizeof(*cpi->mt_current_mb_col) * mb_rows));
+  CHECK_MEM_ERROR(&cpi->common.error, cpi->mt_current_mb_col_mutex,
+                  vpx_malloc(sizeof(*cpi->mt_current_mb_col_mutex) * mb_rows));
+  CHECK_MEM_ERROR(&cpi->common.error, cpi->mt_current_mb_col_cond,
+                  vpx_malloc(sizeof(*cpi->mt_current_mb_col_cond) * mb_rows));
+  CHECK_MEM_ERROR(
+      &cpi->common.error, cpi->mt_current_mb_col_waiters,
+      vpx_malloc(sizeof(*cpi->mt_current_mb_col_waiters) * mb_rows));
+  for (i = 0; i < mb_rows; ++i) {
+    pthread_mutex_init(&cpi->mt_current_mb_col_mutex[i], NULL);
+    pthread_cond_init(&cpi->mt_current_mb_col_cond[i], NULL);
+    vpx_atomic_init(&cpi->mt_current_mb_col_waiters[i], 0);
+  }
+  cpi->mt_current_mb_col_size = mb_rows;
+}
+
+void vp8cx_free_mt_row_sync(VP8_COMP *cpi) {
+  int i;
+
+  if (cpi->mt_current_mb_col_mutex != NULL) {
+    for (i = 0; i < cpi->mt_current_mb_col_size; ++i) {
+      pthread_mutex_destroy(&cpi->mt_current_mb_col_mutex[i]);
+    }
+  }
+  if (cpi->mt_current_mb_col_cond != NULL) {
+    for (i = 0; i < cpi->mt_current_mb_col_size; ++i) {
+      pthread_cond_destroy(&cpi->mt_current_mb_col_cond[i]);
+    }
+  }
+  vpx_free(cpi->mt_current_mb_col);
+  cpi->mt_current_mb_col = NULL;
+  vpx_free(cpi->mt_current_mb_col_mutex);
+  cpi->mt_current_mb_col_mutex = NULL;
+  vpx_free(cpi->mt_current_mb_col_cond);
+  cpi->mt_current_mb_col_cond = NULL;
+  vpx_free(cpi->mt_current_mb_col_waiters);
+  cpi->mt_current_mb_col_waiters = NULL;
+  cpi->mt_current_mb_col_size = 0;
+}
+
 int vp8cx_create_encoder_threads(VP8_COMP *cpi) {
   const VP8_COMMON *cm = &cpi->common;
   int th_count = 0;
@@ -524,6 +342,7 @@ int vp8cx_create_encoder_threads(VP8_COMP *cpi) {
     CHECK_MEM_ERROR(&cpi->common.error, cpi->en_thread_data,
                     vpx_malloc(sizeof(ENCODETHREAD_DATA) * th_count));
 
+    pthread_mutex_init(&cpi->mt_next_mb_row_mutex, NULL);
     vpx_atomic_store_release(&cpi->b_multi_threaded, 1);
     cpi->encoding_thread_count = th_count;
 
@@ -574,6 +393,7 @@ int vp8cx_create_encoder_threads(VP8_COMP *cpi) {
       vpx_free(cpi->en_thread_data);
       cpi->en_thread_data = NULL;
       cpi->encoding_thread_count = 0;
+      pthread_mutex_destroy(&cpi->mt_next_mb_row_mutex);
 
       return -1;
     }
@@ -612,6 +432,7 @@ int vp8cx_create_encoder_threads(VP8_COMP *cpi) {
         vpx_free(cpi->en_thread_data);
         cpi->en_thread_data = NULL;
         cpi->encoding_thread_count = 0;
+        pthread_mutex_destroy(&cpi->mt_next_mb_row_mutex);
 
         return -2;
       }
@@ -646,9 +467,8 @@ void vp8cx_remove_encoder_threads(VP8_COMP *cpi) {
     cpi->b_lpf_running = 0;
 
     /* free thread related resources */
-    vpx_free(cpi->mt_current_mb_col);
-    cpi->mt_current_mb_col = NULL;
-    cpi->mt_current_mb_col_size = 0;
+    vp8cx_free_mt_row_sync(cpi);
+    pthread_mutex_destroy(&cpi->mt_next_mb_row_mutex);
     vpx_free(cpi->h_event_start_encoding);
     cpi->h_event_start_encoding = NULL;
     vpx_free(cpi->h_event_end_encoding);
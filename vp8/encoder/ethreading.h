@@ -22,6 +22,9 @@ struct macroblock;
 
 void vp8cx_init_mbrthread_data(struct VP8_COMP *cpi, struct macroblock *x,
                                MB_ROW_COMP *mbr_ei, int count);
+void vp8cx_init_arnr_thread_data(struct VP8_COMP *cpi);
+void vp8cx_alloc_mt_row_sync(struct VP8_COMP *cpi, int mb_rows);
+void vp8cx_free_mt_row_sync(struct VP8_COMP *cpi);
 int vp8cx_create_encoder_threads(struct VP8_COMP *cpi);
 void vp8cx_remove_encoder_threads(struct VP8_COMP *cpi);
 
@@ -410,6 +410,8 @@ static void initialize_enc(void) {
 void vp8_initialize_enc(void) { once(initialize_enc); }
 
 static void dealloc_compressor_data(VP8_COMP *cpi) {
+  int i;
+
   vpx_free(cpi->tplist);
   cpi->tplist = NULL;
 
@@ -432,7 +434,9 @@ static void dealloc_compressor_data(VP8_COMP *cpi) {
 
   vp8_de_alloc_frame_buffers(&cpi->common);
 
-  vp8_yv12_de_alloc_frame_buffer(&cpi->pick_lf_lvl_frame);
+  for (i = 0; i < MAX_LPF_TRIALS; ++i) {
+    vp8_yv12_de_alloc_frame_buffer(&cpi->pick_lf_lvl_frame[i]);
+  }
   vp8_yv12_de_alloc_frame_buffer(&cpi->scaled_source);
   dealloc_raw_frame_buffers(cpi);
 
@@ -1136,6 +1140,7 @@ void vp8_alloc_compressor_data(VP8_COMP *cpi) {
 
   int width = cm->Width;
   int height = cm->Height;
+  int i;
 
   if (vp8_alloc_frame_buffers(cm, width, height)) {
     vpx_internal_error(&cpi->common.error, VPX_CODEC_MEM_ERROR,
@@ -1151,10 +1156,12 @@ void vp8_alloc_compressor_data(VP8_COMP *cpi) {
 
   if ((height & 0xf) != 0) height += 16 - (height & 0xf);
 
-  if (vp8_yv12_alloc_frame_buffer(&cpi->pick_lf_lvl_frame, width, height,
-                                  VP8BORDERINPIXELS)) {
-    vpx_internal_error(&cpi->common.error, VPX_CODEC_MEM_ERROR,
-                       "Failed to allocate last frame buffer");
+  for (i = 0; i < MAX_LPF_TRIALS; ++i) {
+    if (vp8_yv12_alloc_frame_buffer(&cpi->pick_lf_lvl_frame[i], width, height,
+                                    VP8BORDERINPIXELS)) {
+      vpx_internal_error(&cpi->common.error, VPX_CODEC_MEM_ERROR,
+                         "Failed to allocate last frame buffer");
+    }
   }
 
   if (vp8_yv12_alloc_frame_buffer(&cpi->scaled_source, width, height,
@@ -187,8 +187,20 @@ typedef struct {
   MACROBLOCK mb;
   int segment_counts[MAX_MB_SEGMENTS];
   int totalrate;
+  ENTROPY_CONTEXT_PLANES left_context;
 } MB_ROW_COMP;
 
+/* Mode decision state that adapts from one macroblock to the next. Every
+ * row starts from the state at the start of the frame, so that the result
+ * does not depend on the thread count or on which thread encodes the row.
+ */
+typedef struct {
+  int rd_thresh_mult[MAX_MODES];
+  int rd_threshes[MAX_MODES];
+  unsigned int mbs_tested_so_far;
+  unsigned int mode_test_hit_counts[MAX_MODES];
+} MB_ADAPT_STATE;
+
 typedef struct {
   TOKENEXTRA *start;
   TOKENEXTRA *stop;
@@ -204,6 +216,24 @@ typedef struct {
   void *ptr1;
 } LPFTHREAD_DATA;
 
+/* Work done by the encoding threads when their start event is posted. */
+typedef enum {
+  MT_ENCODE_MB_ROWS = 0,
+  MT_TEMPORAL_FILTER_ROWS,
+  MT_PICK_LPF_ROWS
+} MT_ROW_JOB;
+
+/* Number of loop filter levels vp8cx_pick_filter_level() tries at once. */
+#define MAX_LPF_TRIALS 2
+
+typedef struct {
+  YV12_BUFFER_CONFIG *source;
+  YV12_BUFFER_CONFIG *unfiltered;
+  int num_trials;
+  unsigned char lvl[MAX_LPF_TRIALS][4][4][4];
+  unsigned int err[MAX_LPF_TRIALS];
+} LPF_TRIALS;
+
 enum {
   BLOCK_16X8,
   BLOCK_8X16,
@@ -320,7 +350,8 @@ typedef struct VP8_COMP {
   /* don't do both alt and gold search ( just do gold). */
   int gold_is_alt;
 
-  YV12_BUFFER_CONFIG pick_lf_lvl_frame;
+  YV12_BUFFER_CONFIG pick_lf_lvl_frame[MAX_LPF_TRIALS];
+  LPF_TRIALS lpf_trials;
 
   TOKENEXTRA *tok;
   unsigned int tok_count;
@@ -527,7 +558,20 @@ typedef struct VP8_COMP {
 #if CONFIG_MULTITHREAD
   /* multithread data */
   vpx_atomic_int *mt_current_mb_col;
+  pthread_mutex_t *mt_current_mb_col_mutex;
+  pthread_cond_t *mt_current_mb_col_cond;
+  vpx_atomic_int *mt_current_mb_col_waiters;
   int mt_current_mb_col_size;
+  /* Next macroblock row to be claimed by an encoding thread. */
+  int mt_next_mb_row;
+  pthread_mutex_t mt_next_mb_row_mutex;
+  /* Totals for the rows encoded with cpi->mb. */
+  int mt_segment_counts[MAX_MB_SEGMENTS];
+  int mt_totalrate;
+  /* Adaptive state at the start of the frame and after the last row. */
+  MB_ADAPT_STATE mt_adapt_start;
+  MB_ADAPT_STATE mt_adapt_end;
+  MT_ROW_JOB mt_row_job;
   int mt_sync_range;
   vpx_atomic_int b_multi_threaded;
   int encoding_thread_count;
@@ -609,6 +653,10 @@ typedef struct VP8_COMP {
   YV12_BUFFER_CONFIG alt_ref_buffer;
   YV12_BUFFER_CONFIG *frames[MAX_LAG_BUFFERS];
   int fixed_divide[512];
+  /* Parameters of the ARNR filter pass in progress. */
+  int arnr_frame_count;
+  int arnr_alt_ref_index;
+  int arnr_filter_strength;
 #endif
 
 #if CONFIG_INTERNAL_STATS
@@ -56,7 +56,7 @@ static int check_dot_artifact_candidate(VP8_COMP *cpi, MACROBLOCK *x,
                                         int mb_col, int channel) {
   int threshold1 = 6;
   int threshold2 = 3;
-  unsigned int max_num = (cpi->common.MBs) / 10;
+  unsigned int max_num = cpi->common.mb_cols / 10;
   int grad_last = 0;
   int grad_source = 0;
   int index = mb_row * cpi->common.mb_cols + mb_col;
@@ -73,7 +73,8 @@ static int check_dot_artifact_candidate(VP8_COMP *cpi, MACROBLOCK *x,
   // Blocks on base layer frames that have been using ZEROMV_LAST repeatedly
   // (i.e, at least |x| consecutive frames are candidates for increasing the
   // rd adjustment for zero_last mode.
-  // Only allow this for at most |max_num| blocks per frame.
+  // Only allow this for at most |max_num| blocks per row, so that rows can be
+  // encoded in any order.
   // Don't allow this for screen content input.
   if (cpi->current_layer == 0 &&
       cpi->consec_zero_last_mvbias[index] > num_frames &&
@@ -18,13 +18,12 @@
 #include "vpx_scale/vpx_scale.h"
 #include "vp8/common/alloccommon.h"
 #include "vp8/common/loopfilter.h"
+#include "vp8/common/threading.h"
+#include "vp8/encoder/encodeframe.h"
 #if VPX_ARCH_ARM
 #include "vpx_ports/arm.h"
 #endif
 
-extern int vp8_calc_ss_err(YV12_BUFFER_CONFIG *source,
-                           YV12_BUFFER_CONFIG *dest);
-
 static void yv12_copy_partial_frame(YV12_BUFFER_CONFIG *src_ybc,
                                     YV12_BUFFER_CONFIG *dst_ybc) {
   unsigned char *src_y, *dst_y;
@@ -148,7 +147,7 @@ void vp8cx_pick_filter_level_fast(YV12_BUFFER_CONFIG *sd, VP8_COMP *cpi) {
   YV12_BUFFER_CONFIG *saved_frame = cm->frame_to_show;
 
   /* Replace unfiltered frame buffer with a new one */
-  cm->frame_to_show = &cpi->pick_lf_lvl_frame;
+  cm->frame_to_show = &cpi->pick_lf_lvl_frame[0];
 
   if (cm->frame_type == KEY_FRAME) {
     cm->sharpness_level = 0;
@@ -262,6 +261,182 @@ void vp8cx_set_alt_lf_level(VP8_COMP *cpi, int filt_val) {
       cpi->segment_feature_data[MB_LVL_ALT_LF][3];
 }
 
+/* Sum of squared Y differences over one macroblock row, accumulated as
+ * vp8_calc_ss_err() does for the whole frame.
+ */
+static unsigned int calc_row_ss_err(const YV12_BUFFER_CONFIG *source,
+                                    const YV12_BUFFER_CONFIG *dest,
+                                    int mb_row) {
+  int j;
+  unsigned int total = 0;
+  const unsigned char *src = source->y_buffer + 16 * mb_row * source->y_stride;
+  const unsigned char *dst = dest->y_buffer + 16 * mb_row * dest->y_stride;
+
+  for (j = 0; j < source->y_width; j += 16) {
+    unsigned int sse;
+    total +=
+        vpx_mse16x16(src + j, source->y_stride, dst + j, dest->y_stride, &sse);
+  }
+
+  return total;
+}
+
+/* Filters macroblock row mb_row of every trial frame. Filtering a row
+ * modifies the bottom of the row above, so the error of a row is taken
+ * once the row below it has been filtered.
+ */
+static void pick_lpf_mb_row(VP8_COMP *cpi, int mb_row) {
+  VP8_COMMON *const cm = &cpi->common;
+  LPF_TRIALS *const trials = &cpi->lpf_trials;
+  const YV12_BUFFER_CONFIG *const src = trials->unfiltered;
+  const MODE_INFO *mode_info_context = cm->mi + cm->mode_info_stride * mb_row;
+  unsigned int err[MAX_LPF_TRIALS] = { 0 };
+  int mb_col, i, k;
+#if CONFIG_MULTITHREAD
+  const int nsync = cpi->mt_sync_range;
+  const int mt = vpx_atomic_load_acquire(&cpi->b_multi_threaded) != 0;
+  vpx_atomic_int *const current_mb_col = &cpi->mt_current_mb_col[mb_row];
+#endif
+
+  /* Copy the unfiltered / processed recon rows to the trial buffers */
+  for (k = 0; k < trials->num_trials; ++k) {
+    const YV12_BUFFER_CONFIG *const dst = &cpi->pick_lf_lvl_frame[k];
+    for (i = 0; i < 16; ++i) {
+      memcpy(dst->y_buffer + (16 * mb_row + i) * dst->y_stride,
+             src->y_buffer + (16 * mb_row + i) * src->y_stride, src->y_width);
+    }
+  }
+
+  for (mb_col = 0; mb_col < cm->mb_cols; ++mb_col) {
+#if CONFIG_MULTITHREAD
+    if (mt) {
+      if (((mb_col - 1) % nsync) == 0) {
+        vp8_sync_write(current_mb_col, mb_col - 1,
+                       &cpi->mt_current_mb_col_waiters[mb_row],
+                       &cpi->mt_current_mb_col_mutex[mb_row],
+                       &cpi->mt_current_mb_col_cond[mb_row]);
+      }
+
+      if (mb_row && !(mb_col & (nsync - 1))) {
+        vp8_sync_wait(mb_col, &cpi->mt_current_mb_col[mb_row - 1], nsync,
+                      &cpi->mt_current_mb_col_waiters[mb_row - 1],
+                      &cpi->mt_current_mb_col_mutex[mb_row - 1],
+                      &cpi->mt_current_mb_col_cond[mb_row - 1]);
+      }
+    }
+#endif
+
+    for (k = 0; k < trials->num_trials; ++k) {
+      const YV12_BUFFER_CONFIG *const dst = &cpi->pick_lf_lvl_frame[k];
+      vp8_loop_filter_mb_yonly(
+          cm, trials->lvl[k], mode_info_context, mb_row, mb_col,
+          dst->y_buffer + 16 * (mb_row * dst->y_stride + mb_col),
+          dst->y_stride);
+    }
+
+    mode_info_context++;
+  }
+
+#if CONFIG_MULTITHREAD
+  if (mt) {
+    vp8_sync_write(current_mb_col, cm->mb_cols + nsync,
+                   &cpi->mt_current_mb_col_waiters[mb_row],
+                   &cpi->mt_current_mb_col_mutex[mb_row],
+                   &cpi->mt_current_mb_col_cond[mb_row]);
+
+    /* Wait for the row above to be complete before measuring it. */
+    if (mb_row) {
+      vp8_sync_wait(cm->mb_cols, &cpi->mt_current_mb_col[mb_row - 1], nsync,
+                    &cpi->mt_current_mb_col_waiters[mb_row - 1],
+                    &cpi->mt_current_mb_col_mutex[mb_row - 1],
+                    &cpi->mt_current_mb_col_cond[mb_row - 1]);
+    }
+  }
+#endif
+
+  for (i = mb_row - 1; i <= mb_row; ++i) {
+    /* The row above is final now, and so is the last row. */
+    if (i < 0 || (i == mb_row && mb_row != cm->mb_rows - 1)) continue;
+    if (16 * i >= trials->source->y_height) continue;
+    for (k = 0; k < trials->num_trials; ++k) {
+      err[k] +=
+          calc_row_ss_err(trials->source, &cpi->pick_lf_lvl_frame[k], i);
+    }
+  }
+
+#if CONFIG_MULTITHREAD
+  if (mt) pthread_mutex_lock(&cpi->mt_next_mb_row_mutex);
+#endif
+  for (k = 0; k < trials->num_trials; ++k) trials->err[k] += err[k];
+#if CONFIG_MULTITHREAD
+  if (mt) pthread_mutex_unlock(&cpi->mt_next_mb_row_mutex);
+#endif
+}
+
+#if CONFIG_MULTITHREAD
+void vp8cx_pick_lpf_mt_rows(VP8_COMP *cpi) {
+  int mb_row;
+
+  while ((mb_row = vp8cx_get_next_mb_row(cpi)) < cpi->common.mb_rows) {
+    pick_lpf_mb_row(cpi, mb_row);
+  }
+}
+#endif
+
+/* Filters a copy of the unfiltered frame with each of the num_levels levels
+ * and stores the resulting errors in ss_err. The rows are spread over the
+ * encoding threads when they are available.
+ */
+static void try_filter_levels(VP8_COMP *cpi, YV12_BUFFER_CONFIG *sd,
+                              YV12_BUFFER_CONFIG *unfiltered,
+                              const int *levels, int num_levels,
+                              int *ss_err) {
+  VP8_COMMON *const cm = &cpi->common;
+  LPF_TRIALS *const trials = &cpi->lpf_trials;
+  int k;
+
+  trials->source = sd;
+  trials->unfiltered = unfiltered;
+  trials->num_trials = num_levels;
+  for (k = 0; k < num_levels; ++k) {
+    vp8_loop_filter_calc_lvl(&cpi->mb.e_mbd, levels[k], trials->lvl[k]);
+    trials->err[k] = 0;
+  }
+
+#if CONFIG_MULTITHREAD
+  if (vpx_atomic_load_acquire(&cpi->b_multi_threaded)) {
+    int i;
+
+    for (i = 0; i < cm->mb_rows; ++i) {
+      vpx_atomic_store_release(&cpi->mt_current_mb_col[i], -1);
+    }
+
+    cpi->mt_next_mb_row = 0;
+    cpi->mt_row_job = MT_PICK_LPF_ROWS;
+
+    for (i = 0; i < cpi->encoding_thread_count; ++i) {
+      vp8_sem_post(&cpi->h_event_start_encoding[i]);
+    }
+
+    vp8cx_pick_lpf_mt_rows(cpi);
+
+    for (i = 0; i < cpi->encoding_thread_count; ++i) {
+      vp8_sem_wait(&cpi->h_event_end_encoding[i]);
+    }
+
+    cpi->mt_row_job = MT_ENCODE_MB_ROWS;
+  } else
+#endif
+  {
+    int mb_row;
+    for (mb_row = 0; mb_row < cm->mb_rows; ++mb_row) {
+      pick_lpf_mb_row(cpi, mb_row);
+    }
+  }
+
+  for (k = 0; k < num_levels; ++k) ss_err[levels[k]] = (int)trials->err[k];
+}
+
 void vp8cx_pick_filter_level(YV12_BUFFER_CONFIG *sd, VP8_COMP *cpi) {
   VP8_COMMON *cm = &cpi->common;
 
@@ -286,15 +461,17 @@ void vp8cx_pick_filter_level(YV12_BUFFER_CONFIG *sd, VP8_COMP *cpi) {
 
   memset(ss_err, 0, sizeof(ss_err));
 
-  /* Replace unfiltered frame buffer with a new one */
-  cm->frame_to_show = &cpi->pick_lf_lvl_frame;
-
   if (cm->frame_type == KEY_FRAME) {
     cm->sharpness_level = 0;
   } else {
     cm->sharpness_level = cpi->oxcf.Sharpness;
   }
 
+  if (cm->sharpness_level != cm->last_sharpness_level) {
+    vp8_loop_filter_update_sharpness(&cm->lf_info, cm->sharpness_level);
+    cm->last_sharpness_level = cm->sharpness_level;
+  }
+
   /* Start the search at the previous frame filter level unless it is
    * now out of range.
    */
@@ -310,20 +487,17 @@ void vp8cx_pick_filter_level(YV12_BUFFER_CONFIG *sd, VP8_COMP *cpi) {
   filter_step = (filt_mid < 16) ? 4 : filt_mid / 4;
 
   /* Get baseline error score */
-
-  /* Copy the unfiltered / processed recon buffer to the new buffer */
-  vpx_yv12_copy_y(saved_frame, cm->frame_to_show);
-
   vp8cx_set_alt_lf_level(cpi, filt_mid);
-  vp8_loop_filter_frame_yonly(cm, &cpi->mb.e_mbd, filt_mid);
-
-  best_err = vp8_calc_ss_err(sd, cm->frame_to_show);
+  try_filter_levels(cpi, sd, saved_frame, &filt_mid, 1, ss_err);
 
-  ss_err[filt_mid] = best_err;
+  best_err = ss_err[filt_mid];
 
   filt_best = filt_mid;
 
   while (filter_step > 0) {
+    int levels[MAX_LPF_TRIALS];
+    int num_levels = 0;
+
     Bias = (best_err >> (15 - (filt_mid / 8))) * filter_step;
 
     if (cpi->twopass.section_intra_rating < 20) {
@@ -337,18 +511,21 @@ void vp8cx_pick_filter_level(YV12_BUFFER_CONFIG *sd, VP8_COMP *cpi) {
                    ? min_filter_level
                    : (filt_mid - filter_step);
 
+    /* Get the low and high filter error scores together */
+    if ((filt_direction <= 0) && (filt_low != filt_mid) &&
+        ss_err[filt_low] == 0) {
+      levels[num_levels++] = filt_low;
+    }
+    if ((filt_direction >= 0) && (filt_high != filt_mid) &&
+        ss_err[filt_high] == 0) {
+      levels[num_levels++] = filt_high;
+    }
+    if (num_levels > 0) {
+      try_filter_levels(cpi, sd, saved_frame, levels, num_levels, ss_err);
+    }
+
     if ((filt_direction <= 0) && (filt_low != filt_mid)) {
-      if (ss_err[filt_low] == 0) {
-        /* Get Low filter error score */
-        vpx_yv12_copy_y(saved_frame, cm->frame_to_show);
-        vp8cx_set_alt_lf_level(cpi, filt_low);
-        vp8_loop_filter_frame_yonly(cm, &cpi->mb.e_mbd, filt_low);
-
-        filt_err = vp8_calc_ss_err(sd, cm->frame_to_show);
-        ss_err[filt_low] = filt_err;
-      } else {
-        filt_err = ss_err[filt_low];
-      }
+      filt_err = ss_err[filt_low];
 
       /* If value is close to the best so far then bias towards a
        * lower loop filter value.
@@ -363,16 +540,7 @@ void vp8cx_pick_filter_level(YV12_BUFFER_CONFIG *sd, VP8_COMP *cpi) {
 
     /* Now look at filt_high */
     if ((filt_direction >= 0) && (filt_high != filt_mid)) {
-      if (ss_err[filt_high] == 0) {
-        vpx_yv12_copy_y(saved_frame, cm->frame_to_show);
-        vp8cx_set_alt_lf_level(cpi, filt_high);
-        vp8_loop_filter_frame_yonly(cm, &cpi->mb.e_mbd, filt_high);
-
-        filt_err = vp8_calc_ss_err(sd, cm->frame_to_show);
-        ss_err[filt_high] = filt_err;
-      } else {
-        filt_err = ss_err[filt_high];
-      }
+      filt_err = ss_err[filt_high];
 
       /* Was it better than the previous best? */
       if (filt_err < (best_err - Bias)) {
@@ -394,7 +562,4 @@ void vp8cx_pick_filter_level(YV12_BUFFER_CONFIG *sd, VP8_COMP *cpi) {
   }
 
   cm->filter_level = filt_best;
-
-  /* restore unfiltered frame pointer */
-  cm->frame_to_show = saved_frame;
 }
@@ -23,6 +23,12 @@ void vp8cx_pick_filter_level_fast(struct yv12_buffer_config *sd,
 void vp8cx_set_alt_lf_level(struct VP8_COMP *cpi, int filt_val);
 void vp8cx_pick_filter_level(struct yv12_buffer_config *sd, VP8_COMP *cpi);
 
+/* Filters the macroblock rows of the loop filter level trials taken from the
+ * shared row counter until none are left. Called by the picking thread and
+ * each encoding thread.
+ */
+void vp8cx_pick_lpf_mt_rows(struct VP8_COMP *cpi);
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,9 +16,16 @@ extern "C" {
 #endif
 
 struct VP8_COMP;
+struct macroblock;
 
 void vp8_temporal_filter_prepare_c(struct VP8_COMP *cpi, int distance);
 
+/* Filters macroblock rows of the alt-ref frame taken from the shared row
+ * counter until none are left, using x for the motion search. Called by
+ * the main thread and each encoding thread.
+ */
+void vp8_temporal_filter_mt_rows(struct VP8_COMP *cpi, struct macroblock *x);
+
 #ifdef __cplusplus
 }
 #endif
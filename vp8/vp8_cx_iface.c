@@ -932,6 +932,8 @@ static vpx_codec_err_t vp8e_encode(vpx_codec_alg_priv_t *ctx,
     size_t size, cx_data_sz;
     unsigned char *cx_data;
     unsigned char *cx_data_end;
+    /* The padding around each packet written to the application's buffer. */
+    size_t pad_before = 0, pad_after = 0;
     int comp_data_state = 0;
 
     if (setjmp(ctx->cpi->common.error.jmp)) {
@@ -1006,7 +1008,25 @@ static vpx_codec_err_t vp8e_encode(vpx_codec_alg_priv_t *ctx,
 
     cx_data = ctx->cx_data;
     cx_data_sz = ctx->cx_data_sz;
-    cx_data_end = ctx->cx_data + cx_data_sz;
+
+    /* Write straight into the buffer given to vpx_codec_set_cx_data_buf() if
+     * it has room for a frame, so vpx_codec_get_cx_data() has nothing to
+     * copy. Partitions are returned as separate packets without padding
+     * between them, so they keep using the internal buffer.
+     */
+    if (ctx->base.enc.cx_data_dst_buf.buf != NULL &&
+        !((VP8_COMP *)ctx->cpi)->output_partition) {
+      const vpx_fixed_buf_t *const dst_buf = &ctx->base.enc.cx_data_dst_buf;
+      const size_t pads =
+          ctx->base.enc.cx_data_pad_before + ctx->base.enc.cx_data_pad_after;
+      if (dst_buf->sz >= pads + ctx->cx_data_sz / 2) {
+        pad_before = ctx->base.enc.cx_data_pad_before;
+        pad_after = ctx->base.enc.cx_data_pad_after;
+        cx_data = (unsigned char *)dst_buf->buf + pad_before;
+        cx_data_sz = dst_buf->sz - pads;
+      }
+    }
+    cx_data_end = cx_data + cx_data_sz;
     lib_flags = 0;
 
     while (cx_data_sz >= ctx->cx_data_sz / 2) {
@@ -1096,12 +1116,14 @@ static vpx_codec_err_t vp8e_encode(vpx_codec_alg_priv_t *ctx,
           cx_data_sz -= ctx->cx_data_sz / 2;
 #endif
         } else {
-          pkt.data.frame.buf = cx_data;
-          pkt.data.frame.sz = size;
+          pkt.data.frame.buf = cx_data - pad_before;
+          pkt.data.frame.sz = pad_before + size + pad_after;
           pkt.data.frame.partition_id = -1;
           vpx_codec_pkt_list_add(&ctx->pkt_list.head, &pkt);
+          /* The next packet starts after this one's padding. */
+          size += pad_after + pad_before;
           cx_data += size;
-          cx_data_sz -= size;
+          cx_data_sz -= VPXMIN(size, cx_data_sz);
         }
       }
     }
@@ -52,6 +52,7 @@ struct vpx_codec_alg_priv {
   // are shut down.
   int restart_threads;
 #endif
+  int row_mt;
   int postproc_cfg_set;
   vp8_postproc_cfg_t postproc_cfg;
   vpx_decrypt_cb decrypt_cb;
@@ -378,6 +379,9 @@ static vpx_codec_err_t vp8_decode(vpx_codec_alg_priv_t *ctx,
   if (ctx->decoder_init) {
     ctx->yv12_frame_buffers.pbi[0]->decrypt_cb = ctx->decrypt_cb;
     ctx->yv12_frame_buffers.pbi[0]->decrypt_state = ctx->decrypt_state;
+#if CONFIG_MULTITHREAD
+    ctx->yv12_frame_buffers.pbi[0]->row_mt = ctx->row_mt;
+#endif
   }
 
   if (!res) {
@@ -708,6 +712,13 @@ static vpx_codec_err_t vp8_set_decryptor(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t vp8_set_row_mt(vpx_codec_alg_priv_t *ctx,
+                                      va_list args) {
+  ctx->row_mt = va_arg(args, int);
+
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t vp8_ctf_maps[] = {
   { VP8_SET_REFERENCE, vp8_set_reference },
   { VP8_COPY_REFERENCE, vp8_get_reference },
@@ -717,6 +728,7 @@ static vpx_codec_ctrl_fn_map_t vp8_ctf_maps[] = {
   { VP8D_GET_LAST_REF_USED, vp8_get_last_ref_frame },
   { VPXD_GET_LAST_QUANTIZER, vp8_get_quantizer },
   { VPXD_SET_DECRYPTOR, vp8_set_decryptor },
+  { VP8D_SET_ROW_MT, vp8_set_row_mt },
   { -1, NULL },
 };
 
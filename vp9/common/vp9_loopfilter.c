@@ -1610,6 +1610,7 @@ void vp9_loop_filter_data_reset(
     struct VP9Common *cm, const struct macroblockd_plane planes[MAX_MB_PLANE]) {
   lf_data->frame_buffer = frame_buffer;
   lf_data->cm = cm;
+  lf_data->lfm = cm->lf.lfm;
   lf_data->start = 0;
   lf_data->stop = 0;
   lf_data->y_only = 0;
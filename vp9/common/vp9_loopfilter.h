@@ -141,6 +141,7 @@ typedef struct LoopFilterWorkerData {
   YV12_BUFFER_CONFIG *frame_buffer;
   struct VP9Common *cm;
   struct macroblockd_plane planes[MAX_MB_PLANE];
+  LOOP_FILTER_MASK *lfm;
 
   int start;
   int stop;
@@ -13,6 +13,8 @@
 
 #include "./vpx_config.h"
 #include "vpx/internal/vpx_codec_internal.h"
+#include "vpx_util/vpx_atomics.h"
+#include "vpx_util/vpx_pthread.h"
 #include "./vp9_rtcd.h"
 #include "vp9/common/vp9_alloccommon.h"
 #include "vp9/common/vp9_loopfilter.h"
@@ -80,6 +82,11 @@ typedef struct {
                            // frame.
   vpx_codec_frame_buffer_t raw_frame_buffer;
   YV12_BUFFER_CONFIG buf;
+
+  // Frame parallel decode only: number of luma rows, counted from the top of
+  // the frame, whose pixels are final in all planes. INT_MAX once the whole
+  // frame has been decoded.
+  vpx_atomic_int row;
 } RefCntBuffer;
 
 typedef struct BufferPool {
@@ -93,6 +100,15 @@ typedef struct BufferPool {
 
   // Frame buffers allocated internally by the codec.
   InternalFrameBufferList int_frame_buffers;
+
+#if CONFIG_MULTITHREAD
+  // Protects the reference counts and the frame buffer callbacks when frames
+  // are decoded in parallel.
+  pthread_mutex_t pool_mutex;
+  // Signals decoding progress of the frame buffers, see RefCntBuffer::row.
+  pthread_mutex_t progress_mutex;
+  pthread_cond_t progress_cond;
+#endif
 } BufferPool;
 
 typedef struct VP9Common {
@@ -328,6 +344,22 @@ static INLINE YV12_BUFFER_CONFIG *get_frame_new_buffer(VP9_COMMON *cm) {
   return &cm->buffer_pool->frame_bufs[cm->new_fb_idx].buf;
 }
 
+static INLINE void lock_buffer_pool(BufferPool *const pool) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->pool_mutex);
+#else
+  (void)pool;
+#endif
+}
+
+static INLINE void unlock_buffer_pool(BufferPool *const pool) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&pool->pool_mutex);
+#else
+  (void)pool;
+#endif
+}
+
 static INLINE int get_free_fb(VP9_COMMON *cm) {
   RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
   int i;
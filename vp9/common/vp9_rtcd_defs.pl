@@ -72,9 +72,9 @@ add_proto qw/void vp9_iht16x16_256_add/, "const tran_low_t *input, uint8_t *dest
 if (vpx_config("CONFIG_EMULATE_HARDWARE") ne "yes") {
   # Note that there are more specializations appended when
   # CONFIG_VP9_HIGHBITDEPTH is off.
-  specialize qw/vp9_iht4x4_16_add neon sse2 vsx/;
-  specialize qw/vp9_iht8x8_64_add neon sse2 vsx/;
-  specialize qw/vp9_iht16x16_256_add neon sse2 vsx/;
+  specialize qw/vp9_iht4x4_16_add neon sse2 avx2 vsx/;
+  specialize qw/vp9_iht8x8_64_add neon sse2 avx2 vsx/;
+  specialize qw/vp9_iht16x16_256_add neon sse2 avx2 vsx/;
   if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") ne "yes") {
     # Note that these specializations are appended to the above ones.
     specialize qw/vp9_iht4x4_16_add dspr2 msa/;
@@ -176,7 +176,7 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") ne "yes") {
 # Motion search
 #
 add_proto qw/int vp9_diamond_search_sad/, "const struct macroblock *x, const struct search_site_config *cfg,  struct mv *ref_mv, uint32_t start_mv_sad, struct mv *best_mv, int search_param, int sad_per_bit, int *num00, const struct vp9_sad_table *sad_fn_ptr, const struct mv *center_mv";
-specialize qw/vp9_diamond_search_sad neon/;
+specialize qw/vp9_diamond_search_sad neon sse4_1 avx2/;
 
 #
 # Apply temporal filter
@@ -234,13 +234,13 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
 
   # fdct functions
   add_proto qw/void vp9_highbd_fht4x4/, "const int16_t *input, tran_low_t *output, int stride, int tx_type";
-  specialize qw/vp9_highbd_fht4x4 neon/;
+  specialize qw/vp9_highbd_fht4x4 neon sse4_1/;
 
   add_proto qw/void vp9_highbd_fht8x8/, "const int16_t *input, tran_low_t *output, int stride, int tx_type";
-  specialize qw/vp9_highbd_fht8x8 neon/;
+  specialize qw/vp9_highbd_fht8x8 neon sse4_1 avx2/;
 
   add_proto qw/void vp9_highbd_fht16x16/, "const int16_t *input, tran_low_t *output, int stride, int tx_type";
-  specialize qw/vp9_highbd_fht16x16 neon/;
+  specialize qw/vp9_highbd_fht16x16 neon sse4_1 avx2/;
 
   add_proto qw/void vp9_highbd_fwht4x4/, "const int16_t *input, tran_low_t *output, int stride";
 
@@ -255,6 +255,20 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
 add_proto qw/void vp9_scale_and_extend_frame/, "const struct yv12_buffer_config *src, struct yv12_buffer_config *dst, INTERP_FILTER filter_type, int phase_scaler";
 specialize qw/vp9_scale_and_extend_frame neon ssse3/;
 
+add_proto qw/void vp9_scale_filter_horiz/, "const uint8_t *src, int src_stride, const int *x_offsets, const int16_t *const *x_filters, uint8_t *dst, int dst_stride, int w, int h";
+specialize qw/vp9_scale_filter_horiz ssse3 avx2/;
+
+#
+# arbitrary ratio resize
+#
+add_proto qw/void vp9_resize_filter_rows/, "const uint8_t *const *src, const int16_t *filter, uint8_t *dst, int w";
+specialize qw/vp9_resize_filter_rows sse2 avx2/;
+
+if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
+  add_proto qw/void vp9_highbd_resize_filter_rows/, "const uint16_t *const *src, const int16_t *filter, uint16_t *dst, int w, int bd";
+  specialize qw/vp9_highbd_resize_filter_rows sse2 avx2/;
+}
+
 }
 # end encoder functions
 1;
@@ -90,6 +90,7 @@ static INLINE void sync_write(VP9LfSync *const lf_sync, int r, int c,
 // Implement row loopfiltering for each thread.
 static INLINE void thread_loop_filter_rows(
     const YV12_BUFFER_CONFIG *const frame_buffer, VP9_COMMON *const cm,
+    LOOP_FILTER_MASK *const lfm_base,
     struct macroblockd_plane planes[MAX_MB_PLANE], int start, int stop,
     int y_only, VP9LfSync *const lf_sync) {
   const int num_planes = y_only ? 1 : MAX_MB_PLANE;
@@ -111,7 +112,8 @@ static INLINE void thread_loop_filter_rows(
   for (mi_row = start; mi_row < stop;
        mi_row += num_active_workers * MI_BLOCK_SIZE) {
     MODE_INFO **const mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
-    LOOP_FILTER_MASK *lfm = get_lfm(&cm->lf, mi_row, 0);
+    LOOP_FILTER_MASK *lfm =
+        lfm_base + (mi_row >> MI_BLOCK_SIZE_LOG2) * cm->lf.lfm_stride;
 
     for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE, ++lfm) {
       const int r = mi_row >> MI_BLOCK_SIZE_LOG2;
@@ -149,17 +151,20 @@ static INLINE void thread_loop_filter_rows(
 static int loop_filter_row_worker(void *arg1, void *arg2) {
   VP9LfSync *const lf_sync = (VP9LfSync *)arg1;
   LFWorkerData *const lf_data = (LFWorkerData *)arg2;
-  thread_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->planes,
-                          lf_data->start, lf_data->stop, lf_data->y_only,
-                          lf_sync);
+  thread_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->lfm,
+                          lf_data->planes, lf_data->start, lf_data->stop,
+                          lf_data->y_only, lf_sync);
   return 1;
 }
 
-static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
-                                struct macroblockd_plane planes[MAX_MB_PLANE],
-                                int start, int stop, int y_only,
-                                VPxWorker *workers, int nworkers,
-                                VP9LfSync *lf_sync) {
+// Sets up and starts the row loopfilter of 'frame' on 'workers'. The last
+// worker is run on the calling thread when 'execute_last' is set, otherwise all
+// of them are launched. Returns the number of workers that need to be synced.
+static int launch_loop_filter_rows(
+    YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm, LOOP_FILTER_MASK *lfm,
+    struct macroblockd_plane planes[MAX_MB_PLANE], int start, int stop,
+    int y_only, VPxWorker *workers, int nworkers, VP9LfSync *lf_sync,
+    int execute_last) {
   const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
   // Number of superblock rows and cols
   const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
@@ -199,17 +204,31 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
 
     // Loopfilter data
     vp9_loop_filter_data_reset(lf_data, frame, cm, planes);
+    lf_data->lfm = lfm;
     lf_data->start = start + i * MI_BLOCK_SIZE;
     lf_data->stop = stop;
     lf_data->y_only = y_only;
 
     // Start loopfiltering
-    if (i == num_workers - 1) {
+    if (execute_last && i == num_workers - 1) {
       winterface->execute(worker);
     } else {
       winterface->launch(worker);
     }
   }
+  return num_workers;
+}
+
+static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
+                                struct macroblockd_plane planes[MAX_MB_PLANE],
+                                int start, int stop, int y_only,
+                                VPxWorker *workers, int nworkers,
+                                VP9LfSync *lf_sync) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int num_workers =
+      launch_loop_filter_rows(frame, cm, cm->lf.lfm, planes, start, stop,
+                              y_only, workers, nworkers, lf_sync, 1);
+  int i;
 
   // Wait till all rows are finished
   for (i = 0; i < num_workers; ++i) {
@@ -217,29 +236,69 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
   }
 }
 
+static void get_filter_rows(const VP9_COMMON *cm, int partial_frame,
+                            int *start_mi_row, int *end_mi_row) {
+  int mi_rows_to_filter = cm->mi_rows;
+  *start_mi_row = 0;
+  if (partial_frame && cm->mi_rows > 8) {
+    *start_mi_row = cm->mi_rows >> 1;
+    *start_mi_row &= 0xfffffff8;
+    mi_rows_to_filter = VPXMAX(cm->mi_rows / 8, 8);
+  }
+  *end_mi_row = *start_mi_row + mi_rows_to_filter;
+}
+
 void vp9_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
                               struct macroblockd_plane planes[MAX_MB_PLANE],
                               int frame_filter_level, int y_only,
                               int partial_frame, VPxWorker *workers,
                               int num_workers, VP9LfSync *lf_sync) {
-  int start_mi_row, end_mi_row, mi_rows_to_filter;
+  int start_mi_row, end_mi_row;
 
   if (!frame_filter_level) return;
 
-  start_mi_row = 0;
-  mi_rows_to_filter = cm->mi_rows;
-  if (partial_frame && cm->mi_rows > 8) {
-    start_mi_row = cm->mi_rows >> 1;
-    start_mi_row &= 0xfffffff8;
-    mi_rows_to_filter = VPXMAX(cm->mi_rows / 8, 8);
-  }
-  end_mi_row = start_mi_row + mi_rows_to_filter;
+  get_filter_rows(cm, partial_frame, &start_mi_row, &end_mi_row);
   vp9_loop_filter_frame_init(cm, frame_filter_level);
 
   loop_filter_rows_mt(frame, cm, planes, start_mi_row, end_mi_row, y_only,
                       workers, num_workers, lf_sync);
 }
 
+void vp9_loop_filter_frames_mt(YV12_BUFFER_CONFIG *const *frames,
+                               LOOP_FILTER_MASK *const *lfms,
+                               VP9LfSync *const *lf_syncs, int num_frames,
+                               VP9_COMMON *cm,
+                               struct macroblockd_plane planes[MAX_MB_PLANE],
+                               int y_only, int partial_frame,
+                               VPxWorker *workers, int num_workers) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  int num_launched[MAX_LPF_FRAMES];
+  int start_mi_row, end_mi_row;
+  int f, i;
+
+  assert(num_frames > 0 && num_frames <= MAX_LPF_FRAMES);
+  assert(num_frames <= num_workers);
+
+  get_filter_rows(cm, partial_frame, &start_mi_row, &end_mi_row);
+
+  // Give each frame an equal share of the workers. All of them are started
+  // before any is waited on so the frames are filtered concurrently.
+  for (f = 0; f < num_frames; ++f) {
+    const int first = f * num_workers / num_frames;
+    const int count = (f + 1) * num_workers / num_frames - first;
+    num_launched[f] = launch_loop_filter_rows(
+        frames[f], cm, lfms[f], planes, start_mi_row, end_mi_row, y_only,
+        workers + first, count, lf_syncs[f], f == num_frames - 1);
+  }
+
+  for (f = 0; f < num_frames; ++f) {
+    const int first = f * num_workers / num_frames;
+    for (i = 0; i < num_launched[f]; ++i) {
+      winterface->sync(&workers[first + i]);
+    }
+  }
+}
+
 void vp9_lpf_mt_init(VP9LfSync *lf_sync, VP9_COMMON *cm, int frame_filter_level,
                      int num_workers) {
   const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
@@ -445,9 +504,9 @@ void vp9_loopfilter_rows(LFWorkerData *lf_data, VP9LfSync *lf_sync) {
     lf_data->start = mi_row;
     lf_data->stop = mi_row + MI_BLOCK_SIZE;
 
-    thread_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->planes,
-                            lf_data->start, lf_data->stop, lf_data->y_only,
-                            lf_sync);
+    thread_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->lfm,
+                            lf_data->planes, lf_data->start, lf_data->stop,
+                            lf_data->y_only, lf_sync);
   }
 }
 
@@ -480,9 +539,9 @@ void vp9_set_row(VP9LfSync *lf_sync, int num_tiles, int row, int is_last_row,
 }
 
 void vp9_loopfilter_job(LFWorkerData *lf_data, VP9LfSync *lf_sync) {
-  thread_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->planes,
-                          lf_data->start, lf_data->stop, lf_data->y_only,
-                          lf_sync);
+  thread_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->lfm,
+                          lf_data->planes, lf_data->start, lf_data->stop,
+                          lf_data->y_only, lf_sync);
 }
 
 // Accumulate frame counts.
@@ -63,6 +63,22 @@ void vp9_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, struct VP9Common *cm,
                               int partial_frame, VPxWorker *workers,
                               int num_workers, VP9LfSync *lf_sync);
 
+// Maximum number of frames vp9_loop_filter_frames_mt() can filter at once.
+#define MAX_LPF_FRAMES 2
+
+// Multi-threaded loopfilter of several frames at once, splitting the workers
+// evenly between them. Each frame is filtered with its own masks, built
+// beforehand with vp9_build_mask_frame(), and its own row synchronization, so
+// the frames may be filtered at different levels. cm->lf_info must already be
+// initialized. 'num_frames' must not exceed 'num_workers'.
+void vp9_loop_filter_frames_mt(YV12_BUFFER_CONFIG *const *frames,
+                               LOOP_FILTER_MASK *const *lfms,
+                               VP9LfSync *const *lf_syncs, int num_frames,
+                               struct VP9Common *cm,
+                               struct macroblockd_plane planes[MAX_MB_PLANE],
+                               int y_only, int partial_frame,
+                               VPxWorker *workers, int num_workers);
+
 // Multi-threaded loopfilter initialisations
 void vp9_lpf_mt_init(VP9LfSync *lf_sync, struct VP9Common *cm,
                      int frame_filter_level, int num_workers);
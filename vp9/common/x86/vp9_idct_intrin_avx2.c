@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+
+#include "./vp9_rtcd.h"
+#include "vpx_dsp/x86/inv_txfm_avx2.h"
+
+void vp9_iht4x4_16_add_avx2(const tran_low_t *input, uint8_t *dest, int stride,
+                            int tx_type) {
+  __m256i in = load_input_data4x4(input);
+
+  switch (tx_type) {
+    case DCT_DCT:
+      idct4_avx2(&in);
+      idct4_avx2(&in);
+      break;
+    case ADST_DCT:
+      idct4_avx2(&in);
+      iadst4_avx2(&in);
+      break;
+    case DCT_ADST:
+      iadst4_avx2(&in);
+      idct4_avx2(&in);
+      break;
+    default:
+      assert(tx_type == ADST_ADST);
+      iadst4_avx2(&in);
+      iadst4_avx2(&in);
+      break;
+  }
+
+  // Final round and shift
+  in = _mm256_add_epi16(in, _mm256_set1_epi16(8));
+  in = _mm256_srai_epi16(in, 4);
+
+  recon_and_store4x4_avx2(in, dest, stride);
+}
+
+void vp9_iht8x8_64_add_avx2(const tran_low_t *input, uint8_t *dest, int stride,
+                            int tx_type) {
+  __m256i in[4];
+
+  load_buffer_8x8_avx2(input, in);
+
+  switch (tx_type) {
+    case DCT_DCT:
+      idct8_avx2(in);
+      idct8_avx2(in);
+      break;
+    case ADST_DCT:
+      idct8_avx2(in);
+      iadst8_avx2(in);
+      break;
+    case DCT_ADST:
+      iadst8_avx2(in);
+      idct8_avx2(in);
+      break;
+    default:
+      assert(tx_type == ADST_ADST);
+      iadst8_avx2(in);
+      iadst8_avx2(in);
+      break;
+  }
+
+  write_buffer_8x8_avx2(in, dest, stride);
+}
+
+void vp9_iht16x16_256_add_avx2(const tran_low_t *input, uint8_t *dest,
+                               int stride, int tx_type) {
+  __m256i in[16];
+  int i;
+
+  idct_load16x16(input, in, 16);
+
+  switch (tx_type) {
+    case DCT_DCT:
+      idct16_avx2(in);
+      idct16_avx2(in);
+      break;
+    case ADST_DCT:
+      idct16_avx2(in);
+      iadst16_avx2(in);
+      break;
+    case DCT_ADST:
+      iadst16_avx2(in);
+      idct16_avx2(in);
+      break;
+    default:
+      assert(tx_type == ADST_ADST);
+      iadst16_avx2(in);
+      iadst16_avx2(in);
+      break;
+  }
+
+  for (i = 0; i < 16; ++i) {
+    write_buffer_16x1(dest + i * stride, in[i]);
+  }
+}
@@ -46,6 +46,7 @@
 #include "vp9/decoder/vp9_decodemv.h"
 #include "vp9/decoder/vp9_decoder.h"
 #include "vp9/decoder/vp9_dsubexp.h"
+#include "vp9/decoder/vp9_dthread.h"
 #include "vp9/decoder/vp9_job_queue.h"
 
 #define MAX_VP9_HEADER_SIZE 80
@@ -580,7 +581,7 @@ static void dec_build_inter_predictors(
     int y, int w, int h, int mi_x, int mi_y, const InterpKernel *kernel,
     const struct scale_factors *sf, struct buf_2d *pre_buf,
     struct buf_2d *dst_buf, const MV *mv, RefCntBuffer *ref_frame_buf,
-    int is_scaled, int ref) {
+    int is_scaled, int ref, VP9Decoder *const pbi) {
   struct macroblockd_plane *const pd = &xd->plane[plane];
   uint8_t *const dst = dst_buf->buf + dst_buf->stride * y + x;
   MV32 scaled_mv;
@@ -657,6 +658,20 @@ static void dec_build_inter_predictors(
   buf_ptr = ref_frame + y0 * pre_buf->stride + x0;
   buf_stride = pre_buf->stride;
 
+  // In frame parallel decode wait until the rows read by the interpolation
+  // filter have been decoded in the reference frame.
+  if (pbi->frame_parallel_decode) {
+    const int y_pad =
+        (subpel_y || sf->y_step_q4 != SUBPEL_SHIFTS) ? VP9_INTERP_EXTEND : 0;
+    const int y1 = ((y0_16 + (h - 1) * ys) >> SUBPEL_BITS) + y_pad;
+    if (vp9_frameworker_wait(pbi->common.buffer_pool, ref_frame_buf,
+                             (VPXMAX(VPXMIN(y1, frame_height - 1), 0) + 1)
+                                 << pd->subsampling_y)) {
+      vpx_internal_error(xd->error_info, VPX_CODEC_CORRUPT_FRAME,
+                         "Reference frame failed to decode");
+    }
+  }
+
   // Do border extension if there is motion or the
   // width/height is not a multiple of 8 pixels.
   if (is_scaled || scaled_mv.col || scaled_mv.row || (frame_width & 0x7) ||
@@ -666,6 +681,9 @@ static void dec_build_inter_predictors(
     // Get reference block bottom right horizontal coordinate.
     int x1 = ((x0_16 + (w - 1) * xs) >> SUBPEL_BITS) + 1;
     int x_pad = 0, y_pad = 0;
+    // Without a border the filters may read past the end of the last row of
+    // the plane, the blocks reading it are extended too.
+    const int y_max = frame_height - 1 - pbi->lazy_border;
 
     if (subpel_x || (sf->x_step_q4 != SUBPEL_SHIFTS)) {
       x0 -= VP9_INTERP_EXTEND - 1;
@@ -681,7 +699,7 @@ static void dec_build_inter_predictors(
 
     // Skip border extension if block is inside the frame.
     if (x0 < 0 || x0 > frame_width - 1 || x1 < 0 || x1 > frame_width - 1 ||
-        y0 < 0 || y0 > frame_height - 1 || y1 < 0 || y1 > frame_height - 1) {
+        y0 < 0 || y0 > y_max || y1 < 0 || y1 > y_max) {
       // Extend the border.
       const uint8_t *const buf_ptr1 = ref_frame + y0 * buf_stride + x0;
       const int b_w = x1 - x0 + 1;
@@ -760,7 +778,7 @@ static void dec_build_inter_predictors_sb(TileWorkerData *twd,
             dec_build_inter_predictors(twd, xd, plane, n4w_x4, n4h_x4, 4 * x,
                                        4 * y, 4, 4, mi_x, mi_y, kernel, sf,
                                        pre_buf, dst_buf, &mv, ref_frame_buf,
-                                       is_scaled, ref);
+                                       is_scaled, ref, pbi);
           }
         }
       }
@@ -776,7 +794,8 @@ static void dec_build_inter_predictors_sb(TileWorkerData *twd,
         struct buf_2d *const pre_buf = &pd->pre[ref];
         dec_build_inter_predictors(twd, xd, plane, n4w_x4, n4h_x4, 0, 0, n4w_x4,
                                    n4h_x4, mi_x, mi_y, kernel, sf, pre_buf,
-                                   dst_buf, &mv, ref_frame_buf, is_scaled, ref);
+                                   dst_buf, &mv, ref_frame_buf, is_scaled, ref,
+                                   pbi);
       }
     }
   }
@@ -1514,25 +1533,29 @@ static void resize_context_buffers(VP9_COMMON *cm, int width, int height) {
   }
 }
 
-static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
+static void setup_frame_size(VP9Decoder *pbi, struct vpx_read_bit_buffer *rb) {
+  VP9_COMMON *const cm = &pbi->common;
   int width, height;
   BufferPool *const pool = cm->buffer_pool;
   vp9_read_frame_size(rb, &width, &height);
   resize_context_buffers(cm, width, height);
   setup_render_size(cm, rb);
 
+  lock_buffer_pool(pool);
   if (vpx_realloc_frame_buffer(
           get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
           cm->subsampling_y,
 #if CONFIG_VP9_HIGHBITDEPTH
           cm->use_highbitdepth,
 #endif
-          VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
+          pbi->lazy_border ? 0 : VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
           &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer, pool->get_fb_cb,
           pool->cb_priv)) {
+    unlock_buffer_pool(pool);
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate frame buffer");
   }
+  unlock_buffer_pool(pool);
 
   pool->frame_bufs[cm->new_fb_idx].released = 0;
   pool->frame_bufs[cm->new_fb_idx].buf.subsampling_x = cm->subsampling_x;
@@ -1552,8 +1575,9 @@ static INLINE int valid_ref_frame_img_fmt(vpx_bit_depth_t ref_bit_depth,
          ref_yss == this_yss;
 }
 
-static void setup_frame_size_with_refs(VP9_COMMON *cm,
+static void setup_frame_size_with_refs(VP9Decoder *pbi,
                                        struct vpx_read_bit_buffer *rb) {
+  VP9_COMMON *const cm = &pbi->common;
   int width, height;
   int found = 0, i;
   int has_valid_ref_frame = 0;
@@ -1605,18 +1629,21 @@ static void setup_frame_size_with_refs(VP9_COMMON *cm,
   resize_context_buffers(cm, width, height);
   setup_render_size(cm, rb);
 
+  lock_buffer_pool(pool);
   if (vpx_realloc_frame_buffer(
           get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
           cm->subsampling_y,
 #if CONFIG_VP9_HIGHBITDEPTH
           cm->use_highbitdepth,
 #endif
-          VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
+          pbi->lazy_border ? 0 : VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
           &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer, pool->get_fb_cb,
           pool->cb_priv)) {
+    unlock_buffer_pool(pool);
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate frame buffer");
   }
+  unlock_buffer_pool(pool);
 
   pool->frame_bufs[cm->new_fb_idx].released = 0;
   pool->frame_bufs[cm->new_fb_idx].buf.subsampling_x = cm->subsampling_x;
@@ -1893,6 +1920,22 @@ static void parse_tile_row(TileWorkerData *tile_data, VP9Decoder *pbi,
   }
 }
 
+// Frame parallel decode: publishes the number of luma rows of the current
+// frame that are final in all planes.
+static INLINE void broadcast_progress(VP9Decoder *const pbi, int row) {
+  if (pbi->frame_parallel_decode && row > 0) {
+    vp9_frameworker_broadcast(pbi->common.buffer_pool, pbi->common.cur_frame,
+                              row);
+  }
+}
+
+// Returns the luma rows that are final in all planes once the loop filter has
+// run up to mi row |stop|. Filtering the next rows still changes up to 7 rows
+// above them in every plane, which are 14 luma rows for subsampled chroma.
+static INLINE int loop_filtered_rows(const VP9_COMMON *const cm, int stop) {
+  return (stop << MI_SIZE_LOG2) - (8 << cm->subsampling_y);
+}
+
 static int row_decode_worker_hook(void *arg1, void *arg2) {
   ThreadData *const thread_data = (ThreadData *)arg1;
   uint8_t **data_end = (uint8_t **)arg2;
@@ -1920,6 +1963,8 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
       if (cm->lf.filter_level && !cm->skip_loop_filter &&
           mi_row < cm->mi_rows) {
         vp9_loopfilter_job(lf_data, lf_sync);
+        // The loop filter jobs complete in row order.
+        broadcast_progress(pbi, loop_filtered_rows(cm, lf_data->stop));
       }
     } else if (job.job_type == RECON_JOB) {
       const int cur_sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
@@ -2133,13 +2178,17 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
         if (mi_row + MI_BLOCK_SIZE >= cm->mi_rows) continue;
 
         winterface->sync(&pbi->lf_worker);
+        broadcast_progress(pbi, loop_filtered_rows(cm, lf_data->stop));
         lf_data->start = lf_start;
         lf_data->stop = mi_row;
         if (pbi->max_threads > 1) {
           winterface->launch(&pbi->lf_worker);
         } else {
           winterface->execute(&pbi->lf_worker);
+          broadcast_progress(pbi, loop_filtered_rows(cm, lf_data->stop));
         }
+      } else {
+        broadcast_progress(pbi, (mi_row + MI_BLOCK_SIZE) << MI_SIZE_LOG2);
       }
     }
   }
@@ -2626,6 +2675,7 @@ static INLINE void flush_all_fb_on_key(VP9_COMMON *cm) {
     RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
     BufferPool *const pool = cm->buffer_pool;
     int i;
+    lock_buffer_pool(pool);
     for (i = 0; i < FRAME_BUFFERS; ++i) {
       if (i == cm->new_fb_idx) continue;
       frame_bufs[i].ref_count = 0;
@@ -2634,6 +2684,7 @@ static INLINE void flush_all_fb_on_key(VP9_COMMON *cm) {
         frame_bufs[i].released = 1;
       }
     }
+    unlock_buffer_pool(pool);
   }
 }
 
@@ -2667,13 +2718,16 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
   if (cm->show_existing_frame) {
     // Show an existing frame directly.
     const int frame_to_show = cm->ref_frame_map[vpx_rb_read_literal(rb, 3)];
+    lock_buffer_pool(pool);
     if (frame_to_show < 0 || frame_bufs[frame_to_show].ref_count < 1) {
+      unlock_buffer_pool(pool);
       vpx_internal_error(&cm->error, VPX_CODEC_UNSUP_BITSTREAM,
                          "Buffer %d does not contain a decoded frame",
                          frame_to_show);
     }
 
     ref_cnt_fb(frame_bufs, &cm->new_fb_idx, frame_to_show);
+    unlock_buffer_pool(pool);
     pbi->refresh_frame_flags = 0;
     cm->lf.filter_level = 0;
     cm->show_frame = 1;
@@ -2698,10 +2752,12 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
       cm->frame_refs[i].buf = NULL;
     }
 
-    setup_frame_size(cm, rb);
+    setup_frame_size(pbi, rb);
     if (pbi->need_resync) {
       memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
-      flush_all_fb_on_key(cm);
+      // In frame parallel mode the frame buffers are still referenced by the
+      // frames in flight, the interface rebuilds the reference counts instead.
+      if (!pbi->frame_parallel_decode) flush_all_fb_on_key(cm);
       pbi->need_resync = 0;
     }
   } else {
@@ -2731,7 +2787,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
       }
 
       pbi->refresh_frame_flags = vpx_rb_read_literal(rb, REF_FRAMES);
-      setup_frame_size(cm, rb);
+      setup_frame_size(pbi, rb);
       if (pbi->need_resync) {
         memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
         pbi->need_resync = 0;
@@ -2747,7 +2803,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
         cm->ref_frame_sign_bias[LAST_FRAME + i] = vpx_rb_read_bit(rb);
       }
 
-      setup_frame_size_with_refs(cm, rb);
+      setup_frame_size_with_refs(pbi, rb);
 
       cm->allow_high_precision_mv = vpx_rb_read_bit(rb);
       cm->interp_filter = read_interp_filter(rb);
@@ -2795,6 +2851,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
   cm->frame_context_idx = vpx_rb_read_literal(rb, FRAME_CONTEXTS_LOG2);
 
   // Generate next_ref_frame_map.
+  lock_buffer_pool(pool);
   for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
     if (mask & 1) {
       cm->next_ref_frame_map[ref_index] = cm->new_fb_idx;
@@ -2814,6 +2871,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
     if (cm->ref_frame_map[ref_index] >= 0)
       ++frame_bufs[cm->ref_frame_map[ref_index]].ref_count;
   }
+  unlock_buffer_pool(pool);
   pbi->hold_ref_buf = 1;
 
   if (frame_is_intra_only(cm) || cm->error_resilient_mode)
@@ -2990,6 +3048,14 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
 
   vp9_setup_block_planes(xd, cm->subsampling_x, cm->subsampling_y);
 
+  // In frame parallel decode the next frame may start once the state it
+  // depends on is final. The segmentation map is only known at the end of
+  // the frame.
+  if (pbi->frame_parallel_decode && !cm->seg.enabled &&
+      !cm->refresh_frame_context) {
+    vp9_frameworker_signal_context_ready(pbi->frame_worker_owner);
+  }
+
   *cm->fc = cm->frame_contexts[cm->frame_context_idx];
   if (!cm->fc->initialized)
     vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
@@ -3001,6 +3067,15 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
     vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
                        "Decode failed. Frame data header is corrupted.");
 
+  // Without backward adaptation the frame context is final after the
+  // compressed header.
+  if (pbi->frame_parallel_decode && !cm->seg.enabled &&
+      cm->refresh_frame_context && cm->frame_parallel_decoding_mode) {
+    cm->frame_contexts[cm->frame_context_idx] = *cm->fc;
+    context_updated = 1;
+    vp9_frameworker_signal_context_ready(pbi->frame_worker_owner);
+  }
+
   if (cm->lf.filter_level && !cm->skip_loop_filter) {
     vp9_loop_filter_frame_init(cm, cm->lf.filter_level);
   }
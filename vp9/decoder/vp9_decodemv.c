@@ -21,6 +21,7 @@
 
 #include "vp9/decoder/vp9_decodemv.h"
 #include "vp9/decoder/vp9_decodeframe.h"
+#include "vp9/decoder/vp9_dthread.h"
 
 #include "vpx_dsp/vpx_dsp_common.h"
 
@@ -827,6 +828,15 @@ void vp9_read_mode_info(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
     MV_REFERENCE_FRAME mi_ref_frame[2];
     int_mv mi_mv[2];
 
+    // In frame parallel decode wait until the co-located motion vectors of
+    // the previous frame have been decoded.
+    if (pbi->frame_parallel_decode && cm->use_prev_frame_mvs &&
+        vp9_frameworker_wait(cm->buffer_pool, cm->prev_frame,
+                             (mi_row + 1) << MI_SIZE_LOG2)) {
+      vpx_internal_error(xd->error_info, VPX_CODEC_CORRUPT_FRAME,
+                         "Previous frame failed to decode");
+    }
+
     read_inter_frame_mode_info(pbi, xd, mi_row, mi_col, r, x_mis, y_mis);
 
     copy_ref_frame_pair(mi_ref_frame, mi->ref_frame);
@@ -36,6 +36,7 @@
 #include "vp9/decoder/vp9_decodeframe.h"
 #include "vp9/decoder/vp9_decoder.h"
 #include "vp9/decoder/vp9_detokenize.h"
+#include "vp9/decoder/vp9_dthread.h"
 
 static void initialize_dec(void) {
   static volatile int init_done = 0;
@@ -340,6 +341,7 @@ static void swap_frame_buffers(VP9Decoder *pbi) {
   BufferPool *const pool = cm->buffer_pool;
   RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
 
+  lock_buffer_pool(pool);
   for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
     const int old_idx = cm->ref_frame_map[ref_index];
     // Current thread releases the holding of reference frame.
@@ -362,7 +364,10 @@ static void swap_frame_buffers(VP9Decoder *pbi) {
   pbi->hold_ref_buf = 0;
   cm->frame_to_show = get_frame_new_buffer(cm);
 
-  --frame_bufs[cm->new_fb_idx].ref_count;
+  // In frame parallel mode the frame worker keeps its hold on the new frame
+  // buffer until the frame has been output.
+  if (!pbi->frame_parallel_decode) --frame_bufs[cm->new_fb_idx].ref_count;
+  unlock_buffer_pool(pool);
 
   // Invalidate these references until the next frame starts.
   for (ref_index = 0; ref_index < 3; ref_index++)
@@ -384,6 +389,7 @@ static void release_fb_on_decoder_exit(VP9Decoder *pbi) {
   }
 
   // Release all the reference buffers if worker thread is holding them.
+  lock_buffer_pool(pool);
   if (pbi->hold_ref_buf == 1) {
     int ref_index = 0, mask;
     for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
@@ -405,6 +411,7 @@ static void release_fb_on_decoder_exit(VP9Decoder *pbi) {
     }
     pbi->hold_ref_buf = 0;
   }
+  unlock_buffer_pool(pool);
 }
 
 int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
@@ -433,23 +440,29 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
 
   pbi->ready_for_new_data = 0;
 
-  // Check if the previous frame was a frame without any references to it.
-  if (cm->new_fb_idx >= 0 && frame_bufs[cm->new_fb_idx].ref_count == 0 &&
-      !frame_bufs[cm->new_fb_idx].released) {
-    pool->release_fb_cb(pool->cb_priv,
-                        &frame_bufs[cm->new_fb_idx].raw_frame_buffer);
-    frame_bufs[cm->new_fb_idx].released = 1;
-  }
+  // In frame parallel mode the frame buffer has been assigned by the caller,
+  // which also releases it once the frame has been output.
+  if (!pbi->frame_parallel_decode) {
+    lock_buffer_pool(pool);
+    // Check if the previous frame was a frame without any references to it.
+    if (cm->new_fb_idx >= 0 && frame_bufs[cm->new_fb_idx].ref_count == 0 &&
+        !frame_bufs[cm->new_fb_idx].released) {
+      pool->release_fb_cb(pool->cb_priv,
+                          &frame_bufs[cm->new_fb_idx].raw_frame_buffer);
+      frame_bufs[cm->new_fb_idx].released = 1;
+    }
 
-  // Find a free frame buffer. Return error if can not find any.
-  cm->new_fb_idx = get_free_fb(cm);
-  if (cm->new_fb_idx == INVALID_IDX) {
-    pbi->ready_for_new_data = 1;
-    release_fb_on_decoder_exit(pbi);
-    vpx_clear_system_state();
-    vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
-                       "Unable to find free frame buffer");
-    return cm->error.error_code;
+    // Find a free frame buffer. Return error if can not find any.
+    cm->new_fb_idx = get_free_fb(cm);
+    unlock_buffer_pool(pool);
+    if (cm->new_fb_idx == INVALID_IDX) {
+      pbi->ready_for_new_data = 1;
+      release_fb_on_decoder_exit(pbi);
+      vpx_clear_system_state();
+      vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                         "Unable to find free frame buffer");
+      return cm->error.error_code;
+    }
   }
 
   // Assign a MV array to the frame buffer.
@@ -462,8 +475,19 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
     cm->error.setjmp = 0;
     pbi->ready_for_new_data = 1;
     release_fb_on_decoder_exit(pbi);
-    // Release current frame.
-    decrease_ref_count(cm->new_fb_idx, frame_bufs, pool);
+    if (pbi->frame_parallel_decode) {
+      // Unblock the frames waiting on this one. They fail on the corrupted
+      // flag, and the decoder has to resync as the following frames depend
+      // on a partially decoded state.
+      pbi->need_resync = 1;
+      cm->cur_frame->buf.corrupted = 1;
+      vp9_frameworker_broadcast(pool, cm->cur_frame, INT_MAX);
+    } else {
+      // Release current frame.
+      lock_buffer_pool(pool);
+      decrease_ref_count(cm->new_fb_idx, frame_bufs, pool);
+      unlock_buffer_pool(pool);
+    }
     vpx_clear_system_state();
     return -1;
   }
@@ -475,14 +499,22 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
 
   vpx_clear_system_state();
 
+  if (cm->show_frame) cm->cur_show_frame_fb_idx = cm->new_fb_idx;
+
+  if (pbi->frame_parallel_decode) {
+    // The state carried over to the next frame is copied by the frame worker
+    // decoding it, see vp9_frameworker_copy_context().
+    vp9_frameworker_broadcast(pool, cm->cur_frame, INT_MAX);
+    cm->error.setjmp = 0;
+    return retcode;
+  }
+
   if (!cm->show_existing_frame) {
     cm->last_show_frame = cm->show_frame;
     cm->prev_frame = cm->cur_frame;
     if (cm->seg.enabled) vp9_swap_current_and_last_seg_map(cm);
   }
 
-  if (cm->show_frame) cm->cur_show_frame_fb_idx = cm->new_fb_idx;
-
   // Update progress in frame parallel decode.
   cm->last_width = cm->width;
   cm->last_height = cm->height;
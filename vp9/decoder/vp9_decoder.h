@@ -125,6 +125,15 @@ typedef struct VP9Decoder {
   int row_mt;
   int lpf_mt_opt;
   RowMTWorkerData *row_mt_worker_data;
+
+  // The frame buffers have no border, pixels outside the reference frames
+  // are always built with build_mc_border().
+  int lazy_border;
+
+  // Frame parallel decode: the frame is decoded by 'frame_worker_owner' while
+  // other frame workers decode the frames around it.
+  int frame_parallel_decode;
+  VPxWorker *frame_worker_owner;
 } VP9Decoder;
 
 int vp9_receive_compressed_data(struct VP9Decoder *pbi, size_t size,
@@ -0,0 +1,242 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include "./vpx_config.h"
+#include "vpx_util/vpx_atomics.h"
+
+#include "vp9/common/vp9_alloccommon.h"
+#include "vp9/common/vp9_onyxc_int.h"
+
+#include "vp9/decoder/vp9_decoder.h"
+#include "vp9/decoder/vp9_dthread.h"
+
+void vp9_frameworker_init(FrameWorkerData *const frame_worker_data) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_init(&frame_worker_data->stats_mutex, NULL);
+  pthread_cond_init(&frame_worker_data->stats_cond, NULL);
+#endif
+  frame_worker_data->prev_fb_idx = INVALID_IDX;
+  frame_worker_data->frame_context_ready = 0;
+  frame_worker_data->frame_decoded = 0;
+}
+
+void vp9_frameworker_deinit(FrameWorkerData *const frame_worker_data) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_destroy(&frame_worker_data->stats_mutex);
+  pthread_cond_destroy(&frame_worker_data->stats_cond);
+#else
+  (void)frame_worker_data;
+#endif
+}
+
+void vp9_frameworker_reset_stats(FrameWorkerData *const frame_worker_data) {
+  // The frame worker is idle here, the lock only orders the accesses with
+  // respect to earlier readers.
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&frame_worker_data->stats_mutex);
+#endif
+  frame_worker_data->frame_context_ready = 0;
+  frame_worker_data->frame_decoded = 0;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&frame_worker_data->stats_mutex);
+#endif
+}
+
+void vp9_frameworker_signal_context_ready(VPxWorker *const worker) {
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&frame_worker_data->stats_mutex);
+  frame_worker_data->frame_context_ready = 1;
+  pthread_cond_broadcast(&frame_worker_data->stats_cond);
+  pthread_mutex_unlock(&frame_worker_data->stats_mutex);
+#else
+  frame_worker_data->frame_context_ready = 1;
+#endif
+}
+
+void vp9_frameworker_signal_decoded(VPxWorker *const worker) {
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&frame_worker_data->stats_mutex);
+  frame_worker_data->frame_context_ready = 1;
+  frame_worker_data->frame_decoded = 1;
+  pthread_cond_broadcast(&frame_worker_data->stats_cond);
+  pthread_mutex_unlock(&frame_worker_data->stats_mutex);
+#else
+  frame_worker_data->frame_context_ready = 1;
+  frame_worker_data->frame_decoded = 1;
+#endif
+}
+
+int vp9_frameworker_is_decoded(VPxWorker *const worker) {
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+  int decoded;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&frame_worker_data->stats_mutex);
+  decoded = frame_worker_data->frame_decoded;
+  pthread_mutex_unlock(&frame_worker_data->stats_mutex);
+#else
+  decoded = frame_worker_data->frame_decoded;
+#endif
+  return decoded;
+}
+
+int vp9_frameworker_wait(BufferPool *const pool, RefCntBuffer *const ref_buf,
+                         int row) {
+#if CONFIG_MULTITHREAD
+  int progress = vpx_atomic_load_acquire(&ref_buf->row);
+
+  if (progress < row) {
+    pthread_mutex_lock(&pool->progress_mutex);
+    while ((progress = vpx_atomic_load_acquire(&ref_buf->row)) < row)
+      pthread_cond_wait(&pool->progress_cond, &pool->progress_mutex);
+    pthread_mutex_unlock(&pool->progress_mutex);
+  }
+  // INT_MAX is only published once the frame is done or has failed, after
+  // its corrupted flag has been set. The rows published before are final.
+  return progress == INT_MAX && ref_buf->buf.corrupted;
+#else
+  (void)pool;
+  (void)ref_buf;
+  (void)row;
+  return 0;
+#endif
+}
+
+void vp9_frameworker_broadcast(BufferPool *const pool, RefCntBuffer *const buf,
+                               int row) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->progress_mutex);
+  if (row > vpx_atomic_load_acquire(&buf->row)) {
+    vpx_atomic_store_release(&buf->row, row);
+    pthread_cond_broadcast(&pool->progress_cond);
+  }
+  pthread_mutex_unlock(&pool->progress_mutex);
+#else
+  (void)pool;
+  vpx_atomic_store_release(&buf->row, row);
+#endif
+}
+
+// Sizes the context buffers of 'cm' for a frame of 'width' x 'height' without
+// clearing the segmentation map, as the frame size does not change from the
+// point of view of the next frame.
+static int resize_context_buffers(VP9_COMMON *const cm, int width,
+                                  int height) {
+  const int new_mi_rows =
+      ALIGN_POWER_OF_TWO(height, MI_SIZE_LOG2) >> MI_SIZE_LOG2;
+  const int new_mi_cols =
+      ALIGN_POWER_OF_TWO(width, MI_SIZE_LOG2) >> MI_SIZE_LOG2;
+
+  if (new_mi_cols > cm->mi_cols || new_mi_rows > cm->mi_rows) {
+    if (vp9_alloc_context_buffers(cm, width, height)) {
+      cm->width = 0;
+      cm->height = 0;
+      return 1;
+    }
+  } else {
+    vp9_set_mb_mi(cm, width, height);
+  }
+  cm->setup_mi(cm);
+  cm->width = width;
+  cm->height = height;
+  return 0;
+}
+
+vpx_codec_err_t vp9_frameworker_copy_context(VPxWorker *const dst_worker,
+                                             VPxWorker *const src_worker) {
+  FrameWorkerData *const src_worker_data =
+      (FrameWorkerData *)src_worker->data1;
+  FrameWorkerData *const dst_worker_data =
+      (FrameWorkerData *)dst_worker->data1;
+  VP9_COMMON *const src_cm = &src_worker_data->pbi->common;
+  VP9_COMMON *const dst_cm = &dst_worker_data->pbi->common;
+  const int show_existing_frame = src_cm->show_existing_frame;
+
+  // Wait until the source frame has parsed the state the next frame needs.
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&src_worker_data->stats_mutex);
+  while (!src_worker_data->frame_context_ready) {
+    pthread_cond_wait(&src_worker_data->stats_cond,
+                      &src_worker_data->stats_mutex);
+  }
+  pthread_mutex_unlock(&src_worker_data->stats_mutex);
+#endif
+
+  if (src_cm->width > 0 &&
+      (dst_cm->width != src_cm->width || dst_cm->height != src_cm->height)) {
+    if (resize_context_buffers(dst_cm, src_cm->width, src_cm->height))
+      return VPX_CODEC_MEM_ERROR;
+  }
+
+  // The state below mirrors what vp9_receive_compressed_data() carries over
+  // from one frame to the next in serial mode.
+  memcpy(dst_cm->ref_frame_map,
+         show_existing_frame ? src_cm->ref_frame_map
+                             : src_cm->next_ref_frame_map,
+         sizeof(dst_cm->ref_frame_map));
+  dst_cm->last_show_frame =
+      show_existing_frame ? src_cm->last_show_frame : src_cm->show_frame;
+  dst_cm->prev_frame =
+      show_existing_frame ? src_cm->prev_frame : src_cm->cur_frame;
+  dst_cm->last_width = src_cm->width;
+  dst_cm->last_height = src_cm->height;
+  dst_cm->current_video_frame =
+      src_cm->current_video_frame + src_cm->show_frame;
+
+  dst_cm->frame_type = src_cm->frame_type;
+  dst_cm->intra_only = src_cm->intra_only;
+  dst_cm->bit_depth = src_cm->bit_depth;
+#if CONFIG_VP9_HIGHBITDEPTH
+  dst_cm->use_highbitdepth = src_cm->use_highbitdepth;
+#endif
+  dst_cm->color_space = src_cm->color_space;
+  dst_cm->color_range = src_cm->color_range;
+  dst_cm->subsampling_x = src_cm->subsampling_x;
+  dst_cm->subsampling_y = src_cm->subsampling_y;
+
+  // The loop filter masks and the cached sharpness belong to the decoder.
+  dst_cm->lf.filter_level = src_cm->lf.filter_level;
+  dst_cm->lf.last_filt_level = src_cm->lf.last_filt_level;
+  dst_cm->lf.sharpness_level = src_cm->lf.sharpness_level;
+  dst_cm->lf.mode_ref_delta_enabled = src_cm->lf.mode_ref_delta_enabled;
+  dst_cm->lf.mode_ref_delta_update = src_cm->lf.mode_ref_delta_update;
+  memcpy(dst_cm->lf.ref_deltas, src_cm->lf.ref_deltas,
+         sizeof(dst_cm->lf.ref_deltas));
+  memcpy(dst_cm->lf.last_ref_deltas, src_cm->lf.last_ref_deltas,
+         sizeof(dst_cm->lf.last_ref_deltas));
+  memcpy(dst_cm->lf.mode_deltas, src_cm->lf.mode_deltas,
+         sizeof(dst_cm->lf.mode_deltas));
+  memcpy(dst_cm->lf.last_mode_deltas, src_cm->lf.last_mode_deltas,
+         sizeof(dst_cm->lf.last_mode_deltas));
+
+  dst_cm->seg = src_cm->seg;
+  if (dst_cm->last_frame_seg_map != NULL) {
+    const uint8_t *const seg_map = src_cm->seg.enabled && !show_existing_frame
+                                       ? src_cm->current_frame_seg_map
+                                       : src_cm->last_frame_seg_map;
+    if (seg_map != NULL) {
+      memcpy(dst_cm->last_frame_seg_map, seg_map,
+             dst_cm->mi_rows * dst_cm->mi_cols);
+    } else {
+      memset(dst_cm->last_frame_seg_map, 0, dst_cm->mi_rows * dst_cm->mi_cols);
+    }
+  }
+
+  memcpy(dst_cm->frame_contexts, src_cm->frame_contexts,
+         FRAME_CONTEXTS * sizeof(*dst_cm->frame_contexts));
+
+  dst_worker_data->pbi->need_resync = src_worker_data->pbi->need_resync;
+
+  return VPX_CODEC_OK;
+}
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VP9_DECODER_VP9_DTHREAD_H_
+#define VPX_VP9_DECODER_VP9_DTHREAD_H_
+
+#include "./vpx_config.h"
+#include "vpx_util/vpx_pthread.h"
+#include "vpx_util/vpx_thread.h"
+#include "vpx/internal/vpx_codec_internal.h"
+#include "vp9/common/vp9_onyxc_int.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct VP9Decoder;
+
+// WorkerData for the frame parallel decode. Each frame worker owns a decoder
+// instance and decodes one frame at a time. The frame workers share the
+// BufferPool and follow each other's progress through RefCntBuffer::row.
+typedef struct FrameWorkerData {
+  struct VP9Decoder *pbi;
+  const uint8_t *data;
+  const uint8_t *data_end;
+  size_t data_size;
+  void *user_priv;
+  int result;
+  int worker_id;
+
+  // Whether the frame is the last one of its packet. Only the last frame of a
+  // packet is output, matching the serial decoder.
+  int is_last_in_packet;
+
+  // Buffer holding the compressed data while the caller's buffer may have
+  // been released.
+  uint8_t *scratch_buffer;
+  size_t scratch_buffer_size;
+
+  // Index of the frame buffer that provides the previous frame motion vectors
+  // to this frame, held until the frame worker has been synchronized.
+  int prev_fb_idx;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t stats_mutex;
+  pthread_cond_t stats_cond;
+#endif
+
+  // Set once the state the next frame depends on (reference map, frame
+  // contexts, segmentation and loop filter state) is final.
+  int frame_context_ready;
+  // Set once the frame has been fully decoded.
+  int frame_decoded;
+} FrameWorkerData;
+
+void vp9_frameworker_init(FrameWorkerData *const frame_worker_data);
+void vp9_frameworker_deinit(FrameWorkerData *const frame_worker_data);
+
+// Resets the status of a frame worker before it is launched with a new frame.
+void vp9_frameworker_reset_stats(FrameWorkerData *const frame_worker_data);
+
+// Marks the frame context of the frame being decoded by 'worker' as ready.
+void vp9_frameworker_signal_context_ready(VPxWorker *const worker);
+
+// Marks the frame being decoded by 'worker' as fully decoded.
+void vp9_frameworker_signal_decoded(VPxWorker *const worker);
+
+// Returns non-zero if the frame worker has finished decoding its frame.
+int vp9_frameworker_is_decoded(VPxWorker *const worker);
+
+// Waits until 'row' luma rows of 'ref_buf' have been decoded. Returns non-zero
+// if 'ref_buf' failed to decode, in which case the rows are not valid.
+int vp9_frameworker_wait(BufferPool *const pool, RefCntBuffer *const ref_buf,
+                         int row);
+
+// Publishes that 'row' luma rows of 'buf' have been decoded. Progress never
+// moves backwards.
+void vp9_frameworker_broadcast(BufferPool *const pool, RefCntBuffer *const buf,
+                               int row);
+
+// Waits until the frame context of 'src_worker' is ready and copies the
+// decoder state the next frame depends on to 'dst_worker'.
+vpx_codec_err_t vp9_frameworker_copy_context(VPxWorker *const dst_worker,
+                                             VPxWorker *const src_worker);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // VPX_VP9_DECODER_VP9_DTHREAD_H_
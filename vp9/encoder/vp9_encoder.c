@@ -1044,7 +1044,12 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   vp9_free_context_buffers(cm);
 
   vpx_free_frame_buffer(&cpi->last_frame_uf);
+  vpx_free_frame_buffer(&cpi->lpf_trial_frame);
+  vpx_free(cpi->lpf_trial_lfm);
+  cpi->lpf_trial_lfm = NULL;
+  cpi->lpf_trial_lfm_size = 0;
   vpx_free_frame_buffer(&cpi->scaled_source);
+  vpx_free_frame_buffer(&cpi->svc_scaled_ahead);
   vpx_free_frame_buffer(&cpi->scaled_last_source);
   vpx_free_frame_buffer(&cpi->tf_buffer);
 #ifdef ENABLE_KF_DENOISE
@@ -2075,6 +2080,8 @@ void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
   int last_w = cpi->oxcf.width;
   int last_h = cpi->oxcf.height;
 
+  vp9_finish_async_psnr(cpi);
+  vp9_finish_svc_async_scale(cpi);
   vp9_init_quantizer(cpi);
   if (cm->profile != oxcf->profile) cm->profile = oxcf->profile;
   cm->bit_depth = oxcf->bit_depth;
@@ -2221,8 +2228,9 @@ void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
  * The following 2 functions ('cal_nmvjointsadcost' and                *
  * 'cal_nmvsadcosts') are used to calculate cost lookup tables         *
  * used by 'vp9_diamond_search_sad'. The C implementation of the       *
- * function is generic, but the NEON intrinsics optimised version      *
- * relies on the following properties of the computed tables:          *
+ * function is generic, but the NEON, SSE4.1 and AVX2 intrinsics       *
+ * optimised versions rely on the following properties of the          *
+ * computed tables:                                                    *
  * For cal_nmvjointsadcost:                                            *
  *   - mvjointsadcost[1] == mvjointsadcost[2] == mvjointsadcost[3]     *
  * For cal_nmvsadcosts:                                                *
@@ -2230,9 +2238,9 @@ void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
  *         (Equal costs for both components)                           *
  *   - For all i: mvsadcost[0][i] == mvsadcost[0][-i]                  *
  *         (Cost function is even)                                     *
- * If these do not hold, then the NEON optimised version of the        *
- * 'vp9_diamond_search_sad' function cannot be used as it is, in which *
- * case you can revert to using the C function instead.                *
+ * If these do not hold, then the SIMD optimised versions of the       *
+ * 'vp9_diamond_search_sad' function cannot be used as they are, in    *
+ * which case you can revert to using the C function instead.          *
  ***********************************************************************/
 
 static void cal_nmvjointsadcost(int *mvjointsadcost) {
@@ -2893,9 +2901,20 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
   vp9_free_tpl_buffer(cpi);
 
   vp9_loop_filter_dealloc(&cpi->lf_row_sync);
+  vp9_loop_filter_dealloc(&cpi->lpf_trial_sync);
   vp9_bitstream_encode_tiles_buffer_dealloc(cpi);
   vp9_row_mt_mem_dealloc(cpi);
   vp9_encode_free_mt_data(cpi);
+  if (cpi->psnr_worker_created) {
+    vp9_finish_async_psnr(cpi);
+    vpx_get_worker_interface()->end(&cpi->psnr_worker);
+    vpx_free(cpi->psnr_job);
+  }
+  if (cpi->svc_scale_worker_created) {
+    vp9_finish_svc_async_scale(cpi);
+    vpx_get_worker_interface()->end(&cpi->svc_scale_worker);
+    vpx_free(cpi->svc_scale_job);
+  }
 
 #if !CONFIG_REALTIME_ONLY
   vp9_alt_ref_aq_destroy(cpi->alt_ref_aq);
@@ -2952,14 +2971,24 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
 #endif
 }
 
-int vp9_get_psnr(const VP9_COMP *cpi, PSNR_STATS *psnr) {
-  if (is_psnr_calc_enabled(cpi)) {
+static void get_psnr_bit_depths(const VP9_COMP *cpi, uint32_t *bit_depth,
+                                uint32_t *in_bit_depth) {
 #if CONFIG_VP9_HIGHBITDEPTH
-    vpx_calc_highbd_psnr(cpi->raw_source_frame, cpi->common.frame_to_show, psnr,
-                         cpi->td.mb.e_mbd.bd, cpi->oxcf.input_bit_depth);
+  *bit_depth = cpi->td.mb.e_mbd.bd;
+  *in_bit_depth = cpi->oxcf.input_bit_depth;
 #else
-    vpx_calc_psnr(cpi->raw_source_frame, cpi->common.frame_to_show, psnr);
+  (void)cpi;
+  *bit_depth = 8;
+  *in_bit_depth = 8;
 #endif
+}
+
+int vp9_get_psnr(VP9_COMP *cpi, PSNR_STATS *psnr) {
+  if (is_psnr_calc_enabled(cpi)) {
+    uint32_t bit_depth, in_bit_depth;
+    get_psnr_bit_depths(cpi, &bit_depth, &in_bit_depth);
+    vp9_calc_psnr_mt(cpi, cpi->raw_source_frame, cpi->common.frame_to_show,
+                     psnr, bit_depth, in_bit_depth);
     return 1;
   } else {
     vp9_zero(*psnr);
@@ -2967,6 +2996,73 @@ int vp9_get_psnr(const VP9_COMP *cpi, PSNR_STATS *psnr) {
   }
 }
 
+typedef struct PsnrJobData {
+  const YV12_BUFFER_CONFIG *source;
+  const YV12_BUFFER_CONFIG *recon;
+  uint32_t bit_depth;
+  uint32_t in_bit_depth;
+  PSNR_STATS psnr;
+} PsnrJobData;
+
+static int async_psnr_worker_hook(void *arg1, void *unused) {
+  PsnrJobData *const job = (PsnrJobData *)arg1;
+  int64_t plane_sse[3] = { 0, 0, 0 };
+  (void)unused;
+  vpx_get_sse_rows(job->source, job->recon, 0, job->source->y_crop_height,
+                   job->bit_depth, job->in_bit_depth, plane_sse);
+  vpx_sse_to_psnr_stats(job->source, plane_sse, job->in_bit_depth,
+                        &job->psnr);
+  return 1;
+}
+
+int vp9_launch_async_psnr(VP9_COMP *cpi) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VPxWorker *const worker = &cpi->psnr_worker;
+  PsnrJobData *job;
+
+  vp9_finish_async_psnr(cpi);
+  if (!is_psnr_calc_enabled(cpi)) return 0;
+
+  if (!cpi->psnr_worker_created) {
+    CHECK_MEM_ERROR(&cpi->common.error, cpi->psnr_job,
+                    vpx_calloc(1, sizeof(*cpi->psnr_job)));
+    winterface->init(worker);
+    worker->thread_name = "vpx psnr worker";
+    // Without a thread the job runs on the calling thread below.
+    cpi->psnr_worker_created = winterface->reset(worker) ? 1 : -1;
+  }
+  job = cpi->psnr_job;
+  job->source = cpi->raw_source_frame;
+  job->recon = cpi->common.frame_to_show;
+  get_psnr_bit_depths(cpi, &job->bit_depth, &job->in_bit_depth);
+  worker->hook = async_psnr_worker_hook;
+  worker->data1 = job;
+  worker->data2 = NULL;
+  if (cpi->psnr_worker_created > 0) {
+    winterface->launch(worker);
+  } else {
+    winterface->execute(worker);
+  }
+  cpi->psnr_pending = 1;
+  return 1;
+}
+
+void vp9_finish_async_psnr(VP9_COMP *cpi) {
+  if (cpi->psnr_pending) {
+    vpx_get_worker_interface()->sync(&cpi->psnr_worker);
+    cpi->psnr_pending = 0;
+    cpi->psnr_ready = 1;
+  }
+}
+
+int vp9_get_async_psnr(VP9_COMP *cpi, PSNR_STATS *psnr) {
+  vp9_finish_async_psnr(cpi);
+  if (!cpi->psnr_ready) return 0;
+  *psnr = cpi->psnr_job->psnr;
+  cpi->psnr_ready = 0;
+  return 1;
+}
+
 int vp9_use_as_reference(VP9_COMP *cpi, int ref_frame_flags) {
   if (ref_frame_flags > 7) return -1;
 
@@ -3010,6 +3106,7 @@ int vp9_set_reference_enc(VP9_COMP *cpi, VP9_REFFRAME ref_frame_flag,
                           YV12_BUFFER_CONFIG *sd) {
   YV12_BUFFER_CONFIG *cfg = get_vp9_ref_frame_buffer(cpi, ref_frame_flag);
   if (cfg) {
+    vp9_finish_async_psnr(cpi);
     vpx_yv12_copy_frame(sd, cfg);
     return 0;
   } else {
@@ -3534,7 +3631,8 @@ void vp9_scale_references(VP9_COMP *cpi) {
                                        cm->byte_alignment, NULL, NULL, NULL))
             vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                                "Failed to allocate frame buffer");
-          vp9_scale_and_extend_frame(ref, &new_fb_ptr->buf, EIGHTTAP, 0);
+          vp9_scale_and_extend_frame_mt(cpi, ref, &new_fb_ptr->buf, EIGHTTAP,
+                                        0);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
           cpi->scaled_ref_idx[ref_frame - 1] = new_fb;
           alloc_frame_mvs(cm, new_fb);
@@ -3966,7 +4064,7 @@ static INLINE void set_raw_source_frame(VP9_COMP *cpi) {
 #ifdef ENABLE_KF_DENOISE
   if (is_spatial_denoise_enabled(cpi)) {
     cpi->raw_source_frame = vp9_scale_if_required(
-        cm, &cpi->raw_unscaled_source, &cpi->raw_scaled_source,
+        cpi, &cpi->raw_unscaled_source, &cpi->raw_scaled_source,
         (oxcf->pass == 0), EIGHTTAP, 0);
   } else {
     cpi->raw_source_frame = cpi->Source;
@@ -3977,17 +4075,18 @@ static INLINE void set_raw_source_frame(VP9_COMP *cpi) {
 }
 
 static YV12_BUFFER_CONFIG *svc_twostage_scale(
-    VP9_COMMON *cm, YV12_BUFFER_CONFIG *unscaled, YV12_BUFFER_CONFIG *scaled,
+    VP9_COMP *cpi, YV12_BUFFER_CONFIG *unscaled, YV12_BUFFER_CONFIG *scaled,
     YV12_BUFFER_CONFIG *scaled_temp, INTERP_FILTER filter_type,
     int phase_scaler, INTERP_FILTER filter_type2, int phase_scaler2) {
+  VP9_COMMON *const cm = &cpi->common;
   if (cm->mi_cols * MI_SIZE != unscaled->y_width ||
       cm->mi_rows * MI_SIZE != unscaled->y_height) {
 #if CONFIG_VP9_HIGHBITDEPTH
     if (cm->bit_depth == VPX_BITS_8) {
-      vp9_scale_and_extend_frame(unscaled, scaled_temp, filter_type2,
-                                 phase_scaler2);
-      vp9_scale_and_extend_frame(scaled_temp, scaled, filter_type,
-                                 phase_scaler);
+      vp9_scale_and_extend_frame_mt(cpi, unscaled, scaled_temp, filter_type2,
+                                    phase_scaler2);
+      vp9_scale_and_extend_frame_mt(cpi, scaled_temp, scaled, filter_type,
+                                    phase_scaler);
     } else {
       scale_and_extend_frame(unscaled, scaled_temp, (int)cm->bit_depth,
                              filter_type2, phase_scaler2);
@@ -3995,9 +4094,10 @@ static YV12_BUFFER_CONFIG *svc_twostage_scale(
                              filter_type, phase_scaler);
     }
 #else
-    vp9_scale_and_extend_frame(unscaled, scaled_temp, filter_type2,
-                               phase_scaler2);
-    vp9_scale_and_extend_frame(scaled_temp, scaled, filter_type, phase_scaler);
+    vp9_scale_and_extend_frame_mt(cpi, unscaled, scaled_temp, filter_type2,
+                                  phase_scaler2);
+    vp9_scale_and_extend_frame_mt(cpi, scaled_temp, scaled, filter_type,
+                                  phase_scaler);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
     return scaled;
   } else {
@@ -4005,6 +4105,147 @@ static YV12_BUFFER_CONFIG *svc_twostage_scale(
   }
 }
 
+typedef struct SvcScaleJobData {
+  const YV12_BUFFER_CONFIG *source;
+  YV12_BUFFER_CONFIG *scaled;
+  int superframe;
+  int spatial_layer_id;
+  INTERP_FILTER filter_type;
+  int phase_scaler;
+  int bit_depth;
+} SvcScaleJobData;
+
+// Runs the scaler vp9_scale_if_required() would pick, on this thread only.
+static int svc_scale_worker_hook(void *arg1, void *unused) {
+  SvcScaleJobData *const job = (SvcScaleJobData *)arg1;
+  const YV12_BUFFER_CONFIG *const src = job->source;
+  YV12_BUFFER_CONFIG *const dst = job->scaled;
+  (void)unused;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (src->y_width <= (dst->y_width << 1) &&
+      src->y_height <= (dst->y_height << 1)) {
+    if (job->bit_depth == VPX_BITS_8)
+      vp9_scale_and_extend_frame(src, dst, job->filter_type,
+                                 job->phase_scaler);
+    else
+      scale_and_extend_frame(src, dst, job->bit_depth, job->filter_type,
+                             job->phase_scaler);
+  } else {
+    vp9_scale_and_extend_frame_nonnormative(src, dst, job->bit_depth);
+  }
+#else
+  if (src->y_width <= (dst->y_width << 1) &&
+      src->y_height <= (dst->y_height << 1))
+    vp9_scale_and_extend_frame(src, dst, job->filter_type, job->phase_scaler);
+  else
+    vp9_scale_and_extend_frame_nonnormative(src, dst);
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  return 1;
+}
+
+// Starts scaling the source of the next spatial layer on svc_scale_worker, so
+// it is ready when that layer starts. Layers that are not scaled or that reuse
+// the 1/2x1/2 result of the two-stage scaling are left alone.
+static void launch_svc_async_scale(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  SVC *const svc = &cpi->svc;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VPxWorker *const worker = &cpi->svc_scale_worker;
+  const YV12_BUFFER_CONFIG *const src = cpi->un_scaled_source;
+  const int sl = svc->spatial_layer_id + 1;
+  const LAYER_CONTEXT *lc;
+  SvcScaleJobData *job;
+  int width, height;
+
+  // The source of this layer may be denoised in place if it isn't scaled.
+  if (!cpi->svc_async_scale || !is_one_pass_svc(cpi) ||
+      sl >= svc->number_spatial_layers || cpi->Source == src)
+    return;
+  lc = &svc->layer_context[LAYER_IDS_TO_IDX(sl, svc->temporal_layer_id,
+                                            svc->number_temporal_layers)];
+  get_layer_resolution(cpi->oxcf.width, cpi->oxcf.height,
+                       lc->scaling_factor_num, lc->scaling_factor_den, &width,
+                       &height);
+  if ((ALIGN_POWER_OF_TWO(width, MI_SIZE_LOG2) == src->y_width &&
+       ALIGN_POWER_OF_TWO(height, MI_SIZE_LOG2) == src->y_height) ||
+      (src->y_width == width << 1 && src->y_height == height << 1 &&
+       svc->scaled_one_half) ||
+      (src->y_width == width << 2 && src->y_height == height << 2))
+    return;
+
+  if (!cpi->svc_scale_worker_created) {
+    CHECK_MEM_ERROR(&cm->error, cpi->svc_scale_job,
+                    vpx_calloc(1, sizeof(*cpi->svc_scale_job)));
+    winterface->init(worker);
+    worker->thread_name = "vpx svc scale worker";
+    cpi->svc_scale_worker_created = winterface->reset(worker) ? 1 : -1;
+  }
+  // Without a thread the layer scales its source when it starts, as usual.
+  if (cpi->svc_scale_worker_created < 0) return;
+
+  job = cpi->svc_scale_job;
+  if (vpx_realloc_frame_buffer(&cpi->svc_scaled_ahead, width, height,
+                               cm->subsampling_x, cm->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+                               cm->use_highbitdepth,
+#endif
+                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               NULL, NULL, NULL))
+    return;
+  job->source = src;
+  job->scaled = &cpi->svc_scaled_ahead;
+  job->superframe = svc->current_superframe;
+  job->spatial_layer_id = sl;
+  job->filter_type = svc->downsample_filter_type[sl];
+  job->phase_scaler = svc->downsample_filter_phase[sl];
+  job->bit_depth = (int)cm->bit_depth;
+  worker->hook = svc_scale_worker_hook;
+  worker->data1 = job;
+  worker->data2 = NULL;
+  winterface->launch(worker);
+  cpi->svc_scale_pending = 1;
+  cpi->svc_scale_ready = 0;
+}
+
+void vp9_finish_svc_async_scale(VP9_COMP *cpi) {
+  if (cpi->svc_scale_pending) {
+    vpx_get_worker_interface()->sync(&cpi->svc_scale_worker);
+    cpi->svc_scale_pending = 0;
+    cpi->svc_scale_ready = 1;
+  }
+}
+
+// Moves the source scaled ahead for this layer into cpi->scaled_source.
+// Returns 0 if there is none, or if it was scaled from another source or with
+// other parameters, e.g. when the layer changed its filter on its first frame.
+static int take_svc_async_scale(VP9_COMP *cpi, INTERP_FILTER filter_type,
+                                int phase_scaler) {
+  VP9_COMMON *const cm = &cpi->common;
+  const SVC *const svc = &cpi->svc;
+  SvcScaleJobData *const job = cpi->svc_scale_job;
+  YV12_BUFFER_CONFIG tmp;
+
+  vp9_finish_svc_async_scale(cpi);
+  if (!cpi->svc_scale_ready) return 0;
+  cpi->svc_scale_ready = 0;
+  if (job->source != cpi->un_scaled_source ||
+      job->superframe != svc->current_superframe ||
+      job->spatial_layer_id != svc->spatial_layer_id ||
+      job->filter_type != filter_type || job->phase_scaler != phase_scaler ||
+      job->bit_depth != (int)cm->bit_depth ||
+      job->scaled->y_crop_width != cm->width ||
+      job->scaled->y_crop_height != cm->height ||
+      (cm->mi_cols * MI_SIZE == job->source->y_width &&
+       cm->mi_rows * MI_SIZE == job->source->y_height))
+    return 0;
+
+  // Both buffers are allocated alike, so they can trade places.
+  tmp = cpi->scaled_source;
+  cpi->scaled_source = cpi->svc_scaled_ahead;
+  cpi->svc_scaled_ahead = tmp;
+  return 1;
+}
+
 static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
                                       uint8_t *dest, size_t dest_size) {
   VP9_COMMON *const cm = &cpi->common;
@@ -4048,7 +4289,7 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
     const INTERP_FILTER filter_scaler2 = svc->downsample_filter_type[1];
     const int phase_scaler2 = svc->downsample_filter_phase[1];
     cpi->Source = svc_twostage_scale(
-        cm, cpi->un_scaled_source, &cpi->scaled_source, &svc->scaled_temp,
+        cpi, cpi->un_scaled_source, &cpi->scaled_source, &svc->scaled_temp,
         filter_scaler, phase_scaler, filter_scaler2, phase_scaler2);
     svc->scaled_one_half = 1;
   } else if (is_one_pass_svc(cpi) &&
@@ -4059,11 +4300,16 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
     // two-stage scaling, use the result directly.
     cpi->Source = &svc->scaled_temp;
     svc->scaled_one_half = 0;
+  } else if (is_one_pass_svc(cpi) &&
+             take_svc_async_scale(cpi, filter_scaler, phase_scaler)) {
+    cpi->Source = &cpi->scaled_source;
   } else {
     cpi->Source = vp9_scale_if_required(
-        cm, cpi->un_scaled_source, &cpi->scaled_source, (cpi->oxcf.pass == 0),
+        cpi, cpi->un_scaled_source, &cpi->scaled_source, (cpi->oxcf.pass == 0),
         filter_scaler, phase_scaler);
   }
+  // The next spatial layer's source is scaled while this layer is encoded.
+  launch_svc_async_scale(cpi);
 #ifdef OUTPUT_YUV_SVC_SRC
   // Write out at most 3 spatial layers.
   if (is_one_pass_svc(cpi) && svc->spatial_layer_id < 3) {
@@ -4076,7 +4322,7 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
 #ifdef ENABLE_KF_DENOISE
     if (is_spatial_denoise_enabled(cpi)) {
       cpi->raw_source_frame = vp9_scale_if_required(
-          cm, &cpi->raw_unscaled_source, &cpi->raw_scaled_source,
+          cpi, &cpi->raw_unscaled_source, &cpi->raw_scaled_source,
           (cpi->oxcf.pass == 0), EIGHTTAP, phase_scaler);
     } else {
       cpi->raw_source_frame = cpi->Source;
@@ -4111,7 +4357,7 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
        (cpi->noise_estimate.enabled && !cpi->oxcf.noise_sensitivity) ||
        cpi->compute_source_sad_onepass))
     cpi->Last_Source = vp9_scale_if_required(
-        cm, cpi->unscaled_last_source, &cpi->scaled_last_source,
+        cpi, cpi->unscaled_last_source, &cpi->scaled_last_source,
         (cpi->oxcf.pass == 0), EIGHTTAP, 0);
 
   if (cpi->Last_Source == NULL ||
@@ -4597,8 +4843,9 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
     }
 
     cpi->Source =
-        vp9_scale_if_required(cm, cpi->un_scaled_source, &cpi->scaled_source,
-                              (oxcf->pass == 0), EIGHTTAP, 0);
+        vp9_scale_if_required(cpi, cpi->un_scaled_source,
+                              &cpi->scaled_source, (oxcf->pass == 0),
+                              EIGHTTAP, 0);
 
     // Unfiltered raw source used in metrics calculation if the source
     // has been filtered.
@@ -4606,7 +4853,7 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
 #ifdef ENABLE_KF_DENOISE
       if (is_spatial_denoise_enabled(cpi)) {
         cpi->raw_source_frame = vp9_scale_if_required(
-            cm, &cpi->raw_unscaled_source, &cpi->raw_scaled_source,
+            cpi, &cpi->raw_unscaled_source, &cpi->raw_scaled_source,
             (oxcf->pass == 0), EIGHTTAP, 0);
       } else {
         cpi->raw_source_frame = cpi->Source;
@@ -4617,7 +4864,7 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
     }
 
     if (cpi->unscaled_last_source != NULL)
-      cpi->Last_Source = vp9_scale_if_required(cm, cpi->unscaled_last_source,
+      cpi->Last_Source = vp9_scale_if_required(cpi, cpi->unscaled_last_source,
                                                &cpi->scaled_last_source,
                                                (oxcf->pass == 0), EIGHTTAP, 0);
 
@@ -4993,27 +5240,29 @@ static void set_ext_overrides(VP9_COMP *cpi) {
 }
 
 YV12_BUFFER_CONFIG *vp9_scale_if_required(
-    VP9_COMMON *cm, YV12_BUFFER_CONFIG *unscaled, YV12_BUFFER_CONFIG *scaled,
+    VP9_COMP *cpi, YV12_BUFFER_CONFIG *unscaled, YV12_BUFFER_CONFIG *scaled,
     int use_normative_scaler, INTERP_FILTER filter_type, int phase_scaler) {
+  VP9_COMMON *const cm = &cpi->common;
   if (cm->mi_cols * MI_SIZE != unscaled->y_width ||
       cm->mi_rows * MI_SIZE != unscaled->y_height) {
 #if CONFIG_VP9_HIGHBITDEPTH
     if (use_normative_scaler && unscaled->y_width <= (scaled->y_width << 1) &&
         unscaled->y_height <= (scaled->y_height << 1))
       if (cm->bit_depth == VPX_BITS_8)
-        vp9_scale_and_extend_frame(unscaled, scaled, filter_type, phase_scaler);
+        vp9_scale_and_extend_frame_mt(cpi, unscaled, scaled, filter_type,
+                                      phase_scaler);
       else
         scale_and_extend_frame(unscaled, scaled, (int)cm->bit_depth,
                                filter_type, phase_scaler);
     else
-      vp9_scale_and_extend_frame_nonnormative(unscaled, scaled,
-                                              (int)cm->bit_depth);
+      vp9_scale_and_extend_frame_nonnormative_mt(cpi, unscaled, scaled);
 #else
     if (use_normative_scaler && unscaled->y_width <= (scaled->y_width << 1) &&
         unscaled->y_height <= (scaled->y_height << 1))
-      vp9_scale_and_extend_frame(unscaled, scaled, filter_type, phase_scaler);
+      vp9_scale_and_extend_frame_mt(cpi, unscaled, scaled, filter_type,
+                                    phase_scaler);
     else
-      vp9_scale_and_extend_frame_nonnormative(unscaled, scaled);
+      vp9_scale_and_extend_frame_nonnormative_mt(cpi, unscaled, scaled);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
     return scaled;
   } else {
@@ -5978,8 +6227,8 @@ static void Pass2Encode(VP9_COMP *cpi, size_t *size, uint8_t *dest,
 #endif  // !CONFIG_REALTIME_ONLY
 
 int vp9_receive_raw_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
-                          YV12_BUFFER_CONFIG *sd, int64_t time_stamp,
-                          int64_t end_time) {
+                          YV12_BUFFER_CONFIG *sd, const vpx_image_t *img,
+                          int64_t time_stamp, int64_t end_time) {
   VP9_COMMON *const cm = &cpi->common;
   struct vpx_usec_timer timer;
   int res = 0;
@@ -5991,6 +6240,22 @@ int vp9_receive_raw_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
   const int use_highbitdepth = 0;
 #endif
 
+  // Every error before the frame is pushed has to longjmp, so the caller
+  // knows it still owns |img| and must release it. Nothing may longjmp after.
+  assert(cm->error.setjmp);
+  if ((cm->profile == PROFILE_0 || cm->profile == PROFILE_2) &&
+      (subsampling_x != 1 || subsampling_y != 1)) {
+    vpx_internal_error(&cm->error, VPX_CODEC_INVALID_PARAM,
+                       "Non-4:2:0 color format requires profile 1 or 3");
+  }
+  if ((cm->profile == PROFILE_1 || cm->profile == PROFILE_3) &&
+      (subsampling_x == 1 && subsampling_y == 1)) {
+    vpx_internal_error(&cm->error, VPX_CODEC_INVALID_PARAM,
+                       "4:2:0 color format requires profile 0 or 2");
+  }
+
+  vp9_finish_async_psnr(cpi);
+  vp9_finish_svc_async_scale(cpi);
   update_initial_width(cpi, use_highbitdepth, subsampling_x, subsampling_y);
 #if CONFIG_VP9_TEMPORAL_DENOISING
   setup_denoiser_buffer(cpi);
@@ -6000,25 +6265,18 @@ int vp9_receive_raw_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
 
   vpx_usec_timer_start(&timer);
 
-  if (vp9_lookahead_push(cpi->lookahead, sd, time_stamp, end_time,
-                         use_highbitdepth, frame_flags))
+  if (img != NULL && cpi->source_release.release_cb != NULL) {
+    if (vp9_lookahead_push_external(cpi->lookahead, sd, img,
+                                    &cpi->source_release, time_stamp,
+                                    end_time, use_highbitdepth, frame_flags))
+      res = -1;
+  } else if (vp9_lookahead_push(cpi->lookahead, sd, time_stamp, end_time,
+                                use_highbitdepth, frame_flags)) {
     res = -1;
+  }
   vpx_usec_timer_mark(&timer);
   cpi->time_receive_data += vpx_usec_timer_elapsed(&timer);
 
-  if ((cm->profile == PROFILE_0 || cm->profile == PROFILE_2) &&
-      (subsampling_x != 1 || subsampling_y != 1)) {
-    vpx_internal_error(&cm->error, VPX_CODEC_INVALID_PARAM,
-                       "Non-4:2:0 color format requires profile 1 or 3");
-    res = -1;
-  }
-  if ((cm->profile == PROFILE_1 || cm->profile == PROFILE_3) &&
-      (subsampling_x == 1 && subsampling_y == 1)) {
-    vpx_internal_error(&cm->error, VPX_CODEC_INVALID_PARAM,
-                       "4:2:0 color format requires profile 0 or 2");
-    res = -1;
-  }
-
   return res;
 }
 
@@ -6424,6 +6682,11 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   if (oxcf->pass == 2) start_timing(cpi, vp9_get_compressed_data_time);
 #endif
 
+  // The buffers compared by a pending async PSNR job, or read by a pending
+  // scaling of the next spatial layer, may be reused below.
+  vp9_finish_async_psnr(cpi);
+  vp9_finish_svc_async_scale(cpi);
+
   if (is_one_pass_svc(cpi)) {
     vp9_one_pass_svc_start_layer(cpi);
   }
@@ -6777,8 +7040,9 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
 
 #if !CONFIG_REALTIME_ONLY
   if (is_key_temporal_filter_enabled && cpi->b_calculate_psnr) {
-    cpi->raw_source_frame = vp9_scale_if_required(
-        cm, source_buffer, &cpi->scaled_source, (oxcf->pass == 0), EIGHTTAP, 0);
+    cpi->raw_source_frame =
+        vp9_scale_if_required(cpi, source_buffer, &cpi->scaled_source,
+                              (oxcf->pass == 0), EIGHTTAP, 0);
   }
 #endif  // !CONFIG_REALTIME_ONLY
 
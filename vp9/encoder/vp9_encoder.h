@@ -508,6 +508,16 @@ typedef struct ARNRFilterData {
   YV12_BUFFER_CONFIG *dst;
 } ARNRFilterData;
 
+// State of the frame being processed by the TPL model, shared by the threads
+// running vp9_mc_flow_dispenser_row().
+typedef struct TplMcFlowData {
+  struct GF_PICTURE *gf_picture;
+  int frame_idx;
+  BLOCK_SIZE bsize;
+  struct scale_factors sf;
+  YV12_BUFFER_CONFIG *ref_frame[MAX_INTER_REF_FRAMES];
+} TplMcFlowData;
+
 typedef struct EncFrameBuf {
   int mem_valid;
   int released;
@@ -728,6 +738,8 @@ static INLINE char const *get_component_name(int index) {
 }
 #endif
 
+struct PsnrJobData;
+
 typedef struct VP9_COMP {
   FRAME_INFO frame_info;
   QUANTS quants;
@@ -739,6 +751,9 @@ typedef struct VP9_COMP {
   VP9EncoderConfig oxcf;
   struct lookahead_ctx *lookahead;
   struct lookahead_entry *alt_ref_source;
+  // When set, source frames are referenced in the lookahead rather than
+  // copied, and handed back through this callback.
+  vpx_source_release_cb_t source_release;
 
   YV12_BUFFER_CONFIG *Source;
   YV12_BUFFER_CONFIG *Last_Source;  // NULL for first frame and alt_ref frames
@@ -754,6 +769,7 @@ typedef struct VP9_COMP {
 
   BLOCK_SIZE tpl_bsize;
   TplDepFrame tpl_stats[MAX_ARF_GOP_SIZE];
+  TplMcFlowData tpl_mc_flow_data;
   // Used to store TPL stats before propagation
   VpxTplGopStats tpl_gop_stats;
   YV12_BUFFER_CONFIG *tpl_recon_frames[REF_FRAMES];
@@ -806,6 +822,12 @@ typedef struct VP9_COMP {
   int64_t *sb_mul_scale;
 
   YV12_BUFFER_CONFIG last_frame_uf;
+  // Scratch frame, masks and row sync used by the filter level search to try
+  // a second level concurrently with the one applied to frame_to_show.
+  YV12_BUFFER_CONFIG lpf_trial_frame;
+  LOOP_FILTER_MASK *lpf_trial_lfm;
+  int lpf_trial_lfm_size;
+  VP9LfSync lpf_trial_sync;
 
   TOKENEXTRA *tile_tok[4][1 << 6];
   TOKENLIST *tplist[4][1 << 6];
@@ -993,6 +1015,25 @@ typedef struct VP9_COMP {
   int num_workers;
   VPxWorker *workers;
   struct EncWorkerData *tile_thr_data;
+
+  // PSNR of the last shown frame, computed on psnr_worker while the caller
+  // handles the frame when async_psnr is set.
+  int async_psnr;
+  int psnr_worker_created;  // 1 with a thread, -1 without one
+  int psnr_pending;
+  int psnr_ready;
+  VPxWorker psnr_worker;
+  struct PsnrJobData *psnr_job;
+
+  // Source of the next spatial layer, scaled on svc_scale_worker while the
+  // current layer is encoded when svc_async_scale is set.
+  int svc_async_scale;
+  int svc_scale_worker_created;  // 1 with a thread, -1 without one
+  int svc_scale_pending;
+  int svc_scale_ready;
+  VPxWorker svc_scale_worker;
+  struct SvcScaleJobData *svc_scale_job;
+  YV12_BUFFER_CONFIG svc_scaled_ahead;
   VP9LfSync lf_row_sync;
   struct VP9BitstreamWorkerData *vp9_bitstream_worker_data;
 
@@ -1222,10 +1263,12 @@ void vp9_remove_compressor(VP9_COMP *cpi);
 void vp9_change_config(VP9_COMP *cpi, const VP9EncoderConfig *oxcf);
 
 // receive a frames worth of data. caller can assume that a copy of this
-// frame is made and not just a copy of the pointer..
+// frame is made and not just a copy of the pointer, unless a source release
+// callback is installed, in which case |img| is handed back through it. If
+// this longjmps, |img| has not been taken and the caller has to release it.
 int vp9_receive_raw_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
-                          YV12_BUFFER_CONFIG *sd, int64_t time_stamp,
-                          int64_t end_time);
+                          YV12_BUFFER_CONFIG *sd, const vpx_image_t *img,
+                          int64_t time_stamp, int64_t end_time);
 
 int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
                             size_t *size, uint8_t *dest, size_t dest_size,
@@ -1409,8 +1452,22 @@ void vp9_scale_and_extend_frame_nonnormative(const YV12_BUFFER_CONFIG *src,
                                              YV12_BUFFER_CONFIG *dst);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
+// Returns 1 if vp9_scale_and_extend_frame() scales src into dst through
+// vp9_scale_frame_rows() rather than a ratio specific SIMD path.
+int vp9_scale_frame_is_general(const YV12_BUFFER_CONFIG *src,
+                               const YV12_BUFFER_CONFIG *dst,
+                               int phase_scaler);
+
+// Scales rows [row_start, row_end) of 16x16 luma blocks (8x8 chroma blocks)
+// of dst from src without extending the borders. Ratios up to 2:1 are
+// filtered in row slabs, steeper ones with a vpx_scaled_2d() call per block.
+// Different rows may be scaled concurrently.
+void vp9_scale_frame_rows(const YV12_BUFFER_CONFIG *src,
+                          YV12_BUFFER_CONFIG *dst, INTERP_FILTER filter_type,
+                          int phase_scaler, int row_start, int row_end);
+
 YV12_BUFFER_CONFIG *vp9_scale_if_required(
-    VP9_COMMON *cm, YV12_BUFFER_CONFIG *unscaled, YV12_BUFFER_CONFIG *scaled,
+    VP9_COMP *cpi, YV12_BUFFER_CONFIG *unscaled, YV12_BUFFER_CONFIG *scaled,
     int use_normative_scaler, INTERP_FILTER filter_type, int phase_scaler);
 
 void vp9_apply_encoding_flags(VP9_COMP *cpi, vpx_enc_frame_flags_t flags);
@@ -1497,7 +1554,22 @@ void vp9_new_framerate(VP9_COMP *cpi, double framerate);
 
 void vp9_set_row_mt(VP9_COMP *cpi);
 
-int vp9_get_psnr(const VP9_COMP *cpi, PSNR_STATS *psnr);
+int vp9_get_psnr(VP9_COMP *cpi, PSNR_STATS *psnr);
+
+// Starts computing the PSNR of the frame just encoded on a separate thread.
+// Returns 0 if PSNR is not computed for this frame.
+int vp9_launch_async_psnr(VP9_COMP *cpi);
+
+// Waits for the PSNR started by vp9_launch_async_psnr(), if any. This is done
+// before the encoder touches its source or reconstruction buffers again.
+void vp9_finish_async_psnr(VP9_COMP *cpi);
+
+// Returns 1 and fills |psnr| if the PSNR of an earlier frame is available.
+int vp9_get_async_psnr(VP9_COMP *cpi, PSNR_STATS *psnr);
+
+// Waits for the source scaling started for the next spatial layer, if any.
+// This is done before the source buffers can be released or reused.
+void vp9_finish_svc_async_scale(VP9_COMP *cpi);
 
 #define LAYER_IDS_TO_IDX(sl, tl, num_tl) ((sl) * (num_tl) + (tl))
 
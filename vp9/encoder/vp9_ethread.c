@@ -8,14 +8,19 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "./vpx_scale_rtcd.h"
 #include "vp9/common/vp9_thread_common.h"
 #include "vp9/encoder/vp9_bitstream.h"
 #include "vp9/encoder/vp9_encodeframe.h"
 #include "vp9/encoder/vp9_encoder.h"
 #include "vp9/encoder/vp9_ethread.h"
 #include "vp9/encoder/vp9_firstpass.h"
+#include "vp9/encoder/vp9_mbgraph.h"
 #include "vp9/encoder/vp9_multi_thread.h"
+#include "vp9/encoder/vp9_resize.h"
 #include "vp9/encoder/vp9_temporal_filter.h"
+#include "vp9/encoder/vp9_tpl_model.h"
+#include "vpx_dsp/psnr.h"
 #include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_util/vpx_pthread.h"
 
@@ -584,8 +589,163 @@ void vp9_temporal_filter_row_mt(VP9_COMP *cpi) {
   launch_enc_workers(cpi, temporal_filter_worker_hook, multi_thread_ctxt,
                      num_workers);
 }
+
+typedef struct MbgraphRowMTData {
+  MultiThreadHandle *multi_thread_ctxt;
+  VP9RowMTSync *row_mt_sync;
+  MBGRAPH_FRAME_STATS *stats;
+  YV12_BUFFER_CONFIG *buf;
+  YV12_BUFFER_CONFIG *golden_ref;
+  YV12_BUFFER_CONFIG *alt_ref;
+} MbgraphRowMTData;
+
+static int mbgraph_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  MbgraphRowMTData *const row_mt_data = (MbgraphRowMTData *)arg2;
+  JobNode *proc_job;
+
+  // Rows are queued in order, so the row a job waits on has already been
+  // taken by another worker.
+  while ((proc_job = (JobNode *)vp9_enc_grp_get_next_job(
+              row_mt_data->multi_thread_ctxt, 0)) != NULL) {
+    vp9_update_mbgraph_mb_row(
+        thread_data->cpi, thread_data->td, row_mt_data->stats, row_mt_data->buf,
+        row_mt_data->golden_ref, row_mt_data->alt_ref,
+        proc_job->vert_unit_row_num, row_mt_data->row_mt_sync);
+  }
+  return 1;
+}
+
+void vp9_update_mbgraph_stats_row_mt(VP9_COMP *cpi, int n_frames,
+                                     YV12_BUFFER_CONFIG *golden_ref) {
+  VP9_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  MultiThreadHandle *multi_thread_ctxt = &cpi->multi_thread_ctxt;
+  int num_workers = VPXMAX(cpi->oxcf.max_threads, 1);
+  MbgraphRowMTData row_mt_data;
+  int i;
+
+  if (multi_thread_ctxt->allocated_tile_cols < tile_cols ||
+      multi_thread_ctxt->allocated_tile_rows < tile_rows ||
+      multi_thread_ctxt->allocated_vert_unit_rows < cm->mb_rows) {
+    vp9_row_mt_mem_dealloc(cpi);
+    vp9_init_tile_data(cpi);
+    vp9_row_mt_mem_alloc(cpi);
+  } else {
+    vp9_init_tile_data(cpi);
+  }
+
+  create_enc_workers(cpi, num_workers);
+
+  for (i = 0; i < num_workers; i++) {
+    EncWorkerData *thread_data;
+    thread_data = &cpi->tile_thr_data[i];
+
+    // Before processing a frame, copy the thread data from cpi.
+    if (thread_data->td != &cpi->td) {
+      thread_data->td->mb = cpi->td.mb;
+    }
+  }
+
+  // The row sync of the first tile column covers every macroblock row.
+  row_mt_data.multi_thread_ctxt = multi_thread_ctxt;
+  row_mt_data.row_mt_sync = &cpi->tile_data[0].row_mt_sync;
+  row_mt_data.golden_ref = golden_ref;
+  row_mt_data.alt_ref = cpi->Source;
+
+  for (i = 0; i < n_frames; i++) {
+    struct lookahead_entry *q_cur = vp9_lookahead_peek(cpi->lookahead, i);
+
+    assert(q_cur != NULL);
+
+    row_mt_data.stats = &cpi->mbgraph_stats[i];
+    row_mt_data.buf = &q_cur->img;
+    vp9_prepare_job_queue(cpi, MBGRAPH_JOB);
+    memset(row_mt_data.row_mt_sync->cur_col, -1,
+           sizeof(*row_mt_data.row_mt_sync->cur_col) * cm->mb_rows);
+    launch_enc_workers(cpi, mbgraph_worker_hook, &row_mt_data, num_workers);
+  }
+}
 #endif  // !CONFIG_REALTIME_ONLY
 
+static int tpl_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  MultiThreadHandle *multi_thread_ctxt = (MultiThreadHandle *)arg2;
+  VP9_COMP *const cpi = thread_data->cpi;
+  const VP9_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int mi_height =
+      num_8x8_blocks_high_lookup[cpi->tpl_mc_flow_data.bsize];
+  int tile_row, tile_col;
+  TileDataEnc *this_tile;
+  int end_of_frame;
+  int thread_id = thread_data->thread_id;
+  int cur_tile_id = multi_thread_ctxt->thread_id_to_tile_id[thread_id];
+  JobNode *proc_job = NULL;
+  int mi_row;
+
+  end_of_frame = 0;
+  while (0 == end_of_frame) {
+    // Get the next job in the queue
+    proc_job =
+        (JobNode *)vp9_enc_grp_get_next_job(multi_thread_ctxt, cur_tile_id);
+    if (NULL == proc_job) {
+      // Query for the status of other tiles
+      end_of_frame = vp9_get_tiles_proc_status(
+          multi_thread_ctxt, thread_data->tile_completion_status, &cur_tile_id,
+          tile_cols);
+    } else {
+      tile_col = proc_job->tile_col_id;
+      tile_row = proc_job->tile_row_id;
+      this_tile = &cpi->tile_data[tile_row * tile_cols + tile_col];
+      mi_row = proc_job->vert_unit_row_num * mi_height;
+
+      vp9_mc_flow_dispenser_row(cpi, thread_data->td, mi_row,
+                                this_tile->tile_info.mi_col_start,
+                                this_tile->tile_info.mi_col_end);
+    }
+  }
+  return 1;
+}
+
+void vp9_mc_flow_dispenser_row_mt(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  MultiThreadHandle *multi_thread_ctxt = &cpi->multi_thread_ctxt;
+  int num_workers = VPXMAX(cpi->oxcf.max_threads, 1);
+  int i;
+
+  if (multi_thread_ctxt->allocated_tile_cols < tile_cols ||
+      multi_thread_ctxt->allocated_tile_rows < tile_rows ||
+      multi_thread_ctxt->allocated_vert_unit_rows < cm->mb_rows) {
+    vp9_row_mt_mem_dealloc(cpi);
+    vp9_init_tile_data(cpi);
+    vp9_row_mt_mem_alloc(cpi);
+  } else {
+    vp9_init_tile_data(cpi);
+  }
+
+  create_enc_workers(cpi, num_workers);
+
+  vp9_assign_tile_to_thread(multi_thread_ctxt, tile_cols, cpi->num_workers);
+
+  vp9_prepare_job_queue(cpi, TPL_JOB);
+
+  for (i = 0; i < num_workers; i++) {
+    EncWorkerData *thread_data;
+    thread_data = &cpi->tile_thr_data[i];
+
+    // Before processing a frame, copy the thread data from cpi.
+    if (thread_data->td != &cpi->td) {
+      thread_data->td->mb = cpi->td.mb;
+    }
+  }
+
+  launch_enc_workers(cpi, tpl_worker_hook, multi_thread_ctxt, num_workers);
+}
+
 static int enc_row_mt_worker_hook(void *arg1, void *arg2) {
   EncWorkerData *const thread_data = (EncWorkerData *)arg1;
   MultiThreadHandle *multi_thread_ctxt = (MultiThreadHandle *)arg2;
@@ -691,3 +851,244 @@ void vp9_encode_tiles_row_mt(VP9_COMP *cpi) {
     }
   }
 }
+
+// Number of luma rows in one PSNR band. Must be a multiple of 32 so chroma
+// bands of 4:2:0 input stay aligned.
+#define PSNR_BAND_ROWS 64
+
+typedef struct PsnrBandData {
+  const YV12_BUFFER_CONFIG *a;
+  const YV12_BUFFER_CONFIG *b;
+  uint32_t bit_depth;
+  uint32_t in_bit_depth;
+  int num_workers;
+  int64_t plane_sse[MAX_NUM_THREADS][3];
+} PsnrBandData;
+
+static int psnr_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  PsnrBandData *const band_data = (PsnrBandData *)arg2;
+  const int height = band_data->a->y_crop_height;
+  int64_t *const plane_sse = band_data->plane_sse[thread_data->start];
+  int row;
+
+  plane_sse[0] = plane_sse[1] = plane_sse[2] = 0;
+  for (row = thread_data->start * PSNR_BAND_ROWS; row < height;
+       row += band_data->num_workers * PSNR_BAND_ROWS) {
+    vpx_get_sse_rows(band_data->a, band_data->b, row,
+                     VPXMIN(row + PSNR_BAND_ROWS, height),
+                     band_data->bit_depth, band_data->in_bit_depth, plane_sse);
+  }
+  return 1;
+}
+
+void vp9_calc_psnr_mt(VP9_COMP *cpi, const YV12_BUFFER_CONFIG *a,
+                      const YV12_BUFFER_CONFIG *b, PSNR_STATS *psnr,
+                      uint32_t bit_depth, uint32_t in_bit_depth) {
+  const int num_bands =
+      (a->y_crop_height + PSNR_BAND_ROWS - 1) / PSNR_BAND_ROWS;
+  int64_t plane_sse[3] = { 0, 0, 0 };
+  int i, j;
+
+  if (cpi->num_workers > 1 && num_bands > 1) {
+    // Only reuse workers already created for this frame's encode.
+    PsnrBandData band_data;
+    const int num_workers = VPXMIN(cpi->num_workers, num_bands);
+    band_data.a = a;
+    band_data.b = b;
+    band_data.bit_depth = bit_depth;
+    band_data.in_bit_depth = in_bit_depth;
+    band_data.num_workers = num_workers;
+    launch_enc_workers(cpi, psnr_worker_hook, &band_data, num_workers);
+    for (i = 0; i < num_workers; ++i) {
+      for (j = 0; j < 3; ++j) plane_sse[j] += band_data.plane_sse[i][j];
+    }
+  } else {
+    vpx_get_sse_rows(a, b, 0, a->y_crop_height, bit_depth, in_bit_depth,
+                     plane_sse);
+  }
+  vpx_sse_to_psnr_stats(a, plane_sse, in_bit_depth, psnr);
+}
+
+typedef struct ResizeBandData {
+  const uint8_t *src[MAX_MB_PLANE];
+  int src_stride[MAX_MB_PLANE];
+  int src_width[MAX_MB_PLANE];
+  int src_height[MAX_MB_PLANE];
+  uint8_t *dst[MAX_MB_PLANE];
+  int dst_stride[MAX_MB_PLANE];
+  int dst_width[MAX_MB_PLANE];
+  int dst_height[MAX_MB_PLANE];
+  // Horizontally resized planes, dst_width x src_height each.
+  uint8_t *intbuf[MAX_MB_PLANE];
+  int use_highbitdepth;
+  int bd;
+  int num_workers;
+  // 0 while the rows are resized, 1 for the columns.
+  int cols_pass;
+  int ok[MAX_NUM_THREADS];
+} ResizeBandData;
+
+static int resize_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  ResizeBandData *const band_data = (ResizeBandData *)arg2;
+  const int t = thread_data->start;
+  const int n = band_data->num_workers;
+  int ok = 1;
+  int i;
+
+  for (i = 0; i < MAX_MB_PLANE; ++i) {
+    if (!band_data->cols_pass) {
+      const int rows = band_data->src_height[i];
+      const int start = rows * t / n;
+      const int end = rows * (t + 1) / n;
+      if (start >= end) continue;
+#if CONFIG_VP9_HIGHBITDEPTH
+      if (band_data->use_highbitdepth) {
+        ok &= vp9_highbd_resize_plane_rows(
+            band_data->src[i], band_data->src_width[i],
+            band_data->src_stride[i], (uint16_t *)band_data->intbuf[i],
+            band_data->dst_width[i], start, end, band_data->bd);
+        continue;
+      }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+      ok &= vp9_resize_plane_rows(band_data->src[i], band_data->src_width[i],
+                                  band_data->src_stride[i],
+                                  band_data->intbuf[i],
+                                  band_data->dst_width[i], start, end);
+    } else {
+      // Keep the column bands a multiple of 16 pels wide for the SIMD
+      // filters.
+      const int cols = band_data->dst_width[i];
+      const int band = ALIGN_POWER_OF_TWO((cols + n - 1) / n, 4);
+      const int start = VPXMIN(band * t, cols);
+      const int end = VPXMIN(start + band, cols);
+      if (start >= end) continue;
+#if CONFIG_VP9_HIGHBITDEPTH
+      if (band_data->use_highbitdepth) {
+        ok &= vp9_highbd_resize_plane_cols(
+            (const uint16_t *)band_data->intbuf[i], band_data->src_height[i],
+            cols, band_data->dst[i], band_data->dst_height[i],
+            band_data->dst_stride[i], start, end, band_data->bd);
+        continue;
+      }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+      ok &= vp9_resize_plane_cols(band_data->intbuf[i],
+                                  band_data->src_height[i], cols,
+                                  band_data->dst[i], band_data->dst_height[i],
+                                  band_data->dst_stride[i], start, end);
+    }
+  }
+  band_data->ok[t] = ok;
+  return ok;
+}
+
+void vp9_scale_and_extend_frame_nonnormative_mt(VP9_COMP *cpi,
+                                                const YV12_BUFFER_CONFIG *src,
+                                                YV12_BUFFER_CONFIG *dst) {
+  ResizeBandData band_data;
+  const int num_workers = VPXMIN(cpi->num_workers, src->uv_crop_height);
+  size_t pel_size = 1;
+  int ok = 1;
+  int i;
+
+  if (num_workers <= 1) {
+#if CONFIG_VP9_HIGHBITDEPTH
+    vp9_scale_and_extend_frame_nonnormative(src, dst,
+                                            (int)cpi->common.bit_depth);
+#else
+    vp9_scale_and_extend_frame_nonnormative(src, dst);
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+    return;
+  }
+
+  band_data.src[0] = src->y_buffer;
+  band_data.src[1] = src->u_buffer;
+  band_data.src[2] = src->v_buffer;
+  band_data.dst[0] = dst->y_buffer;
+  band_data.dst[1] = dst->u_buffer;
+  band_data.dst[2] = dst->v_buffer;
+  for (i = 0; i < MAX_MB_PLANE; ++i) {
+    const int is_uv = i > 0;
+    band_data.src_stride[i] = is_uv ? src->uv_stride : src->y_stride;
+    band_data.src_width[i] = is_uv ? src->uv_crop_width : src->y_crop_width;
+    band_data.src_height[i] = is_uv ? src->uv_crop_height : src->y_crop_height;
+    band_data.dst_stride[i] = is_uv ? dst->uv_stride : dst->y_stride;
+    band_data.dst_width[i] = is_uv ? dst->uv_crop_width : dst->y_crop_width;
+    band_data.dst_height[i] = is_uv ? dst->uv_crop_height : dst->y_crop_height;
+  }
+  band_data.use_highbitdepth = 0;
+  band_data.bd = (int)cpi->common.bit_depth;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+    band_data.use_highbitdepth = 1;
+    pel_size = sizeof(uint16_t);
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  band_data.num_workers = num_workers;
+
+  for (i = 0; i < MAX_MB_PLANE; ++i) {
+    band_data.intbuf[i] = (uint8_t *)vpx_malloc(
+        pel_size * band_data.dst_width[i] * band_data.src_height[i]);
+    ok &= band_data.intbuf[i] != NULL;
+  }
+
+  // Every row must be resized before any column is, so the two passes are
+  // separate launches.
+  if (ok) {
+    band_data.cols_pass = 0;
+    launch_enc_workers(cpi, resize_worker_hook, &band_data, num_workers);
+    for (i = 0; i < num_workers; ++i) ok &= band_data.ok[i];
+  }
+  if (ok) {
+    band_data.cols_pass = 1;
+    launch_enc_workers(cpi, resize_worker_hook, &band_data, num_workers);
+  }
+
+  for (i = 0; i < MAX_MB_PLANE; ++i) vpx_free(band_data.intbuf[i]);
+  vpx_extend_frame_borders(dst);
+}
+
+typedef struct ScaleBandData {
+  const YV12_BUFFER_CONFIG *src;
+  YV12_BUFFER_CONFIG *dst;
+  INTERP_FILTER filter_type;
+  int phase_scaler;
+  int num_workers;
+} ScaleBandData;
+
+static int scale_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  ScaleBandData *const band_data = (ScaleBandData *)arg2;
+  const int rows = (band_data->dst->y_crop_height + 15) >> 4;
+  const int t = thread_data->start;
+  const int n = band_data->num_workers;
+  vp9_scale_frame_rows(band_data->src, band_data->dst, band_data->filter_type,
+                       band_data->phase_scaler, rows * t / n,
+                       rows * (t + 1) / n);
+  return 1;
+}
+
+void vp9_scale_and_extend_frame_mt(VP9_COMP *cpi,
+                                   const YV12_BUFFER_CONFIG *src,
+                                   YV12_BUFFER_CONFIG *dst,
+                                   INTERP_FILTER filter_type,
+                                   int phase_scaler) {
+  ScaleBandData band_data;
+  const int num_workers =
+      VPXMIN(cpi->num_workers, (dst->y_crop_height + 15) >> 4);
+
+  if (num_workers <= 1 ||
+      !vp9_scale_frame_is_general(src, dst, phase_scaler)) {
+    vp9_scale_and_extend_frame(src, dst, filter_type, phase_scaler);
+    return;
+  }
+
+  band_data.src = src;
+  band_data.dst = dst;
+  band_data.filter_type = filter_type;
+  band_data.phase_scaler = phase_scaler;
+  band_data.num_workers = num_workers;
+  launch_enc_workers(cpi, scale_worker_hook, &band_data, num_workers);
+  vpx_extend_frame_borders(dst);
+}
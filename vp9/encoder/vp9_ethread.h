@@ -11,6 +11,8 @@
 #ifndef VPX_VP9_ENCODER_VP9_ETHREAD_H_
 #define VPX_VP9_ENCODER_VP9_ETHREAD_H_
 
+#include "vp9/common/vp9_filter.h"
+#include "vpx_dsp/psnr.h"
 #include "vpx_util/vpx_pthread.h"
 
 #ifdef __cplusplus
@@ -22,6 +24,7 @@ extern "C" {
 #define MAX_NUM_THREADS 64
 
 struct VP9_COMP;
+struct VP9Common;
 struct ThreadData;
 
 typedef struct EncWorkerData {
@@ -72,6 +75,35 @@ void vp9_row_mt_sync_mem_dealloc(VP9RowMTSync *row_mt_sync);
 
 void vp9_temporal_filter_row_mt(struct VP9_COMP *cpi);
 
+void vp9_mc_flow_dispenser_row_mt(struct VP9_COMP *cpi);
+
+void vp9_update_mbgraph_stats_row_mt(struct VP9_COMP *cpi, int n_frames,
+                                     YV12_BUFFER_CONFIG *golden_ref);
+
+// Computes the PSNR of |a| against |b| in row bands spread over the encoder
+// workers created for the current frame. Falls back to a single pass on the
+// calling thread if there are none.
+void vp9_calc_psnr_mt(struct VP9_COMP *cpi, const YV12_BUFFER_CONFIG *a,
+                      const YV12_BUFFER_CONFIG *b, PSNR_STATS *psnr,
+                      uint32_t bit_depth, uint32_t in_bit_depth);
+
+// Scales |src| into |dst| like vp9_scale_and_extend_frame_nonnormative(),
+// resizing row bands and then column bands of each plane on the encoder
+// workers created for the current frame. Falls back to the single threaded
+// version if there are none.
+void vp9_scale_and_extend_frame_nonnormative_mt(struct VP9_COMP *cpi,
+                                                const YV12_BUFFER_CONFIG *src,
+                                                YV12_BUFFER_CONFIG *dst);
+
+// Same as vp9_scale_and_extend_frame(), except that ratios without a
+// dedicated SIMD path are scaled in bands of block rows on the encoder
+// workers created for the current frame.
+void vp9_scale_and_extend_frame_mt(struct VP9_COMP *cpi,
+                                   const YV12_BUFFER_CONFIG *src,
+                                   YV12_BUFFER_CONFIG *dst,
+                                   INTERP_FILTER filter_type,
+                                   int phase_scaler);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
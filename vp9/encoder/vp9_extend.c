@@ -31,7 +31,9 @@ static void copy_and_extend_plane(const uint8_t *src, int src_pitch,
 
   for (i = 0; i < h; i++) {
     memset(dst_ptr1, src_ptr1[0], extend_left);
-    if (step == 1) {
+    if (src == dst) {
+      // Extending in place; the visible pixels are already there.
+    } else if (step == 1) {
       memcpy(dst_ptr1 + extend_left, src_ptr1, w);
     } else {
       for (j = 0; j < w; j++) {
@@ -81,7 +83,8 @@ static void highbd_copy_and_extend_plane(const uint8_t *src8, int src_pitch,
 
   for (i = 0; i < h; i++) {
     vpx_memset16(dst_ptr1, src_ptr1[0], extend_left);
-    memcpy(dst_ptr1 + extend_left, src_ptr1, w * sizeof(src_ptr1[0]));
+    if (src != dst)
+      memcpy(dst_ptr1 + extend_left, src_ptr1, w * sizeof(src_ptr1[0]));
     vpx_memset16(dst_ptr2, src_ptr2[0], extend_right);
     src_ptr1 += src_pitch;
     src_ptr2 += src_pitch;
@@ -162,3 +165,7 @@ void vp9_copy_and_extend_frame(const YV12_BUFFER_CONFIG *src,
                         dst->uv_stride, src->uv_crop_width, src->uv_crop_height,
                         et_uv, el_uv, eb_uv, er_uv, chroma_step);
 }
+
+void vp9_extend_frame_inplace(YV12_BUFFER_CONFIG *ybf) {
+  vp9_copy_and_extend_frame(ybf, ybf);
+}
@@ -21,6 +21,10 @@ extern "C" {
 void vp9_copy_and_extend_frame(const YV12_BUFFER_CONFIG *src,
                                YV12_BUFFER_CONFIG *dst);
 
+// Extends the borders of |ybf| the same way vp9_copy_and_extend_frame() does,
+// without copying the visible area.
+void vp9_extend_frame_inplace(YV12_BUFFER_CONFIG *ybf);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
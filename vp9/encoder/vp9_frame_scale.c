@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <assert.h>
+
 #include "./vp9_rtcd.h"
 #include "./vpx_config.h"
 #include "./vpx_dsp_rtcd.h"
@@ -15,21 +17,224 @@
 #include "vp9/common/vp9_blockd.h"
 #include "vp9/encoder/vp9_encoder.h"
 #include "vpx/vpx_codec.h"
+#include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_dsp/vpx_filter.h"
+#include "vpx_mem/vpx_mem.h"
 #include "vpx_scale/yv12config.h"
 
+void vp9_scale_filter_horiz_c(const uint8_t *src, int src_stride,
+                              const int *x_offsets,
+                              const int16_t *const *x_filters, uint8_t *dst,
+                              int dst_stride, int w, int h) {
+  int x, y, k;
+  for (y = 0; y < h; ++y) {
+    for (x = 0; x < w; ++x) {
+      const uint8_t *const src_x = src + x_offsets[x];
+      const int16_t *const x_filter = x_filters[x];
+      int sum = 0;
+      for (k = 0; k < SUBPEL_TAPS; ++k) sum += src_x[k] * x_filter[k];
+      dst[x] = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
+    }
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
+
+// Scales block rows [row_start, row_end) of one plane with a vpx_scaled_2d()
+// call per block.
+static void scale_plane_blocks(const YV12_BUFFER_CONFIG *src,
+                               YV12_BUFFER_CONFIG *dst, int plane,
+                               const InterpKernel *kernel, int phase_scaler,
+                               int row_start, int row_end) {
+  const int src_w = src->y_crop_width;
+  const int src_h = src->y_crop_height;
+  const int dst_w = dst->y_crop_width;
+  const int dst_h = dst->y_crop_height;
+  const int factor = (plane == 0 ? 1 : 2);
+  const int src_stride = plane == 0 ? src->y_stride : src->uv_stride;
+  const int dst_stride = plane == 0 ? dst->y_stride : dst->uv_stride;
+  const uint8_t *const src_buf =
+      plane == 0 ? src->y_buffer : (plane == 1 ? src->u_buffer : src->v_buffer);
+  uint8_t *const dst_buf =
+      plane == 0 ? dst->y_buffer : (plane == 1 ? dst->u_buffer : dst->v_buffer);
+  int x, y;
+
+  for (y = row_start * 16; y < row_end * 16; y += 16) {
+    const int y_q4 = y * (16 / factor) * src_h / dst_h + phase_scaler;
+    for (x = 0; x < dst_w; x += 16) {
+      const int x_q4 = x * (16 / factor) * src_w / dst_w + phase_scaler;
+      const uint8_t *src_ptr = src_buf +
+                               (y / factor) * src_h / dst_h * src_stride +
+                               (x / factor) * src_w / dst_w;
+      uint8_t *dst_ptr = dst_buf + (y / factor) * dst_stride + (x / factor);
+
+      vpx_scaled_2d(src_ptr, src_stride, dst_ptr, dst_stride, kernel,
+                    x_q4 & 0xf, 16 * src_w / dst_w, y_q4 & 0xf,
+                    16 * src_h / dst_h, 16 / factor, 16 / factor);
+    }
+  }
+}
+
+// Number of output rows whose source rows are filtered horizontally together.
+#define SCALE_SLAB_ROWS 64
+
+// Returns the first source row read by the block row starting at output row
+// y0, and sets *y0_q4 to the phase of its first output row.
+static INLINE int block_row_source(int y0, int src_h, int dst_h,
+                                   int phase_scaler, int *y0_q4) {
+  *y0_q4 = (y0 * 16 * src_h / dst_h + phase_scaler) & SUBPEL_MASK;
+  return y0 * src_h / dst_h - (SUBPEL_TAPS / 2 - 1);
+}
+
+// Gives the same result as scale_plane_blocks(), but filters the source rows
+// of a slab of block rows horizontally in one pass across the plane, then
+// filters each output row vertically. Only the pels inside the crop area are
+// written, the rest is overwritten by vpx_extend_frame_borders() anyway.
+// Returns 0 if the buffers can't be allocated.
+static int scale_plane_rows(const YV12_BUFFER_CONFIG *src,
+                            YV12_BUFFER_CONFIG *dst, int plane,
+                            const InterpKernel *kernel, int phase_scaler,
+                            int row_start, int row_end) {
+  const int src_w = src->y_crop_width;
+  const int src_h = src->y_crop_height;
+  const int dst_w = dst->y_crop_width;
+  const int dst_h = dst->y_crop_height;
+  const int x_step_q4 = 16 * src_w / dst_w;
+  const int y_step_q4 = 16 * src_h / dst_h;
+  // The chroma planes are always scaled in 8x8 blocks.
+  const int bs = plane == 0 ? 16 : 8;
+  const int slab = SCALE_SLAB_ROWS / bs;
+  const int src_stride = plane == 0 ? src->y_stride : src->uv_stride;
+  const int dst_stride = plane == 0 ? dst->y_stride : dst->uv_stride;
+  const uint8_t *const src_buf =
+      plane == 0 ? src->y_buffer : (plane == 1 ? src->u_buffer : src->v_buffer);
+  uint8_t *const dst_buf =
+      plane == 0 ? dst->y_buffer : (plane == 1 ? dst->u_buffer : dst->v_buffer);
+  const int w = VPXMIN(plane == 0 ? dst_w : dst->uv_crop_width,
+                       ((dst_w + 15) >> 4) * bs);
+  const int h = VPXMIN(plane == 0 ? dst_h : dst->uv_crop_height,
+                       ((dst_h + 15) >> 4) * bs);
+  const int block_rows = VPXMIN(row_end, (h + bs - 1) / bs);
+  const int buf_stride = (w + 31) & ~31;
+  // The first source rows of the block rows of a slab are at most this many
+  // rows apart, plus the rows a single block row reads.
+  const int buf_rows =
+      ((slab - 1) * bs * src_h + dst_h - 1) / dst_h +
+      (((bs - 1) * y_step_q4 + SUBPEL_MASK) >> SUBPEL_BITS) + SUBPEL_TAPS;
+  int *const x_offsets = (int *)vpx_malloc(w * sizeof(*x_offsets));
+  const int16_t **const x_filters =
+      (const int16_t **)vpx_malloc(w * sizeof(*x_filters));
+  uint8_t *const buf = (uint8_t *)vpx_malloc(buf_stride * buf_rows);
+  int x, y, by, b;
+
+  if (!x_offsets || !x_filters || !buf) {
+    vpx_free(x_offsets);
+    vpx_free(x_filters);
+    vpx_free(buf);
+    return 0;
+  }
+
+  for (x = 0; x < w; ++x) {
+    const int x0 = x - x % bs;
+    const int pos = ((x0 * 16 * src_w / dst_w + phase_scaler) & SUBPEL_MASK) +
+                    (x - x0) * x_step_q4;
+    x_offsets[x] = x0 * src_w / dst_w + (pos >> SUBPEL_BITS) -
+                   (SUBPEL_TAPS / 2 - 1);
+    x_filters[x] = kernel[pos & SUBPEL_MASK];
+  }
+
+  for (by = row_start; by < block_rows; by += slab) {
+    const int slab_end = VPXMIN(by + slab, block_rows);
+    int y0_q4;
+    const int first =
+        block_row_source(by * bs, src_h, dst_h, phase_scaler, &y0_q4);
+    int last = first;
+    for (b = by; b < slab_end; ++b) {
+      const int rows = VPXMIN(bs, h - b * bs);
+      const int row =
+          block_row_source(b * bs, src_h, dst_h, phase_scaler, &y0_q4);
+      const int height =
+          (((rows - 1) * y_step_q4 + y0_q4) >> SUBPEL_BITS) + SUBPEL_TAPS;
+      last = VPXMAX(last, row + height);
+    }
+    assert(last - first <= buf_rows);
+
+    vp9_scale_filter_horiz(src_buf + first * src_stride, src_stride,
+                           x_offsets, x_filters, buf, buf_stride, w,
+                           last - first);
+    for (b = by; b < slab_end; ++b) {
+      const int rows = VPXMIN(bs, h - b * bs);
+      const int row =
+          block_row_source(b * bs, src_h, dst_h, phase_scaler, &y0_q4);
+      const uint8_t *const block_buf = buf + (row - first) * buf_stride;
+      for (y = 0; y < rows; ++y) {
+        const int y_q4 = y0_q4 + y * y_step_q4;
+        const uint8_t *taps[SUBPEL_TAPS];
+        int k;
+        for (k = 0; k < SUBPEL_TAPS; ++k)
+          taps[k] = block_buf + ((y_q4 >> SUBPEL_BITS) + k) * buf_stride;
+        vp9_resize_filter_rows(taps, kernel[y_q4 & SUBPEL_MASK],
+                               dst_buf + (b * bs + y) * dst_stride, w);
+      }
+    }
+  }
+
+  vpx_free(x_offsets);
+  vpx_free(x_filters);
+  vpx_free(buf);
+  return 1;
+}
+
+// Returns 1 if scale_plane_rows() is faster than scale_plane_blocks() for
+// this ratio. Past 2:1 the horizontal step needs two loads per half of a
+// vpx_scaled_2d() block, which the per-block SIMD handles better than the
+// gathers of vp9_scale_filter_horiz().
+static int scale_frame_uses_slabs(const YV12_BUFFER_CONFIG *src,
+                                  const YV12_BUFFER_CONFIG *dst) {
+  return 16 * src->y_crop_width / dst->y_crop_width <= 32;
+}
+
+void vp9_scale_frame_rows(const YV12_BUFFER_CONFIG *src,
+                          YV12_BUFFER_CONFIG *dst, INTERP_FILTER filter_type,
+                          int phase_scaler, int row_start, int row_end) {
+  const InterpKernel *const kernel = vp9_filter_kernels[filter_type];
+  const int use_slabs = scale_frame_uses_slabs(src, dst);
+  int i;
+  for (i = 0; i < MAX_MB_PLANE; ++i) {
+    if (!use_slabs || !scale_plane_rows(src, dst, i, kernel, phase_scaler,
+                                        row_start, row_end)) {
+      scale_plane_blocks(src, dst, i, kernel, phase_scaler, row_start,
+                         row_end);
+    }
+  }
+}
+
+int vp9_scale_frame_is_general(const YV12_BUFFER_CONFIG *src,
+                               const YV12_BUFFER_CONFIG *dst,
+                               int phase_scaler) {
+  const int src_w = src->y_crop_width;
+  const int src_h = src->y_crop_height;
+  const int dst_w = dst->y_crop_width;
+  const int dst_h = dst->y_crop_height;
+#if HAVE_SSSE3 || HAVE_NEON
+  if ((2 * dst_w == src_w && 2 * dst_h == src_h) ||
+      (4 * dst_w == src_w && 4 * dst_h == src_h) ||
+      (4 * dst_w == 3 * src_w && 4 * dst_h == 3 * src_h))
+    return 0;
+#endif
+#if HAVE_SSSE3
+  if (dst_w == 2 * src_w && dst_h == 2 * src_h && phase_scaler == 0) return 0;
+#else
+  (void)phase_scaler;
+#endif
+  return 16 * src_w / dst_w <= 64 && 16 * src_h / dst_h <= 64;
+}
+
 void vp9_scale_and_extend_frame_c(const YV12_BUFFER_CONFIG *src,
                                   YV12_BUFFER_CONFIG *dst,
                                   INTERP_FILTER filter_type, int phase_scaler) {
   const int src_w = src->y_crop_width;
   const int src_h = src->y_crop_height;
-  const uint8_t *const srcs[3] = { src->y_buffer, src->u_buffer,
-                                   src->v_buffer };
-  const int src_strides[3] = { src->y_stride, src->uv_stride, src->uv_stride };
-  uint8_t *const dsts[3] = { dst->y_buffer, dst->u_buffer, dst->v_buffer };
-  const int dst_strides[3] = { dst->y_stride, dst->uv_stride, dst->uv_stride };
-  const InterpKernel *const kernel = vp9_filter_kernels[filter_type];
-  int x, y, i;
 
 #if HAVE_SSSE3 || HAVE_NEON
   // TODO(linfengz): The 4:3 specialized C code is disabled by default since
@@ -69,10 +274,19 @@ void vp9_scale_and_extend_frame_c(const YV12_BUFFER_CONFIG *src,
     //                                     |
     //      X     O S   O   S O     X      |      O     O     O     O     O
 
+    const uint8_t *const srcs[3] = { src->y_buffer, src->u_buffer,
+                                     src->v_buffer };
+    const int src_strides[3] = { src->y_stride, src->uv_stride,
+                                 src->uv_stride };
+    uint8_t *const dsts[3] = { dst->y_buffer, dst->u_buffer, dst->v_buffer };
+    const int dst_strides[3] = { dst->y_stride, dst->uv_stride,
+                                 dst->uv_stride };
     const int dst_ws[3] = { dst->y_crop_width, dst->uv_crop_width,
                             dst->uv_crop_width };
     const int dst_hs[3] = { dst->y_crop_height, dst->uv_crop_height,
                             dst->uv_crop_height };
+    const InterpKernel *const kernel = vp9_filter_kernels[filter_type];
+    int x, y, i;
     for (i = 0; i < MAX_MB_PLANE; ++i) {
       const int dst_w = dst_ws[i];
       const int dst_h = dst_hs[i];
@@ -111,25 +325,8 @@ void vp9_scale_and_extend_frame_c(const YV12_BUFFER_CONFIG *src,
       return;
     }
 
-    for (i = 0; i < MAX_MB_PLANE; ++i) {
-      const int factor = (i == 0 || i == 3 ? 1 : 2);
-      const int src_stride = src_strides[i];
-      const int dst_stride = dst_strides[i];
-      for (y = 0; y < dst_h; y += 16) {
-        const int y_q4 = y * (16 / factor) * src_h / dst_h + phase_scaler;
-        for (x = 0; x < dst_w; x += 16) {
-          const int x_q4 = x * (16 / factor) * src_w / dst_w + phase_scaler;
-          const uint8_t *src_ptr = srcs[i] +
-                                   (y / factor) * src_h / dst_h * src_stride +
-                                   (x / factor) * src_w / dst_w;
-          uint8_t *dst_ptr = dsts[i] + (y / factor) * dst_stride + (x / factor);
-
-          vpx_scaled_2d(src_ptr, src_stride, dst_ptr, dst_stride, kernel,
-                        x_q4 & 0xf, 16 * src_w / dst_w, y_q4 & 0xf,
-                        16 * src_h / dst_h, 16 / factor, 16 / factor);
-        }
-      }
-    }
+    vp9_scale_frame_rows(src, dst, filter_type, phase_scaler, 0,
+                         (dst_h + 15) >> 4);
   }
 
   vpx_extend_frame_borders(dst);
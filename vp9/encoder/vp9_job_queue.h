@@ -15,6 +15,8 @@ typedef enum {
   FIRST_PASS_JOB,
   ENCODE_JOB,
   ARNR_JOB,
+  TPL_JOB,
+  MBGRAPH_JOB,
   NUM_JOB_TYPES,
 } JOB_TYPE;
 
@@ -30,12 +30,24 @@ static struct lookahead_entry *pop(struct lookahead_ctx *ctx, int *idx) {
   return buf;
 }
 
+/* Hand a caller-owned frame back and restore the entry's own buffer */
+static void release_entry(struct lookahead_entry *buf) {
+  if (buf->external) {
+    buf->img = buf->own_img;
+    buf->external = 0;
+    buf->release.release_cb(buf->release.cb_priv, &buf->ext_img);
+  }
+}
+
 void vp9_lookahead_destroy(struct lookahead_ctx *ctx) {
   if (ctx) {
     if (ctx->buf) {
       int i;
 
-      for (i = 0; i < ctx->max_sz; i++) vpx_free_frame_buffer(&ctx->buf[i].img);
+      for (i = 0; i < ctx->max_sz; i++) {
+        release_entry(&ctx->buf[i]);
+        vpx_free_frame_buffer(&ctx->buf[i].img);
+      }
       free(ctx->buf);
     }
     free(ctx);
@@ -109,6 +121,7 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
   if (vp9_lookahead_full(ctx)) return 1;
   ctx->sz++;
   buf = pop(ctx, &ctx->write_idx);
+  release_entry(buf);
 
   new_dimensions = width != buf->img.y_crop_width ||
                    height != buf->img.y_crop_height ||
@@ -153,6 +166,93 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
   return 0;
 }
 
+/* Whether |src| is laid out like the lookahead's own buffers. Other parts of
+ * the encoder, e.g. the temporal filter, assume all source frames share the
+ * stride of a buffer allocated with VP9_ENC_BORDER_IN_PIXELS. */
+static int can_reference(const YV12_BUFFER_CONFIG *src) {
+  const int aligned_width = (src->y_crop_width + 7) & ~7;
+  const int y_stride =
+      ((aligned_width + 2 * VP9_ENC_BORDER_IN_PIXELS) + 31) & ~31;
+  // Interleaved chroma has to be split into planes by the copy.
+  if (src->v_buffer - src->u_buffer == 1) return 0;
+  return src->y_stride == y_stride &&
+         src->uv_stride == y_stride >> src->subsampling_x;
+}
+
+int vp9_lookahead_push_external(struct lookahead_ctx *ctx,
+                                YV12_BUFFER_CONFIG *src,
+                                const vpx_image_t *ext_img,
+                                const vpx_source_release_cb_t *release,
+                                int64_t ts_start, int64_t ts_end,
+                                int use_highbitdepth,
+                                vpx_enc_frame_flags_t flags) {
+  struct lookahead_entry *buf;
+  YV12_BUFFER_CONFIG *img;
+  int new_dimensions, larger_dimensions;
+
+  if (!can_reference(src) || vp9_lookahead_full(ctx)) {
+    const int res = vp9_lookahead_push(ctx, src, ts_start, ts_end,
+                                       use_highbitdepth, flags);
+    release->release_cb(release->cb_priv, ext_img);
+    return res;
+  }
+  ctx->sz++;
+  buf = pop(ctx, &ctx->write_idx);
+  release_entry(buf);
+
+  // Extend before the geometry below is applied so the border matches what
+  // vp9_copy_and_extend_frame() would have produced.
+  vp9_extend_frame_inplace(src);
+
+  // Give the frame the geometry vp9_lookahead_push() would have left in this
+  // entry, without reallocating the entry's own buffer.
+  buf->own_img = buf->img;
+  img = &buf->img;
+  new_dimensions = src->y_crop_width != img->y_crop_width ||
+                   src->y_crop_height != img->y_crop_height ||
+                   src->uv_crop_width != img->uv_crop_width ||
+                   src->uv_crop_height != img->uv_crop_height;
+  larger_dimensions = src->y_crop_width > img->y_crop_width ||
+                      src->y_crop_height > img->y_crop_height ||
+                      src->uv_crop_width > img->uv_crop_width ||
+                      src->uv_crop_height > img->uv_crop_height;
+  if (larger_dimensions) {
+    const int aligned_width = (src->y_crop_width + 7) & ~7;
+    const int aligned_height = (src->y_crop_height + 7) & ~7;
+    img->y_width = aligned_width;
+    img->y_height = aligned_height;
+    img->uv_width = aligned_width >> src->subsampling_x;
+    img->uv_height = aligned_height >> src->subsampling_y;
+  } else if (new_dimensions) {
+    img->y_width = src->y_width;
+    img->y_height = src->y_height;
+    img->uv_width = src->uv_width;
+    img->uv_height = src->uv_height;
+  }
+  img->y_crop_width = src->y_crop_width;
+  img->y_crop_height = src->y_crop_height;
+  img->uv_crop_width = src->uv_crop_width;
+  img->uv_crop_height = src->uv_crop_height;
+  img->subsampling_x = src->subsampling_x;
+  img->subsampling_y = src->subsampling_y;
+  img->y_buffer = src->y_buffer;
+  img->u_buffer = src->u_buffer;
+  img->v_buffer = src->v_buffer;
+  img->y_stride = src->y_stride;
+  img->uv_stride = src->uv_stride;
+  img->border = VP9_ENC_BORDER_IN_PIXELS;
+
+  buf->external = 1;
+  buf->ext_img = *ext_img;
+  buf->release = *release;
+  buf->ts_start = ts_start;
+  buf->ts_end = ts_end;
+  buf->flags = flags;
+  buf->show_idx = ctx->next_show_idx;
+  ++ctx->next_show_idx;
+  return 0;
+}
+
 struct lookahead_entry *vp9_lookahead_pop(struct lookahead_ctx *ctx,
                                           int drain) {
   struct lookahead_entry *buf = NULL;
@@ -160,6 +260,14 @@ struct lookahead_entry *vp9_lookahead_pop(struct lookahead_ctx *ctx,
   if (ctx && ctx->sz && (drain || ctx->sz == ctx->max_sz - MAX_PRE_FRAMES)) {
     buf = pop(ctx, &ctx->read_idx);
     ctx->sz--;
+    // The frame popped before the previous one is no longer referenced as
+    // either the source or the last source. Only release it here if its slot
+    // has not already been taken back by the queue.
+    if (ctx->max_sz - ctx->sz > MAX_PRE_FRAMES + 1) {
+      int index = ctx->read_idx - (MAX_PRE_FRAMES + 2);
+      if (index < 0) index += ctx->max_sz;
+      release_entry(ctx->buf + index);
+    }
   }
   return buf;
 }
@@ -12,6 +12,7 @@
 #define VPX_VP9_ENCODER_VP9_LOOKAHEAD_H_
 
 #include "vpx_scale/yv12config.h"
+#include "vpx/vp8cx.h"
 #include "vpx/vpx_encoder.h"
 #include "vpx/vpx_integer.h"
 
@@ -27,6 +28,12 @@ struct lookahead_entry {
   int64_t ts_end;
   int show_idx; /*The show_idx of this frame*/
   vpx_enc_frame_flags_t flags;
+  // Set while |img| references a caller-owned frame. The entry's own buffer
+  // is kept in |own_img| until |ext_img| is handed back through |release|.
+  int external;
+  YV12_BUFFER_CONFIG own_img;
+  vpx_image_t ext_img;
+  vpx_source_release_cb_t release;
 };
 
 // The max of past frames we want to keep in the queue.
@@ -92,6 +99,30 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
                        int64_t ts_start, int64_t ts_end, int use_highbitdepth,
                        vpx_enc_frame_flags_t flags);
 
+/**\brief Enqueue a caller-owned source buffer without copying it
+ *
+ * The entry references the planes of \p src directly, after extending its
+ * borders in place, and hands \p ext_img back through \p release once the
+ * encoder no longer needs it. Frames whose stride or chroma layout differs
+ * from the lookahead's own buffers are copied as in vp9_lookahead_push() and
+ * released before this function returns.
+ *
+ * \param[in] ctx         Pointer to the lookahead context
+ * \param[in] src         Pointer to the image to enqueue
+ * \param[in] ext_img     Caller image \p src was converted from
+ * \param[in] release     Callback that returns \p ext_img to the caller
+ * \param[in] ts_start    Timestamp for the start of this frame
+ * \param[in] ts_end      Timestamp for the end of this frame
+ * \param[in] flags       Flags set on this frame
+ */
+int vp9_lookahead_push_external(struct lookahead_ctx *ctx,
+                                YV12_BUFFER_CONFIG *src,
+                                const vpx_image_t *ext_img,
+                                const vpx_source_release_cb_t *release,
+                                int64_t ts_start, int64_t ts_end,
+                                int use_highbitdepth,
+                                vpx_enc_frame_flags_t flags);
+
 /**\brief Get the next source buffer to encode
  *
  *
@@ -30,9 +30,21 @@ typedef struct {
 } MBGRAPH_FRAME_STATS;
 
 struct VP9_COMP;
+struct ThreadData;
+struct VP9RowMTSyncData;
 
 void vp9_update_mbgraph_stats(struct VP9_COMP *cpi);
 
+// Fills in the stats of one macroblock row of |buf|. With |row_mt_sync| set,
+// waits for the first block of the row above, which seeds the golden frame
+// search, and signals once the first block of this row is done.
+void vp9_update_mbgraph_mb_row(struct VP9_COMP *cpi, struct ThreadData *td,
+                               MBGRAPH_FRAME_STATS *stats,
+                               YV12_BUFFER_CONFIG *buf,
+                               YV12_BUFFER_CONFIG *golden_ref,
+                               YV12_BUFFER_CONFIG *alt_ref, int mb_row,
+                               struct VP9RowMTSyncData *row_mt_sync);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
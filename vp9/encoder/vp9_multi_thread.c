@@ -239,17 +239,25 @@ void vp9_prepare_job_queue(VP9_COMP *cpi, JOB_TYPE job_type) {
   VP9_COMMON *const cm = &cpi->common;
   MultiThreadHandle *multi_thread_ctxt = &cpi->multi_thread_ctxt;
   JobQueue *job_queue = multi_thread_ctxt->job_queue;
-  const int tile_cols = 1 << cm->log2_tile_cols;
+  // mbgraph rows span the whole frame width.
+  const int tile_cols = job_type == MBGRAPH_JOB ? 1 : 1 << cm->log2_tile_cols;
   int job_row_num, jobs_per_tile, jobs_per_tile_col = 0, total_jobs;
   const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
   int tile_col, i;
 
   switch (job_type) {
     case ENCODE_JOB: jobs_per_tile_col = sb_rows; break;
-    case FIRST_PASS_JOB: jobs_per_tile_col = cm->mb_rows; break;
+    case FIRST_PASS_JOB:
+    case MBGRAPH_JOB: jobs_per_tile_col = cm->mb_rows; break;
     case ARNR_JOB:
       jobs_per_tile_col = ((cm->mi_rows + TF_ROUND) >> TF_SHIFT);
       break;
+    case TPL_JOB: {
+      const int mi_height =
+          num_8x8_blocks_high_lookup[cpi->tpl_mc_flow_data.bsize];
+      jobs_per_tile_col = (cm->mi_rows + mi_height - 1) / mi_height;
+      break;
+    }
     default: assert(0);
   }
 
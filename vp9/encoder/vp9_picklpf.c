@@ -43,6 +43,17 @@ static int get_max_filter_level(const VP9_COMP *cpi) {
   }
 }
 
+static int64_t get_filter_error(const VP9_COMMON *cm,
+                                const YV12_BUFFER_CONFIG *sd,
+                                const YV12_BUFFER_CONFIG *filtered) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (cm->use_highbitdepth) return vpx_highbd_get_y_sse(sd, filtered);
+#else
+  (void)cm;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  return vpx_get_y_sse(sd, filtered);
+}
+
 static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
                                 VP9_COMP *const cpi, int filt_level,
                                 int partial_frame) {
@@ -59,15 +70,7 @@ static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
     vp9_loop_filter_frame(cm->frame_to_show, cm, &cpi->td.mb.e_mbd, filt_level,
                           1, partial_frame);
 
-#if CONFIG_VP9_HIGHBITDEPTH
-  if (cm->use_highbitdepth) {
-    filt_err = vpx_highbd_get_y_sse(sd, cm->frame_to_show);
-  } else {
-    filt_err = vpx_get_y_sse(sd, cm->frame_to_show);
-  }
-#else
-  filt_err = vpx_get_y_sse(sd, cm->frame_to_show);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
+  filt_err = get_filter_error(cm, sd, cm->frame_to_show);
 
   // Re-instate the unfiltered frame
   vpx_yv12_copy_y(&cpi->last_frame_uf, cm->frame_to_show);
@@ -75,6 +78,124 @@ static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
   return filt_err;
 }
 
+typedef struct LpfTrialData {
+  const VP9_COMMON *cm;
+  const YV12_BUFFER_CONFIG *sd;
+  YV12_BUFFER_CONFIG *frame;
+  const YV12_BUFFER_CONFIG *unfiltered;
+  int64_t filt_err;
+} LpfTrialData;
+
+// Measures the error of a filtered trial frame and re-instates the unfiltered
+// frame for the next trial.
+static int lpf_trial_error_worker(void *arg1, void *unused) {
+  LpfTrialData *const trial = (LpfTrialData *)arg1;
+  (void)unused;
+  trial->filt_err = get_filter_error(trial->cm, trial->sd, trial->frame);
+  vpx_yv12_copy_y(trial->unfiltered, trial->frame);
+  return 1;
+}
+
+static void alloc_lpf_trial_buffers(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  const int lfm_size = ((cm->mi_rows + (MI_BLOCK_SIZE - 1)) >> 3) *
+                       cm->lf.lfm_stride;
+
+  if (vpx_realloc_frame_buffer(&cpi->lpf_trial_frame, cm->width, cm->height,
+                               cm->subsampling_x, cm->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+                               cm->use_highbitdepth,
+#endif
+                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               NULL, NULL, NULL))
+    vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                       "Failed to allocate loop filter trial buffer");
+
+  if (cpi->lpf_trial_lfm_size < lfm_size) {
+    vpx_free(cpi->lpf_trial_lfm);
+    cpi->lpf_trial_lfm_size = 0;
+    CHECK_MEM_ERROR(&cm->error, cpi->lpf_trial_lfm,
+                    vpx_calloc(lfm_size, sizeof(*cpi->lpf_trial_lfm)));
+    cpi->lpf_trial_lfm_size = lfm_size;
+  }
+}
+
+// Computes the filter error of two levels at once. The first level is tried on
+// frame_to_show and the second on a scratch copy of it, each with its own
+// masks, and the workers are split between them. Both frames hold the
+// unfiltered reconstruction on entry and on return.
+static void try_filter_frame_pair(const YV12_BUFFER_CONFIG *sd,
+                                  VP9_COMP *const cpi, const int *filt_levels,
+                                  int partial_frame, int64_t *filt_errs) {
+  VP9_COMMON *const cm = &cpi->common;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VPxWorker *const worker = &cpi->workers[0];
+  LOOP_FILTER_MASK *const frame_lfm = cm->lf.lfm;
+  YV12_BUFFER_CONFIG *frames[MAX_LPF_FRAMES];
+  LOOP_FILTER_MASK *lfms[MAX_LPF_FRAMES];
+  VP9LfSync *lf_syncs[MAX_LPF_FRAMES];
+  LpfTrialData trials[MAX_LPF_FRAMES];
+  int num_filtered = 0;
+  int i;
+
+  trials[0].frame = cm->frame_to_show;
+  trials[1].frame = &cpi->lpf_trial_frame;
+  lfms[0] = frame_lfm;
+  lfms[1] = cpi->lpf_trial_lfm;
+  lf_syncs[0] = &cpi->lf_row_sync;
+  lf_syncs[1] = &cpi->lpf_trial_sync;
+
+  // The masks carry the per block filter level, so building them is the only
+  // level dependent step. It stays on this thread as it goes through cm->lf.
+  for (i = 0; i < MAX_LPF_FRAMES; ++i) {
+    if (!filt_levels[i]) continue;
+    cm->lf.lfm = lfms[i];
+    vp9_build_mask_frame(cm, filt_levels[i], partial_frame);
+    frames[num_filtered] = trials[i].frame;
+    lfms[num_filtered] = lfms[i];
+    lf_syncs[num_filtered] = lf_syncs[i];
+    ++num_filtered;
+  }
+  cm->lf.lfm = frame_lfm;
+
+  if (num_filtered > 0) {
+    vp9_loop_filter_frames_mt(frames, lfms, lf_syncs, num_filtered, cm,
+                              cpi->td.mb.e_mbd.plane, 1, partial_frame,
+                              cpi->workers, cpi->num_workers);
+  }
+
+  for (i = 0; i < MAX_LPF_FRAMES; ++i) {
+    trials[i].cm = cm;
+    trials[i].sd = sd;
+    trials[i].unfiltered = &cpi->last_frame_uf;
+  }
+  worker->hook = lpf_trial_error_worker;
+  worker->data1 = &trials[1];
+  worker->data2 = NULL;
+  winterface->launch(worker);
+  lpf_trial_error_worker(&trials[0], NULL);
+  winterface->sync(worker);
+
+  filt_errs[0] = trials[0].filt_err;
+  filt_errs[1] = trials[1].filt_err;
+}
+
+// Computes the filter error of each level in 'filt_levels'. When there are
+// workers to share, pairs of levels are tried concurrently; the errors are the
+// same as trying the levels one after another.
+static void try_filter_levels(const YV12_BUFFER_CONFIG *sd, VP9_COMP *const cpi,
+                              const int *filt_levels, int num_levels,
+                              int partial_frame, int64_t *filt_errs) {
+  if (num_levels == MAX_LPF_FRAMES && cpi->num_workers >= MAX_LPF_FRAMES) {
+    try_filter_frame_pair(sd, cpi, filt_levels, partial_frame, filt_errs);
+  } else {
+    int i;
+    for (i = 0; i < num_levels; ++i) {
+      filt_errs[i] = try_filter_frame(sd, cpi, filt_levels[i], partial_frame);
+    }
+  }
+}
+
 static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
                                int partial_frame) {
   const VP9_COMMON *const cm = &cpi->common;
@@ -98,6 +219,10 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
 
   //  Make a copy of the unfiltered / processed recon buffer
   vpx_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
+  if (cpi->num_workers >= MAX_LPF_FRAMES) {
+    alloc_lpf_trial_buffers(cpi);
+    vpx_yv12_copy_y(cm->frame_to_show, &cpi->lpf_trial_frame);
+  }
 
   best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame);
   filt_best = filt_mid;
@@ -116,11 +241,23 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
     // yx, bias less for large block size
     if (cm->tx_mode != ONLY_4X4) bias >>= 1;
 
+    // Whether a level is tried depends only on the direction and on the scores
+    // cached so far, so both neighbours can be scored before either is judged.
+    {
+      int levels[MAX_LPF_FRAMES];
+      int64_t errs[MAX_LPF_FRAMES];
+      int num_levels = 0;
+      int i;
+      if (filt_direction <= 0 && filt_low != filt_mid && ss_err[filt_low] < 0)
+        levels[num_levels++] = filt_low;
+      if (filt_direction >= 0 && filt_high != filt_mid &&
+          ss_err[filt_high] < 0)
+        levels[num_levels++] = filt_high;
+      try_filter_levels(sd, cpi, levels, num_levels, partial_frame, errs);
+      for (i = 0; i < num_levels; ++i) ss_err[levels[i]] = errs[i];
+    }
+
     if (filt_direction <= 0 && filt_low != filt_mid) {
-      // Get Low filter error score
-      if (ss_err[filt_low] < 0) {
-        ss_err[filt_low] = try_filter_frame(sd, cpi, filt_low, partial_frame);
-      }
       // If value is close to the best so far then bias towards a lower loop
       // filter value.
       if ((ss_err[filt_low] - bias) < best_err) {
@@ -133,9 +270,6 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
 
     // Now look at filt_high
     if (filt_direction >= 0 && filt_high != filt_mid) {
-      if (ss_err[filt_high] < 0) {
-        ss_err[filt_high] = try_filter_frame(sd, cpi, filt_high, partial_frame);
-      }
       // Was it better than the previous best?
       if (ss_err[filt_high] < (best_err - bias)) {
         best_err = ss_err[filt_high];
@@ -15,10 +15,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "./vp9_rtcd.h"
 #include "./vpx_config.h"
-#if CONFIG_VP9_HIGHBITDEPTH
 #include "vpx_dsp/vpx_dsp_common.h"
-#endif  // CONFIG_VP9_HIGHBITDEPTH
 #include "vpx_ports/mem.h"
 #include "vp9/common/vp9_common.h"
 #include "vp9/encoder/vp9_resize.h"
@@ -26,14 +25,14 @@
 #define FILTER_BITS 7
 
 #define INTERP_TAPS 8
-#define SUBPEL_BITS 5
-#define SUBPEL_MASK ((1 << SUBPEL_BITS) - 1)
+#define RS_SUBPEL_BITS 5
+#define RS_SUBPEL_MASK ((1 << RS_SUBPEL_BITS) - 1)
 #define INTERP_PRECISION_BITS 32
 
 typedef int16_t interp_kernel[INTERP_TAPS];
 
 // Filters for interpolation (0.5-band) - note this also filters integer pels.
-static const interp_kernel filteredinterp_filters500[(1 << SUBPEL_BITS)] = {
+static const interp_kernel filteredinterp_filters500[(1 << RS_SUBPEL_BITS)] = {
   { -3, 0, 35, 64, 35, 0, -3, 0 },    { -3, -1, 34, 64, 36, 1, -3, 0 },
   { -3, -1, 32, 64, 38, 1, -3, 0 },   { -2, -2, 31, 63, 39, 2, -3, 0 },
   { -2, -2, 29, 63, 41, 2, -3, 0 },   { -2, -2, 28, 63, 42, 3, -4, 0 },
@@ -53,7 +52,7 @@ static const interp_kernel filteredinterp_filters500[(1 << SUBPEL_BITS)] = {
 };
 
 // Filters for interpolation (0.625-band) - note this also filters integer pels.
-static const interp_kernel filteredinterp_filters625[(1 << SUBPEL_BITS)] = {
+static const interp_kernel filteredinterp_filters625[(1 << RS_SUBPEL_BITS)] = {
   { -1, -8, 33, 80, 33, -8, -1, 0 }, { -1, -8, 30, 80, 35, -8, -1, 1 },
   { -1, -8, 28, 80, 37, -7, -2, 1 }, { 0, -8, 26, 79, 39, -7, -2, 1 },
   { 0, -8, 24, 79, 41, -7, -2, 1 },  { 0, -8, 22, 78, 43, -6, -2, 1 },
@@ -73,7 +72,7 @@ static const interp_kernel filteredinterp_filters625[(1 << SUBPEL_BITS)] = {
 };
 
 // Filters for interpolation (0.75-band) - note this also filters integer pels.
-static const interp_kernel filteredinterp_filters750[(1 << SUBPEL_BITS)] = {
+static const interp_kernel filteredinterp_filters750[(1 << RS_SUBPEL_BITS)] = {
   { 2, -11, 25, 96, 25, -11, 2, 0 }, { 2, -11, 22, 96, 28, -11, 2, 0 },
   { 2, -10, 19, 95, 31, -11, 2, 0 }, { 2, -10, 17, 95, 34, -12, 2, 0 },
   { 2, -9, 14, 94, 37, -12, 2, 0 },  { 2, -8, 12, 93, 40, -12, 1, 0 },
@@ -93,7 +92,7 @@ static const interp_kernel filteredinterp_filters750[(1 << SUBPEL_BITS)] = {
 };
 
 // Filters for interpolation (0.875-band) - note this also filters integer pels.
-static const interp_kernel filteredinterp_filters875[(1 << SUBPEL_BITS)] = {
+static const interp_kernel filteredinterp_filters875[(1 << RS_SUBPEL_BITS)] = {
   { 3, -8, 13, 112, 13, -8, 3, 0 },   { 3, -7, 10, 112, 17, -9, 3, -1 },
   { 2, -6, 7, 111, 21, -9, 3, -1 },   { 2, -5, 4, 111, 24, -10, 3, -1 },
   { 2, -4, 1, 110, 28, -11, 3, -1 },  { 1, -3, -1, 108, 32, -12, 4, -1 },
@@ -113,7 +112,7 @@ static const interp_kernel filteredinterp_filters875[(1 << SUBPEL_BITS)] = {
 };
 
 // Filters for interpolation (full-band) - no filtering for integer pixels
-static const interp_kernel filteredinterp_filters1000[(1 << SUBPEL_BITS)] = {
+static const interp_kernel filteredinterp_filters1000[(1 << RS_SUBPEL_BITS)] = {
   { 0, 0, 0, 128, 0, 0, 0, 0 },        { 0, 1, -3, 128, 3, -1, 0, 0 },
   { -1, 2, -6, 127, 7, -2, 1, 0 },     { -1, 3, -9, 126, 12, -4, 1, 0 },
   { -1, 4, -12, 125, 16, -5, 1, 0 },   { -1, 4, -14, 123, 20, -6, 2, 0 },
@@ -132,9 +131,20 @@ static const interp_kernel filteredinterp_filters1000[(1 << SUBPEL_BITS)] = {
   { 0, 1, -2, 7, 127, -6, 2, -1 },     { 0, 0, -1, 3, 128, -3, 1, 0 }
 };
 
-// Filters for factor of 2 downsampling.
-static const int16_t vp9_down2_symeven_half_filter[] = { 56, 12, -3, -1 };
-static const int16_t vp9_down2_symodd_half_filter[] = { 64, 35, 0, -3 };
+// Filters for factor of 2 downsampling, laid out as INTERP_TAPS taps starting
+// 3 pels before the even input pel of each output pel. The odd length filter
+// only has 7 taps, so its last one is zero.
+static const int16_t vp9_down2_symeven_filter[INTERP_TAPS] = {
+  -1, -3, 12, 56, 56, 12, -3, -1
+};
+static const int16_t vp9_down2_symodd_filter[INTERP_TAPS] = {
+  -3, 0, 35, 64, 35, 0, -3, 0
+};
+
+// Number of rows transposed together for the horizontal pass.
+#define RESIZE_BAND_ROWS 16
+// Number of columns filtered together in the vertical pass.
+#define RESIZE_BAND_COLS 64
 
 static const interp_kernel *choose_interp_filter(int inlength, int outlength) {
   int outlength16 = outlength * 16;
@@ -150,8 +160,30 @@ static const interp_kernel *choose_interp_filter(int inlength, int outlength) {
     return filteredinterp_filters500;
 }
 
-static void interpolate(const uint8_t *const input, int inlength,
-                        uint8_t *output, int outlength) {
+void vp9_resize_filter_rows_c(const uint8_t *const *src, const int16_t *filter,
+                              uint8_t *dst, int w) {
+  int x, k;
+  for (x = 0; x < w; ++x) {
+    int sum = 0;
+    for (k = 0; k < INTERP_TAPS; ++k) sum += filter[k] * src[k][x];
+    dst[x] = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
+  }
+}
+
+// All filtering below runs down columns: every output row is an INTERP_TAPS
+// combination of input rows, so one vp9_resize_filter_rows() call produces
+// |w| output pels. Taps falling outside the input repeat its edge rows. The
+// horizontal pass transposes bands of rows so it can use the same code.
+static void get_filter_rows(const uint8_t *const input, int stride, int length,
+                            int first, const uint8_t *rows[INTERP_TAPS]) {
+  int k;
+  for (k = 0; k < INTERP_TAPS; ++k)
+    rows[k] = input + clamp(first + k, 0, length - 1) * stride;
+}
+
+static void interpolate(const uint8_t *const input, int in_stride,
+                        int inlength, uint8_t *output, int out_stride,
+                        int outlength, int w) {
   const int64_t delta =
       (((uint64_t)inlength << 32) + outlength / 2) / outlength;
   const int64_t offset =
@@ -160,191 +192,32 @@ static void interpolate(const uint8_t *const input, int inlength,
                 outlength
           : -(((int64_t)(outlength - inlength) << 31) + outlength / 2) /
                 outlength;
-  uint8_t *optr = output;
-  int x, x1, x2, sum, k, int_pel, sub_pel;
-  int64_t y;
-
   const interp_kernel *interp_filters =
       choose_interp_filter(inlength, outlength);
+  const uint8_t *rows[INTERP_TAPS];
+  int x, int_pel, sub_pel;
+  int64_t y;
 
-  x = 0;
-  y = offset;
-  while ((y >> INTERP_PRECISION_BITS) < (INTERP_TAPS / 2 - 1)) {
-    x++;
-    y += delta;
-  }
-  x1 = x;
-  x = outlength - 1;
-  y = delta * x + offset;
-  while ((y >> INTERP_PRECISION_BITS) + (int64_t)(INTERP_TAPS / 2) >=
-         inlength) {
-    x--;
-    y -= delta;
-  }
-  x2 = x;
-  if (x1 > x2) {
-    for (x = 0, y = offset; x < outlength; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k) {
-        const int pk = int_pel - INTERP_TAPS / 2 + 1 + k;
-        sum += filter[k] *
-               input[(pk < 0 ? 0 : (pk >= inlength ? inlength - 1 : pk))];
-      }
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
-  } else {
-    // Initial part.
-    for (x = 0, y = offset; x < x1; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[(int_pel - INTERP_TAPS / 2 + 1 + k < 0
-                                      ? 0
-                                      : int_pel - INTERP_TAPS / 2 + 1 + k)];
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
-    // Middle part.
-    for (; x <= x2; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[int_pel - INTERP_TAPS / 2 + 1 + k];
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
-    // End part.
-    for (; x < outlength; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[(int_pel - INTERP_TAPS / 2 + 1 + k >= inlength
-                                      ? inlength - 1
-                                      : int_pel - INTERP_TAPS / 2 + 1 + k)];
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
+  for (x = 0, y = offset; x < outlength; ++x, y += delta) {
+    int_pel = (int)(y >> INTERP_PRECISION_BITS);
+    sub_pel = (y >> (INTERP_PRECISION_BITS - RS_SUBPEL_BITS)) & RS_SUBPEL_MASK;
+    get_filter_rows(input, in_stride, inlength, int_pel - INTERP_TAPS / 2 + 1,
+                    rows);
+    vp9_resize_filter_rows(rows, interp_filters[sub_pel], output, w);
+    output += out_stride;
   }
 }
 
-static void down2_symeven(const uint8_t *const input, int length,
-                          uint8_t *output) {
-  // Actual filter len = 2 * filter_len_half.
-  const int16_t *filter = vp9_down2_symeven_half_filter;
-  const int filter_len_half = sizeof(vp9_down2_symeven_half_filter) / 2;
-  int i, j;
-  uint8_t *optr = output;
-  int l1 = filter_len_half;
-  int l2 = (length - filter_len_half);
-  l1 += (l1 & 1);
-  l2 += (l2 & 1);
-  if (l1 > l2) {
-    // Short input length.
-    for (i = 0; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] +
-                input[(i + 1 + j >= length ? length - 1 : i + 1 + j)]) *
-               filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-  } else {
-    // Initial part.
-    for (i = 0; i < l1; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] + input[i + 1 + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-    // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + 1 + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-    // End part.
-    for (; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[i - j] +
-                input[(i + 1 + j >= length ? length - 1 : i + 1 + j)]) *
-               filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-  }
-}
-
-static void down2_symodd(const uint8_t *const input, int length,
-                         uint8_t *output) {
-  // Actual filter len = 2 * filter_len_half - 1.
-  const int16_t *filter = vp9_down2_symodd_half_filter;
-  const int filter_len_half = sizeof(vp9_down2_symodd_half_filter) / 2;
-  int i, j;
-  uint8_t *optr = output;
-  int l1 = filter_len_half - 1;
-  int l2 = (length - filter_len_half + 1);
-  l1 += (l1 & 1);
-  l2 += (l2 & 1);
-  if (l1 > l2) {
-    // Short input length.
-    for (i = 0; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] +
-                input[(i + j >= length ? length - 1 : i + j)]) *
-               filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-  } else {
-    // Initial part.
-    for (i = 0; i < l1; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] + input[i + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-    // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-    // End part.
-    for (; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[(i + j >= length ? length - 1 : i + j)]) *
-               filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
+static void down2(const uint8_t *const input, int in_stride, int length,
+                  uint8_t *output, int out_stride, int w) {
+  const int16_t *const filter =
+      (length & 1) ? vp9_down2_symodd_filter : vp9_down2_symeven_filter;
+  const uint8_t *rows[INTERP_TAPS];
+  int i;
+  for (i = 0; i < length; i += 2) {
+    get_filter_rows(input, in_stride, length, i - INTERP_TAPS / 2 + 1, rows);
+    vp9_resize_filter_rows(rows, filter, output, w);
+    output += out_stride;
   }
 }
 
@@ -370,11 +243,18 @@ static int get_down2_steps(int in_length, int out_length) {
   return steps;
 }
 
-static void resize_multistep(const uint8_t *const input, int length,
-                             uint8_t *output, int olength, uint8_t *otmp) {
+// Resizes |w| columns from |length| to |olength| rows. |otmp| must hold
+// w * length pels.
+static void resize_multistep(const uint8_t *const input, int in_stride,
+                             int length, uint8_t *output, int out_stride,
+                             int olength, int w, uint8_t *otmp) {
   int steps;
   if (length == olength) {
-    memcpy(output, input, sizeof(output[0]) * length);
+    int i;
+    for (i = 0; i < length; ++i) {
+      memcpy(output + out_stride * i, input + in_stride * i,
+             sizeof(output[0]) * w);
+    }
     return;
   }
   steps = get_down2_steps(length, olength);
@@ -386,80 +266,130 @@ static void resize_multistep(const uint8_t *const input, int length,
     int filteredlength = length;
 
     assert(otmp != NULL);
-    otmp2 = otmp + get_down2_length(length, 1);
+    otmp2 = otmp + get_down2_length(length, 1) * w;
     for (s = 0; s < steps; ++s) {
       const int proj_filteredlength = get_down2_length(filteredlength, 1);
       const uint8_t *const in = (s == 0 ? input : out);
-      if (s == steps - 1 && proj_filteredlength == olength)
+      const int stride = (s == 0 ? in_stride : w);
+      if (s == steps - 1 && proj_filteredlength == olength) {
         out = output;
-      else
+        down2(in, stride, filteredlength, out, out_stride, w);
+      } else {
         out = (s & 1 ? otmp2 : otmp);
-      if (filteredlength & 1)
-        down2_symodd(in, filteredlength, out);
-      else
-        down2_symeven(in, filteredlength, out);
+        down2(in, stride, filteredlength, out, w, w);
+      }
       filteredlength = proj_filteredlength;
     }
     if (filteredlength != olength) {
-      interpolate(out, filteredlength, output, olength);
+      interpolate(out, w, filteredlength, output, out_stride, olength, w);
     }
   } else {
-    interpolate(input, length, output, olength);
+    interpolate(input, in_stride, length, output, out_stride, olength, w);
   }
 }
 
-static void fill_col_to_arr(uint8_t *img, int stride, int len, uint8_t *arr) {
-  int i;
-  uint8_t *iptr = img;
-  uint8_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *aptr++ = *iptr;
+// Copies the |rows| x |cols| block at |src| transposed to |dst|.
+static void transpose(const uint8_t *src, int src_stride, uint8_t *dst,
+                      int dst_stride, int rows, int cols) {
+  int r, c;
+  for (c = 0; c < cols; ++c) {
+    for (r = 0; r < rows; ++r) dst[r] = src[r * src_stride + c];
+    dst += dst_stride;
   }
 }
 
-static void fill_arr_to_col(uint8_t *img, int stride, int len, uint8_t *arr) {
-  int i;
-  uint8_t *iptr = img;
-  uint8_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *iptr = *aptr++;
+int vp9_resize_plane_rows(const uint8_t *const input, int width, int in_stride,
+                          uint8_t *intbuf, int width2, int row_start,
+                          int row_end) {
+  uint8_t *tbuf, *tbuf2, *tmpbuf;
+  int r, ok;
+  assert(width > 0);
+  assert(width2 > 0);
+  if (width == width2) {
+    for (r = row_start; r < row_end; ++r) {
+      memcpy(intbuf + width2 * r, input + in_stride * r,
+             sizeof(*intbuf) * width);
+    }
+    return 1;
   }
+  tbuf = (uint8_t *)malloc(sizeof(*tbuf) * width * RESIZE_BAND_ROWS);
+  tbuf2 = (uint8_t *)malloc(sizeof(*tbuf2) * width2 * RESIZE_BAND_ROWS);
+  tmpbuf = (uint8_t *)malloc(sizeof(*tmpbuf) * width * RESIZE_BAND_ROWS);
+  ok = tbuf != NULL && tbuf2 != NULL && tmpbuf != NULL;
+  if (ok) {
+    for (r = row_start; r < row_end; r += RESIZE_BAND_ROWS) {
+      const int rows = VPXMIN(RESIZE_BAND_ROWS, row_end - r);
+      transpose(input + in_stride * r, in_stride, tbuf, RESIZE_BAND_ROWS, rows,
+                width);
+      resize_multistep(tbuf, RESIZE_BAND_ROWS, width, tbuf2, RESIZE_BAND_ROWS,
+                       width2, rows, tmpbuf);
+      transpose(tbuf2, RESIZE_BAND_ROWS, intbuf + width2 * r, width2, width2,
+                rows);
+    }
+  }
+  free(tbuf);
+  free(tbuf2);
+  free(tmpbuf);
+  return ok;
+}
+
+int vp9_resize_plane_cols(const uint8_t *intbuf, int height, int width2,
+                          uint8_t *output, int height2, int out_stride,
+                          int col_start, int col_end) {
+  uint8_t *tmpbuf;
+  int c;
+  assert(height > 0);
+  assert(height2 > 0);
+  tmpbuf = (uint8_t *)malloc(sizeof(*tmpbuf) * height * RESIZE_BAND_COLS);
+  if (tmpbuf == NULL) return 0;
+  for (c = col_start; c < col_end; c += RESIZE_BAND_COLS) {
+    resize_multistep(intbuf + c, width2, height, output + c, out_stride,
+                     height2, VPXMIN(RESIZE_BAND_COLS, col_end - c), tmpbuf);
+  }
+  free(tmpbuf);
+  return 1;
 }
 
 void vp9_resize_plane(const uint8_t *const input, int height, int width,
                       int in_stride, uint8_t *output, int height2, int width2,
                       int out_stride) {
-  int i;
-  uint8_t *intbuf = (uint8_t *)calloc(width2 * height, sizeof(*intbuf));
-  uint8_t *tmpbuf =
-      (uint8_t *)calloc(width < height ? height : width, sizeof(*tmpbuf));
-  uint8_t *arrbuf = (uint8_t *)calloc(height, sizeof(*arrbuf));
-  uint8_t *arrbuf2 = (uint8_t *)calloc(height2, sizeof(*arrbuf2));
-  if (intbuf == NULL || tmpbuf == NULL || arrbuf == NULL || arrbuf2 == NULL)
-    goto Error;
+  uint8_t *intbuf = (uint8_t *)malloc(sizeof(*intbuf) * width2 * height);
+  if (intbuf == NULL) return;
   assert(width > 0);
   assert(height > 0);
   assert(width2 > 0);
   assert(height2 > 0);
-  for (i = 0; i < height; ++i)
-    resize_multistep(input + in_stride * i, width, intbuf + width2 * i, width2,
-                     tmpbuf);
-  for (i = 0; i < width2; ++i) {
-    fill_col_to_arr(intbuf + i, width2, height, arrbuf);
-    resize_multistep(arrbuf, height, arrbuf2, height2, tmpbuf);
-    fill_arr_to_col(output + i, out_stride, height2, arrbuf2);
+  if (vp9_resize_plane_rows(input, width, in_stride, intbuf, width2, 0,
+                            height)) {
+    vp9_resize_plane_cols(intbuf, height, width2, output, height2, out_stride,
+                          0, width2);
   }
-
-Error:
   free(intbuf);
-  free(tmpbuf);
-  free(arrbuf);
-  free(arrbuf2);
 }
 
 #if CONFIG_VP9_HIGHBITDEPTH
-static void highbd_interpolate(const uint16_t *const input, int inlength,
-                               uint16_t *output, int outlength, int bd) {
+void vp9_highbd_resize_filter_rows_c(const uint16_t *const *src,
+                                     const int16_t *filter, uint16_t *dst,
+                                     int w, int bd) {
+  int x, k;
+  for (x = 0; x < w; ++x) {
+    int sum = 0;
+    for (k = 0; k < INTERP_TAPS; ++k) sum += filter[k] * src[k][x];
+    dst[x] = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
+  }
+}
+
+static void highbd_get_filter_rows(const uint16_t *const input, int stride,
+                                   int length, int first,
+                                   const uint16_t *rows[INTERP_TAPS]) {
+  int k;
+  for (k = 0; k < INTERP_TAPS; ++k)
+    rows[k] = input + clamp(first + k, 0, length - 1) * stride;
+}
+
+static void highbd_interpolate(const uint16_t *const input, int in_stride,
+                               int inlength, uint16_t *output, int out_stride,
+                               int outlength, int w, int bd) {
   const int64_t delta =
       (((uint64_t)inlength << 32) + outlength / 2) / outlength;
   const int64_t offset =
@@ -468,202 +398,50 @@ static void highbd_interpolate(const uint16_t *const input, int inlength,
                 outlength
           : -(((int64_t)(outlength - inlength) << 31) + outlength / 2) /
                 outlength;
-  uint16_t *optr = output;
-  int x, x1, x2, sum, k, int_pel, sub_pel;
-  int64_t y;
-
   const interp_kernel *interp_filters =
       choose_interp_filter(inlength, outlength);
+  const uint16_t *rows[INTERP_TAPS];
+  int x, int_pel, sub_pel;
+  int64_t y;
 
-  x = 0;
-  y = offset;
-  while ((y >> INTERP_PRECISION_BITS) < (INTERP_TAPS / 2 - 1)) {
-    x++;
-    y += delta;
-  }
-  x1 = x;
-  x = outlength - 1;
-  y = delta * x + offset;
-  while ((y >> INTERP_PRECISION_BITS) + (int64_t)(INTERP_TAPS / 2) >=
-         inlength) {
-    x--;
-    y -= delta;
-  }
-  x2 = x;
-  if (x1 > x2) {
-    for (x = 0, y = offset; x < outlength; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k) {
-        const int pk = int_pel - INTERP_TAPS / 2 + 1 + k;
-        sum += filter[k] *
-               input[(pk < 0 ? 0 : (pk >= inlength ? inlength - 1 : pk))];
-      }
-      *optr++ = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
-    }
-  } else {
-    // Initial part.
-    for (x = 0, y = offset; x < x1; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k) {
-        assert(int_pel - INTERP_TAPS / 2 + 1 + k < inlength);
-        sum += filter[k] * input[(int_pel - INTERP_TAPS / 2 + 1 + k < 0
-                                      ? 0
-                                      : int_pel - INTERP_TAPS / 2 + 1 + k)];
-      }
-      *optr++ = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
-    }
-    // Middle part.
-    for (; x <= x2; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[int_pel - INTERP_TAPS / 2 + 1 + k];
-      *optr++ = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
-    }
-    // End part.
-    for (; x < outlength; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[(int_pel - INTERP_TAPS / 2 + 1 + k >= inlength
-                                      ? inlength - 1
-                                      : int_pel - INTERP_TAPS / 2 + 1 + k)];
-      *optr++ = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
-    }
-  }
-}
-
-static void highbd_down2_symeven(const uint16_t *const input, int length,
-                                 uint16_t *output, int bd) {
-  // Actual filter len = 2 * filter_len_half.
-  static const int16_t *filter = vp9_down2_symeven_half_filter;
-  const int filter_len_half = sizeof(vp9_down2_symeven_half_filter) / 2;
-  int i, j;
-  uint16_t *optr = output;
-  int l1 = filter_len_half;
-  int l2 = (length - filter_len_half);
-  l1 += (l1 & 1);
-  l2 += (l2 & 1);
-  if (l1 > l2) {
-    // Short input length.
-    for (i = 0; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] +
-                input[(i + 1 + j >= length ? length - 1 : i + 1 + j)]) *
-               filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
-  } else {
-    // Initial part.
-    for (i = 0; i < l1; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] + input[i + 1 + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
-    // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + 1 + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
-    // End part.
-    for (; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[i - j] +
-                input[(i + 1 + j >= length ? length - 1 : i + 1 + j)]) *
-               filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
+  for (x = 0, y = offset; x < outlength; ++x, y += delta) {
+    int_pel = (int)(y >> INTERP_PRECISION_BITS);
+    sub_pel = (y >> (INTERP_PRECISION_BITS - RS_SUBPEL_BITS)) & RS_SUBPEL_MASK;
+    highbd_get_filter_rows(input, in_stride, inlength,
+                           int_pel - INTERP_TAPS / 2 + 1, rows);
+    vp9_highbd_resize_filter_rows(rows, interp_filters[sub_pel], output, w,
+                                  bd);
+    output += out_stride;
   }
 }
 
-static void highbd_down2_symodd(const uint16_t *const input, int length,
-                                uint16_t *output, int bd) {
-  // Actual filter len = 2 * filter_len_half - 1.
-  static const int16_t *filter = vp9_down2_symodd_half_filter;
-  const int filter_len_half = sizeof(vp9_down2_symodd_half_filter) / 2;
-  int i, j;
-  uint16_t *optr = output;
-  int l1 = filter_len_half - 1;
-  int l2 = (length - filter_len_half + 1);
-  l1 += (l1 & 1);
-  l2 += (l2 & 1);
-  if (l1 > l2) {
-    // Short input length.
-    for (i = 0; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] +
-                input[(i + j >= length ? length - 1 : i + j)]) *
-               filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
-  } else {
-    // Initial part.
-    for (i = 0; i < l1; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] + input[i + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
-    // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
-    // End part.
-    for (; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[(i + j >= length ? length - 1 : i + j)]) *
-               filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
+static void highbd_down2(const uint16_t *const input, int in_stride,
+                         int length, uint16_t *output, int out_stride, int w,
+                         int bd) {
+  const int16_t *const filter =
+      (length & 1) ? vp9_down2_symodd_filter : vp9_down2_symeven_filter;
+  const uint16_t *rows[INTERP_TAPS];
+  int i;
+  for (i = 0; i < length; i += 2) {
+    highbd_get_filter_rows(input, in_stride, length, i - INTERP_TAPS / 2 + 1,
+                           rows);
+    vp9_highbd_resize_filter_rows(rows, filter, output, w, bd);
+    output += out_stride;
   }
 }
 
-static void highbd_resize_multistep(const uint16_t *const input, int length,
-                                    uint16_t *output, int olength,
-                                    uint16_t *otmp, int bd) {
+static void highbd_resize_multistep(const uint16_t *const input,
+                                    int in_stride, int length,
+                                    uint16_t *output, int out_stride,
+                                    int olength, int w, uint16_t *otmp,
+                                    int bd) {
   int steps;
   if (length == olength) {
-    memcpy(output, input, sizeof(output[0]) * length);
+    int i;
+    for (i = 0; i < length; ++i) {
+      memcpy(output + out_stride * i, input + in_stride * i,
+             sizeof(output[0]) * w);
+    }
     return;
   }
   steps = get_down2_steps(length, olength);
@@ -675,78 +453,110 @@ static void highbd_resize_multistep(const uint16_t *const input, int length,
     int filteredlength = length;
 
     assert(otmp != NULL);
-    otmp2 = otmp + get_down2_length(length, 1);
+    otmp2 = otmp + get_down2_length(length, 1) * w;
     for (s = 0; s < steps; ++s) {
       const int proj_filteredlength = get_down2_length(filteredlength, 1);
       const uint16_t *const in = (s == 0 ? input : out);
-      if (s == steps - 1 && proj_filteredlength == olength)
+      const int stride = (s == 0 ? in_stride : w);
+      if (s == steps - 1 && proj_filteredlength == olength) {
         out = output;
-      else
+        highbd_down2(in, stride, filteredlength, out, out_stride, w, bd);
+      } else {
         out = (s & 1 ? otmp2 : otmp);
-      if (filteredlength & 1)
-        highbd_down2_symodd(in, filteredlength, out, bd);
-      else
-        highbd_down2_symeven(in, filteredlength, out, bd);
+        highbd_down2(in, stride, filteredlength, out, w, w, bd);
+      }
       filteredlength = proj_filteredlength;
     }
     if (filteredlength != olength) {
-      highbd_interpolate(out, filteredlength, output, olength, bd);
+      highbd_interpolate(out, w, filteredlength, output, out_stride, olength,
+                         w, bd);
     }
   } else {
-    highbd_interpolate(input, length, output, olength, bd);
+    highbd_interpolate(input, in_stride, length, output, out_stride, olength,
+                       w, bd);
   }
 }
 
-static void highbd_fill_col_to_arr(uint16_t *img, int stride, int len,
-                                   uint16_t *arr) {
-  int i;
-  uint16_t *iptr = img;
-  uint16_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *aptr++ = *iptr;
+static void highbd_transpose(const uint16_t *src, int src_stride,
+                             uint16_t *dst, int dst_stride, int rows,
+                             int cols) {
+  int r, c;
+  for (c = 0; c < cols; ++c) {
+    for (r = 0; r < rows; ++r) dst[r] = src[r * src_stride + c];
+    dst += dst_stride;
   }
 }
 
-static void highbd_fill_arr_to_col(uint16_t *img, int stride, int len,
-                                   uint16_t *arr) {
-  int i;
-  uint16_t *iptr = img;
-  uint16_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *iptr = *aptr++;
+int vp9_highbd_resize_plane_rows(const uint8_t *const input, int width,
+                                 int in_stride, uint16_t *intbuf, int width2,
+                                 int row_start, int row_end, int bd) {
+  const uint16_t *const input16 = CONVERT_TO_SHORTPTR(input);
+  uint16_t *tbuf, *tbuf2, *tmpbuf;
+  int r, ok;
+  assert(width > 0);
+  assert(width2 > 0);
+  if (width == width2) {
+    for (r = row_start; r < row_end; ++r) {
+      memcpy(intbuf + width2 * r, input16 + in_stride * r,
+             sizeof(*intbuf) * width);
+    }
+    return 1;
+  }
+  tbuf = (uint16_t *)malloc(sizeof(*tbuf) * width * RESIZE_BAND_ROWS);
+  tbuf2 = (uint16_t *)malloc(sizeof(*tbuf2) * width2 * RESIZE_BAND_ROWS);
+  tmpbuf = (uint16_t *)malloc(sizeof(*tmpbuf) * width * RESIZE_BAND_ROWS);
+  ok = tbuf != NULL && tbuf2 != NULL && tmpbuf != NULL;
+  if (ok) {
+    for (r = row_start; r < row_end; r += RESIZE_BAND_ROWS) {
+      const int rows = VPXMIN(RESIZE_BAND_ROWS, row_end - r);
+      highbd_transpose(input16 + in_stride * r, in_stride, tbuf,
+                       RESIZE_BAND_ROWS, rows, width);
+      highbd_resize_multistep(tbuf, RESIZE_BAND_ROWS, width, tbuf2,
+                              RESIZE_BAND_ROWS, width2, rows, tmpbuf, bd);
+      highbd_transpose(tbuf2, RESIZE_BAND_ROWS, intbuf + width2 * r, width2,
+                       width2, rows);
+    }
   }
+  free(tbuf);
+  free(tbuf2);
+  free(tmpbuf);
+  return ok;
+}
+
+int vp9_highbd_resize_plane_cols(const uint16_t *intbuf, int height,
+                                 int width2, uint8_t *output, int height2,
+                                 int out_stride, int col_start, int col_end,
+                                 int bd) {
+  uint16_t *const output16 = CONVERT_TO_SHORTPTR(output);
+  uint16_t *tmpbuf;
+  int c;
+  assert(height > 0);
+  assert(height2 > 0);
+  tmpbuf = (uint16_t *)malloc(sizeof(*tmpbuf) * height * RESIZE_BAND_COLS);
+  if (tmpbuf == NULL) return 0;
+  for (c = col_start; c < col_end; c += RESIZE_BAND_COLS) {
+    highbd_resize_multistep(intbuf + c, width2, height, output16 + c,
+                            out_stride, height2,
+                            VPXMIN(RESIZE_BAND_COLS, col_end - c), tmpbuf, bd);
+  }
+  free(tmpbuf);
+  return 1;
 }
 
 void vp9_highbd_resize_plane(const uint8_t *const input, int height, int width,
                              int in_stride, uint8_t *output, int height2,
                              int width2, int out_stride, int bd) {
-  int i;
-  uint16_t *intbuf = (uint16_t *)malloc(sizeof(uint16_t) * width2 * height);
-  uint16_t *tmpbuf =
-      (uint16_t *)malloc(sizeof(uint16_t) * (width < height ? height : width));
-  uint16_t *arrbuf = (uint16_t *)malloc(sizeof(uint16_t) * height);
-  uint16_t *arrbuf2 = (uint16_t *)malloc(sizeof(uint16_t) * height2);
-  if (intbuf == NULL || tmpbuf == NULL || arrbuf == NULL || arrbuf2 == NULL)
-    goto Error;
+  uint16_t *intbuf = (uint16_t *)malloc(sizeof(*intbuf) * width2 * height);
+  if (intbuf == NULL) return;
   assert(width > 0);
   assert(height > 0);
   assert(width2 > 0);
   assert(height2 > 0);
-  for (i = 0; i < height; ++i) {
-    highbd_resize_multistep(CONVERT_TO_SHORTPTR(input + in_stride * i), width,
-                            intbuf + width2 * i, width2, tmpbuf, bd);
+  if (vp9_highbd_resize_plane_rows(input, width, in_stride, intbuf, width2, 0,
+                                   height, bd)) {
+    vp9_highbd_resize_plane_cols(intbuf, height, width2, output, height2,
+                                 out_stride, 0, width2, bd);
   }
-  for (i = 0; i < width2; ++i) {
-    highbd_fill_col_to_arr(intbuf + i, width2, height, arrbuf);
-    highbd_resize_multistep(arrbuf, height, arrbuf2, height2, tmpbuf, bd);
-    highbd_fill_arr_to_col(CONVERT_TO_SHORTPTR(output + i), out_stride, height2,
-                           arrbuf2);
-  }
-
-Error:
   free(intbuf);
-  free(tmpbuf);
-  free(arrbuf);
-  free(arrbuf2);
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
@@ -22,10 +22,30 @@ void vp9_resize_plane(const uint8_t *const input, int height, int width,
                       int in_stride, uint8_t *output, int height2, int width2,
                       int out_stride);
 
+// vp9_resize_plane() is split into two passes that can be run in bands on
+// separate threads. The first resizes input rows [row_start, row_end) to
+// |width2| pels in |intbuf|, a width2 x height plane. Once every row is done
+// the second resizes columns [col_start, col_end) of |intbuf| to |height2|
+// rows in |output|. Both return 0 if they fail to allocate scratch memory.
+int vp9_resize_plane_rows(const uint8_t *const input, int width, int in_stride,
+                          uint8_t *intbuf, int width2, int row_start,
+                          int row_end);
+int vp9_resize_plane_cols(const uint8_t *intbuf, int height, int width2,
+                          uint8_t *output, int height2, int out_stride,
+                          int col_start, int col_end);
+
 #if CONFIG_VP9_HIGHBITDEPTH
 void vp9_highbd_resize_plane(const uint8_t *const input, int height, int width,
                              int in_stride, uint8_t *output, int height2,
                              int width2, int out_stride, int bd);
+
+int vp9_highbd_resize_plane_rows(const uint8_t *const input, int width,
+                                 int in_stride, uint16_t *intbuf, int width2,
+                                 int row_start, int row_end, int bd);
+int vp9_highbd_resize_plane_cols(const uint16_t *intbuf, int height,
+                                 int width2, uint8_t *output, int height2,
+                                 int out_stride, int col_start, int col_end,
+                                 int bd);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
 #ifdef __cplusplus
@@ -795,7 +795,7 @@ static int rate_estimator(const tran_low_t *qcoeff, int eob, TX_SIZE tx_size) {
   return (rate_cost << VP9_PROB_COST_SHIFT);
 }
 
-static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
+static void mode_estimation(VP9_COMP *cpi, ThreadData *td,
                             struct scale_factors *sf, GF_PICTURE *gf_picture,
                             int frame_idx, TplDepFrame *tpl_frame,
                             int16_t *src_diff, tran_low_t *coeff,
@@ -805,7 +805,8 @@ static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
                             int64_t *recon_error, int64_t *rate_cost,
                             int64_t *sse, int *ref_frame_idx) {
   VP9_COMMON *cm = &cpi->common;
-  ThreadData *td = &cpi->td;
+  MACROBLOCK *const x = &td->mb;
+  MACROBLOCKD *const xd = &x->e_mbd;
 
   const int bw = 4 << b_width_log2_lookup[bsize];
   const int bh = 4 << b_height_log2_lookup[bsize];
@@ -1364,21 +1365,19 @@ static void build_motion_field(
 }
 #endif  // CONFIG_NON_GREEDY_MV
 
-static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
-                              int frame_idx, BLOCK_SIZE bsize) {
+void vp9_mc_flow_dispenser_row(VP9_COMP *cpi, ThreadData *td, int mi_row,
+                               int mi_col_start, int mi_col_end) {
+  TplMcFlowData *const mc_flow_data = &cpi->tpl_mc_flow_data;
+  const int frame_idx = mc_flow_data->frame_idx;
+  const BLOCK_SIZE bsize = mc_flow_data->bsize;
   TplDepFrame *tpl_frame = &cpi->tpl_stats[frame_idx];
   VpxTplFrameStats *tpl_frame_stats_before_propagation =
       &cpi->tpl_gop_stats.frame_stats_list[frame_idx];
-  YV12_BUFFER_CONFIG *this_frame = gf_picture[frame_idx].frame;
-  YV12_BUFFER_CONFIG *ref_frame[MAX_INTER_REF_FRAMES] = { NULL, NULL, NULL };
-
-  VP9_COMMON *cm = &cpi->common;
-  struct scale_factors sf;
-  int rdmult, idx;
-  ThreadData *td = &cpi->td;
-  MACROBLOCK *x = &td->mb;
-  MACROBLOCKD *xd = &x->e_mbd;
-  int mi_row, mi_col;
+  MACROBLOCKD *xd = &td->mb.e_mbd;
+  MODE_INFO **const mi_backup = xd->mi;
+  MODE_INFO mi;
+  MODE_INFO *mi_ptr = &mi;
+  int mi_col;
 
 #if CONFIG_VP9_HIGHBITDEPTH
   DECLARE_ALIGNED(16, uint16_t, predictor16[32 * 32 * 3]);
@@ -1393,25 +1392,78 @@ static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
   DECLARE_ALIGNED(16, tran_low_t, dqcoeff[32 * 32]);
 
   const TX_SIZE tx_size = max_txsize_lookup[bsize];
+  const int mi_width = num_8x8_blocks_wide_lookup[bsize];
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH)
+    predictor = CONVERT_TO_BYTEPTR(predictor16);
+  else
+    predictor = predictor8;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+  // Each thread works on its own mode info, only the fields set by
+  // mode_estimation() are read.
+  memset(&mi, 0, sizeof(mi));
+  xd->mi = &mi_ptr;
+
+  for (mi_col = mi_col_start; mi_col < mi_col_end; mi_col += mi_width) {
+    int64_t recon_error = 0;
+    int64_t rate_cost = 0;
+    int64_t sse = 0;
+    // Ref frame index in the ref frame buffer.
+    int ref_frame_idx = -1;
+    mode_estimation(cpi, td, &mc_flow_data->sf, mc_flow_data->gf_picture,
+                    frame_idx, tpl_frame, src_diff, coeff, qcoeff, dqcoeff,
+                    mi_row, mi_col, bsize, tx_size, mc_flow_data->ref_frame,
+                    predictor, &recon_error, &rate_cost, &sse, &ref_frame_idx);
+    // Motion flow dependency dispenser.
+    tpl_model_store(tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize,
+                    tpl_frame->stride);
+
+    tpl_store_before_propagation(
+        tpl_frame_stats_before_propagation->block_stats_list,
+        tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize, tpl_frame->stride,
+        recon_error, sse, rate_cost, ref_frame_idx, tpl_frame->mi_rows,
+        tpl_frame->mi_cols);
+  }
+
+  xd->mi = mi_backup;
+}
+
+static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
+                              int frame_idx, BLOCK_SIZE bsize) {
+  TplMcFlowData *const mc_flow_data = &cpi->tpl_mc_flow_data;
+  TplDepFrame *tpl_frame = &cpi->tpl_stats[frame_idx];
+  VpxTplFrameStats *tpl_frame_stats_before_propagation =
+      &cpi->tpl_gop_stats.frame_stats_list[frame_idx];
+  YV12_BUFFER_CONFIG *this_frame = gf_picture[frame_idx].frame;
+  YV12_BUFFER_CONFIG **ref_frame = mc_flow_data->ref_frame;
+
+  VP9_COMMON *cm = &cpi->common;
+  int rdmult, idx;
+  ThreadData *td = &cpi->td;
+  MACROBLOCK *x = &td->mb;
+  MACROBLOCKD *xd = &x->e_mbd;
+  int mi_row, mi_col;
+
   const int mi_height = num_8x8_blocks_high_lookup[bsize];
   const int mi_width = num_8x8_blocks_wide_lookup[bsize];
 
+  mc_flow_data->gf_picture = gf_picture;
+  mc_flow_data->frame_idx = frame_idx;
+  mc_flow_data->bsize = bsize;
+
   tpl_frame_stats_before_propagation->frame_width = cm->width;
   tpl_frame_stats_before_propagation->frame_height = cm->height;
   // Setup scaling factor
 #if CONFIG_VP9_HIGHBITDEPTH
   vp9_setup_scale_factors_for_frame(
-      &sf, this_frame->y_crop_width, this_frame->y_crop_height,
+      &mc_flow_data->sf, this_frame->y_crop_width, this_frame->y_crop_height,
       this_frame->y_crop_width, this_frame->y_crop_height,
       cpi->common.use_highbitdepth);
-
-  if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH)
-    predictor = CONVERT_TO_BYTEPTR(predictor16);
-  else
-    predictor = predictor8;
 #else
   vp9_setup_scale_factors_for_frame(
-      &sf, this_frame->y_crop_width, this_frame->y_crop_height,
+      &mc_flow_data->sf, this_frame->y_crop_width, this_frame->y_crop_height,
       this_frame->y_crop_width, this_frame->y_crop_height);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
@@ -1419,7 +1471,8 @@ static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
   // unavailable, the pointer will be set to Null.
   for (idx = 0; idx < MAX_INTER_REF_FRAMES; ++idx) {
     int rf_idx = gf_picture[frame_idx].ref_frame[idx];
-    if (rf_idx != -REFS_PER_FRAME) ref_frame[idx] = gf_picture[rf_idx].frame;
+    ref_frame[idx] =
+        rf_idx != -REFS_PER_FRAME ? gf_picture[rf_idx].frame : NULL;
   }
 
   xd->mi = cm->mi_grid_visible;
@@ -1457,27 +1510,19 @@ static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
   }
 #endif  // CONFIG_NON_GREEDY_MV
 
+  // The mode estimation of a block only depends on the source frames, the
+  // rows are processed in parallel when row based multi-threading is on.
+  if (cpi->row_mt && cpi->oxcf.max_threads > 1) {
+    vp9_mc_flow_dispenser_row_mt(cpi);
+  } else {
+    for (mi_row = 0; mi_row < cm->mi_rows; mi_row += mi_height)
+      vp9_mc_flow_dispenser_row(cpi, td, mi_row, 0, cm->mi_cols);
+  }
+
+  // The propagation to the reference frames accumulates into shared stats,
+  // run it in raster order.
   for (mi_row = 0; mi_row < cm->mi_rows; mi_row += mi_height) {
     for (mi_col = 0; mi_col < cm->mi_cols; mi_col += mi_width) {
-      int64_t recon_error = 0;
-      int64_t rate_cost = 0;
-      int64_t sse = 0;
-      // Ref frame index in the ref frame buffer.
-      int ref_frame_idx = -1;
-      mode_estimation(cpi, x, xd, &sf, gf_picture, frame_idx, tpl_frame,
-                      src_diff, coeff, qcoeff, dqcoeff, mi_row, mi_col, bsize,
-                      tx_size, ref_frame, predictor, &recon_error, &rate_cost,
-                      &sse, &ref_frame_idx);
-      // Motion flow dependency dispenser.
-      tpl_model_store(tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize,
-                      tpl_frame->stride);
-
-      tpl_store_before_propagation(
-          tpl_frame_stats_before_propagation->block_stats_list,
-          tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize, tpl_frame->stride,
-          recon_error, sse, rate_cost, ref_frame_idx, tpl_frame->mi_rows,
-          tpl_frame->mi_cols);
-
       tpl_model_update(cpi->tpl_stats, tpl_frame->tpl_stats_ptr, mi_row, mi_col,
                        bsize);
     }
@@ -0,0 +1,240 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vp9/encoder/vp9_encoder.h"
+#include "vpx_ports/mem.h"
+
+#ifdef __GNUC__
+#define LIKELY(v) __builtin_expect(v, 1)
+#define UNLIKELY(v) __builtin_expect(v, 0)
+#else
+#define LIKELY(v) (v)
+#define UNLIKELY(v) (v)
+#endif
+
+static INLINE int_mv pack_int_mv(int16_t row, int16_t col) {
+  int_mv result;
+  result.as_mv.row = row;
+  result.as_mv.col = col;
+  return result;
+}
+
+// Returns the minimum of the 4 unsigned 32-bit lanes of 'v' in all lanes.
+static INLINE __m128i hmin_epu32(__m128i v) {
+  v = _mm_min_epu32(v, _mm_shuffle_epi32(v, 0x4e));
+  return _mm_min_epu32(v, _mm_shuffle_epi32(v, 0xb1));
+}
+
+// This function relies on the same properties of the cost function lookup
+// tables as vp9_diamond_search_sad_neon(), see 'cal_nmvjointsadcost' and
+// 'cal_nmvsadcosts' in vp9_encoder.c:
+//   - mvjointsadcost[1] == mvjointsadcost[2] == mvjointsadcost[3]
+//   - For all i: mvsadcost[0][i] == mvsadcost[1][i]
+//   - For all i: mvsadcost[0][i] == mvsadcost[0][-i]
+int vp9_diamond_search_sad_avx2(const MACROBLOCK *x,
+                                const search_site_config *cfg, MV *ref_mv,
+                                uint32_t start_mv_sad, MV *best_mv,
+                                int search_param, int sad_per_bit, int *num00,
+                                const vp9_sad_fn_ptr_t *sad_fn_ptr,
+                                const MV *center_mv) {
+  const __m128i v_idx_d = _mm_setr_epi32(0, 1, 2, 3);
+
+  const int_mv maxmv = pack_int_mv(x->mv_limits.row_max, x->mv_limits.col_max);
+  const __m128i v_max_mv_w = _mm_set1_epi32((int)maxmv.as_int);
+  const int_mv minmv = pack_int_mv(x->mv_limits.row_min, x->mv_limits.col_min);
+  const __m128i v_min_mv_w = _mm_set1_epi32((int)minmv.as_int);
+
+  const __m128i v_spb_d = _mm_set1_epi32(sad_per_bit);
+
+  const __m128i v_joint_cost_0_d = _mm_set1_epi32(x->nmvjointsadcost[0]);
+  const __m128i v_joint_cost_1_d = _mm_set1_epi32(x->nmvjointsadcost[1]);
+
+  // search_param determines the length of the initial step and hence the number
+  // of iterations.
+  // 0 = initial step (MAX_FIRST_STEP) pel
+  // 1 = (MAX_FIRST_STEP/2) pel,
+  // 2 = (MAX_FIRST_STEP/4) pel...
+  const MV *ss_mv = &cfg->ss_mv[cfg->searches_per_step * search_param];
+  const intptr_t *ss_os = &cfg->ss_os[cfg->searches_per_step * search_param];
+  const int tot_steps = cfg->total_steps - search_param;
+
+  const int_mv fcenter_mv =
+      pack_int_mv(center_mv->row >> 3, center_mv->col >> 3);
+  const __m128i vfcmv = _mm_set1_epi32((int)fcenter_mv.as_int);
+
+  const int ref_row = ref_mv->row;
+  const int ref_col = ref_mv->col;
+
+  int_mv bmv = pack_int_mv(ref_row, ref_col);
+  int_mv new_bmv = bmv;
+  __m128i v_bmv_w = _mm_set1_epi32((int)bmv.as_int);
+
+  const int what_stride = x->plane[0].src.stride;
+  const int in_what_stride = x->e_mbd.plane[0].pre[0].stride;
+  const uint8_t *const what = x->plane[0].src.buf;
+  const uint8_t *const in_what =
+      x->e_mbd.plane[0].pre[0].buf + ref_row * in_what_stride + ref_col;
+
+  // Work out the start point for the search
+  const uint8_t *best_address = in_what;
+  const uint8_t *new_best_address = best_address;
+#if VPX_ARCH_X86_64
+  __m256i v_ba_q = _mm256_set1_epi64x((intptr_t)best_address);
+#else
+  __m128i v_ba_d = _mm_set1_epi32((intptr_t)best_address);
+#endif
+  // Starting position
+  unsigned int best_sad = start_mv_sad;
+  int i, j, step;
+
+  // Check the prerequisite cost function properties that are easy to check
+  // in an assert. See the function-level documentation for details on all
+  // prerequisites.
+  assert(x->nmvjointsadcost[1] == x->nmvjointsadcost[2]);
+  assert(x->nmvjointsadcost[1] == x->nmvjointsadcost[3]);
+  assert(cfg->searches_per_step % 4 == 0);
+
+  *num00 = 0;
+
+  for (i = 0, step = 0; step < tot_steps; step++) {
+    for (j = 0; j < cfg->searches_per_step; j += 4, i += 4) {
+      __m128i v_diff_mv_w, v_inside_d, v_outside_d, v_cost_d, v_sad_d;
+      DECLARE_ALIGNED(32, const uint8_t *, block_addr[4]);
+
+      // Compute the candidate motion vectors
+      const __m128i v_ss_mv_w = _mm_loadu_si128((const __m128i *)&ss_mv[i]);
+      const __m128i v_these_mv_w = _mm_add_epi16(v_bmv_w, v_ss_mv_w);
+      // Clamp them to the search bounds
+      __m128i v_these_mv_clamp_w = v_these_mv_w;
+      v_these_mv_clamp_w = _mm_min_epi16(v_these_mv_clamp_w, v_max_mv_w);
+      v_these_mv_clamp_w = _mm_max_epi16(v_these_mv_clamp_w, v_min_mv_w);
+      // The ones that did not change are inside the search area
+      v_inside_d = _mm_cmpeq_epi32(v_these_mv_clamp_w, v_these_mv_w);
+
+      // If none of them are inside, then move on
+      if (UNLIKELY(_mm_testz_si128(v_inside_d, v_inside_d))) {
+        continue;
+      }
+
+      // The inverse mask indicates which of the MVs are outside. Shift right
+      // to keep the sign bit clear, we will use this later to set the cost to
+      // the maximum value.
+      v_outside_d =
+          _mm_srli_epi32(_mm_xor_si128(v_inside_d, _mm_set1_epi32(-1)), 1);
+
+      // Compute the difference MV. We utilise the fact that the cost function
+      // is even, and use the absolute difference. This allows us to use
+      // unsigned indexes later and reduces cache pressure somewhat as only a
+      // half of the table is ever referenced.
+      v_diff_mv_w = _mm_abs_epi16(_mm_sub_epi16(v_these_mv_clamp_w, vfcmv));
+
+      // Compute the candidate addresses, the ones falling outside point to
+      // the current best.
+      {
+#if VPX_ARCH_X86_64  //  sizeof(intptr_t) == 8
+        __m256i v_bo_q = _mm256_loadu_si256((const __m256i *)&ss_os[i]);
+        v_bo_q = _mm256_and_si256(v_bo_q, _mm256_cvtepi32_epi64(v_inside_d));
+        _mm256_store_si256((__m256i *)block_addr,
+                           _mm256_add_epi64(v_ba_q, v_bo_q));
+#else  // sizeof(intptr_t) == 4
+        __m128i v_bo_d = _mm_loadu_si128((const __m128i *)&ss_os[i]);
+        v_bo_d = _mm_and_si128(v_bo_d, v_inside_d);
+        _mm_store_si128((__m128i *)&block_addr[0],
+                        _mm_add_epi32(v_ba_d, v_bo_d));
+#endif
+      }
+
+      {
+        DECLARE_ALIGNED(16, uint32_t, sad[4]);
+        sad_fn_ptr->sdx4df(what, what_stride, block_addr, in_what_stride, sad);
+        v_sad_d = _mm_load_si128((const __m128i *)sad);
+      }
+
+      // Look up the component cost of the residual motion vector. The rows
+      // are in the low and the columns in the high halves of the 32-bit
+      // lanes.
+      {
+        const __m128i v_row_d =
+            _mm_blend_epi16(v_diff_mv_w, _mm_setzero_si128(), 0xaa);
+        const __m128i v_col_d = _mm_srli_epi32(v_diff_mv_w, 16);
+        v_cost_d =
+            _mm_add_epi32(_mm_i32gather_epi32(x->nmvsadcost[0], v_row_d, 4),
+                          _mm_i32gather_epi32(x->nmvsadcost[0], v_col_d, 4));
+      }
+
+      // Now add in the joint cost
+      {
+        const __m128i v_sel_d =
+            _mm_cmpeq_epi32(v_diff_mv_w, _mm_setzero_si128());
+        const __m128i v_joint_cost_d =
+            _mm_blendv_epi8(v_joint_cost_1_d, v_joint_cost_0_d, v_sel_d);
+        v_cost_d = _mm_add_epi32(v_cost_d, v_joint_cost_d);
+      }
+
+      // Multiply by sad_per_bit
+      v_cost_d = _mm_mullo_epi32(v_cost_d, v_spb_d);
+      // ROUND_POWER_OF_TWO(v_cost_d, VP9_PROB_COST_SHIFT)
+      v_cost_d = _mm_add_epi32(v_cost_d,
+                               _mm_set1_epi32(1 << (VP9_PROB_COST_SHIFT - 1)));
+      v_cost_d = _mm_srai_epi32(v_cost_d, VP9_PROB_COST_SHIFT);
+      // Add the cost to the sad
+      v_sad_d = _mm_add_epi32(v_sad_d, v_cost_d);
+
+      // Make the motion vectors outside the search area have max cost
+      // by or'ing in the comparison mask, this way the minimum search won't
+      // pick them.
+      v_sad_d = _mm_or_si128(v_sad_d, v_outside_d);
+
+      // Find the minimum value and index horizontally in v_sad_d
+      {
+        const __m128i v_min_d = hmin_epu32(v_sad_d);
+        const uint32_t local_best_sad = (uint32_t)_mm_cvtsi128_si32(v_min_d);
+
+        // Update the global minimum if the local minimum is smaller
+        if (LIKELY(local_best_sad < best_sad)) {
+          // The lowest index holding the minimum, as in the C version.
+          const __m128i v_sel_d = _mm_cmpeq_epi32(v_sad_d, v_min_d);
+          const __m128i v_mask_d =
+              _mm_blendv_epi8(_mm_set1_epi32(-1), v_idx_d, v_sel_d);
+          const int local_best_idx = _mm_cvtsi128_si32(hmin_epu32(v_mask_d));
+          DECLARE_ALIGNED(16, int_mv, these_mv[4]);
+          _mm_store_si128((__m128i *)these_mv, v_these_mv_w);
+
+          new_bmv = these_mv[local_best_idx];
+          new_best_address = block_addr[local_best_idx];
+
+          best_sad = local_best_sad;
+        }
+      }
+    }
+
+    bmv = new_bmv;
+    best_address = new_best_address;
+
+    v_bmv_w = _mm_set1_epi32((int)bmv.as_int);
+#if VPX_ARCH_X86_64
+    v_ba_q = _mm256_set1_epi64x((intptr_t)best_address);
+#else
+    v_ba_d = _mm_set1_epi32((intptr_t)best_address);
+#endif
+
+    if (UNLIKELY(best_address == in_what)) {
+      (*num00)++;
+    }
+  }
+
+  *best_mv = bmv.as_mv;
+  return best_sad;
+}
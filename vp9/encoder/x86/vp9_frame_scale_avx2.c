@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "vp9/encoder/x86/vp9_frame_scale_x86.h"
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_dsp/vpx_filter.h"
+
+static INLINE __m256i load_halves(const uint8_t *src, const int *x_offsets,
+                                  int i) {
+  const __m128i lo = _mm_loadu_si128((const __m128i *)(src + x_offsets[i]));
+  const __m128i hi =
+      _mm_loadu_si128((const __m128i *)(src + x_offsets[i + 4]));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+// Rounds the sums of pels 0-3 in the low lane and 4-7 in the high lane and
+// stores the 8 pels.
+static INLINE void store_group(__m256i sum, uint8_t *dst) {
+  const __m256i round = _mm256_set1_epi32(1 << (FILTER_BITS - 1));
+  __m256i res = _mm256_srai_epi32(_mm256_add_epi32(sum, round), FILTER_BITS);
+  res = _mm256_packs_epi32(res, res);
+  res = _mm256_packus_epi16(res, res);
+  _mm_storel_epi64((__m128i *)dst,
+                   _mm_unpacklo_epi32(_mm256_castsi256_si128(res),
+                                      _mm256_extracti128_si256(res, 1)));
+}
+
+static INLINE void filter_group(const uint8_t *src, const int *x_offsets,
+                                const ScaleHorizGroup *g, int loads,
+                                uint8_t *dst) {
+  const __m256i s0 = load_halves(src, x_offsets, 0);
+  const __m256i s1 =
+      loads == 2 ? load_halves(src, x_offsets, 2) : _mm256_setzero_si256();
+  __m256i sum = _mm256_setzero_si256();
+  int j;
+  for (j = 0; j < SUBPEL_TAPS / 2; ++j) {
+    const __m256i *const m0 = (const __m256i *)g->mask[0][j];
+    const __m256i *const m1 = (const __m256i *)g->mask[1][j];
+    const __m256i *const f = (const __m256i *)g->filter[j];
+    __m256i taps = _mm256_shuffle_epi8(s0, _mm256_load_si256(m0));
+    if (loads == 2) {
+      taps = _mm256_or_si256(taps,
+                             _mm256_shuffle_epi8(s1, _mm256_load_si256(m1)));
+    }
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(taps, _mm256_load_si256(f)));
+  }
+  store_group(sum, dst);
+}
+
+void vp9_scale_filter_horiz_avx2(const uint8_t *src, int src_stride,
+                                 const int *x_offsets,
+                                 const int16_t *const *x_filters, uint8_t *dst,
+                                 int dst_stride, int w, int h) {
+  ScaleHorizGroup groups[SCALE_CHUNK_GROUPS];
+  int x = 0;
+
+  // Gather the columns in chunks so the masks stay in L1 for all the rows.
+  while (x + SCALE_GROUP_PELS <= w) {
+    const int n = VPXMIN((w - x) / SCALE_GROUP_PELS, SCALE_CHUNK_GROUPS);
+    const int loads =
+        scale_horiz_build_chunk(x_offsets + x, x_filters + x, n, groups);
+    const int *const offsets = x_offsets + x;
+    const uint8_t *s = src;
+    uint8_t *d = dst + x;
+    int y, i;
+    if (!loads) {
+      vp9_scale_filter_horiz_c(src, src_stride, offsets, x_filters + x, d,
+                               dst_stride, SCALE_GROUP_PELS * n, h);
+    } else if (loads == 1) {
+      for (y = 0; y < h; ++y, s += src_stride, d += dst_stride) {
+        for (i = 0; i < n; ++i) {
+          filter_group(s, offsets + SCALE_GROUP_PELS * i, &groups[i], 1,
+                       d + SCALE_GROUP_PELS * i);
+        }
+      }
+    } else {
+      for (y = 0; y < h; ++y, s += src_stride, d += dst_stride) {
+        for (i = 0; i < n; ++i) {
+          filter_group(s, offsets + SCALE_GROUP_PELS * i, &groups[i], 2,
+                       d + SCALE_GROUP_PELS * i);
+        }
+      }
+    }
+    x += SCALE_GROUP_PELS * n;
+  }
+  if (x < w) {
+    vp9_scale_filter_horiz_c(src, src_stride, x_offsets + x, x_filters + x,
+                             dst + x, dst_stride, w - x, h);
+  }
+}
@@ -16,6 +16,7 @@
 #include "vpx_dsp/x86/convolve_ssse3.h"
 #include "vpx_dsp/x86/mem_sse2.h"
 #include "vpx_dsp/x86/transpose_sse2.h"
+#include "vp9/encoder/x86/vp9_frame_scale_x86.h"
 #include "vpx_scale/yv12config.h"
 
 static INLINE __m128i scale_plane_2_to_1_phase_0_kernel(
@@ -905,3 +906,80 @@ void vp9_scale_and_extend_frame_ssse3(const YV12_BUFFER_CONFIG *src,
     vp9_scale_and_extend_frame_c(src, dst, filter_type, phase_scaler);
   }
 }
+
+// Filters the 4 pels of half h of a group into 32-bit sums.
+static INLINE __m128i filter_half(const uint8_t *src, const int *x_offsets,
+                                  const ScaleHorizGroup *g, int loads,
+                                  int h) {
+  const __m128i s0 =
+      _mm_loadu_si128((const __m128i *)(src + x_offsets[4 * h]));
+  const __m128i s1 =
+      loads == 2
+          ? _mm_loadu_si128((const __m128i *)(src + x_offsets[4 * h + 2]))
+          : _mm_setzero_si128();
+  __m128i sum = _mm_set1_epi32(1 << (FILTER_BITS - 1));
+  int j;
+  for (j = 0; j < SUBPEL_TAPS / 2; ++j) {
+    const __m128i *const m0 = (const __m128i *)&g->mask[0][j][16 * h];
+    const __m128i *const m1 = (const __m128i *)&g->mask[1][j][16 * h];
+    const __m128i *const f = (const __m128i *)&g->filter[j][8 * h];
+    __m128i taps = _mm_shuffle_epi8(s0, _mm_load_si128(m0));
+    if (loads == 2) {
+      taps = _mm_or_si128(taps, _mm_shuffle_epi8(s1, _mm_load_si128(m1)));
+    }
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(taps, _mm_load_si128(f)));
+  }
+  return _mm_srai_epi32(sum, FILTER_BITS);
+}
+
+static INLINE void filter_group(const uint8_t *src, const int *x_offsets,
+                                const ScaleHorizGroup *g, int loads,
+                                uint8_t *dst) {
+  const __m128i res =
+      _mm_packs_epi32(filter_half(src, x_offsets, g, loads, 0),
+                      filter_half(src, x_offsets, g, loads, 1));
+  _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(res, res));
+}
+
+void vp9_scale_filter_horiz_ssse3(const uint8_t *src, int src_stride,
+                                  const int *x_offsets,
+                                  const int16_t *const *x_filters,
+                                  uint8_t *dst, int dst_stride, int w,
+                                  int h) {
+  ScaleHorizGroup groups[SCALE_CHUNK_GROUPS];
+  int x = 0;
+
+  // Gather the columns in chunks so the masks stay in L1 for all the rows.
+  while (x + SCALE_GROUP_PELS <= w) {
+    const int n = VPXMIN((w - x) / SCALE_GROUP_PELS, SCALE_CHUNK_GROUPS);
+    const int loads =
+        scale_horiz_build_chunk(x_offsets + x, x_filters + x, n, groups);
+    const int *const offsets = x_offsets + x;
+    const uint8_t *s = src;
+    uint8_t *d = dst + x;
+    int y, i;
+    if (!loads) {
+      vp9_scale_filter_horiz_c(src, src_stride, offsets, x_filters + x, d,
+                               dst_stride, SCALE_GROUP_PELS * n, h);
+    } else if (loads == 1) {
+      for (y = 0; y < h; ++y, s += src_stride, d += dst_stride) {
+        for (i = 0; i < n; ++i) {
+          filter_group(s, offsets + SCALE_GROUP_PELS * i, &groups[i], 1,
+                       d + SCALE_GROUP_PELS * i);
+        }
+      }
+    } else {
+      for (y = 0; y < h; ++y, s += src_stride, d += dst_stride) {
+        for (i = 0; i < n; ++i) {
+          filter_group(s, offsets + SCALE_GROUP_PELS * i, &groups[i], 2,
+                       d + SCALE_GROUP_PELS * i);
+        }
+      }
+    }
+    x += SCALE_GROUP_PELS * n;
+  }
+  if (x < w) {
+    vp9_scale_filter_horiz_c(src, src_stride, x_offsets + x, x_filters + x,
+                             dst + x, dst_stride, w - x, h);
+  }
+}
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VP9_ENCODER_X86_VP9_FRAME_SCALE_X86_H_
+#define VPX_VP9_ENCODER_X86_VP9_FRAME_SCALE_X86_H_
+
+#include <string.h>
+
+#include "./vpx_config.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_dsp/vpx_filter.h"
+#include "vpx_ports/mem.h"
+
+// vp9_scale_filter_horiz() works on groups of 8 output pels, split in two
+// halves of 4 pels. The taps of a half are gathered with pshufb from one
+// 16-byte load at the taps of its first pel, or, when the taps spread too far
+// for that, from two loads at the taps of its pels 0 and 2. The loads may
+// read up to 8 pels past the last tap.
+#define SCALE_GROUP_PELS 8
+#define SCALE_CHUNK_GROUPS 8
+
+typedef struct ScaleHorizGroup {
+  // Gather masks per load and pair of taps. Each pel takes 4 bytes, its two
+  // taps zero extended to 16 bits, so the taps can be applied with pmaddwd.
+  DECLARE_ALIGNED(32, uint8_t, mask[2][SUBPEL_TAPS / 2][32]);
+  DECLARE_ALIGNED(32, int16_t, filter[SUBPEL_TAPS / 2][16]);
+} ScaleHorizGroup;
+
+// Returns 0 if a pel of the group is out of reach of its load.
+static INLINE int scale_horiz_build_group(const int *x_offsets,
+                                          const int16_t *const *x_filters,
+                                          int loads, ScaleHorizGroup *g) {
+  int i, j;
+  for (i = 0; i < SCALE_GROUP_PELS; ++i) {
+    const int half = i >> 2;
+    const int slot = i & 3;
+    const int load = loads == 2 ? slot >> 1 : 0;
+    const int rel = x_offsets[i] - x_offsets[4 * half + 2 * load];
+    if (rel < 0 || rel > 16 - SUBPEL_TAPS) return 0;
+    for (j = 0; j < SUBPEL_TAPS / 2; ++j) {
+      // Taps 2 * j and 2 * j + 1, each followed by a zero byte.
+      const uint32_t taps = (uint32_t)(rel + 2 * j) * 0x10001u + 0x80018000u;
+      const uint32_t zero = 0x80808080u;
+      memcpy(&g->mask[load][j][16 * half + 4 * slot], &taps, sizeof(taps));
+      memcpy(&g->mask[!load][j][16 * half + 4 * slot], &zero, sizeof(zero));
+      memcpy(&g->filter[j][8 * half + 2 * slot], &x_filters[i][2 * j],
+             2 * sizeof(x_filters[i][0]));
+    }
+  }
+  return 1;
+}
+
+// Builds the groups for 8 * n pels and returns the number of loads per half
+// they need, or 0 if they can't all be gathered.
+static INLINE int scale_horiz_build_chunk(const int *x_offsets,
+                                          const int16_t *const *x_filters,
+                                          int n, ScaleHorizGroup *groups) {
+  int loads, i;
+  for (loads = 1; loads <= 2; ++loads) {
+    for (i = 0; i < n; ++i) {
+      if (!scale_horiz_build_group(x_offsets + SCALE_GROUP_PELS * i,
+                                   x_filters + SCALE_GROUP_PELS * i, loads,
+                                   &groups[i])) {
+        break;
+      }
+    }
+    if (i == n) return loads;
+  }
+  return 0;
+}
+
+#endif  // VPX_VP9_ENCODER_X86_VP9_FRAME_SCALE_X86_H_
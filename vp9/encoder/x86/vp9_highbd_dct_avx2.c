@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "./vpx_dsp_rtcd.h"
+#include "vp9/common/vp9_enums.h"
+#include "vpx_dsp/txfm_common.h"
+
+#define FHT_VEC __m256i
+#define FHT_LANES 8
+#define ZERO_VEC _mm256_setzero_si256()
+#define ADD_EPI32 _mm256_add_epi32
+#define SUB_EPI32 _mm256_sub_epi32
+
+// _mm256_mul_epi32() only reads the low 32 bits of each 64-bit lane, so the
+// constant can be broadcast to every 32-bit lane. As in the SSE4.1 version
+// constants are scaled by 4 so the rounding shift can move whole bytes.
+static INLINE void mul_wide(const __m256i in, const int c,
+                            __m256i *const out /*out[2]*/) {
+  const __m256i cst = _mm256_set1_epi32(4 * c);
+  out[0] = _mm256_mul_epi32(_mm256_unpacklo_epi32(in, in), cst);
+  out[1] = _mm256_mul_epi32(_mm256_unpackhi_epi32(in, in), cst);
+}
+
+static INLINE void add_wide(const __m256i *const in0, const __m256i *const in1,
+                            __m256i *const out /*out[2]*/) {
+  out[0] = _mm256_add_epi64(in0[0], in1[0]);
+  out[1] = _mm256_add_epi64(in0[1], in1[1]);
+}
+
+static INLINE void sub_wide(const __m256i *const in0, const __m256i *const in1,
+                            __m256i *const out /*out[2]*/) {
+  out[0] = _mm256_sub_epi64(in0[0], in1[0]);
+  out[1] = _mm256_sub_epi64(in0[1], in1[1]);
+}
+
+static INLINE __m256i round_wide(const __m256i *const in /*in[2]*/) {
+  const __m256i rounding = _mm256_set1_epi64x(DCT_CONST_ROUNDING << 2);
+  const __m256i t0 = _mm256_srli_si256(_mm256_add_epi64(in[0], rounding), 2);
+  const __m256i t1 = _mm256_srli_si256(_mm256_add_epi64(in[1], rounding), 2);
+  const __m256i u0 = _mm256_unpacklo_epi32(t0, t1);
+  const __m256i u1 = _mm256_unpackhi_epi32(t0, t1);
+  return _mm256_unpacklo_epi32(u0, u1);
+}
+
+#include "vp9/encoder/x86/vp9_highbd_fht_impl.h"
+
+typedef void (*fht_cols_fn)(__m256i *io);
+
+static INLINE void load_cols(const int16_t *input, int stride, int size,
+                             int shift, __m256i *const out) {
+  int i;
+  for (i = 0; i < size; ++i) {
+    out[i] = _mm256_cvtepi16_epi32(
+        _mm_loadu_si128((const __m128i *)(input + i * stride)));
+    out[i] = _mm256_slli_epi32(out[i], shift);
+  }
+}
+
+static INLINE void transpose_32bit_8x8_avx2(const __m256i *const in,
+                                            __m256i *const out) {
+  __m256i a[8], b[8];
+  int i;
+
+  for (i = 0; i < 4; ++i) {
+    a[2 * i + 0] = _mm256_unpacklo_epi32(in[2 * i], in[2 * i + 1]);
+    a[2 * i + 1] = _mm256_unpackhi_epi32(in[2 * i], in[2 * i + 1]);
+  }
+  for (i = 0; i < 2; ++i) {
+    b[4 * i + 0] = _mm256_unpacklo_epi64(a[4 * i + 0], a[4 * i + 2]);
+    b[4 * i + 1] = _mm256_unpackhi_epi64(a[4 * i + 0], a[4 * i + 2]);
+    b[4 * i + 2] = _mm256_unpacklo_epi64(a[4 * i + 1], a[4 * i + 3]);
+    b[4 * i + 3] = _mm256_unpackhi_epi64(a[4 * i + 1], a[4 * i + 3]);
+  }
+  for (i = 0; i < 4; ++i) {
+    out[i] = _mm256_permute2x128_si256(b[i], b[i + 4], 0x20);
+    out[i + 4] = _mm256_permute2x128_si256(b[i], b[i + 4], 0x31);
+  }
+}
+
+// Transposes an n x n block of 32-bit values held as n / 8 column groups of
+// n rows each.
+static INLINE void transpose_groups(__m256i *const io, int n) {
+  const int groups = n / 8;
+  __m256i t[32];
+  int r, c, i;
+  for (r = 0; r < groups; ++r) {
+    for (c = 0; c < groups; ++c) {
+      transpose_32bit_8x8_avx2(io + c * n + r * 8, t + r * n + c * 8);
+    }
+  }
+  for (i = 0; i < n * groups; ++i) io[i] = t[i];
+}
+
+static INLINE void store_groups(const __m256i *const in, int n,
+                                tran_low_t *output) {
+  int r, c;
+  for (r = 0; r < n; ++r) {
+    for (c = 0; c < n / 8; ++c) {
+      _mm256_storeu_si256((__m256i *)(output + r * n + c * 8), in[c * n + r]);
+    }
+  }
+}
+
+void vp9_highbd_fht8x8_avx2(const int16_t *input, tran_low_t *output,
+                            int stride, int tx_type) {
+  static const fht_cols_fn cols[4] = { fdct8_cols, fadst8_cols, fdct8_cols,
+                                       fadst8_cols };
+  static const fht_cols_fn rows[4] = { fdct8_cols, fdct8_cols, fadst8_cols,
+                                       fadst8_cols };
+  __m256i in[8];
+  int i;
+
+  if (tx_type == DCT_DCT) {
+    vpx_highbd_fdct8x8_sse2(input, output, stride);
+    return;
+  }
+
+  load_cols(input, stride, 8, 2, in);
+  cols[tx_type](in);
+  transpose_32bit_8x8_avx2(in, in);
+  rows[tx_type](in);
+  transpose_32bit_8x8_avx2(in, in);
+  for (i = 0; i < 8; ++i) {
+    // (x + (x < 0)) >> 1
+    in[i] = _mm256_srai_epi32(
+        _mm256_sub_epi32(in[i], _mm256_srai_epi32(in[i], 31)), 1);
+  }
+  store_groups(in, 8, output);
+}
+
+void vp9_highbd_fht16x16_avx2(const int16_t *input, tran_low_t *output,
+                              int stride, int tx_type) {
+  static const fht_cols_fn cols[4] = { fdct16_cols, fadst16_cols, fdct16_cols,
+                                       fadst16_cols };
+  static const fht_cols_fn rows[4] = { fdct16_cols, fdct16_cols, fadst16_cols,
+                                       fadst16_cols };
+  const __m256i one = _mm256_set1_epi32(1);
+  __m256i in[32];
+  int i;
+
+  if (tx_type == DCT_DCT) {
+    vpx_highbd_fdct16x16_sse2(input, output, stride);
+    return;
+  }
+
+  for (i = 0; i < 2; ++i) {
+    load_cols(input + i * 8, stride, 16, 2, in + i * 16);
+    cols[tx_type](in + i * 16);
+  }
+  for (i = 0; i < 32; ++i) {
+    // (x + 1 + (x < 0)) >> 2
+    const __m256i t = _mm256_sub_epi32(in[i], _mm256_srai_epi32(in[i], 31));
+    in[i] = _mm256_srai_epi32(_mm256_add_epi32(t, one), 2);
+  }
+  transpose_groups(in, 16);
+  for (i = 0; i < 2; ++i) rows[tx_type](in + i * 16);
+  transpose_groups(in, 16);
+  store_groups(in, 16, output);
+}
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <smmintrin.h>  // SSE4.1
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "./vpx_dsp_rtcd.h"
+#include "vp9/common/vp9_enums.h"
+#include "vpx_dsp/x86/highbd_inv_txfm_sse2.h"
+#include "vpx_dsp/x86/transpose_sse2.h"
+
+#define FHT_VEC __m128i
+#define FHT_LANES 4
+#define ZERO_VEC _mm_setzero_si128()
+#define ADD_EPI32 _mm_add_epi32
+#define SUB_EPI32 _mm_sub_epi32
+
+// Constants are scaled by 4 so dct_const_round_shift_64bit() can shift by
+// whole bytes.
+static INLINE void mul_wide(const __m128i in, const int c,
+                            __m128i *const out /*out[2]*/) {
+  const __m128i pair_c = pair_set_epi32(4 * c, 0);
+  extend_64bit(in, out);
+  out[0] = _mm_mul_epi32(out[0], pair_c);
+  out[1] = _mm_mul_epi32(out[1], pair_c);
+}
+
+static INLINE void add_wide(const __m128i *const in0, const __m128i *const in1,
+                            __m128i *const out /*out[2]*/) {
+  out[0] = _mm_add_epi64(in0[0], in1[0]);
+  out[1] = _mm_add_epi64(in0[1], in1[1]);
+}
+
+static INLINE void sub_wide(const __m128i *const in0, const __m128i *const in1,
+                            __m128i *const out /*out[2]*/) {
+  out[0] = _mm_sub_epi64(in0[0], in1[0]);
+  out[1] = _mm_sub_epi64(in0[1], in1[1]);
+}
+
+static INLINE __m128i round_wide(const __m128i *const in /*in[2]*/) {
+  return pack_4(dct_const_round_shift_64bit(in[0]),
+                dct_const_round_shift_64bit(in[1]));
+}
+
+#include "vp9/encoder/x86/vp9_highbd_fht_impl.h"
+
+typedef void (*fht_cols_fn)(__m128i *io);
+
+// Loads a 4-wide column group of |size| rows, sign extended and scaled.
+static INLINE void load_cols(const int16_t *input, int stride, int size,
+                             int shift, __m128i *const out) {
+  int i;
+  for (i = 0; i < size; ++i) {
+    out[i] = _mm_cvtepi16_epi32(
+        _mm_loadl_epi64((const __m128i *)(input + i * stride)));
+    out[i] = _mm_slli_epi32(out[i], shift);
+  }
+}
+
+// Transposes an n x n block of 32-bit values held as n / 4 column groups of
+// n rows each.
+static INLINE void transpose_groups(__m128i *const io, int n) {
+  const int groups = n / 4;
+  __m128i t[64];
+  int r, c, i;
+  for (r = 0; r < groups; ++r) {
+    for (c = 0; c < groups; ++c) {
+      transpose_32bit_4x4(io + c * n + r * 4, t + r * n + c * 4);
+    }
+  }
+  for (i = 0; i < n * groups; ++i) io[i] = t[i];
+}
+
+// (x + 1 + (x < 0)) >> 2
+static INLINE __m128i half_round_shift(const __m128i in) {
+  const __m128i t = _mm_sub_epi32(in, _mm_srai_epi32(in, 31));
+  return _mm_srai_epi32(_mm_add_epi32(t, _mm_set1_epi32(1)), 2);
+}
+
+static INLINE void store_groups(const __m128i *const in, int n,
+                                tran_low_t *output) {
+  int r, c;
+  for (r = 0; r < n; ++r) {
+    for (c = 0; c < n / 4; ++c) {
+      _mm_storeu_si128((__m128i *)(output + r * n + c * 4), in[c * n + r]);
+    }
+  }
+}
+
+void vp9_highbd_fht4x4_sse4_1(const int16_t *input, tran_low_t *output,
+                              int stride, int tx_type) {
+  static const fht_cols_fn cols[4] = { fdct4_cols, fadst4_cols, fdct4_cols,
+                                       fadst4_cols };
+  static const fht_cols_fn rows[4] = { fdct4_cols, fdct4_cols, fadst4_cols,
+                                       fadst4_cols };
+  __m128i in[4];
+  int i;
+
+  if (tx_type == DCT_DCT) {
+    vpx_highbd_fdct4x4_sse2(input, output, stride);
+    return;
+  }
+
+  load_cols(input, stride, 4, 4, in);
+  // if (i == 0 && temp_in[0]) temp_in[0] += 1;
+  if (input[0]) in[0] = _mm_add_epi32(in[0], _mm_setr_epi32(1, 0, 0, 0));
+  cols[tx_type](in);
+  transpose_32bit_4x4(in, in);
+  rows[tx_type](in);
+  transpose_32bit_4x4(in, in);
+  for (i = 0; i < 4; ++i) {
+    in[i] = _mm_srai_epi32(_mm_add_epi32(in[i], _mm_set1_epi32(1)), 2);
+    _mm_storeu_si128((__m128i *)(output + i * 4), in[i]);
+  }
+}
+
+void vp9_highbd_fht8x8_sse4_1(const int16_t *input, tran_low_t *output,
+                              int stride, int tx_type) {
+  static const fht_cols_fn cols[4] = { fdct8_cols, fadst8_cols, fdct8_cols,
+                                       fadst8_cols };
+  static const fht_cols_fn rows[4] = { fdct8_cols, fdct8_cols, fadst8_cols,
+                                       fadst8_cols };
+  __m128i in[16];
+  int i;
+
+  if (tx_type == DCT_DCT) {
+    vpx_highbd_fdct8x8_sse2(input, output, stride);
+    return;
+  }
+
+  for (i = 0; i < 2; ++i) {
+    load_cols(input + i * 4, stride, 8, 2, in + i * 8);
+    cols[tx_type](in + i * 8);
+  }
+  transpose_groups(in, 8);
+  for (i = 0; i < 2; ++i) rows[tx_type](in + i * 8);
+  transpose_groups(in, 8);
+  for (i = 0; i < 16; ++i) {
+    // (x + (x < 0)) >> 1
+    in[i] = _mm_srai_epi32(_mm_sub_epi32(in[i], _mm_srai_epi32(in[i], 31)), 1);
+  }
+  store_groups(in, 8, output);
+}
+
+void vp9_highbd_fht16x16_sse4_1(const int16_t *input, tran_low_t *output,
+                                int stride, int tx_type) {
+  static const fht_cols_fn cols[4] = { fdct16_cols, fadst16_cols, fdct16_cols,
+                                       fadst16_cols };
+  static const fht_cols_fn rows[4] = { fdct16_cols, fdct16_cols, fadst16_cols,
+                                       fadst16_cols };
+  __m128i in[64];
+  int i;
+
+  if (tx_type == DCT_DCT) {
+    vpx_highbd_fdct16x16_sse2(input, output, stride);
+    return;
+  }
+
+  for (i = 0; i < 4; ++i) {
+    load_cols(input + i * 4, stride, 16, 2, in + i * 16);
+    cols[tx_type](in + i * 16);
+  }
+  for (i = 0; i < 64; ++i) in[i] = half_round_shift(in[i]);
+  transpose_groups(in, 16);
+  for (i = 0; i < 4; ++i) rows[tx_type](in + i * 16);
+  transpose_groups(in, 16);
+  store_groups(in, 16, output);
+}
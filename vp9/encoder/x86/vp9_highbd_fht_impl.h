@@ -0,0 +1,362 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Column-parallel 1-D forward transforms used by the high bitdepth
+// vp9_highbd_fht*() functions. Every 32-bit lane of a vector holds one column,
+// so io[j] is row j of the group of columns being transformed. Products are
+// accumulated in 64 bits to stay bit-exact with the C code for 12-bit input.
+//
+// The including file defines:
+//   FHT_VEC      the vector type;
+//   FHT_LANES    the number of 32-bit lanes in FHT_VEC;
+//   ZERO_VEC     an all-zero FHT_VEC;
+//   ADD_EPI32    32-bit lane addition;
+//   SUB_EPI32    32-bit lane subtraction;
+//   mul_wide()   widens in * c to 64-bit products in out[2];
+//   add_wide()   64-bit addition of two widened values;
+//   sub_wide()   64-bit subtraction of two widened values;
+//   round_wide() narrows fdct_round_shift() of a widened value to 32 bits.
+
+#include "vpx_dsp/txfm_common.h"
+
+static INLINE void madd_wide(const FHT_VEC in0, const int c0,
+                             const FHT_VEC in1, const int c1,
+                             FHT_VEC *const out /*out[2]*/) {
+  FHT_VEC t[2];
+  mul_wide(in0, c0, out);
+  mul_wide(in1, c1, t);
+  add_wide(out, t, out);
+}
+
+// Returns fdct_round_shift(in * c).
+static INLINE FHT_VEC mul_round(const FHT_VEC in, const int c) {
+  FHT_VEC t[2];
+  mul_wide(in, c, t);
+  return round_wide(t);
+}
+
+// Returns fdct_round_shift(in0 * c0 + in1 * c1).
+static INLINE FHT_VEC madd_round(const FHT_VEC in0, const int c0,
+                                 const FHT_VEC in1, const int c1) {
+  FHT_VEC t[2];
+  madd_wide(in0, c0, in1, c1, t);
+  return round_wide(t);
+}
+
+// Returns fdct_round_shift(in0 + in1) and fdct_round_shift(in0 - in1).
+static INLINE void add_sub_round(const FHT_VEC *const in0,
+                                 const FHT_VEC *const in1,
+                                 FHT_VEC *const sum, FHT_VEC *const diff) {
+  FHT_VEC t[2];
+  add_wide(in0, in1, t);
+  *sum = round_wide(t);
+  sub_wide(in0, in1, t);
+  *diff = round_wide(t);
+}
+
+static INLINE FHT_VEC neg_epi32(const FHT_VEC in) {
+  return SUB_EPI32(ZERO_VEC, in);
+}
+
+// Only 4x4 blocks map onto a vector of 4 columns.
+#if FHT_LANES == 4
+static void fdct4_cols(FHT_VEC *const io /*io[4]*/) {
+  const FHT_VEC s0 = ADD_EPI32(io[0], io[3]);
+  const FHT_VEC s1 = ADD_EPI32(io[1], io[2]);
+  const FHT_VEC s2 = SUB_EPI32(io[1], io[2]);
+  const FHT_VEC s3 = SUB_EPI32(io[0], io[3]);
+
+  io[0] = mul_round(ADD_EPI32(s0, s1), cospi_16_64);
+  io[2] = mul_round(SUB_EPI32(s0, s1), cospi_16_64);
+  io[1] = madd_round(s2, cospi_24_64, s3, cospi_8_64);
+  io[3] = madd_round(s2, -cospi_8_64, s3, cospi_24_64);
+}
+
+static void fadst4_cols(FHT_VEC *const io /*io[4]*/) {
+  const FHT_VEC s7 = SUB_EPI32(ADD_EPI32(io[0], io[1]), io[3]);
+  FHT_VEC x0[2], x2[2], x3[2], t[2];
+
+  // x0 = sinpi_1_9 * in[0] + sinpi_2_9 * in[1] + sinpi_4_9 * in[3]
+  madd_wide(io[0], sinpi_1_9, io[1], sinpi_2_9, x0);
+  mul_wide(io[3], sinpi_4_9, t);
+  add_wide(x0, t, x0);
+  // x2 = sinpi_4_9 * in[0] - sinpi_1_9 * in[1] + sinpi_2_9 * in[3]
+  madd_wide(io[0], sinpi_4_9, io[1], -sinpi_1_9, x2);
+  mul_wide(io[3], sinpi_2_9, t);
+  add_wide(x2, t, x2);
+  mul_wide(io[2], sinpi_3_9, x3);
+
+  io[1] = mul_round(s7, sinpi_3_9);
+  add_wide(x0, x3, t);
+  io[0] = round_wide(t);
+  sub_wide(x2, x3, t);
+  io[2] = round_wide(t);
+  sub_wide(x2, x0, t);
+  add_wide(t, x3, t);
+  io[3] = round_wide(t);
+}
+#endif  // FHT_LANES == 4
+
+static void fdct8_cols(FHT_VEC *const io /*io[8]*/) {
+  FHT_VEC s[8], x[4], t2, t3;
+
+  // stage 1
+  s[0] = ADD_EPI32(io[0], io[7]);
+  s[1] = ADD_EPI32(io[1], io[6]);
+  s[2] = ADD_EPI32(io[2], io[5]);
+  s[3] = ADD_EPI32(io[3], io[4]);
+  s[4] = SUB_EPI32(io[3], io[4]);
+  s[5] = SUB_EPI32(io[2], io[5]);
+  s[6] = SUB_EPI32(io[1], io[6]);
+  s[7] = SUB_EPI32(io[0], io[7]);
+
+  // fdct4(step, step);
+  x[0] = ADD_EPI32(s[0], s[3]);
+  x[1] = ADD_EPI32(s[1], s[2]);
+  x[2] = SUB_EPI32(s[1], s[2]);
+  x[3] = SUB_EPI32(s[0], s[3]);
+  io[0] = mul_round(ADD_EPI32(x[0], x[1]), cospi_16_64);
+  io[4] = mul_round(SUB_EPI32(x[0], x[1]), cospi_16_64);
+  io[2] = madd_round(x[2], cospi_24_64, x[3], cospi_8_64);
+  io[6] = madd_round(x[2], -cospi_8_64, x[3], cospi_24_64);
+
+  // Stage 2
+  t2 = mul_round(SUB_EPI32(s[6], s[5]), cospi_16_64);
+  t3 = mul_round(ADD_EPI32(s[6], s[5]), cospi_16_64);
+
+  // Stage 3
+  x[0] = ADD_EPI32(s[4], t2);
+  x[1] = SUB_EPI32(s[4], t2);
+  x[2] = SUB_EPI32(s[7], t3);
+  x[3] = ADD_EPI32(s[7], t3);
+
+  // Stage 4
+  io[1] = madd_round(x[0], cospi_28_64, x[3], cospi_4_64);
+  io[5] = madd_round(x[1], cospi_12_64, x[2], cospi_20_64);
+  io[3] = madd_round(x[2], cospi_12_64, x[1], -cospi_20_64);
+  io[7] = madd_round(x[3], cospi_28_64, x[0], -cospi_4_64);
+}
+
+static void fadst8_cols(FHT_VEC *const io /*io[8]*/) {
+  FHT_VEC s0[2], s1[2], s2[2], s3[2], s4[2], s5[2], s6[2], s7[2];
+  FHT_VEC x0, x1, x2, x3, x4, x5, x6, x7;
+
+  // stage 1
+  madd_wide(io[7], cospi_2_64, io[0], cospi_30_64, s0);
+  madd_wide(io[7], cospi_30_64, io[0], -cospi_2_64, s1);
+  madd_wide(io[5], cospi_10_64, io[2], cospi_22_64, s2);
+  madd_wide(io[5], cospi_22_64, io[2], -cospi_10_64, s3);
+  madd_wide(io[3], cospi_18_64, io[4], cospi_14_64, s4);
+  madd_wide(io[3], cospi_14_64, io[4], -cospi_18_64, s5);
+  madd_wide(io[1], cospi_26_64, io[6], cospi_6_64, s6);
+  madd_wide(io[1], cospi_6_64, io[6], -cospi_26_64, s7);
+
+  add_sub_round(s0, s4, &x0, &x4);
+  add_sub_round(s1, s5, &x1, &x5);
+  add_sub_round(s2, s6, &x2, &x6);
+  add_sub_round(s3, s7, &x3, &x7);
+
+  // stage 2
+  madd_wide(x4, cospi_8_64, x5, cospi_24_64, s4);
+  madd_wide(x4, cospi_24_64, x5, -cospi_8_64, s5);
+  madd_wide(x6, -cospi_24_64, x7, cospi_8_64, s6);
+  madd_wide(x6, cospi_8_64, x7, cospi_24_64, s7);
+
+  io[0] = ADD_EPI32(x0, x2);
+  io[7] = neg_epi32(ADD_EPI32(x1, x3));
+  x2 = SUB_EPI32(x0, x2);
+  x3 = SUB_EPI32(x1, x3);
+  add_sub_round(s4, s6, &x4, &x6);
+  add_sub_round(s5, s7, &x5, &x7);
+
+  // stage 3
+  io[3] = neg_epi32(mul_round(ADD_EPI32(x2, x3), cospi_16_64));
+  io[4] = mul_round(SUB_EPI32(x2, x3), cospi_16_64);
+  io[2] = mul_round(ADD_EPI32(x6, x7), cospi_16_64);
+  io[5] = neg_epi32(mul_round(SUB_EPI32(x6, x7), cospi_16_64));
+
+  io[1] = neg_epi32(x4);
+  io[6] = x5;
+}
+
+static void fdct16_cols(FHT_VEC *const io /*io[16]*/) {
+  FHT_VEC in[8], step1[8], step2[8], step3[8];
+  FHT_VEC s[8], x[4], t2, t3;
+  int i;
+
+  // step 1
+  for (i = 0; i < 8; ++i) {
+    in[i] = ADD_EPI32(io[i], io[15 - i]);
+    step1[i] = SUB_EPI32(io[7 - i], io[8 + i]);
+  }
+
+  // fdct8(step, step);
+  // stage 1
+  s[0] = ADD_EPI32(in[0], in[7]);
+  s[1] = ADD_EPI32(in[1], in[6]);
+  s[2] = ADD_EPI32(in[2], in[5]);
+  s[3] = ADD_EPI32(in[3], in[4]);
+  s[4] = SUB_EPI32(in[3], in[4]);
+  s[5] = SUB_EPI32(in[2], in[5]);
+  s[6] = SUB_EPI32(in[1], in[6]);
+  s[7] = SUB_EPI32(in[0], in[7]);
+
+  // fdct4(step, step);
+  x[0] = ADD_EPI32(s[0], s[3]);
+  x[1] = ADD_EPI32(s[1], s[2]);
+  x[2] = SUB_EPI32(s[1], s[2]);
+  x[3] = SUB_EPI32(s[0], s[3]);
+  io[0] = mul_round(ADD_EPI32(x[0], x[1]), cospi_16_64);
+  io[8] = mul_round(SUB_EPI32(x[0], x[1]), cospi_16_64);
+  io[4] = madd_round(x[3], cospi_8_64, x[2], cospi_24_64);
+  io[12] = madd_round(x[3], cospi_24_64, x[2], -cospi_8_64);
+
+  // Stage 2
+  t2 = mul_round(SUB_EPI32(s[6], s[5]), cospi_16_64);
+  t3 = mul_round(ADD_EPI32(s[6], s[5]), cospi_16_64);
+
+  // Stage 3
+  x[0] = ADD_EPI32(s[4], t2);
+  x[1] = SUB_EPI32(s[4], t2);
+  x[2] = SUB_EPI32(s[7], t3);
+  x[3] = ADD_EPI32(s[7], t3);
+
+  // Stage 4
+  io[2] = madd_round(x[0], cospi_28_64, x[3], cospi_4_64);
+  io[10] = madd_round(x[1], cospi_12_64, x[2], cospi_20_64);
+  io[6] = madd_round(x[2], cospi_12_64, x[1], -cospi_20_64);
+  io[14] = madd_round(x[3], cospi_28_64, x[0], -cospi_4_64);
+
+  // step 2
+  step2[2] = mul_round(SUB_EPI32(step1[5], step1[2]), cospi_16_64);
+  step2[3] = mul_round(SUB_EPI32(step1[4], step1[3]), cospi_16_64);
+  step2[4] = mul_round(ADD_EPI32(step1[4], step1[3]), cospi_16_64);
+  step2[5] = mul_round(ADD_EPI32(step1[5], step1[2]), cospi_16_64);
+
+  // step 3
+  step3[0] = ADD_EPI32(step1[0], step2[3]);
+  step3[1] = ADD_EPI32(step1[1], step2[2]);
+  step3[2] = SUB_EPI32(step1[1], step2[2]);
+  step3[3] = SUB_EPI32(step1[0], step2[3]);
+  step3[4] = SUB_EPI32(step1[7], step2[4]);
+  step3[5] = SUB_EPI32(step1[6], step2[5]);
+  step3[6] = ADD_EPI32(step1[6], step2[5]);
+  step3[7] = ADD_EPI32(step1[7], step2[4]);
+
+  // step 4
+  step2[1] = madd_round(step3[1], -cospi_8_64, step3[6], cospi_24_64);
+  step2[2] = madd_round(step3[2], cospi_24_64, step3[5], cospi_8_64);
+  step2[5] = madd_round(step3[2], cospi_8_64, step3[5], -cospi_24_64);
+  step2[6] = madd_round(step3[1], cospi_24_64, step3[6], cospi_8_64);
+
+  // step 5
+  step1[0] = ADD_EPI32(step3[0], step2[1]);
+  step1[1] = SUB_EPI32(step3[0], step2[1]);
+  step1[2] = ADD_EPI32(step3[3], step2[2]);
+  step1[3] = SUB_EPI32(step3[3], step2[2]);
+  step1[4] = SUB_EPI32(step3[4], step2[5]);
+  step1[5] = ADD_EPI32(step3[4], step2[5]);
+  step1[6] = SUB_EPI32(step3[7], step2[6]);
+  step1[7] = ADD_EPI32(step3[7], step2[6]);
+
+  // step 6
+  io[1] = madd_round(step1[0], cospi_30_64, step1[7], cospi_2_64);
+  io[9] = madd_round(step1[1], cospi_14_64, step1[6], cospi_18_64);
+  io[5] = madd_round(step1[2], cospi_22_64, step1[5], cospi_10_64);
+  io[13] = madd_round(step1[3], cospi_6_64, step1[4], cospi_26_64);
+  io[3] = madd_round(step1[3], -cospi_26_64, step1[4], cospi_6_64);
+  io[11] = madd_round(step1[2], -cospi_10_64, step1[5], cospi_22_64);
+  io[7] = madd_round(step1[1], -cospi_18_64, step1[6], cospi_14_64);
+  io[15] = madd_round(step1[0], -cospi_2_64, step1[7], cospi_30_64);
+}
+
+static void fadst16_cols(FHT_VEC *const io /*io[16]*/) {
+  FHT_VEC s[16][2], x[16];
+  int i;
+
+  // stage 1
+  madd_wide(io[15], cospi_1_64, io[0], cospi_31_64, s[0]);
+  madd_wide(io[15], cospi_31_64, io[0], -cospi_1_64, s[1]);
+  madd_wide(io[13], cospi_5_64, io[2], cospi_27_64, s[2]);
+  madd_wide(io[13], cospi_27_64, io[2], -cospi_5_64, s[3]);
+  madd_wide(io[11], cospi_9_64, io[4], cospi_23_64, s[4]);
+  madd_wide(io[11], cospi_23_64, io[4], -cospi_9_64, s[5]);
+  madd_wide(io[9], cospi_13_64, io[6], cospi_19_64, s[6]);
+  madd_wide(io[9], cospi_19_64, io[6], -cospi_13_64, s[7]);
+  madd_wide(io[7], cospi_17_64, io[8], cospi_15_64, s[8]);
+  madd_wide(io[7], cospi_15_64, io[8], -cospi_17_64, s[9]);
+  madd_wide(io[5], cospi_21_64, io[10], cospi_11_64, s[10]);
+  madd_wide(io[5], cospi_11_64, io[10], -cospi_21_64, s[11]);
+  madd_wide(io[3], cospi_25_64, io[12], cospi_7_64, s[12]);
+  madd_wide(io[3], cospi_7_64, io[12], -cospi_25_64, s[13]);
+  madd_wide(io[1], cospi_29_64, io[14], cospi_3_64, s[14]);
+  madd_wide(io[1], cospi_3_64, io[14], -cospi_29_64, s[15]);
+
+  for (i = 0; i < 8; ++i) add_sub_round(s[i], s[i + 8], &x[i], &x[i + 8]);
+
+  // stage 2
+  madd_wide(x[8], cospi_4_64, x[9], cospi_28_64, s[8]);
+  madd_wide(x[8], cospi_28_64, x[9], -cospi_4_64, s[9]);
+  madd_wide(x[10], cospi_20_64, x[11], cospi_12_64, s[10]);
+  madd_wide(x[10], cospi_12_64, x[11], -cospi_20_64, s[11]);
+  madd_wide(x[12], -cospi_28_64, x[13], cospi_4_64, s[12]);
+  madd_wide(x[12], cospi_4_64, x[13], cospi_28_64, s[13]);
+  madd_wide(x[14], -cospi_12_64, x[15], cospi_20_64, s[14]);
+  madd_wide(x[14], cospi_20_64, x[15], cospi_12_64, s[15]);
+
+  for (i = 0; i < 4; ++i) {
+    const FHT_VEC t = x[i];
+    x[i] = ADD_EPI32(t, x[i + 4]);
+    x[i + 4] = SUB_EPI32(t, x[i + 4]);
+  }
+  for (i = 8; i < 12; ++i) add_sub_round(s[i], s[i + 4], &x[i], &x[i + 4]);
+
+  // stage 3
+  madd_wide(x[4], cospi_8_64, x[5], cospi_24_64, s[4]);
+  madd_wide(x[4], cospi_24_64, x[5], -cospi_8_64, s[5]);
+  madd_wide(x[6], -cospi_24_64, x[7], cospi_8_64, s[6]);
+  madd_wide(x[6], cospi_8_64, x[7], cospi_24_64, s[7]);
+  madd_wide(x[12], cospi_8_64, x[13], cospi_24_64, s[12]);
+  madd_wide(x[12], cospi_24_64, x[13], -cospi_8_64, s[13]);
+  madd_wide(x[14], -cospi_24_64, x[15], cospi_8_64, s[14]);
+  madd_wide(x[14], cospi_8_64, x[15], cospi_24_64, s[15]);
+
+  for (i = 0; i < 2; ++i) {
+    FHT_VEC t = x[i];
+    x[i] = ADD_EPI32(t, x[i + 2]);
+    x[i + 2] = SUB_EPI32(t, x[i + 2]);
+    t = x[i + 8];
+    x[i + 8] = ADD_EPI32(t, x[i + 10]);
+    x[i + 10] = SUB_EPI32(t, x[i + 10]);
+  }
+  add_sub_round(s[4], s[6], &x[4], &x[6]);
+  add_sub_round(s[5], s[7], &x[5], &x[7]);
+  add_sub_round(s[12], s[14], &x[12], &x[14]);
+  add_sub_round(s[13], s[15], &x[13], &x[15]);
+
+  // stage 4
+  io[7] = mul_round(ADD_EPI32(x[2], x[3]), -cospi_16_64);
+  io[8] = mul_round(SUB_EPI32(x[2], x[3]), cospi_16_64);
+  io[4] = mul_round(ADD_EPI32(x[6], x[7]), cospi_16_64);
+  io[11] = mul_round(SUB_EPI32(x[7], x[6]), cospi_16_64);
+  io[6] = mul_round(ADD_EPI32(x[10], x[11]), cospi_16_64);
+  io[9] = mul_round(SUB_EPI32(x[11], x[10]), cospi_16_64);
+  io[5] = mul_round(ADD_EPI32(x[14], x[15]), -cospi_16_64);
+  io[10] = mul_round(SUB_EPI32(x[14], x[15]), cospi_16_64);
+
+  io[0] = x[0];
+  io[1] = neg_epi32(x[8]);
+  io[2] = x[12];
+  io[3] = neg_epi32(x[4]);
+  io[12] = x[5];
+  io[13] = neg_epi32(x[13]);
+  io[14] = x[9];
+  io[15] = neg_epi32(x[1]);
+}
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_dsp/vpx_filter.h"
+
+#define RESIZE_TAPS 8
+
+static INLINE void load_filter(const int16_t *filter, __m256i *const f) {
+  int k;
+  for (k = 0; k < RESIZE_TAPS / 2; ++k) {
+    f[k] = _mm256_set1_epi32((int)((uint16_t)filter[2 * k]) |
+                             ((int)filter[2 * k + 1] * (1 << 16)));
+  }
+}
+
+// Filters 16 pels given as 16-bit values in rows[0..7]. The unpacks and the
+// final pack both work within 128-bit lanes, so the pels come out in order.
+static INLINE __m256i filter_16(const __m256i *const rows,
+                                const __m256i *const f) {
+  const __m256i round = _mm256_set1_epi32(1 << (FILTER_BITS - 1));
+  __m256i sum_lo = round;
+  __m256i sum_hi = round;
+  int k;
+  for (k = 0; k < RESIZE_TAPS / 2; ++k) {
+    const __m256i lo = _mm256_unpacklo_epi16(rows[2 * k], rows[2 * k + 1]);
+    const __m256i hi = _mm256_unpackhi_epi16(rows[2 * k], rows[2 * k + 1]);
+    sum_lo = _mm256_add_epi32(sum_lo, _mm256_madd_epi16(lo, f[k]));
+    sum_hi = _mm256_add_epi32(sum_hi, _mm256_madd_epi16(hi, f[k]));
+  }
+  return _mm256_packs_epi32(_mm256_srai_epi32(sum_lo, FILTER_BITS),
+                            _mm256_srai_epi32(sum_hi, FILTER_BITS));
+}
+
+void vp9_resize_filter_rows_avx2(const uint8_t *const *src,
+                                 const int16_t *filter, uint8_t *dst, int w) {
+  __m256i f[RESIZE_TAPS / 2];
+  __m256i rows[RESIZE_TAPS];
+  int x = 0, k;
+
+  load_filter(filter, f);
+  for (; x + 16 <= w; x += 16) {
+    __m256i res;
+    for (k = 0; k < RESIZE_TAPS; ++k) {
+      rows[k] = _mm256_cvtepu8_epi16(
+          _mm_loadu_si128((const __m128i *)(src[k] + x)));
+    }
+    res = filter_16(rows, f);
+    _mm_storeu_si128((__m128i *)(dst + x),
+                     _mm_packus_epi16(_mm256_castsi256_si128(res),
+                                      _mm256_extracti128_si256(res, 1)));
+  }
+  if (x < w) {
+    const uint8_t *tail[RESIZE_TAPS];
+    for (k = 0; k < RESIZE_TAPS; ++k) tail[k] = src[k] + x;
+    vp9_resize_filter_rows_sse2(tail, filter, dst + x, w - x);
+  }
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+void vp9_highbd_resize_filter_rows_avx2(const uint16_t *const *src,
+                                        const int16_t *filter, uint16_t *dst,
+                                        int w, int bd) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+  __m256i f[RESIZE_TAPS / 2];
+  __m256i rows[RESIZE_TAPS];
+  int x = 0, k;
+
+  load_filter(filter, f);
+  for (; x + 16 <= w; x += 16) {
+    __m256i res;
+    for (k = 0; k < RESIZE_TAPS; ++k)
+      rows[k] = _mm256_loadu_si256((const __m256i *)(src[k] + x));
+    res = filter_16(rows, f);
+    res = _mm256_min_epi16(_mm256_max_epi16(res, zero), max);
+    _mm256_storeu_si256((__m256i *)(dst + x), res);
+  }
+  if (x < w) {
+    const uint16_t *tail[RESIZE_TAPS];
+    for (k = 0; k < RESIZE_TAPS; ++k) tail[k] = src[k] + x;
+    vp9_highbd_resize_filter_rows_sse2(tail, filter, dst + x, w - x, bd);
+  }
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
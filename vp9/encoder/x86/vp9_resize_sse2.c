@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>  // SSE2
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_dsp/vpx_filter.h"
+
+#define RESIZE_TAPS 8
+
+// Packs adjacent taps into the 32-bit lanes used by _mm_madd_epi16().
+static INLINE void load_filter(const int16_t *filter, __m128i *const f) {
+  int k;
+  for (k = 0; k < RESIZE_TAPS / 2; ++k) {
+    f[k] = _mm_set1_epi32((int)((uint16_t)filter[2 * k]) |
+                          ((int)filter[2 * k + 1] * (1 << 16)));
+  }
+}
+
+// Filters 8 pels given as 16-bit values in rows[0..7]. The sums can't
+// overflow 32 bits and their rounded quotients fit 16 bits.
+static INLINE __m128i filter_8(const __m128i *const rows,
+                               const __m128i *const f) {
+  const __m128i round = _mm_set1_epi32(1 << (FILTER_BITS - 1));
+  __m128i sum_lo = round;
+  __m128i sum_hi = round;
+  int k;
+  for (k = 0; k < RESIZE_TAPS / 2; ++k) {
+    const __m128i lo = _mm_unpacklo_epi16(rows[2 * k], rows[2 * k + 1]);
+    const __m128i hi = _mm_unpackhi_epi16(rows[2 * k], rows[2 * k + 1]);
+    sum_lo = _mm_add_epi32(sum_lo, _mm_madd_epi16(lo, f[k]));
+    sum_hi = _mm_add_epi32(sum_hi, _mm_madd_epi16(hi, f[k]));
+  }
+  return _mm_packs_epi32(_mm_srai_epi32(sum_lo, FILTER_BITS),
+                         _mm_srai_epi32(sum_hi, FILTER_BITS));
+}
+
+void vp9_resize_filter_rows_sse2(const uint8_t *const *src,
+                                 const int16_t *filter, uint8_t *dst, int w) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i f[RESIZE_TAPS / 2];
+  __m128i lo[RESIZE_TAPS], hi[RESIZE_TAPS];
+  int x = 0, k;
+
+  load_filter(filter, f);
+  for (; x + 16 <= w; x += 16) {
+    for (k = 0; k < RESIZE_TAPS; ++k) {
+      const __m128i s = _mm_loadu_si128((const __m128i *)(src[k] + x));
+      lo[k] = _mm_unpacklo_epi8(s, zero);
+      hi[k] = _mm_unpackhi_epi8(s, zero);
+    }
+    _mm_storeu_si128((__m128i *)(dst + x),
+                     _mm_packus_epi16(filter_8(lo, f), filter_8(hi, f)));
+  }
+  if (x + 8 <= w) {
+    __m128i res;
+    for (k = 0; k < RESIZE_TAPS; ++k) {
+      lo[k] = _mm_unpacklo_epi8(
+          _mm_loadl_epi64((const __m128i *)(src[k] + x)), zero);
+    }
+    res = filter_8(lo, f);
+    _mm_storel_epi64((__m128i *)(dst + x), _mm_packus_epi16(res, res));
+    x += 8;
+  }
+  for (; x < w; ++x) {
+    int sum = 0;
+    for (k = 0; k < RESIZE_TAPS; ++k) sum += filter[k] * src[k][x];
+    dst[x] = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
+  }
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+void vp9_highbd_resize_filter_rows_sse2(const uint16_t *const *src,
+                                        const int16_t *filter, uint16_t *dst,
+                                        int w, int bd) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i max = _mm_set1_epi16((1 << bd) - 1);
+  __m128i f[RESIZE_TAPS / 2];
+  __m128i rows[RESIZE_TAPS];
+  int x = 0, k;
+
+  load_filter(filter, f);
+  for (; x + 8 <= w; x += 8) {
+    __m128i res;
+    for (k = 0; k < RESIZE_TAPS; ++k)
+      rows[k] = _mm_loadu_si128((const __m128i *)(src[k] + x));
+    res = filter_8(rows, f);
+    res = _mm_min_epi16(_mm_max_epi16(res, zero), max);
+    _mm_storeu_si128((__m128i *)(dst + x), res);
+  }
+  for (; x < w; ++x) {
+    int sum = 0;
+    for (k = 0; k < RESIZE_TAPS; ++k) sum += filter[k] * src[k][x];
+    dst[x] = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
+  }
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
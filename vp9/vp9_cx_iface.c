@@ -1230,7 +1230,8 @@ static vpx_codec_err_t pick_quickcompress_mode(vpx_codec_alg_priv_t *ctx,
 
 // Turn on to test if supplemental superframe data breaks decoding
 // #define TEST_SUPPLEMENTAL_SUPERFRAME_DATA
-static int write_superframe_index(vpx_codec_alg_priv_t *ctx) {
+// |buf_sz| is the space from the start of the pending data.
+static int write_superframe_index(vpx_codec_alg_priv_t *ctx, size_t buf_sz) {
   uint8_t marker = 0xc0;
   unsigned int mask;
   int mag, index_sz;
@@ -1251,7 +1252,7 @@ static int write_superframe_index(vpx_codec_alg_priv_t *ctx) {
 
   // Write the index
   index_sz = 2 + (mag + 1) * ctx->pending_frame_count;
-  if (ctx->pending_cx_data_sz + index_sz < ctx->cx_data_sz) {
+  if (ctx->pending_cx_data_sz + index_sz < buf_sz) {
     uint8_t *x = ctx->pending_cx_data + ctx->pending_cx_data_sz;
     int i, j;
 #ifdef TEST_SUPPLEMENTAL_SUPERFRAME_DATA
@@ -1330,6 +1331,13 @@ get_first_pass_stats_pkt(FIRSTPASS_STATS *stats) {
 #endif
 
 const size_t kMinCompressedSize = 8192;
+
+// Hands back a frame the encoder was given but never took.
+static void release_source_img(const VP9_COMP *cpi, const vpx_image_t *img) {
+  if (img != NULL)
+    cpi->source_release.release_cb(cpi->source_release.cb_priv, img);
+}
+
 static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
                                       const vpx_image_t *img,
                                       vpx_codec_pts_t pts_val,
@@ -1347,44 +1355,54 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
 
   if (cpi == NULL) return VPX_CODEC_INVALID_PARAM;
 
+  // The frame to hand back if this returns before vp9_receive_raw_frame()
+  // takes it.
+  const vpx_image_t *volatile held_img =
+      cpi->source_release.release_cb != NULL ? img : NULL;
+
   cpi->last_coded_width = ctx->oxcf.width;
   cpi->last_coded_height = ctx->oxcf.height;
 
   if (img != NULL) {
     res = validate_img(ctx, img);
-    if (res == VPX_CODEC_OK) {
-      // There's no codec control for multiple alt-refs so check the encoder
-      // instance for its status to determine the compressed data size.
-      data_sz = ctx->cfg.g_w * ctx->cfg.g_h * get_image_bps(img) / 8 *
-                (cpi->multi_layer_arf ? 8 : 2);
-      if (data_sz < kMinCompressedSize) data_sz = kMinCompressedSize;
-      if (ctx->cx_data == NULL || ctx->cx_data_sz < data_sz) {
-        ctx->cx_data_sz = data_sz;
-        free(ctx->cx_data);
-        ctx->cx_data = (unsigned char *)malloc(ctx->cx_data_sz);
-        if (ctx->cx_data == NULL) {
-          return VPX_CODEC_MEM_ERROR;
-        }
-      }
+    if (res != VPX_CODEC_OK) {
+      release_source_img(cpi, held_img);
+      return res;
+    }
 
-      int chroma_subsampling = -1;
-      if ((img->fmt & VPX_IMG_FMT_I420) == VPX_IMG_FMT_I420 ||
-          (img->fmt & VPX_IMG_FMT_NV12) == VPX_IMG_FMT_NV12 ||
-          (img->fmt & VPX_IMG_FMT_YV12) == VPX_IMG_FMT_YV12) {
-        chroma_subsampling = 1;  // matches default for Codec Parameter String
-      } else if ((img->fmt & VPX_IMG_FMT_I422) == VPX_IMG_FMT_I422) {
-        chroma_subsampling = 2;
-      } else if ((img->fmt & VPX_IMG_FMT_I444) == VPX_IMG_FMT_I444) {
-        chroma_subsampling = 3;
-      }
-      if (chroma_subsampling > ctx->global_header_subsampling) {
-        ctx->global_header_subsampling = chroma_subsampling;
+    // There's no codec control for multiple alt-refs so check the encoder
+    // instance for its status to determine the compressed data size.
+    data_sz = ctx->cfg.g_w * ctx->cfg.g_h * get_image_bps(img) / 8 *
+              (cpi->multi_layer_arf ? 8 : 2);
+    if (data_sz < kMinCompressedSize) data_sz = kMinCompressedSize;
+    if (ctx->cx_data == NULL || ctx->cx_data_sz < data_sz) {
+      ctx->cx_data_sz = data_sz;
+      free(ctx->cx_data);
+      ctx->cx_data = (unsigned char *)malloc(ctx->cx_data_sz);
+      if (ctx->cx_data == NULL) {
+        release_source_img(cpi, held_img);
+        return VPX_CODEC_MEM_ERROR;
       }
     }
+
+    int chroma_subsampling = -1;
+    if ((img->fmt & VPX_IMG_FMT_I420) == VPX_IMG_FMT_I420 ||
+        (img->fmt & VPX_IMG_FMT_NV12) == VPX_IMG_FMT_NV12 ||
+        (img->fmt & VPX_IMG_FMT_YV12) == VPX_IMG_FMT_YV12) {
+      chroma_subsampling = 1;  // matches default for Codec Parameter String
+    } else if ((img->fmt & VPX_IMG_FMT_I422) == VPX_IMG_FMT_I422) {
+      chroma_subsampling = 2;
+    } else if ((img->fmt & VPX_IMG_FMT_I444) == VPX_IMG_FMT_I444) {
+      chroma_subsampling = 3;
+    }
+    if (chroma_subsampling > ctx->global_header_subsampling) {
+      ctx->global_header_subsampling = chroma_subsampling;
+    }
   }
 
   res = pick_quickcompress_mode(ctx, duration, deadline);
   if (res != VPX_CODEC_OK) {
+    release_source_img(cpi, held_img);
     return res;
   }
   vpx_codec_pkt_list_init(&ctx->pkt_list);
@@ -1393,6 +1411,7 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
   if (((flags & VP8_EFLAG_NO_UPD_GF) && (flags & VP8_EFLAG_FORCE_GF)) ||
       ((flags & VP8_EFLAG_NO_UPD_ARF) && (flags & VP8_EFLAG_FORCE_ARF))) {
     ctx->base.err_detail = "Conflicting flags.";
+    release_source_img(cpi, held_img);
     return VPX_CODEC_INVALID_PARAM;
   }
 
@@ -1400,6 +1419,7 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
     cpi->common.error.setjmp = 0;
     res = update_error_state(ctx, &cpi->common.error);
     vpx_clear_system_state();
+    release_source_img(cpi, held_img);
     return res;
   }
   cpi->common.error.setjmp = 1;
@@ -1419,6 +1439,9 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
     unsigned int lib_flags = 0;
     size_t size, cx_data_sz;
     unsigned char *cx_data;
+    // The padding around each packet written to the application's buffer.
+    size_t pad_before = 0, pad_after = 0;
+    int to_app_buf = 0;
 
     // Set up internal flags
     if (ctx->base.init_flags & VPX_CODEC_USE_PSNR) cpi->b_calculate_psnr = 1;
@@ -1469,15 +1492,34 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
       // Store the original flags in to the frame buffer. Will extract the
       // key frame flag when we actually encode this frame.
       if (vp9_receive_raw_frame(cpi, flags | ctx->next_frame_flags, &sd,
-                                dst_time_stamp, dst_end_time_stamp)) {
+                                img, dst_time_stamp, dst_end_time_stamp)) {
         res = update_error_state(ctx, &cpi->common.error);
       }
+      held_img = NULL;
       ctx->next_frame_flags = 0;
     }
 
     cx_data = ctx->cx_data;
     cx_data_sz = ctx->cx_data_sz;
 
+    // Write straight into the buffer given to vpx_codec_set_cx_data_buf() if
+    // it has room for a frame, so vpx_codec_get_cx_data() has nothing to copy.
+    // Packets passed to the output callback don't go through
+    // vpx_codec_get_cx_data(), so they keep using the internal buffer.
+    if (ctx->base.enc.cx_data_dst_buf.buf != NULL &&
+        !ctx->output_cx_pkt_cb.output_cx_pkt) {
+      const vpx_fixed_buf_t *const dst_buf = &ctx->base.enc.cx_data_dst_buf;
+      const size_t pads =
+          ctx->base.enc.cx_data_pad_before + ctx->base.enc.cx_data_pad_after;
+      if (dst_buf->sz >= pads + ctx->pending_cx_data_sz + ctx->cx_data_sz / 2) {
+        pad_before = ctx->base.enc.cx_data_pad_before;
+        pad_after = ctx->base.enc.cx_data_pad_after;
+        cx_data = (unsigned char *)dst_buf->buf + pad_before;
+        cx_data_sz = dst_buf->sz - pads;
+        to_app_buf = 1;
+      }
+    }
+
     /* Any pending invisible frames? */
     if (ctx->pending_cx_data) {
       assert(cx_data_sz >= ctx->pending_cx_data_sz);
@@ -1540,7 +1582,14 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
           // TODO(angiebird): Figure out while we don't need psnr pkt when
           // use_svc is on
           PSNR_STATS psnr;
-          if (vp9_get_psnr(cpi, &psnr)) {
+          if (cpi->async_psnr) {
+            // Emit the previous frame's result, then start this frame's.
+            if (vp9_get_async_psnr(cpi, &psnr)) {
+              vpx_codec_cx_pkt_t psnr_pkt = get_psnr_pkt(&psnr);
+              vpx_codec_pkt_list_add(&ctx->pkt_list.head, &psnr_pkt);
+            }
+            vp9_launch_async_psnr(cpi);
+          } else if (vp9_get_psnr(cpi, &psnr)) {
             vpx_codec_cx_pkt_t psnr_pkt = get_psnr_pkt(&psnr);
             vpx_codec_pkt_list_add(&ctx->pkt_list.head, &psnr_pkt);
           }
@@ -1603,17 +1652,20 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
             ctx->pending_frame_magnitude |= size;
             ctx->pending_cx_data_sz += size;
             // write the superframe only for the case when
-            if (!ctx->output_cx_pkt_cb.output_cx_pkt)
-              size += write_superframe_index(ctx);
-            pkt.data.frame.buf = ctx->pending_cx_data;
-            pkt.data.frame.sz = ctx->pending_cx_data_sz;
+            if (!ctx->output_cx_pkt_cb.output_cx_pkt) {
+              size += write_superframe_index(
+                  ctx, cx_data + cx_data_sz - ctx->pending_cx_data);
+            }
+            pkt.data.frame.buf = ctx->pending_cx_data - pad_before;
+            pkt.data.frame.sz =
+                pad_before + ctx->pending_cx_data_sz + pad_after;
             ctx->pending_cx_data = NULL;
             ctx->pending_cx_data_sz = 0;
             ctx->pending_frame_count = 0;
             ctx->pending_frame_magnitude = 0;
           } else {
-            pkt.data.frame.buf = cx_data;
-            pkt.data.frame.sz = size;
+            pkt.data.frame.buf = cx_data - pad_before;
+            pkt.data.frame.sz = pad_before + size + pad_after;
           }
           pkt.data.frame.partition_id = -1;
 
@@ -1623,8 +1675,10 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
           else
             vpx_codec_pkt_list_add(&ctx->pkt_list.head, &pkt);
 
+          // The next packet starts after this one's padding.
+          size += pad_after + pad_before;
           cx_data += size;
-          cx_data_sz -= size;
+          cx_data_sz -= VPXMIN(size, cx_data_sz);
           if (is_one_pass_svc(cpi) && (cpi->svc.spatial_layer_id ==
                                        cpi->svc.number_spatial_layers - 1)) {
             // Encoded all spatial layers; exit loop.
@@ -1632,6 +1686,35 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
           }
         }
       }
+      // The application may reuse its buffer before the next call, so move
+      // the frames held back for the next superframe out of it.
+      if (to_app_buf && ctx->pending_cx_data) {
+        if (ctx->cx_data_sz < ctx->pending_cx_data_sz) {
+          free(ctx->cx_data);
+          ctx->cx_data_sz = ctx->pending_cx_data_sz;
+          ctx->cx_data = (unsigned char *)malloc(ctx->cx_data_sz);
+          if (ctx->cx_data == NULL) {
+            ctx->cx_data_sz = 0;
+            ctx->pending_cx_data = NULL;
+            ctx->pending_cx_data_sz = 0;
+            ctx->pending_frame_count = 0;
+            ctx->pending_frame_magnitude = 0;
+            vpx_internal_error(&cpi->common.error, VPX_CODEC_MEM_ERROR,
+                               "Failed to allocate compressed data buffer");
+          }
+        }
+        memcpy(ctx->cx_data, ctx->pending_cx_data, ctx->pending_cx_data_sz);
+        ctx->pending_cx_data = ctx->cx_data;
+      }
+      if (img == NULL) {
+        // Callers stop flushing once no frame is returned, so don't hold the
+        // last result back.
+        PSNR_STATS psnr;
+        if (vp9_get_async_psnr(cpi, &psnr)) {
+          vpx_codec_cx_pkt_t psnr_pkt = get_psnr_pkt(&psnr);
+          vpx_codec_pkt_list_add(&ctx->pkt_list.head, &psnr_pkt);
+        }
+      }
     }
   }
 
@@ -2092,6 +2175,30 @@ static vpx_codec_err_t ctrl_set_external_rate_control(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_external_source_buffers(
+    vpx_codec_alg_priv_t *ctx, va_list args) {
+  VP9_COMP *const cpi = ctx->cpi;
+  const vpx_source_release_cb_t *const data =
+      va_arg(args, vpx_source_release_cb_t *);
+  if (data == NULL) return VPX_CODEC_INVALID_PARAM;
+  cpi->source_release = *data;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_async_psnr(vpx_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  VP9_COMP *const cpi = ctx->cpi;
+  cpi->async_psnr = va_arg(args, int) != 0;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_svc_async_scale(vpx_codec_alg_priv_t *ctx,
+                                                va_list args) {
+  VP9_COMP *const cpi = ctx->cpi;
+  cpi->svc_async_scale = va_arg(args, int) != 0;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_set_quantizer_one_pass(vpx_codec_alg_priv_t *ctx,
                                                    va_list args) {
   VP9_COMP *const cpi = ctx->cpi;
@@ -2166,6 +2273,9 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { VP9E_SET_RTC_EXTERNAL_RATECTRL, ctrl_set_rtc_external_ratectrl },
   { VP9E_SET_EXTERNAL_RATE_CONTROL, ctrl_set_external_rate_control },
   { VP9E_SET_QUANTIZER_ONE_PASS, ctrl_set_quantizer_one_pass },
+  { VP9E_SET_EXTERNAL_SOURCE_BUFFERS, ctrl_set_external_source_buffers },
+  { VP9E_SET_ASYNC_PSNR, ctrl_set_async_psnr },
+  { VP9E_SET_SVC_ASYNC_SCALE, ctrl_set_svc_async_scale },
 
   // Getters
   { VP8E_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -55,8 +55,45 @@ static vpx_codec_err_t decoder_init(vpx_codec_ctx_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static void free_buffer_pool(vpx_codec_alg_priv_t *ctx) {
+  if (ctx->buffer_pool == NULL) return;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
+  pthread_mutex_destroy(&ctx->buffer_pool->progress_mutex);
+  pthread_cond_destroy(&ctx->buffer_pool->progress_cond);
+#endif
+  vpx_free(ctx->buffer_pool);
+  ctx->buffer_pool = NULL;
+}
+
+static void remove_frame_workers(vpx_codec_alg_priv_t *ctx) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  int i;
+
+  // Finish the frames in flight before any decoder goes away.
+  for (i = 0; i < ctx->num_frame_workers; ++i) {
+    winterface->end(&ctx->frame_workers[i]);
+  }
+  for (i = 0; i < ctx->num_frame_workers; ++i) {
+    FrameWorkerData *const frame_worker_data =
+        (FrameWorkerData *)ctx->frame_workers[i].data1;
+    if (frame_worker_data == NULL) continue;
+    if (frame_worker_data->pbi != NULL)
+      vp9_decoder_remove(frame_worker_data->pbi);
+    vpx_free(frame_worker_data->scratch_buffer);
+    vp9_frameworker_deinit(frame_worker_data);
+    vpx_free(frame_worker_data);
+  }
+  vpx_free(ctx->frame_workers);
+  ctx->frame_workers = NULL;
+  ctx->num_frame_workers = 0;
+  ctx->pbi = NULL;
+}
+
 static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
-  if (ctx->pbi != NULL) {
+  if (ctx->frame_workers != NULL) {
+    remove_frame_workers(ctx);
+  } else if (ctx->pbi != NULL) {
     vp9_decoder_remove(ctx->pbi);
   }
 
@@ -65,7 +102,7 @@ static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
     vp9_free_internal_frame_buffers(&ctx->buffer_pool->int_frame_buffers);
   }
 
-  vpx_free(ctx->buffer_pool);
+  free_buffer_pool(ctx);
   vpx_free(ctx);
   return VPX_CODEC_OK;
 }
@@ -254,30 +291,130 @@ static void set_ppflags(const vpx_codec_alg_priv_t *ctx, vp9_ppflags_t *flags) {
       ERROR(#memb " out of range [" #lo ".." #hi "]");                   \
   } while (0)
 
+static void init_decoder_config(vpx_codec_alg_priv_t *ctx, VP9Decoder *pbi,
+                                int max_threads) {
+  pbi->max_threads = max_threads;
+  pbi->inv_tile_order = ctx->invert_tile_order;
+  pbi->row_mt = ctx->row_mt;
+  pbi->lpf_mt_opt = ctx->lpf_opt;
+  // Postprocessing reads the pixels around the frame.
+  pbi->lazy_border =
+      ctx->lazy_border && !(ctx->base.init_flags & VPX_CODEC_USE_POSTPROC);
+}
+
+static int frame_worker_hook(void *arg1, void *arg2) {
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)arg1;
+  const uint8_t *data = frame_worker_data->data;
+  (void)arg2;
+
+  frame_worker_data->result = vp9_receive_compressed_data(
+      frame_worker_data->pbi, frame_worker_data->data_size, &data);
+  frame_worker_data->data_end = data;
+
+  // Also releases a frame waiting for the frame context of this one.
+  vp9_frameworker_signal_decoded(frame_worker_data->pbi->frame_worker_owner);
+  return !frame_worker_data->result;
+}
+
+static vpx_codec_err_t init_frame_workers(vpx_codec_alg_priv_t *ctx) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int num_frame_workers = ctx->frame_parallel_decode;
+  // The threads are shared among the frames in flight.
+  const int max_threads = VPXMAX(1, (int)ctx->cfg.threads / num_frame_workers);
+  int i;
+
+  ctx->frame_workers = (VPxWorker *)vpx_calloc(num_frame_workers,
+                                               sizeof(*ctx->frame_workers));
+  if (ctx->frame_workers == NULL) {
+    set_error_detail(ctx, "Failed to allocate frame workers");
+    return VPX_CODEC_MEM_ERROR;
+  }
+
+  for (i = 0; i < num_frame_workers; ++i) {
+    VPxWorker *const worker = &ctx->frame_workers[i];
+    FrameWorkerData *frame_worker_data;
+
+    winterface->init(worker);
+    worker->data1 = vpx_calloc(1, sizeof(FrameWorkerData));
+    if (worker->data1 == NULL) {
+      set_error_detail(ctx, "Failed to allocate frame worker data");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    ++ctx->num_frame_workers;
+
+    frame_worker_data = (FrameWorkerData *)worker->data1;
+    vp9_frameworker_init(frame_worker_data);
+    frame_worker_data->worker_id = i;
+    frame_worker_data->pbi = vp9_decoder_create(ctx->buffer_pool);
+    if (frame_worker_data->pbi == NULL) {
+      set_error_detail(ctx, "Failed to allocate decoder");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    frame_worker_data->pbi->frame_parallel_decode = 1;
+    frame_worker_data->pbi->frame_worker_owner = worker;
+    frame_worker_data->pbi->common.new_fb_idx = INVALID_IDX;
+    init_decoder_config(ctx, frame_worker_data->pbi, max_threads);
+
+    worker->hook = frame_worker_hook;
+    if (!winterface->reset(worker)) {
+      set_error_detail(ctx, "Frame worker thread creation failed");
+      return VPX_CODEC_ERROR;
+    }
+  }
+
+  ctx->pbi = ((FrameWorkerData *)ctx->frame_workers[0].data1)->pbi;
+  ctx->next_submit_worker_id = 0;
+  ctx->last_submit_worker_id = -1;
+  ctx->next_output_worker_id = 0;
+  ctx->num_frames_in_flight = 0;
+  ctx->last_fb_idx = INVALID_IDX;
+  ctx->prev_fb_idx = INVALID_IDX;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
   vpx_codec_err_t res;
   ctx->last_show_frame = -1;
   ctx->need_resync = 1;
   ctx->flushed = 0;
 
+  RANGE_CHECK(ctx, row_mt, 0, 1);
+  RANGE_CHECK(ctx, lpf_opt, 0, 1);
+  RANGE_CHECK(ctx, lazy_border, 0, 1);
+  RANGE_CHECK(ctx, frame_parallel_decode, 0, VPX_MAXIMUM_WORK_BUFFERS);
+
   ctx->buffer_pool = (BufferPool *)vpx_calloc(1, sizeof(BufferPool));
   if (ctx->buffer_pool == NULL) return VPX_CODEC_MEM_ERROR;
-
-  ctx->pbi = vp9_decoder_create(ctx->buffer_pool);
-  if (ctx->pbi == NULL) {
+#if CONFIG_MULTITHREAD
+  if (pthread_mutex_init(&ctx->buffer_pool->pool_mutex, NULL) ||
+      pthread_mutex_init(&ctx->buffer_pool->progress_mutex, NULL) ||
+      pthread_cond_init(&ctx->buffer_pool->progress_cond, NULL)) {
     vpx_free(ctx->buffer_pool);
     ctx->buffer_pool = NULL;
-    set_error_detail(ctx, "Failed to allocate decoder");
+    set_error_detail(ctx, "Failed to initialize buffer pool");
     return VPX_CODEC_MEM_ERROR;
   }
-  ctx->pbi->max_threads = ctx->cfg.threads;
-  ctx->pbi->inv_tile_order = ctx->invert_tile_order;
-
-  RANGE_CHECK(ctx, row_mt, 0, 1);
-  ctx->pbi->row_mt = ctx->row_mt;
+#endif
 
-  RANGE_CHECK(ctx, lpf_opt, 0, 1);
-  ctx->pbi->lpf_mt_opt = ctx->lpf_opt;
+  // Postprocessing runs on the decoder state of the output frame, which is
+  // only available when decoding serially.
+  if (ctx->frame_parallel_decode > 1 &&
+      !(ctx->base.init_flags & VPX_CODEC_USE_POSTPROC)) {
+    res = init_frame_workers(ctx);
+    if (res != VPX_CODEC_OK) {
+      remove_frame_workers(ctx);
+      free_buffer_pool(ctx);
+      return res;
+    }
+  } else {
+    ctx->pbi = vp9_decoder_create(ctx->buffer_pool);
+    if (ctx->pbi == NULL) {
+      free_buffer_pool(ctx);
+      set_error_detail(ctx, "Failed to allocate decoder");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    init_decoder_config(ctx, ctx->pbi, ctx->cfg.threads);
+  }
 
   // If postprocessing was enabled by the application and a
   // configuration has not been provided, default it.
@@ -286,10 +423,13 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
 
   res = init_buffer_callbacks(ctx);
   if (res != VPX_CODEC_OK) {
-    vpx_free(ctx->buffer_pool);
-    ctx->buffer_pool = NULL;
-    vp9_decoder_remove(ctx->pbi);
-    ctx->pbi = NULL;
+    if (ctx->frame_workers != NULL) {
+      remove_frame_workers(ctx);
+    } else {
+      vp9_decoder_remove(ctx->pbi);
+      ctx->pbi = NULL;
+    }
+    free_buffer_pool(ctx);
   }
   return res;
 }
@@ -302,6 +442,268 @@ static INLINE void check_resync(vpx_codec_alg_priv_t *const ctx,
     ctx->need_resync = 0;
 }
 
+static void release_frame_buffer(vpx_codec_alg_priv_t *ctx, int fb_idx) {
+  BufferPool *const pool = ctx->buffer_pool;
+  lock_buffer_pool(pool);
+  decrease_ref_count(fb_idx, pool->frame_bufs, pool);
+  unlock_buffer_pool(pool);
+}
+
+static void release_output_frames(vpx_codec_alg_priv_t *ctx) {
+  int i;
+  for (i = 0; i < ctx->num_output_frames; ++i) {
+    release_frame_buffer(ctx, ctx->output_fb_idx[i]);
+  }
+  ctx->num_output_frames = 0;
+}
+
+// Recomputes the frame buffer reference counts once the decoder has resynced,
+// dropping the references leaked by the frames that failed to decode. Called
+// with no frame in flight.
+static void reset_frame_buffer_refs(vpx_codec_alg_priv_t *ctx,
+                                    const VP9Decoder *const pbi) {
+  BufferPool *const pool = ctx->buffer_pool;
+  RefCntBuffer *const frame_bufs = pool->frame_bufs;
+  int ref_count[FRAME_BUFFERS] = { 0 };
+  int i;
+
+  for (i = 0; i < REF_FRAMES; ++i) {
+    if (pbi->common.ref_frame_map[i] >= 0)
+      ++ref_count[pbi->common.ref_frame_map[i]];
+  }
+  if (ctx->last_fb_idx >= 0) ++ref_count[ctx->last_fb_idx];
+  if (ctx->prev_fb_idx >= 0) ++ref_count[ctx->prev_fb_idx];
+  for (i = 0; i < ctx->num_cache_frames; ++i) {
+    ++ref_count[ctx->frame_cache[(ctx->frame_cache_read + i) %
+                                 FRAME_CACHE_SIZE]
+                    .fb_idx];
+  }
+  for (i = 0; i < ctx->num_output_frames; ++i) {
+    ++ref_count[ctx->output_fb_idx[i]];
+  }
+
+  lock_buffer_pool(pool);
+  for (i = 0; i < FRAME_BUFFERS; ++i) {
+    frame_bufs[i].ref_count = ref_count[i];
+    if (ref_count[i] == 0 && !frame_bufs[i].released &&
+        frame_bufs[i].raw_frame_buffer.priv) {
+      pool->release_fb_cb(pool->cb_priv, &frame_bufs[i].raw_frame_buffer);
+      frame_bufs[i].released = 1;
+    }
+  }
+  unlock_buffer_pool(pool);
+}
+
+// Waits for the oldest frame in flight and queues it for output unless
+// 'drop_output' is set.
+static vpx_codec_err_t sync_frame_worker(vpx_codec_alg_priv_t *ctx,
+                                         int drop_output) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VPxWorker *const worker = &ctx->frame_workers[ctx->next_output_worker_id];
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+  VP9Decoder *const pbi = frame_worker_data->pbi;
+  VP9_COMMON *const cm = &pbi->common;
+  const int need_resync = ctx->need_resync;
+
+  winterface->sync(worker);
+  ctx->next_output_worker_id =
+      (ctx->next_output_worker_id + 1) % ctx->num_frame_workers;
+  --ctx->num_frames_in_flight;
+
+  release_frame_buffer(ctx, frame_worker_data->prev_fb_idx);
+  frame_worker_data->prev_fb_idx = INVALID_IDX;
+
+  if (frame_worker_data->result != 0) {
+    pbi->cur_buf->buf.corrupted = 1;
+    release_frame_buffer(ctx, cm->new_fb_idx);
+    return update_error_state(ctx, &cm->error);
+  }
+
+  check_resync(ctx, pbi);
+
+  ctx->last_frame_info.base_qindex = cm->base_qindex;
+  ctx->last_frame_info.refresh_frame_flags = pbi->refresh_frame_flags;
+  ctx->last_frame_info.width = cm->width;
+  ctx->last_frame_info.height = cm->height;
+  ctx->last_frame_info.render_width = cm->render_width;
+  ctx->last_frame_info.render_height = cm->render_height;
+  ctx->last_frame_info.bit_depth = cm->bit_depth;
+  ctx->has_last_frame_info = 1;
+
+  // Only the last frame of a packet is output, as in serial mode. The frame
+  // buffer reference taken on submission moves to the output cache.
+  if (!drop_output && frame_worker_data->is_last_in_packet && cm->show_frame &&
+      !ctx->need_resync) {
+    RefCntBuffer *const frame_buf = &cm->buffer_pool->frame_bufs[cm->new_fb_idx];
+    cache_frame *cached;
+    if (ctx->num_cache_frames == FRAME_CACHE_SIZE) {
+      // The application does not retrieve the frames, drop the oldest one.
+      release_frame_buffer(ctx, ctx->frame_cache[ctx->frame_cache_read].fb_idx);
+      ctx->frame_cache_read = (ctx->frame_cache_read + 1) % FRAME_CACHE_SIZE;
+      --ctx->num_cache_frames;
+    }
+    cached = &ctx->frame_cache[ctx->frame_cache_write];
+    cached->fb_idx = cm->new_fb_idx;
+    yuvconfig2image(&cached->img, &frame_buf->buf, frame_worker_data->user_priv);
+    cached->img.fb_priv = frame_buf->raw_frame_buffer.priv;
+    ctx->frame_cache_write = (ctx->frame_cache_write + 1) % FRAME_CACHE_SIZE;
+    ++ctx->num_cache_frames;
+  } else {
+    release_frame_buffer(ctx, cm->new_fb_idx);
+  }
+
+  if (need_resync && !ctx->need_resync) reset_frame_buffer_refs(ctx, pbi);
+  return VPX_CODEC_OK;
+}
+
+// Drops the frames in flight after a frame failed to decode. Decoding resumes
+// on the next key frame or intra-only frame.
+static void flush_frame_workers_on_error(vpx_codec_alg_priv_t *ctx) {
+  while (ctx->num_frames_in_flight > 0) sync_frame_worker(ctx, 1);
+  ctx->need_resync = 1;
+  ctx->pbi->need_resync = 1;
+}
+
+static vpx_codec_err_t sync_all_frame_workers(vpx_codec_alg_priv_t *ctx) {
+  while (ctx->num_frames_in_flight > 0) {
+    const vpx_codec_err_t res = sync_frame_worker(ctx, 0);
+    if (res != VPX_CODEC_OK) {
+      flush_frame_workers_on_error(ctx);
+      return res;
+    }
+  }
+  return VPX_CODEC_OK;
+}
+
+static void hold_frame_buffer(BufferPool *const pool, int *fb_idx,
+                              int new_fb_idx) {
+  lock_buffer_pool(pool);
+  decrease_ref_count(*fb_idx, pool->frame_bufs, pool);
+  *fb_idx = new_fb_idx;
+  if (new_fb_idx >= 0) ++pool->frame_bufs[new_fb_idx].ref_count;
+  unlock_buffer_pool(pool);
+}
+
+static vpx_codec_err_t submit_frame(vpx_codec_alg_priv_t *ctx,
+                                    const uint8_t *data, unsigned int data_sz,
+                                    void *user_priv, int is_last_in_packet) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VPxWorker *const worker = &ctx->frame_workers[ctx->next_submit_worker_id];
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+  VP9Decoder *const pbi = frame_worker_data->pbi;
+  VP9_COMMON *const cm = &pbi->common;
+  BufferPool *const pool = ctx->buffer_pool;
+  // Decode the frames one at a time until the decoder has resynced. The
+  // decryptor may depend on the position of the data in the caller's buffer.
+  const int decode_serially = ctx->need_resync || ctx->decrypt_cb != NULL;
+  vpx_codec_err_t res;
+
+  // Determine the stream parameters. Note that we rely on peek_si to
+  // validate that we have a buffer that does not wrap around the top
+  // of the heap.
+  if (!ctx->si.h) {
+    int is_intra_only = 0;
+    res = decoder_peek_si_internal(data, data_sz, &ctx->si, &is_intra_only,
+                                   ctx->decrypt_cb, ctx->decrypt_state);
+    if (res != VPX_CODEC_OK) return res;
+
+    if (!ctx->si.is_kf && !is_intra_only) return VPX_CODEC_ERROR;
+  }
+
+  if (ctx->num_frames_in_flight == ctx->num_frame_workers ||
+      (decode_serially && ctx->num_frames_in_flight > 0)) {
+    res = decode_serially ? sync_all_frame_workers(ctx)
+                          : sync_frame_worker(ctx, 0);
+    if (res != VPX_CODEC_OK) {
+      flush_frame_workers_on_error(ctx);
+      return res;
+    }
+  }
+
+  if (decode_serially) {
+    frame_worker_data->data = data;
+  } else {
+    // The caller's buffer is only valid for the duration of this call.
+    if (frame_worker_data->scratch_buffer_size < data_sz) {
+      vpx_free(frame_worker_data->scratch_buffer);
+      frame_worker_data->scratch_buffer = (uint8_t *)vpx_malloc(data_sz);
+      if (frame_worker_data->scratch_buffer == NULL) {
+        frame_worker_data->scratch_buffer_size = 0;
+        set_error_detail(ctx, "Failed to allocate scratch buffer");
+        return VPX_CODEC_MEM_ERROR;
+      }
+      frame_worker_data->scratch_buffer_size = data_sz;
+    }
+    memcpy(frame_worker_data->scratch_buffer, data, data_sz);
+    frame_worker_data->data = frame_worker_data->scratch_buffer;
+  }
+  frame_worker_data->data_size = data_sz;
+  frame_worker_data->user_priv = user_priv;
+  frame_worker_data->is_last_in_packet = is_last_in_packet;
+
+  // Carry over the state of the previous frame once it is final.
+  if (ctx->last_submit_worker_id >= 0) {
+    res = vp9_frameworker_copy_context(
+        worker, &ctx->frame_workers[ctx->last_submit_worker_id]);
+    if (res != VPX_CODEC_OK) {
+      set_error_detail(ctx, "Failed to allocate context buffers");
+      return res;
+    }
+  }
+
+  // Keep the buffer providing the previous frame motion vectors until this
+  // frame is decoded.
+  {
+    const int prev_fb_idx =
+        cm->prev_frame != NULL ? (int)(cm->prev_frame - pool->frame_bufs)
+                               : INVALID_IDX;
+    hold_frame_buffer(pool, &frame_worker_data->prev_fb_idx, prev_fb_idx);
+    hold_frame_buffer(pool, &ctx->prev_fb_idx, prev_fb_idx);
+  }
+
+  // Find a free frame buffer, waiting for the frames in flight if needed.
+  for (;;) {
+    lock_buffer_pool(pool);
+    cm->new_fb_idx = get_free_fb(cm);
+    unlock_buffer_pool(pool);
+    if (cm->new_fb_idx != INVALID_IDX) break;
+    if (ctx->num_frames_in_flight == 0) {
+      set_error_detail(ctx, "Unable to find free frame buffer");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    res = sync_frame_worker(ctx, 0);
+    if (res != VPX_CODEC_OK) {
+      flush_frame_workers_on_error(ctx);
+      return res;
+    }
+  }
+  vpx_atomic_init(&pool->frame_bufs[cm->new_fb_idx].row, 0);
+  pool->frame_bufs[cm->new_fb_idx].buf.corrupted = 0;
+  hold_frame_buffer(pool, &ctx->last_fb_idx, cm->new_fb_idx);
+
+  cm->byte_alignment = ctx->byte_alignment;
+  cm->skip_loop_filter = ctx->skip_loop_filter;
+  pbi->decrypt_cb = ctx->decrypt_cb;
+  pbi->decrypt_state = ctx->decrypt_state;
+
+  vp9_frameworker_reset_stats(frame_worker_data);
+  ctx->pbi = pbi;
+  ctx->last_submit_worker_id = ctx->next_submit_worker_id;
+  ctx->next_submit_worker_id =
+      (ctx->next_submit_worker_id + 1) % ctx->num_frame_workers;
+  ++ctx->num_frames_in_flight;
+  winterface->launch(worker);
+
+  if (decode_serially) {
+    res = sync_frame_worker(ctx, 0);
+    if (res != VPX_CODEC_OK) {
+      flush_frame_workers_on_error(ctx);
+      return res;
+    }
+  }
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
                                   const uint8_t **data, unsigned int data_sz,
                                   void *user_priv) {
@@ -347,6 +749,7 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
 
   if (data == NULL && data_sz == 0) {
     ctx->flushed = 1;
+    if (ctx->frame_workers != NULL) release_output_frames(ctx);
     return VPX_CODEC_OK;
   }
 
@@ -366,6 +769,33 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
   if (ctx->svc_decoding && ctx->svc_spatial_layer < frame_count - 1)
     frame_count = ctx->svc_spatial_layer + 1;
 
+  if (ctx->frame_workers != NULL) {
+    // Decode in frame parallel mode. The frames of a packet are located
+    // through the superframe index.
+    const uint8_t *const data_end = data + data_sz;
+    int i;
+
+    release_output_frames(ctx);
+    if (frame_count == 0) {
+      frame_sizes[0] = data_sz;
+      frame_count = 1;
+    }
+    for (i = 0; i < frame_count; ++i) {
+      const uint32_t frame_size = frame_sizes[i];
+      if (data_start < data || frame_size > (uint32_t)(data_end - data_start)) {
+        set_error_detail(ctx, "Invalid frame size in index");
+        return VPX_CODEC_CORRUPT_FRAME;
+      }
+
+      res = submit_frame(ctx, data_start, frame_size, user_priv,
+                         i == frame_count - 1);
+      if (res != VPX_CODEC_OK) return res;
+
+      data_start += frame_size;
+    }
+    return VPX_CODEC_OK;
+  }
+
   // Decode in serial mode.
   if (frame_count > 0) {
     const uint8_t *const data_end = data + data_sz;
@@ -412,6 +842,32 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
   // always return only 1 frame per decode call.
   (void)iter;
 
+  if (ctx->frame_workers != NULL) {
+    // Return the frames in decode order, waiting for the frames in flight
+    // once the decoder has been flushed.
+    while (ctx->num_cache_frames == 0 && ctx->num_frames_in_flight > 0 &&
+           (ctx->flushed ||
+            vp9_frameworker_is_decoded(
+                &ctx->frame_workers[ctx->next_output_worker_id]))) {
+      if (sync_frame_worker(ctx, 0) != VPX_CODEC_OK) {
+        flush_frame_workers_on_error(ctx);
+        return NULL;
+      }
+    }
+    if (ctx->num_cache_frames > 0) {
+      const cache_frame *const cached =
+          &ctx->frame_cache[ctx->frame_cache_read];
+      ctx->frame_cache_read = (ctx->frame_cache_read + 1) % FRAME_CACHE_SIZE;
+      --ctx->num_cache_frames;
+      if (ctx->num_output_frames == FRAME_CACHE_SIZE) release_output_frames(ctx);
+      ctx->output_fb_idx[ctx->num_output_frames++] = cached->fb_idx;
+      ctx->last_show_frame = cached->fb_idx;
+      ctx->img = cached->img;
+      img = &ctx->img;
+    }
+    return img;
+  }
+
   if (ctx->pbi != NULL) {
     YV12_BUFFER_CONFIG sd;
     vp9_ppflags_t flags = { 0, 0, 0 };
@@ -454,6 +910,10 @@ static vpx_codec_err_t ctrl_set_reference(vpx_codec_alg_priv_t *ctx,
   if (data) {
     vpx_ref_frame_t *const frame = (vpx_ref_frame_t *)data;
     YV12_BUFFER_CONFIG sd;
+    if (ctx->frame_workers != NULL) {
+      const vpx_codec_err_t res = sync_all_frame_workers(ctx);
+      if (res != VPX_CODEC_OK) return res;
+    }
     image2yuvconfig(&frame->img, &sd);
     return vp9_set_reference_dec(
         &ctx->pbi->common, ref_frame_to_vp9_reframe(frame->frame_type), &sd);
@@ -469,6 +929,10 @@ static vpx_codec_err_t ctrl_copy_reference(vpx_codec_alg_priv_t *ctx,
   if (data) {
     vpx_ref_frame_t *frame = (vpx_ref_frame_t *)data;
     YV12_BUFFER_CONFIG sd;
+    if (ctx->frame_workers != NULL) {
+      const vpx_codec_err_t res = sync_all_frame_workers(ctx);
+      if (res != VPX_CODEC_OK) return res;
+    }
     image2yuvconfig(&frame->img, &sd);
     return vp9_copy_reference_dec(ctx->pbi, (VP9_REFFRAME)frame->frame_type,
                                   &sd);
@@ -483,7 +947,12 @@ static vpx_codec_err_t ctrl_get_reference(vpx_codec_alg_priv_t *ctx,
 
   if (data) {
     if (ctx->pbi) {
-      const int fb_idx = ctx->pbi->common.cur_show_frame_fb_idx;
+      int fb_idx;
+      if (ctx->frame_workers != NULL) {
+        const vpx_codec_err_t res = sync_all_frame_workers(ctx);
+        if (res != VPX_CODEC_OK) return res;
+      }
+      fb_idx = ctx->pbi->common.cur_show_frame_fb_idx;
       YV12_BUFFER_CONFIG *fb = get_buf_frame(&ctx->pbi->common, fb_idx);
       if (fb == NULL) return VPX_CODEC_ERROR;
       yuvconfig2image(&data->img, fb, NULL);
@@ -519,6 +988,11 @@ static vpx_codec_err_t ctrl_get_quantizer(vpx_codec_alg_priv_t *ctx,
                                           va_list args) {
   int *const arg = va_arg(args, int *);
   if (arg == NULL || ctx->pbi == NULL) return VPX_CODEC_INVALID_PARAM;
+  if (ctx->frame_workers != NULL) {
+    if (!ctx->has_last_frame_info) return VPX_CODEC_ERROR;
+    *arg = ctx->last_frame_info.base_qindex;
+    return VPX_CODEC_OK;
+  }
   *arg = ctx->pbi->common.base_qindex;
   return VPX_CODEC_OK;
 }
@@ -528,7 +1002,11 @@ static vpx_codec_err_t ctrl_get_last_ref_updates(vpx_codec_alg_priv_t *ctx,
   int *const update_info = va_arg(args, int *);
 
   if (update_info) {
-    if (ctx->pbi != NULL) {
+    if (ctx->frame_workers != NULL) {
+      if (!ctx->has_last_frame_info) return VPX_CODEC_ERROR;
+      *update_info = ctx->last_frame_info.refresh_frame_flags;
+      return VPX_CODEC_OK;
+    } else if (ctx->pbi != NULL) {
       *update_info = ctx->pbi->refresh_frame_flags;
       return VPX_CODEC_OK;
     } else {
@@ -546,7 +1024,9 @@ static vpx_codec_err_t ctrl_get_frame_corrupted(vpx_codec_alg_priv_t *ctx,
   if (corrupted) {
     if (ctx->pbi != NULL) {
       RefCntBuffer *const frame_bufs = ctx->pbi->common.buffer_pool->frame_bufs;
-      if (ctx->pbi->common.frame_to_show == NULL) return VPX_CODEC_ERROR;
+      if (ctx->frame_workers != NULL ? !ctx->has_last_frame_info
+                                     : ctx->pbi->common.frame_to_show == NULL)
+        return VPX_CODEC_ERROR;
       if (ctx->last_show_frame >= 0)
         *corrupted = frame_bufs[ctx->last_show_frame].buf.corrupted;
       return VPX_CODEC_OK;
@@ -563,7 +1043,12 @@ static vpx_codec_err_t ctrl_get_frame_size(vpx_codec_alg_priv_t *ctx,
   int *const frame_size = va_arg(args, int *);
 
   if (frame_size) {
-    if (ctx->pbi != NULL) {
+    if (ctx->frame_workers != NULL) {
+      if (!ctx->has_last_frame_info) return VPX_CODEC_ERROR;
+      frame_size[0] = ctx->last_frame_info.width;
+      frame_size[1] = ctx->last_frame_info.height;
+      return VPX_CODEC_OK;
+    } else if (ctx->pbi != NULL) {
       const VP9_COMMON *const cm = &ctx->pbi->common;
       frame_size[0] = cm->width;
       frame_size[1] = cm->height;
@@ -581,7 +1066,12 @@ static vpx_codec_err_t ctrl_get_render_size(vpx_codec_alg_priv_t *ctx,
   int *const render_size = va_arg(args, int *);
 
   if (render_size) {
-    if (ctx->pbi != NULL) {
+    if (ctx->frame_workers != NULL) {
+      if (!ctx->has_last_frame_info) return VPX_CODEC_ERROR;
+      render_size[0] = ctx->last_frame_info.render_width;
+      render_size[1] = ctx->last_frame_info.render_height;
+      return VPX_CODEC_OK;
+    } else if (ctx->pbi != NULL) {
       const VP9_COMMON *const cm = &ctx->pbi->common;
       render_size[0] = cm->render_width;
       render_size[1] = cm->render_height;
@@ -599,7 +1089,11 @@ static vpx_codec_err_t ctrl_get_bit_depth(vpx_codec_alg_priv_t *ctx,
   unsigned int *const bit_depth = va_arg(args, unsigned int *);
 
   if (bit_depth) {
-    if (ctx->pbi != NULL) {
+    if (ctx->frame_workers != NULL) {
+      if (!ctx->has_last_frame_info) return VPX_CODEC_ERROR;
+      *bit_depth = ctx->last_frame_info.bit_depth;
+      return VPX_CODEC_OK;
+    } else if (ctx->pbi != NULL) {
       const VP9_COMMON *const cm = &ctx->pbi->common;
       *bit_depth = cm->bit_depth;
       return VPX_CODEC_OK;
@@ -639,7 +1133,8 @@ static vpx_codec_err_t ctrl_set_byte_alignment(vpx_codec_alg_priv_t *ctx,
     return VPX_CODEC_INVALID_PARAM;
 
   ctx->byte_alignment = byte_alignment;
-  if (ctx->pbi != NULL) {
+  // The frame workers pick up the setting when a frame is submitted.
+  if (ctx->pbi != NULL && ctx->frame_workers == NULL) {
     ctx->pbi->common.byte_alignment = byte_alignment;
   }
   return VPX_CODEC_OK;
@@ -649,7 +1144,7 @@ static vpx_codec_err_t ctrl_set_skip_loop_filter(vpx_codec_alg_priv_t *ctx,
                                                  va_list args) {
   ctx->skip_loop_filter = va_arg(args, int);
 
-  if (ctx->pbi != NULL) {
+  if (ctx->pbi != NULL && ctx->frame_workers == NULL) {
     ctx->pbi->common.skip_loop_filter = ctx->skip_loop_filter;
   }
 
@@ -680,6 +1175,24 @@ static vpx_codec_err_t ctrl_enable_lpf_opt(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_frame_parallel(vpx_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  // The number of frame workers is fixed once the decoder is initialized.
+  if (ctx->pbi != NULL) return VPX_CODEC_ERROR;
+  ctx->frame_parallel_decode = va_arg(args, int);
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_lazy_border(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  // The reference frames keep the border they were allocated with.
+  if (ctx->pbi != NULL) return VPX_CODEC_ERROR;
+  ctx->lazy_border = va_arg(args, int);
+
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP8_COPY_REFERENCE, ctrl_copy_reference },
 
@@ -693,6 +1206,8 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9_DECODE_SVC_SPATIAL_LAYER, ctrl_set_spatial_layer_svc },
   { VP9D_SET_ROW_MT, ctrl_set_row_mt },
   { VP9D_SET_LOOP_FILTER_OPT, ctrl_enable_lpf_opt },
+  { VP9D_SET_FRAME_PARALLEL, ctrl_set_frame_parallel },
+  { VP9D_SET_LAZY_BORDER, ctrl_set_lazy_border },
 
   // Getters
   { VPXD_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -12,9 +12,31 @@
 #define VPX_VP9_VP9_DX_IFACE_H_
 
 #include "vp9/decoder/vp9_decoder.h"
+#include "vp9/decoder/vp9_dthread.h"
 
 typedef vpx_codec_stream_info_t vp9_stream_info_t;
 
+// Maximum number of decoded frames waiting to be returned in frame parallel
+// mode.
+#define FRAME_CACHE_SIZE (2 * FRAME_BUFFERS)
+
+typedef struct cache_frame {
+  int fb_idx;
+  vpx_image_t img;
+} cache_frame;
+
+// State of the last frame decoded in frame parallel mode, reported by the
+// getters while the next frames are being decoded.
+typedef struct {
+  int base_qindex;
+  int refresh_frame_flags;
+  int width;
+  int height;
+  int render_width;
+  int render_height;
+  vpx_bit_depth_t bit_depth;
+} FrameInfo;
+
 struct vpx_codec_alg_priv {
   vpx_codec_priv_t base;
   vpx_codec_dec_cfg_t cfg;
@@ -47,6 +69,32 @@ struct vpx_codec_alg_priv {
   int svc_spatial_layer;
   int row_mt;
   int lpf_opt;
+  int lazy_border;
+
+  // Frame parallel decode. Each frame worker owns a decoder, 'pbi' points to
+  // the decoder of the last submitted frame.
+  int frame_parallel_decode;  // Number of frames decoded in parallel.
+  VPxWorker *frame_workers;
+  int num_frame_workers;
+  int next_submit_worker_id;
+  int last_submit_worker_id;
+  int next_output_worker_id;
+  int num_frames_in_flight;
+  // Frame buffers held for the next submitted frame: the buffer of the last
+  // submitted frame and the one providing its previous frame motion vectors.
+  int last_fb_idx;
+  int prev_fb_idx;
+  // Decoded frames waiting to be returned by decoder_get_frame().
+  cache_frame frame_cache[FRAME_CACHE_SIZE];
+  int frame_cache_write;
+  int frame_cache_read;
+  int num_cache_frames;
+  // Frame buffers returned by decoder_get_frame(), released by the next call
+  // to decoder_decode().
+  int output_fb_idx[FRAME_CACHE_SIZE];
+  int num_output_frames;
+  FrameInfo last_frame_info;
+  int has_last_frame_info;
 };
 
 #endif  // VPX_VP9_VP9_DX_IFACE_H_
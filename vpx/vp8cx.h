@@ -776,6 +776,55 @@ enum vp8e_enc_control_id {
    *
    */
   VP9E_SET_QUANTIZER_ONE_PASS,
+
+  /*!\brief Codec control to let the encoder reference caller-owned source
+   * frames instead of copying them into its lookahead, with
+   * vpx_source_release_cb_t* parameter.
+   *
+   * While a release callback is installed, each frame passed to
+   * vpx_codec_encode() is held by reference until the encoder no longer
+   * needs it and is then handed back through the callback. The caller must
+   * not modify or free the frame until that happens. The frame must be laid
+   * out like the encoder's own source buffers: every plane is surrounded by
+   * #VP9E_SOURCE_BORDER_IN_PIXELS pixels (subsampled for chroma), which the
+   * encoder may overwrite, the luma stride in pixels is
+   * (((d_w + 7) & ~7) + 2 * VP9E_SOURCE_BORDER_IN_PIXELS + 31) & ~31, and
+   * the chroma stride is the luma stride >> x_chroma_shift. Frames laid out
+   * differently, including NV12 frames, are copied as usual and
+   * handed back before vpx_codec_encode() returns, as is a frame passed to a
+   * vpx_codec_encode() call that fails. Setting release_cb to
+   * NULL restores the copying behavior; frames already held are still
+   * released.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_EXTERNAL_SOURCE_BUFFERS,
+
+  /*!\brief Codec control to compute PSNR asynchronously, int parameter.
+   *
+   * Only takes effect when the encoder was initialized with
+   * #VPX_CODEC_USE_PSNR. When set to 1, the PSNR of a frame is computed on a
+   * separate thread while the caller consumes its packets, and the
+   * #VPX_CODEC_PSNR_PKT for it is returned by the next vpx_codec_encode()
+   * call that outputs a frame, ahead of that frame's packet. When flushing,
+   * the PSNR packet is returned with its frame. 0 (default) returns the
+   * PSNR packet right before the frame it describes.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_ASYNC_PSNR,
+
+  /*!\brief Codec control to scale the SVC spatial layers ahead, int
+   * parameter.
+   *
+   * When set to 1 in one pass SVC, the source of the next spatial layer of a
+   * superframe is scaled down on a separate thread while the current layer is
+   * encoded, so the next layer doesn't wait for it. The output is the same as
+   * with 0 (default), which scales each layer's source when it starts.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_SVC_ASYNC_SCALE,
 };
 
 /*!\brief vpx 1-D scaling mode
@@ -967,6 +1016,30 @@ typedef struct vpx_svc_spatial_layer_sync {
   int base_layer_intra_only; /**< Flag for setting Intra-only frame on base */
 } vpx_svc_spatial_layer_sync_t;
 
+/*!\brief Border, in luma pixels, around a source frame that the VP9 encoder
+ * references in place.
+ */
+#define VP9E_SOURCE_BORDER_IN_PIXELS 160
+
+/*!\brief Source frame release callback prototype
+ *
+ * Called when the encoder no longer references a frame it took through
+ * VP9E_SET_EXTERNAL_SOURCE_BUFFERS. \p img is a copy of the image descriptor
+ * passed to vpx_codec_encode(); its planes and user_priv identify the frame.
+ */
+typedef void (*vpx_release_source_cb_fn_t)(void *cb_priv,
+                                           const vpx_image_t *img);
+
+/*!\brief vp9 source frame release callback
+ *
+ * This defines the callback used to return caller-owned source frames.
+ *
+ */
+typedef struct vpx_source_release_cb {
+  vpx_release_source_cb_fn_t release_cb; /**< NULL disables zero-copy input */
+  void *cb_priv; /**< Caller data passed to release_cb */
+} vpx_source_release_cb_t;
+
 /*!\cond */
 /*!\brief VP8 encoder control function parameter type
  *
@@ -1108,6 +1181,12 @@ VPX_CTRL_USE_TYPE(VP8E_SET_RTC_EXTERNAL_RATECTRL, int)
 #define VPX_CTRL_VP8E_SET_RTC_EXTERNAL_RATECTRL
 VPX_CTRL_USE_TYPE(VP9E_SET_QUANTIZER_ONE_PASS, int)
 #define VPX_CTRL_VP9E_SET_QUANTIZER_ONE_PASS
+VPX_CTRL_USE_TYPE(VP9E_SET_EXTERNAL_SOURCE_BUFFERS, vpx_source_release_cb_t *)
+#define VPX_CTRL_VP9E_SET_EXTERNAL_SOURCE_BUFFERS
+VPX_CTRL_USE_TYPE(VP9E_SET_ASYNC_PSNR, int)
+#define VPX_CTRL_VP9E_SET_ASYNC_PSNR
+VPX_CTRL_USE_TYPE(VP9E_SET_SVC_ASYNC_SCALE, int)
+#define VPX_CTRL_VP9E_SET_SVC_ASYNC_SCALE
 
 /*!\endcond */
 /*! @} - end defgroup vp8_encoder */
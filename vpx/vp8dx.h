@@ -158,6 +158,47 @@ enum vp8_dec_control_id {
    */
   VP9D_SET_LOOP_FILTER_OPT,
 
+  /*!\brief Codec control function to decode frames in parallel.
+   *
+   * The argument is the number of frames decoded at the same time, at most
+   * #VPX_MAXIMUM_WORK_BUFFERS. 0 and 1 decode frames serially. A frame starts
+   * decoding as soon as the rows of the reference frames it predicts from are
+   * available, the output is identical to the serial decode. Frames are
+   * returned with a delay of up to the number of frames in flight, the
+   * remaining frames are returned after flushing the decoder. Packets holding
+   * more than one frame must carry a superframe index. Must be set before the
+   * first frame is decoded, has no effect when postprocessing is enabled.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_FRAME_PARALLEL,
+
+  /*!\brief Codec control function to allocate frames without a border.
+   *
+   * The argument is 0 or 1. When set to 1 the reference frames are allocated
+   * without a border, the pixels outside the frame are built on demand for
+   * the blocks predicted from them. This reduces the memory footprint of the
+   * frame buffers. Must be set before the first frame is decoded, has no
+   * effect when postprocessing is enabled.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_LAZY_BORDER,
+
+  /*!\brief Codec control function to set dynamic row dispatch in the
+   * multi-threaded decoder.
+   *
+   * 0 : off, each thread decodes a fixed set of macroblock rows and spins
+   *     while waiting on the row above.
+   * 1 : on, threads take the next undecoded row as they become free and
+   *     block after a short spin while waiting on the row above.
+   *
+   * The output is identical in both modes.
+   *
+   * Supported in codecs: VP8
+   */
+  VP8D_SET_ROW_MT,
+
   VP8_DECODER_CTRL_ID_MAX
 };
 
@@ -217,6 +258,12 @@ VPX_CTRL_USE_TYPE(VP9D_SET_ROW_MT, int)
 #define VPX_CTRL_VP9_DECODE_SET_ROW_MT
 VPX_CTRL_USE_TYPE(VP9D_SET_LOOP_FILTER_OPT, int)
 #define VPX_CTRL_VP9_SET_LOOP_FILTER_OPT
+VPX_CTRL_USE_TYPE(VP9D_SET_FRAME_PARALLEL, int)
+#define VPX_CTRL_VP9D_SET_FRAME_PARALLEL
+VPX_CTRL_USE_TYPE(VP9D_SET_LAZY_BORDER, int)
+#define VPX_CTRL_VP9D_SET_LAZY_BORDER
+VPX_CTRL_USE_TYPE(VP8D_SET_ROW_MT, int)
+#define VPX_CTRL_VP8D_SET_ROW_MT
 
 /*!\endcond */
 /*! @} - end defgroup vp8_decoder */
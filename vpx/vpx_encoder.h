@@ -1075,6 +1075,20 @@ vpx_codec_err_t vpx_codec_encode(vpx_codec_ctx_t *ctx, const vpx_image_t *img,
  * that may output multiple packets for a single encoded frame (e.g., lagged
  * encoding) or if the application does not reset the buffer periodically.
  *
+ * The VP8 and VP9 encoders write the compressed data, including any VP9
+ * superframe index, directly into the buffer, so no copy is made, while the
+ * space left in it besides the padding is at least:
+ * - VP8: g_w * g_h * 3 / 2 bytes (an uncompressed 8-bit 4:2:0 frame), and
+ *   no less than 16384 bytes. Partitioned output
+ *   (#VPX_CODEC_USE_OUTPUT_PARTITION) is always copied.
+ * - VP9: the size of an uncompressed g_w x g_h frame in the format of the
+ *   images passed to vpx_codec_encode(), four times that in two-pass
+ *   encoding with multiple alt-ref layers, and no less than 4096 bytes,
+ *   plus the size of any invisible frames waiting to be output with the
+ *   next visible frame. Frames sent to a #VP9E_REGISTER_CX_CALLBACK
+ *   callback are always copied.
+ * These sizes only grow over the life of the encoder.
+ *
  * Applications may restore the default behavior of the codec providing
  * the compressed data buffer by calling this function with a NULL
  * buffer.
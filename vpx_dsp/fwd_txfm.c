@@ -772,6 +772,11 @@ void vpx_highbd_fdct4x4_c(const int16_t *input, tran_low_t *output,
   vpx_fdct4x4_c(input, output, stride);
 }
 
+void vpx_highbd_fdct4x4_1_c(const int16_t *input, tran_low_t *output,
+                            int stride) {
+  vpx_fdct4x4_1_c(input, output, stride);
+}
+
 void vpx_highbd_fdct8x8_c(const int16_t *input, tran_low_t *output,
                           int stride) {
   vpx_fdct8x8_c(input, output, stride);
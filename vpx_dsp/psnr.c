@@ -11,6 +11,7 @@
 #include <math.h>
 #include <assert.h>
 #include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_dsp/psnr.h"
 #include "vpx_scale/yv12config.h"
 
@@ -174,75 +175,68 @@ int64_t vpx_highbd_get_y_sse(const YV12_BUFFER_CONFIG *a,
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
-#if CONFIG_VP9_HIGHBITDEPTH
-void vpx_calc_highbd_psnr(const YV12_BUFFER_CONFIG *a,
-                          const YV12_BUFFER_CONFIG *b, PSNR_STATS *psnr,
-                          uint32_t bit_depth, uint32_t in_bit_depth) {
+void vpx_get_sse_rows(const YV12_BUFFER_CONFIG *a,
+                      const YV12_BUFFER_CONFIG *b, int row_start, int row_end,
+                      uint32_t bit_depth, uint32_t in_bit_depth,
+                      int64_t *plane_sse) {
+  // Derive the chroma rows from the crop sizes so the last band also covers
+  // the odd chroma row of an odd height.
+  const int ss_y = a->uv_crop_height < a->y_crop_height;
+  const int uv_start = row_start >> ss_y;
+  const int uv_end =
+      row_end >= a->y_crop_height ? a->uv_crop_height : row_end >> ss_y;
+  const int starts[3] = { row_start, uv_start, uv_start };
+  const int heights[3] = { VPXMIN(row_end, a->y_crop_height) - row_start,
+                           uv_end - uv_start, uv_end - uv_start };
   const int widths[3] = { a->y_crop_width, a->uv_crop_width, a->uv_crop_width };
-  const int heights[3] = { a->y_crop_height, a->uv_crop_height,
-                           a->uv_crop_height };
   const uint8_t *a_planes[3] = { a->y_buffer, a->u_buffer, a->v_buffer };
   const int a_strides[3] = { a->y_stride, a->uv_stride, a->uv_stride };
   const uint8_t *b_planes[3] = { b->y_buffer, b->u_buffer, b->v_buffer };
   const int b_strides[3] = { b->y_stride, b->uv_stride, b->uv_stride };
   int i;
-  uint64_t total_sse = 0;
-  uint32_t total_samples = 0;
-  const double peak = (double)((1 << in_bit_depth) - 1);
+#if CONFIG_VP9_HIGHBITDEPTH
   const unsigned int input_shift = bit_depth - in_bit_depth;
+#else
+  (void)bit_depth;
+  (void)in_bit_depth;
+#endif
 
   for (i = 0; i < 3; ++i) {
+    const uint8_t *const pa = a_planes[i] + starts[i] * a_strides[i];
+    const uint8_t *const pb = b_planes[i] + starts[i] * b_strides[i];
     const int w = widths[i];
     const int h = heights[i];
-    const uint32_t samples = w * h;
-    uint64_t sse;
+    if (h <= 0) continue;
+#if CONFIG_VP9_HIGHBITDEPTH
     if (a->flags & YV12_FLAG_HIGHBITDEPTH) {
       if (input_shift) {
-        sse = highbd_get_sse_shift(a_planes[i], a_strides[i], b_planes[i],
-                                   b_strides[i], w, h, input_shift);
+        plane_sse[i] += highbd_get_sse_shift(pa, a_strides[i], pb,
+                                             b_strides[i], w, h, input_shift);
       } else {
-        sse = highbd_get_sse(a_planes[i], a_strides[i], b_planes[i],
-                             b_strides[i], w, h);
+        plane_sse[i] +=
+            highbd_get_sse(pa, a_strides[i], pb, b_strides[i], w, h);
       }
-    } else {
-      sse = get_sse(a_planes[i], a_strides[i], b_planes[i], b_strides[i], w, h);
+      continue;
     }
-    psnr->sse[1 + i] = sse;
-    psnr->samples[1 + i] = samples;
-    psnr->psnr[1 + i] = vpx_sse_to_psnr(samples, peak, (double)sse);
-
-    total_sse += sse;
-    total_samples += samples;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+    plane_sse[i] += get_sse(pa, a_strides[i], pb, b_strides[i], w, h);
   }
-
-  psnr->sse[0] = total_sse;
-  psnr->samples[0] = total_samples;
-  psnr->psnr[0] =
-      vpx_sse_to_psnr((double)total_samples, peak, (double)total_sse);
 }
 
-#endif  // !CONFIG_VP9_HIGHBITDEPTH
-
-void vpx_calc_psnr(const YV12_BUFFER_CONFIG *a, const YV12_BUFFER_CONFIG *b,
-                   PSNR_STATS *psnr) {
-  static const double peak = 255.0;
+void vpx_sse_to_psnr_stats(const YV12_BUFFER_CONFIG *a,
+                           const int64_t *plane_sse, uint32_t in_bit_depth,
+                           PSNR_STATS *psnr) {
   const int widths[3] = { a->y_crop_width, a->uv_crop_width, a->uv_crop_width };
   const int heights[3] = { a->y_crop_height, a->uv_crop_height,
                            a->uv_crop_height };
-  const uint8_t *a_planes[3] = { a->y_buffer, a->u_buffer, a->v_buffer };
-  const int a_strides[3] = { a->y_stride, a->uv_stride, a->uv_stride };
-  const uint8_t *b_planes[3] = { b->y_buffer, b->u_buffer, b->v_buffer };
-  const int b_strides[3] = { b->y_stride, b->uv_stride, b->uv_stride };
+  const double peak = (double)((1 << in_bit_depth) - 1);
   int i;
   uint64_t total_sse = 0;
   uint32_t total_samples = 0;
 
   for (i = 0; i < 3; ++i) {
-    const int w = widths[i];
-    const int h = heights[i];
-    const uint32_t samples = w * h;
-    const uint64_t sse =
-        get_sse(a_planes[i], a_strides[i], b_planes[i], b_strides[i], w, h);
+    const uint32_t samples = widths[i] * heights[i];
+    const uint64_t sse = (uint64_t)plane_sse[i];
     psnr->sse[1 + i] = sse;
     psnr->samples[1 + i] = samples;
     psnr->psnr[1 + i] = vpx_sse_to_psnr(samples, peak, (double)sse);
@@ -256,3 +250,22 @@ void vpx_calc_psnr(const YV12_BUFFER_CONFIG *a, const YV12_BUFFER_CONFIG *b,
   psnr->psnr[0] =
       vpx_sse_to_psnr((double)total_samples, peak, (double)total_sse);
 }
+
+#if CONFIG_VP9_HIGHBITDEPTH
+void vpx_calc_highbd_psnr(const YV12_BUFFER_CONFIG *a,
+                          const YV12_BUFFER_CONFIG *b, PSNR_STATS *psnr,
+                          uint32_t bit_depth, uint32_t in_bit_depth) {
+  int64_t plane_sse[3] = { 0, 0, 0 };
+  vpx_get_sse_rows(a, b, 0, a->y_crop_height, bit_depth, in_bit_depth,
+                   plane_sse);
+  vpx_sse_to_psnr_stats(a, plane_sse, in_bit_depth, psnr);
+}
+
+#endif  // !CONFIG_VP9_HIGHBITDEPTH
+
+void vpx_calc_psnr(const YV12_BUFFER_CONFIG *a, const YV12_BUFFER_CONFIG *b,
+                   PSNR_STATS *psnr) {
+  int64_t plane_sse[3] = { 0, 0, 0 };
+  vpx_get_sse_rows(a, b, 0, a->y_crop_height, 8, 8, plane_sse);
+  vpx_sse_to_psnr_stats(a, plane_sse, 8, psnr);
+}
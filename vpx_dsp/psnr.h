@@ -44,6 +44,31 @@ void vpx_calc_highbd_psnr(const YV12_BUFFER_CONFIG *a,
 void vpx_calc_psnr(const YV12_BUFFER_CONFIG *a, const YV12_BUFFER_CONFIG *b,
                    PSNR_STATS *psnr);
 
+/*!\brief Accumulates the per plane SSE of a band of rows
+ *
+ * Adds the SSE between \p a and \p b over luma rows [row_start, row_end),
+ * and the chroma rows they cover, to \p plane_sse. Bands split at multiples
+ * of 32 rows keep the 16x16 blocks of a whole frame pass and add up to the
+ * SSE of vpx_calc_psnr() and vpx_calc_highbd_psnr().
+ *
+ * \param[in]    a             Source frame
+ * \param[in]    b             Reconstructed frame
+ * \param[in]    row_start     First luma row of the band
+ * \param[in]    row_end       End luma row of the band, exclusive
+ * \param[in]    bit_depth     Bit depth of the frames
+ * \param[in]    in_bit_depth  Bit depth of the input, used for the peak
+ * \param[in,out] plane_sse    Y, U and V SSE to add to
+ */
+void vpx_get_sse_rows(const YV12_BUFFER_CONFIG *a,
+                      const YV12_BUFFER_CONFIG *b, int row_start, int row_end,
+                      uint32_t bit_depth, uint32_t in_bit_depth,
+                      int64_t *plane_sse);
+
+/*!\brief Fills PSNR stats from the per plane SSE of \p a */
+void vpx_sse_to_psnr_stats(const YV12_BUFFER_CONFIG *a,
+                           const int64_t *plane_sse, uint32_t in_bit_depth,
+                           PSNR_STATS *psnr);
+
 double vpx_psnrhvs(const YV12_BUFFER_CONFIG *source,
                    const YV12_BUFFER_CONFIG *dest, double *phvs_y,
                    double *phvs_u, double *phvs_v, uint32_t bd, uint32_t in_bd);
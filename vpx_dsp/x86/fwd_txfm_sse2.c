@@ -270,3 +270,55 @@ void vpx_fdct32x32_1_sse2(const int16_t *input, tran_low_t *output,
 #undef FDCT32x32_HIGH_PRECISION
 #undef DCT_HIGH_BIT_DEPTH
 #endif  // CONFIG_VP9_HIGHBITDEPTH
+
+#if CONFIG_VP9_HIGHBITDEPTH
+// High bitdepth residuals can overflow the 16-bit accumulators used above, so
+// the high bitdepth versions sum into 32-bit lanes with _mm_madd_epi16().
+static INLINE int highbd_sum_block_sse2(const int16_t *input, int stride,
+                                        int size) {
+  const __m128i one = _mm_set1_epi16(1);
+  __m128i sum = _mm_setzero_si128();
+  int r, c;
+
+  if (size == 4) {
+    for (r = 0; r < 4; r += 2) {
+      const __m128i in = _mm_unpacklo_epi64(
+          _mm_loadl_epi64((const __m128i *)(input + r * stride)),
+          _mm_loadl_epi64((const __m128i *)(input + (r + 1) * stride)));
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(in, one));
+    }
+  } else {
+    for (r = 0; r < size; ++r) {
+      for (c = 0; c < size; c += 8) {
+        const __m128i in =
+            _mm_load_si128((const __m128i *)(input + r * stride + c));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(in, one));
+      }
+    }
+  }
+
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+  return _mm_cvtsi128_si32(sum);
+}
+
+void vpx_highbd_fdct4x4_1_sse2(const int16_t *input, tran_low_t *output,
+                               int stride) {
+  output[0] = (tran_low_t)(highbd_sum_block_sse2(input, stride, 4) * 2);
+}
+
+void vpx_highbd_fdct8x8_1_sse2(const int16_t *input, tran_low_t *output,
+                               int stride) {
+  output[0] = (tran_low_t)highbd_sum_block_sse2(input, stride, 8);
+}
+
+void vpx_highbd_fdct16x16_1_sse2(const int16_t *input, tran_low_t *output,
+                                 int stride) {
+  output[0] = (tran_low_t)(highbd_sum_block_sse2(input, stride, 16) >> 1);
+}
+
+void vpx_highbd_fdct32x32_1_sse2(const int16_t *input, tran_low_t *output,
+                                 int stride) {
+  output[0] = (tran_low_t)(highbd_sum_block_sse2(input, stride, 32) >> 3);
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
@@ -0,0 +1,465 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_ports/mem.h"
+
+// All the filters work on 16 pixels at a time. The single edge versions load
+// their 8 pixels into both lanes and only store the low lane back.
+
+static INLINE __m256i abs_diff16(__m256i a, __m256i b) {
+  return _mm256_or_si256(_mm256_subs_epu16(a, b), _mm256_subs_epu16(b, a));
+}
+
+static INLINE __m256i clamp16(__m256i v, __m256i min, __m256i max) {
+  return _mm256_min_epi16(_mm256_max_epi16(v, min), max);
+}
+
+static INLINE __m256i load_limit(const uint8_t *l0, const uint8_t *l1,
+                                 int bd) {
+  const int shift = bd - 8;
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_set1_epi16((int16_t)(l0[0] << shift))),
+      _mm_set1_epi16((int16_t)(l1[0] << shift)), 1);
+}
+
+// Filters the edge between p[0] and q[0]. 'taps' is 4, 8 or 16, p[4] to p[7]
+// and q[4] to q[7] are only used by the 16 tap filter. The filtered pixels
+// are written back to 'p' and 'q'.
+static INLINE void highbd_filter_avx2(__m256i *p, __m256i *q,
+                                      const __m256i blimit,
+                                      const __m256i limit,
+                                      const __m256i thresh, int bd, int taps) {
+  const __m256i ff = _mm256_set1_epi16(-1);
+  const __m256i one = _mm256_set1_epi16(1);
+  const __m256i flat_thresh = _mm256_set1_epi16(1 << (bd - 8));
+  const __m256i offset = _mm256_set1_epi16(0x80 << (bd - 8));
+  const __m256i min = _mm256_sub_epi16(_mm256_setzero_si256(), offset);
+  const __m256i max = _mm256_sub_epi16(offset, one);
+  const __m256i abs_p1p0 = abs_diff16(p[1], p[0]);
+  const __m256i abs_q1q0 = abs_diff16(q[1], q[0]);
+  __m256i mask, hev, flat, work;
+  __m256i op1, op0, oq0, oq1;
+
+  // mask |= (abs(p0 - q0) * 2 + abs(p1 - q1) / 2 > blimit) * -1;
+  work = _mm256_add_epi16(
+      _mm256_slli_epi16(abs_diff16(p[0], q[0]), 1),
+      _mm256_srli_epi16(abs_diff16(p[1], q[1]), 1));
+  mask = _mm256_cmpgt_epi16(work, blimit);
+  work = _mm256_max_epi16(abs_p1p0, abs_q1q0);
+  hev = _mm256_cmpgt_epi16(work, thresh);
+  work = _mm256_max_epi16(
+      work, _mm256_max_epi16(abs_diff16(p[2], p[1]), abs_diff16(q[2], q[1])));
+  work = _mm256_max_epi16(
+      work, _mm256_max_epi16(abs_diff16(p[3], p[2]), abs_diff16(q[3], q[2])));
+  mask = _mm256_or_si256(mask, _mm256_cmpgt_epi16(work, limit));
+  mask = _mm256_xor_si256(mask, ff);
+
+  // filter4
+  {
+    const __m256i ps1 = _mm256_sub_epi16(p[1], offset);
+    const __m256i ps0 = _mm256_sub_epi16(p[0], offset);
+    const __m256i qs0 = _mm256_sub_epi16(q[0], offset);
+    const __m256i qs1 = _mm256_sub_epi16(q[1], offset);
+    const __m256i diff = _mm256_sub_epi16(qs0, ps0);
+    __m256i filt, filter1, filter2;
+
+    filt = _mm256_and_si256(clamp16(_mm256_sub_epi16(ps1, qs1), min, max), hev);
+    filt = _mm256_add_epi16(filt, _mm256_add_epi16(diff, diff));
+    filt = clamp16(_mm256_add_epi16(filt, diff), min, max);
+    filt = _mm256_and_si256(filt, mask);
+
+    filter1 = _mm256_srai_epi16(
+        clamp16(_mm256_add_epi16(filt, _mm256_set1_epi16(4)), min, max), 3);
+    filter2 = _mm256_srai_epi16(
+        clamp16(_mm256_add_epi16(filt, _mm256_set1_epi16(3)), min, max), 3);
+
+    oq0 = _mm256_add_epi16(clamp16(_mm256_sub_epi16(qs0, filter1), min, max),
+                           offset);
+    op0 = _mm256_add_epi16(clamp16(_mm256_add_epi16(ps0, filter2), min, max),
+                           offset);
+
+    // (filter1 + 1) >> 1 & ~hev
+    filt = _mm256_srai_epi16(_mm256_add_epi16(filter1, one), 1);
+    filt = _mm256_andnot_si256(hev, filt);
+
+    oq1 = _mm256_add_epi16(clamp16(_mm256_sub_epi16(qs1, filt), min, max),
+                           offset);
+    op1 = _mm256_add_epi16(clamp16(_mm256_add_epi16(ps1, filt), min, max),
+                           offset);
+  }
+
+  if (taps >= 8) {
+    work = _mm256_max_epi16(abs_p1p0, abs_q1q0);
+    work = _mm256_max_epi16(
+        work, _mm256_max_epi16(abs_diff16(p[2], p[0]), abs_diff16(q[2], q[0])));
+    work = _mm256_max_epi16(
+        work, _mm256_max_epi16(abs_diff16(p[3], p[0]), abs_diff16(q[3], q[0])));
+    flat = _mm256_andnot_si256(_mm256_cmpgt_epi16(work, flat_thresh), mask);
+
+    if (!_mm256_testz_si256(flat, flat)) {
+      const __m256i four = _mm256_set1_epi16(4);
+      __m256i op2, oq2, sum;
+
+      // 7-tap filter [1, 1, 1, 2, 1, 1, 1], updated as a running sum.
+      sum = _mm256_add_epi16(_mm256_add_epi16(p[3], p[3]), p[3]);
+      sum = _mm256_add_epi16(sum, _mm256_add_epi16(p[2], p[2]));
+      sum = _mm256_add_epi16(sum, _mm256_add_epi16(p[1], p[0]));
+      sum = _mm256_add_epi16(sum, _mm256_add_epi16(q[0], four));
+      op2 = _mm256_blendv_epi8(p[2], _mm256_srli_epi16(sum, 3), flat);
+      sum = _mm256_sub_epi16(sum, _mm256_add_epi16(p[3], p[2]));
+      sum = _mm256_add_epi16(sum, _mm256_add_epi16(p[1], q[1]));
+      op1 = _mm256_blendv_epi8(op1, _mm256_srli_epi16(sum, 3), flat);
+      sum = _mm256_sub_epi16(sum, _mm256_add_epi16(p[3], p[1]));
+      sum = _mm256_add_epi16(sum, _mm256_add_epi16(p[0], q[2]));
+      op0 = _mm256_blendv_epi8(op0, _mm256_srli_epi16(sum, 3), flat);
+      sum = _mm256_sub_epi16(sum, _mm256_add_epi16(p[3], p[0]));
+      sum = _mm256_add_epi16(sum, _mm256_add_epi16(q[0], q[3]));
+      oq0 = _mm256_blendv_epi8(oq0, _mm256_srli_epi16(sum, 3), flat);
+      sum = _mm256_sub_epi16(sum, _mm256_add_epi16(p[2], q[0]));
+      sum = _mm256_add_epi16(sum, _mm256_add_epi16(q[1], q[3]));
+      oq1 = _mm256_blendv_epi8(oq1, _mm256_srli_epi16(sum, 3), flat);
+      sum = _mm256_sub_epi16(sum, _mm256_add_epi16(p[1], q[1]));
+      sum = _mm256_add_epi16(sum, _mm256_add_epi16(q[2], q[3]));
+      oq2 = _mm256_blendv_epi8(q[2], _mm256_srli_epi16(sum, 3), flat);
+
+      if (taps == 16) {
+        __m256i flat2;
+        int i;
+
+        work = _mm256_setzero_si256();
+        for (i = 4; i < 8; ++i) {
+          work = _mm256_max_epi16(
+              work,
+              _mm256_max_epi16(abs_diff16(p[i], p[0]), abs_diff16(q[i], q[0])));
+        }
+        flat2 =
+            _mm256_andnot_si256(_mm256_cmpgt_epi16(work, flat_thresh), flat);
+
+        if (!_mm256_testz_si256(flat2, flat2)) {
+          // 15-tap filter [1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1],
+          // updated as a running sum. The sums fit in 16 bits for 12-bit
+          // input.
+          __m256i out_p[7], out_q[7];
+
+          sum = _mm256_sub_epi16(_mm256_slli_epi16(p[7], 3), p[7]);
+          sum = _mm256_add_epi16(sum, _mm256_slli_epi16(p[6], 1));
+          for (i = 0; i < 6; ++i) sum = _mm256_add_epi16(sum, p[i]);
+          sum = _mm256_add_epi16(
+              sum, _mm256_add_epi16(q[0], _mm256_set1_epi16(8)));
+          out_p[6] = _mm256_srli_epi16(sum, 4);
+          for (i = 5; i >= 0; --i) {
+            sum = _mm256_sub_epi16(sum, _mm256_add_epi16(p[7], p[i + 1]));
+            sum = _mm256_add_epi16(sum, _mm256_add_epi16(p[i], q[6 - i]));
+            out_p[i] = _mm256_srli_epi16(sum, 4);
+          }
+          sum = _mm256_sub_epi16(sum, _mm256_add_epi16(p[7], p[0]));
+          sum = _mm256_add_epi16(sum, _mm256_add_epi16(q[0], q[7]));
+          out_q[0] = _mm256_srli_epi16(sum, 4);
+          for (i = 1; i < 7; ++i) {
+            sum = _mm256_sub_epi16(sum, _mm256_add_epi16(p[7 - i], q[i - 1]));
+            sum = _mm256_add_epi16(sum, _mm256_add_epi16(q[i], q[7]));
+            out_q[i] = _mm256_srli_epi16(sum, 4);
+          }
+
+          for (i = 3; i < 7; ++i) {
+            p[i] = _mm256_blendv_epi8(p[i], out_p[i], flat2);
+            q[i] = _mm256_blendv_epi8(q[i], out_q[i], flat2);
+          }
+          op2 = _mm256_blendv_epi8(op2, out_p[2], flat2);
+          op1 = _mm256_blendv_epi8(op1, out_p[1], flat2);
+          op0 = _mm256_blendv_epi8(op0, out_p[0], flat2);
+          oq0 = _mm256_blendv_epi8(oq0, out_q[0], flat2);
+          oq1 = _mm256_blendv_epi8(oq1, out_q[1], flat2);
+          oq2 = _mm256_blendv_epi8(oq2, out_q[2], flat2);
+        }
+      }
+
+      p[2] = op2;
+      q[2] = oq2;
+    }
+  }
+
+  p[1] = op1;
+  p[0] = op0;
+  q[0] = oq0;
+  q[1] = oq1;
+}
+
+static INLINE __m256i load_pixels(const uint16_t *s, int dual) {
+  if (dual) return _mm256_loadu_si256((const __m256i *)s);
+  return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)s));
+}
+
+static INLINE void store_pixels(uint16_t *s, __m256i v, int dual) {
+  if (dual) {
+    _mm256_storeu_si256((__m256i *)s, v);
+  } else {
+    _mm_storeu_si128((__m128i *)s, _mm256_castsi256_si128(v));
+  }
+}
+
+static INLINE void highbd_lpf_horizontal_avx2(uint16_t *s, int pitch,
+                                              const __m256i blimit,
+                                              const __m256i limit,
+                                              const __m256i thresh, int bd,
+                                              int taps, int dual) {
+  const int n = taps == 16 ? 8 : 4;
+  const int n_out = taps == 16 ? 7 : taps == 8 ? 3 : 2;
+  __m256i p[8], q[8];
+  int i;
+
+  for (i = 0; i < n; ++i) {
+    p[i] = load_pixels(s - (i + 1) * pitch, dual);
+    q[i] = load_pixels(s + i * pitch, dual);
+  }
+
+  highbd_filter_avx2(p, q, blimit, limit, thresh, bd, taps);
+
+  for (i = 0; i < n_out; ++i) {
+    store_pixels(s - (i + 1) * pitch, p[i], dual);
+    store_pixels(s + i * pitch, q[i], dual);
+  }
+}
+
+// Transposes the 8x8 blocks in each lane of in[0] to in[7].
+static INLINE void highbd_transpose_8x8x2(const __m256i *in, __m256i *out) {
+  const __m256i a0 = _mm256_unpacklo_epi16(in[0], in[1]);
+  const __m256i a1 = _mm256_unpacklo_epi16(in[2], in[3]);
+  const __m256i a2 = _mm256_unpacklo_epi16(in[4], in[5]);
+  const __m256i a3 = _mm256_unpacklo_epi16(in[6], in[7]);
+  const __m256i a4 = _mm256_unpackhi_epi16(in[0], in[1]);
+  const __m256i a5 = _mm256_unpackhi_epi16(in[2], in[3]);
+  const __m256i a6 = _mm256_unpackhi_epi16(in[4], in[5]);
+  const __m256i a7 = _mm256_unpackhi_epi16(in[6], in[7]);
+
+  const __m256i b0 = _mm256_unpacklo_epi32(a0, a1);
+  const __m256i b1 = _mm256_unpacklo_epi32(a2, a3);
+  const __m256i b2 = _mm256_unpackhi_epi32(a0, a1);
+  const __m256i b3 = _mm256_unpackhi_epi32(a2, a3);
+  const __m256i b4 = _mm256_unpacklo_epi32(a4, a5);
+  const __m256i b5 = _mm256_unpacklo_epi32(a6, a7);
+  const __m256i b6 = _mm256_unpackhi_epi32(a4, a5);
+  const __m256i b7 = _mm256_unpackhi_epi32(a6, a7);
+
+  out[0] = _mm256_unpacklo_epi64(b0, b1);
+  out[1] = _mm256_unpackhi_epi64(b0, b1);
+  out[2] = _mm256_unpacklo_epi64(b2, b3);
+  out[3] = _mm256_unpackhi_epi64(b2, b3);
+  out[4] = _mm256_unpacklo_epi64(b4, b5);
+  out[5] = _mm256_unpackhi_epi64(b4, b5);
+  out[6] = _mm256_unpacklo_epi64(b6, b7);
+  out[7] = _mm256_unpackhi_epi64(b6, b7);
+}
+
+// Filters a vertical edge with the 4 or 8 tap filter. The first 8 rows are
+// in the low lanes and the next 8 rows, for the dual version, in the high
+// lanes.
+static INLINE void highbd_lpf_vertical_avx2(uint16_t *s, int pitch,
+                                            const __m256i blimit,
+                                            const __m256i limit,
+                                            const __m256i thresh, int bd,
+                                            int taps, int dual) {
+  __m256i x[8], c[8], p[4], q[4];
+  int i;
+
+  for (i = 0; i < 8; ++i) {
+    const __m128i lo = _mm_loadu_si128((const __m128i *)(s - 4 + i * pitch));
+    x[i] = dual ? _mm256_inserti128_si256(
+                      _mm256_castsi128_si256(lo),
+                      _mm_loadu_si128(
+                          (const __m128i *)(s - 4 + (i + 8) * pitch)),
+                      1)
+                : _mm256_broadcastsi128_si256(lo);
+  }
+  highbd_transpose_8x8x2(x, c);
+  for (i = 0; i < 4; ++i) {
+    p[i] = c[3 - i];
+    q[i] = c[4 + i];
+  }
+
+  highbd_filter_avx2(p, q, blimit, limit, thresh, bd, taps);
+
+  for (i = 0; i < 4; ++i) {
+    c[3 - i] = p[i];
+    c[4 + i] = q[i];
+  }
+  highbd_transpose_8x8x2(c, x);
+  for (i = 0; i < 8; ++i) {
+    _mm_storeu_si128((__m128i *)(s - 4 + i * pitch),
+                     _mm256_castsi256_si128(x[i]));
+    if (dual) {
+      _mm_storeu_si128((__m128i *)(s - 4 + (i + 8) * pitch),
+                       _mm256_extracti128_si256(x[i], 1));
+    }
+  }
+}
+
+// Transposes the 8 rows of 16 pixels at 'src' to 16 rows of 8 pixels.
+static INLINE void highbd_transpose_8x16(const uint16_t *src, int in_p,
+                                         uint16_t *dst, int out_p) {
+  __m256i x[8], y[8];
+  int i;
+
+  for (i = 0; i < 8; ++i) {
+    x[i] = _mm256_loadu_si256((const __m256i *)(src + i * in_p));
+  }
+  highbd_transpose_8x8x2(x, y);
+  for (i = 0; i < 8; ++i) {
+    _mm_storeu_si128((__m128i *)(dst + i * out_p),
+                     _mm256_castsi256_si128(y[i]));
+    _mm_storeu_si128((__m128i *)(dst + (i + 8) * out_p),
+                     _mm256_extracti128_si256(y[i], 1));
+  }
+}
+
+// Transposes the 16 rows of 8 pixels at 'src' to 8 rows of 16 pixels.
+static INLINE void highbd_transpose_16x8(const uint16_t *src, int in_p,
+                                         uint16_t *dst, int out_p) {
+  __m256i x[8], y[8];
+  int i;
+
+  for (i = 0; i < 8; ++i) {
+    x[i] = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(
+            _mm_loadu_si128((const __m128i *)(src + i * in_p))),
+        _mm_loadu_si128((const __m128i *)(src + (i + 8) * in_p)), 1);
+  }
+  highbd_transpose_8x8x2(x, y);
+  for (i = 0; i < 8; ++i) {
+    _mm256_storeu_si256((__m256i *)(dst + i * out_p), y[i]);
+  }
+}
+
+void vpx_highbd_lpf_horizontal_16_avx2(uint16_t *s, int pitch,
+                                       const uint8_t *blimit,
+                                       const uint8_t *limit,
+                                       const uint8_t *thresh, int bd) {
+  highbd_lpf_horizontal_avx2(s, pitch, load_limit(blimit, blimit, bd),
+                             load_limit(limit, limit, bd),
+                             load_limit(thresh, thresh, bd), bd, 16, 0);
+}
+
+void vpx_highbd_lpf_horizontal_16_dual_avx2(uint16_t *s, int pitch,
+                                            const uint8_t *blimit,
+                                            const uint8_t *limit,
+                                            const uint8_t *thresh, int bd) {
+  highbd_lpf_horizontal_avx2(s, pitch, load_limit(blimit, blimit, bd),
+                             load_limit(limit, limit, bd),
+                             load_limit(thresh, thresh, bd), bd, 16, 1);
+}
+
+void vpx_highbd_lpf_horizontal_8_avx2(uint16_t *s, int pitch,
+                                      const uint8_t *blimit,
+                                      const uint8_t *limit,
+                                      const uint8_t *thresh, int bd) {
+  highbd_lpf_horizontal_avx2(s, pitch, load_limit(blimit, blimit, bd),
+                             load_limit(limit, limit, bd),
+                             load_limit(thresh, thresh, bd), bd, 8, 0);
+}
+
+void vpx_highbd_lpf_horizontal_8_dual_avx2(
+    uint16_t *s, int pitch, const uint8_t *blimit0, const uint8_t *limit0,
+    const uint8_t *thresh0, const uint8_t *blimit1, const uint8_t *limit1,
+    const uint8_t *thresh1, int bd) {
+  highbd_lpf_horizontal_avx2(s, pitch, load_limit(blimit0, blimit1, bd),
+                             load_limit(limit0, limit1, bd),
+                             load_limit(thresh0, thresh1, bd), bd, 8, 1);
+}
+
+void vpx_highbd_lpf_horizontal_4_avx2(uint16_t *s, int pitch,
+                                      const uint8_t *blimit,
+                                      const uint8_t *limit,
+                                      const uint8_t *thresh, int bd) {
+  highbd_lpf_horizontal_avx2(s, pitch, load_limit(blimit, blimit, bd),
+                             load_limit(limit, limit, bd),
+                             load_limit(thresh, thresh, bd), bd, 4, 0);
+}
+
+void vpx_highbd_lpf_horizontal_4_dual_avx2(
+    uint16_t *s, int pitch, const uint8_t *blimit0, const uint8_t *limit0,
+    const uint8_t *thresh0, const uint8_t *blimit1, const uint8_t *limit1,
+    const uint8_t *thresh1, int bd) {
+  highbd_lpf_horizontal_avx2(s, pitch, load_limit(blimit0, blimit1, bd),
+                             load_limit(limit0, limit1, bd),
+                             load_limit(thresh0, thresh1, bd), bd, 4, 1);
+}
+
+void vpx_highbd_lpf_vertical_4_avx2(uint16_t *s, int pitch,
+                                    const uint8_t *blimit, const uint8_t *limit,
+                                    const uint8_t *thresh, int bd) {
+  highbd_lpf_vertical_avx2(s, pitch, load_limit(blimit, blimit, bd),
+                           load_limit(limit, limit, bd),
+                           load_limit(thresh, thresh, bd), bd, 4, 0);
+}
+
+void vpx_highbd_lpf_vertical_4_dual_avx2(
+    uint16_t *s, int pitch, const uint8_t *blimit0, const uint8_t *limit0,
+    const uint8_t *thresh0, const uint8_t *blimit1, const uint8_t *limit1,
+    const uint8_t *thresh1, int bd) {
+  highbd_lpf_vertical_avx2(s, pitch, load_limit(blimit0, blimit1, bd),
+                           load_limit(limit0, limit1, bd),
+                           load_limit(thresh0, thresh1, bd), bd, 4, 1);
+}
+
+void vpx_highbd_lpf_vertical_8_avx2(uint16_t *s, int pitch,
+                                    const uint8_t *blimit, const uint8_t *limit,
+                                    const uint8_t *thresh, int bd) {
+  highbd_lpf_vertical_avx2(s, pitch, load_limit(blimit, blimit, bd),
+                           load_limit(limit, limit, bd),
+                           load_limit(thresh, thresh, bd), bd, 8, 0);
+}
+
+void vpx_highbd_lpf_vertical_8_dual_avx2(
+    uint16_t *s, int pitch, const uint8_t *blimit0, const uint8_t *limit0,
+    const uint8_t *thresh0, const uint8_t *blimit1, const uint8_t *limit1,
+    const uint8_t *thresh1, int bd) {
+  highbd_lpf_vertical_avx2(s, pitch, load_limit(blimit0, blimit1, bd),
+                           load_limit(limit0, limit1, bd),
+                           load_limit(thresh0, thresh1, bd), bd, 8, 1);
+}
+
+void vpx_highbd_lpf_vertical_16_avx2(uint16_t *s, int pitch,
+                                     const uint8_t *blimit,
+                                     const uint8_t *limit,
+                                     const uint8_t *thresh, int bd) {
+  DECLARE_ALIGNED(32, uint16_t, t_dst[16 * 8]);
+
+  // Transpose 16x8
+  highbd_transpose_8x16(s - 8, pitch, t_dst, 8);
+
+  // Loop filtering
+  vpx_highbd_lpf_horizontal_16_avx2(t_dst + 8 * 8, 8, blimit, limit, thresh,
+                                    bd);
+
+  // Transpose back
+  highbd_transpose_16x8(t_dst, 8, s - 8, pitch);
+}
+
+void vpx_highbd_lpf_vertical_16_dual_avx2(uint16_t *s, int pitch,
+                                          const uint8_t *blimit,
+                                          const uint8_t *limit,
+                                          const uint8_t *thresh, int bd) {
+  DECLARE_ALIGNED(32, uint16_t, t_dst[256]);
+
+  // Transpose 16x16
+  highbd_transpose_8x16(s - 8, pitch, t_dst, 16);
+  highbd_transpose_8x16(s - 8 + 8 * pitch, pitch, t_dst + 8, 16);
+
+  // Loop filtering
+  vpx_highbd_lpf_horizontal_16_dual_avx2(t_dst + 8 * 16, 16, blimit, limit,
+                                         thresh, bd);
+
+  // Transpose back
+  highbd_transpose_16x8(t_dst, 16, s - 8, pitch);
+  highbd_transpose_16x8(t_dst + 8, 16, s - 8 + 8 * pitch, pitch);
+}
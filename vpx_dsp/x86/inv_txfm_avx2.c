@@ -9,55 +9,12 @@
  */
 
 #include <immintrin.h>  // AVX2
+#include <stdlib.h>
 
 #include "./vpx_dsp_rtcd.h"
 #include "vpx_dsp/txfm_common.h"
-
-#define PAIR256_SET_EPI16(a, b)                                            \
-  _mm256_set_epi16((int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
-                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
-                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
-                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a))
-
-static INLINE void idct_load16x16(const tran_low_t *input, __m256i *in,
-                                  int stride) {
-  int i;
-  // Load 16x16 values
-  for (i = 0; i < 16; i++) {
-#if CONFIG_VP9_HIGHBITDEPTH
-    const __m128i in0 = _mm_loadu_si128((const __m128i *)(input + i * stride));
-    const __m128i in1 =
-        _mm_loadu_si128((const __m128i *)((input + i * stride) + 4));
-    const __m128i in2 =
-        _mm_loadu_si128((const __m128i *)((input + i * stride) + 8));
-    const __m128i in3 =
-        _mm_loadu_si128((const __m128i *)((input + i * stride) + 12));
-    const __m128i ls = _mm_packs_epi32(in0, in1);
-    const __m128i rs = _mm_packs_epi32(in2, in3);
-    in[i] = _mm256_inserti128_si256(_mm256_castsi128_si256(ls), rs, 1);
-#else
-    in[i] = _mm256_load_si256((const __m256i *)(input + i * stride));
-#endif
-  }
-}
-
-static INLINE __m256i dct_round_shift_avx2(__m256i in) {
-  const __m256i t = _mm256_add_epi32(in, _mm256_set1_epi32(DCT_CONST_ROUNDING));
-  return _mm256_srai_epi32(t, DCT_CONST_BITS);
-}
-
-static INLINE __m256i idct_madd_round_shift_avx2(__m256i *in, __m256i *cospi) {
-  const __m256i t = _mm256_madd_epi16(*in, *cospi);
-  return dct_round_shift_avx2(t);
-}
-
-// Calculate the dot product between in0/1 and x and wrap to short.
-static INLINE __m256i idct_calc_wraplow_avx2(__m256i *in0, __m256i *in1,
-                                             __m256i *x) {
-  const __m256i t0 = idct_madd_round_shift_avx2(in0, x);
-  const __m256i t1 = idct_madd_round_shift_avx2(in1, x);
-  return _mm256_packs_epi32(t0, t1);
-}
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_dsp/x86/inv_txfm_avx2.h"
 
 // Multiply elements by constants and add them together.
 static INLINE void butterfly16(__m256i in0, __m256i in1, int c0, int c1,
@@ -70,18 +27,19 @@ static INLINE void butterfly16(__m256i in0, __m256i in1, int c0, int c1,
   *out1 = idct_calc_wraplow_avx2(&lo, &hi, &cst1);
 }
 
-static INLINE void idct16_16col(__m256i *in, __m256i *out) {
-  __m256i step1[16], step2[16];
-
-  // stage 2
-  butterfly16(in[1], in[15], cospi_30_64, cospi_2_64, &step2[8], &step2[15]);
-  butterfly16(in[9], in[7], cospi_14_64, cospi_18_64, &step2[9], &step2[14]);
-  butterfly16(in[5], in[11], cospi_22_64, cospi_10_64, &step2[10], &step2[13]);
-  butterfly16(in[13], in[3], cospi_6_64, cospi_26_64, &step2[11], &step2[12]);
+// Same as butterfly16() with a zero second input: out0 = in * c0 and
+// out1 = in * c1, rounded.
+static INLINE void multiply16(__m256i in, int c0, int c1, __m256i *out0,
+                              __m256i *out1) {
+  *out0 = _mm256_mulhrs_epi16(in, _mm256_set1_epi16(2 * c0));
+  *out1 = _mm256_mulhrs_epi16(in, _mm256_set1_epi16(2 * c1));
+}
 
+// The butterflies of stages 3 to 7 that do not use the input. Takes step2[0-3]
+// and step2[8-15] and step1[4-7].
+static INLINE void idct16_16col_stage_3_to_7(__m256i *step1, __m256i *step2,
+                                             __m256i *out) {
   // stage 3
-  butterfly16(in[2], in[14], cospi_28_64, cospi_4_64, &step1[4], &step1[7]);
-  butterfly16(in[10], in[6], cospi_12_64, cospi_20_64, &step1[5], &step1[6]);
   step1[8] = _mm256_add_epi16(step2[8], step2[9]);
   step1[9] = _mm256_sub_epi16(step2[8], step2[9]);
   step1[10] = _mm256_sub_epi16(step2[11], step2[10]);
@@ -92,8 +50,6 @@ static INLINE void idct16_16col(__m256i *in, __m256i *out) {
   step1[15] = _mm256_add_epi16(step2[14], step2[15]);
 
   // stage 4
-  butterfly16(in[0], in[8], cospi_16_64, cospi_16_64, &step2[1], &step2[0]);
-  butterfly16(in[4], in[12], cospi_24_64, cospi_8_64, &step2[2], &step2[3]);
   butterfly16(step1[14], step1[9], cospi_24_64, cospi_8_64, &step2[9],
               &step2[14]);
   butterfly16(step1[10], step1[13], -cospi_8_64, -cospi_24_64, &step2[13],
@@ -156,24 +112,46 @@ static INLINE void idct16_16col(__m256i *in, __m256i *out) {
   out[15] = _mm256_sub_epi16(step2[0], step1[15]);
 }
 
-static INLINE void recon_and_store16(uint8_t *dest, __m256i in_x) {
-  const __m256i zero = _mm256_setzero_si256();
-  __m256i d0 = _mm256_castsi128_si256(_mm_loadu_si128((__m128i *)(dest)));
-  d0 = _mm256_permute4x64_epi64(d0, 0xd8);
-  d0 = _mm256_unpacklo_epi8(d0, zero);
-  d0 = _mm256_add_epi16(in_x, d0);
-  d0 = _mm256_packus_epi16(
-      d0, _mm256_castsi128_si256(_mm256_extractf128_si256(d0, 1)));
+static INLINE void idct16_16col(__m256i *in, __m256i *out) {
+  __m256i step1[16], step2[16];
 
-  _mm_storeu_si128((__m128i *)dest, _mm256_castsi256_si128(d0));
+  // stage 2
+  butterfly16(in[1], in[15], cospi_30_64, cospi_2_64, &step2[8], &step2[15]);
+  butterfly16(in[9], in[7], cospi_14_64, cospi_18_64, &step2[9], &step2[14]);
+  butterfly16(in[5], in[11], cospi_22_64, cospi_10_64, &step2[10], &step2[13]);
+  butterfly16(in[13], in[3], cospi_6_64, cospi_26_64, &step2[11], &step2[12]);
+
+  // stage 3
+  butterfly16(in[2], in[14], cospi_28_64, cospi_4_64, &step1[4], &step1[7]);
+  butterfly16(in[10], in[6], cospi_12_64, cospi_20_64, &step1[5], &step1[6]);
+
+  // stage 4
+  butterfly16(in[0], in[8], cospi_16_64, cospi_16_64, &step2[1], &step2[0]);
+  butterfly16(in[4], in[12], cospi_24_64, cospi_8_64, &step2[2], &step2[3]);
+
+  idct16_16col_stage_3_to_7(step1, step2, out);
 }
 
-static INLINE void write_buffer_16x1(uint8_t *dest, __m256i in) {
-  const __m256i final_rounding = _mm256_set1_epi16(1 << 5);
-  __m256i out;
-  out = _mm256_adds_epi16(in, final_rounding);
-  out = _mm256_srai_epi16(out, 6);
-  recon_and_store16(dest, out);
+// Only in[0-7] are non-zero, the butterflies with a single input are
+// multiplications.
+static INLINE void idct16_16col_8(__m256i *in, __m256i *out) {
+  __m256i step1[16], step2[16];
+
+  // stage 2
+  multiply16(in[1], cospi_30_64, cospi_2_64, &step2[8], &step2[15]);
+  multiply16(in[7], -cospi_18_64, cospi_14_64, &step2[9], &step2[14]);
+  multiply16(in[5], cospi_22_64, cospi_10_64, &step2[10], &step2[13]);
+  multiply16(in[3], -cospi_26_64, cospi_6_64, &step2[11], &step2[12]);
+
+  // stage 3
+  multiply16(in[2], cospi_28_64, cospi_4_64, &step1[4], &step1[7]);
+  multiply16(in[6], -cospi_20_64, cospi_12_64, &step1[5], &step1[6]);
+
+  // stage 4
+  multiply16(in[0], cospi_16_64, cospi_16_64, &step2[1], &step2[0]);
+  multiply16(in[4], cospi_24_64, cospi_8_64, &step2[2], &step2[3]);
+
+  idct16_16col_stage_3_to_7(step1, step2, out);
 }
 
 static INLINE void store_buffer_16x32(__m256i *in, uint8_t *dst, int stride) {
@@ -550,6 +528,106 @@ static INLINE void idct32_1024_16x32_quarter_3_4(__m256i *in, __m256i *out) {
   idct32_16x32_quarter_3_4_stage_4_to_7(step1, out);
 }
 
+// For each 16x32 block __m256i in[32],
+// Input with index, 0, 4
+// output pixels: 0-7 in __m256i out[32]
+static INLINE void idct32_34_16x32_quarter_1(__m256i *in, __m256i *out) {
+  __m256i step1[8], step2[8];
+
+  // stage 3
+  multiply16(in[4], cospi_28_64, cospi_4_64, &step1[4], &step1[7]);
+
+  // stage 4
+  step2[0] = _mm256_mulhrs_epi16(in[0], _mm256_set1_epi16(2 * cospi_16_64));
+  step2[4] = step1[4];
+  step2[5] = step1[4];
+  step2[6] = step1[7];
+  step2[7] = step1[7];
+
+  // stage 5
+  step1[0] = step2[0];
+  step1[1] = step2[0];
+  step1[2] = step2[0];
+  step1[3] = step2[0];
+  step1[4] = step2[4];
+  butterfly16(step2[6], step2[5], cospi_16_64, cospi_16_64, &step1[5],
+              &step1[6]);
+  step1[7] = step2[7];
+
+  // stage 6
+  out[0] = _mm256_add_epi16(step1[0], step1[7]);
+  out[1] = _mm256_add_epi16(step1[1], step1[6]);
+  out[2] = _mm256_add_epi16(step1[2], step1[5]);
+  out[3] = _mm256_add_epi16(step1[3], step1[4]);
+  out[4] = _mm256_sub_epi16(step1[3], step1[4]);
+  out[5] = _mm256_sub_epi16(step1[2], step1[5]);
+  out[6] = _mm256_sub_epi16(step1[1], step1[6]);
+  out[7] = _mm256_sub_epi16(step1[0], step1[7]);
+}
+
+// For each 16x32 block __m256i in[32],
+// Input with index, 2, 6
+// output pixels: 8-15 in __m256i out[32]
+static INLINE void idct32_34_16x32_quarter_2(__m256i *in, __m256i *out) {
+  __m256i step1[16], step2[16];
+
+  // stage 2
+  multiply16(in[2], cospi_30_64, cospi_2_64, &step2[8], &step2[15]);
+  multiply16(in[6], -cospi_26_64, cospi_6_64, &step2[11], &step2[12]);
+
+  // stage 3
+  step1[8] = step2[8];
+  step1[9] = step2[8];
+  step1[14] = step2[15];
+  step1[15] = step2[15];
+  step1[10] = step2[11];
+  step1[11] = step2[11];
+  step1[12] = step2[12];
+  step1[13] = step2[12];
+
+  idct32_16x32_quarter_2_stage_4_to_6(step1, out);
+}
+
+// For each 16x32 block __m256i in[32],
+// Input with odd index, 1, 3, 5, 7
+// output pixels: 16-23, 24-31 in __m256i out[32]
+static INLINE void idct32_34_16x32_quarter_3_4(__m256i *in, __m256i *out) {
+  __m256i step1[32];
+
+  // stage 1
+  multiply16(in[1], cospi_31_64, cospi_1_64, &step1[16], &step1[31]);
+  multiply16(in[7], -cospi_25_64, cospi_7_64, &step1[19], &step1[28]);
+  multiply16(in[5], cospi_27_64, cospi_5_64, &step1[20], &step1[27]);
+  multiply16(in[3], -cospi_29_64, cospi_3_64, &step1[23], &step1[24]);
+
+  // stage 3
+  butterfly16(step1[31], step1[16], cospi_28_64, cospi_4_64, &step1[17],
+              &step1[30]);
+  butterfly16(step1[28], step1[19], -cospi_4_64, cospi_28_64, &step1[18],
+              &step1[29]);
+  butterfly16(step1[27], step1[20], cospi_12_64, cospi_20_64, &step1[21],
+              &step1[26]);
+  butterfly16(step1[24], step1[23], -cospi_20_64, cospi_12_64, &step1[22],
+              &step1[25]);
+
+  idct32_16x32_quarter_3_4_stage_4_to_7(step1, out);
+}
+
+// Only in[0-7] are non-zero.
+static INLINE void idct32_34_16x32(__m256i *in, __m256i *out) {
+  __m256i temp[32], t[16];
+
+  idct32_34_16x32_quarter_1(in, t);
+  idct32_34_16x32_quarter_2(in, t);
+  // stage 7
+  add_sub_butterfly_avx2(t, temp, 16);
+
+  idct32_34_16x32_quarter_3_4(in, temp);
+
+  // final stage
+  add_sub_butterfly_avx2(temp, out, 32);
+}
+
 static INLINE void idct32_1024_16x32(__m256i *in, __m256i *out) {
   __m256i temp[32];
 
@@ -624,3 +702,527 @@ void vpx_idct32x32_135_add_avx2(const tran_low_t *input, uint8_t *dest,
     dest += 16;
   }
 }
+
+// Only upper-left 8x8 has non-zero coeff
+void vpx_idct32x32_34_add_avx2(const tran_low_t *input, uint8_t *dest,
+                               int stride) {
+  __m256i in[32], io[32], out[32];
+  int i;
+
+  for (i = 8; i < 32; i++) {
+    in[i] = _mm256_setzero_si256();
+  }
+
+  // rows
+  idct_load16xn(input, in, 32, 8);
+  transpose_16bit_16x16_avx2(in, in);
+  idct32_34_16x32(in, io);
+
+  // columns
+  for (i = 0; i < 32; i += 16) {
+    transpose_16bit_16x16_avx2(io + i, in);
+    idct32_34_16x32(in, out);
+
+    store_buffer_16x32(out, dest, stride);
+    dest += 16;
+  }
+}
+
+static INLINE int dc_only_value(const tran_low_t *input, int shift) {
+  const int16_t out0 =
+      WRAPLOW(dct_const_round_shift((int16_t)input[0] * cospi_16_64));
+  const int16_t out1 = WRAPLOW(dct_const_round_shift(out0 * cospi_16_64));
+  return ROUND_POWER_OF_TWO(out1, shift);
+}
+
+// Adds the dc value to 'rows' rows of 32 bytes, or of 16 bytes when 'half' is
+// set, with saturating byte arithmetic.
+static INLINE void dc_only_add(const tran_low_t *input, uint8_t *dest,
+                               int stride, int rows, int half) {
+  const int a1 = dc_only_value(input, 6);
+  const __m256i dc = _mm256_set1_epi8((char)VPXMIN(abs(a1), 255));
+  int i;
+
+  for (i = 0; i < rows; ++i) {
+    __m256i d;
+    if (half) {
+      d = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)dest));
+    } else {
+      d = _mm256_loadu_si256((const __m256i *)dest);
+    }
+    d = (a1 >= 0) ? _mm256_adds_epu8(d, dc) : _mm256_subs_epu8(d, dc);
+    if (half) {
+      _mm_storeu_si128((__m128i *)dest, _mm256_castsi256_si128(d));
+    } else {
+      _mm256_storeu_si256((__m256i *)dest, d);
+    }
+    dest += stride;
+  }
+}
+
+void vpx_idct32x32_1_add_avx2(const tran_low_t *input, uint8_t *dest,
+                              int stride) {
+  dc_only_add(input, dest, stride, 32, 0);
+}
+
+void vpx_idct16x16_1_add_avx2(const tran_low_t *input, uint8_t *dest,
+                              int stride) {
+  dc_only_add(input, dest, stride, 16, 1);
+}
+
+void vpx_idct8x8_1_add_avx2(const tran_low_t *input, uint8_t *dest,
+                            int stride) {
+  const __m256i dc_value = _mm256_set1_epi16(dc_only_value(input, 5));
+  int i;
+
+  for (i = 0; i < 4; ++i) {
+    recon_and_store8x2(dest + i * stride, dest + (i + 4) * stride, dc_value);
+  }
+}
+
+// Only the upper-left 8x8 (or 4x4 when 'rows' is 4) has non-zero coeff.
+static INLINE void idct16x16_partial_add(const tran_low_t *input,
+                                         uint8_t *dest, int stride, int rows) {
+  int i;
+  __m256i in[16];
+
+  for (i = rows; i < 16; i++) {
+    in[i] = _mm256_setzero_si256();
+  }
+  idct_load16xn(input, in, 16, rows);
+
+  transpose_16bit_16x16_avx2(in, in);
+  idct16_16col_8(in, in);
+
+  transpose_16bit_16x16_avx2(in, in);
+  idct16_16col_8(in, in);
+
+  for (i = 0; i < 16; ++i) {
+    write_buffer_16x1(dest + i * stride, in[i]);
+  }
+}
+
+void vpx_idct16x16_38_add_avx2(const tran_low_t *input, uint8_t *dest,
+                               int stride) {
+  idct16x16_partial_add(input, dest, stride, 8);
+}
+
+void vpx_idct16x16_10_add_avx2(const tran_low_t *input, uint8_t *dest,
+                               int stride) {
+  idct16x16_partial_add(input, dest, stride, 4);
+}
+
+void idct16_avx2(__m256i *const in) {
+  transpose_16bit_16x16_avx2(in, in);
+  idct16_16col(in, in);
+}
+
+// Returns the rounded and packed a * ca + b * cb and a * ca - b * cb, where 'a'
+// and 'b' are the low and high halves of interleaved 16-bit pairs.
+static INLINE void iadst_butterfly16(const __m256i *a, const __m256i *b,
+                                     __m256i ca, __m256i cb, __m256i *sum,
+                                     __m256i *diff) {
+  const __m256i a0 = _mm256_madd_epi16(a[0], ca);
+  const __m256i a1 = _mm256_madd_epi16(a[1], ca);
+  const __m256i b0 = _mm256_madd_epi16(b[0], cb);
+  const __m256i b1 = _mm256_madd_epi16(b[1], cb);
+  *sum = _mm256_packs_epi32(dct_round_shift_avx2(_mm256_add_epi32(a0, b0)),
+                            dct_round_shift_avx2(_mm256_add_epi32(a1, b1)));
+  *diff = _mm256_packs_epi32(dct_round_shift_avx2(_mm256_sub_epi32(a0, b0)),
+                             dct_round_shift_avx2(_mm256_sub_epi32(a1, b1)));
+}
+
+static INLINE void unpack16(__m256i in0, __m256i in1, __m256i *out) {
+  out[0] = _mm256_unpacklo_epi16(in0, in1);
+  out[1] = _mm256_unpackhi_epi16(in0, in1);
+}
+
+static INLINE void iadst16_16col(__m256i *const in) {
+  // perform 16x16 1-D ADST for 16 columns
+  const __m256i k__cospi_p04_p28 = PAIR256_SET_EPI16(cospi_4_64, cospi_28_64);
+  const __m256i k__cospi_p28_m04 = PAIR256_SET_EPI16(cospi_28_64, -cospi_4_64);
+  const __m256i k__cospi_p20_p12 = PAIR256_SET_EPI16(cospi_20_64, cospi_12_64);
+  const __m256i k__cospi_p12_m20 = PAIR256_SET_EPI16(cospi_12_64, -cospi_20_64);
+  const __m256i k__cospi_m28_p04 = PAIR256_SET_EPI16(-cospi_28_64, cospi_4_64);
+  const __m256i k__cospi_m12_p20 = PAIR256_SET_EPI16(-cospi_12_64, cospi_20_64);
+  const __m256i k__cospi_p08_p24 = PAIR256_SET_EPI16(cospi_8_64, cospi_24_64);
+  const __m256i k__cospi_p24_m08 = PAIR256_SET_EPI16(cospi_24_64, -cospi_8_64);
+  const __m256i k__cospi_m24_p08 = PAIR256_SET_EPI16(-cospi_24_64, cospi_8_64);
+  const __m256i k__cospi_m16_m16 = _mm256_set1_epi16(-cospi_16_64);
+  const __m256i k__cospi_p16_p16 = _mm256_set1_epi16(cospi_16_64);
+  const __m256i k__cospi_p16_m16 = PAIR256_SET_EPI16(cospi_16_64, -cospi_16_64);
+  const __m256i k__cospi_m16_p16 = PAIR256_SET_EPI16(-cospi_16_64, cospi_16_64);
+  const __m256i kZero = _mm256_setzero_si256();
+  // Stage 1 constants for the pairs (in[15 - 2 * i], in[2 * i]).
+  const __m256i k1[8] = {
+    PAIR256_SET_EPI16(cospi_1_64, cospi_31_64),
+    PAIR256_SET_EPI16(cospi_5_64, cospi_27_64),
+    PAIR256_SET_EPI16(cospi_9_64, cospi_23_64),
+    PAIR256_SET_EPI16(cospi_13_64, cospi_19_64),
+    PAIR256_SET_EPI16(cospi_17_64, cospi_15_64),
+    PAIR256_SET_EPI16(cospi_21_64, cospi_11_64),
+    PAIR256_SET_EPI16(cospi_25_64, cospi_7_64),
+    PAIR256_SET_EPI16(cospi_29_64, cospi_3_64),
+  };
+  const __m256i k2[8] = {
+    PAIR256_SET_EPI16(cospi_31_64, -cospi_1_64),
+    PAIR256_SET_EPI16(cospi_27_64, -cospi_5_64),
+    PAIR256_SET_EPI16(cospi_23_64, -cospi_9_64),
+    PAIR256_SET_EPI16(cospi_19_64, -cospi_13_64),
+    PAIR256_SET_EPI16(cospi_15_64, -cospi_17_64),
+    PAIR256_SET_EPI16(cospi_11_64, -cospi_21_64),
+    PAIR256_SET_EPI16(cospi_7_64, -cospi_25_64),
+    PAIR256_SET_EPI16(cospi_3_64, -cospi_29_64),
+  };
+  __m256i s[16], x[16], u[8][2];
+  int i;
+
+  // stage 1
+  for (i = 0; i < 8; ++i) unpack16(in[15 - 2 * i], in[2 * i], u[i]);
+  for (i = 0; i < 4; ++i) {
+    iadst_butterfly16(u[i], u[i + 4], k1[i], k1[i + 4], &s[2 * i],
+                      &s[2 * i + 8]);
+    iadst_butterfly16(u[i], u[i + 4], k2[i], k2[i + 4], &s[2 * i + 1],
+                      &s[2 * i + 9]);
+  }
+
+  // stage 2
+  unpack16(s[8], s[9], u[0]);
+  unpack16(s[10], s[11], u[1]);
+  unpack16(s[12], s[13], u[2]);
+  unpack16(s[14], s[15], u[3]);
+  iadst_butterfly16(u[0], u[2], k__cospi_p04_p28, k__cospi_m28_p04, &x[8],
+                    &x[12]);
+  iadst_butterfly16(u[0], u[2], k__cospi_p28_m04, k__cospi_p04_p28, &x[9],
+                    &x[13]);
+  iadst_butterfly16(u[1], u[3], k__cospi_p20_p12, k__cospi_m12_p20, &x[10],
+                    &x[14]);
+  iadst_butterfly16(u[1], u[3], k__cospi_p12_m20, k__cospi_p20_p12, &x[11],
+                    &x[15]);
+  for (i = 0; i < 4; ++i) {
+    x[i] = _mm256_add_epi16(s[i], s[i + 4]);
+    x[i + 4] = _mm256_sub_epi16(s[i], s[i + 4]);
+  }
+
+  // stage 3
+  unpack16(x[4], x[5], u[0]);
+  unpack16(x[6], x[7], u[1]);
+  unpack16(x[12], x[13], u[2]);
+  unpack16(x[14], x[15], u[3]);
+  iadst_butterfly16(u[0], u[1], k__cospi_p08_p24, k__cospi_m24_p08, &s[4],
+                    &s[6]);
+  iadst_butterfly16(u[0], u[1], k__cospi_p24_m08, k__cospi_p08_p24, &s[5],
+                    &s[7]);
+  iadst_butterfly16(u[2], u[3], k__cospi_p08_p24, k__cospi_m24_p08, &s[12],
+                    &s[14]);
+  iadst_butterfly16(u[2], u[3], k__cospi_p24_m08, k__cospi_p08_p24, &s[13],
+                    &s[15]);
+  s[0] = _mm256_add_epi16(x[0], x[2]);
+  s[1] = _mm256_add_epi16(x[1], x[3]);
+  s[2] = _mm256_sub_epi16(x[0], x[2]);
+  s[3] = _mm256_sub_epi16(x[1], x[3]);
+  s[8] = _mm256_add_epi16(x[8], x[10]);
+  s[9] = _mm256_add_epi16(x[9], x[11]);
+  s[10] = _mm256_sub_epi16(x[8], x[10]);
+  s[11] = _mm256_sub_epi16(x[9], x[11]);
+
+  // stage 4
+  unpack16(s[2], s[3], u[0]);
+  unpack16(s[6], s[7], u[1]);
+  unpack16(s[10], s[11], u[2]);
+  unpack16(s[14], s[15], u[3]);
+  in[7] = idct_calc_wraplow_avx2(&u[0][0], &u[0][1], &k__cospi_m16_m16);
+  in[8] = idct_calc_wraplow_avx2(&u[0][0], &u[0][1], &k__cospi_p16_m16);
+  in[4] = idct_calc_wraplow_avx2(&u[1][0], &u[1][1], &k__cospi_p16_p16);
+  in[11] = idct_calc_wraplow_avx2(&u[1][0], &u[1][1], &k__cospi_m16_p16);
+  in[6] = idct_calc_wraplow_avx2(&u[2][0], &u[2][1], &k__cospi_p16_p16);
+  in[9] = idct_calc_wraplow_avx2(&u[2][0], &u[2][1], &k__cospi_m16_p16);
+  in[5] = idct_calc_wraplow_avx2(&u[3][0], &u[3][1], &k__cospi_m16_m16);
+  in[10] = idct_calc_wraplow_avx2(&u[3][0], &u[3][1], &k__cospi_p16_m16);
+
+  in[0] = s[0];
+  in[1] = _mm256_sub_epi16(kZero, s[8]);
+  in[2] = s[12];
+  in[3] = _mm256_sub_epi16(kZero, s[4]);
+  in[12] = s[5];
+  in[13] = _mm256_sub_epi16(kZero, s[13]);
+  in[14] = s[9];
+  in[15] = _mm256_sub_epi16(kZero, s[1]);
+}
+
+void iadst16_avx2(__m256i *const in) {
+  transpose_16bit_16x16_avx2(in, in);
+  iadst16_16col(in);
+}
+
+// Sets the 16-bit pairs (a, b) in the low lane and (c, d) in the high lane.
+static INLINE __m256i pair256_set_epi16_lanes(int a, int b, int c, int d) {
+  const __m128i lo = _mm_set_epi16((int16_t)b, (int16_t)a, (int16_t)b,
+                                   (int16_t)a, (int16_t)b, (int16_t)a,
+                                   (int16_t)b, (int16_t)a);
+  const __m128i hi = _mm_set_epi16((int16_t)d, (int16_t)c, (int16_t)d,
+                                   (int16_t)c, (int16_t)d, (int16_t)c,
+                                   (int16_t)d, (int16_t)c);
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+// Transposes the 8x8 block held as in[i] = [row i | row i + 4] into pairs of
+// columns: out[0] = [col 0 | col 2], out[1] = [col 4 | col 6],
+// out[2] = [col 1 | col 5] and out[3] = [col 7 | col 3], the pairings used by
+// the first stage of the 8-point transforms.
+static INLINE void transpose_16bit_8x8_avx2(const __m256i *const in,
+                                            __m256i *const out) {
+  const __m256i a0 = _mm256_unpacklo_epi16(in[0], in[1]);
+  const __m256i a1 = _mm256_unpackhi_epi16(in[0], in[1]);
+  const __m256i a2 = _mm256_unpacklo_epi16(in[2], in[3]);
+  const __m256i a3 = _mm256_unpackhi_epi16(in[2], in[3]);
+  // Columns 0-1, 2-3, 4-5 and 6-7, rows 0-3 in the low lane and rows 4-7 in
+  // the high lane.
+  const __m256i b0 = _mm256_unpacklo_epi32(a0, a2);
+  const __m256i b1 = _mm256_unpackhi_epi32(a0, a2);
+  const __m256i b2 = _mm256_unpacklo_epi32(a1, a3);
+  const __m256i b3 = _mm256_unpackhi_epi32(a1, a3);
+
+  out[0] = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(b0, b1), 0xd8);
+  out[1] = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(b2, b3), 0xd8);
+  out[2] = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(b0, b2), 0xd8);
+  out[3] = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(b3, b1), 0xd8);
+}
+
+// Takes the outputs of the 8-point transforms, [0 | 1], [3 | 2], [4 | 5] and
+// [7 | 6], and returns them as out[i] = [i | i + 4].
+static INLINE void regroup_8x8_avx2(__m256i o01, __m256i o32, __m256i o45,
+                                    __m256i o76, __m256i *const out) {
+  out[0] = _mm256_permute2x128_si256(o01, o45, 0x20);
+  out[1] = _mm256_permute2x128_si256(o01, o45, 0x31);
+  out[2] = _mm256_permute2x128_si256(o32, o76, 0x31);
+  out[3] = _mm256_permute2x128_si256(o32, o76, 0x20);
+}
+
+void idct8_avx2(__m256i *const in) {
+  const __m256i k_odd0 = pair256_set_epi16_lanes(cospi_28_64, -cospi_4_64,
+                                                 cospi_12_64, -cospi_20_64);
+  const __m256i k_odd1 = pair256_set_epi16_lanes(cospi_4_64, cospi_28_64,
+                                                 cospi_20_64, cospi_12_64);
+  const __m256i k_even0 = pair256_set_epi16_lanes(cospi_16_64, cospi_16_64,
+                                                  cospi_24_64, -cospi_8_64);
+  const __m256i k_even1 = pair256_set_epi16_lanes(cospi_16_64, -cospi_16_64,
+                                                  cospi_8_64, cospi_24_64);
+  const __m256i k_cospi16 = pair256_set_epi16_lanes(cospi_16_64, -cospi_16_64,
+                                                    -cospi_16_64, -cospi_16_64);
+  __m256i col[4], lo, hi, s45, s76, s02, s13, t, st4, st5, st6, st7, t56;
+  __m256i st01, st32, e, f;
+
+  transpose_16bit_8x8_avx2(in, col);
+
+  // stage 1
+  lo = _mm256_unpacklo_epi16(col[2], col[3]);
+  hi = _mm256_unpackhi_epi16(col[2], col[3]);
+  s45 = idct_calc_wraplow_avx2(&lo, &hi, &k_odd0);
+  s76 = idct_calc_wraplow_avx2(&lo, &hi, &k_odd1);
+
+  // stage 2
+  lo = _mm256_unpacklo_epi16(col[0], col[1]);
+  hi = _mm256_unpackhi_epi16(col[0], col[1]);
+  s02 = idct_calc_wraplow_avx2(&lo, &hi, &k_even0);
+  s13 = idct_calc_wraplow_avx2(&lo, &hi, &k_even1);
+  // The low lanes hold step2[4-7], the high lanes are not used apart from the
+  // negated step2[5] and step2[6].
+  t = _mm256_permute4x64_epi64(s45, 0x4e);
+  st4 = _mm256_add_epi16(s45, t);
+  st5 = _mm256_sub_epi16(s45, t);
+  t = _mm256_permute4x64_epi64(s76, 0x4e);
+  st7 = _mm256_add_epi16(s76, t);
+  st6 = _mm256_sub_epi16(s76, t);
+
+  // stage 3
+  e = _mm256_permute2x128_si256(s02, s13, 0x20);
+  f = _mm256_permute2x128_si256(s13, s02, 0x31);
+  st01 = _mm256_add_epi16(e, f);
+  st32 = _mm256_sub_epi16(e, f);
+  lo = _mm256_unpacklo_epi16(st6, st5);
+  hi = _mm256_unpackhi_epi16(st6, st5);
+  t56 = idct_calc_wraplow_avx2(&lo, &hi, &k_cospi16);
+
+  // stage 4
+  e = _mm256_blend_epi32(st7, t56, 0xf0);
+  f = _mm256_permute2x128_si256(st4, t56, 0x20);
+  regroup_8x8_avx2(_mm256_add_epi16(st01, e), _mm256_add_epi16(st32, f),
+                   _mm256_sub_epi16(st32, f), _mm256_sub_epi16(st01, e), in);
+}
+
+// Sets all the 16-bit values of the low lane to 'lo' and of the high lane to
+// 'hi'.
+static INLINE __m256i lanes_set_epi16(int lo, int hi) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_set1_epi16((int16_t)lo)),
+      _mm_set1_epi16((int16_t)hi), 1);
+}
+
+void iadst8_avx2(__m256i *const in) {
+  const __m256i k0 = pair256_set_epi16_lanes(cospi_2_64, cospi_30_64,
+                                             cospi_10_64, cospi_22_64);
+  const __m256i k1 = pair256_set_epi16_lanes(cospi_30_64, -cospi_2_64,
+                                             cospi_22_64, -cospi_10_64);
+  const __m256i k2 = pair256_set_epi16_lanes(cospi_18_64, cospi_14_64,
+                                             cospi_26_64, cospi_6_64);
+  const __m256i k3 = pair256_set_epi16_lanes(cospi_14_64, -cospi_18_64,
+                                             cospi_6_64, -cospi_26_64);
+  const __m256i k4 = pair256_set_epi16_lanes(cospi_8_64, cospi_24_64,
+                                             cospi_24_64, -cospi_8_64);
+  const __m256i k5 = pair256_set_epi16_lanes(-cospi_24_64, cospi_8_64,
+                                             cospi_8_64, cospi_24_64);
+  const __m256i k__cospi_p16_p16 = _mm256_set1_epi16(cospi_16_64);
+  const __m256i k__cospi_p16_m16 =
+      PAIR256_SET_EPI16(cospi_16_64, -cospi_16_64);
+  const __m256i pos_neg = lanes_set_epi16(1, -1);
+  const __m256i neg_pos = lanes_set_epi16(-1, 1);
+  __m256i col[4], u0[2], u1[2], x02, x13, x46, x57, x45, x67, s01, s23, e, f;
+  __m256i lo, hi;
+
+  transpose_16bit_8x8_avx2(in, col);
+
+  // stage 1
+  // Pairs (in[7], in[0]) and (in[5], in[2]).
+  unpack16(_mm256_blend_epi32(col[3], col[2], 0xf0), col[0], u0);
+  // Pairs (in[3], in[4]) and (in[1], in[6]).
+  unpack16(_mm256_permute2x128_si256(col[3], col[2], 0x21), col[1], u1);
+  iadst_butterfly16(u0, u1, k0, k2, &x02, &x46);
+  iadst_butterfly16(u0, u1, k1, k3, &x13, &x57);
+
+  // stage 2
+  e = _mm256_permute2x128_si256(x02, x13, 0x20);
+  f = _mm256_permute2x128_si256(x02, x13, 0x31);
+  s01 = _mm256_add_epi16(e, f);
+  s23 = _mm256_sub_epi16(e, f);
+  unpack16(_mm256_permute4x64_epi64(x46, 0x44),
+           _mm256_permute4x64_epi64(x57, 0x44), u0);
+  unpack16(_mm256_permute4x64_epi64(x46, 0xee),
+           _mm256_permute4x64_epi64(x57, 0xee), u1);
+  iadst_butterfly16(u0, u1, k4, k5, &x45, &x67);
+
+  // stage 3
+  e = _mm256_permute2x128_si256(s23, x67, 0x20);
+  f = _mm256_permute2x128_si256(s23, x67, 0x31);
+  lo = _mm256_unpacklo_epi16(e, f);
+  hi = _mm256_unpackhi_epi16(e, f);
+  e = idct_calc_wraplow_avx2(&lo, &hi, &k__cospi_p16_p16);
+  f = idct_calc_wraplow_avx2(&lo, &hi, &k__cospi_p16_m16);
+
+  regroup_8x8_avx2(
+      _mm256_sign_epi16(_mm256_permute2x128_si256(s01, x45, 0x20), pos_neg),
+      _mm256_sign_epi16(e, neg_pos), _mm256_sign_epi16(f, pos_neg),
+      _mm256_sign_epi16(_mm256_permute2x128_si256(s01, x45, 0x31), neg_pos),
+      in);
+}
+
+void vpx_idct8x8_64_add_avx2(const tran_low_t *input, uint8_t *dest,
+                             int stride) {
+  __m256i in[4];
+
+  load_buffer_8x8_avx2(input, in);
+  idct8_avx2(in);
+  idct8_avx2(in);
+  write_buffer_8x8_avx2(in, dest, stride);
+}
+
+// Only upper-left 4x4 has non-zero coeff. The full transform is cheap enough
+// in this layout that it is not specialized.
+void vpx_idct8x8_12_add_avx2(const tran_low_t *input, uint8_t *dest,
+                             int stride) {
+  vpx_idct8x8_64_add_avx2(input, dest, stride);
+}
+
+static INLINE __m256i transpose_16bit_4x4_avx2(__m256i in) {
+  const __m256i shuffle =
+      _mm256_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15, 0,
+                       1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+  const __m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  return _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(in, shuffle), perm);
+}
+
+// The 4-point transforms work on the rows and transpose the result, so two
+// calls make the 2-D transform.
+void idct4_avx2(__m256i *const in) {
+  const __m256i shuffle =
+      _mm256_setr_epi8(0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15, 0,
+                       1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15);
+  const __m256i k0 = _mm256_setr_epi16(
+      cospi_16_64, cospi_16_64, cospi_24_64, -cospi_8_64, cospi_16_64,
+      cospi_16_64, cospi_24_64, -cospi_8_64, cospi_16_64, cospi_16_64,
+      cospi_24_64, -cospi_8_64, cospi_16_64, cospi_16_64, cospi_24_64,
+      -cospi_8_64);
+  const __m256i k1 = _mm256_setr_epi16(
+      cospi_16_64, -cospi_16_64, cospi_8_64, cospi_24_64, cospi_16_64,
+      -cospi_16_64, cospi_8_64, cospi_24_64, cospi_16_64, -cospi_16_64,
+      cospi_8_64, cospi_24_64, cospi_16_64, -cospi_16_64, cospi_8_64,
+      cospi_24_64);
+  const __m256i sign = _mm256_setr_epi32(1, 1, -1, -1, 1, 1, -1, -1);
+  // (in[0], in[2], in[1], in[3]) for each row.
+  const __m256i x = _mm256_shuffle_epi8(*in, shuffle);
+  // step[0] and step[2], step[1] and step[3].
+  const __m256i s02 = dct_round_shift_avx2(_mm256_madd_epi16(x, k0));
+  const __m256i s13 = dct_round_shift_avx2(_mm256_madd_epi16(x, k1));
+  // step[0-3] of rows 0 and 2, then rows 1 and 3.
+  __m256i r0 = _mm256_unpacklo_epi32(s02, s13);
+  __m256i r1 = _mm256_unpackhi_epi32(s02, s13);
+
+  // (step[0], step[1], step[1], step[0]) +/- (step[3], step[2], step[2],
+  // step[3])
+  r0 = _mm256_add_epi32(
+      _mm256_shuffle_epi32(r0, 0x14),
+      _mm256_sign_epi32(_mm256_shuffle_epi32(r0, 0xeb), sign));
+  r1 = _mm256_add_epi32(
+      _mm256_shuffle_epi32(r1, 0x14),
+      _mm256_sign_epi32(_mm256_shuffle_epi32(r1, 0xeb), sign));
+  *in = transpose_16bit_4x4_avx2(_mm256_packs_epi32(r0, r1));
+}
+
+void iadst4_avx2(__m256i *const in) {
+  const __m256i shuffle =
+      _mm256_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15, 0,
+                       1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+  // Dot products of (in[0], in[1], in[2], in[3]) for output[0-3].
+  const __m256i k0 = _mm256_setr_epi16(
+      sinpi_1_9, sinpi_3_9, sinpi_4_9, sinpi_2_9, sinpi_1_9, sinpi_3_9,
+      sinpi_4_9, sinpi_2_9, sinpi_1_9, sinpi_3_9, sinpi_4_9, sinpi_2_9,
+      sinpi_1_9, sinpi_3_9, sinpi_4_9, sinpi_2_9);
+  const __m256i k1 = _mm256_setr_epi16(
+      sinpi_2_9, sinpi_3_9, -sinpi_1_9, -sinpi_4_9, sinpi_2_9, sinpi_3_9,
+      -sinpi_1_9, -sinpi_4_9, sinpi_2_9, sinpi_3_9, -sinpi_1_9, -sinpi_4_9,
+      sinpi_2_9, sinpi_3_9, -sinpi_1_9, -sinpi_4_9);
+  const __m256i k2 = _mm256_setr_epi16(
+      sinpi_3_9, 0, -sinpi_3_9, sinpi_3_9, sinpi_3_9, 0, -sinpi_3_9, sinpi_3_9,
+      sinpi_3_9, 0, -sinpi_3_9, sinpi_3_9, sinpi_3_9, 0, -sinpi_3_9,
+      sinpi_3_9);
+  const int16_t c0 = sinpi_1_9 + sinpi_2_9;
+  const int16_t c1 = sinpi_4_9 - sinpi_1_9;
+  const int16_t c2 = sinpi_2_9 - sinpi_4_9;
+  const __m256i k3 = _mm256_setr_epi16(
+      c0, -sinpi_3_9, c1, c2, c0, -sinpi_3_9, c1, c2, c0, -sinpi_3_9, c1, c2,
+      c0, -sinpi_3_9, c1, c2);
+  const __m256i m0 = _mm256_madd_epi16(*in, k0);
+  const __m256i m1 = _mm256_madd_epi16(*in, k1);
+  const __m256i m2 = _mm256_madd_epi16(*in, k2);
+  const __m256i m3 = _mm256_madd_epi16(*in, k3);
+  // output[0-1] and output[2-3] of rows 0 and 1, then rows 2 and 3.
+  const __m256i h01 = dct_round_shift_avx2(_mm256_hadd_epi32(m0, m1));
+  const __m256i h23 = dct_round_shift_avx2(_mm256_hadd_epi32(m2, m3));
+
+  *in = transpose_16bit_4x4_avx2(
+      _mm256_shuffle_epi8(_mm256_packs_epi32(h01, h23), shuffle));
+}
+
+void vpx_idct4x4_16_add_avx2(const tran_low_t *input, uint8_t *dest,
+                             int stride) {
+  __m256i in = load_input_data4x4(input);
+
+  idct4_avx2(&in);
+  idct4_avx2(&in);
+
+  // Final round and shift
+  in = _mm256_add_epi16(in, _mm256_set1_epi16(8));
+  in = _mm256_srai_epi16(in, 4);
+
+  recon_and_store4x4_avx2(in, dest, stride);
+}
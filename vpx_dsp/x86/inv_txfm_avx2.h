@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VPX_DSP_X86_INV_TXFM_AVX2_H_
+#define VPX_VPX_DSP_X86_INV_TXFM_AVX2_H_
+
+#include <immintrin.h>  // AVX2
+
+#include "./vpx_config.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_dsp/inv_txfm.h"
+#include "vpx_dsp/txfm_common.h"
+
+#define PAIR256_SET_EPI16(a, b)                                            \
+  _mm256_set_epi16((int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
+                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
+                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
+                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a))
+
+// Loads 'rows' rows of 16 values.
+static INLINE void idct_load16xn(const tran_low_t *input, __m256i *in,
+                                 int stride, int rows) {
+  int i;
+  for (i = 0; i < rows; i++) {
+#if CONFIG_VP9_HIGHBITDEPTH
+    const __m128i in0 = _mm_loadu_si128((const __m128i *)(input + i * stride));
+    const __m128i in1 =
+        _mm_loadu_si128((const __m128i *)((input + i * stride) + 4));
+    const __m128i in2 =
+        _mm_loadu_si128((const __m128i *)((input + i * stride) + 8));
+    const __m128i in3 =
+        _mm_loadu_si128((const __m128i *)((input + i * stride) + 12));
+    const __m128i ls = _mm_packs_epi32(in0, in1);
+    const __m128i rs = _mm_packs_epi32(in2, in3);
+    in[i] = _mm256_inserti128_si256(_mm256_castsi128_si256(ls), rs, 1);
+#else
+    in[i] = _mm256_load_si256((const __m256i *)(input + i * stride));
+#endif
+  }
+}
+
+static INLINE void idct_load16x16(const tran_low_t *input, __m256i *in,
+                                  int stride) {
+  // Load 16x16 values
+  idct_load16xn(input, in, stride, 16);
+}
+
+static INLINE __m256i dct_round_shift_avx2(__m256i in) {
+  const __m256i t = _mm256_add_epi32(in, _mm256_set1_epi32(DCT_CONST_ROUNDING));
+  return _mm256_srai_epi32(t, DCT_CONST_BITS);
+}
+
+static INLINE __m256i idct_madd_round_shift_avx2(const __m256i *in,
+                                                  const __m256i *cospi) {
+  const __m256i t = _mm256_madd_epi16(*in, *cospi);
+  return dct_round_shift_avx2(t);
+}
+
+// Calculate the dot product between in0/1 and x and wrap to short.
+static INLINE __m256i idct_calc_wraplow_avx2(const __m256i *in0,
+                                             const __m256i *in1,
+                                             const __m256i *x) {
+  const __m256i t0 = idct_madd_round_shift_avx2(in0, x);
+  const __m256i t1 = idct_madd_round_shift_avx2(in1, x);
+  return _mm256_packs_epi32(t0, t1);
+}
+
+static INLINE void recon_and_store16(uint8_t *dest, __m256i in_x) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i d0 = _mm256_castsi128_si256(_mm_loadu_si128((__m128i *)(dest)));
+  d0 = _mm256_permute4x64_epi64(d0, 0xd8);
+  d0 = _mm256_unpacklo_epi8(d0, zero);
+  d0 = _mm256_add_epi16(in_x, d0);
+  d0 = _mm256_packus_epi16(
+      d0, _mm256_castsi128_si256(_mm256_extractf128_si256(d0, 1)));
+
+  _mm_storeu_si128((__m128i *)dest, _mm256_castsi256_si128(d0));
+}
+
+static INLINE void write_buffer_16x1(uint8_t *dest, __m256i in) {
+  const __m256i final_rounding = _mm256_set1_epi16(1 << 5);
+  __m256i out;
+  out = _mm256_adds_epi16(in, final_rounding);
+  out = _mm256_srai_epi16(out, 6);
+  recon_and_store16(dest, out);
+}
+
+// 4x4 blocks are held in a single register, rows 0 and 1 in the low lane and
+// rows 2 and 3 in the high lane.
+static INLINE __m256i load_input_data4x4(const tran_low_t *data) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  const __m256i in0 = _mm256_loadu_si256((const __m256i *)data);
+  const __m256i in1 = _mm256_loadu_si256((const __m256i *)(data + 8));
+  return _mm256_permute4x64_epi64(_mm256_packs_epi32(in0, in1), 0xd8);
+#else
+  return _mm256_loadu_si256((const __m256i *)data);
+#endif
+}
+
+static INLINE void recon_and_store4x4_avx2(__m256i in, uint8_t *const dest,
+                                           const int stride) {
+  __m128i d = _mm_cvtsi32_si128(*(const int *)dest);
+  __m256i t;
+  d = _mm_insert_epi32(d, *(const int *)(dest + stride), 1);
+  d = _mm_insert_epi32(d, *(const int *)(dest + stride * 2), 2);
+  d = _mm_insert_epi32(d, *(const int *)(dest + stride * 3), 3);
+  t = _mm256_add_epi16(_mm256_cvtepu8_epi16(d), in);
+  d = _mm_packus_epi16(_mm256_castsi256_si128(t),
+                       _mm256_extracti128_si256(t, 1));
+  *(int *)dest = _mm_cvtsi128_si32(d);
+  *(int *)(dest + stride) = _mm_extract_epi32(d, 1);
+  *(int *)(dest + stride * 2) = _mm_extract_epi32(d, 2);
+  *(int *)(dest + stride * 3) = _mm_extract_epi32(d, 3);
+}
+
+// 8x8 blocks are held in 4 registers, in[i] has row i in the low lane and
+// row i + 4 in the high lane.
+static INLINE __m256i load_input_data8x2(const tran_low_t *data0,
+                                         const tran_low_t *data1) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  const __m256i in0 = _mm256_loadu_si256((const __m256i *)data0);
+  const __m256i in1 = _mm256_loadu_si256((const __m256i *)data1);
+  return _mm256_permute4x64_epi64(_mm256_packs_epi32(in0, in1), 0xd8);
+#else
+  const __m128i in0 = _mm_loadu_si128((const __m128i *)data0);
+  const __m128i in1 = _mm_loadu_si128((const __m128i *)data1);
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(in0), in1, 1);
+#endif
+}
+
+static INLINE void load_buffer_8x8_avx2(const tran_low_t *input,
+                                        __m256i *const in) {
+  in[0] = load_input_data8x2(input + 0 * 8, input + 4 * 8);
+  in[1] = load_input_data8x2(input + 1 * 8, input + 5 * 8);
+  in[2] = load_input_data8x2(input + 2 * 8, input + 6 * 8);
+  in[3] = load_input_data8x2(input + 3 * 8, input + 7 * 8);
+}
+
+static INLINE void recon_and_store8x2(uint8_t *const dest0,
+                                      uint8_t *const dest1, __m256i in) {
+  const __m128i d = _mm_unpacklo_epi64(_mm_loadl_epi64((__m128i *)dest0),
+                                       _mm_loadl_epi64((__m128i *)dest1));
+  const __m256i t = _mm256_add_epi16(_mm256_cvtepu8_epi16(d), in);
+  const __m128i out = _mm_packus_epi16(_mm256_castsi256_si128(t),
+                                       _mm256_extracti128_si256(t, 1));
+  _mm_storel_epi64((__m128i *)dest0, out);
+  _mm_storel_epi64((__m128i *)dest1, _mm_srli_si128(out, 8));
+}
+
+static INLINE void write_buffer_8x8_avx2(const __m256i *const in,
+                                         uint8_t *const dest,
+                                         const int stride) {
+  const __m256i final_rounding = _mm256_set1_epi16(1 << 4);
+  int i;
+  for (i = 0; i < 4; ++i) {
+    const __m256i out =
+        _mm256_srai_epi16(_mm256_adds_epi16(in[i], final_rounding), 5);
+    recon_and_store8x2(dest + i * stride, dest + (i + 4) * stride, out);
+  }
+}
+
+void idct4_avx2(__m256i *const in);
+void iadst4_avx2(__m256i *const in);
+void idct8_avx2(__m256i *const in);
+void iadst8_avx2(__m256i *const in);
+void idct16_avx2(__m256i *const in);
+void iadst16_avx2(__m256i *const in);
+
+#endif  // VPX_VPX_DSP_X86_INV_TXFM_AVX2_H_
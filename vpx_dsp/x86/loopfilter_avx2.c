@@ -911,3 +911,389 @@ void vpx_lpf_horizontal_16_dual_avx2(unsigned char *s, int pitch,
     _mm_storeu_si128((__m128i *)(s + 6 * pitch), q6);
   }
 }
+
+// Transposes the 8x16 block held in 'in' to 16x8. in[i] holds rows i and
+// i + 4 in its low and high lanes. On return out[i] holds rows 4 * i to
+// 4 * i + 3 of the transposed block, 8 bytes each.
+static INLINE void transpose_8x16_to_16x8(const __m256i *in, __m256i *out) {
+  const __m256i idx = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  // 00 10 01 11 .. 07 17 | 40 50 41 51 .. 47 57
+  const __m256i a0 = _mm256_unpacklo_epi8(in[0], in[1]);
+  const __m256i a1 = _mm256_unpackhi_epi8(in[0], in[1]);
+  const __m256i a2 = _mm256_unpacklo_epi8(in[2], in[3]);
+  const __m256i a3 = _mm256_unpackhi_epi8(in[2], in[3]);
+  // 00 10 20 30 .. 03 13 23 33 | 40 50 60 70 .. 43 53 63 73
+  const __m256i b0 = _mm256_unpacklo_epi16(a0, a2);
+  const __m256i b1 = _mm256_unpackhi_epi16(a0, a2);
+  const __m256i b2 = _mm256_unpacklo_epi16(a1, a3);
+  const __m256i b3 = _mm256_unpackhi_epi16(a1, a3);
+  // 00 10 20 30 40 50 60 70 .. 03 13 23 33 43 53 63 73
+  out[0] = _mm256_permutevar8x32_epi32(b0, idx);
+  out[1] = _mm256_permutevar8x32_epi32(b1, idx);
+  out[2] = _mm256_permutevar8x32_epi32(b2, idx);
+  out[3] = _mm256_permutevar8x32_epi32(b3, idx);
+}
+
+// Transposes the 16x8 block of rows of 8 bytes, the first 8 rows are read
+// from 's0' and the last 8 from 's1'. On return out[i] holds the columns
+// 2 * i and 2 * i + 1, for the first 8 rows in the low lane and for the last
+// 8 rows in the high lane.
+static INLINE void transpose_16x8_to_8x16(const uint8_t *s0, const uint8_t *s1,
+                                          int pitch, __m256i *out) {
+  const __m256i interleave =
+      _mm256_setr_epi8(0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15, 0,
+                       8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15);
+  __m256i x[4], t[4];
+  int i;
+
+  for (i = 0; i < 4; ++i) {
+    const __m128i lo = _mm_castpd_si128(
+        _mm_loadh_pd(_mm_castsi128_pd(_mm_loadl_epi64(
+                         (const __m128i *)(s0 + 2 * i * pitch))),
+                     (const double *)(s0 + (2 * i + 1) * pitch)));
+    const __m128i hi = _mm_castpd_si128(
+        _mm_loadh_pd(_mm_castsi128_pd(_mm_loadl_epi64(
+                         (const __m128i *)(s1 + 2 * i * pitch))),
+                     (const double *)(s1 + (2 * i + 1) * pitch)));
+    // 00 10 01 11 .. 07 17 | 80 90 81 91 .. 87 97
+    x[i] = _mm256_shuffle_epi8(
+        _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1),
+        interleave);
+  }
+  // 00 10 20 30 .. 03 13 23 33 | 80 90 a0 b0 .. 83 93 a3 b3
+  t[0] = _mm256_unpacklo_epi16(x[0], x[1]);
+  t[1] = _mm256_unpackhi_epi16(x[0], x[1]);
+  t[2] = _mm256_unpacklo_epi16(x[2], x[3]);
+  t[3] = _mm256_unpackhi_epi16(x[2], x[3]);
+  // 00 10 20 30 40 50 60 70 01 11 .. 71 | 80 90 .. f0 81 91 .. f1
+  out[0] = _mm256_unpacklo_epi32(t[0], t[2]);
+  out[1] = _mm256_unpackhi_epi32(t[0], t[2]);
+  out[2] = _mm256_unpacklo_epi32(t[1], t[3]);
+  out[3] = _mm256_unpackhi_epi32(t[1], t[3]);
+}
+
+// Transposes a 16x16 block, 'dst' may not overlap 'src'.
+static INLINE void transpose_16x16(const uint8_t *src, int in_p, uint8_t *dst,
+                                   int out_p) {
+  __m256i x[8], a[8], b[8], c;
+  int i;
+
+  for (i = 0; i < 8; ++i) {
+    x[i] = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(
+            _mm_loadu_si128((const __m128i *)(src + i * in_p))),
+        _mm_loadu_si128((const __m128i *)(src + (i + 8) * in_p)), 1);
+  }
+  for (i = 0; i < 4; ++i) {
+    a[2 * i] = _mm256_unpacklo_epi8(x[2 * i], x[2 * i + 1]);
+    a[2 * i + 1] = _mm256_unpackhi_epi8(x[2 * i], x[2 * i + 1]);
+  }
+  // Columns 0-3, 4-7, 8-11 and 12-15 of rows 0-3 and 4-7.
+  b[0] = _mm256_unpacklo_epi16(a[0], a[2]);
+  b[1] = _mm256_unpacklo_epi16(a[4], a[6]);
+  b[2] = _mm256_unpackhi_epi16(a[0], a[2]);
+  b[3] = _mm256_unpackhi_epi16(a[4], a[6]);
+  b[4] = _mm256_unpacklo_epi16(a[1], a[3]);
+  b[5] = _mm256_unpacklo_epi16(a[5], a[7]);
+  b[6] = _mm256_unpackhi_epi16(a[1], a[3]);
+  b[7] = _mm256_unpackhi_epi16(a[5], a[7]);
+  for (i = 0; i < 4; ++i) {
+    // Columns 4 * i and 4 * i + 1, then 4 * i + 2 and 4 * i + 3.
+    c = _mm256_permute4x64_epi64(
+        _mm256_unpacklo_epi32(b[2 * i], b[2 * i + 1]), 0xd8);
+    _mm_storeu_si128((__m128i *)(dst + 4 * i * out_p),
+                     _mm256_castsi256_si128(c));
+    _mm_storeu_si128((__m128i *)(dst + (4 * i + 1) * out_p),
+                     _mm256_extracti128_si256(c, 1));
+    c = _mm256_permute4x64_epi64(
+        _mm256_unpackhi_epi32(b[2 * i], b[2 * i + 1]), 0xd8);
+    _mm_storeu_si128((__m128i *)(dst + (4 * i + 2) * out_p),
+                     _mm256_castsi256_si128(c));
+    _mm_storeu_si128((__m128i *)(dst + (4 * i + 3) * out_p),
+                     _mm256_extracti128_si256(c, 1));
+  }
+}
+
+static INLINE __m256i abs_diff_avx2(__m256i a, __m256i b) {
+  return _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+}
+
+static INLINE __m128i max_lanes_avx2(__m256i a) {
+  return _mm_max_epu8(_mm256_castsi256_si128(a),
+                      _mm256_extracti128_si256(a, 1));
+}
+
+// Packs the 16-bit 'lo' and 'hi' to bytes in the low and high lanes.
+static INLINE __m256i pack_lanes_avx2(__m256i lo, __m256i hi) {
+  return _mm256_permute4x64_epi64(_mm256_packs_epi16(lo, hi), 0xd8);
+}
+
+static INLINE __m256i packus_lanes_avx2(__m256i lo, __m256i hi) {
+  return _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xd8);
+}
+
+// Filters 16 columns of an edge with the 4 or, when 'filter8' is set, the 8
+// tap filter. qp0 to qp3 hold p0 to p3 in their low lanes and q0 to q3 in
+// their high lanes.
+static INLINE void lpf_8x16_avx2(__m256i *qp2, __m256i *qp1, __m256i *qp0,
+                                 const __m256i qp3, const __m128i blimit,
+                                 const __m128i limit, const __m128i thresh,
+                                 int filter8) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ff = _mm_cmpeq_epi8(zero, zero);
+  const __m256i t80 = _mm256_set1_epi8((int8_t)0x80);
+  const __m256i abs_qp1qp0 = abs_diff_avx2(*qp1, *qp0);
+  const __m128i p1 = _mm256_castsi256_si128(*qp1);
+  const __m128i q1 = _mm256_extracti128_si256(*qp1, 1);
+  const __m128i p0 = _mm256_castsi256_si128(*qp0);
+  const __m128i q0 = _mm256_extracti128_si256(*qp0, 1);
+  __m128i mask, hev, flat;
+  __m256i qp1_f, qp0_f;
+
+  {
+    const __m128i fe = _mm_set1_epi8((int8_t)0xfe);
+    const __m128i abs_p1p0 = max_lanes_avx2(abs_qp1qp0);
+    __m128i abs_p0q0 =
+        _mm_or_si128(_mm_subs_epu8(p0, q0), _mm_subs_epu8(q0, p0));
+    __m128i abs_p1q1 =
+        _mm_or_si128(_mm_subs_epu8(p1, q1), _mm_subs_epu8(q1, p1));
+    __m256i work;
+    hev = _mm_subs_epu8(abs_p1p0, thresh);
+    hev = _mm_xor_si128(_mm_cmpeq_epi8(hev, zero), ff);
+
+    abs_p0q0 = _mm_adds_epu8(abs_p0q0, abs_p0q0);
+    abs_p1q1 = _mm_srli_epi16(_mm_and_si128(abs_p1q1, fe), 1);
+    mask = _mm_subs_epu8(_mm_adds_epu8(abs_p0q0, abs_p1q1), blimit);
+    mask = _mm_xor_si128(_mm_cmpeq_epi8(mask, zero), ff);
+    // mask |= (abs(p0 - q0) * 2 + abs(p1 - q1) / 2  > blimit) * -1;
+    work = _mm256_max_epu8(abs_diff_avx2(*qp2, *qp1),
+                           abs_diff_avx2(qp3, *qp2));
+    mask = _mm_max_epu8(max_lanes_avx2(_mm256_max_epu8(work, abs_qp1qp0)),
+                        mask);
+    mask = _mm_subs_epu8(mask, limit);
+    mask = _mm_cmpeq_epi8(mask, zero);
+  }
+
+  // lp filter
+  {
+    const __m128i t4 = _mm_set1_epi8(4);
+    const __m128i t3 = _mm_set1_epi8(3);
+    const __m256i zero256 = _mm256_setzero_si256();
+    const __m256i qps1 = _mm256_xor_si256(*qp1, t80);
+    const __m256i qps0 = _mm256_xor_si256(*qp0, t80);
+    const __m128i ps1 = _mm256_castsi256_si128(qps1);
+    const __m128i qs1 = _mm256_extracti128_si256(qps1, 1);
+    const __m128i ps0 = _mm256_castsi256_si128(qps0);
+    const __m128i qs0 = _mm256_extracti128_si256(qps0, 1);
+    __m128i filt, work_a;
+    __m256i filter1, filter2;
+
+    filt = _mm_and_si128(_mm_subs_epi8(ps1, qs1), hev);
+    work_a = _mm_subs_epi8(qs0, ps0);
+    filt = _mm_adds_epi8(filt, work_a);
+    filt = _mm_adds_epi8(filt, work_a);
+    filt = _mm_adds_epi8(filt, work_a);
+    // (vpx_filter + 3 * (qs0 - ps0)) & mask
+    filt = _mm_and_si128(filt, mask);
+
+    filter1 = _mm256_srai_epi16(
+        _mm256_cvtepi8_epi16(_mm_adds_epi8(filt, t4)), 3);
+    filter2 = _mm256_srai_epi16(
+        _mm256_cvtepi8_epi16(_mm_adds_epi8(filt, t3)), 3);
+
+    // ps0 + filter2, qs0 - filter1
+    qp0_f = _mm256_adds_epi8(
+        qps0,
+        pack_lanes_avx2(filter2, _mm256_sub_epi16(zero256, filter1)));
+    qp0_f = _mm256_xor_si256(qp0_f, t80);
+
+    // (filter1 + 1) >> 1 & ~hev
+    filter1 = _mm256_srai_epi16(
+        _mm256_add_epi16(filter1, _mm256_set1_epi16(1)), 1);
+    filter1 = _mm256_andnot_si256(_mm256_cvtepi8_epi16(hev), filter1);
+    qp1_f = _mm256_adds_epi8(
+        qps1,
+        pack_lanes_avx2(filter1, _mm256_sub_epi16(zero256, filter1)));
+    qp1_f = _mm256_xor_si256(qp1_f, t80);
+  }
+
+  if (filter8) {
+    flat = max_lanes_avx2(_mm256_max_epu8(
+        _mm256_max_epu8(abs_diff_avx2(*qp2, *qp0), abs_diff_avx2(qp3, *qp0)),
+        abs_qp1qp0));
+    flat = _mm_subs_epu8(flat, _mm_set1_epi8(1));
+    flat = _mm_cmpeq_epi8(flat, zero);
+    flat = _mm_and_si128(flat, mask);
+
+    if (_mm_movemask_epi8(flat)) {
+      const __m256i four = _mm256_set1_epi16(4);
+      const __m256i flat256 =
+          _mm256_inserti128_si256(_mm256_castsi128_si256(flat), flat, 1);
+      const __m256i p3 = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(qp3));
+      const __m256i q3 = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(qp3, 1));
+      const __m256i p2 = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(*qp2));
+      const __m256i q2 =
+          _mm256_cvtepu8_epi16(_mm256_extracti128_si256(*qp2, 1));
+      const __m256i p1w = _mm256_cvtepu8_epi16(p1);
+      const __m256i q1w = _mm256_cvtepu8_epi16(q1);
+      const __m256i p0w = _mm256_cvtepu8_epi16(p0);
+      const __m256i q0w = _mm256_cvtepu8_epi16(q0);
+      __m256i sum, op2, op1, op0, oq0, oq1, oq2;
+
+      // 7-tap filter [1, 1, 1, 2, 1, 1, 1], updated as a running sum.
+      sum = _mm256_add_epi16(_mm256_add_epi16(p3, p3), p3);
+      sum = _mm256_add_epi16(sum, _mm256_add_epi16(p2, p2));
+      sum = _mm256_add_epi16(sum, _mm256_add_epi16(p1w, p0w));
+      sum = _mm256_add_epi16(sum, _mm256_add_epi16(q0w, four));
+      op2 = _mm256_srli_epi16(sum, 3);
+      sum = _mm256_add_epi16(_mm256_sub_epi16(sum, _mm256_add_epi16(p3, p2)),
+                             _mm256_add_epi16(p1w, q1w));
+      op1 = _mm256_srli_epi16(sum, 3);
+      sum = _mm256_add_epi16(_mm256_sub_epi16(sum, _mm256_add_epi16(p3, p1w)),
+                             _mm256_add_epi16(p0w, q2));
+      op0 = _mm256_srli_epi16(sum, 3);
+      sum = _mm256_add_epi16(_mm256_sub_epi16(sum, _mm256_add_epi16(p3, p0w)),
+                             _mm256_add_epi16(q0w, q3));
+      oq0 = _mm256_srli_epi16(sum, 3);
+      sum = _mm256_add_epi16(_mm256_sub_epi16(sum, _mm256_add_epi16(p2, q0w)),
+                             _mm256_add_epi16(q1w, q3));
+      oq1 = _mm256_srli_epi16(sum, 3);
+      sum = _mm256_add_epi16(_mm256_sub_epi16(sum, _mm256_add_epi16(p1w, q1w)),
+                             _mm256_add_epi16(q2, q3));
+      oq2 = _mm256_srli_epi16(sum, 3);
+
+      *qp2 = _mm256_blendv_epi8(*qp2, packus_lanes_avx2(op2, oq2), flat256);
+      qp1_f = _mm256_blendv_epi8(qp1_f, packus_lanes_avx2(op1, oq1), flat256);
+      qp0_f = _mm256_blendv_epi8(qp0_f, packus_lanes_avx2(op0, oq0), flat256);
+    }
+  }
+
+  *qp1 = qp1_f;
+  *qp0 = qp0_f;
+}
+
+// Filters the vertical edge at 's' of 16 rows, or of 8 rows when 's1' is 's'.
+// Rows 8 to 15 are at 's1'.
+static INLINE void lpf_vertical_8x16_avx2(uint8_t *s, uint8_t *s1, int pitch,
+                                          const __m128i blimit,
+                                          const __m128i limit,
+                                          const __m128i thresh, int filter8) {
+  __m256i x[4], qp3, qp2, qp1, qp0, r[4];
+  int i;
+
+  transpose_16x8_to_8x16(s - 4, s1 - 4, pitch, x);
+  // [c0 | c7], [c1 | c6], [c2 | c5] and [c3 | c4]
+  qp3 = _mm256_permute4x64_epi64(_mm256_blend_epi32(x[0], x[3], 0xcc), 0xd8);
+  qp2 = _mm256_permute4x64_epi64(_mm256_blend_epi32(x[0], x[3], 0x33), 0x8d);
+  qp1 = _mm256_permute4x64_epi64(_mm256_blend_epi32(x[1], x[2], 0xcc), 0xd8);
+  qp0 = _mm256_permute4x64_epi64(_mm256_blend_epi32(x[1], x[2], 0x33), 0x8d);
+
+  lpf_8x16_avx2(&qp2, &qp1, &qp0, qp3, blimit, limit, thresh, filter8);
+
+  // [p3 | q0], [p2 | q1], [p1 | q2] and [p0 | q3]
+  x[0] = _mm256_blend_epi32(qp3, qp0, 0xf0);
+  x[1] = _mm256_blend_epi32(qp2, qp1, 0xf0);
+  x[2] = _mm256_blend_epi32(qp1, qp2, 0xf0);
+  x[3] = _mm256_blend_epi32(qp0, qp3, 0xf0);
+  transpose_8x16_to_16x8(x, r);
+
+  for (i = 0; i < (s1 == s ? 2 : 4); ++i) {
+    uint8_t *const d = (i < 2 ? s : s1 - 8 * pitch) + 4 * i * pitch - 4;
+    const __m128i lo = _mm256_castsi256_si128(r[i]);
+    const __m128i hi = _mm256_extracti128_si256(r[i], 1);
+    _mm_storel_epi64((__m128i *)d, lo);
+    _mm_storeh_pd((double *)(d + pitch), _mm_castsi128_pd(lo));
+    _mm_storel_epi64((__m128i *)(d + 2 * pitch), hi);
+    _mm_storeh_pd((double *)(d + 3 * pitch), _mm_castsi128_pd(hi));
+  }
+}
+
+static INLINE __m128i load_limit_avx2(const uint8_t *l0, const uint8_t *l1) {
+  return _mm_unpacklo_epi64(_mm_set1_epi8((int8_t)l0[0]),
+                            _mm_set1_epi8((int8_t)l1[0]));
+}
+
+void vpx_lpf_vertical_4_avx2(uint8_t *s, int pitch, const uint8_t *blimit,
+                             const uint8_t *limit, const uint8_t *thresh) {
+  lpf_vertical_8x16_avx2(s, s, pitch, load_limit_avx2(blimit, blimit),
+                         load_limit_avx2(limit, limit),
+                         load_limit_avx2(thresh, thresh), 0);
+}
+
+void vpx_lpf_vertical_4_dual_avx2(uint8_t *s, int pitch,
+                                  const uint8_t *blimit0,
+                                  const uint8_t *limit0,
+                                  const uint8_t *thresh0,
+                                  const uint8_t *blimit1,
+                                  const uint8_t *limit1,
+                                  const uint8_t *thresh1) {
+  lpf_vertical_8x16_avx2(s, s + 8 * pitch, pitch,
+                         load_limit_avx2(blimit0, blimit1),
+                         load_limit_avx2(limit0, limit1),
+                         load_limit_avx2(thresh0, thresh1), 0);
+}
+
+void vpx_lpf_vertical_8_avx2(uint8_t *s, int pitch, const uint8_t *blimit,
+                             const uint8_t *limit, const uint8_t *thresh) {
+  lpf_vertical_8x16_avx2(s, s, pitch, load_limit_avx2(blimit, blimit),
+                         load_limit_avx2(limit, limit),
+                         load_limit_avx2(thresh, thresh), 1);
+}
+
+void vpx_lpf_vertical_8_dual_avx2(uint8_t *s, int pitch,
+                                  const uint8_t *blimit0,
+                                  const uint8_t *limit0,
+                                  const uint8_t *thresh0,
+                                  const uint8_t *blimit1,
+                                  const uint8_t *limit1,
+                                  const uint8_t *thresh1) {
+  lpf_vertical_8x16_avx2(s, s + 8 * pitch, pitch,
+                         load_limit_avx2(blimit0, blimit1),
+                         load_limit_avx2(limit0, limit1),
+                         load_limit_avx2(thresh0, thresh1), 1);
+}
+
+void vpx_lpf_vertical_16_avx2(uint8_t *s, int pitch, const uint8_t *blimit,
+                              const uint8_t *limit, const uint8_t *thresh) {
+  DECLARE_ALIGNED(32, uint8_t, t_dst[16 * 8]);
+  __m256i x[4], r[4];
+  int i;
+
+  // Transpose 8x16 to 16x8.
+  for (i = 0; i < 4; ++i) {
+    x[i] = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(
+            _mm_loadu_si128((const __m128i *)(s - 8 + i * pitch))),
+        _mm_loadu_si128((const __m128i *)(s - 8 + (i + 4) * pitch)), 1);
+  }
+  transpose_8x16_to_16x8(x, r);
+  for (i = 0; i < 4; ++i) _mm256_store_si256((__m256i *)(t_dst + 32 * i), r[i]);
+
+  // Loop filtering
+  vpx_lpf_horizontal_16_avx2(t_dst + 8 * 8, 8, blimit, limit, thresh);
+
+  // Transpose back.
+  transpose_16x8_to_8x16(t_dst, t_dst + 8 * 8, 8, x);
+  for (i = 0; i < 4; ++i) {
+    const __m256i rows = _mm256_permute4x64_epi64(x[i], 0xd8);
+    _mm_storeu_si128((__m128i *)(s - 8 + 2 * i * pitch),
+                     _mm256_castsi256_si128(rows));
+    _mm_storeu_si128((__m128i *)(s - 8 + (2 * i + 1) * pitch),
+                     _mm256_extracti128_si256(rows, 1));
+  }
+}
+
+void vpx_lpf_vertical_16_dual_avx2(uint8_t *s, int pitch,
+                                   const uint8_t *blimit, const uint8_t *limit,
+                                   const uint8_t *thresh) {
+  DECLARE_ALIGNED(16, uint8_t, t_dst[256]);
+
+  // Transpose 16x16
+  transpose_16x16(s - 8, pitch, t_dst, 16);
+
+  // Loop filtering
+  vpx_lpf_horizontal_16_dual_avx2(t_dst + 8 * 16, 16, blimit, limit, thresh);
+
+  // Transpose back
+  transpose_16x16(t_dst, 16, s - 8, pitch);
+}
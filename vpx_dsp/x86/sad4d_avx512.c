@@ -11,12 +11,50 @@
 #include "./vpx_dsp_rtcd.h"
 #include "vpx/vpx_integer.h"
 
-void vpx_sad64x64x4d_avx512(const uint8_t *src_ptr, int src_stride,
-                            const uint8_t *const ref_array[4], int ref_stride,
-                            uint32_t sad_array[4]) {
+static INLINE void calc_final_4(__m512i sum_ref0, __m512i sum_ref1,
+                                __m512i sum_ref2, __m512i sum_ref3,
+                                uint32_t sad_array[4]) {
+  __m512i sum_mlow, sum_mhigh;
+  __m256i sum256;
+  __m128i sum128;
+  // in sum_ref[] the result is saved in the first 4 bytes
+  // the other 4 bytes are zeroed.
+  // sum_ref1 and sum_ref3 are shifted left by 4 bytes
+  sum_ref1 = _mm512_bslli_epi128(sum_ref1, 4);
+  sum_ref3 = _mm512_bslli_epi128(sum_ref3, 4);
+
+  // merge sum_ref0 and sum_ref1 also sum_ref2 and sum_ref3
+  sum_ref0 = _mm512_or_si512(sum_ref0, sum_ref1);
+  sum_ref2 = _mm512_or_si512(sum_ref2, sum_ref3);
+
+  // merge every 64 bit from each sum_ref[]
+  sum_mlow = _mm512_unpacklo_epi64(sum_ref0, sum_ref2);
+  sum_mhigh = _mm512_unpackhi_epi64(sum_ref0, sum_ref2);
+
+  // add the low 64 bit to the high 64 bit
+  sum_mlow = _mm512_add_epi32(sum_mlow, sum_mhigh);
+
+  // add the low 128 bit to the high 128 bit
+  sum256 = _mm256_add_epi32(_mm512_castsi512_si256(sum_mlow),
+                            _mm512_extracti32x8_epi32(sum_mlow, 1));
+  sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum256),
+                         _mm256_extractf128_si256(sum256, 1));
+
+  _mm_storeu_si128((__m128i *)(sad_array), sum128);
+}
+
+static INLINE __m512i loadu_2x32(const uint8_t *p0, const uint8_t *p1) {
+  const __m256i lo = _mm256_loadu_si256((const __m256i *)p0);
+  const __m256i hi = _mm256_loadu_si256((const __m256i *)p1);
+  return _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+}
+
+static INLINE void sad64xhx4d_avx512(const uint8_t *src_ptr, int src_stride,
+                                     const uint8_t *const ref_array[4],
+                                     int ref_stride, int h,
+                                     uint32_t sad_array[4]) {
   __m512i src_reg, ref0_reg, ref1_reg, ref2_reg, ref3_reg;
   __m512i sum_ref0, sum_ref1, sum_ref2, sum_ref3;
-  __m512i sum_mlow, sum_mhigh;
   int i;
   const uint8_t *ref0, *ref1, *ref2, *ref3;
 
@@ -28,7 +66,7 @@ void vpx_sad64x64x4d_avx512(const uint8_t *src_ptr, int src_stride,
   sum_ref1 = _mm512_set1_epi16(0);
   sum_ref2 = _mm512_set1_epi16(0);
   sum_ref3 = _mm512_set1_epi16(0);
-  for (i = 0; i < 64; i++) {
+  for (i = 0; i < h; i++) {
     // load src and all ref[]
     src_reg = _mm512_loadu_si512((const __m512i *)src_ptr);
     ref0_reg = _mm512_loadu_si512((const __m512i *)ref0);
@@ -52,32 +90,101 @@ void vpx_sad64x64x4d_avx512(const uint8_t *src_ptr, int src_stride,
     ref2 += ref_stride;
     ref3 += ref_stride;
   }
-  {
-    __m256i sum256;
-    __m128i sum128;
-    // in sum_ref[] the result is saved in the first 4 bytes
-    // the other 4 bytes are zeroed.
-    // sum_ref1 and sum_ref3 are shifted left by 4 bytes
-    sum_ref1 = _mm512_bslli_epi128(sum_ref1, 4);
-    sum_ref3 = _mm512_bslli_epi128(sum_ref3, 4);
-
-    // merge sum_ref0 and sum_ref1 also sum_ref2 and sum_ref3
-    sum_ref0 = _mm512_or_si512(sum_ref0, sum_ref1);
-    sum_ref2 = _mm512_or_si512(sum_ref2, sum_ref3);
-
-    // merge every 64 bit from each sum_ref[]
-    sum_mlow = _mm512_unpacklo_epi64(sum_ref0, sum_ref2);
-    sum_mhigh = _mm512_unpackhi_epi64(sum_ref0, sum_ref2);
-
-    // add the low 64 bit to the high 64 bit
-    sum_mlow = _mm512_add_epi32(sum_mlow, sum_mhigh);
-
-    // add the low 128 bit to the high 128 bit
-    sum256 = _mm256_add_epi32(_mm512_castsi512_si256(sum_mlow),
-                              _mm512_extracti32x8_epi32(sum_mlow, 1));
-    sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum256),
-                           _mm256_extractf128_si256(sum256, 1));
-
-    _mm_storeu_si128((__m128i *)(sad_array), sum128);
+  calc_final_4(sum_ref0, sum_ref1, sum_ref2, sum_ref3, sad_array);
+}
+
+// Same as above, but each register holds two consecutive 32-wide rows.
+static INLINE void sad32xhx4d_avx512(const uint8_t *src_ptr, int src_stride,
+                                     const uint8_t *const ref_array[4],
+                                     int ref_stride, int h,
+                                     uint32_t sad_array[4]) {
+  __m512i src_reg, ref0_reg, ref1_reg, ref2_reg, ref3_reg;
+  __m512i sum_ref0, sum_ref1, sum_ref2, sum_ref3;
+  int i;
+  const uint8_t *ref0, *ref1, *ref2, *ref3;
+
+  ref0 = ref_array[0];
+  ref1 = ref_array[1];
+  ref2 = ref_array[2];
+  ref3 = ref_array[3];
+  sum_ref0 = _mm512_set1_epi16(0);
+  sum_ref1 = _mm512_set1_epi16(0);
+  sum_ref2 = _mm512_set1_epi16(0);
+  sum_ref3 = _mm512_set1_epi16(0);
+  for (i = 0; i < h; i += 2) {
+    // load two rows of src and all ref[]
+    src_reg = loadu_2x32(src_ptr, src_ptr + src_stride);
+    ref0_reg = loadu_2x32(ref0, ref0 + ref_stride);
+    ref1_reg = loadu_2x32(ref1, ref1 + ref_stride);
+    ref2_reg = loadu_2x32(ref2, ref2 + ref_stride);
+    ref3_reg = loadu_2x32(ref3, ref3 + ref_stride);
+    // sum of the absolute differences between every ref[] to src
+    ref0_reg = _mm512_sad_epu8(ref0_reg, src_reg);
+    ref1_reg = _mm512_sad_epu8(ref1_reg, src_reg);
+    ref2_reg = _mm512_sad_epu8(ref2_reg, src_reg);
+    ref3_reg = _mm512_sad_epu8(ref3_reg, src_reg);
+    // sum every ref[]
+    sum_ref0 = _mm512_add_epi32(sum_ref0, ref0_reg);
+    sum_ref1 = _mm512_add_epi32(sum_ref1, ref1_reg);
+    sum_ref2 = _mm512_add_epi32(sum_ref2, ref2_reg);
+    sum_ref3 = _mm512_add_epi32(sum_ref3, ref3_reg);
+
+    src_ptr += 2 * src_stride;
+    ref0 += 2 * ref_stride;
+    ref1 += 2 * ref_stride;
+    ref2 += 2 * ref_stride;
+    ref3 += 2 * ref_stride;
   }
+  calc_final_4(sum_ref0, sum_ref1, sum_ref2, sum_ref3, sad_array);
 }
+
+#define SAD64_H(h)                                                           \
+  void vpx_sad64x##h##x4d_avx512(const uint8_t *src, int src_stride,         \
+                                 const uint8_t *const ref_array[4],          \
+                                 int ref_stride, uint32_t sad_array[4]) {    \
+    sad64xhx4d_avx512(src, src_stride, ref_array, ref_stride, h, sad_array); \
+  }
+
+#define SAD32_H(h)                                                           \
+  void vpx_sad32x##h##x4d_avx512(const uint8_t *src, int src_stride,         \
+                                 const uint8_t *const ref_array[4],          \
+                                 int ref_stride, uint32_t sad_array[4]) {    \
+    sad32xhx4d_avx512(src, src_stride, ref_array, ref_stride, h, sad_array); \
+  }
+
+SAD64_H(64)
+SAD64_H(32)
+SAD32_H(64)
+SAD32_H(32)
+SAD32_H(16)
+
+#define SADS64_H(h)                                                          \
+  void vpx_sad_skip_64x##h##x4d_avx512(                                      \
+      const uint8_t *src, int src_stride, const uint8_t *const ref_array[4], \
+      int ref_stride, uint32_t sad_array[4]) {                               \
+    sad64xhx4d_avx512(src, 2 * src_stride, ref_array, 2 * ref_stride,        \
+                      ((h) >> 1), sad_array);                                \
+    sad_array[0] <<= 1;                                                      \
+    sad_array[1] <<= 1;                                                      \
+    sad_array[2] <<= 1;                                                      \
+    sad_array[3] <<= 1;                                                      \
+  }
+
+#define SADS32_H(h)                                                          \
+  void vpx_sad_skip_32x##h##x4d_avx512(                                      \
+      const uint8_t *src, int src_stride, const uint8_t *const ref_array[4], \
+      int ref_stride, uint32_t sad_array[4]) {                               \
+    sad32xhx4d_avx512(src, 2 * src_stride, ref_array, 2 * ref_stride,        \
+                      ((h) >> 1), sad_array);                                \
+    sad_array[0] <<= 1;                                                      \
+    sad_array[1] <<= 1;                                                      \
+    sad_array[2] <<= 1;                                                      \
+    sad_array[3] <<= 1;                                                      \
+  }
+
+SADS64_H(64)
+SADS64_H(32)
+
+SADS32_H(64)
+SADS32_H(32)
+SADS32_H(16)
@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include <immintrin.h>  // AVX512
+#include "./vpx_dsp_rtcd.h"
+#include "vpx/vpx_integer.h"
+
+// Loads two 32 byte rows into the low and high halves of a 512-bit register.
+static INLINE __m512i loadu_2x32(const uint8_t *p0, const uint8_t *p1) {
+  const __m256i lo = _mm256_loadu_si256((const __m256i *)p0);
+  const __m256i hi = _mm256_loadu_si256((const __m256i *)p1);
+  return _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+}
+
+static INLINE unsigned int sum_sad_avx512(const __m512i sum_sad) {
+  // _mm512_sad_epu8() leaves eight 64-bit partial sums.
+  const __m256i sum256 =
+      _mm256_add_epi64(_mm512_castsi512_si256(sum_sad),
+                       _mm512_extracti64x4_epi64(sum_sad, 1));
+  const __m128i sum128 = _mm_add_epi64(_mm256_castsi256_si128(sum256),
+                                       _mm256_extracti128_si256(sum256, 1));
+  return (unsigned int)_mm_cvtsi128_si32(
+      _mm_add_epi64(sum128, _mm_srli_si128(sum128, 8)));
+}
+
+static INLINE unsigned int sad64xh_avx512(const uint8_t *src_ptr,
+                                          int src_stride,
+                                          const uint8_t *ref_ptr,
+                                          int ref_stride, int h) {
+  int i;
+  __m512i sum_sad = _mm512_setzero_si512();
+  for (i = 0; i < h; i++) {
+    const __m512i ref_reg = _mm512_loadu_si512((const __m512i *)ref_ptr);
+    const __m512i src_reg = _mm512_loadu_si512((const __m512i *)src_ptr);
+    sum_sad = _mm512_add_epi32(sum_sad, _mm512_sad_epu8(ref_reg, src_reg));
+    ref_ptr += ref_stride;
+    src_ptr += src_stride;
+  }
+  return sum_sad_avx512(sum_sad);
+}
+
+static INLINE unsigned int sad32xh_avx512(const uint8_t *src_ptr,
+                                          int src_stride,
+                                          const uint8_t *ref_ptr,
+                                          int ref_stride, int h) {
+  int i;
+  __m512i sum_sad = _mm512_setzero_si512();
+  for (i = 0; i < h; i += 2) {
+    const __m512i ref_reg = loadu_2x32(ref_ptr, ref_ptr + ref_stride);
+    const __m512i src_reg = loadu_2x32(src_ptr, src_ptr + src_stride);
+    sum_sad = _mm512_add_epi32(sum_sad, _mm512_sad_epu8(ref_reg, src_reg));
+    ref_ptr += 2 * ref_stride;
+    src_ptr += 2 * src_stride;
+  }
+  return sum_sad_avx512(sum_sad);
+}
+
+static INLINE unsigned int sad64xh_avg_avx512(const uint8_t *src_ptr,
+                                              int src_stride,
+                                              const uint8_t *ref_ptr,
+                                              int ref_stride, int h,
+                                              const uint8_t *second_pred) {
+  int i;
+  __m512i sum_sad = _mm512_setzero_si512();
+  for (i = 0; i < h; i++) {
+    const __m512i ref_reg = _mm512_avg_epu8(
+        _mm512_loadu_si512((const __m512i *)ref_ptr),
+        _mm512_loadu_si512((const __m512i *)second_pred));
+    const __m512i src_reg = _mm512_loadu_si512((const __m512i *)src_ptr);
+    sum_sad = _mm512_add_epi32(sum_sad, _mm512_sad_epu8(ref_reg, src_reg));
+    ref_ptr += ref_stride;
+    src_ptr += src_stride;
+    second_pred += 64;
+  }
+  return sum_sad_avx512(sum_sad);
+}
+
+static INLINE unsigned int sad32xh_avg_avx512(const uint8_t *src_ptr,
+                                              int src_stride,
+                                              const uint8_t *ref_ptr,
+                                              int ref_stride, int h,
+                                              const uint8_t *second_pred) {
+  int i;
+  __m512i sum_sad = _mm512_setzero_si512();
+  for (i = 0; i < h; i += 2) {
+    // second_pred is contiguous, so two of its rows fill one register.
+    const __m512i ref_reg =
+        _mm512_avg_epu8(loadu_2x32(ref_ptr, ref_ptr + ref_stride),
+                        _mm512_loadu_si512((const __m512i *)second_pred));
+    const __m512i src_reg = loadu_2x32(src_ptr, src_ptr + src_stride);
+    sum_sad = _mm512_add_epi32(sum_sad, _mm512_sad_epu8(ref_reg, src_reg));
+    ref_ptr += 2 * ref_stride;
+    src_ptr += 2 * src_stride;
+    second_pred += 64;
+  }
+  return sum_sad_avx512(sum_sad);
+}
+
+#define FSAD64_H(h)                                                           \
+  unsigned int vpx_sad64x##h##_avx512(const uint8_t *src_ptr, int src_stride, \
+                                      const uint8_t *ref_ptr,                 \
+                                      int ref_stride) {                       \
+    return sad64xh_avx512(src_ptr, src_stride, ref_ptr, ref_stride, h);       \
+  }
+
+#define FSADS64_H(h)                                                  \
+  unsigned int vpx_sad_skip_64x##h##_avx512(                          \
+      const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, \
+      int ref_stride) {                                               \
+    return 2 * sad64xh_avx512(src_ptr, src_stride * 2, ref_ptr,       \
+                              ref_stride * 2, h / 2);                 \
+  }
+
+#define FSAD32_H(h)                                                           \
+  unsigned int vpx_sad32x##h##_avx512(const uint8_t *src_ptr, int src_stride, \
+                                      const uint8_t *ref_ptr,                 \
+                                      int ref_stride) {                       \
+    return sad32xh_avx512(src_ptr, src_stride, ref_ptr, ref_stride, h);       \
+  }
+
+#define FSADS32_H(h)                                                  \
+  unsigned int vpx_sad_skip_32x##h##_avx512(                          \
+      const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, \
+      int ref_stride) {                                               \
+    return 2 * sad32xh_avx512(src_ptr, src_stride * 2, ref_ptr,       \
+                              ref_stride * 2, h / 2);                 \
+  }
+
+#define FSADAVG64_H(h)                                                     \
+  unsigned int vpx_sad64x##h##_avg_avx512(                                 \
+      const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr,      \
+      int ref_stride, const uint8_t *second_pred) {                        \
+    return sad64xh_avg_avx512(src_ptr, src_stride, ref_ptr, ref_stride, h, \
+                              second_pred);                                \
+  }
+
+#define FSADAVG32_H(h)                                                     \
+  unsigned int vpx_sad32x##h##_avg_avx512(                                 \
+      const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr,      \
+      int ref_stride, const uint8_t *second_pred) {                        \
+    return sad32xh_avg_avx512(src_ptr, src_stride, ref_ptr, ref_stride, h, \
+                              second_pred);                                \
+  }
+
+#define FSAD64    \
+  FSAD64_H(64)    \
+  FSAD64_H(32)    \
+  FSADS64_H(64)   \
+  FSADS64_H(32)   \
+  FSADAVG64_H(64) \
+  FSADAVG64_H(32)
+
+#define FSAD32    \
+  FSAD32_H(64)    \
+  FSAD32_H(32)    \
+  FSAD32_H(16)    \
+  FSADS32_H(64)   \
+  FSADS32_H(32)   \
+  FSADS32_H(16)   \
+  FSADAVG32_H(64) \
+  FSADAVG32_H(32) \
+  FSADAVG32_H(16)
+
+FSAD64
+FSAD32
+
+#undef FSAD64
+#undef FSAD32
+#undef FSAD64_H
+#undef FSAD32_H
+#undef FSADS64_H
+#undef FSADS32_H
+#undef FSADAVG64_H
+#undef FSADAVG32_H
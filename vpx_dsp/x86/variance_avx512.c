@@ -0,0 +1,209 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX512
+
+#include "./vpx_dsp_rtcd.h"
+
+// Loads two 32 byte rows into the low and high halves of a 512-bit register.
+static INLINE __m512i loadu_2x32(const uint8_t *p0, const uint8_t *p1) {
+  const __m256i lo = _mm256_loadu_si256((const __m256i *)p0);
+  const __m256i hi = _mm256_loadu_si256((const __m256i *)p1);
+  return _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+}
+
+// Loads 64 pixels: one row of a 64-wide block, or two rows of a 32-wide one.
+static INLINE __m512i load_rows_avx512(const uint8_t *p, int stride,
+                                       const int w) {
+  if (w == 64) return _mm512_loadu_si512((const __m512i *)p);
+  return loadu_2x32(p, p + stride);
+}
+
+static INLINE int hsum_epi32_avx512(const __m512i v) {
+  const __m256i v256 = _mm256_add_epi32(_mm512_castsi512_si256(v),
+                                        _mm512_extracti64x4_epi64(v, 1));
+  __m128i v128 = _mm_add_epi32(_mm256_castsi256_si128(v256),
+                               _mm256_extracti128_si256(v256, 1));
+  v128 = _mm_add_epi32(v128, _mm_srli_si128(v128, 8));
+  v128 = _mm_add_epi32(v128, _mm_srli_si128(v128, 4));
+  return _mm_cvtsi128_si32(v128);
+}
+
+static INLINE void variance_kernel_avx512(const __m512i src,
+                                          const __m512i ref,
+                                          __m512i *const sse,
+                                          __m512i *const sum) {
+  const __m512i adj_sub = _mm512_set1_epi16((short)0xff01);
+
+  // unpack into pairs of source and reference values
+  const __m512i src_ref0 = _mm512_unpacklo_epi8(src, ref);
+  const __m512i src_ref1 = _mm512_unpackhi_epi8(src, ref);
+
+  // subtract adjacent elements using src*1 + ref*-1
+  const __m512i diff0 = _mm512_maddubs_epi16(src_ref0, adj_sub);
+  const __m512i diff1 = _mm512_maddubs_epi16(src_ref1, adj_sub);
+  const __m512i madd0 = _mm512_madd_epi16(diff0, diff0);
+  const __m512i madd1 = _mm512_madd_epi16(diff1, diff1);
+
+  // add to the running totals. Each 16-bit lane of sum gains at most two
+  // differences per call, so up to 64 calls cannot overflow.
+  *sum = _mm512_add_epi16(*sum, _mm512_add_epi16(diff0, diff1));
+  *sse = _mm512_add_epi32(*sse, _mm512_add_epi32(madd0, madd1));
+}
+
+static INLINE void variance_final_avx512(const __m512i vsse,
+                                         const __m512i vsum,
+                                         unsigned int *const sse,
+                                         int *const sum) {
+  const __m512i vsum32 = _mm512_madd_epi16(vsum, _mm512_set1_epi16(1));
+  *sse = (unsigned int)hsum_epi32_avx512(vsse);
+  *sum = hsum_epi32_avx512(vsum32);
+}
+
+static INLINE void variance_avx512(const uint8_t *src, const int src_stride,
+                                   const uint8_t *ref, const int ref_stride,
+                                   const int w, const int h,
+                                   unsigned int *const sse, int *const sum) {
+  const int rows = 64 / w;
+  __m512i vsse = _mm512_setzero_si512();
+  __m512i vsum = _mm512_setzero_si512();
+  int i;
+
+  for (i = 0; i < h; i += rows) {
+    variance_kernel_avx512(load_rows_avx512(src, src_stride, w),
+                           load_rows_avx512(ref, ref_stride, w), &vsse, &vsum);
+    src += rows * src_stride;
+    ref += rows * ref_stride;
+  }
+  variance_final_avx512(vsse, vsum, sse, sum);
+}
+
+#define VAR_FN(w, h, shift)                                              \
+  unsigned int vpx_variance##w##x##h##_avx512(                           \
+      const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr,    \
+      int ref_stride, unsigned int *sse) {                               \
+    int sum;                                                             \
+    variance_avx512(src_ptr, src_stride, ref_ptr, ref_stride, w, h, sse, \
+                    &sum);                                               \
+    return *sse - (uint32_t)(((int64_t)sum * sum) >> (shift));           \
+  }
+
+VAR_FN(64, 64, 12)
+VAR_FN(64, 32, 11)
+VAR_FN(32, 64, 11)
+VAR_FN(32, 32, 10)
+VAR_FN(32, 16, 9)
+
+#undef VAR_FN
+
+// Returns the 2-tap filter for |offset| in the form expected by
+// _mm512_maddubs_epi16(). The taps are the C bilinear filters divided by 8.
+static INLINE __m512i bilinear_filter_avx512(int offset) {
+  return _mm512_set1_epi16((short)(((2 * offset) << 8) | (16 - 2 * offset)));
+}
+
+// Filters between a and b at |offset| eighth-pels. An offset of 0 returns a,
+// and the half-pel case reduces to a rounded average.
+static INLINE __m512i filter_avx512(const __m512i a, const __m512i b,
+                                    int offset, const __m512i filter) {
+  const __m512i pw8 = _mm512_set1_epi16(8);
+  __m512i lo, hi;
+  if (offset == 0) return a;
+  if (offset == 4) return _mm512_avg_epu8(a, b);
+  lo = _mm512_maddubs_epi16(_mm512_unpacklo_epi8(a, b), filter);
+  hi = _mm512_maddubs_epi16(_mm512_unpackhi_epi8(a, b), filter);
+  lo = _mm512_srai_epi16(_mm512_add_epi16(lo, pw8), 4);
+  hi = _mm512_srai_epi16(_mm512_add_epi16(hi, pw8), 4);
+  return _mm512_packus_epi16(lo, hi);
+}
+
+static INLINE __m512i hfilter_avx512(const uint8_t *src, int stride,
+                                     const int w, int x_offset,
+                                     const __m512i filter) {
+  const __m512i a = load_rows_avx512(src, stride, w);
+  if (x_offset == 0) return a;
+  return filter_avx512(a, load_rows_avx512(src + 1, stride, w), x_offset,
+                       filter);
+}
+
+// Computes the sub-pixel variance of a 64xh or 32xh block, processing 64
+// pixels (one or two rows) per iteration. When y_offset is non-zero the
+// horizontally filtered rows are carried over between iterations so each
+// source row is only filtered once.
+static INLINE int sub_pixel_variance_avx512(
+    const uint8_t *src, int src_stride, int x_offset, int y_offset,
+    const uint8_t *dst, int dst_stride, const uint8_t *second_pred,
+    const int w, const int h, unsigned int *sse) {
+  const int rows = 64 / w;
+  const __m512i x_filter = bilinear_filter_avx512(x_offset);
+  const __m512i y_filter = bilinear_filter_avx512(y_offset);
+  __m512i vsse = _mm512_setzero_si512();
+  __m512i vsum = _mm512_setzero_si512();
+  __m512i prev = _mm512_setzero_si512();
+  int i, sum;
+
+  if (y_offset) {
+    prev = hfilter_avx512(src, src_stride, w, x_offset, x_filter);
+    src += rows * src_stride;
+  }
+
+  for (i = 0; i < h; i += rows) {
+    // Vertical filtering reads one row past the block. On the last iteration
+    // of a 32-wide block avoid loading the row after that.
+    const int stride = (y_offset == 0 || i + rows < h) ? src_stride : 0;
+    __m512i pred = hfilter_avx512(src, stride, w, x_offset, x_filter);
+    if (y_offset) {
+      const __m512i below =
+          (w == 64) ? pred : _mm512_shuffle_i64x2(prev, pred, 0x4e);
+      const __m512i above = prev;
+      prev = pred;
+      pred = filter_avx512(above, below, y_offset, y_filter);
+    }
+    if (second_pred != NULL) {
+      pred = _mm512_avg_epu8(
+          pred, _mm512_loadu_si512((const __m512i *)second_pred));
+      second_pred += 64;
+    }
+    variance_kernel_avx512(pred, load_rows_avx512(dst, dst_stride, w), &vsse,
+                           &vsum);
+    src += rows * src_stride;
+    dst += rows * dst_stride;
+  }
+  variance_final_avx512(vsse, vsum, sse, &sum);
+  return sum;
+}
+
+#define SUBPIX_VAR_FN(w, h, shift)                                          \
+  uint32_t vpx_sub_pixel_variance##w##x##h##_avx512(                        \
+      const uint8_t *src_ptr, int src_stride, int x_offset, int y_offset,   \
+      const uint8_t *ref_ptr, int ref_stride, uint32_t *sse) {              \
+    const int se =                                                          \
+        sub_pixel_variance_avx512(src_ptr, src_stride, x_offset, y_offset,  \
+                                  ref_ptr, ref_stride, NULL, w, h, sse);    \
+    return *sse - (uint32_t)(((int64_t)se * se) >> (shift));                \
+  }                                                                         \
+                                                                            \
+  uint32_t vpx_sub_pixel_avg_variance##w##x##h##_avx512(                    \
+      const uint8_t *src_ptr, int src_stride, int x_offset, int y_offset,   \
+      const uint8_t *ref_ptr, int ref_stride, uint32_t *sse,                \
+      const uint8_t *second_pred) {                                         \
+    const int se = sub_pixel_variance_avx512(src_ptr, src_stride, x_offset, \
+                                             y_offset, ref_ptr, ref_stride, \
+                                             second_pred, w, h, sse);       \
+    return *sse - (uint32_t)(((int64_t)se * se) >> (shift));                \
+  }
+
+SUBPIX_VAR_FN(64, 64, 12)
+SUBPIX_VAR_FN(64, 32, 11)
+SUBPIX_VAR_FN(32, 64, 11)
+SUBPIX_VAR_FN(32, 32, 10)
+SUBPIX_VAR_FN(32, 16, 9)
+
+#undef SUBPIX_VAR_FN
@@ -0,0 +1,303 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX512
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/x86/convolve.h"
+#include "vpx_ports/mem.h"
+
+// The AVX-512 kernels below handle the 8-tap filters on 32 and 64 pixel wide
+// blocks, which is where the wider registers pay off. Narrower blocks and the
+// 4-tap and bilinear filters use the AVX2 versions.
+
+// Within each 128-bit lane, gathers the source pairs for taps (0, 1), (2, 3),
+// (4, 5) and (6, 7) of eight output pixels.
+DECLARE_ALIGNED(16, static const uint8_t, filt_global_avx512[4][16]) = {
+  { 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8 },
+  { 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10 },
+  { 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12 },
+  { 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14 }
+};
+
+static INLINE int use_avx512(const int16_t *filter, int w) {
+  return (w == 32 || w == 64) &&
+         (filter[0] | filter[1] | filter[6] | filter[7]);
+}
+
+static INLINE __m512i loadu_2x32(const uint8_t *p0, const uint8_t *p1) {
+  const __m256i lo = _mm256_loadu_si256((const __m256i *)p0);
+  const __m256i hi = _mm256_loadu_si256((const __m256i *)p1);
+  return _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+}
+
+static INLINE void storeu_2x32(uint8_t *p0, uint8_t *p1, const __m512i v) {
+  _mm256_storeu_si256((__m256i *)p0, _mm512_castsi512_si256(v));
+  _mm256_storeu_si256((__m256i *)p1, _mm512_extracti64x4_epi64(v, 1));
+}
+
+static INLINE void shuffle_filter_avx512(const int16_t *const filter,
+                                         __m512i *const f) {
+  const __m512i f_values =
+      _mm512_broadcast_i32x4(_mm_load_si128((const __m128i *)filter));
+  // pack and duplicate the filter values
+  f[0] = _mm512_shuffle_epi8(f_values, _mm512_set1_epi16(0x0200u));
+  f[1] = _mm512_shuffle_epi8(f_values, _mm512_set1_epi16(0x0604u));
+  f[2] = _mm512_shuffle_epi8(f_values, _mm512_set1_epi16(0x0a08u));
+  f[3] = _mm512_shuffle_epi8(f_values, _mm512_set1_epi16(0x0e0cu));
+}
+
+static INLINE __m512i convolve8_32_avx512(const __m512i *const s,
+                                          const __m512i *const f) {
+  // multiply 2 adjacent elements with the filter and add the result
+  const __m512i k_64 = _mm512_set1_epi16(1 << 6);
+  const __m512i x0 = _mm512_maddubs_epi16(s[0], f[0]);
+  const __m512i x1 = _mm512_maddubs_epi16(s[1], f[1]);
+  const __m512i x2 = _mm512_maddubs_epi16(s[2], f[2]);
+  const __m512i x3 = _mm512_maddubs_epi16(s[3], f[3]);
+  __m512i sum1, sum2;
+
+  // sum the results together, saturating only on the final step
+  // adding x0 with x2 and x1 with x3 is the only order that prevents
+  // outranges for all filters
+  sum1 = _mm512_add_epi16(x0, x2);
+  sum2 = _mm512_add_epi16(x1, x3);
+  // add the rounding offset early to avoid another saturated add
+  sum1 = _mm512_add_epi16(sum1, k_64);
+  sum1 = _mm512_adds_epi16(sum1, sum2);
+  // round and shift by 7 bit each 16 bit
+  return _mm512_srai_epi16(sum1, 7);
+}
+
+// Filters 32 pixels of a row. 128-bit lane i of the result holds the 16-bit
+// values of pixels 8 * i to 8 * i + 7.
+static INLINE __m512i convolve8_horiz_32_avx512(const uint8_t *src,
+                                                const __m512i *const f,
+                                                const __m512i *const filt) {
+  // Lane i needs the 16 bytes at src - 3 + 8 * i. Only the 39 bytes the C
+  // code reads are loaded.
+  const __m512i idx = _mm512_set_epi64(4, 3, 3, 2, 2, 1, 1, 0);
+  const __m512i data = _mm512_permutexvar_epi64(
+      idx, _mm512_maskz_loadu_epi8((__mmask64)0x7fffffffffULL, src - 3));
+  __m512i s[4];
+  s[0] = _mm512_shuffle_epi8(data, filt[0]);
+  s[1] = _mm512_shuffle_epi8(data, filt[1]);
+  s[2] = _mm512_shuffle_epi8(data, filt[2]);
+  s[3] = _mm512_shuffle_epi8(data, filt[3]);
+  return convolve8_32_avx512(s, f);
+}
+
+static INLINE void convolve8_horiz_x_avx512(const uint8_t *src,
+                                            ptrdiff_t src_stride, uint8_t *dst,
+                                            ptrdiff_t dst_stride,
+                                            const int16_t *filter, const int w,
+                                            int h, const int avg) {
+  // A 64-wide block is done one row at a time, a 32-wide block two rows at a
+  // time. Either way the second half of each output register lives at
+  // src + src_next and dst + dst_next.
+  const int rows = 64 / w;
+  const ptrdiff_t src_next = (w == 64) ? 32 : src_stride;
+  const ptrdiff_t dst_next = (w == 64) ? 32 : dst_stride;
+  // packus interleaves the two halves 8 pixels at a time; undo that.
+  const __m512i pack_idx = _mm512_set_epi64(7, 5, 3, 1, 6, 4, 2, 0);
+  __m512i f[4], filt[4];
+  int i;
+
+  shuffle_filter_avx512(filter, f);
+  filt[0] = _mm512_broadcast_i32x4(
+      _mm_load_si128((const __m128i *)filt_global_avx512[0]));
+  filt[1] = _mm512_broadcast_i32x4(
+      _mm_load_si128((const __m128i *)filt_global_avx512[1]));
+  filt[2] = _mm512_broadcast_i32x4(
+      _mm_load_si128((const __m128i *)filt_global_avx512[2]));
+  filt[3] = _mm512_broadcast_i32x4(
+      _mm_load_si128((const __m128i *)filt_global_avx512[3]));
+
+  for (i = 0; i + rows <= h; i += rows) {
+    const __m512i a = convolve8_horiz_32_avx512(src, f, filt);
+    const __m512i b = convolve8_horiz_32_avx512(src + src_next, f, filt);
+    __m512i res =
+        _mm512_permutexvar_epi64(pack_idx, _mm512_packus_epi16(a, b));
+    if (avg) res = _mm512_avg_epu8(res, loadu_2x32(dst, dst + dst_next));
+    storeu_2x32(dst, dst + dst_next, res);
+    src += rows * src_stride;
+    dst += rows * dst_stride;
+  }
+
+  // The last row of a 32-wide block with an odd height.
+  if (i < h) {
+    const __m512i a = convolve8_horiz_32_avx512(src, f, filt);
+    __m256i res = _mm512_castsi512_si256(
+        _mm512_permutexvar_epi64(pack_idx, _mm512_packus_epi16(a, a)));
+    if (avg) {
+      res = _mm256_avg_epu8(res, _mm256_loadu_si256((const __m256i *)dst));
+    }
+    _mm256_storeu_si256((__m256i *)dst, res);
+  }
+}
+
+// Loads 64 pixels: one row of a 64-wide block, or two rows of a 32-wide one.
+static INLINE __m512i load_rows_avx512(const uint8_t *p, ptrdiff_t stride,
+                                       const int w) {
+  if (w == 64) return _mm512_loadu_si512((const __m512i *)p);
+  return loadu_2x32(p, p + stride);
+}
+
+static INLINE __m512i convolve8_vert_64_avx512(const __m512i *const s,
+                                               const __m512i *const f) {
+  __m512i lo[4], hi[4];
+  lo[0] = _mm512_unpacklo_epi8(s[0], s[1]);
+  hi[0] = _mm512_unpackhi_epi8(s[0], s[1]);
+  lo[1] = _mm512_unpacklo_epi8(s[2], s[3]);
+  hi[1] = _mm512_unpackhi_epi8(s[2], s[3]);
+  lo[2] = _mm512_unpacklo_epi8(s[4], s[5]);
+  hi[2] = _mm512_unpackhi_epi8(s[4], s[5]);
+  lo[3] = _mm512_unpacklo_epi8(s[6], s[7]);
+  hi[3] = _mm512_unpackhi_epi8(s[6], s[7]);
+  return _mm512_packus_epi16(convolve8_32_avx512(lo, f),
+                             convolve8_32_avx512(hi, f));
+}
+
+static INLINE void convolve8_vert_x_avx512(const uint8_t *src,
+                                           ptrdiff_t src_stride, uint8_t *dst,
+                                           ptrdiff_t dst_stride,
+                                           const int16_t *filter, const int w,
+                                           int h, const int avg) {
+  // s[k] holds the 64 pixels starting k rows below the current output
+  // position, so every output register is a function of s[0] to s[7].
+  const int rows = 64 / w;
+  __m512i f[4], s[8];
+  int i, k;
+
+  shuffle_filter_avx512(filter, f);
+  for (k = 0; k < 8 - rows; ++k) {
+    s[k] = load_rows_avx512(src + k * src_stride, src_stride, w);
+  }
+
+  for (i = 0; i + rows <= h; i += rows) {
+    __m512i res;
+    for (k = 8 - rows; k < 8; ++k) {
+      s[k] = load_rows_avx512(src + k * src_stride, src_stride, w);
+    }
+    res = convolve8_vert_64_avx512(s, f);
+    if (avg) res = _mm512_avg_epu8(res, load_rows_avx512(dst, dst_stride, w));
+    if (w == 64) {
+      _mm512_storeu_si512((__m512i *)dst, res);
+    } else {
+      storeu_2x32(dst, dst + dst_stride, res);
+    }
+    for (k = 0; k < 8 - rows; ++k) s[k] = s[k + rows];
+    src += rows * src_stride;
+    dst += rows * dst_stride;
+  }
+
+  // The last row of a 32-wide block with an odd height. Duplicate each source
+  // row into both halves rather than reading past the 8 rows needed.
+  if (i < h) {
+    __m256i res;
+    for (k = 0; k < 8; ++k) {
+      s[k] = loadu_2x32(src + k * src_stride, src + k * src_stride);
+    }
+    res = _mm512_castsi512_si256(convolve8_vert_64_avx512(s, f));
+    if (avg) {
+      res = _mm256_avg_epu8(res, _mm256_loadu_si256((const __m256i *)dst));
+    }
+    _mm256_storeu_si256((__m256i *)dst, res);
+  }
+}
+
+void vpx_convolve8_horiz_avx512(const uint8_t *src, ptrdiff_t src_stride,
+                                uint8_t *dst, ptrdiff_t dst_stride,
+                                const InterpKernel *filter, int x0_q4,
+                                int x_step_q4, int y0_q4, int y_step_q4,
+                                int w, int h) {
+  const int16_t *filter_row = filter[x0_q4];
+  assert(x_step_q4 == 16);
+  if (!use_avx512(filter_row, w)) {
+    vpx_convolve8_horiz_avx2(src, src_stride, dst, dst_stride, filter, x0_q4,
+                             x_step_q4, y0_q4, y_step_q4, w, h);
+  } else if (w == 64) {
+    convolve8_horiz_x_avx512(src, src_stride, dst, dst_stride, filter_row, 64,
+                             h, 0);
+  } else {
+    convolve8_horiz_x_avx512(src, src_stride, dst, dst_stride, filter_row, 32,
+                             h, 0);
+  }
+}
+
+void vpx_convolve8_avg_horiz_avx512(const uint8_t *src, ptrdiff_t src_stride,
+                                    uint8_t *dst, ptrdiff_t dst_stride,
+                                    const InterpKernel *filter, int x0_q4,
+                                    int x_step_q4, int y0_q4, int y_step_q4,
+                                    int w, int h) {
+  const int16_t *filter_row = filter[x0_q4];
+  assert(x_step_q4 == 16);
+  if (!use_avx512(filter_row, w)) {
+    vpx_convolve8_avg_horiz_avx2(src, src_stride, dst, dst_stride, filter,
+                                 x0_q4, x_step_q4, y0_q4, y_step_q4, w, h);
+  } else if (w == 64) {
+    convolve8_horiz_x_avx512(src, src_stride, dst, dst_stride, filter_row, 64,
+                             h, 1);
+  } else {
+    convolve8_horiz_x_avx512(src, src_stride, dst, dst_stride, filter_row, 32,
+                             h, 1);
+  }
+}
+
+void vpx_convolve8_vert_avx512(const uint8_t *src, ptrdiff_t src_stride,
+                               uint8_t *dst, ptrdiff_t dst_stride,
+                               const InterpKernel *filter, int x0_q4,
+                               int x_step_q4, int y0_q4, int y_step_q4, int w,
+                               int h) {
+  const int16_t *filter_row = filter[y0_q4];
+  assert(y_step_q4 == 16);
+  if (!use_avx512(filter_row, w)) {
+    vpx_convolve8_vert_avx2(src, src_stride, dst, dst_stride, filter, x0_q4,
+                            x_step_q4, y0_q4, y_step_q4, w, h);
+  } else if (w == 64) {
+    convolve8_vert_x_avx512(src - 3 * src_stride, src_stride, dst, dst_stride,
+                            filter_row, 64, h, 0);
+  } else {
+    convolve8_vert_x_avx512(src - 3 * src_stride, src_stride, dst, dst_stride,
+                            filter_row, 32, h, 0);
+  }
+}
+
+void vpx_convolve8_avg_vert_avx512(const uint8_t *src, ptrdiff_t src_stride,
+                                   uint8_t *dst, ptrdiff_t dst_stride,
+                                   const InterpKernel *filter, int x0_q4,
+                                   int x_step_q4, int y0_q4, int y_step_q4,
+                                   int w, int h) {
+  const int16_t *filter_row = filter[y0_q4];
+  assert(y_step_q4 == 16);
+  if (!use_avx512(filter_row, w)) {
+    vpx_convolve8_avg_vert_avx2(src, src_stride, dst, dst_stride, filter,
+                                x0_q4, x_step_q4, y0_q4, y_step_q4, w, h);
+  } else if (w == 64) {
+    convolve8_vert_x_avx512(src - 3 * src_stride, src_stride, dst, dst_stride,
+                            filter_row, 64, h, 1);
+  } else {
+    convolve8_vert_x_avx512(src - 3 * src_stride, src_stride, dst, dst_stride,
+                            filter_row, 32, h, 1);
+  }
+}
+
+// void vpx_convolve8_avx512(const uint8_t *src, ptrdiff_t src_stride,
+//                           uint8_t *dst, ptrdiff_t dst_stride,
+//                           const InterpKernel *filter, int x0_q4,
+//                           int32_t x_step_q4, int y0_q4, int y_step_q4,
+//                           int w, int h);
+// void vpx_convolve8_avg_avx512(const uint8_t *src, ptrdiff_t src_stride,
+//                               uint8_t *dst, ptrdiff_t dst_stride,
+//                               const InterpKernel *filter, int x0_q4,
+//                               int32_t x_step_q4, int y0_q4, int y_step_q4,
+//                               int w, int h);
+FUN_CONV_2D(, avx512, 0)
+FUN_CONV_2D(avg_, avx512, 1)
@@ -166,7 +166,14 @@ static INLINE uint64_t xgetbv(void) {
 
 static INLINE int x86_simd_caps(void) {
   unsigned int flags = 0;
+#if CONFIG_PREFER_AVX2
+  // Skip the AVX-512 kernels by default; parts that throttle their clock when
+  // running 512-bit instructions are usually faster with the AVX2 versions.
+  // VPX_SIMD_CAPS and VPX_SIMD_CAPS_MASK still take precedence.
+  unsigned int mask = ~(unsigned int)HAS_AVX512;
+#else
   unsigned int mask = ~0u;
+#endif
   unsigned int max_cpuid_val, reg_eax, reg_ebx, reg_ecx, reg_edx;
   char *env;
   (void)reg_ebx;
@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <arm_neon.h>
+#include <string.h>
+
+#include "./vpx_config.h"
+#include "./vpx_scale_rtcd.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+#include "vpx_scale/yv12config.h"
+#include "vpx_scale/yv12extend.h"
+
+// Writes 'n' bytes of the repeated pattern 'v' to 'dst'. The overlapping last
+// store keeps the pattern phase as 'n' is a multiple of the sample size.
+static INLINE void fill_row(uint8_t *dst, uint8x16_t v, int n) {
+  int i;
+  if (n < 16) {
+    uint8_t tmp[16];
+    vst1q_u8(tmp, v);
+    memcpy(dst, tmp, n);
+    return;
+  }
+  for (i = 0; i + 16 <= n; i += 16) vst1q_u8(dst + i, v);
+  if (i < n) vst1q_u8(dst + n - 16, v);
+}
+
+static INLINE void copy_row(uint8_t *dst, const uint8_t *src, int n) {
+  int i;
+  if (n < 16) {
+    memcpy(dst, src, n);
+    return;
+  }
+  for (i = 0; i + 64 <= n; i += 64) {
+    const uint8x16_t s0 = vld1q_u8(src + i + 0);
+    const uint8x16_t s1 = vld1q_u8(src + i + 16);
+    const uint8x16_t s2 = vld1q_u8(src + i + 32);
+    const uint8x16_t s3 = vld1q_u8(src + i + 48);
+    vst1q_u8(dst + i + 0, s0);
+    vst1q_u8(dst + i + 16, s1);
+    vst1q_u8(dst + i + 32, s2);
+    vst1q_u8(dst + i + 48, s3);
+  }
+  for (; i + 16 <= n; i += 16) vst1q_u8(dst + i, vld1q_u8(src + i));
+  if (i < n) vst1q_u8(dst + n - 16, vld1q_u8(src + n - 16));
+}
+
+// Extends a plane, 'bytes_per_sample' is 2 for high bitdepth planes and all
+// the sizes are in samples.
+static INLINE void extend_plane_neon(uint8_t *const src, int src_stride,
+                                     int width, int height, int extend_top,
+                                     int extend_left, int extend_bottom,
+                                     int extend_right, int bytes_per_sample) {
+  const int stride = src_stride * bytes_per_sample;
+  const int left = extend_left * bytes_per_sample;
+  const int right = extend_right * bytes_per_sample;
+  const int linesize = left + width * bytes_per_sample + right;
+  uint8_t *row = src;
+  uint8_t *top_src, *bot_src, *dst;
+  int i;
+
+  // Copy the left and right most columns out.
+  for (i = 0; i < height; ++i) {
+    uint8_t *const end = row + (width - 1) * bytes_per_sample;
+    if (bytes_per_sample == 1) {
+      fill_row(row - left, vdupq_n_u8(row[0]), left);
+      fill_row(end + 1, vdupq_n_u8(end[0]), right);
+    } else {
+      const uint16_t l = ((const uint16_t *)row)[0];
+      const uint16_t r = ((const uint16_t *)end)[0];
+      fill_row(row - left, vreinterpretq_u8_u16(vdupq_n_u16(l)), left);
+      fill_row(end + 2, vreinterpretq_u8_u16(vdupq_n_u16(r)), right);
+    }
+    row += stride;
+  }
+
+  // Now copy the top and bottom lines into each line of the respective
+  // borders.
+  top_src = src - left;
+  bot_src = src + stride * (height - 1) - left;
+  dst = top_src - stride * extend_top;
+  for (i = 0; i < extend_top; ++i, dst += stride)
+    copy_row(dst, top_src, linesize);
+  dst = bot_src + stride;
+  for (i = 0; i < extend_bottom; ++i, dst += stride)
+    copy_row(dst, bot_src, linesize);
+}
+
+static void extend_plane(uint8_t *const src, int src_stride, int width,
+                         int height, int extend_top, int extend_left,
+                         int extend_bottom, int extend_right) {
+  extend_plane_neon(src, src_stride, width, height, extend_top, extend_left,
+                    extend_bottom, extend_right, 1);
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+static void extend_plane_high(uint8_t *const src8, int src_stride, int width,
+                              int height, int extend_top, int extend_left,
+                              int extend_bottom, int extend_right) {
+  extend_plane_neon((uint8_t *)CONVERT_TO_SHORTPTR(src8), src_stride, width,
+                    height, extend_top, extend_left, extend_bottom,
+                    extend_right, 2);
+}
+#define EXTEND_PLANE_HIGH extend_plane_high
+#else
+#define EXTEND_PLANE_HIGH NULL
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+static void copy_plane(const uint8_t *src, int src_stride, uint8_t *dst,
+                       int dst_stride, int width_in_bytes, int height) {
+  int row;
+  for (row = 0; row < height; ++row) {
+    copy_row(dst, src, width_in_bytes);
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
+
+void vp8_yv12_extend_frame_borders_neon(YV12_BUFFER_CONFIG *ybf) {
+  yv12_extend_frame_borders(ybf, extend_plane);
+}
+
+void vp8_yv12_copy_frame_neon(const YV12_BUFFER_CONFIG *src_ybc,
+                              YV12_BUFFER_CONFIG *dst_ybc) {
+  yv12_copy_frame(src_ybc, dst_ybc, copy_plane);
+  vp8_yv12_extend_frame_borders_neon(dst_ybc);
+}
+
+#if CONFIG_VP9
+void vpx_extend_frame_borders_neon(YV12_BUFFER_CONFIG *ybf) {
+  yv12_extend_frame(ybf, ybf->border, extend_plane, EXTEND_PLANE_HIGH);
+}
+
+void vpx_extend_frame_inner_borders_neon(YV12_BUFFER_CONFIG *ybf) {
+  yv12_extend_frame(ybf, yv12_inner_border(ybf), extend_plane,
+                    EXTEND_PLANE_HIGH);
+}
+
+void vpx_yv12_copy_frame_neon(const YV12_BUFFER_CONFIG *src_ybc,
+                              YV12_BUFFER_CONFIG *dst_ybc) {
+  yv12_copy_frame(src_ybc, dst_ybc, copy_plane);
+  vpx_extend_frame_borders_neon(dst_ybc);
+}
+#endif  // CONFIG_VP9
@@ -172,16 +172,22 @@ int vpx_realloc_frame_buffer(YV12_BUFFER_CONFIG *ybf, int width, int height,
     const int vp9_byte_align = (byte_alignment == 0) ? 1 : byte_alignment;
     const int aligned_width = (width + 7) & ~7;
     const int aligned_height = (height + 7) & ~7;
-    const int y_stride = ((aligned_width + 2 * border) + 31) & ~31;
+    // Without a border the planes are padded to the 64x64 superblock grid
+    // instead, as the decoder writes the partially visible blocks at the
+    // right and bottom edges in full.
+    const int alloc_width = border ? aligned_width : (width + 63) & ~63;
+    const int alloc_height = border ? aligned_height : (height + 63) & ~63;
+    const int y_stride = ((alloc_width + 2 * border) + 31) & ~31;
     const uint64_t yplane_size =
-        (aligned_height + 2 * border) * (uint64_t)y_stride + byte_alignment;
+        (alloc_height + 2 * border) * (uint64_t)y_stride + byte_alignment;
     const int uv_width = aligned_width >> ss_x;
     const int uv_height = aligned_height >> ss_y;
     const int uv_stride = y_stride >> ss_x;
     const int uv_border_w = border >> ss_x;
     const int uv_border_h = border >> ss_y;
     const uint64_t uvplane_size =
-        (uv_height + 2 * uv_border_h) * (uint64_t)uv_stride + byte_alignment;
+        ((alloc_height >> ss_y) + 2 * uv_border_h) * (uint64_t)uv_stride +
+        byte_alignment;
 
 #if CONFIG_VP9_HIGHBITDEPTH
     const uint64_t frame_size =
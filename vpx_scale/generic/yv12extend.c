@@ -15,6 +15,7 @@
 #include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/mem.h"
 #include "vpx_scale/yv12config.h"
+#include "vpx_scale/yv12extend.h"
 #if CONFIG_VP9_HIGHBITDEPTH
 #include "vp9/common/vp9_common.h"
 #endif
@@ -103,88 +104,35 @@ static void extend_plane_high(uint8_t *const src8, int src_stride, int width,
 #endif
 
 void vp8_yv12_extend_frame_borders_c(YV12_BUFFER_CONFIG *ybf) {
-  const int uv_border = ybf->border / 2;
-
-  assert(ybf->border % 2 == 0);
-  assert(ybf->y_height - ybf->y_crop_height < 16);
-  assert(ybf->y_width - ybf->y_crop_width < 16);
-  assert(ybf->y_height - ybf->y_crop_height >= 0);
-  assert(ybf->y_width - ybf->y_crop_width >= 0);
-
-  extend_plane(ybf->y_buffer, ybf->y_stride, ybf->y_crop_width,
-               ybf->y_crop_height, ybf->border, ybf->border,
-               ybf->border + ybf->y_height - ybf->y_crop_height,
-               ybf->border + ybf->y_width - ybf->y_crop_width);
-
-  extend_plane(ybf->u_buffer, ybf->uv_stride, ybf->uv_crop_width,
-               ybf->uv_crop_height, uv_border, uv_border,
-               uv_border + ybf->uv_height - ybf->uv_crop_height,
-               uv_border + ybf->uv_width - ybf->uv_crop_width);
-
-  extend_plane(ybf->v_buffer, ybf->uv_stride, ybf->uv_crop_width,
-               ybf->uv_crop_height, uv_border, uv_border,
-               uv_border + ybf->uv_height - ybf->uv_crop_height,
-               uv_border + ybf->uv_width - ybf->uv_crop_width);
+  yv12_extend_frame_borders(ybf, extend_plane);
 }
 
 #if CONFIG_VP9
-static void extend_frame(YV12_BUFFER_CONFIG *const ybf, int ext_size) {
-  const int c_w = ybf->uv_crop_width;
-  const int c_h = ybf->uv_crop_height;
-  const int ss_x = ybf->uv_width < ybf->y_width;
-  const int ss_y = ybf->uv_height < ybf->y_height;
-  const int c_et = ext_size >> ss_y;
-  const int c_el = ext_size >> ss_x;
-  const int c_eb = c_et + ybf->uv_height - ybf->uv_crop_height;
-  const int c_er = c_el + ybf->uv_width - ybf->uv_crop_width;
-
-  assert(ybf->y_height - ybf->y_crop_height < 16);
-  assert(ybf->y_width - ybf->y_crop_width < 16);
-  assert(ybf->y_height - ybf->y_crop_height >= 0);
-  assert(ybf->y_width - ybf->y_crop_width >= 0);
-
 #if CONFIG_VP9_HIGHBITDEPTH
-  if (ybf->flags & YV12_FLAG_HIGHBITDEPTH) {
-    extend_plane_high(ybf->y_buffer, ybf->y_stride, ybf->y_crop_width,
-                      ybf->y_crop_height, ext_size, ext_size,
-                      ext_size + ybf->y_height - ybf->y_crop_height,
-                      ext_size + ybf->y_width - ybf->y_crop_width);
-    extend_plane_high(ybf->u_buffer, ybf->uv_stride, c_w, c_h, c_et, c_el, c_eb,
-                      c_er);
-    extend_plane_high(ybf->v_buffer, ybf->uv_stride, c_w, c_h, c_et, c_el, c_eb,
-                      c_er);
-    return;
-  }
+#define EXTEND_PLANE_HIGH extend_plane_high
+#else
+#define EXTEND_PLANE_HIGH NULL
 #endif
-  extend_plane(ybf->y_buffer, ybf->y_stride, ybf->y_crop_width,
-               ybf->y_crop_height, ext_size, ext_size,
-               ext_size + ybf->y_height - ybf->y_crop_height,
-               ext_size + ybf->y_width - ybf->y_crop_width);
-
-  extend_plane(ybf->u_buffer, ybf->uv_stride, c_w, c_h, c_et, c_el, c_eb, c_er);
-
-  extend_plane(ybf->v_buffer, ybf->uv_stride, c_w, c_h, c_et, c_el, c_eb, c_er);
-}
 
 void vpx_extend_frame_borders_c(YV12_BUFFER_CONFIG *ybf) {
-  extend_frame(ybf, ybf->border);
+  yv12_extend_frame(ybf, ybf->border, extend_plane, EXTEND_PLANE_HIGH);
 }
 
 void vpx_extend_frame_inner_borders_c(YV12_BUFFER_CONFIG *ybf) {
-  const int inner_bw = (ybf->border > VP9INNERBORDERINPIXELS)
-                           ? VP9INNERBORDERINPIXELS
-                           : ybf->border;
-  extend_frame(ybf, inner_bw);
+  yv12_extend_frame(ybf, yv12_inner_border(ybf), extend_plane,
+                    EXTEND_PLANE_HIGH);
 }
+#endif  // CONFIG_VP9
 
-#if CONFIG_VP9_HIGHBITDEPTH
-static void memcpy_short_addr(uint8_t *dst8, const uint8_t *src8, int num) {
-  uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
-  uint16_t *src = CONVERT_TO_SHORTPTR(src8);
-  memcpy(dst, src, num * sizeof(uint16_t));
+static void copy_plane(const uint8_t *src, int src_stride, uint8_t *dst,
+                       int dst_stride, int width_in_bytes, int height) {
+  int row;
+  for (row = 0; row < height; ++row) {
+    memcpy(dst, src, width_in_bytes);
+    src += src_stride;
+    dst += dst_stride;
+  }
 }
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-#endif  // CONFIG_VP9
 
 // Copies the source image into the destination image and updates the
 // destination's UMV borders.
@@ -192,118 +140,14 @@ static void memcpy_short_addr(uint8_t *dst8, const uint8_t *src8, int num) {
 
 void vp8_yv12_copy_frame_c(const YV12_BUFFER_CONFIG *src_ybc,
                            YV12_BUFFER_CONFIG *dst_ybc) {
-  int row;
-  const uint8_t *src = src_ybc->y_buffer;
-  uint8_t *dst = dst_ybc->y_buffer;
-
-#if 0
-  /* These assertions are valid in the codec, but the libvpx-tester uses
-   * this code slightly differently.
-   */
-  assert(src_ybc->y_width == dst_ybc->y_width);
-  assert(src_ybc->y_height == dst_ybc->y_height);
-#endif
-
-  for (row = 0; row < src_ybc->y_height; ++row) {
-    memcpy(dst, src, src_ybc->y_width);
-    src += src_ybc->y_stride;
-    dst += dst_ybc->y_stride;
-  }
-
-  src = src_ybc->u_buffer;
-  dst = dst_ybc->u_buffer;
-
-  for (row = 0; row < src_ybc->uv_height; ++row) {
-    memcpy(dst, src, src_ybc->uv_width);
-    src += src_ybc->uv_stride;
-    dst += dst_ybc->uv_stride;
-  }
-
-  src = src_ybc->v_buffer;
-  dst = dst_ybc->v_buffer;
-
-  for (row = 0; row < src_ybc->uv_height; ++row) {
-    memcpy(dst, src, src_ybc->uv_width);
-    src += src_ybc->uv_stride;
-    dst += dst_ybc->uv_stride;
-  }
-
+  yv12_copy_frame(src_ybc, dst_ybc, copy_plane);
   vp8_yv12_extend_frame_borders_c(dst_ybc);
 }
 
 #if CONFIG_VP9
 void vpx_yv12_copy_frame_c(const YV12_BUFFER_CONFIG *src_ybc,
                            YV12_BUFFER_CONFIG *dst_ybc) {
-  int row;
-  const uint8_t *src = src_ybc->y_buffer;
-  uint8_t *dst = dst_ybc->y_buffer;
-
-#if 0
-  /* These assertions are valid in the codec, but the libvpx-tester uses
-   * this code slightly differently.
-   */
-  assert(src_ybc->y_width == dst_ybc->y_width);
-  assert(src_ybc->y_height == dst_ybc->y_height);
-#endif
-
-#if CONFIG_VP9_HIGHBITDEPTH
-  if (src_ybc->flags & YV12_FLAG_HIGHBITDEPTH) {
-    assert(dst_ybc->flags & YV12_FLAG_HIGHBITDEPTH);
-    for (row = 0; row < src_ybc->y_height; ++row) {
-      memcpy_short_addr(dst, src, src_ybc->y_width);
-      src += src_ybc->y_stride;
-      dst += dst_ybc->y_stride;
-    }
-
-    src = src_ybc->u_buffer;
-    dst = dst_ybc->u_buffer;
-
-    for (row = 0; row < src_ybc->uv_height; ++row) {
-      memcpy_short_addr(dst, src, src_ybc->uv_width);
-      src += src_ybc->uv_stride;
-      dst += dst_ybc->uv_stride;
-    }
-
-    src = src_ybc->v_buffer;
-    dst = dst_ybc->v_buffer;
-
-    for (row = 0; row < src_ybc->uv_height; ++row) {
-      memcpy_short_addr(dst, src, src_ybc->uv_width);
-      src += src_ybc->uv_stride;
-      dst += dst_ybc->uv_stride;
-    }
-
-    vpx_extend_frame_borders_c(dst_ybc);
-    return;
-  } else {
-    assert(!(dst_ybc->flags & YV12_FLAG_HIGHBITDEPTH));
-  }
-#endif
-
-  for (row = 0; row < src_ybc->y_height; ++row) {
-    memcpy(dst, src, src_ybc->y_width);
-    src += src_ybc->y_stride;
-    dst += dst_ybc->y_stride;
-  }
-
-  src = src_ybc->u_buffer;
-  dst = dst_ybc->u_buffer;
-
-  for (row = 0; row < src_ybc->uv_height; ++row) {
-    memcpy(dst, src, src_ybc->uv_width);
-    src += src_ybc->uv_stride;
-    dst += dst_ybc->uv_stride;
-  }
-
-  src = src_ybc->v_buffer;
-  dst = dst_ybc->v_buffer;
-
-  for (row = 0; row < src_ybc->uv_height; ++row) {
-    memcpy(dst, src, src_ybc->uv_width);
-    src += src_ybc->uv_stride;
-    dst += dst_ybc->uv_stride;
-  }
-
+  yv12_copy_frame(src_ybc, dst_ybc, copy_plane);
   vpx_extend_frame_borders_c(dst_ybc);
 }
 #endif  // CONFIG_VP9
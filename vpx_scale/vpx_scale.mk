@@ -4,6 +4,7 @@ SCALE_SRCS-$(CONFIG_SPATIAL_RESAMPLING) += vpx_scale.h
 SCALE_SRCS-$(CONFIG_SPATIAL_RESAMPLING) += generic/vpx_scale.c
 SCALE_SRCS-yes += generic/yv12config.c
 SCALE_SRCS-yes += generic/yv12extend.c
+SCALE_SRCS-yes += yv12extend.h
 SCALE_SRCS-$(CONFIG_SPATIAL_RESAMPLING) += generic/gen_scalers.c
 SCALE_SRCS-yes += vpx_scale_rtcd.c
 SCALE_SRCS-yes += vpx_scale_rtcd.pl
@@ -11,6 +12,13 @@ SCALE_SRCS-yes += vpx_scale_rtcd.pl
 #mips(dspr2)
 SCALE_SRCS-$(HAVE_DSPR2)  += mips/dspr2/yv12extend_dspr2.c
 
+#x86
+SCALE_SRCS-$(HAVE_SSE2) += x86/yv12extend_sse2.c
+SCALE_SRCS-$(HAVE_AVX2) += x86/yv12extend_avx2.c
+
+#arm
+SCALE_SRCS-$(HAVE_NEON) += arm/neon/yv12extend_neon.c
+
 SCALE_SRCS-no += $(SCALE_SRCS_REMOVE-yes)
 
 $(eval $(call rtcd_h_template,vpx_scale_rtcd,vpx_scale/vpx_scale_rtcd.pl))
@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>  // SSE2
+#include <string.h>
+
+#include "./vpx_config.h"
+#include "./vpx_scale_rtcd.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+#include "vpx_scale/yv12config.h"
+#include "vpx_scale/yv12extend.h"
+
+// Top and bottom borders larger than this are written with non-temporal
+// stores. They do not fit in the cache next to the frame and are only read
+// back when motion vectors point outside the frame.
+#define NON_TEMPORAL_MIN_BYTES (1 << 19)
+
+// Writes 'n' bytes of the repeated pattern 'v' to 'dst'. The overlapping last
+// store keeps the pattern phase as 'n' is a multiple of the sample size.
+static INLINE void fill_row(uint8_t *dst, __m128i v, int n) {
+  int i;
+  if (n < 16) {
+    DECLARE_ALIGNED(16, uint8_t, tmp[16]);
+    _mm_store_si128((__m128i *)tmp, v);
+    memcpy(dst, tmp, n);
+    return;
+  }
+  for (i = 0; i + 16 <= n; i += 16) _mm_storeu_si128((__m128i *)(dst + i), v);
+  if (i < n) _mm_storeu_si128((__m128i *)(dst + n - 16), v);
+}
+
+static INLINE void copy_row(uint8_t *dst, const uint8_t *src, int n) {
+  int i;
+  if (n < 16) {
+    memcpy(dst, src, n);
+    return;
+  }
+  for (i = 0; i + 16 <= n; i += 16) {
+    _mm_storeu_si128((__m128i *)(dst + i),
+                     _mm_loadu_si128((const __m128i *)(src + i)));
+  }
+  if (i < n) {
+    _mm_storeu_si128((__m128i *)(dst + n - 16),
+                     _mm_loadu_si128((const __m128i *)(src + n - 16)));
+  }
+}
+
+static INLINE void copy_row_nt(uint8_t *dst, const uint8_t *src, int n) {
+  const int head = (int)(-(intptr_t)dst & 15);
+  int i;
+  if (n < 32) {
+    copy_row(dst, src, n);
+    return;
+  }
+  _mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+  for (i = head; i + 16 <= n; i += 16) {
+    _mm_stream_si128((__m128i *)(dst + i),
+                     _mm_loadu_si128((const __m128i *)(src + i)));
+  }
+  if (i < n) {
+    _mm_storeu_si128((__m128i *)(dst + n - 16),
+                     _mm_loadu_si128((const __m128i *)(src + n - 16)));
+  }
+}
+
+// Extends a plane, 'bytes_per_sample' is 2 for high bitdepth planes and all
+// the sizes are in samples.
+static INLINE void extend_plane_sse2(uint8_t *const src, int src_stride,
+                                     int width, int height, int extend_top,
+                                     int extend_left, int extend_bottom,
+                                     int extend_right, int bytes_per_sample) {
+  const int stride = src_stride * bytes_per_sample;
+  const int left = extend_left * bytes_per_sample;
+  const int right = extend_right * bytes_per_sample;
+  const int linesize = left + width * bytes_per_sample + right;
+  uint8_t *row = src;
+  uint8_t *top_src, *bot_src, *dst;
+  int i;
+
+  // Copy the left and right most columns out.
+  for (i = 0; i < height; ++i) {
+    uint8_t *const end = row + (width - 1) * bytes_per_sample;
+    if (bytes_per_sample == 1) {
+      fill_row(row - left, _mm_set1_epi8((char)row[0]), left);
+      fill_row(end + 1, _mm_set1_epi8((char)end[0]), right);
+    } else {
+      fill_row(row - left, _mm_set1_epi16(((const int16_t *)row)[0]), left);
+      fill_row(end + 2, _mm_set1_epi16(((const int16_t *)end)[0]), right);
+    }
+    row += stride;
+  }
+
+  // Now copy the top and bottom lines into each line of the respective
+  // borders.
+  top_src = src - left;
+  bot_src = src + stride * (height - 1) - left;
+  if (linesize * (extend_top + extend_bottom) >= NON_TEMPORAL_MIN_BYTES) {
+    dst = top_src - stride * extend_top;
+    for (i = 0; i < extend_top; ++i, dst += stride)
+      copy_row_nt(dst, top_src, linesize);
+    dst = bot_src + stride;
+    for (i = 0; i < extend_bottom; ++i, dst += stride)
+      copy_row_nt(dst, bot_src, linesize);
+    _mm_sfence();
+  } else {
+    dst = top_src - stride * extend_top;
+    for (i = 0; i < extend_top; ++i, dst += stride)
+      copy_row(dst, top_src, linesize);
+    dst = bot_src + stride;
+    for (i = 0; i < extend_bottom; ++i, dst += stride)
+      copy_row(dst, bot_src, linesize);
+  }
+}
+
+static void extend_plane(uint8_t *const src, int src_stride, int width,
+                         int height, int extend_top, int extend_left,
+                         int extend_bottom, int extend_right) {
+  extend_plane_sse2(src, src_stride, width, height, extend_top, extend_left,
+                    extend_bottom, extend_right, 1);
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+static void extend_plane_high(uint8_t *const src8, int src_stride, int width,
+                              int height, int extend_top, int extend_left,
+                              int extend_bottom, int extend_right) {
+  extend_plane_sse2((uint8_t *)CONVERT_TO_SHORTPTR(src8), src_stride, width,
+                    height, extend_top, extend_left, extend_bottom,
+                    extend_right, 2);
+}
+#define EXTEND_PLANE_HIGH extend_plane_high
+#else
+#define EXTEND_PLANE_HIGH NULL
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+static void copy_plane(const uint8_t *src, int src_stride, uint8_t *dst,
+                       int dst_stride, int width_in_bytes, int height) {
+  int row;
+  for (row = 0; row < height; ++row) {
+    copy_row(dst, src, width_in_bytes);
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
+
+void vp8_yv12_extend_frame_borders_sse2(YV12_BUFFER_CONFIG *ybf) {
+  yv12_extend_frame_borders(ybf, extend_plane);
+}
+
+void vp8_yv12_copy_frame_sse2(const YV12_BUFFER_CONFIG *src_ybc,
+                              YV12_BUFFER_CONFIG *dst_ybc) {
+  yv12_copy_frame(src_ybc, dst_ybc, copy_plane);
+  vp8_yv12_extend_frame_borders_sse2(dst_ybc);
+}
+
+#if CONFIG_VP9
+void vpx_extend_frame_borders_sse2(YV12_BUFFER_CONFIG *ybf) {
+  yv12_extend_frame(ybf, ybf->border, extend_plane, EXTEND_PLANE_HIGH);
+}
+
+void vpx_extend_frame_inner_borders_sse2(YV12_BUFFER_CONFIG *ybf) {
+  yv12_extend_frame(ybf, yv12_inner_border(ybf), extend_plane,
+                    EXTEND_PLANE_HIGH);
+}
+
+void vpx_yv12_copy_frame_sse2(const YV12_BUFFER_CONFIG *src_ybc,
+                              YV12_BUFFER_CONFIG *dst_ybc) {
+  yv12_copy_frame(src_ybc, dst_ybc, copy_plane);
+  vpx_extend_frame_borders_sse2(dst_ybc);
+}
+#endif  // CONFIG_VP9
@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VPX_SCALE_YV12EXTEND_H_
+#define VPX_VPX_SCALE_YV12EXTEND_H_
+
+#include <assert.h>
+
+#include "./vpx_config.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+#include "vpx_scale/yv12config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Frame level helpers shared by the C and SIMD versions of the border
+// extension and frame copy functions. Each version only provides the plane
+// level kernels.
+
+// Replicates the outermost pixels of the 'width' x 'height' plane at 'src'
+// into the given number of border pixels on each side. For high bitdepth
+// planes 'src' is the CONVERT_TO_BYTEPTR() address of the samples.
+typedef void (*extend_plane_fn_t)(uint8_t *const src, int src_stride,
+                                  int width, int height, int extend_top,
+                                  int extend_left, int extend_bottom,
+                                  int extend_right);
+
+// Copies 'height' rows of 'width_in_bytes' bytes.
+typedef void (*copy_plane_fn_t)(const uint8_t *src, int src_stride,
+                                uint8_t *dst, int dst_stride,
+                                int width_in_bytes, int height);
+
+static INLINE void yv12_extend_frame_borders(YV12_BUFFER_CONFIG *ybf,
+                                             extend_plane_fn_t extend_plane) {
+  const int uv_border = ybf->border / 2;
+
+  assert(ybf->border % 2 == 0);
+  assert(ybf->y_height - ybf->y_crop_height < 16);
+  assert(ybf->y_width - ybf->y_crop_width < 16);
+  assert(ybf->y_height - ybf->y_crop_height >= 0);
+  assert(ybf->y_width - ybf->y_crop_width >= 0);
+
+  extend_plane(ybf->y_buffer, ybf->y_stride, ybf->y_crop_width,
+               ybf->y_crop_height, ybf->border, ybf->border,
+               ybf->border + ybf->y_height - ybf->y_crop_height,
+               ybf->border + ybf->y_width - ybf->y_crop_width);
+
+  extend_plane(ybf->u_buffer, ybf->uv_stride, ybf->uv_crop_width,
+               ybf->uv_crop_height, uv_border, uv_border,
+               uv_border + ybf->uv_height - ybf->uv_crop_height,
+               uv_border + ybf->uv_width - ybf->uv_crop_width);
+
+  extend_plane(ybf->v_buffer, ybf->uv_stride, ybf->uv_crop_width,
+               ybf->uv_crop_height, uv_border, uv_border,
+               uv_border + ybf->uv_height - ybf->uv_crop_height,
+               uv_border + ybf->uv_width - ybf->uv_crop_width);
+}
+
+static INLINE void yv12_copy_frame(const YV12_BUFFER_CONFIG *src_ybc,
+                                   YV12_BUFFER_CONFIG *dst_ybc,
+                                   copy_plane_fn_t copy_plane) {
+  const uint8_t *src_y = src_ybc->y_buffer;
+  const uint8_t *src_u = src_ybc->u_buffer;
+  const uint8_t *src_v = src_ybc->v_buffer;
+  uint8_t *dst_y = dst_ybc->y_buffer;
+  uint8_t *dst_u = dst_ybc->u_buffer;
+  uint8_t *dst_v = dst_ybc->v_buffer;
+  int bytes_per_sample = 1;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (src_ybc->flags & YV12_FLAG_HIGHBITDEPTH) {
+    assert(dst_ybc->flags & YV12_FLAG_HIGHBITDEPTH);
+    src_y = (const uint8_t *)CONVERT_TO_SHORTPTR(src_y);
+    src_u = (const uint8_t *)CONVERT_TO_SHORTPTR(src_u);
+    src_v = (const uint8_t *)CONVERT_TO_SHORTPTR(src_v);
+    dst_y = (uint8_t *)CONVERT_TO_SHORTPTR(dst_y);
+    dst_u = (uint8_t *)CONVERT_TO_SHORTPTR(dst_u);
+    dst_v = (uint8_t *)CONVERT_TO_SHORTPTR(dst_v);
+    bytes_per_sample = 2;
+  } else {
+    assert(!(dst_ybc->flags & YV12_FLAG_HIGHBITDEPTH));
+  }
+#endif
+
+  copy_plane(src_y, src_ybc->y_stride * bytes_per_sample, dst_y,
+             dst_ybc->y_stride * bytes_per_sample,
+             src_ybc->y_width * bytes_per_sample, src_ybc->y_height);
+  copy_plane(src_u, src_ybc->uv_stride * bytes_per_sample, dst_u,
+             dst_ybc->uv_stride * bytes_per_sample,
+             src_ybc->uv_width * bytes_per_sample, src_ybc->uv_height);
+  copy_plane(src_v, src_ybc->uv_stride * bytes_per_sample, dst_v,
+             dst_ybc->uv_stride * bytes_per_sample,
+             src_ybc->uv_width * bytes_per_sample, src_ybc->uv_height);
+}
+
+#if CONFIG_VP9
+// Extends the borders of all the planes by 'ext_size' luma pixels.
+// 'extend_plane_high' is used for high bitdepth frames.
+static INLINE void yv12_extend_frame(YV12_BUFFER_CONFIG *const ybf,
+                                     int ext_size,
+                                     extend_plane_fn_t extend_plane,
+                                     extend_plane_fn_t extend_plane_high) {
+  const int c_w = ybf->uv_crop_width;
+  const int c_h = ybf->uv_crop_height;
+  const int ss_x = ybf->uv_width < ybf->y_width;
+  const int ss_y = ybf->uv_height < ybf->y_height;
+  const int c_et = ext_size >> ss_y;
+  const int c_el = ext_size >> ss_x;
+  const int c_eb = c_et + ybf->uv_height - ybf->uv_crop_height;
+  const int c_er = c_el + ybf->uv_width - ybf->uv_crop_width;
+
+  assert(ybf->y_height - ybf->y_crop_height < 16);
+  assert(ybf->y_width - ybf->y_crop_width < 16);
+  assert(ybf->y_height - ybf->y_crop_height >= 0);
+  assert(ybf->y_width - ybf->y_crop_width >= 0);
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (ybf->flags & YV12_FLAG_HIGHBITDEPTH) extend_plane = extend_plane_high;
+#else
+  (void)extend_plane_high;
+#endif
+  extend_plane(ybf->y_buffer, ybf->y_stride, ybf->y_crop_width,
+               ybf->y_crop_height, ext_size, ext_size,
+               ext_size + ybf->y_height - ybf->y_crop_height,
+               ext_size + ybf->y_width - ybf->y_crop_width);
+
+  extend_plane(ybf->u_buffer, ybf->uv_stride, c_w, c_h, c_et, c_el, c_eb, c_er);
+
+  extend_plane(ybf->v_buffer, ybf->uv_stride, c_w, c_h, c_et, c_el, c_eb, c_er);
+}
+
+static INLINE int yv12_inner_border(const YV12_BUFFER_CONFIG *ybf) {
+  return (ybf->border > VP9INNERBORDERINPIXELS) ? VP9INNERBORDERINPIXELS
+                                                : ybf->border;
+}
+#endif  // CONFIG_VP9
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // VPX_VPX_SCALE_YV12EXTEND_H_
@@ -13,6 +13,10 @@
 
 #include "./vpx_config.h"
 
+#if CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -50,14 +54,24 @@ extern "C" {
 #define vpx_atomic_memory_barrier() \
   do {                              \
   } while (0)
+// The Interlocked intrinsics are full barriers on every target.
+#define vpx_atomic_full_barrier()    \
+  do {                               \
+    volatile long fence_dummy = 0;   \
+    _InterlockedOr(&fence_dummy, 0); \
+  } while (0)
 #else
 #if VPX_ARCH_X86 || VPX_ARCH_X86_64
 // Use a compiler barrier on x86, no runtime penalty.
 #define vpx_atomic_memory_barrier() __asm__ __volatile__("" ::: "memory")
+// Stores may still pass later loads on x86.
+#define vpx_atomic_full_barrier() __asm__ __volatile__("mfence" ::: "memory")
 #elif VPX_ARCH_ARM
 #define vpx_atomic_memory_barrier() __asm__ __volatile__("dmb ish" ::: "memory")
+#define vpx_atomic_full_barrier() vpx_atomic_memory_barrier()
 #elif VPX_ARCH_MIPS
 #define vpx_atomic_memory_barrier() __asm__ __volatile__("sync" ::: "memory")
+#define vpx_atomic_full_barrier() vpx_atomic_memory_barrier()
 #else
 #error Unsupported architecture!
 #endif  // VPX_ARCH_X86 || VPX_ARCH_X86_64
@@ -99,8 +113,20 @@ static INLINE int vpx_atomic_load_acquire(const vpx_atomic_int *atomic) {
 #endif  // defined(VPX_USE_ATOMIC_BUILTINS)
 }
 
+// Orders the stores before it against the loads after it, which acquire and
+// release do not. Needed when two threads each store a flag and then check
+// the other's.
+static INLINE void vpx_atomic_thread_fence(void) {
+#if defined(VPX_USE_ATOMIC_BUILTINS)
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#else
+  vpx_atomic_full_barrier();
+#endif  // defined(VPX_USE_ATOMIC_BUILTINS)
+}
+
 #undef VPX_USE_ATOMIC_BUILTINS
 #undef vpx_atomic_memory_barrier
+#undef vpx_atomic_full_barrier
 
 #endif /* CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD */
 
@@ -27,6 +27,7 @@
 #include "vpx/vpx_decoder.h"
 #include "vpx_ports/mem_ops.h"
 #include "vpx_ports/vpx_timer.h"
+#include "vpx_util/vpx_pthread.h"
 
 #if CONFIG_VP8_DECODER || CONFIG_VP9_DECODER
 #include "vpx/vp8dx.h"
@@ -77,7 +78,10 @@ static const arg_def_t outputfile =
 static const arg_def_t threadsarg =
     ARG_DEF("t", "threads", 1, "Max threads to use");
 static const arg_def_t frameparallelarg =
-    ARG_DEF(NULL, "frame-parallel", 0, "Frame parallel decode (ignored)");
+    ARG_DEF(NULL, "frame-parallel", 0, "Frame parallel decode in VP9");
+static const arg_def_t frameparallelframesarg =
+    ARG_DEF(NULL, "frame-parallel-frames", 1,
+            "Number of frames decoded in parallel in VP9 (default 4)");
 static const arg_def_t verbosearg =
     ARG_DEF("v", "verbose", 0, "Show version string");
 static const arg_def_t error_concealment =
@@ -99,10 +103,21 @@ static const arg_def_t svcdecodingarg = ARG_DEF(
 static const arg_def_t framestatsarg =
     ARG_DEF(NULL, "framestats", 1, "Output per-frame stats (.csv format)");
 static const arg_def_t rowmtarg =
-    ARG_DEF(NULL, "row-mt", 1, "Enable multi-threading to run row-wise in VP9");
+    ARG_DEF(NULL, "row-mt", 1,
+            "Enable multi-threading to run row-wise in VP8/VP9");
 static const arg_def_t lpfoptarg =
     ARG_DEF(NULL, "lpf-opt", 1,
             "Do loopfilter without waiting for all threads to sync.");
+static const arg_def_t lazyborderarg =
+    ARG_DEF(NULL, "lazy-border", 0,
+            "Allocate VP9 frames without a border to save memory");
+static const arg_def_t mmaparg =
+    ARG_DEF(NULL, "mmap", 0,
+            "Map IVF or raw input into memory rather than reading it");
+static const arg_def_t pipelinearg =
+    ARG_DEF(NULL, "pipeline-depth", 1,
+            "Hash or write frames on a separate thread, queueing n frames "
+            "(0: off)");
 
 static const arg_def_t *all_args[] = { &help,
                                        &codecarg,
@@ -119,6 +134,7 @@ static const arg_def_t *all_args[] = { &help,
                                        &outputfile,
                                        &threadsarg,
                                        &frameparallelarg,
+                                       &frameparallelframesarg,
                                        &verbosearg,
                                        &scalearg,
                                        &fb_arg,
@@ -132,6 +148,9 @@ static const arg_def_t *all_args[] = { &help,
                                        &framestatsarg,
                                        &rowmtarg,
                                        &lpfoptarg,
+                                       &lazyborderarg,
+                                       &mmaparg,
+                                       &pipelinearg,
                                        NULL };
 
 #if CONFIG_VP8_DECODER
@@ -265,17 +284,53 @@ static int raw_read_frame(FILE *infile, uint8_t **buffer, size_t *bytes_read,
   return 1;
 }
 
+static int raw_map_frame(struct VpxFileMap *map, uint8_t **buffer,
+                         size_t *bytes_read) {
+  const size_t kCorruptFrameThreshold = 256 * 1024 * 1024;
+  const size_t kFrameTooSmallThreshold = 256 * 1024;
+  size_t left = map->size - map->position;
+  size_t frame_size;
+
+  if (left < RAW_FRAME_HDR_SZ) return 1;
+  frame_size = mem_get_le32(map->data + map->position);
+  map->position += RAW_FRAME_HDR_SZ;
+  left -= RAW_FRAME_HDR_SZ;
+
+  if (frame_size > kCorruptFrameThreshold) {
+    warn("Read invalid frame size (%u)\n", (unsigned int)frame_size);
+    frame_size = 0;
+  }
+  if (frame_size < kFrameTooSmallThreshold) {
+    warn("Warning: Read invalid frame size (%u) - not a raw file?\n",
+         (unsigned int)frame_size);
+  }
+  if (frame_size > left) {
+    warn("Failed to read full frame\n");
+    map->position = map->size;
+    return 1;
+  }
+
+  *buffer = map->data + map->position;
+  *bytes_read = frame_size;
+  map->position += frame_size;
+  return 0;
+}
+
 static int dec_read_frame(struct VpxDecInputContext *input, uint8_t **buf,
                           size_t *bytes_in_buffer, size_t *buffer_size) {
+  struct VpxFileMap *const map = &input->vpx_input_ctx->map;
+
   switch (input->vpx_input_ctx->file_type) {
 #if CONFIG_WEBM_IO
     case FILE_TYPE_WEBM:
       return webm_read_frame(input->webm_ctx, buf, bytes_in_buffer);
 #endif
     case FILE_TYPE_RAW:
+      if (map->data) return raw_map_frame(map, buf, bytes_in_buffer);
       return raw_read_frame(input->vpx_input_ctx->file, buf, bytes_in_buffer,
                             buffer_size);
     case FILE_TYPE_IVF:
+      if (map->data) return ivf_map_frame(map, buf, bytes_in_buffer);
       return ivf_read_frame(input->vpx_input_ctx->file, buf, bytes_in_buffer,
                             buffer_size);
     default: return 1;
@@ -365,14 +420,34 @@ static void show_progress(int frame_in, int frame_out, uint64_t dx_time) {
 struct ExternalFrameBuffer {
   uint8_t *data;
   size_t size;
+  // Number of references: one from the decoder, plus one per pending write
+  // when pipelined.
   int in_use;
 };
 
 struct ExternalFrameBufferList {
   int num_external_frame_buffers;
   struct ExternalFrameBuffer *ext_fb;
+#if CONFIG_MULTITHREAD
+  // The buffers are requested and released by the VP9 frame workers and
+  // released by the output thread.
+  pthread_mutex_t mutex;
+#endif
 };
 
+static void release_ext_frame_buffer(struct ExternalFrameBufferList *list,
+                                     struct ExternalFrameBuffer *ext_fb) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&list->mutex);
+#else
+  (void)list;
+#endif
+  --ext_fb->in_use;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&list->mutex);
+#endif
+}
+
 // Callback used by libvpx to request an external frame buffer. |cb_priv|
 // Application private data passed into the set function. |min_size| is the
 // minimum size in bytes needed to decode the next frame. |fb| pointer to the
@@ -384,24 +459,35 @@ static int get_vp9_frame_buffer(void *cb_priv, size_t min_size,
       (struct ExternalFrameBufferList *)cb_priv;
   if (ext_fb_list == NULL) return -1;
 
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&ext_fb_list->mutex);
+#endif
   // Find a free frame buffer.
   for (i = 0; i < ext_fb_list->num_external_frame_buffers; ++i) {
     if (!ext_fb_list->ext_fb[i].in_use) break;
   }
+  if (i < ext_fb_list->num_external_frame_buffers)
+    ext_fb_list->ext_fb[i].in_use = 1;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&ext_fb_list->mutex);
+#endif
 
   if (i == ext_fb_list->num_external_frame_buffers) return -1;
 
   if (ext_fb_list->ext_fb[i].size < min_size) {
     free(ext_fb_list->ext_fb[i].data);
     ext_fb_list->ext_fb[i].data = (uint8_t *)calloc(min_size, sizeof(uint8_t));
-    if (!ext_fb_list->ext_fb[i].data) return -1;
+    if (!ext_fb_list->ext_fb[i].data) {
+      ext_fb_list->ext_fb[i].size = 0;
+      release_ext_frame_buffer(ext_fb_list, &ext_fb_list->ext_fb[i]);
+      return -1;
+    }
 
     ext_fb_list->ext_fb[i].size = min_size;
   }
 
   fb->data = ext_fb_list->ext_fb[i].data;
   fb->size = ext_fb_list->ext_fb[i].size;
-  ext_fb_list->ext_fb[i].in_use = 1;
 
   // Set the frame buffer's private data to point at the external frame buffer.
   fb->priv = &ext_fb_list->ext_fb[i];
@@ -413,10 +499,8 @@ static int get_vp9_frame_buffer(void *cb_priv, size_t min_size,
 // to the frame buffer.
 static int release_vp9_frame_buffer(void *cb_priv,
                                     vpx_codec_frame_buffer_t *fb) {
-  struct ExternalFrameBuffer *const ext_fb =
-      (struct ExternalFrameBuffer *)fb->priv;
-  (void)cb_priv;
-  ext_fb->in_use = 0;
+  release_ext_frame_buffer((struct ExternalFrameBufferList *)cb_priv,
+                           (struct ExternalFrameBuffer *)fb->priv);
   return 0;
 }
 
@@ -514,6 +598,346 @@ static int img_shifted_realloc_required(const vpx_image_t *img,
 }
 #endif
 
+struct VpxDecOutputContext {
+  const struct VpxInputContext *vpx_input_ctx;
+  int single_file;
+  int use_y4m;
+  int opt_yv12;
+  int opt_i420;
+  int flipuv;
+  int do_md5;
+  const char *outfile_pattern;
+  char outfile_name[PATH_MAX];
+  FILE *outfile;
+  MD5Context md5_ctx;
+  vpx_image_t *scaled_img;
+#if CONFIG_VP9_HIGHBITDEPTH
+  unsigned int output_bit_depth;
+  vpx_image_t *img_shifted;
+#endif
+};
+
+// Scales and shifts the frame as requested, then writes it or adds it to the
+// MD5 sum. Returns 0 on success.
+static int write_frame(struct VpxDecOutputContext *output, vpx_image_t *img,
+                       int frame_in, int frame_out, int corrupted) {
+  const int PLANES_YUV[] = { VPX_PLANE_Y, VPX_PLANE_U, VPX_PLANE_V };
+  const int PLANES_YVU[] = { VPX_PLANE_Y, VPX_PLANE_V, VPX_PLANE_U };
+  const int *planes = output->flipuv ? PLANES_YVU : PLANES_YUV;
+  const struct VpxInputContext *const vpx_input_ctx = output->vpx_input_ctx;
+  vpx_image_t *const scaled_img = output->scaled_img;
+
+  if (scaled_img &&
+      (img->d_w != scaled_img->d_w || img->d_h != scaled_img->d_h)) {
+#if CONFIG_LIBYUV
+    libyuv_scale(img, scaled_img, kFilterBox);
+    img = scaled_img;
+#else
+    fprintf(stderr,
+            "Failed to scale output frame.\n"
+            "Scaling is disabled in this configuration. "
+            "To enable scaling, configure with --enable-libyuv\n");
+    return -1;
+#endif
+  }
+#if CONFIG_VP9_HIGHBITDEPTH
+  // Default to codec bit depth if output bit depth not set
+  if (!output->output_bit_depth && output->single_file && !output->do_md5) {
+    output->output_bit_depth = img->bit_depth;
+  }
+  // Shift up or down if necessary
+  if (output->output_bit_depth != 0 &&
+      output->output_bit_depth != img->bit_depth) {
+    const unsigned int output_bit_depth = output->output_bit_depth;
+    const vpx_img_fmt_t shifted_fmt =
+        output_bit_depth == 8 ? img->fmt ^ (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH)
+                              : img->fmt | VPX_IMG_FMT_HIGHBITDEPTH;
+    if (output->img_shifted &&
+        img_shifted_realloc_required(img, output->img_shifted, shifted_fmt)) {
+      vpx_img_free(output->img_shifted);
+      output->img_shifted = NULL;
+    }
+    if (!output->img_shifted) {
+      output->img_shifted =
+          vpx_img_alloc(NULL, shifted_fmt, img->d_w, img->d_h, 16);
+      if (!output->img_shifted) {
+        fprintf(stderr, "Failed to allocate image\n");
+        return -1;
+      }
+      output->img_shifted->bit_depth = output_bit_depth;
+    }
+    if (output_bit_depth > img->bit_depth) {
+      vpx_img_upshift(output->img_shifted, img,
+                      output_bit_depth - img->bit_depth);
+    } else {
+      vpx_img_downshift(output->img_shifted, img,
+                        img->bit_depth - output_bit_depth);
+    }
+    img = output->img_shifted;
+  }
+#endif
+
+  if (output->single_file) {
+    if (output->use_y4m) {
+      char y4m_buf[Y4M_BUFFER_SIZE] = { 0 };
+      size_t len = 0;
+      if (img->fmt == VPX_IMG_FMT_I440 || img->fmt == VPX_IMG_FMT_I44016) {
+        fprintf(stderr, "Cannot produce y4m output for 440 sampling.\n");
+        return -1;
+      }
+      if (frame_out == 1) {
+        // Y4M file header
+        len = y4m_write_file_header(
+            y4m_buf, sizeof(y4m_buf), vpx_input_ctx->width,
+            vpx_input_ctx->height, &vpx_input_ctx->framerate, img->fmt,
+            img->bit_depth);
+        if (output->do_md5) {
+          MD5Update(&output->md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
+        } else {
+          fputs(y4m_buf, output->outfile);
+        }
+      }
+
+      // Y4M frame header
+      len = y4m_write_frame_header(y4m_buf, sizeof(y4m_buf));
+      if (output->do_md5) {
+        MD5Update(&output->md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
+      } else {
+        fputs(y4m_buf, output->outfile);
+      }
+    } else {
+      if (frame_out == 1) {
+        // Check if --yv12 or --i420 options are consistent with the
+        // bit-stream decoded
+        if (output->opt_i420) {
+          if (img->fmt != VPX_IMG_FMT_I420 && img->fmt != VPX_IMG_FMT_I42016) {
+            fprintf(stderr, "Cannot produce i420 output for bit-stream.\n");
+            return -1;
+          }
+        }
+        if (output->opt_yv12) {
+          if ((img->fmt != VPX_IMG_FMT_I420 && img->fmt != VPX_IMG_FMT_YV12) ||
+              img->bit_depth != 8) {
+            fprintf(stderr, "Cannot produce yv12 output for bit-stream.\n");
+            return -1;
+          }
+        }
+      }
+    }
+
+    if (output->do_md5) {
+      update_image_md5(img, planes, &output->md5_ctx);
+    } else {
+      if (!corrupted) write_image_file(img, planes, output->outfile);
+    }
+  } else {
+    generate_filename(output->outfile_pattern, output->outfile_name, PATH_MAX,
+                      img->d_w, img->d_h, frame_in);
+    if (output->do_md5) {
+      unsigned char md5_digest[16];
+      MD5Init(&output->md5_ctx);
+      update_image_md5(img, planes, &output->md5_ctx);
+      MD5Final(md5_digest, &output->md5_ctx);
+      print_md5(md5_digest, output->outfile_name);
+    } else {
+      FILE *const outfile = open_outfile(output->outfile_name);
+      write_image_file(img, planes, outfile);
+      fclose(outfile);
+    }
+  }
+  return 0;
+}
+
+#if CONFIG_MULTITHREAD
+struct frame_entry {
+  vpx_image_t img;
+  // The external frame buffer holding the frame, referenced until it is
+  // written, or NULL if the frame was copied into |copy|.
+  struct ExternalFrameBuffer *ext_fb;
+  vpx_image_t *copy;
+  int frame_in;
+  int frame_out;
+  int corrupted;
+};
+
+// Decoded frames waiting for the output thread. Frames in external frame
+// buffers are queued in place; the others are only valid until the next
+// call into the decoder, so the queue holds copies of them.
+struct frame_queue {
+  struct VpxDecOutputContext *output;
+  struct ExternalFrameBufferList *ext_fb_list;
+  struct frame_entry *entries;
+  int depth;
+  int head;
+  int count;
+  int done;
+  int failed;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  pthread_t thread;
+};
+
+static struct ExternalFrameBuffer *find_ext_frame_buffer(
+    const struct ExternalFrameBufferList *ext_fb_list, const vpx_image_t *img) {
+  struct ExternalFrameBuffer *const ext_fb =
+      (struct ExternalFrameBuffer *)img->fb_priv;
+  int i;
+
+  // Postprocessed frames are not in the buffer the frame was decoded to.
+  for (i = 0; i < ext_fb_list->num_external_frame_buffers; ++i) {
+    if (ext_fb == &ext_fb_list->ext_fb[i]) {
+      return img->planes[VPX_PLANE_Y] >= ext_fb->data &&
+                     img->planes[VPX_PLANE_Y] < ext_fb->data + ext_fb->size
+                 ? ext_fb
+                 : NULL;
+    }
+  }
+  return NULL;
+}
+
+static int copy_frame(const vpx_image_t *img, vpx_image_t **copy) {
+  const int bytespp = (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+  int plane;
+
+  if (*copy && ((*copy)->fmt != img->fmt || (*copy)->d_w != img->d_w ||
+                (*copy)->d_h != img->d_h)) {
+    vpx_img_free(*copy);
+    *copy = NULL;
+  }
+  if (!*copy) {
+    *copy = vpx_img_alloc(NULL, img->fmt, img->d_w, img->d_h, 16);
+    if (!*copy) return -1;
+  }
+  (*copy)->bit_depth = img->bit_depth;
+  for (plane = 0; plane < 3; ++plane) {
+    const int w = vpx_img_plane_width(img, plane) * bytespp;
+    const int h = vpx_img_plane_height(img, plane);
+    const unsigned char *src = img->planes[plane];
+    unsigned char *dst = (*copy)->planes[plane];
+    int y;
+
+    for (y = 0; y < h; ++y) {
+      memcpy(dst, src, w);
+      src += img->stride[plane];
+      dst += (*copy)->stride[plane];
+    }
+  }
+  return 0;
+}
+
+static THREADFN frame_queue_writer(void *arg) {
+  struct frame_queue *const queue = (struct frame_queue *)arg;
+
+  pthread_mutex_lock(&queue->mutex);
+  for (;;) {
+    struct frame_entry *entry;
+    int failed;
+
+    while (!queue->count && !queue->done)
+      pthread_cond_wait(&queue->cond, &queue->mutex);
+    if (!queue->count) break;
+    entry = &queue->entries[queue->head];
+    failed = queue->failed;
+    pthread_mutex_unlock(&queue->mutex);
+
+    // After a failure, the remaining frames are only released.
+    if (!failed) {
+      failed = write_frame(queue->output, &entry->img, entry->frame_in,
+                           entry->frame_out, entry->corrupted);
+    }
+    if (entry->ext_fb) {
+      release_ext_frame_buffer(queue->ext_fb_list, entry->ext_fb);
+      entry->ext_fb = NULL;
+    }
+
+    pthread_mutex_lock(&queue->mutex);
+    if (failed) queue->failed = 1;
+    queue->head = (queue->head + 1) % queue->depth;
+    queue->count--;
+    pthread_cond_signal(&queue->cond);
+  }
+  pthread_mutex_unlock(&queue->mutex);
+  return THREAD_EXIT_SUCCESS;
+}
+
+static void frame_queue_start(struct frame_queue *queue,
+                              struct VpxDecOutputContext *output,
+                              struct ExternalFrameBufferList *ext_fb_list,
+                              int depth) {
+  memset(queue, 0, sizeof(*queue));
+  queue->output = output;
+  queue->ext_fb_list = ext_fb_list;
+  queue->depth = depth;
+  queue->entries = calloc(depth, sizeof(*queue->entries));
+  if (!queue->entries) fatal("Failed to allocate frame queue");
+  pthread_mutex_init(&queue->mutex, NULL);
+  pthread_cond_init(&queue->cond, NULL);
+  if (pthread_create(&queue->thread, NULL, frame_queue_writer, queue))
+    fatal("Failed to create output thread");
+}
+
+// Queues a decoded frame for the output thread. Returns 0 on success, or -1
+// if a frame failed to be written.
+static int frame_queue_push(struct frame_queue *queue, const vpx_image_t *img,
+                            int frame_in, int frame_out, int corrupted) {
+  struct frame_entry *entry;
+
+  pthread_mutex_lock(&queue->mutex);
+  while (queue->count == queue->depth && !queue->failed)
+    pthread_cond_wait(&queue->cond, &queue->mutex);
+  if (queue->failed) {
+    pthread_mutex_unlock(&queue->mutex);
+    return -1;
+  }
+  entry = &queue->entries[(queue->head + queue->count) % queue->depth];
+  pthread_mutex_unlock(&queue->mutex);
+
+  entry->ext_fb = queue->ext_fb_list->ext_fb
+                      ? find_ext_frame_buffer(queue->ext_fb_list, img)
+                      : NULL;
+  if (entry->ext_fb) {
+    pthread_mutex_lock(&queue->ext_fb_list->mutex);
+    ++entry->ext_fb->in_use;
+    pthread_mutex_unlock(&queue->ext_fb_list->mutex);
+    entry->img = *img;
+  } else {
+    if (copy_frame(img, &entry->copy)) {
+      fprintf(stderr, "Failed to allocate image\n");
+      return -1;
+    }
+    entry->img = *entry->copy;
+  }
+  entry->frame_in = frame_in;
+  entry->frame_out = frame_out;
+  entry->corrupted = corrupted;
+
+  pthread_mutex_lock(&queue->mutex);
+  queue->count++;
+  pthread_cond_signal(&queue->cond);
+  pthread_mutex_unlock(&queue->mutex);
+  return 0;
+}
+
+// Waits for the queued frames to be written. Returns 0 if they all were.
+static int frame_queue_stop(struct frame_queue *queue) {
+  int i;
+
+  pthread_mutex_lock(&queue->mutex);
+  queue->done = 1;
+  pthread_cond_signal(&queue->cond);
+  pthread_mutex_unlock(&queue->mutex);
+  pthread_join(queue->thread, NULL);
+  pthread_mutex_destroy(&queue->mutex);
+  pthread_cond_destroy(&queue->cond);
+  for (i = 0; i < queue->depth; ++i) {
+    if (queue->entries[i].copy) vpx_img_free(queue->entries[i].copy);
+  }
+  free(queue->entries);
+  queue->entries = NULL;
+  return queue->failed ? -1 : 0;
+}
+#endif  // CONFIG_MULTITHREAD
+
 static int main_loop(int argc, const char **argv_) {
   vpx_codec_ctx_t decoder;
   char *fn = NULL;
@@ -530,13 +954,16 @@ static int main_loop(int argc, const char **argv_) {
   int keep_going = 0;
   int enable_row_mt = 0;
   int enable_lpf_opt = 0;
+  int frame_parallel = 0;
+  int lazy_border = 0;
+  int use_mmap = 0;
+  int pipeline_depth = 0;
   const VpxInterface *interface = NULL;
   const VpxInterface *fourcc_interface = NULL;
   uint64_t dx_time = 0;
   struct arg arg;
   char **argv, **argi, **argj;
 
-  int single_file;
   int use_y4m = 1;
   int opt_yv12 = 0;
   int opt_i420 = 0;
@@ -552,21 +979,19 @@ static int main_loop(int argc, const char **argv_) {
   int frames_corrupted = 0;
   int dec_flags = 0;
   int do_scale = 0;
-  vpx_image_t *scaled_img = NULL;
-#if CONFIG_VP9_HIGHBITDEPTH
-  vpx_image_t *img_shifted = NULL;
-#endif
   int frame_avail, got_data, flush_decoder = 0;
   int num_external_frame_buffers = 0;
-  struct ExternalFrameBufferList ext_fb_list = { 0, NULL };
+  struct ExternalFrameBufferList ext_fb_list;
 
   const char *outfile_pattern = NULL;
-  char outfile_name[PATH_MAX] = { 0 };
-  FILE *outfile = NULL;
+  struct VpxDecOutputContext output;
+#if CONFIG_MULTITHREAD
+  struct frame_queue frame_queue;
+  struct frame_queue *queue = NULL;
+#endif
 
   FILE *framestats_file = NULL;
 
-  MD5Context md5_ctx;
   unsigned char md5_digest[16];
 
   struct VpxDecInputContext input = { NULL, NULL };
@@ -576,7 +1001,11 @@ static int main_loop(int argc, const char **argv_) {
   memset(&(webm_ctx), 0, sizeof(webm_ctx));
   input.webm_ctx = &webm_ctx;
 #endif
+  memset(&vpx_input_ctx, 0, sizeof(vpx_input_ctx));
   input.vpx_input_ctx = &vpx_input_ctx;
+  memset(&output, 0, sizeof(output));
+  output.vpx_input_ctx = &vpx_input_ctx;
+  memset(&ext_fb_list, 0, sizeof(ext_fb_list));
 
   /* Parse command line */
   exec_name = argv_[0];
@@ -630,7 +1059,9 @@ static int main_loop(int argc, const char **argv_) {
       cfg.threads = arg_parse_uint(&arg);
 #if CONFIG_VP9_DECODER
     else if (arg_match(&arg, &frameparallelarg, argi)) {
-      /* ignored for compatibility */
+      if (!frame_parallel) frame_parallel = 4;
+    } else if (arg_match(&arg, &frameparallelframesarg, argi)) {
+      frame_parallel = arg_parse_uint(&arg);
     }
 #endif
     else if (arg_match(&arg, &verbosearg, argi))
@@ -659,6 +1090,12 @@ static int main_loop(int argc, const char **argv_) {
       enable_row_mt = arg_parse_uint(&arg);
     } else if (arg_match(&arg, &lpfoptarg, argi)) {
       enable_lpf_opt = arg_parse_uint(&arg);
+    } else if (arg_match(&arg, &lazyborderarg, argi)) {
+      lazy_border = 1;
+    } else if (arg_match(&arg, &mmaparg, argi)) {
+      use_mmap = 1;
+    } else if (arg_match(&arg, &pipelinearg, argi)) {
+      pipeline_depth = arg_parse_uint(&arg);
     }
 #if CONFIG_VP8_DECODER
     else if (arg_match(&arg, &addnoise_level, argi)) {
@@ -688,6 +1125,13 @@ static int main_loop(int argc, const char **argv_) {
     if (argi[0][0] == '-' && strlen(argi[0]) > 1)
       die("Error: Unrecognized option %s\n", *argi);
 
+#if !CONFIG_MULTITHREAD
+  if (pipeline_depth) {
+    warn("Ignoring --pipeline-depth, built without multithreading\n");
+    pipeline_depth = 0;
+  }
+#endif
+
   /* Handle non-option arguments */
   fn = argv[0];
 
@@ -728,21 +1172,32 @@ static int main_loop(int argc, const char **argv_) {
     free(argv);
     return EXIT_FAILURE;
   }
+  if (use_mmap && input.vpx_input_ctx->file_type != FILE_TYPE_WEBM)
+    map_input_file(input.vpx_input_ctx);
 
   outfile_pattern = outfile_pattern ? outfile_pattern : "-";
-  single_file = is_single_file(outfile_pattern);
+  output.outfile_pattern = outfile_pattern;
+  output.single_file = is_single_file(outfile_pattern);
+  output.use_y4m = use_y4m;
+  output.opt_yv12 = opt_yv12;
+  output.opt_i420 = opt_i420;
+  output.flipuv = flipuv;
+  output.do_md5 = do_md5;
+#if CONFIG_VP9_HIGHBITDEPTH
+  output.output_bit_depth = output_bit_depth;
+#endif
 
-  if (!noblit && single_file) {
-    generate_filename(outfile_pattern, outfile_name, PATH_MAX,
+  if (!noblit && output.single_file) {
+    generate_filename(outfile_pattern, output.outfile_name, PATH_MAX,
                       vpx_input_ctx.width, vpx_input_ctx.height, 0);
     if (do_md5)
-      MD5Init(&md5_ctx);
+      MD5Init(&output.md5_ctx);
     else
-      outfile = open_outfile(outfile_name);
+      output.outfile = open_outfile(output.outfile_name);
   }
 
   if (use_y4m && !noblit) {
-    if (!single_file) {
+    if (!output.single_file) {
       fprintf(stderr,
               "YUV4MPEG2 not supported with output patterns,"
               " try --i420 or --yv12 or --rawvideo.\n");
@@ -797,9 +1252,27 @@ static int main_loop(int argc, const char **argv_) {
             vpx_codec_error(&decoder));
     goto fail;
   }
+  if (interface->fourcc == VP9_FOURCC &&
+      vpx_codec_control(&decoder, VP9D_SET_FRAME_PARALLEL, frame_parallel)) {
+    fprintf(stderr, "Failed to set decoder in frame parallel mode: %s\n",
+            vpx_codec_error(&decoder));
+    goto fail;
+  }
+  if (interface->fourcc == VP9_FOURCC &&
+      vpx_codec_control(&decoder, VP9D_SET_LAZY_BORDER, lazy_border)) {
+    fprintf(stderr, "Failed to set decoder in lazy border mode: %s\n",
+            vpx_codec_error(&decoder));
+    goto fail;
+  }
   if (!quiet) fprintf(stderr, "%s\n", decoder.name);
 
 #if CONFIG_VP8_DECODER
+  if (interface->fourcc == VP8_FOURCC &&
+      vpx_codec_control(&decoder, VP8D_SET_ROW_MT, enable_row_mt)) {
+    fprintf(stderr, "Failed to set decoder in row multi-thread mode: %s\n",
+            vpx_codec_error(&decoder));
+    goto fail;
+  }
   if (vp8_pp_cfg.post_proc_flag &&
       vpx_codec_control(&decoder, VP8_SET_POSTPROC, &vp8_pp_cfg)) {
     fprintf(stderr, "Failed to configure postproc: %s\n",
@@ -814,6 +1287,18 @@ static int main_loop(int argc, const char **argv_) {
     arg_skip--;
   }
 
+#if CONFIG_MULTITHREAD
+  // Queued VP9 frames stay in their external frame buffers, which the decoder
+  // can't reuse until the frames are written.
+  if (pipeline_depth && !noblit && interface->fourcc == VP9_FOURCC) {
+    if (!num_external_frame_buffers) {
+      num_external_frame_buffers =
+          VP9_MAXIMUM_REF_BUFFERS + VPX_MAXIMUM_WORK_BUFFERS;
+    }
+    num_external_frame_buffers += pipeline_depth;
+  }
+#endif
+
   if (num_external_frame_buffers > 0) {
     ext_fb_list.num_external_frame_buffers = num_external_frame_buffers;
     ext_fb_list.ext_fb = (struct ExternalFrameBuffer *)calloc(
@@ -822,6 +1307,9 @@ static int main_loop(int argc, const char **argv_) {
       fprintf(stderr, "Failed to allocate ExternalFrameBuffer\n");
       goto fail;
     }
+#if CONFIG_MULTITHREAD
+    pthread_mutex_init(&ext_fb_list.mutex, NULL);
+#endif
     if (vpx_codec_set_frame_buffer_functions(&decoder, get_vp9_frame_buffer,
                                              release_vp9_frame_buffer,
                                              &ext_fb_list)) {
@@ -836,6 +1324,13 @@ static int main_loop(int argc, const char **argv_) {
 
   if (framestats_file) fprintf(framestats_file, "bytes,qp\n");
 
+#if CONFIG_MULTITHREAD
+  if (pipeline_depth && !noblit) {
+    frame_queue_start(&frame_queue, &output, &ext_fb_list, pipeline_depth);
+    queue = &frame_queue;
+  }
+#endif
+
   /* Decode file */
   while (frame_avail || got_data) {
     vpx_codec_iter_t iter = NULL;
@@ -910,162 +1405,55 @@ static int main_loop(int argc, const char **argv_) {
     if (progress) show_progress(frame_in, frame_out, dx_time);
 
     if (!noblit && img) {
-      const int PLANES_YUV[] = { VPX_PLANE_Y, VPX_PLANE_U, VPX_PLANE_V };
-      const int PLANES_YVU[] = { VPX_PLANE_Y, VPX_PLANE_V, VPX_PLANE_U };
-      const int *planes = flipuv ? PLANES_YVU : PLANES_YUV;
-
-      if (do_scale) {
-        if (frame_out == 1) {
-          // If the output frames are to be scaled to a fixed display size then
-          // use the width and height specified in the container. If either of
-          // these is set to 0, use the display size set in the first frame
-          // header. If that is unavailable, use the raw decoded size of the
-          // first decoded frame.
-          int render_width = vpx_input_ctx.width;
-          int render_height = vpx_input_ctx.height;
-          if (!render_width || !render_height) {
-            int render_size[2];
-            if (vpx_codec_control(&decoder, VP9D_GET_DISPLAY_SIZE,
-                                  render_size)) {
-              // As last resort use size of first frame as display size.
-              render_width = img->d_w;
-              render_height = img->d_h;
-            } else {
-              render_width = render_size[0];
-              render_height = render_size[1];
-            }
-          }
-          scaled_img =
-              vpx_img_alloc(NULL, img->fmt, render_width, render_height, 16);
-          if (!scaled_img) {
-            fprintf(stderr, "Failed to allocate scaled image (%d x %d)\n",
-                    render_width, render_height);
-            goto fail;
+      if (do_scale && frame_out == 1) {
+        // If the output frames are to be scaled to a fixed display size then
+        // use the width and height specified in the container. If either of
+        // these is set to 0, use the display size set in the first frame
+        // header. If that is unavailable, use the raw decoded size of the
+        // first decoded frame.
+        int render_width = vpx_input_ctx.width;
+        int render_height = vpx_input_ctx.height;
+        if (!render_width || !render_height) {
+          int render_size[2];
+          if (vpx_codec_control(&decoder, VP9D_GET_DISPLAY_SIZE,
+                                render_size)) {
+            // As last resort use size of first frame as display size.
+            render_width = img->d_w;
+            render_height = img->d_h;
+          } else {
+            render_width = render_size[0];
+            render_height = render_size[1];
           }
-          scaled_img->bit_depth = img->bit_depth;
         }
-
-        if (img->d_w != scaled_img->d_w || img->d_h != scaled_img->d_h) {
-#if CONFIG_LIBYUV
-          libyuv_scale(img, scaled_img, kFilterBox);
-          img = scaled_img;
-#else
-          fprintf(stderr,
-                  "Failed  to scale output frame: %s.\n"
-                  "Scaling is disabled in this configuration. "
-                  "To enable scaling, configure with --enable-libyuv\n",
-                  vpx_codec_error(&decoder));
+        output.scaled_img =
+            vpx_img_alloc(NULL, img->fmt, render_width, render_height, 16);
+        if (!output.scaled_img) {
+          fprintf(stderr, "Failed to allocate scaled image (%d x %d)\n",
+                  render_width, render_height);
           goto fail;
-#endif
-        }
-      }
-#if CONFIG_VP9_HIGHBITDEPTH
-      // Default to codec bit depth if output bit depth not set
-      if (!output_bit_depth && single_file && !do_md5) {
-        output_bit_depth = img->bit_depth;
-      }
-      // Shift up or down if necessary
-      if (output_bit_depth != 0 && output_bit_depth != img->bit_depth) {
-        const vpx_img_fmt_t shifted_fmt =
-            output_bit_depth == 8
-                ? img->fmt ^ (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH)
-                : img->fmt | VPX_IMG_FMT_HIGHBITDEPTH;
-        if (img_shifted &&
-            img_shifted_realloc_required(img, img_shifted, shifted_fmt)) {
-          vpx_img_free(img_shifted);
-          img_shifted = NULL;
         }
-        if (!img_shifted) {
-          img_shifted =
-              vpx_img_alloc(NULL, shifted_fmt, img->d_w, img->d_h, 16);
-          if (!img_shifted) {
-            fprintf(stderr, "Failed to allocate image\n");
-            goto fail;
-          }
-          img_shifted->bit_depth = output_bit_depth;
-        }
-        if (output_bit_depth > img->bit_depth) {
-          vpx_img_upshift(img_shifted, img, output_bit_depth - img->bit_depth);
-        } else {
-          vpx_img_downshift(img_shifted, img,
-                            img->bit_depth - output_bit_depth);
-        }
-        img = img_shifted;
+        output.scaled_img->bit_depth = img->bit_depth;
       }
-#endif
-
-      if (single_file) {
-        if (use_y4m) {
-          char y4m_buf[Y4M_BUFFER_SIZE] = { 0 };
-          size_t len = 0;
-          if (img->fmt == VPX_IMG_FMT_I440 || img->fmt == VPX_IMG_FMT_I44016) {
-            fprintf(stderr, "Cannot produce y4m output for 440 sampling.\n");
-            goto fail;
-          }
-          if (frame_out == 1) {
-            // Y4M file header
-            len = y4m_write_file_header(
-                y4m_buf, sizeof(y4m_buf), vpx_input_ctx.width,
-                vpx_input_ctx.height, &vpx_input_ctx.framerate, img->fmt,
-                img->bit_depth);
-            if (do_md5) {
-              MD5Update(&md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
-            } else {
-              fputs(y4m_buf, outfile);
-            }
-          }
 
-          // Y4M frame header
-          len = y4m_write_frame_header(y4m_buf, sizeof(y4m_buf));
-          if (do_md5) {
-            MD5Update(&md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
-          } else {
-            fputs(y4m_buf, outfile);
-          }
-        } else {
-          if (frame_out == 1) {
-            // Check if --yv12 or --i420 options are consistent with the
-            // bit-stream decoded
-            if (opt_i420) {
-              if (img->fmt != VPX_IMG_FMT_I420 &&
-                  img->fmt != VPX_IMG_FMT_I42016) {
-                fprintf(stderr, "Cannot produce i420 output for bit-stream.\n");
-                goto fail;
-              }
-            }
-            if (opt_yv12) {
-              if ((img->fmt != VPX_IMG_FMT_I420 &&
-                   img->fmt != VPX_IMG_FMT_YV12) ||
-                  img->bit_depth != 8) {
-                fprintf(stderr, "Cannot produce yv12 output for bit-stream.\n");
-                goto fail;
-              }
-            }
-          }
-        }
-
-        if (do_md5) {
-          update_image_md5(img, planes, &md5_ctx);
-        } else {
-          if (!corrupted) write_image_file(img, planes, outfile);
-        }
-      } else {
-        generate_filename(outfile_pattern, outfile_name, PATH_MAX, img->d_w,
-                          img->d_h, frame_in);
-        if (do_md5) {
-          MD5Init(&md5_ctx);
-          update_image_md5(img, planes, &md5_ctx);
-          MD5Final(md5_digest, &md5_ctx);
-          print_md5(md5_digest, outfile_name);
-        } else {
-          outfile = open_outfile(outfile_name);
-          write_image_file(img, planes, outfile);
-          fclose(outfile);
-        }
+#if CONFIG_MULTITHREAD
+      if (queue) {
+        if (frame_queue_push(queue, img, frame_in, frame_out, corrupted))
+          goto fail;
+        continue;
       }
+#endif
+      if (write_frame(&output, img, frame_in, frame_out, corrupted)) goto fail;
     }
   }
 
+#if CONFIG_MULTITHREAD
+  if (queue) {
+    const int failed = frame_queue_stop(queue);
+    queue = NULL;
+    if (failed) goto fail;
+  }
+#endif
+
   if (summary || progress) {
     show_progress(frame_in, frame_out, dx_time);
     fprintf(stderr, "\n");
@@ -1079,6 +1467,10 @@ static int main_loop(int argc, const char **argv_) {
 
 fail:
 
+#if CONFIG_MULTITHREAD
+  if (queue) frame_queue_stop(queue);
+#endif
+
   if (vpx_codec_destroy(&decoder)) {
     fprintf(stderr, "Failed to destroy decoder: %s\n",
             vpx_codec_error(&decoder));
@@ -1086,12 +1478,12 @@ fail:
 
 fail2:
 
-  if (!noblit && single_file) {
+  if (!noblit && output.single_file) {
     if (do_md5) {
-      MD5Final(md5_digest, &md5_ctx);
-      print_md5(md5_digest, outfile_name);
+      MD5Final(md5_digest, &output.md5_ctx);
+      print_md5(md5_digest, output.outfile_name);
     } else {
-      fclose(outfile);
+      fclose(output.outfile);
     }
   }
 
@@ -1100,16 +1492,24 @@ fail2:
     webm_free(input.webm_ctx);
 #endif
 
-  if (input.vpx_input_ctx->file_type != FILE_TYPE_WEBM) free(buf);
+  if (input.vpx_input_ctx->file_type != FILE_TYPE_WEBM) {
+    if (vpx_input_ctx.map.data)
+      unmap_input_file(&vpx_input_ctx);
+    else
+      free(buf);
+  }
 
-  if (scaled_img) vpx_img_free(scaled_img);
+  if (output.scaled_img) vpx_img_free(output.scaled_img);
 #if CONFIG_VP9_HIGHBITDEPTH
-  if (img_shifted) vpx_img_free(img_shifted);
+  if (output.img_shifted) vpx_img_free(output.img_shifted);
 #endif
 
   for (i = 0; i < ext_fb_list.num_external_frame_buffers; ++i) {
     free(ext_fb_list.ext_fb[i].data);
   }
+#if CONFIG_MULTITHREAD
+  if (ext_fb_list.ext_fb) pthread_mutex_destroy(&ext_fb_list.mutex);
+#endif
   free(ext_fb_list.ext_fb);
 
   fclose(infile);
@@ -42,6 +42,7 @@
 #include "vpx/vpx_integer.h"
 #include "vpx_ports/mem_ops.h"
 #include "vpx_ports/vpx_timer.h"
+#include "vpx_util/vpx_pthread.h"
 #include "./rate_hist.h"
 #include "./vpxstats.h"
 #include "./warnings.h"
@@ -120,6 +121,15 @@ static const arg_def_t limit =
     ARG_DEF(NULL, "limit", 1, "Stop encoding after n input frames");
 static const arg_def_t skip =
     ARG_DEF(NULL, "skip", 1, "Skip the first n input frames");
+static const arg_def_t mmap_input =
+    ARG_DEF(NULL, "mmap", 0,
+            "Map the input file into memory rather than reading it");
+static const arg_def_t pipeline_depth =
+    ARG_DEF(NULL, "pipeline-depth", 1,
+            "Read and write on separate threads, queueing n frames (0: off)");
+static const arg_def_t y4m_threads =
+    ARG_DEF(NULL, "y4m-threads", 1,
+            "Threads converting Y4M input chroma to 4:2:0 (default: 1)");
 static const arg_def_t deadline =
     ARG_DEF("d", "deadline", 1, "Deadline per frame (usec)");
 static const arg_def_t best_dl =
@@ -176,6 +186,9 @@ static const arg_def_t *main_args[] = { &help,
                                         &fpf_name,
                                         &limit,
                                         &skip,
+                                        &mmap_input,
+                                        &pipeline_depth,
+                                        &y4m_threads,
                                         &deadline,
                                         &best_dl,
                                         &good_dl,
@@ -710,6 +723,9 @@ struct stream_state {
   struct vpx_image *img;
   vpx_codec_ctx_t decoder;
   int mismatch_seen;
+#if CONFIG_MULTITHREAD
+  struct packet_queue *pkt_queue;
+#endif
 };
 
 static void validate_positive_rational(const char *msg,
@@ -789,6 +805,12 @@ static void parse_global_config(struct VpxEncoderConfig *global, char **argv) {
       global->limit = arg_parse_uint(&arg);
     else if (arg_match(&arg, &skip, argi))
       global->skip_frames = arg_parse_uint(&arg);
+    else if (arg_match(&arg, &mmap_input, argi))
+      global->mmap_input = 1;
+    else if (arg_match(&arg, &pipeline_depth, argi))
+      global->pipeline_depth = arg_parse_uint(&arg);
+    else if (arg_match(&arg, &y4m_threads, argi))
+      global->y4m_threads = arg_parse_uint(&arg);
     else if (arg_match(&arg, &psnrarg, argi))
       global->show_psnr = 1;
     else if (arg_match(&arg, &recontest, argi))
@@ -840,6 +862,17 @@ static void parse_global_config(struct VpxEncoderConfig *global, char **argv) {
     warn("Enforcing one-pass encoding in realtime mode\n");
     global->passes = 1;
   }
+
+#if !CONFIG_MULTITHREAD
+  if (global->pipeline_depth) {
+    warn("Ignoring --pipeline-depth, built without multithreading\n");
+    global->pipeline_depth = 0;
+  }
+  if (global->y4m_threads > 1) {
+    warn("Ignoring --y4m-threads, built without multithreading\n");
+    global->y4m_threads = 0;
+  }
+#endif
 }
 
 static struct stream_state *new_stream(struct VpxEncoderConfig *global,
@@ -1471,6 +1504,43 @@ static void update_quantizer_histogram(struct stream_state *stream) {
   }
 }
 
+static void write_frame_pkt(struct stream_state *stream,
+                            const vpx_codec_cx_pkt_t *pkt) {
+  static size_t fsize = 0;
+  static FileOffset ivf_header_pos = 0;
+
+#if CONFIG_WEBM_IO
+  if (stream->config.write_webm) {
+    write_webm_block(&stream->webm_ctx, &stream->config.cfg, pkt);
+  }
+#endif
+  if (!stream->config.write_webm) {
+    if (pkt->data.frame.partition_id <= 0) {
+      ivf_header_pos = ftello(stream->file);
+      fsize = pkt->data.frame.sz;
+
+      ivf_write_frame_header(stream->file, pkt->data.frame.pts, fsize);
+    } else {
+      fsize += pkt->data.frame.sz;
+
+      if (!(pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT)) {
+        const FileOffset currpos = ftello(stream->file);
+        fseeko(stream->file, ivf_header_pos, SEEK_SET);
+        ivf_write_frame_size(stream->file, fsize);
+        fseeko(stream->file, currpos, SEEK_SET);
+      }
+    }
+
+    (void)fwrite(pkt->data.frame.buf, 1, pkt->data.frame.sz, stream->file);
+  }
+}
+
+#if CONFIG_MULTITHREAD
+static void packet_queue_push(struct packet_queue *queue,
+                              struct stream_state *stream,
+                              const vpx_codec_cx_pkt_t *pkt);
+#endif
+
 static void get_cx_data(struct stream_state *stream,
                         struct VpxEncoderConfig *global, int *got_data) {
   const vpx_codec_cx_pkt_t *pkt;
@@ -1479,9 +1549,6 @@ static void get_cx_data(struct stream_state *stream,
 
   *got_data = 0;
   while ((pkt = vpx_codec_get_cx_data(&stream->encoder, &iter))) {
-    static size_t fsize = 0;
-    static FileOffset ivf_header_pos = 0;
-
     switch (pkt->kind) {
       case VPX_CODEC_CX_FRAME_PKT:
         if (!(pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT)) {
@@ -1491,31 +1558,12 @@ static void get_cx_data(struct stream_state *stream,
           fprintf(stderr, " %6luF", (unsigned long)pkt->data.frame.sz);
 
         update_rate_histogram(stream->rate_hist, cfg, pkt);
-#if CONFIG_WEBM_IO
-        if (stream->config.write_webm) {
-          write_webm_block(&stream->webm_ctx, cfg, pkt);
-        }
+#if CONFIG_MULTITHREAD
+        if (stream->pkt_queue)
+          packet_queue_push(stream->pkt_queue, stream, pkt);
+        else
 #endif
-        if (!stream->config.write_webm) {
-          if (pkt->data.frame.partition_id <= 0) {
-            ivf_header_pos = ftello(stream->file);
-            fsize = pkt->data.frame.sz;
-
-            ivf_write_frame_header(stream->file, pkt->data.frame.pts, fsize);
-          } else {
-            fsize += pkt->data.frame.sz;
-
-            if (!(pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT)) {
-              const FileOffset currpos = ftello(stream->file);
-              fseeko(stream->file, ivf_header_pos, SEEK_SET);
-              ivf_write_frame_size(stream->file, fsize);
-              fseeko(stream->file, currpos, SEEK_SET);
-            }
-          }
-
-          (void)fwrite(pkt->data.frame.buf, 1, pkt->data.frame.sz,
-                       stream->file);
-        }
+          write_frame_pkt(stream, pkt);
         stream->nbytes += pkt->data.raw.sz;
 
         *got_data = 1;
@@ -1659,6 +1707,312 @@ static void test_decode(struct stream_state *stream,
   vpx_img_free(&dec_img);
 }
 
+static int64_t input_position(struct VpxInputContext *input) {
+  if (input->map.data) return (int64_t)input->map.position;
+  return ftello(input->file);
+}
+
+#if CONFIG_MULTITHREAD
+/* Number and length of the waits of a pipeline stage on its neighbours. */
+struct stage_stalls {
+  unsigned int count;
+  int64_t usec;
+};
+
+/* Input frames read ahead of the encoder into a ring of preallocated
+ * images. The encoder holds on to the frame at the head until it asks for
+ * the next one. The input position after each frame is kept along with it,
+ * as the reader has moved past it by the time the frame is encoded.
+ */
+struct frame_ring {
+  struct VpxInputContext *input;
+  vpx_image_t *imgs;
+  int64_t *positions;
+  int depth;
+  int limit;
+  int head;
+  int count;
+  int in_use;
+  int done;
+  int quit;
+  struct stage_stalls reader_stalls;
+  struct stage_stalls encoder_stalls;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  pthread_t thread;
+};
+
+struct packet_entry {
+  struct stream_state *stream;
+  vpx_codec_cx_pkt_t pkt;
+  void *buf;
+  size_t buf_sz;
+};
+
+/* Frame packets waiting for the writer. Packets are only valid until the
+ * next call into their encoder, so the queue holds copies.
+ */
+struct packet_queue {
+  struct packet_entry *entries;
+  int depth;
+  int head;
+  int count;
+  int done;
+  struct stage_stalls encoder_stalls;
+  struct stage_stalls writer_stalls;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  pthread_t thread;
+};
+
+static void stall_start(struct stage_stalls *stalls,
+                        struct vpx_usec_timer *timer) {
+  stalls->count++;
+  vpx_usec_timer_start(timer);
+}
+
+static void stall_end(struct stage_stalls *stalls,
+                      struct vpx_usec_timer *timer) {
+  vpx_usec_timer_mark(timer);
+  stalls->usec += vpx_usec_timer_elapsed(timer);
+}
+
+static int frame_ring_read(struct VpxInputContext *input, vpx_image_t *img) {
+  vpx_image_t y4m_img;
+  int plane;
+
+  if (input->file_type != FILE_TYPE_Y4M) return read_frame(input, img);
+
+  /* The Y4M reader hands out its own buffer, reused by the next read. */
+  if (!read_frame(input, &y4m_img)) return 0;
+  for (plane = 0; plane < 3; ++plane) {
+    const int bytespp = (y4m_img.fmt & VPX_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+    const int w = vpx_img_plane_width(&y4m_img, plane) * bytespp;
+    const int h = vpx_img_plane_height(&y4m_img, plane);
+    const unsigned char *src = y4m_img.planes[plane];
+    unsigned char *dst = img->planes[plane];
+    int y;
+
+    for (y = 0; y < h; ++y) {
+      memcpy(dst, src, w);
+      src += y4m_img.stride[plane];
+      dst += img->stride[plane];
+    }
+  }
+  img->bit_depth = y4m_img.bit_depth;
+  return 1;
+}
+
+static THREADFN frame_ring_reader(void *arg) {
+  struct frame_ring *const ring = (struct frame_ring *)arg;
+  int frames = 0;
+
+  for (;;) {
+    vpx_image_t *img;
+    int slot;
+    int ok;
+
+    pthread_mutex_lock(&ring->mutex);
+    if (ring->count == ring->depth && !ring->quit) {
+      struct vpx_usec_timer timer;
+      stall_start(&ring->reader_stalls, &timer);
+      while (ring->count == ring->depth && !ring->quit)
+        pthread_cond_wait(&ring->cond, &ring->mutex);
+      stall_end(&ring->reader_stalls, &timer);
+    }
+    if (ring->quit) {
+      pthread_mutex_unlock(&ring->mutex);
+      break;
+    }
+    slot = (ring->head + ring->count) % ring->depth;
+    img = &ring->imgs[slot];
+    pthread_mutex_unlock(&ring->mutex);
+
+    ok = (!ring->limit || frames < ring->limit) &&
+         frame_ring_read(ring->input, img);
+    if (ok) ring->positions[slot] = input_position(ring->input);
+
+    pthread_mutex_lock(&ring->mutex);
+    if (ok) {
+      ring->count++;
+      frames++;
+    } else {
+      ring->done = 1;
+    }
+    pthread_cond_signal(&ring->cond);
+    pthread_mutex_unlock(&ring->mutex);
+    if (!ok) break;
+  }
+  return THREAD_EXIT_SUCCESS;
+}
+
+static void frame_ring_start(struct frame_ring *ring,
+                             struct VpxInputContext *input, int depth,
+                             int max_frames) {
+  int i;
+
+  memset(ring, 0, sizeof(*ring));
+  ring->input = input;
+  ring->depth = depth;
+  ring->limit = max_frames;
+  ring->imgs = calloc(depth, sizeof(*ring->imgs));
+  ring->positions = calloc(depth, sizeof(*ring->positions));
+  if (!ring->imgs || !ring->positions) fatal("Failed to allocate frame ring");
+  for (i = 0; i < depth; ++i) {
+    if (!vpx_img_alloc(&ring->imgs[i], input->fmt, input->width,
+                       input->height, 32))
+      fatal("Failed to allocate frame ring");
+  }
+  pthread_mutex_init(&ring->mutex, NULL);
+  pthread_cond_init(&ring->cond, NULL);
+  if (pthread_create(&ring->thread, NULL, frame_ring_reader, ring))
+    fatal("Failed to create reader thread");
+}
+
+/* Returns the next input frame, or NULL at the end of the input. The input
+ * position after the frame is stored in 'position'.
+ */
+static vpx_image_t *frame_ring_get(struct frame_ring *ring,
+                                   int64_t *position) {
+  vpx_image_t *img = NULL;
+
+  pthread_mutex_lock(&ring->mutex);
+  if (ring->in_use) {
+    ring->head = (ring->head + 1) % ring->depth;
+    ring->count--;
+    ring->in_use = 0;
+    pthread_cond_signal(&ring->cond);
+  }
+  if (!ring->count && !ring->done) {
+    struct vpx_usec_timer timer;
+    stall_start(&ring->encoder_stalls, &timer);
+    while (!ring->count && !ring->done)
+      pthread_cond_wait(&ring->cond, &ring->mutex);
+    stall_end(&ring->encoder_stalls, &timer);
+  }
+  if (ring->count) {
+    img = &ring->imgs[ring->head];
+    *position = ring->positions[ring->head];
+    ring->in_use = 1;
+  }
+  pthread_mutex_unlock(&ring->mutex);
+  return img;
+}
+
+static void frame_ring_stop(struct frame_ring *ring) {
+  int i;
+
+  pthread_mutex_lock(&ring->mutex);
+  ring->quit = 1;
+  pthread_cond_signal(&ring->cond);
+  pthread_mutex_unlock(&ring->mutex);
+  pthread_join(ring->thread, NULL);
+  pthread_mutex_destroy(&ring->mutex);
+  pthread_cond_destroy(&ring->cond);
+  for (i = 0; i < ring->depth; ++i) vpx_img_free(&ring->imgs[i]);
+  free(ring->imgs);
+  free(ring->positions);
+  ring->imgs = NULL;
+  ring->positions = NULL;
+}
+
+static THREADFN packet_queue_writer(void *arg) {
+  struct packet_queue *const queue = (struct packet_queue *)arg;
+
+  pthread_mutex_lock(&queue->mutex);
+  for (;;) {
+    struct packet_entry *entry;
+
+    if (!queue->count && !queue->done) {
+      struct vpx_usec_timer timer;
+      stall_start(&queue->writer_stalls, &timer);
+      while (!queue->count && !queue->done)
+        pthread_cond_wait(&queue->cond, &queue->mutex);
+      stall_end(&queue->writer_stalls, &timer);
+    }
+    if (!queue->count) break;
+    entry = &queue->entries[queue->head];
+    pthread_mutex_unlock(&queue->mutex);
+
+    write_frame_pkt(entry->stream, &entry->pkt);
+
+    pthread_mutex_lock(&queue->mutex);
+    queue->head = (queue->head + 1) % queue->depth;
+    queue->count--;
+    pthread_cond_signal(&queue->cond);
+  }
+  pthread_mutex_unlock(&queue->mutex);
+  return THREAD_EXIT_SUCCESS;
+}
+
+static void packet_queue_start(struct packet_queue *queue, int depth) {
+  memset(queue, 0, sizeof(*queue));
+  queue->depth = depth;
+  queue->entries = calloc(depth, sizeof(*queue->entries));
+  if (!queue->entries) fatal("Failed to allocate packet queue");
+  pthread_mutex_init(&queue->mutex, NULL);
+  pthread_cond_init(&queue->cond, NULL);
+  if (pthread_create(&queue->thread, NULL, packet_queue_writer, queue))
+    fatal("Failed to create writer thread");
+}
+
+static void packet_queue_push(struct packet_queue *queue,
+                              struct stream_state *stream,
+                              const vpx_codec_cx_pkt_t *pkt) {
+  const size_t sz = pkt->data.frame.sz;
+  struct packet_entry *entry;
+
+  pthread_mutex_lock(&queue->mutex);
+  if (queue->count == queue->depth) {
+    struct vpx_usec_timer timer;
+    stall_start(&queue->encoder_stalls, &timer);
+    while (queue->count == queue->depth)
+      pthread_cond_wait(&queue->cond, &queue->mutex);
+    stall_end(&queue->encoder_stalls, &timer);
+  }
+  entry = &queue->entries[(queue->head + queue->count) % queue->depth];
+  pthread_mutex_unlock(&queue->mutex);
+
+  if (sz > entry->buf_sz) {
+    void *const buf = realloc(entry->buf, sz);
+    if (!buf) fatal("Failed to allocate packet buffer");
+    entry->buf = buf;
+    entry->buf_sz = sz;
+  }
+  if (sz) memcpy(entry->buf, pkt->data.frame.buf, sz);
+  entry->stream = stream;
+  entry->pkt = *pkt;
+  entry->pkt.data.frame.buf = entry->buf;
+
+  pthread_mutex_lock(&queue->mutex);
+  queue->count++;
+  pthread_cond_signal(&queue->cond);
+  pthread_mutex_unlock(&queue->mutex);
+}
+
+/* Waits for the writer to drain the queue. */
+static void packet_queue_finish(struct packet_queue *queue) {
+  int i;
+
+  pthread_mutex_lock(&queue->mutex);
+  queue->done = 1;
+  pthread_cond_signal(&queue->cond);
+  pthread_mutex_unlock(&queue->mutex);
+  pthread_join(queue->thread, NULL);
+  pthread_mutex_destroy(&queue->mutex);
+  pthread_cond_destroy(&queue->cond);
+  for (i = 0; i < queue->depth; ++i) free(queue->entries[i].buf);
+  free(queue->entries);
+  queue->entries = NULL;
+}
+
+static void show_stage_stalls(const char *stage,
+                              const struct stage_stalls *stalls) {
+  fprintf(stderr, "  %-22s %6u stalls %10.3f ms\n", stage, stalls->count,
+          stalls->usec / 1000.0);
+}
+#endif  // CONFIG_MULTITHREAD
+
 static void print_time(const char *label, int64_t etl) {
   int64_t hours;
   int64_t mins;
@@ -1696,6 +2050,10 @@ int main(int argc, const char **argv_) {
   uint64_t cx_time = 0;
   int stream_cnt = 0;
   int res = 0;
+#if CONFIG_MULTITHREAD
+  struct frame_ring ring;
+  struct packet_queue pkt_queue;
+#endif
 
   memset(&input, 0, sizeof(input));
   memset(&raw, 0, sizeof(raw));
@@ -1764,11 +2122,19 @@ int main(int argc, const char **argv_) {
 
   for (pass = global.pass ? global.pass - 1 : 0; pass < global.passes; pass++) {
     int frames_in = 0, seen_frames = 0;
+    vpx_image_t *img_in = &raw;
     int64_t estimated_time_left = -1;
     int64_t average_rate = -1;
     int64_t lagged_count = 0;
+    int64_t input_pos = 0;
 
     open_input_file(&input);
+    // NV12 input has its chroma read differently and is always streamed.
+    if (global.mmap_input && input.fmt != VPX_IMG_FMT_NV12)
+      map_input_file(&input);
+    if (global.y4m_threads > 1 && input.file_type == FILE_TYPE_Y4M &&
+        y4m_input_set_threads(&input.y4m, global.y4m_threads))
+      warn("Failed to start the Y4M conversion threads\n");
 
     /* If the input file doesn't specify its w/h (raw files), try to get
      * the data from the first stream's configuration.
@@ -1861,6 +2227,14 @@ int main(int argc, const char **argv_) {
         open_output_file(stream, &global, &input.pixel_aspect_ratio));
     FOREACH_STREAM(initialize_encoder(stream, &global));
 
+#if CONFIG_MULTITHREAD
+    if (global.pipeline_depth) {
+      frame_ring_start(&ring, &input, global.pipeline_depth, global.limit);
+      packet_queue_start(&pkt_queue, global.pipeline_depth);
+      FOREACH_STREAM(stream->pkt_queue = &pkt_queue);
+    }
+#endif
+
 #if CONFIG_VP9_HIGHBITDEPTH
     if (strcmp(global.codec->name, "vp9") == 0) {
       // Check to see if at least one stream uses 16 bit internal.
@@ -1887,7 +2261,17 @@ int main(int argc, const char **argv_) {
       struct vpx_usec_timer timer;
 
       if (!global.limit || frames_in < global.limit) {
-        frame_avail = read_frame(&input, &raw);
+#if CONFIG_MULTITHREAD
+        if (global.pipeline_depth) {
+          vpx_image_t *const img = frame_ring_get(&ring, &input_pos);
+          frame_avail = img != NULL;
+          if (img) img_in = img;
+        } else
+#endif
+        {
+          frame_avail = read_frame(&input, &raw);
+          input_pos = input_position(&input);
+        }
 
         if (frame_avail) frames_in++;
         seen_frames =
@@ -1921,14 +2305,14 @@ int main(int argc, const char **argv_) {
           // Input bit depth and stream bit depth do not match, so up
           // shift frame to stream bit depth
           if (!allocated_raw_shift) {
-            vpx_img_alloc(&raw_shift, raw.fmt | VPX_IMG_FMT_HIGHBITDEPTH,
+            vpx_img_alloc(&raw_shift, img_in->fmt | VPX_IMG_FMT_HIGHBITDEPTH,
                           input.width, input.height, 32);
             allocated_raw_shift = 1;
           }
-          vpx_img_upshift(&raw_shift, &raw, input_shift);
+          if (frame_avail) vpx_img_upshift(&raw_shift, img_in, input_shift);
           frame_to_encode = &raw_shift;
         } else {
-          frame_to_encode = &raw;
+          frame_to_encode = img_in;
         }
         vpx_usec_timer_start(&timer);
         if (use_16bit_internal) {
@@ -1948,8 +2332,8 @@ int main(int argc, const char **argv_) {
         }
 #else
         vpx_usec_timer_start(&timer);
-        FOREACH_STREAM(encode_frame(stream, &global, frame_avail ? &raw : NULL,
-                                    frames_in));
+        FOREACH_STREAM(encode_frame(stream, &global,
+                                    frame_avail ? img_in : NULL, frames_in));
 #endif
         vpx_usec_timer_mark(&timer);
         cx_time += vpx_usec_timer_elapsed(&timer);
@@ -1961,7 +2345,7 @@ int main(int argc, const char **argv_) {
 
         if (!got_data && input.length && streams != NULL &&
             !streams->frames_out) {
-          lagged_count = global.limit ? seen_frames : ftello(input.file);
+          lagged_count = global.limit ? seen_frames : input_pos;
         } else if (input.length) {
           int64_t remaining;
           int64_t rate;
@@ -1973,7 +2357,6 @@ int main(int argc, const char **argv_) {
             remaining = 1000 * (global.limit - global.skip_frames -
                                 seen_frames + lagged_count);
           } else {
-            const int64_t input_pos = ftello(input.file);
             const int64_t input_pos_lagged = input_pos - lagged_count;
 
             rate = cx_time ? input_pos_lagged * (int64_t)1000000 / cx_time : 0;
@@ -1993,6 +2376,14 @@ int main(int argc, const char **argv_) {
       if (!global.quiet) fprintf(stderr, "\033[K");
     }
 
+#if CONFIG_MULTITHREAD
+    if (global.pipeline_depth) {
+      frame_ring_stop(&ring);
+      packet_queue_finish(&pkt_queue);
+      FOREACH_STREAM(stream->pkt_queue = NULL);
+    }
+#endif
+
     if (stream_cnt > 1) fprintf(stderr, "\n");
 
     if (!global.quiet) {
@@ -2021,6 +2412,17 @@ int main(int argc, const char **argv_) {
       }
     }
 
+#if CONFIG_MULTITHREAD
+    if (global.pipeline_depth && global.verbose) {
+      fprintf(stderr, "Pipeline stalls, pass %d/%d:\n", pass + 1,
+              global.passes);
+      show_stage_stalls("reader (ring full)", &ring.reader_stalls);
+      show_stage_stalls("encoder (ring empty)", &ring.encoder_stalls);
+      show_stage_stalls("encoder (queue full)", &pkt_queue.encoder_stalls);
+      show_stage_stalls("writer (queue empty)", &pkt_queue.writer_stalls);
+    }
+#endif
+
     FOREACH_STREAM(vpx_codec_destroy(&stream->encoder));
 
     if (global.test_decode != TEST_DECODE_OFF) {
@@ -45,6 +45,9 @@ struct VpxEncoderConfig {
   int verbose;
   int limit;
   int skip_frames;
+  int mmap_input;
+  int pipeline_depth;
+  int y4m_threads;
   int show_psnr;
   enum TestDecodeFatality test_decode;
   int have_framerate;
@@ -16,9 +16,36 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "./vpx_config.h"
 #include "vpx/vpx_integer.h"
 #include "y4minput.h"
 
+#if CONFIG_MULTITHREAD
+#include "vpx_util/vpx_pthread.h"
+#endif
+
+/*The SIMD conversion kernels are chosen at compile time: the tools have no
+   run time CPU detection, so AVX2 is only used when the compiler targets it.*/
+#if HAVE_SSE2 && (defined(__SSE2__) || defined(_M_X64) || \
+                  (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define Y4M_SSE2 1
+#else
+#define Y4M_SSE2 0
+#endif
+#if Y4M_SSE2 && HAVE_AVX2 && defined(__AVX2__)
+#include <immintrin.h>
+#define Y4M_AVX2 1
+#else
+#define Y4M_AVX2 0
+#endif
+#if HAVE_NEON && (defined(__ARM_NEON) || defined(_M_ARM64))
+#include <arm_neon.h>
+#define Y4M_NEON 1
+#else
+#define Y4M_NEON 0
+#endif
+
 // Reads 'size' bytes from 'file' into 'buf' with some fault tolerance.
 // Returns true on success.
 static int file_read(void *buf, size_t size, FILE *file) {
@@ -206,6 +233,484 @@ static int parse_tags(y4m_input *y4m_ctx, FILE *file) {
 #define OC_MAXI(_a, _b) ((_a) < (_b) ? (_b) : (_a))
 #define OC_CLAMPI(_a, _b, _c) (OC_MAXI(_a, OC_MINI(_b, _c)))
 
+/*Filter: [4 -17 114 35 -9 1]/128, derived from a 6-tap Lanczos window.*/
+static unsigned char y4m_shift6(int _a, int _b, int _c, int _d, int _e,
+                                int _f) {
+  return (unsigned char)OC_CLAMPI(
+      0, (4 * _a - 17 * _b + 114 * _c + 35 * _d - 9 * _e + _f + 64) >> 7, 255);
+}
+
+/*Filter: [3 -17 78 78 -17 3]/128, derived from a 6-tap Lanczos window.*/
+static unsigned char y4m_decimate6(int _a, int _b, int _c, int _d, int _e,
+                                   int _f) {
+  return (unsigned char)OC_CLAMPI(
+      0, (3 * (_a + _f) - 17 * (_b + _e) + 78 * (_c + _d) + 64) >> 7, 255);
+}
+
+/*The SIMD kernels below are bit-exact with the filters above: the positive
+   and negative taps are summed separately in 16 bits (the positive sum of
+   either filter stays below 2^16), then subtracted with unsigned saturation,
+   which gives the clamp to 0, and the shifted result is packed with unsigned
+   saturation, which gives the clamp to 255.*/
+#if Y4M_SSE2
+static void y4m_shift16_sse2(unsigned char *_dst, const unsigned char *_src) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i res[2];
+  int i;
+  for (i = 0; i < 2; i++) {
+    __m128i s[6];
+    __m128i pos;
+    __m128i neg;
+    int k;
+    for (k = 0; k < 6; k++) {
+      const __m128i v = _mm_loadu_si128((const __m128i *)(_src + k - 2));
+      s[k] = i ? _mm_unpackhi_epi8(v, zero) : _mm_unpacklo_epi8(v, zero);
+    }
+    pos = _mm_add_epi16(_mm_slli_epi16(s[0], 2), s[5]);
+    pos = _mm_add_epi16(pos, _mm_mullo_epi16(s[2], _mm_set1_epi16(114)));
+    pos = _mm_add_epi16(pos, _mm_mullo_epi16(s[3], _mm_set1_epi16(35)));
+    pos = _mm_add_epi16(pos, _mm_set1_epi16(64));
+    neg = _mm_add_epi16(_mm_mullo_epi16(s[1], _mm_set1_epi16(17)),
+                        _mm_mullo_epi16(s[4], _mm_set1_epi16(9)));
+    res[i] = _mm_srli_epi16(_mm_subs_epu16(pos, neg), 7);
+  }
+  _mm_storeu_si128((__m128i *)_dst, _mm_packus_epi16(res[0], res[1]));
+}
+
+static __m128i y4m_decimate8_sse2(__m128i _a, __m128i _b, __m128i _c,
+                                  __m128i _d, __m128i _e, __m128i _f) {
+  __m128i pos;
+  __m128i neg;
+  pos = _mm_mullo_epi16(_mm_add_epi16(_a, _f), _mm_set1_epi16(3));
+  pos = _mm_add_epi16(
+      pos, _mm_mullo_epi16(_mm_add_epi16(_c, _d), _mm_set1_epi16(78)));
+  pos = _mm_add_epi16(pos, _mm_set1_epi16(64));
+  neg = _mm_mullo_epi16(_mm_add_epi16(_b, _e), _mm_set1_epi16(17));
+  return _mm_srli_epi16(_mm_subs_epu16(pos, neg), 7);
+}
+
+static void y4m_decimate16v_sse2(unsigned char *_dst,
+                                 const unsigned char *const *_rows, int _x) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i lo[6];
+  __m128i hi[6];
+  int k;
+  for (k = 0; k < 6; k++) {
+    const __m128i v = _mm_loadu_si128((const __m128i *)(_rows[k] + _x));
+    lo[k] = _mm_unpacklo_epi8(v, zero);
+    hi[k] = _mm_unpackhi_epi8(v, zero);
+  }
+  _mm_storeu_si128(
+      (__m128i *)(_dst + _x),
+      _mm_packus_epi16(
+          y4m_decimate8_sse2(lo[0], lo[1], lo[2], lo[3], lo[4], lo[5]),
+          y4m_decimate8_sse2(hi[0], hi[1], hi[2], hi[3], hi[4], hi[5])));
+}
+
+/*Computes the 8 outputs of source columns _src[0], _src[2], ..., _src[14]:
+   the 16-bit lanes of the loads at -2, 0 and +2 hold the even taps of each
+   output in their low byte and the odd taps in their high byte.*/
+static void y4m_decimate8h_sse2(unsigned char *_dst,
+                                const unsigned char *_src) {
+  const __m128i mask = _mm_set1_epi16(0xff);
+  const __m128i a = _mm_loadu_si128((const __m128i *)(_src - 2));
+  const __m128i b = _mm_loadu_si128((const __m128i *)_src);
+  const __m128i c = _mm_loadu_si128((const __m128i *)(_src + 2));
+  const __m128i res = y4m_decimate8_sse2(
+      _mm_and_si128(a, mask), _mm_srli_epi16(a, 8), _mm_and_si128(b, mask),
+      _mm_srli_epi16(b, 8), _mm_and_si128(c, mask), _mm_srli_epi16(c, 8));
+  _mm_storel_epi64((__m128i *)_dst, _mm_packus_epi16(res, res));
+}
+#endif
+
+#if Y4M_AVX2
+static void y4m_shift32_avx2(unsigned char *_dst, const unsigned char *_src) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i res[2];
+  int i;
+  for (i = 0; i < 2; i++) {
+    __m256i s[6];
+    __m256i pos;
+    __m256i neg;
+    int k;
+    for (k = 0; k < 6; k++) {
+      const __m256i v = _mm256_loadu_si256((const __m256i *)(_src + k - 2));
+      s[k] = i ? _mm256_unpackhi_epi8(v, zero) : _mm256_unpacklo_epi8(v, zero);
+    }
+    pos = _mm256_add_epi16(_mm256_slli_epi16(s[0], 2), s[5]);
+    pos = _mm256_add_epi16(pos,
+                           _mm256_mullo_epi16(s[2], _mm256_set1_epi16(114)));
+    pos = _mm256_add_epi16(pos,
+                           _mm256_mullo_epi16(s[3], _mm256_set1_epi16(35)));
+    pos = _mm256_add_epi16(pos, _mm256_set1_epi16(64));
+    neg = _mm256_add_epi16(_mm256_mullo_epi16(s[1], _mm256_set1_epi16(17)),
+                           _mm256_mullo_epi16(s[4], _mm256_set1_epi16(9)));
+    res[i] = _mm256_srli_epi16(_mm256_subs_epu16(pos, neg), 7);
+  }
+  _mm256_storeu_si256((__m256i *)_dst, _mm256_packus_epi16(res[0], res[1]));
+}
+
+static __m256i y4m_decimate16_avx2(__m256i _a, __m256i _b, __m256i _c,
+                                   __m256i _d, __m256i _e, __m256i _f) {
+  __m256i pos;
+  __m256i neg;
+  pos = _mm256_mullo_epi16(_mm256_add_epi16(_a, _f), _mm256_set1_epi16(3));
+  pos = _mm256_add_epi16(
+      pos, _mm256_mullo_epi16(_mm256_add_epi16(_c, _d), _mm256_set1_epi16(78)));
+  pos = _mm256_add_epi16(pos, _mm256_set1_epi16(64));
+  neg = _mm256_mullo_epi16(_mm256_add_epi16(_b, _e), _mm256_set1_epi16(17));
+  return _mm256_srli_epi16(_mm256_subs_epu16(pos, neg), 7);
+}
+
+static void y4m_decimate32v_avx2(unsigned char *_dst,
+                                 const unsigned char *const *_rows, int _x) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i lo[6];
+  __m256i hi[6];
+  int k;
+  for (k = 0; k < 6; k++) {
+    const __m256i v = _mm256_loadu_si256((const __m256i *)(_rows[k] + _x));
+    lo[k] = _mm256_unpacklo_epi8(v, zero);
+    hi[k] = _mm256_unpackhi_epi8(v, zero);
+  }
+  _mm256_storeu_si256(
+      (__m256i *)(_dst + _x),
+      _mm256_packus_epi16(
+          y4m_decimate16_avx2(lo[0], lo[1], lo[2], lo[3], lo[4], lo[5]),
+          y4m_decimate16_avx2(hi[0], hi[1], hi[2], hi[3], hi[4], hi[5])));
+}
+
+/*As y4m_decimate8h_sse2(), for 16 outputs.*/
+static void y4m_decimate16h_avx2(unsigned char *_dst,
+                                 const unsigned char *_src) {
+  const __m256i mask = _mm256_set1_epi16(0xff);
+  const __m256i a = _mm256_loadu_si256((const __m256i *)(_src - 2));
+  const __m256i b = _mm256_loadu_si256((const __m256i *)_src);
+  const __m256i c = _mm256_loadu_si256((const __m256i *)(_src + 2));
+  __m256i res = y4m_decimate16_avx2(
+      _mm256_and_si256(a, mask), _mm256_srli_epi16(a, 8),
+      _mm256_and_si256(b, mask), _mm256_srli_epi16(b, 8),
+      _mm256_and_si256(c, mask), _mm256_srli_epi16(c, 8));
+  /*Each lane packs its 8 outputs into its low 64 bits.*/
+  res = _mm256_permute4x64_epi64(_mm256_packus_epi16(res, res), 0x08);
+  _mm_storeu_si128((__m128i *)_dst, _mm256_castsi256_si128(res));
+}
+#endif
+
+#if Y4M_NEON
+static void y4m_shift16_neon(unsigned char *_dst, const unsigned char *_src) {
+  uint8x16_t s[6];
+  uint8x8_t res[2];
+  int i;
+  int k;
+  for (k = 0; k < 6; k++) s[k] = vld1q_u8(_src + k - 2);
+  for (i = 0; i < 2; i++) {
+    uint8x8_t t[6];
+    uint16x8_t pos;
+    uint16x8_t neg;
+    for (k = 0; k < 6; k++) t[k] = i ? vget_high_u8(s[k]) : vget_low_u8(s[k]);
+    pos = vaddw_u8(vdupq_n_u16(64), t[5]);
+    pos = vmlal_u8(pos, t[0], vdup_n_u8(4));
+    pos = vmlal_u8(pos, t[2], vdup_n_u8(114));
+    pos = vmlal_u8(pos, t[3], vdup_n_u8(35));
+    neg = vmull_u8(t[1], vdup_n_u8(17));
+    neg = vmlal_u8(neg, t[4], vdup_n_u8(9));
+    res[i] = vqshrn_n_u16(vqsubq_u16(pos, neg), 7);
+  }
+  vst1q_u8(_dst, vcombine_u8(res[0], res[1]));
+}
+
+static uint8x8_t y4m_decimate8_neon(uint8x8_t _a, uint8x8_t _b, uint8x8_t _c,
+                                    uint8x8_t _d, uint8x8_t _e, uint8x8_t _f) {
+  uint16x8_t pos;
+  uint16x8_t neg;
+  pos = vmlaq_n_u16(vdupq_n_u16(64), vaddl_u8(_a, _f), 3);
+  pos = vmlaq_n_u16(pos, vaddl_u8(_c, _d), 78);
+  neg = vmulq_n_u16(vaddl_u8(_b, _e), 17);
+  return vqshrn_n_u16(vqsubq_u16(pos, neg), 7);
+}
+
+static void y4m_decimate16v_neon(unsigned char *_dst,
+                                 const unsigned char *const *_rows, int _x) {
+  uint8x16_t r[6];
+  int k;
+  for (k = 0; k < 6; k++) r[k] = vld1q_u8(_rows[k] + _x);
+  vst1q_u8(_dst + _x,
+           vcombine_u8(y4m_decimate8_neon(vget_low_u8(r[0]), vget_low_u8(r[1]),
+                                          vget_low_u8(r[2]), vget_low_u8(r[3]),
+                                          vget_low_u8(r[4]), vget_low_u8(r[5])),
+                       y4m_decimate8_neon(
+                           vget_high_u8(r[0]), vget_high_u8(r[1]),
+                           vget_high_u8(r[2]), vget_high_u8(r[3]),
+                           vget_high_u8(r[4]), vget_high_u8(r[5]))));
+}
+
+/*Computes the 16 outputs of source columns _src[0], _src[2], ..., _src[30],
+   deinterleaving the even and odd taps with vld2.*/
+static void y4m_decimate16h_neon(unsigned char *_dst,
+                                 const unsigned char *_src) {
+  const uint8x16x2_t a = vld2q_u8(_src - 2);
+  const uint8x16x2_t b = vld2q_u8(_src);
+  const uint8x16x2_t c = vld2q_u8(_src + 2);
+  vst1q_u8(_dst, vcombine_u8(y4m_decimate8_neon(
+                                 vget_low_u8(a.val[0]), vget_low_u8(a.val[1]),
+                                 vget_low_u8(b.val[0]), vget_low_u8(b.val[1]),
+                                 vget_low_u8(c.val[0]), vget_low_u8(c.val[1])),
+                             y4m_decimate8_neon(vget_high_u8(a.val[0]),
+                                                vget_high_u8(a.val[1]),
+                                                vget_high_u8(b.val[0]),
+                                                vget_high_u8(b.val[1]),
+                                                vget_high_u8(c.val[0]),
+                                                vget_high_u8(c.val[1]))));
+}
+#endif
+
+/*Shifts the sites of one row of a 42xmpeg2 plane to 42xjpeg.*/
+static void y4m_42xmpeg2_42xjpeg_row(unsigned char *_dst,
+                                     const unsigned char *_src, int _c_w) {
+  int x;
+  for (x = 0; x < OC_MINI(_c_w, 2); x++) {
+    _dst[x] = y4m_shift6(_src[0], _src[OC_MAXI(x - 1, 0)], _src[x],
+                         _src[OC_MINI(x + 1, _c_w - 1)],
+                         _src[OC_MINI(x + 2, _c_w - 1)],
+                         _src[OC_MINI(x + 3, _c_w - 1)]);
+  }
+#if Y4M_AVX2
+  for (; x + 32 <= _c_w - 3; x += 32) y4m_shift32_avx2(_dst + x, _src + x);
+#endif
+#if Y4M_SSE2
+  for (; x + 16 <= _c_w - 3; x += 16) y4m_shift16_sse2(_dst + x, _src + x);
+#elif Y4M_NEON
+  for (; x + 16 <= _c_w - 3; x += 16) y4m_shift16_neon(_dst + x, _src + x);
+#endif
+  for (; x < _c_w - 3; x++) {
+    _dst[x] = y4m_shift6(_src[x - 2], _src[x - 1], _src[x], _src[x + 1],
+                         _src[x + 2], _src[x + 3]);
+  }
+  for (; x < _c_w; x++) {
+    _dst[x] = y4m_shift6(_src[x - 2], _src[x - 1], _src[x],
+                         _src[OC_MINI(x + 1, _c_w - 1)],
+                         _src[OC_MINI(x + 2, _c_w - 1)], _src[_c_w - 1]);
+  }
+}
+
+/*Decimates one row of a 444 plane by two horizontally.*/
+static void y4m_444_422jpeg_row(unsigned char *_dst, const unsigned char *_src,
+                                int _c_w) {
+  int x;
+  for (x = 0; x < OC_MINI(_c_w, 2); x += 2) {
+    _dst[x >> 1] = y4m_decimate6(
+        _src[0], _src[0], _src[0], _src[OC_MINI(1, _c_w - 1)],
+        _src[OC_MINI(2, _c_w - 1)], _src[OC_MINI(3, _c_w - 1)]);
+  }
+#if Y4M_AVX2
+  for (; x + 34 <= _c_w; x += 32) {
+    y4m_decimate16h_avx2(_dst + (x >> 1), _src + x);
+  }
+#endif
+#if Y4M_SSE2
+  for (; x + 18 <= _c_w; x += 16) {
+    y4m_decimate8h_sse2(_dst + (x >> 1), _src + x);
+  }
+#elif Y4M_NEON
+  for (; x + 34 <= _c_w; x += 32) {
+    y4m_decimate16h_neon(_dst + (x >> 1), _src + x);
+  }
+#endif
+  for (; x < _c_w - 3; x += 2) {
+    _dst[x >> 1] = y4m_decimate6(_src[x - 2], _src[x - 1], _src[x],
+                                 _src[x + 1], _src[x + 2], _src[x + 3]);
+  }
+  for (; x < _c_w; x += 2) {
+    _dst[x >> 1] = y4m_decimate6(
+        _src[x - 2], _src[x - 1], _src[x], _src[OC_MINI(x + 1, _c_w - 1)],
+        _src[OC_MINI(x + 2, _c_w - 1)], _src[_c_w - 1]);
+  }
+}
+
+/*Computes one row of a plane decimated by two vertically from the six source
+   rows under its filter taps.*/
+static void y4m_422jpeg_420jpeg_row(unsigned char *_dst,
+                                    const unsigned char *const *_rows,
+                                    int _c_w) {
+  int x = 0;
+#if Y4M_AVX2
+  for (; x + 32 <= _c_w; x += 32) y4m_decimate32v_avx2(_dst, _rows, x);
+#endif
+#if Y4M_SSE2
+  for (; x + 16 <= _c_w; x += 16) y4m_decimate16v_sse2(_dst, _rows, x);
+#elif Y4M_NEON
+  for (; x + 16 <= _c_w; x += 16) y4m_decimate16v_neon(_dst, _rows, x);
+#endif
+  for (; x < _c_w; x++) {
+    _dst[x] = y4m_decimate6(_rows[0][x], _rows[1][x], _rows[2][x],
+                            _rows[3][x], _rows[4][x], _rows[5][x]);
+  }
+}
+
+typedef enum {
+  Y4M_PASS_SHIFT_H,
+  Y4M_PASS_DECIMATE_H,
+  Y4M_PASS_DECIMATE_V
+} y4m_pass_type;
+
+/*One filtering pass over a chroma plane. Every output row depends only on
+   the source plane, so a pass can be split into bands of output rows.*/
+typedef struct {
+  y4m_pass_type type;
+  unsigned char *dst;
+  const unsigned char *src;
+  int src_w;
+  int src_h;
+  int dst_w;
+  int dst_h;
+} y4m_pass;
+
+static y4m_pass y4m_make_pass(y4m_pass_type _type, unsigned char *_dst,
+                              const unsigned char *_src, int _src_w,
+                              int _src_h) {
+  y4m_pass pass;
+  pass.type = _type;
+  pass.dst = _dst;
+  pass.src = _src;
+  pass.src_w = _src_w;
+  pass.src_h = _src_h;
+  pass.dst_w = _type == Y4M_PASS_DECIMATE_H ? (_src_w + 1) >> 1 : _src_w;
+  pass.dst_h = _type == Y4M_PASS_DECIMATE_V ? (_src_h + 1) >> 1 : _src_h;
+  return pass;
+}
+
+static void y4m_run_pass_rows(const y4m_pass *_pass, int _y0, int _y1) {
+  int y;
+  for (y = _y0; y < _y1; y++) {
+    unsigned char *dst = _pass->dst + y * _pass->dst_w;
+    switch (_pass->type) {
+      case Y4M_PASS_SHIFT_H:
+        y4m_42xmpeg2_42xjpeg_row(dst, _pass->src + y * _pass->src_w,
+                                 _pass->src_w);
+        break;
+      case Y4M_PASS_DECIMATE_H:
+        y4m_444_422jpeg_row(dst, _pass->src + y * _pass->src_w, _pass->src_w);
+        break;
+      default: {
+        const unsigned char *rows[6];
+        int k;
+        assert(_pass->type == Y4M_PASS_DECIMATE_V);
+        for (k = 0; k < 6; k++) {
+          rows[k] =
+              _pass->src +
+              OC_CLAMPI(0, 2 * y - 2 + k, _pass->src_h - 1) * _pass->src_w;
+        }
+        y4m_422jpeg_420jpeg_row(dst, rows, _pass->src_w);
+        break;
+      }
+    }
+  }
+}
+
+/*Runs band _band of _num_bands of each pass.*/
+static void y4m_run_band(const y4m_pass *_passes, int _num_passes, int _band,
+                         int _num_bands) {
+  int i;
+  for (i = 0; i < _num_passes; i++) {
+    const int h = _passes[i].dst_h;
+    y4m_run_pass_rows(&_passes[i], h * _band / _num_bands,
+                      h * (_band + 1) / _num_bands);
+  }
+}
+
+#if CONFIG_MULTITHREAD
+struct y4m_worker {
+  struct y4m_threads *threads;
+  pthread_t thread;
+  int band;
+};
+
+/*Band 0 of each job runs on the calling thread, band i on worker i - 1.*/
+struct y4m_threads {
+  struct y4m_worker *workers;
+  int num_workers;
+  const y4m_pass *passes;
+  int num_passes;
+  /*Incremented to start a job.*/
+  int generation;
+  /*The number of workers still running the current job.*/
+  int pending;
+  int quit;
+  pthread_mutex_t mutex;
+  pthread_cond_t start_cond;
+  pthread_cond_t done_cond;
+};
+
+static THREADFN y4m_worker_loop(void *arg) {
+  struct y4m_worker *const worker = (struct y4m_worker *)arg;
+  struct y4m_threads *const threads = worker->threads;
+  int generation = 0;
+
+  pthread_mutex_lock(&threads->mutex);
+  for (;;) {
+    while (threads->generation == generation && !threads->quit)
+      pthread_cond_wait(&threads->start_cond, &threads->mutex);
+    if (threads->quit) break;
+    generation = threads->generation;
+    pthread_mutex_unlock(&threads->mutex);
+
+    y4m_run_band(threads->passes, threads->num_passes, worker->band,
+                 threads->num_workers + 1);
+
+    pthread_mutex_lock(&threads->mutex);
+    if (--threads->pending == 0) pthread_cond_signal(&threads->done_cond);
+  }
+  pthread_mutex_unlock(&threads->mutex);
+  return THREAD_EXIT_SUCCESS;
+}
+
+static void y4m_threads_free(struct y4m_threads *_threads) {
+  int i;
+  if (_threads == NULL) return;
+  pthread_mutex_lock(&_threads->mutex);
+  _threads->quit = 1;
+  pthread_cond_broadcast(&_threads->start_cond);
+  pthread_mutex_unlock(&_threads->mutex);
+  for (i = 0; i < _threads->num_workers; i++) {
+    pthread_join(_threads->workers[i].thread, NULL);
+  }
+  pthread_mutex_destroy(&_threads->mutex);
+  pthread_cond_destroy(&_threads->start_cond);
+  pthread_cond_destroy(&_threads->done_cond);
+  free(_threads->workers);
+  free(_threads);
+}
+#endif
+
+/*Runs the passes, which must be independent of each other, on all threads.*/
+static void y4m_run_passes(y4m_input *_y4m, const y4m_pass *_passes,
+                           int _num_passes) {
+#if CONFIG_MULTITHREAD
+  struct y4m_threads *const threads = _y4m->threads;
+  if (threads != NULL) {
+    pthread_mutex_lock(&threads->mutex);
+    threads->passes = _passes;
+    threads->num_passes = _num_passes;
+    threads->pending = threads->num_workers;
+    threads->generation++;
+    pthread_cond_broadcast(&threads->start_cond);
+    pthread_mutex_unlock(&threads->mutex);
+
+    y4m_run_band(_passes, _num_passes, 0, threads->num_workers + 1);
+
+    pthread_mutex_lock(&threads->mutex);
+    while (threads->pending)
+      pthread_cond_wait(&threads->done_cond, &threads->mutex);
+    pthread_mutex_unlock(&threads->mutex);
+    return;
+  }
+#else
+  (void)_y4m;
+#endif
+  y4m_run_band(_passes, _num_passes, 0, 1);
+}
+
 /*420jpeg chroma samples are sited like:
   Y-------Y-------Y-------Y-------
   |       |       |       |
@@ -251,37 +756,8 @@ static void y4m_42xmpeg2_42xjpeg_helper(unsigned char *_dst,
                                         const unsigned char *_src, int _c_w,
                                         int _c_h) {
   int y;
-  int x;
   for (y = 0; y < _c_h; y++) {
-    /*Filter: [4 -17 114 35 -9 1]/128, derived from a 6-tap Lanczos
-       window.*/
-    for (x = 0; x < OC_MINI(_c_w, 2); x++) {
-      _dst[x] = (unsigned char)OC_CLAMPI(
-          0,
-          (4 * _src[0] - 17 * _src[OC_MAXI(x - 1, 0)] + 114 * _src[x] +
-           35 * _src[OC_MINI(x + 1, _c_w - 1)] -
-           9 * _src[OC_MINI(x + 2, _c_w - 1)] + _src[OC_MINI(x + 3, _c_w - 1)] +
-           64) >>
-              7,
-          255);
-    }
-    for (; x < _c_w - 3; x++) {
-      _dst[x] = (unsigned char)OC_CLAMPI(
-          0,
-          (4 * _src[x - 2] - 17 * _src[x - 1] + 114 * _src[x] +
-           35 * _src[x + 1] - 9 * _src[x + 2] + _src[x + 3] + 64) >>
-              7,
-          255);
-    }
-    for (; x < _c_w; x++) {
-      _dst[x] = (unsigned char)OC_CLAMPI(
-          0,
-          (4 * _src[x - 2] - 17 * _src[x - 1] + 114 * _src[x] +
-           35 * _src[OC_MINI(x + 1, _c_w - 1)] -
-           9 * _src[OC_MINI(x + 2, _c_w - 1)] + _src[_c_w - 1] + 64) >>
-              7,
-          255);
-    }
+    y4m_42xmpeg2_42xjpeg_row(_dst, _src, _c_w);
     _dst += _c_w;
     _src += _c_w;
   }
@@ -447,41 +923,9 @@ static void y4m_convert_42xpaldv_42xjpeg(y4m_input *_y4m, unsigned char *_dst,
 static void y4m_422jpeg_420jpeg_helper(unsigned char *_dst,
                                        const unsigned char *_src, int _c_w,
                                        int _c_h) {
-  int y;
-  int x;
-  /*Filter: [3 -17 78 78 -17 3]/128, derived from a 6-tap Lanczos window.*/
-  for (x = 0; x < _c_w; x++) {
-    for (y = 0; y < OC_MINI(_c_h, 2); y += 2) {
-      _dst[(y >> 1) * _c_w] =
-          OC_CLAMPI(0,
-                    (64 * _src[0] + 78 * _src[OC_MINI(1, _c_h - 1) * _c_w] -
-                     17 * _src[OC_MINI(2, _c_h - 1) * _c_w] +
-                     3 * _src[OC_MINI(3, _c_h - 1) * _c_w] + 64) >>
-                        7,
-                    255);
-    }
-    for (; y < _c_h - 3; y += 2) {
-      _dst[(y >> 1) * _c_w] =
-          OC_CLAMPI(0,
-                    (3 * (_src[(y - 2) * _c_w] + _src[(y + 3) * _c_w]) -
-                     17 * (_src[(y - 1) * _c_w] + _src[(y + 2) * _c_w]) +
-                     78 * (_src[y * _c_w] + _src[(y + 1) * _c_w]) + 64) >>
-                        7,
-                    255);
-    }
-    for (; y < _c_h; y += 2) {
-      _dst[(y >> 1) * _c_w] = OC_CLAMPI(
-          0,
-          (3 * (_src[(y - 2) * _c_w] + _src[(_c_h - 1) * _c_w]) -
-           17 * (_src[(y - 1) * _c_w] + _src[OC_MINI(y + 2, _c_h - 1) * _c_w]) +
-           78 * (_src[y * _c_w] + _src[OC_MINI(y + 1, _c_h - 1) * _c_w]) +
-           64) >>
-              7,
-          255);
-    }
-    _src++;
-    _dst++;
-  }
+  const y4m_pass pass =
+      y4m_make_pass(Y4M_PASS_DECIMATE_V, _dst, _src, _c_w, _c_h);
+  y4m_run_pass_rows(&pass, 0, pass.dst_h);
 }
 
 /*420jpeg chroma samples are sited like:
@@ -524,6 +968,7 @@ static void y4m_422jpeg_420jpeg_helper(unsigned char *_dst,
    vertical direction.*/
 static void y4m_convert_422jpeg_420jpeg(y4m_input *_y4m, unsigned char *_dst,
                                         unsigned char *_aux) {
+  y4m_pass passes[2];
   int c_w;
   int c_h;
   int c_sz;
@@ -540,11 +985,11 @@ static void y4m_convert_422jpeg_420jpeg(y4m_input *_y4m, unsigned char *_dst,
   dst_c_h = (_y4m->pic_h + _y4m->dst_c_dec_v - 1) / _y4m->dst_c_dec_v;
   c_sz = c_w * c_h;
   dst_c_sz = dst_c_w * dst_c_h;
-  for (pli = 1; pli < 3; pli++) {
-    y4m_422jpeg_420jpeg_helper(_dst, _aux, c_w, c_h);
-    _aux += c_sz;
-    _dst += dst_c_sz;
+  for (pli = 0; pli < 2; pli++) {
+    passes[pli] = y4m_make_pass(Y4M_PASS_DECIMATE_V, _dst + pli * dst_c_sz,
+                                _aux + pli * c_sz, c_w, c_h);
   }
+  y4m_run_passes(_y4m, passes, 2);
 }
 
 /*420jpeg chroma samples are sited like:
@@ -606,13 +1051,16 @@ static void y4m_convert_422_420jpeg(y4m_input *_y4m, unsigned char *_dst,
   dst_c_sz = c_w * dst_c_h;
   tmp = _aux + 2 * c_sz;
   for (pli = 1; pli < 3; pli++) {
+    y4m_pass pass;
     /*In reality, the horizontal and vertical steps could be pipelined, for
        less memory consumption and better cache performance, but we do them
        separately for simplicity.*/
     /*First do horizontal filtering (convert to 422jpeg)*/
-    y4m_42xmpeg2_42xjpeg_helper(tmp, _aux, c_w, c_h);
+    pass = y4m_make_pass(Y4M_PASS_SHIFT_H, tmp, _aux, c_w, c_h);
+    y4m_run_passes(_y4m, &pass, 1);
     /*Now do the vertical filtering.*/
-    y4m_422jpeg_420jpeg_helper(_dst, tmp, c_w, c_h);
+    pass = y4m_make_pass(Y4M_PASS_DECIMATE_V, _dst, tmp, c_w, c_h);
+    y4m_run_passes(_y4m, &pass, 1);
     _aux += c_sz;
     _dst += dst_c_sz;
   }
@@ -755,10 +1203,7 @@ static void y4m_convert_444_420jpeg(y4m_input *_y4m, unsigned char *_dst,
   int dst_c_w;
   int dst_c_h;
   int dst_c_sz;
-  int tmp_sz;
   int pli;
-  int y;
-  int x;
   /*Skip past the luma data.*/
   _dst += _y4m->pic_w * _y4m->pic_h;
   /*Compute the size of each chroma plane.*/
@@ -768,42 +1213,16 @@ static void y4m_convert_444_420jpeg(y4m_input *_y4m, unsigned char *_dst,
   dst_c_h = (_y4m->pic_h + _y4m->dst_c_dec_v - 1) / _y4m->dst_c_dec_v;
   c_sz = c_w * c_h;
   dst_c_sz = dst_c_w * dst_c_h;
-  tmp_sz = dst_c_w * c_h;
   tmp = _aux + 2 * c_sz;
   for (pli = 1; pli < 3; pli++) {
-    /*Filter: [3 -17 78 78 -17 3]/128, derived from a 6-tap Lanczos window.*/
-    for (y = 0; y < c_h; y++) {
-      for (x = 0; x < OC_MINI(c_w, 2); x += 2) {
-        tmp[x >> 1] = OC_CLAMPI(0,
-                                (64 * _aux[0] + 78 * _aux[OC_MINI(1, c_w - 1)] -
-                                 17 * _aux[OC_MINI(2, c_w - 1)] +
-                                 3 * _aux[OC_MINI(3, c_w - 1)] + 64) >>
-                                    7,
-                                255);
-      }
-      for (; x < c_w - 3; x += 2) {
-        tmp[x >> 1] = OC_CLAMPI(0,
-                                (3 * (_aux[x - 2] + _aux[x + 3]) -
-                                 17 * (_aux[x - 1] + _aux[x + 2]) +
-                                 78 * (_aux[x] + _aux[x + 1]) + 64) >>
-                                    7,
-                                255);
-      }
-      for (; x < c_w; x += 2) {
-        tmp[x >> 1] =
-            OC_CLAMPI(0,
-                      (3 * (_aux[x - 2] + _aux[c_w - 1]) -
-                       17 * (_aux[x - 1] + _aux[OC_MINI(x + 2, c_w - 1)]) +
-                       78 * (_aux[x] + _aux[OC_MINI(x + 1, c_w - 1)]) + 64) >>
-                          7,
-                      255);
-      }
-      tmp += dst_c_w;
-      _aux += c_w;
-    }
-    tmp -= tmp_sz;
+    y4m_pass pass;
+    /*First decimate horizontally (convert to 422jpeg).*/
+    pass = y4m_make_pass(Y4M_PASS_DECIMATE_H, tmp, _aux, c_w, c_h);
+    y4m_run_passes(_y4m, &pass, 1);
     /*Now do the vertical filtering.*/
-    y4m_422jpeg_420jpeg_helper(_dst, tmp, dst_c_w, c_h);
+    pass = y4m_make_pass(Y4M_PASS_DECIMATE_V, _dst, tmp, dst_c_w, c_h);
+    y4m_run_passes(_y4m, &pass, 1);
+    _aux += c_sz;
     _dst += dst_c_sz;
   }
 }
@@ -833,6 +1252,7 @@ int y4m_input_open(y4m_input *y4m_ctx, FILE *file, char *skip_buffer,
                    int num_skip, int only_420) {
   // File must start with |TAG|.
   char tag_buffer[9];  // 9 == strlen(TAG)
+  y4m_ctx->threads = NULL;
   // Read as much as possible from |skip_buffer|, which were characters
   // that were previously read from the file to do input-type detection.
   assert(num_skip >= 0 && num_skip <= 8);
@@ -1102,17 +1522,86 @@ int y4m_input_open(y4m_input *y4m_ctx, FILE *file, char *skip_buffer,
 }
 
 void y4m_input_close(y4m_input *_y4m) {
+  y4m_input_set_threads(_y4m, 1);
   free(_y4m->dst_buf);
   free(_y4m->aux_buf);
 }
 
-int y4m_input_fetch_frame(y4m_input *_y4m, FILE *_fin, vpx_image_t *_img) {
-  char frame[6];
+int y4m_input_set_threads(y4m_input *_y4m, int _num_threads) {
+#if CONFIG_MULTITHREAD
+  struct y4m_threads *threads;
+  int i;
+  y4m_threads_free(_y4m->threads);
+  _y4m->threads = NULL;
+  if (_num_threads <= 1) return 0;
+  threads = (struct y4m_threads *)calloc(1, sizeof(*threads));
+  if (threads == NULL) return -1;
+  threads->workers = (struct y4m_worker *)calloc(_num_threads - 1,
+                                                 sizeof(*threads->workers));
+  if (threads->workers == NULL) {
+    free(threads);
+    return -1;
+  }
+  pthread_mutex_init(&threads->mutex, NULL);
+  pthread_cond_init(&threads->start_cond, NULL);
+  pthread_cond_init(&threads->done_cond, NULL);
+  for (i = 0; i < _num_threads - 1; i++) {
+    struct y4m_worker *const worker = &threads->workers[i];
+    worker->threads = threads;
+    worker->band = i + 1;
+    if (pthread_create(&worker->thread, NULL, y4m_worker_loop, worker)) break;
+    threads->num_workers++;
+  }
+  if (threads->num_workers < _num_threads - 1) {
+    y4m_threads_free(threads);
+    return -1;
+  }
+  _y4m->threads = threads;
+  return 0;
+#else
+  (void)_y4m;
+  return _num_threads <= 1 ? 0 : -1;
+#endif
+}
+
+/*Fills in the image for a converted frame at _buf.*/
+static void y4m_input_wrap_frame(y4m_input *_y4m, unsigned char *_buf,
+                                 vpx_image_t *_img) {
   int pic_sz;
   int c_w;
   int c_h;
   int c_sz;
   int bytes_per_sample = _y4m->bit_depth > 8 ? 2 : 1;
+  /*Fill in the frame buffer pointers.
+    We don't use vpx_img_wrap() because it forces padding for odd picture
+     sizes, which would require a separate fread call for every row.*/
+  memset(_img, 0, sizeof(*_img));
+  /*Y4M has the planes in Y'CbCr order, which libvpx calls Y, U, and V.*/
+  _img->fmt = _y4m->vpx_fmt;
+  _img->w = _img->d_w = _y4m->pic_w;
+  _img->h = _img->d_h = _y4m->pic_h;
+  _img->bit_depth = _y4m->bit_depth;
+  _img->x_chroma_shift = _y4m->dst_c_dec_h >> 1;
+  _img->y_chroma_shift = _y4m->dst_c_dec_v >> 1;
+  _img->bps = _y4m->bps;
+
+  /*Set up the buffer pointers.*/
+  pic_sz = _y4m->pic_w * _y4m->pic_h * bytes_per_sample;
+  c_w = (_y4m->pic_w + _y4m->dst_c_dec_h - 1) / _y4m->dst_c_dec_h;
+  c_w *= bytes_per_sample;
+  c_h = (_y4m->pic_h + _y4m->dst_c_dec_v - 1) / _y4m->dst_c_dec_v;
+  c_sz = c_w * c_h;
+  _img->stride[VPX_PLANE_Y] = _img->stride[VPX_PLANE_ALPHA] =
+      _y4m->pic_w * bytes_per_sample;
+  _img->stride[VPX_PLANE_U] = _img->stride[VPX_PLANE_V] = c_w;
+  _img->planes[VPX_PLANE_Y] = _buf;
+  _img->planes[VPX_PLANE_U] = _buf + pic_sz;
+  _img->planes[VPX_PLANE_V] = _buf + pic_sz + c_sz;
+  _img->planes[VPX_PLANE_ALPHA] = _buf + pic_sz + 2 * c_sz;
+}
+
+int y4m_input_fetch_frame(y4m_input *_y4m, FILE *_fin, vpx_image_t *_img) {
+  char frame[6];
   /*Read and skip the frame header.*/
   if (!file_read(frame, 6, _fin)) return 0;
   if (memcmp(frame, "FRAME", 5)) {
@@ -1141,31 +1630,45 @@ int y4m_input_fetch_frame(y4m_input *_y4m, FILE *_fin, vpx_image_t *_img) {
   }
   /*Now convert the just read frame.*/
   (*_y4m->convert)(_y4m, _y4m->dst_buf, _y4m->aux_buf);
-  /*Fill in the frame buffer pointers.
-    We don't use vpx_img_wrap() because it forces padding for odd picture
-     sizes, which would require a separate fread call for every row.*/
-  memset(_img, 0, sizeof(*_img));
-  /*Y4M has the planes in Y'CbCr order, which libvpx calls Y, U, and V.*/
-  _img->fmt = _y4m->vpx_fmt;
-  _img->w = _img->d_w = _y4m->pic_w;
-  _img->h = _img->d_h = _y4m->pic_h;
-  _img->bit_depth = _y4m->bit_depth;
-  _img->x_chroma_shift = _y4m->dst_c_dec_h >> 1;
-  _img->y_chroma_shift = _y4m->dst_c_dec_v >> 1;
-  _img->bps = _y4m->bps;
+  y4m_input_wrap_frame(_y4m, _y4m->dst_buf, _img);
+  return 1;
+}
 
-  /*Set up the buffer pointers.*/
-  pic_sz = _y4m->pic_w * _y4m->pic_h * bytes_per_sample;
-  c_w = (_y4m->pic_w + _y4m->dst_c_dec_h - 1) / _y4m->dst_c_dec_h;
-  c_w *= bytes_per_sample;
-  c_h = (_y4m->pic_h + _y4m->dst_c_dec_v - 1) / _y4m->dst_c_dec_v;
-  c_sz = c_w * c_h;
-  _img->stride[VPX_PLANE_Y] = _img->stride[VPX_PLANE_ALPHA] =
-      _y4m->pic_w * bytes_per_sample;
-  _img->stride[VPX_PLANE_U] = _img->stride[VPX_PLANE_V] = c_w;
-  _img->planes[VPX_PLANE_Y] = _y4m->dst_buf;
-  _img->planes[VPX_PLANE_U] = _y4m->dst_buf + pic_sz;
-  _img->planes[VPX_PLANE_V] = _y4m->dst_buf + pic_sz + c_sz;
-  _img->planes[VPX_PLANE_ALPHA] = _y4m->dst_buf + pic_sz + 2 * c_sz;
+int y4m_input_fetch_frame_mem(y4m_input *_y4m, unsigned char *_buf,
+                              size_t _size, size_t *_consumed,
+                              vpx_image_t *_img) {
+  size_t pos = 6;
+  /*Skip the frame header.*/
+  if (_size < 6) return 0;
+  if (memcmp(_buf, "FRAME", 5)) {
+    fprintf(stderr, "Loss of framing in Y4M input data\n");
+    return -1;
+  }
+  if (_buf[5] != '\n') {
+    int j;
+    for (j = 0; j < 79 && pos < _size && _buf[pos++] != '\n'; j++) {
+    }
+    if (j == 79) {
+      fprintf(stderr, "Error parsing Y4M frame header\n");
+      return -1;
+    }
+  }
+  if (_size - pos < _y4m->dst_buf_read_sz + _y4m->aux_buf_read_sz) {
+    fprintf(stderr, "Error reading Y4M frame data.\n");
+    return -1;
+  }
+  *_consumed = pos + _y4m->dst_buf_read_sz + _y4m->aux_buf_read_sz;
+  /*Frames that need no conversion are used in place, unless that would leave
+     16-bit samples at an odd address.*/
+  if (_y4m->convert == y4m_convert_null &&
+      !(_y4m->bit_depth > 8 && ((uintptr_t)(_buf + pos) & 1))) {
+    y4m_input_wrap_frame(_y4m, _buf + pos, _img);
+    return 1;
+  }
+  memcpy(_y4m->dst_buf, _buf + pos, _y4m->dst_buf_read_sz);
+  memcpy(_y4m->aux_buf, _buf + pos + _y4m->dst_buf_read_sz,
+         _y4m->aux_buf_read_sz);
+  (*_y4m->convert)(_y4m, _y4m->dst_buf, _y4m->aux_buf);
+  y4m_input_wrap_frame(_y4m, _y4m->dst_buf, _img);
   return 1;
 }
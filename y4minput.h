@@ -23,6 +23,9 @@ extern "C" {
 
 typedef struct y4m_input y4m_input;
 
+/*The threads converting the chroma planes, if any.*/
+struct y4m_threads;
+
 /*The function used to perform chroma conversion.*/
 typedef void (*y4m_convert_func)(y4m_input *_y4m, unsigned char *_dst,
                                  unsigned char *_src);
@@ -54,6 +57,7 @@ struct y4m_input {
   enum vpx_img_fmt vpx_fmt;
   int bps;
   unsigned int bit_depth;
+  struct y4m_threads *threads;
 };
 
 /**
@@ -69,6 +73,23 @@ int y4m_input_open(y4m_input *y4m_ctx, FILE *file, char *skip_buffer,
 void y4m_input_close(y4m_input *_y4m);
 int y4m_input_fetch_frame(y4m_input *_y4m, FILE *_fin, vpx_image_t *img);
 
+/*
+ * Splits the chroma conversion of each frame into bands of rows converted by
+ * |num_threads| threads, the calling thread included. A count of 1 or less
+ * converts on the calling thread only.
+ *
+ * Returns 0 on success, -1 on failure.
+ */
+int y4m_input_set_threads(y4m_input *_y4m, int num_threads);
+
+/*
+ * Like y4m_input_fetch_frame(), but takes the frame from the |size| bytes at
+ * |buf| and sets |consumed| to the number of bytes it took up. Frames that
+ * need no conversion are wrapped in place, so |buf| must outlive |img|.
+ */
+int y4m_input_fetch_frame_mem(y4m_input *_y4m, unsigned char *buf,
+                              size_t size, size_t *consumed, vpx_image_t *img);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif